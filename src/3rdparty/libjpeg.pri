@@ -5,6 +5,7 @@ DEFINES += \
     D_ARITH_CODING_SUPPORTED=1 \
     BITS_IN_JSAMPLE=8 \
     JPEG_LIB_VERSION=80 \
+    LIBJPEG_TURBO_VERSION_NUMBER=1005003 \
     SIZEOF_SIZE_T=__SIZEOF_SIZE_T__
 
 #Disable warnings in 3rdparty code due to unused arguments
@@ -348,6 +348,15 @@ bool QNonContiguousByteDeviceIoDeviceImpl::advanceReadPointer(qint64 amount)
     // advancing over that what has actually been read before
     if (currentReadBufferPosition > currentReadBufferAmount) {
         qint64 i = currentReadBufferPosition - currentReadBufferAmount;
+        if (!device->isSequential()) {
+            // the data was consumed somewhere else (e.g. sent straight from
+            // the file), no need to read it just to throw it away
+            if (!device->seek(device->pos() + i)) {
+                emit readProgress(totalAdvancements - i, size());
+                return false;
+            }
+            i = 0;
+        }
         while (i > 0) {
             if (device->getChar(0) == false) {
                 emit readProgress(totalAdvancements - i, size());
@@ -1141,6 +1141,40 @@ const QDBusArgument &operator>>(const QDBusArgument &a, QVariant &v)
     return a;
 }
 
+QDBusArgument &operator<<(QDBusArgument &a, const QVariantMap &map)
+{
+    QDBusArgumentPrivate *&d = QDBusArgumentPrivate::d(a);
+    if (QDBusArgumentPrivate::checkWrite(d))
+        d->marshaller()->append(map);
+    return a;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &a, QVariantMap &map)
+{
+    QDBusArgumentPrivate *&d = QDBusArgumentPrivate::d(a);
+    if (QDBusArgumentPrivate::checkReadAndDetach(d))
+        map = d->demarshaller()->toVariantMap();
+    return a;
+}
+
+namespace QtPrivate {
+void qDBusAppendFixedArray(QDBusArgument &arg, int type, const void *data, int count)
+{
+    QDBusArgumentPrivate *&d = QDBusArgumentPrivate::d(arg);
+    if (QDBusArgumentPrivate::checkWrite(d))
+        d->marshaller()->appendFixedArray(type, data, count);
+}
+
+// Returns false, without consuming anything, unless the current argument is
+// an array of that type; data then points into the message.
+bool qDBusReadFixedArray(const QDBusArgument &arg, int type, const void **data, int *count)
+{
+    QDBusArgumentPrivate *&d = QDBusArgumentPrivate::d(arg);
+    return QDBusArgumentPrivate::checkReadAndDetach(d)
+            && d->demarshaller()->toFixedArray(type, data, count);
+}
+}
+
 // QVariant types
 #ifndef QDBUS_NO_SPECIALTYPES
 const QDBusArgument &operator>>(const QDBusArgument &a, QDate &date)
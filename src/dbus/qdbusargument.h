@@ -49,6 +49,7 @@
 #include <QtCore/qstring.h>
 #include <QtCore/qstringlist.h>
 #include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
 #include <QtDBus/qdbusextratypes.h>
 
 #ifndef QT_NO_DBUS
@@ -233,6 +234,22 @@ Q_DBUS_EXPORT const QDBusArgument &operator>>(const QDBusArgument &a, QLineF &li
 Q_DBUS_EXPORT QDBusArgument &operator<<(QDBusArgument &a, const QLineF &line);
 #endif
 
+namespace QtPrivate {
+// D-Bus type codes of the types whose arrays are copied as a whole
+template <typename T> struct QDBusFixedType { enum { Code = 0 }; };
+template <> struct QDBusFixedType<uchar> { enum { Code = 'y' }; };
+template <> struct QDBusFixedType<short> { enum { Code = 'n' }; };
+template <> struct QDBusFixedType<ushort> { enum { Code = 'q' }; };
+template <> struct QDBusFixedType<int> { enum { Code = 'i' }; };
+template <> struct QDBusFixedType<uint> { enum { Code = 'u' }; };
+template <> struct QDBusFixedType<qlonglong> { enum { Code = 'x' }; };
+template <> struct QDBusFixedType<qulonglong> { enum { Code = 't' }; };
+template <> struct QDBusFixedType<double> { enum { Code = 'd' }; };
+
+Q_DBUS_EXPORT void qDBusAppendFixedArray(QDBusArgument &arg, int type, const void *data, int count);
+Q_DBUS_EXPORT bool qDBusReadFixedArray(const QDBusArgument &arg, int type, const void **data, int *count);
+}
+
 template<template <typename> class Container, typename T>
 inline QDBusArgument &operator<<(QDBusArgument &arg, const Container<T> &list)
 {
@@ -261,10 +278,61 @@ inline const QDBusArgument &operator>>(const QDBusArgument &arg, Container<T> &l
     return arg;
 }
 
+// QVector specializations
+template<typename T>
+inline QDBusArgument &operator<<(QDBusArgument &arg, const QVector<T> &vector)
+{
+    if (QtPrivate::QDBusFixedType<T>::Code != 0) {
+        QtPrivate::qDBusAppendFixedArray(arg, QtPrivate::QDBusFixedType<T>::Code,
+                                         vector.constData(), vector.size());
+        return arg;
+    }
+
+    int id = qMetaTypeId<T>();
+    arg.beginArray(id);
+    typename QVector<T>::ConstIterator it = vector.constBegin();
+    typename QVector<T>::ConstIterator end = vector.constEnd();
+    for ( ; it != end; ++it)
+        arg << *it;
+    arg.endArray();
+    return arg;
+}
+
+template<typename T>
+inline const QDBusArgument &operator>>(const QDBusArgument &arg, QVector<T> &vector)
+{
+    const void *data;
+    int count;
+    if (QtPrivate::QDBusFixedType<T>::Code != 0
+        && QtPrivate::qDBusReadFixedArray(arg, QtPrivate::QDBusFixedType<T>::Code, &data, &count)) {
+        const T *begin = static_cast<const T *>(data);
+        vector.resize(count);
+        std::copy(begin, begin + count, vector.begin());
+        return arg;
+    }
+
+    arg.beginArray();
+    vector.clear();
+    while (!arg.atEnd()) {
+        T item;
+        arg >> item;
+        vector.push_back(item);
+    }
+    arg.endArray();
+    return arg;
+}
+
 // QList specializations
 template<typename T>
 inline QDBusArgument &operator<<(QDBusArgument &arg, const QList<T> &list)
 {
+    if (QtPrivate::QDBusFixedType<T>::Code != 0) {
+        const QVector<T> vector = list.toVector();
+        QtPrivate::qDBusAppendFixedArray(arg, QtPrivate::QDBusFixedType<T>::Code,
+                                         vector.constData(), vector.size());
+        return arg;
+    }
+
     int id = qMetaTypeId<T>();
     arg.beginArray(id);
     typename QList<T>::ConstIterator it = list.constBegin();
@@ -278,6 +346,18 @@ inline QDBusArgument &operator<<(QDBusArgument &arg, const QList<T> &list)
 template<typename T>
 inline const QDBusArgument &operator>>(const QDBusArgument &arg, QList<T> &list)
 {
+    const void *data;
+    int count;
+    if (QtPrivate::QDBusFixedType<T>::Code != 0
+        && QtPrivate::qDBusReadFixedArray(arg, QtPrivate::QDBusFixedType<T>::Code, &data, &count)) {
+        const T *begin = static_cast<const T *>(data);
+        list.clear();
+        list.reserve(count);
+        for (const T *it = begin; it != begin + count; ++it)
+            list.append(*it);
+        return arg;
+    }
+
     arg.beginArray();
     list.clear();
     while (!arg.atEnd()) {
@@ -337,19 +417,8 @@ inline const QDBusArgument &operator>>(const QDBusArgument &arg, QMap<Key, T> &m
     return arg;
 }
 
-inline QDBusArgument &operator<<(QDBusArgument &arg, const QVariantMap &map)
-{
-    arg.beginMap(QVariant::String, qMetaTypeId<QDBusVariant>());
-    QVariantMap::ConstIterator it = map.constBegin();
-    QVariantMap::ConstIterator end = map.constEnd();
-    for ( ; it != end; ++it) {
-        arg.beginMapEntry();
-        arg << it.key() << QDBusVariant(it.value());
-        arg.endMapEntry();
-    }
-    arg.endMap();
-    return arg;
-}
+Q_DBUS_EXPORT QDBusArgument &operator<<(QDBusArgument &arg, const QVariantMap &map);
+Q_DBUS_EXPORT const QDBusArgument &operator>>(const QDBusArgument &arg, QVariantMap &map);
 
 // QHash specializations
 template<typename Key, typename T>
@@ -88,7 +88,9 @@ public:
         QDBusArgument q(d);
         return q;
     }
-    static inline QDBusArgumentPrivate *d(QDBusArgument &q)
+    static inline QDBusArgumentPrivate *&d(QDBusArgument &q)
+    { return q.d; }
+    static inline QDBusArgumentPrivate *&d(const QDBusArgument &q)
     { return q.d; }
 
 public:
@@ -126,6 +128,8 @@ public:
     void append(const QStringList &arg);
     void append(const QByteArray &arg);
     bool append(const QDBusVariant &arg); // this one can fail
+    void append(const QVariantMap &arg);
+    void appendFixedArray(int type, const void *data, int count);
 
     QDBusMarshaller *beginStructure();
     QDBusMarshaller *endStructure();
@@ -183,6 +187,8 @@ public:
     QDBusVariant toVariant();
     QStringList toStringList();
     QByteArray toByteArray();
+    QVariantMap toVariantMap();
+    bool toFixedArray(int type, const void **data, int *count);
 
     QDBusDemarshaller *beginStructure();
     QDBusDemarshaller *endStructure();
@@ -359,6 +359,57 @@ QByteArray QDBusDemarshaller::toByteArray()
     return QByteArray();
 }
 
+QVariantMap QDBusDemarshaller::toVariantMap()
+{
+    QVariantMap map;
+    if (q_dbus_message_iter_get_arg_type(&iterator) != DBUS_TYPE_ARRAY
+            || q_dbus_message_iter_get_element_type(&iterator) != DBUS_TYPE_DICT_ENTRY) {
+        q_dbus_message_iter_next(&iterator);
+        return map;
+    }
+
+    DBusMessageIter array;
+    q_dbus_message_iter_recurse(&iterator, &array);
+    q_dbus_message_iter_next(&iterator);
+
+    // Unlike beginMapEntry(), this does not allocate a demarshaller for every
+    // entry. As with toVariantInternal(), values that are arrays, maps or
+    // structures stay undecoded in a QDBusArgument until they are used.
+    // Basic values are decoded right away: the map holds them by value, and
+    // callers read them with QVariant::toInt() and friends, not qdbus_cast().
+    QDBusDemarshaller entry(capabilities);
+    entry.message = q_dbus_message_ref(message);
+    while (q_dbus_message_iter_get_arg_type(&array) == DBUS_TYPE_DICT_ENTRY) {
+        q_dbus_message_iter_recurse(&array, &entry.iterator);
+        q_dbus_message_iter_next(&array);
+
+        QString key;
+        if (entry.isCurrentTypeStringLike())
+            key = entry.toStringUnchecked();
+        else
+            q_dbus_message_iter_next(&entry.iterator);
+        if (q_dbus_message_iter_get_arg_type(&entry.iterator) == DBUS_TYPE_VARIANT)
+            map.insertMulti(key, entry.toVariant().variant());
+        else
+            map.insertMulti(key, entry.toVariantInternal());
+    }
+    return map;
+}
+
+bool QDBusDemarshaller::toFixedArray(int type, const void **data, int *count)
+{
+    if (q_dbus_message_iter_get_arg_type(&iterator) != DBUS_TYPE_ARRAY
+            || q_dbus_message_iter_get_element_type(&iterator) != type)
+        return false;
+
+    // code is exactly like QDBusDemarshaller::toByteArray
+    DBusMessageIter sub;
+    q_dbus_message_iter_recurse(&iterator, &sub);
+    q_dbus_message_iter_next(&iterator);
+    q_dbus_message_iter_get_fixed_array(&sub, data, count);
+    return true;
+}
+
 bool QDBusDemarshaller::atEnd()
 {
     // dbus_message_iter_has_next is broken if the list has one single element
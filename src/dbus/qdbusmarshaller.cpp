@@ -180,6 +180,24 @@ inline void QDBusMarshaller::append(const QByteArray &arg)
     q_dbus_message_iter_close_container(&iterator, &subiterator);
 }
 
+// the elements of fixed-size types are copied in one go
+inline void QDBusMarshaller::appendFixedArray(int type, const void *data, int count)
+{
+    const char signature[2] = { char(type), 0 };
+    if (ba) {
+        if (!skipSignature) {
+            *ba += DBUS_TYPE_ARRAY_AS_STRING;
+            *ba += signature;
+        }
+        return;
+    }
+
+    DBusMessageIter subiterator;
+    q_dbus_message_iter_open_container(&iterator, DBUS_TYPE_ARRAY, signature, &subiterator);
+    q_dbus_message_iter_append_fixed_array(&subiterator, type, &data, count);
+    q_dbus_message_iter_close_container(&iterator, &subiterator);
+}
+
 inline bool QDBusMarshaller::append(const QDBusVariant &arg)
 {
     if (ba) {
@@ -241,6 +259,28 @@ inline void QDBusMarshaller::append(const QStringList &arg)
     // don't call sub.close(): it auto-closes
 }
 
+inline void QDBusMarshaller::append(const QVariantMap &arg)
+{
+    QDBusMarshaller sub(capabilities);
+    open(sub, DBUS_TYPE_ARRAY,
+         DBUS_DICT_ENTRY_BEGIN_CHAR_AS_STRING DBUS_TYPE_STRING_AS_STRING
+         DBUS_TYPE_VARIANT_AS_STRING DBUS_DICT_ENTRY_END_CHAR_AS_STRING);
+    if (ba)
+        return;
+
+    // unlike beginMapEntry(), the entries are marshalled on the stack
+    QVariantMap::ConstIterator it = arg.constBegin();
+    QVariantMap::ConstIterator end = arg.constEnd();
+    for ( ; it != end; ++it) {
+        QDBusMarshaller entry(capabilities);
+        sub.open(entry, DBUS_TYPE_DICT_ENTRY, 0);
+        entry.append(it.key());
+        if (!entry.append(QDBusVariant(it.value())))
+            return;
+    }
+    // don't call sub.close(): it auto-closes
+}
+
 inline QDBusMarshaller *QDBusMarshaller::beginStructure()
 {
     return beginCommon(DBUS_TYPE_STRUCT, 0);
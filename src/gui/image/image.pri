@@ -8,6 +8,7 @@ HEADERS += \
         image/qimage.h \
         image/qimage_p.h \
         image/qimageiohandler.h \
+        image/qimagecache.h \
         image/qimagereader.h \
         image/qimagewriter.h \
         image/qpaintengine_pic_p.h \
@@ -32,6 +33,7 @@ SOURCES += \
         image/qimage.cpp \
         image/qimage_conversions.cpp \
         image/qimageiohandler.cpp \
+        image/qimagecache.cpp \
         image/qimagereader.cpp \
         image/qimagewriter.cpp \
         image/qpaintengine_pic.cpp \
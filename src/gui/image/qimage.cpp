@@ -60,6 +60,8 @@
 #include <private/qsimd_p.h>
 
 #include <qhash.h>
+#include <qsemaphore.h>
+#include <qthreadpool.h>
 
 #include <private/qpaintengine_raster_p.h>
 
@@ -571,6 +573,15 @@ bool QImageData::checkForAlphaPixels() const
     function returns the actual matrix used for transforming the
     image.
 
+    Since Qt 5.11, converting a large image between non-indexed formats
+    and scaling it with Qt::SmoothTransformation split the work into bands
+    of scanlines that are processed in parallel on the threads of the
+    global QThreadPool; the result is identical to processing the image on
+    a single thread. The number of threads used is limited by
+    QThreadPool::maxThreadCount() of the global pool, and can be limited
+    further by setting the \c QT_IMAGE_MAX_THREADS environment variable;
+    a value of 1 processes all images on the calling thread.
+
     There are also functions for changing attributes of an image
     in-place:
 
@@ -1986,6 +1997,94 @@ QImage::Format QImage::format() const
     \sa {Image Formats}
 */
 
+#ifndef QT_NO_THREAD
+namespace {
+class QImageSegmentRunnable : public QRunnable
+{
+public:
+    QImageSegmentRunnable(QImageSegmentFunction function, void *context,
+                          int yStart, int yEnd, QSemaphore *done)
+        : function(function), context(context), yStart(yStart), yEnd(yEnd), done(done)
+    {
+    }
+
+    void run() override
+    {
+        function(context, yStart, yEnd);
+        done->release();
+    }
+
+private:
+    QImageSegmentFunction function;
+    void *context;
+    int yStart;
+    int yEnd;
+    QSemaphore *done;
+};
+}
+
+// Handing rows to another thread only pays off once each thread gets a few
+// hundred kilobytes of pixels to work on.
+static const qsizetype minimumSegmentBytes = 256 * 1024;
+
+static int imageSegmentCount(int height, qsizetype bytes)
+{
+    if (bytes < 2 * minimumSegmentBytes || height < 32)
+        return 1;
+
+    int threads = QThreadPool::globalInstance()->maxThreadCount();
+    bool ok = false;
+    const int budget = qEnvironmentVariableIntValue("QT_IMAGE_MAX_THREADS", &ok);
+    if (ok)
+        threads = qMin(threads, budget);
+
+    return qMax(1, int(qMin<qsizetype>(qMin(threads, height / 16), bytes / minimumSegmentBytes)));
+}
+#endif // QT_NO_THREAD
+
+/*!
+    \internal
+
+    Calls \a function with \a context for consecutive row ranges that
+    together cover the \a height rows of an image whose pixel data takes
+    \a bytes bytes.
+
+    Large images are split into one range per available thread of the global
+    QThreadPool, limited by the \c QT_IMAGE_MAX_THREADS environment variable.
+    The ranges are handed to idle pool threads and the calling thread
+    processes the last one itself; if no pool thread is available, the
+    calling thread processes that range too, so this never waits for
+    unrelated work queued on the pool. Every range except the last one is a
+    multiple of 16 rows long.
+*/
+void qt_processImageSegments(int height, qsizetype bytes, QImageSegmentFunction function, void *context)
+{
+#ifndef QT_NO_THREAD
+    const int segments = imageSegmentCount(height, bytes);
+    if (segments > 1) {
+        QThreadPool *pool = QThreadPool::globalInstance();
+        QSemaphore done;
+        int started = 0;
+        const int segmentHeight = ((height + segments - 1) / segments + 15) & ~15;
+        int y = 0;
+        for (; y + segmentHeight < height; y += segmentHeight) {
+            QImageSegmentRunnable *runnable =
+                    new QImageSegmentRunnable(function, context, y, y + segmentHeight, &done);
+            if (pool->tryStart(runnable)) {
+                ++started;
+            } else {
+                delete runnable;
+                function(context, y, y + segmentHeight);
+            }
+        }
+        function(context, y, height);
+        done.acquire(started);
+        return;
+    }
+#endif
+    function(context, 0, height);
+}
+
 /*!
     \internal
 */
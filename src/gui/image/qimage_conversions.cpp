@@ -146,12 +146,8 @@ void convert_generic(QImageData *dest, const QImageData *src, Qt::ImageConversio
     Q_ASSERT(dest->format > QImage::Format_Indexed8);
     Q_ASSERT(src->format > QImage::Format_Indexed8);
     const int buffer_size = 2048;
-    uint buf[buffer_size];
-    uint *buffer = buf;
     const QPixelLayout *srcLayout = &qPixelLayouts[src->format];
     const QPixelLayout *destLayout = &qPixelLayouts[dest->format];
-    const uchar *srcData = src->data;
-    uchar *destData = dest->data;
 
     const FetchPixelsFunc fetch = qFetchPixels[srcLayout->bpp];
     const StorePixelsFunc store = qStorePixels[destLayout->bpp];
@@ -182,31 +178,37 @@ void convert_generic(QImageData *dest, const QImageData *src, Qt::ImageConversio
         else
             convertFromARGB32PM = destLayout->convertFromRGB32;
     }
-    QDitherInfo dither;
-    QDitherInfo *ditherPtr = 0;
-    if ((flags & Qt::PreferDither) && (flags & Qt::Dither_Mask) != Qt::ThresholdDither)
-        ditherPtr = &dither;
-
-    for (int y = 0; y < src->height; ++y) {
-        dither.y = y;
-        int x = 0;
-        while (x < src->width) {
-            dither.x = x;
-            int l = src->width - x;
-            if (destLayout->bpp == QPixelLayout::BPP32)
-                buffer = reinterpret_cast<uint *>(destData) + x;
-            else
-                l = qMin(l, buffer_size);
-            const uint *ptr = fetch(buffer, srcData, x, l);
-            ptr = convertToARGB32PM(buffer, ptr, l, 0, ditherPtr);
-            ptr = convertFromARGB32PM(buffer, ptr, l, 0, ditherPtr);
-            if (ptr != reinterpret_cast<uint *>(destData))
-                store(destData, ptr, x, l);
-            x += l;
+    const bool dither = (flags & Qt::PreferDither) && (flags & Qt::Dither_Mask) != Qt::ThresholdDither;
+
+    auto convertSegment = [=](int yStart, int yEnd) {
+        uint buf[buffer_size];
+        uint *buffer = buf;
+        const uchar *srcData = src->data + src->bytes_per_line * yStart;
+        uchar *destData = dest->data + dest->bytes_per_line * yStart;
+        QDitherInfo ditherInfo;
+        QDitherInfo *ditherPtr = dither ? &ditherInfo : 0;
+        for (int y = yStart; y < yEnd; ++y) {
+            ditherInfo.y = y;
+            int x = 0;
+            while (x < src->width) {
+                ditherInfo.x = x;
+                int l = src->width - x;
+                if (destLayout->bpp == QPixelLayout::BPP32)
+                    buffer = reinterpret_cast<uint *>(destData) + x;
+                else
+                    l = qMin(l, buffer_size);
+                const uint *ptr = fetch(buffer, srcData, x, l);
+                ptr = convertToARGB32PM(buffer, ptr, l, 0, ditherPtr);
+                ptr = convertFromARGB32PM(buffer, ptr, l, 0, ditherPtr);
+                if (ptr != reinterpret_cast<uint *>(destData))
+                    store(destData, ptr, x, l);
+                x += l;
+            }
+            srcData += src->bytes_per_line;
+            destData += dest->bytes_per_line;
         }
-        srcData += src->bytes_per_line;
-        destData += dest->bytes_per_line;
-    }
+    };
+    qt_processImageSegments(src->height, src->nbytes + dest->nbytes, convertSegment);
 }
 
 bool convert_generic_inplace(QImageData *data, QImage::Format dst_format, Qt::ImageConversionFlags flags)
@@ -218,10 +220,8 @@ bool convert_generic_inplace(QImageData *data, QImage::Format dst_format, Qt::Im
         return false;
 
     const int buffer_size = 2048;
-    uint buffer[buffer_size];
     const QPixelLayout *srcLayout = &qPixelLayouts[data->format];
     const QPixelLayout *destLayout = &qPixelLayouts[dst_format];
-    uchar *srcData = data->data;
 
     const FetchPixelsFunc fetch = qFetchPixels[srcLayout->bpp];
     const StorePixelsFunc store = qStorePixels[destLayout->bpp];
@@ -251,27 +251,31 @@ bool convert_generic_inplace(QImageData *data, QImage::Format dst_format, Qt::Im
         else
             convertFromARGB32PM = destLayout->convertFromRGB32;
     }
-    QDitherInfo dither;
-    QDitherInfo *ditherPtr = 0;
-    if ((flags & Qt::PreferDither) && (flags & Qt::Dither_Mask) != Qt::ThresholdDither)
-        ditherPtr = &dither;
-
-    for (int y = 0; y < data->height; ++y) {
-        dither.y = y;
-        int x = 0;
-        while (x < data->width) {
-            dither.x = x;
-            int l = qMin(data->width - x, buffer_size);
-            const uint *ptr = fetch(buffer, srcData, x, l);
-            ptr = convertToARGB32PM(buffer, ptr, l, 0, ditherPtr);
-            ptr = convertFromARGB32PM(buffer, ptr, l, 0, ditherPtr);
-            // The conversions might be passthrough and not use the buffer, in that case we are already done.
-            if (srcData != (const uchar*)ptr)
-                store(srcData, ptr, x, l);
-            x += l;
+    const bool dither = (flags & Qt::PreferDither) && (flags & Qt::Dither_Mask) != Qt::ThresholdDither;
+
+    auto convertSegment = [=](int yStart, int yEnd) {
+        uint buffer[buffer_size];
+        uchar *srcData = data->data + data->bytes_per_line * yStart;
+        QDitherInfo ditherInfo;
+        QDitherInfo *ditherPtr = dither ? &ditherInfo : 0;
+        for (int y = yStart; y < yEnd; ++y) {
+            ditherInfo.y = y;
+            int x = 0;
+            while (x < data->width) {
+                ditherInfo.x = x;
+                int l = qMin(data->width - x, buffer_size);
+                const uint *ptr = fetch(buffer, srcData, x, l);
+                ptr = convertToARGB32PM(buffer, ptr, l, 0, ditherPtr);
+                ptr = convertFromARGB32PM(buffer, ptr, l, 0, ditherPtr);
+                // The conversions might be passthrough and not use the buffer, in that case we are already done.
+                if (srcData != (const uchar*)ptr)
+                    store(srcData, ptr, x, l);
+                x += l;
+            }
+            srcData += data->bytes_per_line;
         }
-        srcData += data->bytes_per_line;
-    }
+    };
+    qt_processImageSegments(data->height, data->nbytes, convertSegment);
     data->format = dst_format;
     return true;
 }
@@ -283,19 +287,22 @@ static void convert_passthrough(QImageData *dest, const QImageData *src, Qt::Ima
 
     const int src_pad = (src->bytes_per_line >> 2) - src->width;
     const int dest_pad = (dest->bytes_per_line >> 2) - dest->width;
-    const quint32 *src_data = (quint32 *) src->data;
-    quint32 *dest_data = (quint32 *) dest->data;
-
-    for (int i = 0; i < src->height; ++i) {
-        const quint32 *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = *src_data;
-            ++src_data;
-            ++dest_data;
+
+    auto convertSegment = [=](int yStart, int yEnd) {
+        const quint32 *src_data = (const quint32 *)(src->data + src->bytes_per_line * yStart);
+        quint32 *dest_data = (quint32 *)(dest->data + dest->bytes_per_line * yStart);
+        for (int i = yStart; i < yEnd; ++i) {
+            const quint32 *end = src_data + src->width;
+            while (src_data < end) {
+                *dest_data = *src_data;
+                ++src_data;
+                ++dest_data;
+            }
+            src_data += src_pad;
+            dest_data += dest_pad;
         }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    };
+    qt_processImageSegments(src->height, src->nbytes + dest->nbytes, convertSegment);
 }
 
 template<QImage::Format Format>
@@ -314,19 +321,22 @@ static void convert_ARGB_to_ARGB_PM(QImageData *dest, const QImageData *src, Qt:
 
     const int src_pad = (src->bytes_per_line >> 2) - src->width;
     const int dest_pad = (dest->bytes_per_line >> 2) - dest->width;
-    const QRgb *src_data = (QRgb *) src->data;
-    QRgb *dest_data = (QRgb *) dest->data;
-
-    for (int i = 0; i < src->height; ++i) {
-        const QRgb *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = qPremultiply(*src_data);
-            ++src_data;
-            ++dest_data;
+
+    auto convertSegment = [=](int yStart, int yEnd) {
+        const QRgb *src_data = (const QRgb *)(src->data + src->bytes_per_line * yStart);
+        QRgb *dest_data = (QRgb *)(dest->data + dest->bytes_per_line * yStart);
+        for (int i = yStart; i < yEnd; ++i) {
+            const QRgb *end = src_data + src->width;
+            while (src_data < end) {
+                *dest_data = qPremultiply(*src_data);
+                ++src_data;
+                ++dest_data;
+            }
+            src_data += src_pad;
+            dest_data += dest_pad;
         }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    };
+    qt_processImageSegments(src->height, src->nbytes + dest->nbytes, convertSegment);
 }
 
 Q_GUI_EXPORT void QT_FASTCALL qt_convert_rgb888_to_rgb32(quint32 *dest_data, const uchar *src_data, int len)
@@ -419,16 +429,18 @@ static void convert_RGB888_to_RGB(QImageData *dest, const QImageData *src, Qt::I
     Q_ASSERT(src->width == dest->width);
     Q_ASSERT(src->height == dest->height);
 
-    const uchar *src_data = (uchar *) src->data;
-    quint32 *dest_data = (quint32 *) dest->data;
-
     Rgb888ToRgbConverter line_converter= rgbx ? qt_convert_rgb888_to_rgbx8888 : qt_convert_rgb888_to_rgb32;
 
-    for (int i = 0; i < src->height; ++i) {
-        line_converter(dest_data, src_data, src->width);
-        src_data += src->bytes_per_line;
-        dest_data = (quint32 *)((uchar*)dest_data + dest->bytes_per_line);
-    }
+    auto convertSegment = [=](int yStart, int yEnd) {
+        const uchar *src_data = src->data + src->bytes_per_line * yStart;
+        quint32 *dest_data = (quint32 *)(dest->data + dest->bytes_per_line * yStart);
+        for (int i = yStart; i < yEnd; ++i) {
+            line_converter(dest_data, src_data, src->width);
+            src_data += src->bytes_per_line;
+            dest_data = (quint32 *)((uchar*)dest_data + dest->bytes_per_line);
+        }
+    };
+    qt_processImageSegments(src->height, src->nbytes + dest->nbytes, convertSegment);
 }
 
 #ifdef __SSE2__
@@ -467,19 +479,22 @@ static void convert_ARGB_to_RGBx(QImageData *dest, const QImageData *src, Qt::Im
 
     const int src_pad = (src->bytes_per_line >> 2) - src->width;
     const int dest_pad = (dest->bytes_per_line >> 2) - dest->width;
-    const quint32 *src_data = (quint32 *) src->data;
-    quint32 *dest_data = (quint32 *) dest->data;
-
-    for (int i = 0; i < src->height; ++i) {
-        const quint32 *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = ARGB2RGBA(0xff000000 | *src_data);
-            ++src_data;
-            ++dest_data;
+
+    auto convertSegment = [=](int yStart, int yEnd) {
+        const quint32 *src_data = (const quint32 *)(src->data + src->bytes_per_line * yStart);
+        quint32 *dest_data = (quint32 *)(dest->data + dest->bytes_per_line * yStart);
+        for (int i = yStart; i < yEnd; ++i) {
+            const quint32 *end = src_data + src->width;
+            while (src_data < end) {
+                *dest_data = ARGB2RGBA(0xff000000 | *src_data);
+                ++src_data;
+                ++dest_data;
+            }
+            src_data += src_pad;
+            dest_data += dest_pad;
         }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    };
+    qt_processImageSegments(src->height, src->nbytes + dest->nbytes, convertSegment);
 }
 
 static void convert_ARGB_to_RGBA(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags)
@@ -491,19 +506,22 @@ static void convert_ARGB_to_RGBA(QImageData *dest, const QImageData *src, Qt::Im
 
     const int src_pad = (src->bytes_per_line >> 2) - src->width;
     const int dest_pad = (dest->bytes_per_line >> 2) - dest->width;
-    const quint32 *src_data = (quint32 *) src->data;
-    quint32 *dest_data = (quint32 *) dest->data;
-
-    for (int i = 0; i < src->height; ++i) {
-        const quint32 *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = ARGB2RGBA(*src_data);
-            ++src_data;
-            ++dest_data;
+
+    auto convertSegment = [=](int yStart, int yEnd) {
+        const quint32 *src_data = (const quint32 *)(src->data + src->bytes_per_line * yStart);
+        quint32 *dest_data = (quint32 *)(dest->data + dest->bytes_per_line * yStart);
+        for (int i = yStart; i < yEnd; ++i) {
+            const quint32 *end = src_data + src->width;
+            while (src_data < end) {
+                *dest_data = ARGB2RGBA(*src_data);
+                ++src_data;
+                ++dest_data;
+            }
+            src_data += src_pad;
+            dest_data += dest_pad;
         }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    };
+    qt_processImageSegments(src->height, src->nbytes + dest->nbytes, convertSegment);
 }
 
 template<QImage::Format DestFormat>
@@ -537,19 +555,22 @@ static void convert_RGBA_to_ARGB(QImageData *dest, const QImageData *src, Qt::Im
 
     const int src_pad = (src->bytes_per_line >> 2) - src->width;
     const int dest_pad = (dest->bytes_per_line >> 2) - dest->width;
-    const quint32 *src_data = (quint32 *) src->data;
-    quint32 *dest_data = (quint32 *) dest->data;
-
-    for (int i = 0; i < src->height; ++i) {
-        const quint32 *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = RGBA2ARGB(*src_data);
-            ++src_data;
-            ++dest_data;
+
+    auto convertSegment = [=](int yStart, int yEnd) {
+        const quint32 *src_data = (const quint32 *)(src->data + src->bytes_per_line * yStart);
+        quint32 *dest_data = (quint32 *)(dest->data + dest->bytes_per_line * yStart);
+        for (int i = yStart; i < yEnd; ++i) {
+            const quint32 *end = src_data + src->width;
+            while (src_data < end) {
+                *dest_data = RGBA2ARGB(*src_data);
+                ++src_data;
+                ++dest_data;
+            }
+            src_data += src_pad;
+            dest_data += dest_pad;
         }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    };
+    qt_processImageSegments(src->height, src->nbytes + dest->nbytes, convertSegment);
 }
 
 template<QImage::Format DestFormat>
@@ -584,19 +605,22 @@ static void convert_RGB_to_RGB30(QImageData *dest, const QImageData *src, Qt::Im
 
     const int src_pad = (src->bytes_per_line >> 2) - src->width;
     const int dest_pad = (dest->bytes_per_line >> 2) - dest->width;
-    const quint32 *src_data = (quint32 *) src->data;
-    quint32 *dest_data = (quint32 *) dest->data;
-
-    for (int i = 0; i < src->height; ++i) {
-        const quint32 *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = qConvertRgb32ToRgb30<PixelOrder>(*src_data);
-            ++src_data;
-            ++dest_data;
+
+    auto convertSegment = [=](int yStart, int yEnd) {
+        const quint32 *src_data = (const quint32 *)(src->data + src->bytes_per_line * yStart);
+        quint32 *dest_data = (quint32 *)(dest->data + dest->bytes_per_line * yStart);
+        for (int i = yStart; i < yEnd; ++i) {
+            const quint32 *end = src_data + src->width;
+            while (src_data < end) {
+                *dest_data = qConvertRgb32ToRgb30<PixelOrder>(*src_data);
+                ++src_data;
+                ++dest_data;
+            }
+            src_data += src_pad;
+            dest_data += dest_pad;
         }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    };
+    qt_processImageSegments(src->height, src->nbytes + dest->nbytes, convertSegment);
 }
 
 template<QtPixelOrder PixelOrder>
@@ -653,20 +677,23 @@ static void convert_A2RGB30_PM_to_RGB30(QImageData *dest, const QImageData *src,
 
     const int src_pad = (src->bytes_per_line >> 2) - src->width;
     const int dest_pad = (dest->bytes_per_line >> 2) - dest->width;
-    const quint32 *src_data = (quint32 *) src->data;
-    quint32 *dest_data = (quint32 *) dest->data;
-
-    for (int i = 0; i < src->height; ++i) {
-        const quint32 *end = src_data + src->width;
-        while (src_data < end) {
-            const uint p = 0xc0000000 | qUnpremultiplyRgb30(*src_data);
-            *dest_data = (rgbswap) ? qRgbSwapRgb30(p) : p;
-            ++src_data;
-            ++dest_data;
+
+    auto convertSegment = [=](int yStart, int yEnd) {
+        const quint32 *src_data = (const quint32 *)(src->data + src->bytes_per_line * yStart);
+        quint32 *dest_data = (quint32 *)(dest->data + dest->bytes_per_line * yStart);
+        for (int i = yStart; i < yEnd; ++i) {
+            const quint32 *end = src_data + src->width;
+            while (src_data < end) {
+                const uint p = 0xc0000000 | qUnpremultiplyRgb30(*src_data);
+                *dest_data = (rgbswap) ? qRgbSwapRgb30(p) : p;
+                ++src_data;
+                ++dest_data;
+            }
+            src_data += src_pad;
+            dest_data += dest_pad;
         }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    };
+    qt_processImageSegments(src->height, src->nbytes + dest->nbytes, convertSegment);
 }
 
 template<bool rgbswap>
@@ -705,19 +732,22 @@ static void convert_BGR30_to_RGB30(QImageData *dest, const QImageData *src, Qt::
 
     const int src_pad = (src->bytes_per_line >> 2) - src->width;
     const int dest_pad = (dest->bytes_per_line >> 2) - dest->width;
-    const quint32 *src_data = (quint32 *) src->data;
-    quint32 *dest_data = (quint32 *) dest->data;
-
-    for (int i = 0; i < src->height; ++i) {
-        const quint32 *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = qRgbSwapRgb30(*src_data);
-            ++src_data;
-            ++dest_data;
+
+    auto convertSegment = [=](int yStart, int yEnd) {
+        const quint32 *src_data = (const quint32 *)(src->data + src->bytes_per_line * yStart);
+        quint32 *dest_data = (quint32 *)(dest->data + dest->bytes_per_line * yStart);
+        for (int i = yStart; i < yEnd; ++i) {
+            const quint32 *end = src_data + src->width;
+            while (src_data < end) {
+                *dest_data = qRgbSwapRgb30(*src_data);
+                ++src_data;
+                ++dest_data;
+            }
+            src_data += src_pad;
+            dest_data += dest_pad;
         }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    };
+    qt_processImageSegments(src->height, src->nbytes + dest->nbytes, convertSegment);
 }
 
 static bool convert_BGR30_to_RGB30_inplace(QImageData *data, Qt::ImageConversionFlags)
@@ -781,19 +811,22 @@ static void convert_A2RGB30_PM_to_ARGB(QImageData *dest, const QImageData *src,
 
     const int src_pad = (src->bytes_per_line >> 2) - src->width;
     const int dest_pad = (dest->bytes_per_line >> 2) - dest->width;
-    const quint32 *src_data = (quint32 *) src->data;
-    quint32 *dest_data = (quint32 *) dest->data;
-
-    for (int i = 0; i < src->height; ++i) {
-        const quint32 *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = qConvertA2rgb30ToArgb32<PixelOrder>(qUnpremultiplyRgb30(*src_data));
-            ++src_data;
-            ++dest_data;
+
+    auto convertSegment = [=](int yStart, int yEnd) {
+        const quint32 *src_data = (const quint32 *)(src->data + src->bytes_per_line * yStart);
+        quint32 *dest_data = (quint32 *)(dest->data + dest->bytes_per_line * yStart);
+        for (int i = yStart; i < yEnd; ++i) {
+            const quint32 *end = src_data + src->width;
+            while (src_data < end) {
+                *dest_data = qConvertA2rgb30ToArgb32<PixelOrder>(qUnpremultiplyRgb30(*src_data));
+                ++src_data;
+                ++dest_data;
+            }
+            src_data += src_pad;
+            dest_data += dest_pad;
         }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    };
+    qt_processImageSegments(src->height, src->nbytes + dest->nbytes, convertSegment);
 }
 
 template<QtPixelOrder PixelOrder>
@@ -1035,19 +1068,22 @@ static void convert_ARGB_PM_to_ARGB(QImageData *dest, const QImageData *src)
 
     const int src_pad = (src->bytes_per_line >> 2) - src->width;
     const int dest_pad = (dest->bytes_per_line >> 2) - dest->width;
-    const QRgb *src_data = (QRgb *) src->data;
-    QRgb *dest_data = (QRgb *) dest->data;
-
-    for (int i = 0; i < src->height; ++i) {
-        const QRgb *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = qUnpremultiply(*src_data);
-            ++src_data;
-            ++dest_data;
+
+    auto convertSegment = [=](int yStart, int yEnd) {
+        const QRgb *src_data = (const QRgb *)(src->data + src->bytes_per_line * yStart);
+        QRgb *dest_data = (QRgb *)(dest->data + dest->bytes_per_line * yStart);
+        for (int i = yStart; i < yEnd; ++i) {
+            const QRgb *end = src_data + src->width;
+            while (src_data < end) {
+                *dest_data = qUnpremultiply(*src_data);
+                ++src_data;
+                ++dest_data;
+            }
+            src_data += src_pad;
+            dest_data += dest_pad;
         }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    };
+    qt_processImageSegments(src->height, src->nbytes + dest->nbytes, convertSegment);
 }
 
 static void convert_RGBA_to_RGB(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags)
@@ -1059,19 +1095,22 @@ static void convert_RGBA_to_RGB(QImageData *dest, const QImageData *src, Qt::Ima
 
     const int src_pad = (src->bytes_per_line >> 2) - src->width;
     const int dest_pad = (dest->bytes_per_line >> 2) - dest->width;
-    const uint *src_data = (const uint *)src->data;
-    uint *dest_data = (uint *)dest->data;
-
-    for (int i = 0; i < src->height; ++i) {
-        const uint *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = RGBA2ARGB(*src_data) | 0xff000000;
-            ++src_data;
-            ++dest_data;
+
+    auto convertSegment = [=](int yStart, int yEnd) {
+        const uint *src_data = (const uint *)(src->data + src->bytes_per_line * yStart);
+        uint *dest_data = (uint *)(dest->data + dest->bytes_per_line * yStart);
+        for (int i = yStart; i < yEnd; ++i) {
+            const uint *end = src_data + src->width;
+            while (src_data < end) {
+                *dest_data = RGBA2ARGB(*src_data) | 0xff000000;
+                ++src_data;
+                ++dest_data;
+            }
+            src_data += src_pad;
+            dest_data += dest_pad;
         }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    };
+    qt_processImageSegments(src->height, src->nbytes + dest->nbytes, convertSegment);
 }
 
 static void swap_bit_order(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags)
@@ -1102,19 +1141,22 @@ static void mask_alpha_converter(QImageData *dest, const QImageData *src, Qt::Im
 
     const int src_pad = (src->bytes_per_line >> 2) - src->width;
     const int dest_pad = (dest->bytes_per_line >> 2) - dest->width;
-    const uint *src_data = (const uint *)src->data;
-    uint *dest_data = (uint *)dest->data;
-
-    for (int i = 0; i < src->height; ++i) {
-        const uint *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = *src_data | 0xff000000;
-            ++src_data;
-            ++dest_data;
+
+    auto convertSegment = [=](int yStart, int yEnd) {
+        const uint *src_data = (const uint *)(src->data + src->bytes_per_line * yStart);
+        uint *dest_data = (uint *)(dest->data + dest->bytes_per_line * yStart);
+        for (int i = yStart; i < yEnd; ++i) {
+            const uint *end = src_data + src->width;
+            while (src_data < end) {
+                *dest_data = *src_data | 0xff000000;
+                ++src_data;
+                ++dest_data;
+            }
+            src_data += src_pad;
+            dest_data += dest_pad;
         }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    };
+    qt_processImageSegments(src->height, src->nbytes + dest->nbytes, convertSegment);
 }
 
 template<QImage::Format DestFormat>
@@ -1149,19 +1191,22 @@ static void mask_alpha_converter_RGBx(QImageData *dest, const QImageData *src, Q
 
     const int src_pad = (src->bytes_per_line >> 2) - src->width;
     const int dest_pad = (dest->bytes_per_line >> 2) - dest->width;
-    const uint *src_data = (const uint *)src->data;
-    uint *dest_data = (uint *)dest->data;
-
-    for (int i = 0; i < src->height; ++i) {
-        const uint *end = src_data + src->width;
-        while (src_data < end) {
-            *dest_data = *src_data | 0x000000ff;
-            ++src_data;
-            ++dest_data;
+
+    auto convertSegment = [=](int yStart, int yEnd) {
+        const uint *src_data = (const uint *)(src->data + src->bytes_per_line * yStart);
+        uint *dest_data = (uint *)(dest->data + dest->bytes_per_line * yStart);
+        for (int i = yStart; i < yEnd; ++i) {
+            const uint *end = src_data + src->width;
+            while (src_data < end) {
+                *dest_data = *src_data | 0x000000ff;
+                ++src_data;
+                ++dest_data;
+            }
+            src_data += src_pad;
+            dest_data += dest_pad;
         }
-        src_data += src_pad;
-        dest_data += dest_pad;
-    }
+    };
+    qt_processImageSegments(src->height, src->nbytes + dest->nbytes, convertSegment);
 #endif
 }
 
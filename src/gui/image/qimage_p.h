@@ -117,6 +117,22 @@ bool convert_generic_inplace(QImageData *data, QImage::Format dst_format, Qt::Im
 
 void dither_to_Mono(QImageData *dst, const QImageData *src, Qt::ImageConversionFlags flags, bool fromalpha);
 
+typedef void (*QImageSegmentFunction)(void *context, int yStart, int yEnd);
+void qt_processImageSegments(int height, qsizetype bytes, QImageSegmentFunction function, void *context);
+
+// Calls function(yStart, yEnd) for consecutive row ranges covering
+// [0, height), in parallel on the global thread pool when the image data
+// is large enough. Ranges start at multiples of 16 rows, so that ordered
+// dithering produces the same result as a single pass.
+template <typename Function>
+inline void qt_processImageSegments(int height, qsizetype bytes, const Function &function)
+{
+    QImageSegmentFunction trampoline = [](void *context, int yStart, int yEnd) {
+        (*static_cast<const Function *>(context))(yStart, yEnd);
+    };
+    qt_processImageSegments(height, bytes, trampoline, const_cast<Function *>(&function));
+}
+
 const uchar *qt_get_bitflip_array();
 Q_GUI_EXPORT void qGamma_correct_back_to_linear_cs(QImage *image);
 
@@ -0,0 +1,736 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qimagecache.h"
+
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtGui/qimage.h>
+#include <QtGui/qpixmap.h>
+#include <private/qobject_p.h>
+#include <qpa/qplatformpixmap.h>
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QImageCache
+    \inmodule QtGui
+    \since 5.11
+
+    \brief The QImageCache class provides a thread-safe cache for images.
+
+    QImageCache stores images under string keys, like QPixmapCache does,
+    but can be used from any thread. This lets worker threads that decode
+    or render image content put their results into a cache that the GUI
+    thread and other workers read from.
+
+    \snippet code/src_gui_image_qimagecache.cpp 0
+
+    The cache is split into shards that are locked independently, so
+    threads working on different keys rarely wait for each other.
+
+    The cache holds at most maxCost() bytes of image data, 10 MB by
+    default. When an insertion makes it exceed this budget, the cache
+    discards entries using the LRU-2 policy: the entry whose second to last
+    use lies furthest in the past goes first, and entries that have only
+    been used once go before any entry that has been used twice. A single
+    pass over many images therefore does not push the images that are used
+    over and over out of the cache. The budget and the order in which
+    entries are discarded are shared by all shards.
+
+    Whenever an insertion has to discard entries, the cache emits
+    memoryPressure(). Connect to it to release other memory, or call trim()
+    when the system reports that memory is running low.
+
+    QPixmap objects can be stored as well, as long as they are backed by
+    the raster platform pixmap. The cache keeps their pixel data as a
+    QImage, which shares the data with the pixmap instead of copying it.
+    Note that pixmaps can only be used outside the GUI thread on platforms
+    that support threaded pixmaps.
+
+    \sa QPixmapCache, QCache
+*/
+
+/*!
+    \fn void QImageCache::memoryPressure(qint64 totalCost, qint64 maxCost)
+
+    This signal is emitted when an insertion had to discard entries to
+    stay within \a maxCost bytes. \a totalCost is the number of bytes in
+    use afterwards.
+
+    The signal is emitted from the thread that inserted the entry, after
+    the cache has released its locks, so connected slots may use the
+    cache.
+*/
+
+static const qint64 defaultImageCacheLimit = 10 * 1024 * 1024;
+
+Q_GLOBAL_STATIC(QImageCache, theInstance)
+
+// The clock is shared by all shards, so that the ranks of entries in
+// different shards can be compared. Without 64-bit atomics, the order is
+// only approximate once the clock has wrapped around.
+#ifdef Q_ATOMIC_INT64_IS_SUPPORTED
+typedef quint64 QImageCacheTime;
+#else
+typedef quint32 QImageCacheTime;
+#endif
+
+// The keys of the hashes carry the hash of the string, so that it is
+// computed only once per call, to pick the shard. Keys made for lookups
+// refer to the string of the caller; copies, like those in the hash, own it.
+struct QImageCacheKey
+{
+    QImageCacheKey(const QString &string, uint hash) : view(&string), hash(hash) {}
+    QImageCacheKey(const QImageCacheKey &other) : string(other.str()), view(nullptr), hash(other.hash) {}
+    QImageCacheKey &operator=(const QImageCacheKey &) Q_DECL_EQ_DELETE;
+
+    const QString &str() const { return view ? *view : string; }
+
+    QString string;
+    const QString *view;
+    uint hash;
+};
+
+static inline bool operator==(const QImageCacheKey &key1, const QImageCacheKey &key2)
+{
+    return key1.str() == key2.str();
+}
+
+static inline uint qHash(const QImageCacheKey &key, uint seed)
+{
+    return key.hash ^ seed;
+}
+
+struct QImageCacheEntry;
+typedef QHash<QImageCacheKey, QImageCacheEntry> QImageCacheHash;
+
+// One of the last two uses of an entry, linked into the history of its shard
+struct QImageCacheUse
+{
+    QImageCacheEntry *entry;
+    QImageCacheUse *older;
+    QImageCacheUse *newer;
+};
+
+struct QImageCacheEntry
+{
+    QImage image;
+    qptrdiff cost;
+    QImageCacheTime lastUse;
+    QImageCacheTime previousUse; // 0 if the entry has been used only once
+
+    // entries used only once are also linked in the order of their use,
+    // through the nodes of the hash, like QCache does
+    const QImageCacheKey *key;
+    QImageCacheEntry *older;
+    QImageCacheEntry *newer;
+
+    QImageCacheUse uses[2];
+    int last; // index of the last use in uses
+};
+
+struct QImageCacheShard
+{
+    // Entries are discarded in ascending order of their rank. Entries used
+    // only once rank by their use, before all others, which rank by their
+    // second to last use.
+    static const QImageCacheTime UsedTwice = QImageCacheTime(1) << (sizeof(QImageCacheTime) * 8 - 1);
+    static const QImageCacheTime NoEntries = ~QImageCacheTime(0);
+
+    QImageCacheShard()
+        : oldestUsedOnce(nullptr), newestUsedOnce(nullptr),
+          oldestUse(nullptr), newestUse(nullptr),
+          rank(NoEntries), lastTick(0), hits(0), misses(0), evictions(0) {}
+
+    void linkUsedOnce(QImageCacheEntry *entry)
+    {
+        entry->older = newestUsedOnce;
+        entry->newer = nullptr;
+        if (newestUsedOnce)
+            newestUsedOnce->newer = entry;
+        else
+            oldestUsedOnce = entry;
+        newestUsedOnce = entry;
+    }
+
+    void unlinkUsedOnce(QImageCacheEntry *entry)
+    {
+        if (entry->older)
+            entry->older->newer = entry->newer;
+        else
+            oldestUsedOnce = entry->newer;
+        if (entry->newer)
+            entry->newer->older = entry->older;
+        else
+            newestUsedOnce = entry->older;
+    }
+
+    void linkUse(QImageCacheUse *use)
+    {
+        use->older = newestUse;
+        use->newer = nullptr;
+        if (newestUse)
+            newestUse->newer = use;
+        else
+            oldestUse = use;
+        newestUse = use;
+    }
+
+    void unlinkUse(QImageCacheUse *use)
+    {
+        if (use->older)
+            use->older->newer = use->newer;
+        else
+            oldestUse = use->newer;
+        if (use->newer)
+            use->newer->older = use->older;
+        else
+            newestUse = use->older;
+    }
+
+    // whether using or removing the entry changes the rank of the shard
+    bool isNextToDiscard(const QImageCacheEntry *entry) const
+    {
+        return oldestUsedOnce ? entry == oldestUsedOnce : &entry->uses[entry->last ^ 1] == oldestUse;
+    }
+
+    void insertEntry(QImageCacheEntry *entry, const QImageCacheKey *key, QImageCacheTime now);
+    void useEntry(QImageCacheEntry *entry, QImageCacheTime now);
+    void removeEntry(QImageCacheEntry *entry);
+    qptrdiff evictOne(const QString &keep, QImage *evicted);
+    void updateRank();
+
+    mutable QMutex mutex;
+    QImageCacheHash entries;
+    QImageCacheEntry *oldestUsedOnce;
+    QImageCacheEntry *newestUsedOnce;
+    QImageCacheUse *oldestUse;
+    QImageCacheUse *newestUse;
+    QAtomicInteger<QImageCacheTime> rank; // of the entry to discard next, read without locking
+    QImageCacheTime lastTick;
+    quint64 hits;
+    quint64 misses;
+    quint64 evictions;
+};
+
+class QImageCachePrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QImageCache)
+public:
+    enum { ShardCount = 16 };
+
+    QImageCachePrivate()
+        : totalCost(0), maxCost(defaultImageCacheLimit), clock(0), memoryPressureSignalIndex(-1) {}
+
+    QImageCacheShard &shard(uint hash) { return shards[hash % ShardCount]; }
+    const QImageCacheShard &shard(uint hash) const { return shards[hash % ShardCount]; }
+
+    QImageCacheTime tick(QImageCacheShard &s);
+
+    bool trimShards(qptrdiff limit, const QString &keep = QString());
+
+    QImageCacheShard shards[ShardCount];
+    QAtomicInteger<qptrdiff> totalCost;
+    QAtomicInteger<qptrdiff> maxCost;
+    QAtomicInteger<QImageCacheTime> clock;
+    int memoryPressureSignalIndex;
+};
+
+/*
+    Returns the time of a use of an entry in \a s, which must be locked.
+    The clock is advanced without a read-modify-write, since it is touched
+    on every lookup; threads that race here merely give uses in different
+    shards the same time. Within a shard, times always increase, which
+    keeps its history in order.
+*/
+QImageCacheTime QImageCachePrivate::tick(QImageCacheShard &s)
+{
+    const QImageCacheTime now = qMax(clock.load(), s.lastTick) + 1;
+    clock.store(now);
+    s.lastTick = now;
+    return now;
+}
+
+/*
+    The last two uses of every entry are linked into the history of the
+    shard, oldest first. Once all entries that have been used only once
+    are gone, the oldest use in the history is the second to last use of
+    the entry that ranks lowest, so that entry is found without a search.
+*/
+void QImageCacheShard::insertEntry(QImageCacheEntry *entry, const QImageCacheKey *key, QImageCacheTime now)
+{
+    entry->key = key;
+    entry->lastUse = now;
+    entry->previousUse = 0;
+    entry->uses[0].entry = entry->uses[1].entry = entry;
+    entry->last = 0;
+    linkUse(&entry->uses[0]);
+    linkUsedOnce(entry);
+}
+
+void QImageCacheShard::useEntry(QImageCacheEntry *entry, QImageCacheTime now)
+{
+    if (entry->previousUse == 0)
+        unlinkUsedOnce(entry);
+    else
+        unlinkUse(&entry->uses[entry->last ^ 1]);
+    entry->previousUse = entry->lastUse;
+    entry->lastUse = now;
+    entry->last ^= 1;
+    linkUse(&entry->uses[entry->last]);
+}
+
+void QImageCacheShard::removeEntry(QImageCacheEntry *entry)
+{
+    unlinkUse(&entry->uses[entry->last]);
+    if (entry->previousUse == 0)
+        unlinkUsedOnce(entry);
+    else
+        unlinkUse(&entry->uses[entry->last ^ 1]);
+}
+
+/*
+    Publishes the rank of the entry that evictOne() discards next, so that
+    trimShards() can choose a shard without locking all of them.
+*/
+void QImageCacheShard::updateRank()
+{
+    if (oldestUsedOnce)
+        rank.store(oldestUsedOnce->lastUse & ~UsedTwice);
+    else if (oldestUse)
+        rank.store(oldestUse->entry->previousUse | UsedTwice);
+    else
+        rank.store(NoEntries);
+}
+
+/*
+    Discards the lowest ranked entry other than \a keep. The image is moved
+    to \a evicted, so that the caller can free it after unlocking. Returns
+    the cost of the entry, or 0 if there was none. The shard must be locked.
+
+    If there is no other entry used only once, the only uses in the history
+    that do not belong to an entry used twice are those of \a keep, so at
+    most two uses are skipped.
+*/
+qptrdiff QImageCacheShard::evictOne(const QString &keep, QImage *evicted)
+{
+    QImageCacheEntry *victim = oldestUsedOnce;
+    if (victim && victim->key->str() == keep)
+        victim = victim->newer;
+    for (QImageCacheUse *use = oldestUse; !victim && use; use = use->newer) {
+        if (use->entry->key->str() != keep)
+            victim = use->entry;
+    }
+    if (!victim)
+        return 0;
+    const qptrdiff cost = victim->cost;
+    removeEntry(victim);
+    evicted->swap(victim->image);
+    entries.remove(*victim->key);
+    updateRank();
+    ++evictions;
+    return cost;
+}
+
+/*
+    Discards entries other than \a keep until no more than \a limit bytes
+    are in use, always from the shard whose next entry to discard ranks
+    lowest, so that the order is the same as if the cache was not sharded.
+    Returns whether anything was discarded.
+*/
+bool QImageCachePrivate::trimShards(qptrdiff limit, const QString &keep)
+{
+    bool trimmed = false;
+    bool exhausted[ShardCount] = {};
+    while (totalCost.load() > limit) {
+        int lowest = -1;
+        QImageCacheTime lowestRank = QImageCacheShard::NoEntries;
+        for (int i = 0; i < ShardCount; ++i) {
+            const QImageCacheTime rank = shards[i].rank.load();
+            if (!exhausted[i] && rank < lowestRank) {
+                lowest = i;
+                lowestRank = rank;
+            }
+        }
+        if (lowest < 0)
+            break;
+
+        QImageCacheShard &s = shards[lowest];
+        QImage evicted;
+        QMutexLocker locker(&s.mutex);
+        if (const qptrdiff cost = s.evictOne(keep, &evicted)) {
+            totalCost.fetchAndAddRelaxed(-cost);
+            trimmed = true;
+        } else {
+            exhausted[lowest] = true;
+        }
+    }
+    return trimmed;
+}
+
+/*!
+    Constructs an empty image cache with the given \a parent.
+
+    Most applications use the cache returned by globalInstance().
+*/
+QImageCache::QImageCache(QObject *parent)
+    : QObject(*new QImageCachePrivate, parent)
+{
+    Q_D(QImageCache);
+    d->memoryPressureSignalIndex = d->signalIndex("memoryPressure(qint64,qint64)");
+}
+
+/*!
+    Destroys the cache and releases its images.
+*/
+QImageCache::~QImageCache()
+{
+}
+
+/*!
+    Returns the application-wide image cache.
+*/
+QImageCache *QImageCache::globalInstance()
+{
+    return theInstance();
+}
+
+/*!
+    \property QImageCache::maxCost
+    \brief the maximum number of bytes of image data held by the cache
+
+    The default is 10 MB. Lowering the limit discards entries until the
+    cache fits.
+*/
+qint64 QImageCache::maxCost() const
+{
+    Q_D(const QImageCache);
+    return d->maxCost.load();
+}
+
+void QImageCache::setMaxCost(qint64 bytes)
+{
+    Q_D(QImageCache);
+    const qptrdiff limit = qptrdiff(qBound<qint64>(0, bytes, std::numeric_limits<qptrdiff>::max()));
+    d->maxCost.store(limit);
+    d->trimShards(limit);
+}
+
+/*!
+    Returns the number of bytes of image data in the cache.
+*/
+qint64 QImageCache::totalCost() const
+{
+    Q_D(const QImageCache);
+    return d->totalCost.load();
+}
+
+/*!
+    Returns the number of images in the cache.
+*/
+int QImageCache::count() const
+{
+    Q_D(const QImageCache);
+    int n = 0;
+    for (const QImageCacheShard &s : d->shards) {
+        QMutexLocker locker(&s.mutex);
+        n += s.entries.size();
+    }
+    return n;
+}
+
+/*!
+    Inserts a copy of \a image into the cache under \a key, replacing any
+    image already stored under that key. Since QImage is implicitly
+    shared, this does not copy the pixel data.
+
+    Returns \c true if the image was inserted. Null images and images
+    larger than maxCost() are not inserted, and any previous entry for
+    \a key is removed.
+
+    \sa find(), remove()
+*/
+bool QImageCache::insert(const QString &key, const QImage &image)
+{
+    Q_D(QImageCache);
+    const qptrdiff cost = image.sizeInBytes();
+    const qptrdiff limit = d->maxCost.load();
+    if (image.isNull() || cost > limit) {
+        remove(key);
+        return false;
+    }
+
+    const QImageCacheKey lookup(key, qHash(key));
+    QImageCacheShard &s = d->shard(lookup.hash);
+    qptrdiff total;
+    {
+        QImage previous; // freed after unlocking
+        qptrdiff added = cost;
+        QMutexLocker locker(&s.mutex);
+        auto it = s.entries.find(lookup);
+        bool rankChanged;
+        if (it != s.entries.end()) {
+            // replacing an entry counts as using it
+            added -= it->cost;
+            previous.swap(it->image);
+            rankChanged = s.isNextToDiscard(&*it);
+            s.useEntry(&*it, d->tick(s));
+        } else {
+            // copied into the hash, so that no temporary image is made
+            static const QImageCacheEntry blank = QImageCacheEntry();
+            it = s.entries.insert(lookup, blank);
+            rankChanged = !s.oldestUsedOnce;
+            s.insertEntry(&*it, &it.key(), d->tick(s));
+        }
+        it->image = image;
+        it->cost = cost;
+        if (rankChanged)
+            s.updateRank();
+        total = d->totalCost.fetchAndAddRelaxed(added) + added;
+    }
+
+    if (total > limit && d->trimShards(limit, key)
+            && d->isSignalConnected(d->memoryPressureSignalIndex)) {
+        emit memoryPressure(d->totalCost.load(), limit);
+    }
+    return true;
+}
+
+/*!
+    \overload
+
+    Inserts \a pixmap into the cache under \a key. The pixel data is shared
+    with the pixmap, not copied.
+
+    Returns \c false if \a pixmap is not backed by the raster platform
+    pixmap, since other pixmaps cannot be used from other threads.
+*/
+bool QImageCache::insert(const QString &key, const QPixmap &pixmap)
+{
+    QPlatformPixmap *pd = pixmap.handle();
+    if (!pd || pd->classId() != QPlatformPixmap::RasterClass)
+        return false;
+    return insert(key, pixmap.toImage());
+}
+
+/*!
+    Looks up \a key and, if the cache contains an image for it, assigns it
+    to \a image and returns \c true. Otherwise returns \c false and leaves
+    \a image unchanged.
+
+    \sa insert(), contains()
+*/
+bool QImageCache::find(const QString &key, QImage *image)
+{
+    Q_D(QImageCache);
+    const QImageCacheKey lookup(key, qHash(key));
+    QImageCacheShard &s = d->shard(lookup.hash);
+    QMutexLocker locker(&s.mutex);
+    const auto it = s.entries.find(lookup);
+    if (it == s.entries.end()) {
+        ++s.misses;
+        return false;
+    }
+    ++s.hits;
+    const bool rankChanged = s.isNextToDiscard(&*it);
+    s.useEntry(&*it, d->tick(s));
+    if (rankChanged)
+        s.updateRank();
+    if (image)
+        *image = it->image;
+    return true;
+}
+
+/*!
+    \overload
+
+    Looks up \a key and, if the cache contains an image for it, assigns
+    it to \a pixmap and returns \c true. Images that are in the format the
+    raster platform pixmap uses, such as images inserted as pixmaps, are
+    shared with \a pixmap instead of being converted.
+*/
+bool QImageCache::find(const QString &key, QPixmap *pixmap)
+{
+    QImage image;
+    if (!find(key, &image))
+        return false;
+    if (pixmap)
+        *pixmap = QPixmap::fromImage(image);
+    return true;
+}
+
+/*!
+    Returns \c true if the cache contains an image for \a key. Unlike
+    find(), this does not count as a use of the entry.
+*/
+bool QImageCache::contains(const QString &key) const
+{
+    Q_D(const QImageCache);
+    const QImageCacheKey lookup(key, qHash(key));
+    const QImageCacheShard &s = d->shard(lookup.hash);
+    QMutexLocker locker(&s.mutex);
+    return s.entries.contains(lookup);
+}
+
+/*!
+    Removes the image stored under \a key. Returns \c true if there was
+    one.
+*/
+bool QImageCache::remove(const QString &key)
+{
+    Q_D(QImageCache);
+    const QImageCacheKey lookup(key, qHash(key));
+    QImageCacheShard &s = d->shard(lookup.hash);
+    QImage image;
+    QMutexLocker locker(&s.mutex);
+    const auto it = s.entries.find(lookup);
+    if (it == s.entries.end())
+        return false;
+    image.swap(it->image);
+    const bool rankChanged = s.isNextToDiscard(&*it);
+    s.removeEntry(&*it);
+    d->totalCost.fetchAndAddRelaxed(-it->cost);
+    s.entries.erase(it);
+    if (rankChanged)
+        s.updateRank();
+    return true;
+}
+
+/*!
+    Discards entries, least valuable first, until no more than \a bytes of
+    image data are in use. Call this when the system reports that memory is
+    running low.
+
+    \sa memoryPressure()
+*/
+void QImageCache::trim(qint64 bytes)
+{
+    Q_D(QImageCache);
+    d->trimShards(qptrdiff(qBound<qint64>(0, bytes, std::numeric_limits<qptrdiff>::max())));
+}
+
+/*!
+    Removes all images from the cache. The statistics are kept.
+*/
+void QImageCache::clear()
+{
+    Q_D(QImageCache);
+    for (QImageCacheShard &s : d->shards) {
+        QImageCacheHash entries;
+        QMutexLocker locker(&s.mutex);
+        entries.swap(s.entries);
+        s.oldestUsedOnce = s.newestUsedOnce = nullptr;
+        s.oldestUse = s.newestUse = nullptr;
+        s.rank.store(QImageCacheShard::NoEntries);
+        qptrdiff cost = 0;
+        for (const QImageCacheEntry &entry : qAsConst(entries))
+            cost += entry.cost;
+        d->totalCost.fetchAndAddRelaxed(-cost);
+    }
+}
+
+/*!
+    Returns how often find() found an image since the cache was created or
+    the statistics were last reset.
+
+    \sa missCount(), resetStatistics()
+*/
+quint64 QImageCache::hitCount() const
+{
+    Q_D(const QImageCache);
+    quint64 n = 0;
+    for (const QImageCacheShard &s : d->shards) {
+        QMutexLocker locker(&s.mutex);
+        n += s.hits;
+    }
+    return n;
+}
+
+/*!
+    Returns how often find() did not find an image since the cache was
+    created or the statistics were last reset.
+
+    \sa hitCount(), resetStatistics()
+*/
+quint64 QImageCache::missCount() const
+{
+    Q_D(const QImageCache);
+    quint64 n = 0;
+    for (const QImageCacheShard &s : d->shards) {
+        QMutexLocker locker(&s.mutex);
+        n += s.misses;
+    }
+    return n;
+}
+
+/*!
+    Returns how many entries were discarded to stay within the cost limit
+    since the cache was created or the statistics were last reset. Entries
+    removed with remove() or clear() are not counted.
+
+    \sa resetStatistics()
+*/
+quint64 QImageCache::evictionCount() const
+{
+    Q_D(const QImageCache);
+    quint64 n = 0;
+    for (const QImageCacheShard &s : d->shards) {
+        QMutexLocker locker(&s.mutex);
+        n += s.evictions;
+    }
+    return n;
+}
+
+/*!
+    Sets the hit, miss and eviction counts to zero.
+*/
+void QImageCache::resetStatistics()
+{
+    Q_D(QImageCache);
+    for (QImageCacheShard &s : d->shards) {
+        QMutexLocker locker(&s.mutex);
+        s.hits = s.misses = s.evictions = 0;
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QIMAGECACHE_H
+#define QIMAGECACHE_H
+
+#include <QtGui/qtguiglobal.h>
+#include <QtCore/qobject.h>
+
+QT_BEGIN_NAMESPACE
+
+
+class QImage;
+class QPixmap;
+class QImageCachePrivate;
+
+class Q_GUI_EXPORT QImageCache : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QImageCache)
+
+    Q_PROPERTY(qint64 maxCost READ maxCost WRITE setMaxCost)
+
+public:
+    explicit QImageCache(QObject *parent = Q_NULLPTR);
+    ~QImageCache();
+
+    static QImageCache *globalInstance();
+
+    qint64 maxCost() const;
+    void setMaxCost(qint64 bytes);
+    qint64 totalCost() const;
+    int count() const;
+
+    bool insert(const QString &key, const QImage &image);
+    bool insert(const QString &key, const QPixmap &pixmap);
+    bool find(const QString &key, QImage *image);
+    bool find(const QString &key, QPixmap *pixmap);
+    bool contains(const QString &key) const;
+    bool remove(const QString &key);
+    void trim(qint64 bytes);
+    void clear();
+
+    quint64 hitCount() const;
+    quint64 missCount() const;
+    quint64 evictionCount() const;
+    void resetStatistics();
+
+Q_SIGNALS:
+    void memoryPressure(qint64 totalCost, qint64 maxCost);
+
+private:
+    Q_DISABLE_COPY(QImageCache)
+};
+
+QT_END_NAMESPACE
+
+#endif // QIMAGECACHE_H
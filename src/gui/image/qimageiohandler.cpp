@@ -172,6 +172,11 @@
 
     \value TransformedByDefault. A handler that reports support for this feature
     will have image transformation metadata applied by default on read.
+
+    \value IncrementalReadFinished Whether the image that is being read
+    with IncrementalReading set is complete (a bool). Handlers that support
+    IncrementalReading are expected to return it from option(); it cannot
+    be set. This value was added in Qt 5.11.
 */
 
 /*! \enum QImageIOHandler::Transformation
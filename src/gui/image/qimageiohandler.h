@@ -98,6 +98,7 @@ public:
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
         , TransformedByDefault
 #endif
+        , IncrementalReadFinished
     };
 
     enum Transformation {
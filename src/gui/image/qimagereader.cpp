@@ -146,6 +146,10 @@
 #include <qsize.h>
 #include <qcolor.h>
 #include <qvariant.h>
+#include <qvector.h>
+#include <qrunnable.h>
+#include <qsemaphore.h>
+#include <qthreadpool.h>
 
 // factory loader
 #include <qcoreapplication.h>
@@ -509,6 +513,7 @@ public:
     bool deleteDevice;
     QImageIOHandler *handler;
     bool initHandler();
+    bool incrementalReading;
 
     // image options
     QRect clipRect;
@@ -539,6 +544,7 @@ QImageReaderPrivate::QImageReaderPrivate(QImageReader *qq)
     device = 0;
     deleteDevice = false;
     handler = 0;
+    incrementalReading = false;
     quality = -1;
     imageReaderError = QImageReader::UnknownError;
     autoTransform = UsePluginDefault;
@@ -816,6 +822,7 @@ void QImageReader::setDevice(QIODevice *device)
     d->deleteDevice = false;
     delete d->handler;
     d->handler = 0;
+    d->incrementalReading = false;
     d->text.clear();
 }
 
@@ -1378,6 +1385,91 @@ bool QImageReader::read(QImage *image)
     return true;
 }
 
+/*!
+    \since 5.11
+
+    Decodes as much of the image as the data currently available on the
+    device allows, without waiting for more data, and stores the partially
+    decoded image in \a image. If \a updatedRect is not null, it is set to
+    the part of the image that changed since the previous call. Returns
+    \c true on success; returns \c false if the data is corrupt or the
+    format does not support incremental reading.
+
+    This is meant for devices that receive data over time, such as a
+    QNetworkReply: call this function whenever new data has arrived, for
+    example from a slot connected to QIODevice::readyRead(), until
+    isIncrementalReadFinished() returns \c true. Rows that have not arrived
+    yet are transparent, or black for formats without an alpha channel. The
+    image stays null until enough data has arrived to know its size.
+
+    Pass the image returned by the previous call back in; this lets the
+    decoder continue writing into it instead of copying it. For animations,
+    calling this function after a frame has finished continues with the
+    next frame.
+
+    Incremental reading is supported by the PNG and GIF formats, see
+    supportsOption() with QImageIOHandler::IncrementalReading. The clip
+    rect, scaled size and automatic transformation settings are not applied
+    to incrementally read images, and read() should not be used on the same
+    reader.
+
+    \sa isIncrementalReadFinished(), read()
+*/
+bool QImageReader::readIncrementally(QImage *image, QRect *updatedRect)
+{
+    if (!image) {
+        qWarning("QImageReader::readIncrementally: cannot read into null pointer");
+        return false;
+    }
+    if (updatedRect)
+        *updatedRect = QRect();
+
+    if (!d->handler) {
+        // wait for enough data to recognize the image format
+        if (d->device && d->device->isOpen() && d->device->isSequential()
+            && d->device->bytesAvailable() < 16) {
+            return true;
+        }
+        if (!d->initHandler())
+            return false;
+    }
+
+    if (!d->incrementalReading) {
+        if (!d->handler->supportsOption(QImageIOHandler::IncrementalReading)) {
+            d->imageReaderError = UnsupportedFormatError;
+            d->errorString = QImageReader::tr("Incremental reading is not supported for this image format");
+            return false;
+        }
+        d->handler->setOption(QImageIOHandler::IncrementalReading, true);
+        d->incrementalReading = true;
+    }
+
+    if (!d->handler->read(image)) {
+        d->imageReaderError = InvalidDataError;
+        d->errorString = QImageReader::tr("Unable to read image data");
+        return false;
+    }
+
+    if (updatedRect)
+        *updatedRect = d->handler->currentImageRect();
+    return true;
+}
+
+/*!
+    \since 5.11
+
+    Returns \c true if the image that readIncrementally() is decoding is
+    complete; otherwise returns \c false.
+
+    \sa readIncrementally()
+*/
+bool QImageReader::isIncrementalReadFinished() const
+{
+    if (!d->incrementalReading)
+        return false;
+    return d->handler->option(QImageIOHandler::IncrementalReadFinished).toBool();
+}
+
 /*!
    For image formats that support animation, this function steps over the
    current image, returning true if successful or false if there is no
@@ -1644,4 +1736,94 @@ QList<QByteArray> QImageReader::supportedMimeTypes()
     return mimeTypes;
 }
 
+namespace {
+struct QImageThumbnailJob
+{
+    QImageThumbnailJob(const QStringList &fileNames, const QSize &size, QImage *images)
+        : fileNames(fileNames), size(size), images(images), next(0)
+    { }
+
+    // Called from every participating thread; each thread takes the next
+    // file that nobody has started on yet.
+    void work()
+    {
+        for (int i = next.fetchAndAddRelaxed(1); i < fileNames.size(); i = next.fetchAndAddRelaxed(1)) {
+            QImageReader reader(fileNames.at(i));
+            const QSize imageSize = reader.size();
+            if (size.isValid() && (imageSize.width() > size.width() || imageSize.height() > size.height()))
+                reader.setScaledSize(imageSize.scaled(size, Qt::KeepAspectRatio).expandedTo(QSize(1, 1)));
+            images[i] = reader.read();
+        }
+    }
+
+    const QStringList &fileNames;
+    const QSize size;
+    QImage *images;
+    QAtomicInt next;
+};
+
+#ifndef QT_NO_THREAD
+class QImageThumbnailRunnable : public QRunnable
+{
+public:
+    QImageThumbnailRunnable(QImageThumbnailJob *job, QSemaphore *done)
+        : job(job), done(done)
+    { }
+
+    void run() override
+    {
+        job->work();
+        done->release();
+    }
+
+private:
+    QImageThumbnailJob *job;
+    QSemaphore *done;
+};
+#endif
+} // unnamed namespace
+
+/*!
+    \since 5.11
+
+    Reads the images in \a fileNames, scaled down to fit within \a size
+    while keeping their aspect ratio, and returns them in the same order.
+    Images that already fit are not scaled up; if \a size is invalid, the
+    images are read at their full size. A null image is returned for each
+    file that could not be read.
+
+    The files are decoded concurrently on the global thread pool. The
+    scaling is done with setScaledSize(), so formats that can decode
+    directly at a reduced size, such as JPEG, only do the work the
+    thumbnail needs.
+
+    \sa setScaledSize(), QThreadPool::globalInstance()
+*/
+QVector<QImage> QImageReader::readThumbnails(const QStringList &fileNames, const QSize &size)
+{
+    QVector<QImage> images(fileNames.size());
+    QImageThumbnailJob job(fileNames, size, images.data());
+
+#ifndef QT_NO_THREAD
+    QThreadPool *pool = QThreadPool::globalInstance();
+    QSemaphore done;
+    int started = 0;
+    const int helpers = qMin(pool->maxThreadCount(), fileNames.size()) - 1;
+    for (int i = 0; i < helpers; ++i) {
+        QImageThumbnailRunnable *runnable = new QImageThumbnailRunnable(&job, &done);
+        if (!pool->tryStart(runnable)) {
+            delete runnable;
+            break;
+        }
+        ++started;
+    }
+    job.work();
+    done.acquire(started);
+#else
+    job.work();
+#endif
+
+    return images;
+}
+
 QT_END_NAMESPACE
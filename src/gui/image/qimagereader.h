@@ -127,6 +127,9 @@ public:
     QImage read();
     bool read(QImage *image);
 
+    bool readIncrementally(QImage *image, QRect *updatedRect = Q_NULLPTR);
+    bool isIncrementalReadFinished() const;
+
     bool jumpToNextImage();
     bool jumpToImage(int imageNumber);
     int loopCount() const;
@@ -145,6 +148,8 @@ public:
     static QList<QByteArray> supportedImageFormats();
     static QList<QByteArray> supportedMimeTypes();
 
+    static QVector<QImage> readThumbnails(const QStringList &fileNames, const QSize &size);
+
 private:
     Q_DISABLE_COPY(QImageReader)
     QImageReaderPrivate *d;
@@ -99,7 +99,8 @@ public:
     };
 
     QPngHandlerPrivate(QPngHandler *qq)
-        : gamma(0.0), fileGamma(0.0), quality(2), png_ptr(0), info_ptr(0), end_info(0), state(Ready), q(qq)
+        : gamma(0.0), fileGamma(0.0), quality(2), png_ptr(0), info_ptr(0), end_info(0),
+          incrementalReading(false), incrementalFinished(false), state(Ready), q(qq)
     { }
 
     float gamma;
@@ -117,6 +118,15 @@ public:
     bool readPngImage(QImage *image);
     void readPngTexts(png_info *info);
 
+    // incremental reading, driven by libpng's progressive reader
+    bool incrementalReading;
+    bool incrementalFinished;
+    QImage incrementalImage;
+    QRect incrementalUpdate;
+
+    bool startPngIncrementalRead();
+    bool readPngImageIncrementally(QImage *image);
+
     QImage::Format readImageFormat();
 
     struct AllocatedMemoryPointers {
@@ -653,6 +663,171 @@ bool QPngHandlerPrivate::readPngImage(QImage *outImage)
     return true;
 }
 
+extern "C" {
+static
+void qt_png_progressive_info(png_structp png_ptr, png_infop info_ptr)
+{
+    QPngHandlerPrivate *d = (QPngHandlerPrivate *)png_get_progressive_ptr(png_ptr);
+
+    d->readPngTexts(info_ptr);
+    if (png_get_valid(png_ptr, info_ptr, PNG_INFO_gAMA)) {
+        double file_gamma = 0.0;
+        png_get_gAMA(png_ptr, info_ptr, &file_gamma);
+        d->fileGamma = file_gamma;
+    }
+    d->state = QPngHandlerPrivate::ReadHeader;
+
+    QImage &image = d->incrementalImage;
+    setup_qt(image, png_ptr, info_ptr, QSize(), 0, d->gamma, d->fileGamma);
+    if (image.isNull()) {
+        png_error(png_ptr, "Out of memory");
+        return;
+    }
+
+    // Rows that have not arrived yet are shown as transparent, or black
+    // for formats without alpha
+    if (image.hasAlphaChannel())
+        image.fill(Qt::transparent);
+    else
+        image.fill(0);
+
+    png_int_32 offset_x = 0;
+    png_int_32 offset_y = 0;
+    int unit_type = PNG_OFFSET_PIXEL;
+    png_get_oFFs(png_ptr, info_ptr, &offset_x, &offset_y, &unit_type);
+    image.setDotsPerMeterX(png_get_x_pixels_per_meter(png_ptr, info_ptr));
+    image.setDotsPerMeterY(png_get_y_pixels_per_meter(png_ptr, info_ptr));
+    if (unit_type == PNG_OFFSET_PIXEL)
+        image.setOffset(QPoint(offset_x, offset_y));
+}
+
+static
+void qt_png_progressive_row(png_structp png_ptr, png_bytep new_row, png_uint_32 row_num, int /*pass*/)
+{
+    // libpng reports every row of an interlaced image in every pass, but
+    // only passes data for the rows that the pass changes
+    if (!new_row)
+        return;
+
+    QPngHandlerPrivate *d = (QPngHandlerPrivate *)png_get_progressive_ptr(png_ptr);
+    QImage &image = d->incrementalImage;
+    if (int(row_num) >= image.height())
+        return;
+
+    uchar *line = image.scanLine(row_num);
+    png_progressive_combine_row(png_ptr, line, new_row);
+
+    // sanity check palette entries
+    if (png_get_color_type(png_ptr, d->info_ptr) == PNG_COLOR_TYPE_PALETTE
+        && image.format() == QImage::Format_Indexed8) {
+        const int color_table_size = image.colorCount();
+        for (uchar *p = line, *end = line + image.width(); p < end; ++p) {
+            if (*p >= color_table_size)
+                *p = 0;
+        }
+    }
+
+    d->incrementalUpdate |= QRect(0, row_num, image.width(), 1);
+}
+
+static
+void qt_png_progressive_end(png_structp png_ptr, png_infop info_ptr)
+{
+    QPngHandlerPrivate *d = (QPngHandlerPrivate *)png_get_progressive_ptr(png_ptr);
+
+    // info_ptr now also holds the text chunks that followed the image data
+    d->description.clear();
+    d->readTexts.clear();
+    d->readPngTexts(info_ptr);
+    for (int i = 0; i < d->readTexts.size() - 1; i += 2)
+        d->incrementalImage.setText(d->readTexts.at(i), d->readTexts.at(i + 1));
+
+    d->incrementalFinished = true;
+}
+}
+
+bool QPngHandlerPrivate::startPngIncrementalRead()
+{
+    png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING,0,0,0);
+    if (!png_ptr)
+        return false;
+
+    png_set_error_fn(png_ptr, 0, 0, qt_png_warning);
+
+#if defined(PNG_SET_OPTION_SUPPORTED) && defined(PNG_MAXIMUM_INFLATE_WINDOW)
+    png_set_option(png_ptr, PNG_MAXIMUM_INFLATE_WINDOW, PNG_OPTION_ON);
+#endif
+
+    info_ptr = png_create_info_struct(png_ptr);
+    if (!info_ptr) {
+        png_destroy_read_struct(&png_ptr, 0, 0);
+        png_ptr = 0;
+        return false;
+    }
+
+    png_set_progressive_read_fn(png_ptr, this, qt_png_progressive_info,
+                                qt_png_progressive_row, qt_png_progressive_end);
+    return true;
+}
+
+/*!
+    \internal
+
+    Feeds the data that is currently available on the device to libpng's
+    progressive reader and returns the partially decoded image in
+    \a outImage. Returns \c false only if the data is corrupt.
+*/
+bool QPngHandlerPrivate::readPngImageIncrementally(QImage *outImage)
+{
+    if (state == Error)
+        return false;
+
+    incrementalUpdate = QRect();
+    if (incrementalFinished) {
+        // start over with the next image in the stream
+        incrementalFinished = false;
+        incrementalImage = QImage();
+    }
+
+    // If the caller passed back the image we returned last time, drop its
+    // reference so that decoding the next rows does not detach the image.
+    if (!outImage->isNull() && outImage->constBits() == incrementalImage.constBits())
+        *outImage = QImage();
+
+    if (!png_ptr) {
+        if (!startPngIncrementalRead()) {
+            state = Error;
+            return false;
+        }
+    }
+
+    if (setjmp(png_jmpbuf(png_ptr))) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, 0);
+        png_ptr = 0;
+        incrementalImage = QImage();
+        state = Error;
+        return false;
+    }
+
+    QIODevice *in = q->device();
+    char buffer[16384];
+    while (!incrementalFinished) {
+        const qint64 nr = in->read(buffer, sizeof(buffer));
+        if (nr <= 0)
+            break;
+        png_process_data(png_ptr, info_ptr, (png_bytep)buffer, png_size_t(nr));
+    }
+
+    if (incrementalFinished) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, 0);
+        png_ptr = 0;
+        state = Ready;
+    }
+
+    *outImage = incrementalImage;
+    return true;
+}
+
 QImage::Format QPngHandlerPrivate::readImageFormat()
 {
         QImage::Format format = QImage::Format_Invalid;
@@ -1019,6 +1194,8 @@ bool QPngHandler::canRead(QIODevice *device)
 
 bool QPngHandler::read(QImage *image)
 {
+    if (d->incrementalReading)
+        return d->readPngImageIncrementally(image);
     if (!canRead())
         return false;
     return d->readPngImage(image);
@@ -1036,14 +1213,20 @@ bool QPngHandler::supportsOption(ImageOption option) const
         || option == ImageFormat
         || option == Quality
         || option == Size
-        || option == ScaledSize;
+        || option == ScaledSize
+        || option == IncrementalReading;
 }
 
 QVariant QPngHandler::option(ImageOption option) const
 {
+    if (option == IncrementalReading)
+        return d->incrementalReading;
+    if (option == IncrementalReadFinished)
+        return d->incrementalFinished;
     if (d->state == QPngHandlerPrivate::Error)
         return QVariant();
-    if (d->state == QPngHandlerPrivate::Ready && !d->readPngHeader())
+    // in incremental mode the header is only known once it has arrived
+    if (d->state == QPngHandlerPrivate::Ready && (d->incrementalReading || !d->readPngHeader()))
         return QVariant();
 
     if (option == Gamma)
@@ -1072,6 +1255,13 @@ void QPngHandler::setOption(ImageOption option, const QVariant &value)
         d->description = value.toString();
     else if (option == ScaledSize)
         d->scaledSize = value.toSize();
+    else if (option == IncrementalReading)
+        d->incrementalReading = value.toBool();
+}
+
+QRect QPngHandler::currentImageRect() const
+{
+    return d->incrementalUpdate;
 }
 
 QByteArray QPngHandler::name() const
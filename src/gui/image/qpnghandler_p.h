@@ -75,6 +75,8 @@ public:
     void setOption(ImageOption option, const QVariant &value) override;
     bool supportsOption(ImageOption option) const override;
 
+    QRect currentImageRect() const override;
+
     static bool canRead(QIODevice *device);
 
 private:
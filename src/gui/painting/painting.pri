@@ -50,6 +50,8 @@ HEADERS += \
         painting/qrgba64_p.h \
         painting/qstroker_p.h \
         painting/qtextureglyphcache_p.h \
+        painting/qtiledimagepaintdevice.h \
+        painting/qtiledimagepaintdevice_p.h \
         painting/qtransform.h \
         painting/qtriangulatingstroker_p.h \
         painting/qtriangulator_p.h \
@@ -93,6 +95,7 @@ SOURCES += \
         painting/qregion.cpp \
         painting/qstroker.cpp \
         painting/qtextureglyphcache.cpp \
+        painting/qtiledimagepaintdevice.cpp \
         painting/qtransform.cpp \
         painting/qtriangulatingstroker.cpp \
         painting/qtriangulator.cpp \
@@ -123,6 +126,7 @@ SSSE3_SOURCES += painting/qdrawhelper_ssse3.cpp
 SSE4_1_SOURCES += painting/qdrawhelper_sse4.cpp \
                   painting/qimagescale_sse4.cpp
 AVX2_SOURCES += painting/qdrawhelper_avx2.cpp
+AVX512CORE_SOURCES += painting/qdrawhelper_avx512.cpp
 
 NEON_SOURCES += painting/qdrawhelper_neon.cpp painting/qimagescale_neon.cpp
 NEON_HEADERS += painting/qdrawhelper_neon_p.h
@@ -3336,21 +3336,6 @@ static inline SourceFetchProc getSourceFetch(TextureBlendType blendType, QImage:
 }
 
 
-#define FIXPT_BITS 8
-#define FIXPT_SIZE (1<<FIXPT_BITS)
-
-static uint qt_gradient_pixel_fixed(const QGradientData *data, int fixed_pos)
-{
-    int ipos = (fixed_pos + (FIXPT_SIZE / 2)) >> FIXPT_BITS;
-    return data->colorTable32[qt_gradient_clamp(data, ipos)];
-}
-
-static const QRgba64& qt_gradient_pixel64_fixed(const QGradientData *data, int fixed_pos)
-{
-    int ipos = (fixed_pos + (FIXPT_SIZE / 2)) >> FIXPT_BITS;
-    return data->colorTable64[qt_gradient_clamp(data, ipos)];
-}
-
 static void QT_FASTCALL getLinearGradientValues(LinearGradientValues *v, const QSpanData *data)
 {
     v->dx = data->gradient.linear.end.x - data->gradient.linear.origin.x;
@@ -3364,6 +3349,32 @@ static void QT_FASTCALL getLinearGradientValues(LinearGradientValues *v, const Q
     }
 }
 
+static void QT_FASTCALL qt_fetch_linear_gradient_fixed_plain(uint *buffer, int length, const QGradientData *gradient,
+                                                              int t, int inc)
+{
+    for (int i = 0; i < length; ++i) {
+        buffer[i] = qt_gradient_pixel_fixed(gradient, t);
+        t += inc;
+    }
+}
+
+static void QT_FASTCALL qt_fetch_linear_gradient_fixed_rgb64_plain(QRgba64 *buffer, int length, const QGradientData *gradient,
+                                                                    int t, int inc)
+{
+    for (int i = 0; i < length; ++i) {
+        buffer[i] = qt_gradient_pixel64_fixed(gradient, t);
+        t += inc;
+    }
+}
+
+typedef void (QT_FASTCALL *LinearGradientFixedFetchFunc)(uint *buffer, int length, const QGradientData *gradient,
+                                                         int t, int inc);
+typedef void (QT_FASTCALL *LinearGradientFixedFetchFunc64)(QRgba64 *buffer, int length, const QGradientData *gradient,
+                                                           int t, int inc);
+
+static LinearGradientFixedFetchFunc qt_fetch_linear_gradient_fixed = qt_fetch_linear_gradient_fixed_plain;
+static LinearGradientFixedFetchFunc64 qt_fetch_linear_gradient_fixed_rgb64 = qt_fetch_linear_gradient_fixed_rgb64_plain;
+
 class GradientBase32
 {
 public:
@@ -3377,6 +3388,10 @@ public:
     {
         return qt_gradient_pixel_fixed(&gradient, v);
     }
+    static void fetchFixed(Type *buffer, int length, const QGradientData& gradient, int t, int inc)
+    {
+        qt_fetch_linear_gradient_fixed(buffer, length, &gradient, t, inc);
+    }
     static void memfill(Type *buffer, Type fill, int length)
     {
         qt_memfill32(buffer, fill, length);
@@ -3396,6 +3411,10 @@ public:
     {
         return qt_gradient_pixel64_fixed(&gradient, v);
     }
+    static void fetchFixed(Type *buffer, int length, const QGradientData& gradient, int t, int inc)
+    {
+        qt_fetch_linear_gradient_fixed_rgb64(buffer, length, &gradient, t, inc);
+    }
     static void memfill(Type *buffer, Type fill, int length)
     {
         qt_memfill64((quint64*)buffer, fill, length);
@@ -3437,11 +3456,7 @@ static inline const BlendType * QT_FASTCALL qt_fetch_linear_gradient_template(
                 // we can use fixed point math
                 int t_fixed = int(t * FIXPT_SIZE);
                 int inc_fixed = int(inc * FIXPT_SIZE);
-                while (buffer < end) {
-                    *buffer = GradientBase::fetchSingle(data->gradient, t_fixed);
-                    t_fixed += inc_fixed;
-                    ++buffer;
-                }
+                GradientBase::fetchFixed(buffer, length, data->gradient, t_fixed, inc_fixed);
             } else {
                 // we have to fall back to float math
                 while (buffer < end) {
@@ -6281,6 +6296,9 @@ void qt_memfill32(quint32 *dest, quint32 color, int count)
 #ifdef QT_COMPILER_SUPPORTS_SSE4_1
 template<QtPixelOrder> const uint *QT_FASTCALL convertA2RGB30PMFromARGB32PM_sse4(uint *buffer, const uint *src, int count, const QVector<QRgb> *, QDitherInfo *);
 #endif
+#ifdef QT_COMPILER_SUPPORTS_AVX2
+template<QtPixelOrder> const QRgba64 *QT_FASTCALL convertA2RGB30PMToARGB64PM_avx2(QRgba64 *buffer, const uint *src, int count, const QVector<QRgb> *, QDitherInfo *);
+#endif
 
 extern void qInitBlendFunctions();
 
@@ -6416,6 +6434,71 @@ static void qInitDrawhelperFunctions()
         bilinearFastTransformHelperARGB32PM[0][SimpleUpscaleTransform] = fetchTransformedBilinearARGB32PM_simple_upscale_helper_avx2;
         bilinearFastTransformHelperARGB32PM[0][DownscaleTransform] = fetchTransformedBilinearARGB32PM_downscale_helper_avx2;
         bilinearFastTransformHelperARGB32PM[0][FastRotateTransform] = fetchTransformedBilinearARGB32PM_fast_rotate_helper_avx2;
+
+        extern void QT_FASTCALL comp_func_Plus_avx2(uint *destPixels, const uint *srcPixels, int length, uint const_alpha);
+        extern void QT_FASTCALL comp_func_SourceOver_rgb64_avx2(QRgba64 *destPixels, const QRgba64 *srcPixels, int length, uint const_alpha);
+        extern void QT_FASTCALL comp_func_solid_SourceOver_rgb64_avx2(QRgba64 *destPixels, int length, QRgba64 color, uint const_alpha);
+        extern void QT_FASTCALL comp_func_Source_rgb64_avx2(QRgba64 *destPixels, const QRgba64 *srcPixels, int length, uint const_alpha);
+        extern void QT_FASTCALL comp_func_Plus_rgb64_avx2(QRgba64 *destPixels, const QRgba64 *srcPixels, int length, uint const_alpha);
+        qt_functionForMode_C[QPainter::CompositionMode_Plus] = comp_func_Plus_avx2;
+        qt_functionForMode64_C[QPainter::CompositionMode_SourceOver] = comp_func_SourceOver_rgb64_avx2;
+        qt_functionForModeSolid64_C[QPainter::CompositionMode_SourceOver] = comp_func_solid_SourceOver_rgb64_avx2;
+        qt_functionForMode64_C[QPainter::CompositionMode_Source] = comp_func_Source_rgb64_avx2;
+        qt_functionForMode64_C[QPainter::CompositionMode_Plus] = comp_func_Plus_rgb64_avx2;
+
+        extern const uint *QT_FASTCALL convertARGB32ToARGB32PM_avx2(uint *buffer, const uint *src, int count,
+                                                                    const QVector<QRgb> *, QDitherInfo *);
+        extern const uint *QT_FASTCALL convertRGBA8888ToARGB32PM_avx2(uint *buffer, const uint *src, int count,
+                                                                      const QVector<QRgb> *, QDitherInfo *);
+        extern const QRgba64 *QT_FASTCALL convertARGB32ToARGB64PM_avx2(QRgba64 *buffer, const uint *src, int count,
+                                                                       const QVector<QRgb> *, QDitherInfo *);
+        extern const QRgba64 *QT_FASTCALL convertRGBA8888ToARGB64PM_avx2(QRgba64 *buffer, const uint *src, int count,
+                                                                         const QVector<QRgb> *, QDitherInfo *);
+        extern const uint *QT_FASTCALL convertGrayscale8ToRGB32_avx2(uint *buffer, const uint *src, int count,
+                                                                     const QVector<QRgb> *, QDitherInfo *);
+        extern const QRgba64 *QT_FASTCALL convertGrayscale8ToRGB64_avx2(QRgba64 *buffer, const uint *src, int count,
+                                                                        const QVector<QRgb> *, QDitherInfo *);
+        extern const uint *QT_FASTCALL convertGrayscale8FromRGB32_avx2(uint *buffer, const uint *src, int count,
+                                                                       const QVector<QRgb> *, QDitherInfo *);
+        qPixelLayouts[QImage::Format_ARGB32].convertToARGB32PM = convertARGB32ToARGB32PM_avx2;
+        qPixelLayouts[QImage::Format_RGBA8888].convertToARGB32PM = convertRGBA8888ToARGB32PM_avx2;
+        qPixelLayouts[QImage::Format_ARGB32].convertToARGB64PM = convertARGB32ToARGB64PM_avx2;
+        qPixelLayouts[QImage::Format_RGBA8888].convertToARGB64PM = convertRGBA8888ToARGB64PM_avx2;
+        qPixelLayouts[QImage::Format_BGR30].convertToARGB64PM = convertA2RGB30PMToARGB64PM_avx2<PixelOrderBGR>;
+        qPixelLayouts[QImage::Format_A2BGR30_Premultiplied].convertToARGB64PM = convertA2RGB30PMToARGB64PM_avx2<PixelOrderBGR>;
+        qPixelLayouts[QImage::Format_RGB30].convertToARGB64PM = convertA2RGB30PMToARGB64PM_avx2<PixelOrderRGB>;
+        qPixelLayouts[QImage::Format_A2RGB30_Premultiplied].convertToARGB64PM = convertA2RGB30PMToARGB64PM_avx2<PixelOrderRGB>;
+        qPixelLayouts[QImage::Format_Grayscale8].convertToARGB32PM = convertGrayscale8ToRGB32_avx2;
+        qPixelLayouts[QImage::Format_Grayscale8].convertToARGB64PM = convertGrayscale8ToRGB64_avx2;
+        qPixelLayouts[QImage::Format_Grayscale8].convertFromRGB32 = convertGrayscale8FromRGB32_avx2;
+
+        extern void QT_FASTCALL qt_fetch_linear_gradient_fixed_avx2(uint *buffer, int length, const QGradientData *gradient,
+                                                                    int t, int inc);
+        extern void QT_FASTCALL qt_fetch_linear_gradient_fixed_rgb64_avx2(QRgba64 *buffer, int length, const QGradientData *gradient,
+                                                                          int t, int inc);
+        qt_fetch_linear_gradient_fixed = qt_fetch_linear_gradient_fixed_avx2;
+        qt_fetch_linear_gradient_fixed_rgb64 = qt_fetch_linear_gradient_fixed_rgb64_avx2;
+    }
+#endif
+
+#if defined(QT_COMPILER_SUPPORTS_AVX512CORE)
+    if (qCpuHasFeature(AVX512F) && qCpuHasFeature(AVX512CD) && qCpuHasFeature(AVX512BW)
+            && qCpuHasFeature(AVX512DQ) && qCpuHasFeature(AVX512VL)) {
+        extern void QT_FASTCALL comp_func_SourceOver_avx512(uint *destPixels, const uint *srcPixels, int length, uint const_alpha);
+        extern void QT_FASTCALL comp_func_solid_SourceOver_avx512(uint *destPixels, int length, uint color, uint const_alpha);
+        qt_functionForMode_C[QPainter::CompositionMode_SourceOver] = comp_func_SourceOver_avx512;
+        qt_functionForModeSolid_C[QPainter::CompositionMode_SourceOver] = comp_func_solid_SourceOver_avx512;
+
+        extern const uint *QT_FASTCALL convertARGB32ToARGB32PM_avx512(uint *buffer, const uint *src, int count,
+                                                                      const QVector<QRgb> *, QDitherInfo *);
+        extern const uint *QT_FASTCALL convertRGBA8888ToARGB32PM_avx512(uint *buffer, const uint *src, int count,
+                                                                        const QVector<QRgb> *, QDitherInfo *);
+        qPixelLayouts[QImage::Format_ARGB32].convertToARGB32PM = convertARGB32ToARGB32PM_avx512;
+        qPixelLayouts[QImage::Format_RGBA8888].convertToARGB32PM = convertRGBA8888ToARGB32PM_avx512;
+
+        extern void QT_FASTCALL qt_fetch_linear_gradient_fixed_avx512(uint *buffer, int length, const QGradientData *gradient,
+                                                                      int t, int inc);
+        qt_fetch_linear_gradient_fixed = qt_fetch_linear_gradient_fixed_avx512;
     }
 #endif
 
@@ -39,6 +39,7 @@
 
 #include "qdrawhelper_p.h"
 #include "qdrawingprimitive_sse2_p.h"
+#include "qrgba64_p.h"
 
 #if defined(QT_COMPILER_SUPPORTS_AVX2)
 
@@ -350,6 +351,181 @@ void QT_FASTCALL comp_func_solid_SourceOver_avx2(uint *destPixels, int length, u
     }
 }
 
+void QT_FASTCALL comp_func_Plus_avx2(uint *dst, const uint *src, int length, uint const_alpha)
+{
+    int x = 0;
+
+    if (const_alpha == 255) {
+        // 1) Prologue: align destination on 32 bytes
+        ALIGNMENT_PROLOGUE_32BYTES(dst, x, length)
+            dst[x] = comp_func_Plus_one_pixel(dst[x], src[x]);
+
+        // 2) composition with AVX2
+        for (; x < length - 7; x += 8) {
+            const __m256i srcVector = _mm256_lddqu_si256((const __m256i *)&src[x]);
+            const __m256i dstVector = _mm256_load_si256((const __m256i *)&dst[x]);
+            _mm256_store_si256((__m256i *)&dst[x], _mm256_adds_epu8(srcVector, dstVector));
+        }
+
+        // 3) Epilogue
+        SIMD_EPILOGUE(x, length, 7)
+            dst[x] = comp_func_Plus_one_pixel(dst[x], src[x]);
+    } else {
+        const int one_minus_const_alpha = 255 - const_alpha;
+
+        // 1) Prologue: align destination on 32 bytes
+        ALIGNMENT_PROLOGUE_32BYTES(dst, x, length)
+            dst[x] = comp_func_Plus_one_pixel_const_alpha(dst[x], src[x], const_alpha, one_minus_const_alpha);
+
+        // 2) composition with AVX2
+        const __m256i half = _mm256_set1_epi16(0x80);
+        const __m256i colorMask = _mm256_set1_epi32(0x00ff00ff);
+        const __m256i constAlphaVector = _mm256_set1_epi16(const_alpha);
+        const __m256i oneMinusConstAlpha = _mm256_set1_epi16(one_minus_const_alpha);
+        for (; x < length - 7; x += 8) {
+            const __m256i srcVector = _mm256_lddqu_si256((const __m256i *)&src[x]);
+            __m256i dstVector = _mm256_load_si256((const __m256i *)&dst[x]);
+            const __m256i result = _mm256_adds_epu8(srcVector, dstVector);
+            INTERPOLATE_PIXEL_255_AVX2(result, dstVector, constAlphaVector, oneMinusConstAlpha, colorMask, half);
+            _mm256_store_si256((__m256i *)&dst[x], dstVector);
+        }
+
+        // 3) Epilogue
+        SIMD_EPILOGUE(x, length, 7)
+            dst[x] = comp_func_Plus_one_pixel_const_alpha(dst[x], src[x], const_alpha, one_minus_const_alpha);
+    }
+}
+
+// See multiplyAlpha65535() in qrgba64_p.h for details.
+static inline __m256i multiplyAlpha65535_avx2(const __m256i &rgba64, const __m256i &alpha)
+{
+    const __m256i low = _mm256_mullo_epi16(rgba64, alpha);
+    const __m256i high = _mm256_mulhi_epu16(rgba64, alpha);
+    __m256i vlo = _mm256_unpacklo_epi16(low, high);
+    __m256i vhi = _mm256_unpackhi_epi16(low, high);
+    const __m256i half = _mm256_set1_epi32(0x8000);
+    vlo = _mm256_add_epi32(vlo, _mm256_srli_epi32(vlo, 16));
+    vhi = _mm256_add_epi32(vhi, _mm256_srli_epi32(vhi, 16));
+    vlo = _mm256_srli_epi32(_mm256_add_epi32(vlo, half), 16);
+    vhi = _mm256_srli_epi32(_mm256_add_epi32(vhi, half), 16);
+    return _mm256_packus_epi32(vlo, vhi);
+}
+
+static inline __m256i interpolate255_avx2(const __m256i &x, uint alpha1, const __m256i &y, uint alpha2)
+{
+    return _mm256_add_epi16(multiplyAlpha65535_avx2(x, _mm256_set1_epi16(alpha1 * 257)),
+                            multiplyAlpha65535_avx2(y, _mm256_set1_epi16(alpha2 * 257)));
+}
+
+void QT_FASTCALL comp_func_SourceOver_rgb64_avx2(QRgba64 *dst, const QRgba64 *src, int length, uint const_alpha)
+{
+    Q_ASSERT(const_alpha < 256);
+    const __m256i alphaMask = _mm256_set1_epi64x(qint64(Q_UINT64_C(0xffff) << 48));
+    const __m256i alphaShuffleMask = _mm256_set_epi8(15,14,15,14,15,14,15,14, 7,6,7,6,7,6,7,6,
+                                                     15,14,15,14,15,14,15,14, 7,6,7,6,7,6,7,6);
+    const __m256i one = _mm256_set1_epi16(-1);
+
+    int x = 0;
+    if (const_alpha == 255) {
+        for (; x < length - 3; x += 4) {
+            const __m256i srcVector = _mm256_lddqu_si256((const __m256i *)&src[x]);
+            if (!_mm256_testz_si256(srcVector, alphaMask)) {
+                if (!_mm256_testc_si256(srcVector, alphaMask)) {
+                    const __m256i alphaChannel = _mm256_sub_epi16(one, _mm256_shuffle_epi8(srcVector, alphaShuffleMask));
+                    __m256i dstVector = _mm256_loadu_si256((const __m256i *)&dst[x]);
+                    dstVector = multiplyAlpha65535_avx2(dstVector, alphaChannel);
+                    _mm256_storeu_si256((__m256i *)&dst[x], _mm256_add_epi16(srcVector, dstVector));
+                } else {
+                    _mm256_storeu_si256((__m256i *)&dst[x], srcVector);
+                }
+            }
+        }
+        SIMD_EPILOGUE(x, length, 3) {
+            const QRgba64 s = src[x];
+            if (s.isOpaque())
+                dst[x] = s;
+            else if (!s.isTransparent())
+                dst[x] = QRgba64::fromRgba64(s + multiplyAlpha65535(dst[x], 65535 - s.alpha()));
+        }
+    } else {
+        const __m256i constAlphaVector = _mm256_set1_epi16(const_alpha * 257);
+        for (; x < length - 3; x += 4) {
+            __m256i srcVector = _mm256_lddqu_si256((const __m256i *)&src[x]);
+            srcVector = multiplyAlpha65535_avx2(srcVector, constAlphaVector);
+            const __m256i alphaChannel = _mm256_sub_epi16(one, _mm256_shuffle_epi8(srcVector, alphaShuffleMask));
+            __m256i dstVector = _mm256_loadu_si256((const __m256i *)&dst[x]);
+            dstVector = multiplyAlpha65535_avx2(dstVector, alphaChannel);
+            _mm256_storeu_si256((__m256i *)&dst[x], _mm256_add_epi16(srcVector, dstVector));
+        }
+        SIMD_EPILOGUE(x, length, 3) {
+            const QRgba64 s = multiplyAlpha255(src[x], const_alpha);
+            dst[x] = QRgba64::fromRgba64(s + multiplyAlpha65535(dst[x], 65535 - s.alpha()));
+        }
+    }
+}
+
+void QT_FASTCALL comp_func_solid_SourceOver_rgb64_avx2(QRgba64 *dst, int length, QRgba64 color, uint const_alpha)
+{
+    Q_ASSERT(const_alpha < 256);
+    if (const_alpha == 255 && color.isOpaque()) {
+        qt_memfill64((quint64 *)dst, color, length);
+    } else {
+        if (const_alpha != 255)
+            color = multiplyAlpha255(color, const_alpha);
+
+        const uint minusAlphaOfColor = 65535 - color.alpha();
+        const __m256i colorVector = _mm256_set1_epi64x(color);
+        const __m256i minusAlphaOfColorVector = _mm256_set1_epi16(minusAlphaOfColor);
+        int x = 0;
+        for (; x < length - 3; x += 4) {
+            __m256i dstVector = _mm256_loadu_si256((const __m256i *)&dst[x]);
+            dstVector = multiplyAlpha65535_avx2(dstVector, minusAlphaOfColorVector);
+            _mm256_storeu_si256((__m256i *)&dst[x], _mm256_add_epi16(colorVector, dstVector));
+        }
+        SIMD_EPILOGUE(x, length, 3)
+            dst[x] = QRgba64::fromRgba64(color + multiplyAlpha65535(dst[x], minusAlphaOfColor));
+    }
+}
+
+void QT_FASTCALL comp_func_Source_rgb64_avx2(QRgba64 *dst, const QRgba64 *src, int length, uint const_alpha)
+{
+    Q_ASSERT(const_alpha < 256);
+    if (const_alpha == 255) {
+        ::memcpy(dst, src, length * sizeof(QRgba64));
+    } else {
+        const uint ialpha = 255 - const_alpha;
+        int x = 0;
+        for (; x < length - 3; x += 4) {
+            const __m256i srcVector = _mm256_lddqu_si256((const __m256i *)&src[x]);
+            const __m256i dstVector = _mm256_loadu_si256((const __m256i *)&dst[x]);
+            _mm256_storeu_si256((__m256i *)&dst[x], interpolate255_avx2(srcVector, const_alpha, dstVector, ialpha));
+        }
+        SIMD_EPILOGUE(x, length, 3)
+            dst[x] = interpolate255(src[x], const_alpha, dst[x], ialpha);
+    }
+}
+
+void QT_FASTCALL comp_func_Plus_rgb64_avx2(QRgba64 *dst, const QRgba64 *src, int length, uint const_alpha)
+{
+    Q_ASSERT(const_alpha < 256);
+    const uint ialpha = 255 - const_alpha;
+    int x = 0;
+    for (; x < length - 3; x += 4) {
+        const __m256i srcVector = _mm256_lddqu_si256((const __m256i *)&src[x]);
+        const __m256i dstVector = _mm256_loadu_si256((const __m256i *)&dst[x]);
+        __m256i result = _mm256_adds_epu16(srcVector, dstVector);
+        if (const_alpha != 255)
+            result = interpolate255_avx2(result, const_alpha, dstVector, ialpha);
+        _mm256_storeu_si256((__m256i *)&dst[x], result);
+    }
+    SIMD_EPILOGUE(x, length, 3) {
+        QRgba64 result = addWithSaturation(dst[x], src[x]);
+        if (const_alpha != 255)
+            result = interpolate255(result, const_alpha, dst[x], ialpha);
+        dst[x] = result;
+    }
+}
+
 #define interpolate_4_pixels_16_avx2(tlr1, tlr2, blr1, blr2, distx, disty, colorMask, v_256, b)  \
 { \
     /* Correct for later unpack */ \
@@ -760,6 +936,293 @@ void QT_FASTCALL fetchTransformedBilinearARGB32PM_fast_rotate_helper_avx2(uint *
     }
 }
 
+template<bool RGBA>
+static inline void convertARGBToARGB32PM_avx2(uint *buffer, const uint *src, int count)
+{
+    int i = 0;
+    const __m256i alphaMask = _mm256_set1_epi32(0xff000000);
+    const __m256i rgbaMask = _mm256_broadcastsi128_si256(_mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15));
+    const __m256i shuffleMask = _mm256_broadcastsi128_si256(_mm_setr_epi8(6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15));
+    const __m256i half = _mm256_set1_epi16(0x0080);
+    const __m256i zero = _mm256_setzero_si256();
+
+    for (; i < count - 7; i += 8) {
+        __m256i srcVector = _mm256_loadu_si256((const __m256i *)&src[i]);
+        if (!_mm256_testz_si256(srcVector, alphaMask)) {
+            if (!_mm256_testc_si256(srcVector, alphaMask)) {
+                if (RGBA)
+                    srcVector = _mm256_shuffle_epi8(srcVector, rgbaMask);
+                __m256i src1 = _mm256_unpacklo_epi8(srcVector, zero);
+                __m256i src2 = _mm256_unpackhi_epi8(srcVector, zero);
+                const __m256i alpha1 = _mm256_shuffle_epi8(src1, shuffleMask);
+                const __m256i alpha2 = _mm256_shuffle_epi8(src2, shuffleMask);
+                src1 = _mm256_mullo_epi16(src1, alpha1);
+                src2 = _mm256_mullo_epi16(src2, alpha2);
+                src1 = _mm256_add_epi16(src1, _mm256_srli_epi16(src1, 8));
+                src2 = _mm256_add_epi16(src2, _mm256_srli_epi16(src2, 8));
+                src1 = _mm256_add_epi16(src1, half);
+                src2 = _mm256_add_epi16(src2, half);
+                src1 = _mm256_srli_epi16(src1, 8);
+                src2 = _mm256_srli_epi16(src2, 8);
+                src1 = _mm256_blend_epi16(src1, alpha1, 0x88);
+                src2 = _mm256_blend_epi16(src2, alpha2, 0x88);
+                srcVector = _mm256_packus_epi16(src1, src2);
+                _mm256_storeu_si256((__m256i *)&buffer[i], srcVector);
+            } else {
+                if (RGBA)
+                    _mm256_storeu_si256((__m256i *)&buffer[i], _mm256_shuffle_epi8(srcVector, rgbaMask));
+                else if (buffer != src)
+                    _mm256_storeu_si256((__m256i *)&buffer[i], srcVector);
+            }
+        } else {
+            _mm256_storeu_si256((__m256i *)&buffer[i], zero);
+        }
+    }
+
+    SIMD_EPILOGUE(i, count, 7) {
+        uint v = qPremultiply(src[i]);
+        buffer[i] = RGBA ? RGBA2ARGB(v) : v;
+    }
+}
+
+const uint *QT_FASTCALL convertARGB32ToARGB32PM_avx2(uint *buffer, const uint *src, int count,
+                                                     const QVector<QRgb> *, QDitherInfo *)
+{
+    convertARGBToARGB32PM_avx2<false>(buffer, src, count);
+    return buffer;
+}
+
+const uint *QT_FASTCALL convertRGBA8888ToARGB32PM_avx2(uint *buffer, const uint *src, int count,
+                                                       const QVector<QRgb> *, QDitherInfo *)
+{
+    convertARGBToARGB32PM_avx2<true>(buffer, src, count);
+    return buffer;
+}
+
+template<bool RGBA>
+static inline void convertARGBToRGBA64PM_avx2(QRgba64 *buffer, const uint *src, int count)
+{
+    int i = 0;
+    const __m128i alphaMask = _mm_set1_epi32(0xff000000);
+    const __m256i alphaShuffleMask = _mm256_broadcastsi128_si256(_mm_setr_epi8(6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15));
+
+    for (; i < count - 3; i += 4) {
+        const __m128i srcVector = _mm_loadu_si128((const __m128i *)&src[i]);
+        // Widen each 8-bit channel to 16 bits, x * 257 = (x << 8) | x.
+        __m256i v = _mm256_cvtepu8_epi16(srcVector);
+        v = _mm256_or_si256(v, _mm256_slli_epi16(v, 8));
+        if (!RGBA) {
+            v = _mm256_shufflelo_epi16(v, _MM_SHUFFLE(3, 0, 1, 2));
+            v = _mm256_shufflehi_epi16(v, _MM_SHUFFLE(3, 0, 1, 2));
+        }
+        if (!_mm_testc_si128(srcVector, alphaMask)) {
+            const __m256i alpha = _mm256_shuffle_epi8(v, alphaShuffleMask);
+            v = _mm256_blend_epi16(multiplyAlpha65535_avx2(v, alpha), alpha, 0x88);
+        }
+        _mm256_storeu_si256((__m256i *)&buffer[i], v);
+    }
+
+    SIMD_EPILOGUE(i, count, 3) {
+        const uint s = RGBA ? RGBA2ARGB(src[i]) : src[i];
+        buffer[i] = QRgba64::fromArgb32(s).premultiplied();
+    }
+}
+
+const QRgba64 *QT_FASTCALL convertARGB32ToARGB64PM_avx2(QRgba64 *buffer, const uint *src, int count,
+                                                        const QVector<QRgb> *, QDitherInfo *)
+{
+    convertARGBToRGBA64PM_avx2<false>(buffer, src, count);
+    return buffer;
+}
+
+const QRgba64 *QT_FASTCALL convertRGBA8888ToARGB64PM_avx2(QRgba64 *buffer, const uint *src, int count,
+                                                          const QVector<QRgb> *, QDitherInfo *)
+{
+    convertARGBToRGBA64PM_avx2<true>(buffer, src, count);
+    return buffer;
+}
+
+template<QtPixelOrder PixelOrder>
+const QRgba64 *QT_FASTCALL convertA2RGB30PMToARGB64PM_avx2(QRgba64 *buffer, const uint *src, int count,
+                                                           const QVector<QRgb> *, QDitherInfo *)
+{
+    const __m256i mask = _mm256_set1_epi64x(0x3ff);
+    const __m256i afactor = _mm256_set1_epi64x(0x5555);
+    const int redShift = PixelOrder == PixelOrderRGB ? 20 : 0;
+    const int blueShift = PixelOrder == PixelOrderRGB ? 0 : 20;
+    int i = 0;
+
+    for (; i < count - 3; i += 4) {
+        // One pixel per 64-bit lane, expanded to the QRgba64 channel positions.
+        const __m256i vs = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *)&src[i]));
+        __m256i vr = _mm256_and_si256(_mm256_srli_epi64(vs, redShift), mask);
+        __m256i vg = _mm256_and_si256(_mm256_srli_epi64(vs, 10), mask);
+        __m256i vb = _mm256_and_si256(_mm256_srli_epi64(vs, blueShift), mask);
+        __m256i va = _mm256_mul_epu32(_mm256_srli_epi64(vs, 30), afactor);
+        vr = _mm256_or_si256(_mm256_slli_epi64(vr, 6), _mm256_srli_epi64(vr, 4));
+        vg = _mm256_or_si256(_mm256_slli_epi64(vg, 6), _mm256_srli_epi64(vg, 4));
+        vb = _mm256_or_si256(_mm256_slli_epi64(vb, 6), _mm256_srli_epi64(vb, 4));
+        const __m256i vrg = _mm256_or_si256(vr, _mm256_slli_epi64(vg, 16));
+        const __m256i vba = _mm256_or_si256(_mm256_slli_epi64(vb, 32), _mm256_slli_epi64(va, 48));
+        _mm256_storeu_si256((__m256i *)&buffer[i], _mm256_or_si256(vrg, vba));
+    }
+
+    SIMD_EPILOGUE(i, count, 3)
+        buffer[i] = qConvertA2rgb30ToRgb64<PixelOrder>(src[i]);
+    return buffer;
+}
+
+template
+const QRgba64 *QT_FASTCALL convertA2RGB30PMToARGB64PM_avx2<PixelOrderBGR>(QRgba64 *buffer, const uint *src, int count,
+                                                                          const QVector<QRgb> *, QDitherInfo *);
+template
+const QRgba64 *QT_FASTCALL convertA2RGB30PMToARGB64PM_avx2<PixelOrderRGB>(QRgba64 *buffer, const uint *src, int count,
+                                                                          const QVector<QRgb> *, QDitherInfo *);
+
+const uint *QT_FASTCALL convertGrayscale8ToRGB32_avx2(uint *buffer, const uint *src, int count,
+                                                      const QVector<QRgb> *, QDitherInfo *)
+{
+    const __m256i grayFactor = _mm256_set1_epi32(0x010101);
+    const __m256i alphaMask = _mm256_set1_epi32(0xff000000);
+    int i = 0;
+    for (; i < count - 7; i += 8) {
+        const __m256i v = _mm256_loadu_si256((const __m256i *)&src[i]);
+        _mm256_storeu_si256((__m256i *)&buffer[i], _mm256_or_si256(_mm256_mullo_epi32(v, grayFactor), alphaMask));
+    }
+    SIMD_EPILOGUE(i, count, 7)
+        buffer[i] = qRgb(src[i], src[i], src[i]);
+    return buffer;
+}
+
+const QRgba64 *QT_FASTCALL convertGrayscale8ToRGB64_avx2(QRgba64 *buffer, const uint *src, int count,
+                                                         const QVector<QRgb> *, QDitherInfo *)
+{
+    const __m256i grayFactor = _mm256_set1_epi64x(257);
+    const __m256i alphaMask = _mm256_set1_epi64x(qint64(Q_UINT64_C(0xffff) << 48));
+    int i = 0;
+    for (; i < count - 3; i += 4) {
+        const __m256i v = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *)&src[i]));
+        const __m256i gray = _mm256_mul_epu32(v, grayFactor);
+        __m256i rgba = _mm256_or_si256(gray, _mm256_slli_epi64(gray, 16));
+        rgba = _mm256_or_si256(rgba, _mm256_slli_epi64(gray, 32));
+        _mm256_storeu_si256((__m256i *)&buffer[i], _mm256_or_si256(rgba, alphaMask));
+    }
+    SIMD_EPILOGUE(i, count, 3)
+        buffer[i] = QRgba64::fromRgba(src[i], src[i], src[i], 255);
+    return buffer;
+}
+
+const uint *QT_FASTCALL convertGrayscale8FromRGB32_avx2(uint *buffer, const uint *src, int count,
+                                                        const QVector<QRgb> *, QDitherInfo *)
+{
+    // qGray(): (r * 11 + g * 16 + b * 5) / 32
+    const __m256i rbMask = _mm256_set1_epi32(0x00ff00ff);
+    const __m256i rbFactor = _mm256_set1_epi32((11 << 16) | 5);
+    const __m256i greenMask = _mm256_set1_epi32(0xff);
+    int i = 0;
+    for (; i < count - 7; i += 8) {
+        const __m256i v = _mm256_loadu_si256((const __m256i *)&src[i]);
+        const __m256i rb = _mm256_madd_epi16(_mm256_and_si256(v, rbMask), rbFactor);
+        const __m256i g = _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(v, 8), greenMask), 4);
+        _mm256_storeu_si256((__m256i *)&buffer[i], _mm256_srli_epi32(_mm256_add_epi32(rb, g), 5));
+    }
+    SIMD_EPILOGUE(i, count, 7)
+        buffer[i] = qGray(src[i]);
+    return buffer;
+}
+
+// Clamps the gradient table positions of 8 pixels the way qt_gradient_clamp() does.
+template<QGradient::Spread Spread>
+static inline __m256i gradientClamp_avx2(__m256i ipos)
+{
+    switch (Spread) {
+    case QGradient::RepeatSpread:
+        return _mm256_and_si256(ipos, _mm256_set1_epi32(GRADIENT_STOPTABLE_SIZE - 1));
+    case QGradient::ReflectSpread: {
+        const __m256i limit = _mm256_set1_epi32(GRADIENT_STOPTABLE_SIZE * 2 - 1);
+        ipos = _mm256_and_si256(ipos, limit);
+        const __m256i reflected = _mm256_cmpgt_epi32(ipos, _mm256_set1_epi32(GRADIENT_STOPTABLE_SIZE - 1));
+        return _mm256_xor_si256(ipos, _mm256_and_si256(reflected, limit));
+    }
+    default:
+        ipos = _mm256_max_epi32(ipos, _mm256_setzero_si256());
+        return _mm256_min_epi32(ipos, _mm256_set1_epi32(GRADIENT_STOPTABLE_SIZE - 1));
+    }
+}
+
+static inline void storeGradientPixels_avx2(uint *buffer, const QGradientData *gradient, const __m256i &ipos)
+{
+    const __m256i pixels = _mm256_i32gather_epi32((const int *)gradient->colorTable32, ipos, 4);
+    _mm256_storeu_si256((__m256i *)buffer, pixels);
+}
+
+static inline void storeGradientPixels_avx2(QRgba64 *buffer, const QGradientData *gradient, const __m256i &ipos)
+{
+    const long long *table = (const long long *)gradient->colorTable64;
+    const __m256i pixelsLo = _mm256_i32gather_epi64(table, _mm256_castsi256_si128(ipos), 8);
+    const __m256i pixelsHi = _mm256_i32gather_epi64(table, _mm256_extracti128_si256(ipos, 1), 8);
+    _mm256_storeu_si256((__m256i *)buffer, pixelsLo);
+    _mm256_storeu_si256((__m256i *)(buffer + 4), pixelsHi);
+}
+
+static inline void fetchGradientPixel(uint *buffer, const QGradientData *gradient, int t)
+{
+    *buffer = qt_gradient_pixel_fixed(gradient, t);
+}
+
+static inline void fetchGradientPixel(QRgba64 *buffer, const QGradientData *gradient, int t)
+{
+    *buffer = qt_gradient_pixel64_fixed(gradient, t);
+}
+
+template<QGradient::Spread Spread, typename T>
+static void fetchLinearGradientFixed_avx2(T *buffer, int length, const QGradientData *gradient, int t, int inc)
+{
+    const __m256i half = _mm256_set1_epi32(FIXPT_SIZE / 2);
+    const __m256i vinc = _mm256_set1_epi32(inc * 8);
+    __m256i vt = _mm256_add_epi32(_mm256_set1_epi32(t),
+                                  _mm256_mullo_epi32(_mm256_set1_epi32(inc), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+    int i = 0;
+    for (; i < length - 7; i += 8) {
+        const __m256i ipos = _mm256_srai_epi32(_mm256_add_epi32(vt, half), FIXPT_BITS);
+        storeGradientPixels_avx2(buffer + i, gradient, gradientClamp_avx2<Spread>(ipos));
+        vt = _mm256_add_epi32(vt, vinc);
+    }
+    t += i * inc;
+    SIMD_EPILOGUE(i, length, 7) {
+        fetchGradientPixel(buffer + i, gradient, t);
+        t += inc;
+    }
+}
+
+template<typename T>
+static inline void fetchLinearGradientFixed_avx2(T *buffer, int length, const QGradientData *gradient, int t, int inc)
+{
+    switch (gradient->spread) {
+    case QGradient::RepeatSpread:
+        fetchLinearGradientFixed_avx2<QGradient::RepeatSpread>(buffer, length, gradient, t, inc);
+        break;
+    case QGradient::ReflectSpread:
+        fetchLinearGradientFixed_avx2<QGradient::ReflectSpread>(buffer, length, gradient, t, inc);
+        break;
+    default:
+        fetchLinearGradientFixed_avx2<QGradient::PadSpread>(buffer, length, gradient, t, inc);
+        break;
+    }
+}
+
+void QT_FASTCALL qt_fetch_linear_gradient_fixed_avx2(uint *buffer, int length, const QGradientData *gradient,
+                                                     int t, int inc)
+{
+    fetchLinearGradientFixed_avx2(buffer, length, gradient, t, inc);
+}
+
+void QT_FASTCALL qt_fetch_linear_gradient_fixed_rgb64_avx2(QRgba64 *buffer, int length, const QGradientData *gradient,
+                                                           int t, int inc)
+{
+    fetchLinearGradientFixed_avx2(buffer, length, gradient, t, inc);
+}
+
 QT_END_NAMESPACE
 
 #endif
@@ -0,0 +1,253 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qdrawhelper_p.h"
+#include "qdrawingprimitive_sse2_p.h"
+
+#if defined(QT_COMPILER_SUPPORTS_AVX512CORE)
+
+QT_BEGIN_NAMESPACE
+
+// AVX-512 versions of the composition, conversion and gradient functions that
+// process the longest spans. The remaining ones are left to the AVX2 versions,
+// since the wider registers only pay off when they keep the core busy long
+// enough to make up for the lower clock speed of AVX-512 code.
+//
+// Instead of scalar prologues and epilogues, the first and last pixels of a
+// span are handled with masked loads and stores.
+
+static inline __mmask16 spanMask(int length)
+{
+    return length >= 16 ? __mmask16(0xffff) : __mmask16((1U << length) - 1);
+}
+
+// See BYTE_MUL_SSE2 for details.
+static inline __m512i BYTE_MUL_AVX512(const __m512i &pixelVector, const __m512i &alphaChannel, const __m512i &colorMask, const __m512i &half)
+{
+    __m512i pixelVectorAG = _mm512_srli_epi16(pixelVector, 8);
+    __m512i pixelVectorRB = _mm512_and_si512(pixelVector, colorMask);
+
+    pixelVectorAG = _mm512_mullo_epi16(pixelVectorAG, alphaChannel);
+    pixelVectorRB = _mm512_mullo_epi16(pixelVectorRB, alphaChannel);
+
+    pixelVectorRB = _mm512_add_epi16(pixelVectorRB, _mm512_srli_epi16(pixelVectorRB, 8));
+    pixelVectorAG = _mm512_add_epi16(pixelVectorAG, _mm512_srli_epi16(pixelVectorAG, 8));
+    pixelVectorRB = _mm512_add_epi16(pixelVectorRB, half);
+    pixelVectorAG = _mm512_add_epi16(pixelVectorAG, half);
+
+    pixelVectorRB = _mm512_srli_epi16(pixelVectorRB, 8);
+    pixelVectorAG = _mm512_and_si512(pixelVectorAG, _mm512_slli_epi16(colorMask, 8));
+
+    return _mm512_or_si512(pixelVectorAG, pixelVectorRB);
+}
+
+// Spreads the alpha byte of each pixel over its two 16-bit halves.
+static inline __m512i alphaShuffleMask_avx512()
+{
+    return _mm512_set4_epi32(int(0xff0fff0f), int(0xff0bff0b), int(0xff07ff07), int(0xff03ff03));
+}
+
+void QT_FASTCALL comp_func_SourceOver_avx512(uint *dst, const uint *src, int length, uint const_alpha)
+{
+    Q_ASSERT(const_alpha < 256);
+
+    const __m512i half = _mm512_set1_epi16(0x80);
+    const __m512i one = _mm512_set1_epi16(0xff);
+    const __m512i colorMask = _mm512_set1_epi32(0x00ff00ff);
+    const __m512i alphaShuffleMask = alphaShuffleMask_avx512();
+
+    if (const_alpha == 255) {
+        const __m512i alphaMask = _mm512_set1_epi32(0xff000000);
+        for (int x = 0; x < length; x += 16) {
+            const __mmask16 mask = spanMask(length - x);
+            const __m512i srcVector = _mm512_maskz_loadu_epi32(mask, &src[x]);
+            // Like comp_func_SourceOver(), leave the destination alone where the source is 0,
+            // and copy opaque source pixels.
+            const __mmask16 visible = _mm512_test_epi32_mask(srcVector, srcVector);
+            const __mmask16 opaque = _mm512_cmpge_epu32_mask(srcVector, alphaMask);
+            if (visible == opaque) {
+                _mm512_mask_storeu_epi32(&dst[x], opaque, srcVector);
+            } else {
+                const __m512i alphaChannel = _mm512_sub_epi16(one, _mm512_shuffle_epi8(srcVector, alphaShuffleMask));
+                __m512i dstVector = _mm512_maskz_loadu_epi32(visible, &dst[x]);
+                dstVector = BYTE_MUL_AVX512(dstVector, alphaChannel, colorMask, half);
+                _mm512_mask_storeu_epi32(&dst[x], visible, _mm512_add_epi8(srcVector, dstVector));
+            }
+        }
+    } else {
+        const __m512i constAlphaVector = _mm512_set1_epi16(const_alpha);
+        for (int x = 0; x < length; x += 16) {
+            const __mmask16 mask = spanMask(length - x);
+            __m512i srcVector = _mm512_maskz_loadu_epi32(mask, &src[x]);
+            srcVector = BYTE_MUL_AVX512(srcVector, constAlphaVector, colorMask, half);
+            const __m512i alphaChannel = _mm512_sub_epi16(one, _mm512_shuffle_epi8(srcVector, alphaShuffleMask));
+            __m512i dstVector = _mm512_maskz_loadu_epi32(mask, &dst[x]);
+            dstVector = BYTE_MUL_AVX512(dstVector, alphaChannel, colorMask, half);
+            _mm512_mask_storeu_epi32(&dst[x], mask, _mm512_add_epi8(srcVector, dstVector));
+        }
+    }
+}
+
+void QT_FASTCALL comp_func_solid_SourceOver_avx512(uint *dst, int length, uint color, uint const_alpha)
+{
+    if ((const_alpha & qAlpha(color)) == 255) {
+        qt_memfill32(dst, color, length);
+    } else {
+        if (const_alpha != 255)
+            color = BYTE_MUL(color, const_alpha);
+
+        const __m512i colorVector = _mm512_set1_epi32(color);
+        const __m512i colorMask = _mm512_set1_epi32(0x00ff00ff);
+        const __m512i half = _mm512_set1_epi16(0x80);
+        const __m512i minusAlphaOfColorVector = _mm512_set1_epi16(qAlpha(~color));
+
+        for (int x = 0; x < length; x += 16) {
+            const __mmask16 mask = spanMask(length - x);
+            __m512i dstVector = _mm512_maskz_loadu_epi32(mask, &dst[x]);
+            dstVector = BYTE_MUL_AVX512(dstVector, minusAlphaOfColorVector, colorMask, half);
+            _mm512_mask_storeu_epi32(&dst[x], mask, _mm512_add_epi8(colorVector, dstVector));
+        }
+    }
+}
+
+template<bool RGBA>
+static inline void convertARGBToARGB32PM_avx512(uint *buffer, const uint *src, int count)
+{
+    const __m512i alphaMask = _mm512_set1_epi32(0xff000000);
+    const __m512i rgbaMask = _mm512_set4_epi32(0x0f0c0d0e, 0x0b08090a, 0x07040506, 0x03000102);
+    const __m512i shuffleMask = _mm512_set4_epi32(0x0f0e0f0e, 0x0f0e0f0e, 0x07060706, 0x07060706);
+    const __m512i half = _mm512_set1_epi16(0x0080);
+    const __m512i zero = _mm512_setzero_si512();
+
+    for (int i = 0; i < count; i += 16) {
+        const __mmask16 mask = spanMask(count - i);
+        __m512i srcVector = _mm512_maskz_loadu_epi32(mask, &src[i]);
+        if (RGBA)
+            srcVector = _mm512_shuffle_epi8(srcVector, rgbaMask);
+        if (_mm512_cmpge_epu32_mask(srcVector, alphaMask) != mask) {
+            __m512i src1 = _mm512_unpacklo_epi8(srcVector, zero);
+            __m512i src2 = _mm512_unpackhi_epi8(srcVector, zero);
+            const __m512i alpha1 = _mm512_shuffle_epi8(src1, shuffleMask);
+            const __m512i alpha2 = _mm512_shuffle_epi8(src2, shuffleMask);
+            src1 = _mm512_mullo_epi16(src1, alpha1);
+            src2 = _mm512_mullo_epi16(src2, alpha2);
+            src1 = _mm512_add_epi16(src1, _mm512_srli_epi16(src1, 8));
+            src2 = _mm512_add_epi16(src2, _mm512_srli_epi16(src2, 8));
+            src1 = _mm512_srli_epi16(_mm512_add_epi16(src1, half), 8);
+            src2 = _mm512_srli_epi16(_mm512_add_epi16(src2, half), 8);
+            src1 = _mm512_mask_blend_epi16(0x88888888, src1, alpha1);
+            src2 = _mm512_mask_blend_epi16(0x88888888, src2, alpha2);
+            srcVector = _mm512_packus_epi16(src1, src2);
+        } else if (!RGBA && buffer == src) {
+            continue;
+        }
+        _mm512_mask_storeu_epi32(&buffer[i], mask, srcVector);
+    }
+}
+
+const uint *QT_FASTCALL convertARGB32ToARGB32PM_avx512(uint *buffer, const uint *src, int count,
+                                                       const QVector<QRgb> *, QDitherInfo *)
+{
+    convertARGBToARGB32PM_avx512<false>(buffer, src, count);
+    return buffer;
+}
+
+const uint *QT_FASTCALL convertRGBA8888ToARGB32PM_avx512(uint *buffer, const uint *src, int count,
+                                                         const QVector<QRgb> *, QDitherInfo *)
+{
+    convertARGBToARGB32PM_avx512<true>(buffer, src, count);
+    return buffer;
+}
+
+// Clamps the gradient table positions of 16 pixels the way qt_gradient_clamp() does.
+template<QGradient::Spread Spread>
+static inline __m512i gradientClamp_avx512(__m512i ipos)
+{
+    switch (Spread) {
+    case QGradient::RepeatSpread:
+        return _mm512_and_si512(ipos, _mm512_set1_epi32(GRADIENT_STOPTABLE_SIZE - 1));
+    case QGradient::ReflectSpread: {
+        const __m512i limit = _mm512_set1_epi32(GRADIENT_STOPTABLE_SIZE * 2 - 1);
+        ipos = _mm512_and_si512(ipos, limit);
+        const __mmask16 reflected = _mm512_cmpgt_epi32_mask(ipos, _mm512_set1_epi32(GRADIENT_STOPTABLE_SIZE - 1));
+        return _mm512_mask_xor_epi32(ipos, reflected, ipos, limit);
+    }
+    default:
+        ipos = _mm512_max_epi32(ipos, _mm512_setzero_si512());
+        return _mm512_min_epi32(ipos, _mm512_set1_epi32(GRADIENT_STOPTABLE_SIZE - 1));
+    }
+}
+
+template<QGradient::Spread Spread>
+static void fetchLinearGradientFixed_avx512(uint *buffer, int length, const QGradientData *gradient, int t, int inc)
+{
+    const __m512i half = _mm512_set1_epi32(FIXPT_SIZE / 2);
+    const __m512i vinc = _mm512_set1_epi32(inc * 16);
+    __m512i vt = _mm512_add_epi32(_mm512_set1_epi32(t),
+                                  _mm512_mullo_epi32(_mm512_set1_epi32(inc),
+                                                     _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15)));
+    for (int i = 0; i < length; i += 16) {
+        const __mmask16 mask = spanMask(length - i);
+        const __m512i ipos = gradientClamp_avx512<Spread>(_mm512_srai_epi32(_mm512_add_epi32(vt, half), FIXPT_BITS));
+        const __m512i pixels = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), mask, ipos, gradient->colorTable32, 4);
+        _mm512_mask_storeu_epi32(&buffer[i], mask, pixels);
+        vt = _mm512_add_epi32(vt, vinc);
+    }
+}
+
+void QT_FASTCALL qt_fetch_linear_gradient_fixed_avx512(uint *buffer, int length, const QGradientData *gradient,
+                                                       int t, int inc)
+{
+    switch (gradient->spread) {
+    case QGradient::RepeatSpread:
+        fetchLinearGradientFixed_avx512<QGradient::RepeatSpread>(buffer, length, gradient, t, inc);
+        break;
+    case QGradient::ReflectSpread:
+        fetchLinearGradientFixed_avx512<QGradient::ReflectSpread>(buffer, length, gradient, t, inc);
+        break;
+    default:
+        fetchLinearGradientFixed_avx512<QGradient::PadSpread>(buffer, length, gradient, t, inc);
+        break;
+    }
+}
+
+QT_END_NAMESPACE
+
+#endif
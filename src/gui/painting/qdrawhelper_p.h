@@ -79,6 +79,13 @@ QT_BEGIN_NAMESPACE
 #  define Q_DECL_RESTRICT
 #endif
 
+// qdrawhelper_avx512.cpp is built with the "avx512core" profile of simd.prf.
+#if defined(QT_COMPILER_SUPPORTS_AVX512F) && defined(QT_COMPILER_SUPPORTS_AVX512CD) \
+    && defined(QT_COMPILER_SUPPORTS_AVX512BW) && defined(QT_COMPILER_SUPPORTS_AVX512DQ) \
+    && defined(QT_COMPILER_SUPPORTS_AVX512VL)
+#  define QT_COMPILER_SUPPORTS_AVX512CORE
+#endif
+
 static const uint AMASK = 0xff000000;
 static const uint RMASK = 0x00ff0000;
 static const uint GMASK = 0x0000ff00;
@@ -387,6 +394,21 @@ static inline const QRgba64& qt_gradient_pixel64(const QGradientData *data, qrea
     return data->colorTable64[qt_gradient_clamp(data, ipos)];
 }
 
+#define FIXPT_BITS 8
+#define FIXPT_SIZE (1<<FIXPT_BITS)
+
+static inline uint qt_gradient_pixel_fixed(const QGradientData *data, int fixed_pos)
+{
+    int ipos = (fixed_pos + (FIXPT_SIZE / 2)) >> FIXPT_BITS;
+    return data->colorTable32[qt_gradient_clamp(data, ipos)];
+}
+
+static inline const QRgba64& qt_gradient_pixel64_fixed(const QGradientData *data, int fixed_pos)
+{
+    int ipos = (fixed_pos + (FIXPT_SIZE / 2)) >> FIXPT_BITS;
+    return data->colorTable64[qt_gradient_clamp(data, ipos)];
+}
+
 static inline qreal qRadialDeterminant(qreal a, qreal b, qreal c)
 {
     return (b * b) - (4 * a * c);
@@ -38,6 +38,7 @@
 ****************************************************************************/
 #include <private/qimagescale_p.h>
 #include <private/qdrawhelper_p.h>
+#include <private/qimage_p.h>
 
 #include "qimage.h"
 #include "qcolor.h"
@@ -745,12 +746,23 @@ QImage qSmoothScaleImage(const QImage &src, int dw, int dh)
         return QImage();
     }
 
-    if (src.hasAlphaChannel())
-        qt_qimageScaleAARGBA(scaleinfo, (unsigned int *)buffer.scanLine(0),
-                             dw, dh, dw, src.bytesPerLine() / 4);
-    else
-        qt_qimageScaleAARGB(scaleinfo, (unsigned int *)buffer.scanLine(0),
-                            dw, dh, dw, src.bytesPerLine() / 4);
+    const bool hasAlpha = src.hasAlphaChannel();
+    const int sow = src.bytesPerLine() / 4;
+    unsigned int *dest = (unsigned int *)buffer.scanLine(0);
+
+    // Each destination row only depends on its own entries in the scale
+    // tables, so row ranges can be scaled independently.
+    auto scaleSegment = [=](int yStart, int yEnd) {
+        QImageScaleInfo segment = *scaleinfo;
+        segment.ypoints += yStart;
+        if (segment.yapoints)
+            segment.yapoints += yStart;
+        if (hasAlpha)
+            qt_qimageScaleAARGBA(&segment, dest + yStart * dw, dw, yEnd - yStart, dw, sow);
+        else
+            qt_qimageScaleAARGB(&segment, dest + yStart * dw, dw, yEnd - yStart, dw, sow);
+    };
+    qt_processImageSegments(dh, src.sizeInBytes() + buffer.sizeInBytes(), scaleSegment);
 
     qimageFreeScaleInfo(scaleinfo);
     return buffer;
@@ -1725,7 +1725,7 @@ void QRasterPaintEngine::fill(const QVectorPath &path, const QBrush &brush)
 
     // ### Optimize for non transformed ellipses and rectangles...
     QRectF cpRect = path.controlPointRect();
-    const QRect pathDeviceRect = s->matrix.mapRect(cpRect).toRect();
+    const QRect pathDeviceRect = s->matrix.mapRect(cpRect).toAlignedRect();
     // Skip paths that by conservative estimates are completely outside the paint device.
     if (!pathDeviceRect.intersects(d->deviceRect))
         return;
@@ -0,0 +1,1294 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qtiledimagepaintdevice.h"
+#include "qtiledimagepaintdevice_p.h"
+
+#include <qimage.h>
+#include <qmath.h>
+#include <qmutex.h>
+#include <qsemaphore.h>
+#include <qthreadpool.h>
+#include <qpa/qplatformintegration.h>
+
+#include <private/qfontengine_p.h>
+#include <private/qguiapplication_p.h>
+#include <private/qvectorpath_p.h>
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+bool qHasPixmapTexture(const QBrush &);
+Q_GUI_EXPORT bool qt_scaleForTransform(const QTransform &transform, qreal *scale);
+
+/*!
+    \class QTiledImagePaintDevice
+    \since 5.11
+    \inmodule QtGui
+    \ingroup painting
+
+    \brief The QTiledImagePaintDevice class paints on a QImage using several
+    threads.
+
+    A QTiledImagePaintDevice wraps an existing QImage. A QPainter that is
+    opened on the device does not draw immediately; instead, it records the
+    painting commands and sorts each one into the tiles that it can affect.
+    Tiles span the full width of the image and are tileHeight() rows high.
+    When the painter is ended, the tiles are painted in parallel on the
+    global QThreadPool. Each tile only replays the commands that touch it,
+    clipped to the tile:
+
+    \snippet code/src_gui_painting_qtiledimagepaintdevice.cpp 0
+
+    This pays off for scenes with many commands, expensive brushes, or
+    antialiased shapes that cover a large image. QPainter::end() does not
+    return until all tiles have been painted, and the image must not be used
+    while the painter is active.
+
+    The result is the same as painting on the image directly. Since
+    gradients, patterns and images are sampled from the left edge of each
+    scanline, full-width tiles do not change them. The raster engine does
+    however clip rotated rectangles and images, and lines drawn with pens
+    wider than a pixel, against the tile before rounding their edges. Such
+    commands are painted on the whole image by a single thread instead,
+    after the commands before them and before the ones after them, so a
+    scene that consists mostly of them gains nothing from the device.
+
+    Text is drawn by one thread at a time: the glyphs of a font are cached
+    by its font engine, which all threads share. Pixmaps are only painted by
+    several threads on platforms that support threaded pixmaps. Images in
+    the QImage::Format_Mono, QImage::Format_MonoLSB, and
+    QImage::Format_Indexed8 formats cannot be painted on.
+
+    \sa QImage, QPainter, QThreadPool
+*/
+
+QTiledImagePaintDevicePrivate::QTiledImagePaintDevicePrivate(QImage *image)
+    : image(image),
+      tileHeight(64),
+      engine(new QTiledImagePaintEngine(this))
+{
+}
+
+QTiledImagePaintDevicePrivate::~QTiledImagePaintDevicePrivate()
+{
+}
+
+/*!
+    Constructs a paint device that paints on \a image.
+
+    The image is not copied, and must stay valid for as long as the paint
+    device is used.
+*/
+QTiledImagePaintDevice::QTiledImagePaintDevice(QImage *image)
+    : d_ptr(new QTiledImagePaintDevicePrivate(image))
+{
+}
+
+/*!
+    Destroys the paint device. The image is not affected.
+*/
+QTiledImagePaintDevice::~QTiledImagePaintDevice()
+{
+}
+
+/*!
+    Returns the image that the device paints on.
+*/
+QImage *QTiledImagePaintDevice::image() const
+{
+    Q_D(const QTiledImagePaintDevice);
+    return d->image;
+}
+
+/*!
+    Sets the number of rows in each of the tiles that painting is split into
+    to \a height.
+
+    Lower tiles spread the work more evenly over the threads, but commands
+    that cover several tiles are replayed once for every one of them. The
+    default is 64 rows. The tile height cannot be changed while a painter is
+    active on the device.
+*/
+void QTiledImagePaintDevice::setTileHeight(int height)
+{
+    Q_D(QTiledImagePaintDevice);
+    if (height <= 0) {
+        qWarning("QTiledImagePaintDevice::setTileHeight: Invalid tile height %d", height);
+        return;
+    }
+    if (paintingActive()) {
+        qWarning("QTiledImagePaintDevice::setTileHeight: Cannot change the tile height while painting");
+        return;
+    }
+    d->tileHeight = height;
+}
+
+/*!
+    Returns the number of rows in each of the tiles that painting is split
+    into.
+*/
+int QTiledImagePaintDevice::tileHeight() const
+{
+    Q_D(const QTiledImagePaintDevice);
+    return d->tileHeight;
+}
+
+/*!
+    \internal
+*/
+int QTiledImagePaintDevice::devType() const
+{
+    return QInternal::CustomRaster;
+}
+
+/*!
+    \reimp
+*/
+QPaintEngine *QTiledImagePaintDevice::paintEngine() const
+{
+    Q_D(const QTiledImagePaintDevice);
+    return d->engine.data();
+}
+
+/*!
+    \reimp
+*/
+int QTiledImagePaintDevice::metric(PaintDeviceMetric metric) const
+{
+    Q_D(const QTiledImagePaintDevice);
+    const QImage *image = d->image;
+
+    switch (metric) {
+    case PdmWidth:
+        return image->width();
+    case PdmHeight:
+        return image->height();
+    case PdmWidthMM:
+        return image->widthMM();
+    case PdmHeightMM:
+        return image->heightMM();
+    case PdmNumColors:
+        return image->colorCount();
+    case PdmDepth:
+        return image->depth();
+    case PdmDpiX:
+        return image->logicalDpiX();
+    case PdmDpiY:
+        return image->logicalDpiY();
+    case PdmPhysicalDpiX:
+        return image->physicalDpiX();
+    case PdmPhysicalDpiY:
+        return image->physicalDpiY();
+    case PdmDevicePixelRatio:
+        return image->devicePixelRatio();
+    case PdmDevicePixelRatioScaled:
+        return image->devicePixelRatioF() * QPaintDevice::devicePixelRatioFScale();
+    default:
+        qWarning("QTiledImagePaintDevice::metric(): Unhandled metric type %d", metric);
+        break;
+    }
+    return 0;
+}
+
+namespace {
+// Accumulates the rectangle spanned by a set of points.
+class QTiledBounds
+{
+public:
+    QTiledBounds()
+        : minX(std::numeric_limits<qreal>::max()), minY(std::numeric_limits<qreal>::max()),
+          maxX(-std::numeric_limits<qreal>::max()), maxY(-std::numeric_limits<qreal>::max())
+    {
+    }
+
+    void add(const QPointF &point)
+    {
+        minX = qMin(minX, point.x());
+        minY = qMin(minY, point.y());
+        maxX = qMax(maxX, point.x());
+        maxY = qMax(maxY, point.y());
+    }
+
+    QRectF rect() const { return QRectF(QPointF(minX, minY), QPointF(maxX, maxY)); }
+
+private:
+    qreal minX;
+    qreal minY;
+    qreal maxX;
+    qreal maxY;
+};
+}
+
+template <typename T>
+static QByteArray copyArray(const T *data, int count)
+{
+    return QByteArray(reinterpret_cast<const char *>(data), count * int(sizeof(T)));
+}
+
+template <typename T>
+static const T *arrayData(const QByteArray &array)
+{
+    return reinterpret_cast<const T *>(array.constData());
+}
+
+// Maps the logical rectangle rect to the device pixels that painting inside
+// it can touch, growing it by margin device pixels.
+static QRect mapToDevice(const QTransform &matrix, const QRectF &rect, qreal margin,
+                         const QRect &deviceRect)
+{
+    if (matrix.type() >= QTransform::TxProject)
+        return deviceRect;
+
+    QRectF bounds = matrix.mapRect(rect);
+    if (!qIsFinite(bounds.left()) || !qIsFinite(bounds.top())
+        || !qIsFinite(bounds.right()) || !qIsFinite(bounds.bottom())) {
+        return deviceRect;
+    }
+
+    // Leave room for antialiasing and for rounding to whole pixels.
+    margin += 2;
+    bounds.adjust(-margin, -margin, margin, margin);
+    return (bounds & QRectF(deviceRect)).toAlignedRect();
+}
+
+// QPen and QBrush compute some of their data on first use. Do that while
+// recording, so that the threads that replay the commands only read them.
+static bool prepareForSharing(const QBrush &brush)
+{
+    if (brush.style() != Qt::TexturePattern)
+        return false;
+    (void) brush.textureImage();
+    return qHasPixmapTexture(brush);
+}
+
+static bool prepareForSharing(const QPen &pen)
+{
+    (void) pen.dashPattern();
+    return prepareForSharing(pen.brush());
+}
+
+static qreal textMargin(QFontEngine *fontEngine)
+{
+    return qMax((fontEngine->ascent() + fontEngine->descent()).toReal(), fontEngine->maxCharWidth());
+}
+
+QTiledImagePaintEngine::QTiledImagePaintEngine(QTiledImagePaintDevicePrivate *device)
+    : device(device),
+      imageEngine(0),
+      tileHeight(0),
+      tileCount(0),
+      operationState(-1),
+      stateDirty(true),
+      usesPixmaps(false)
+{
+}
+
+QTiledImagePaintEngine::~QTiledImagePaintEngine()
+{
+    reset();
+}
+
+bool QTiledImagePaintEngine::begin(QPaintDevice *)
+{
+    QImage *image = device->image;
+    switch (image->format()) {
+    case QImage::Format_Invalid:
+    case QImage::Format_Mono:
+    case QImage::Format_MonoLSB:
+    case QImage::Format_Indexed8:
+        qWarning("QTiledImagePaintDevice: Cannot paint on an image of format %d", int(image->format()));
+        return false;
+    default:
+        break;
+    }
+
+    QPaintEngine *engine = image->paintEngine();
+    if (!engine || !engine->isExtended())
+        return false;
+    imageEngine = static_cast<QPaintEngineEx *>(engine);
+
+    deviceRect = image->rect();
+    tileHeight = device->tileHeight;
+    tileCount = (deviceRect.height() + tileHeight - 1) / tileHeight;
+    stateDirty = true;
+    usesPixmaps = false;
+    return true;
+}
+
+bool QTiledImagePaintEngine::end()
+{
+    if (!operations.isEmpty())
+        render();
+    reset();
+    return true;
+}
+
+void QTiledImagePaintEngine::reset()
+{
+    states.clear();
+    clips.clear();
+    operations.clear();
+    qDeleteAll(texts);
+    texts.clear();
+    passes.clear();
+}
+
+void QTiledImagePaintEngine::setState(QPainterState *s)
+{
+    QPaintEngineEx::setState(s);
+    stateDirty = true;
+}
+
+void QTiledImagePaintEngine::penChanged()
+{
+    stateDirty = true;
+}
+
+void QTiledImagePaintEngine::brushChanged()
+{
+    stateDirty = true;
+}
+
+void QTiledImagePaintEngine::brushOriginChanged()
+{
+    stateDirty = true;
+}
+
+void QTiledImagePaintEngine::opacityChanged()
+{
+    stateDirty = true;
+}
+
+void QTiledImagePaintEngine::compositionModeChanged()
+{
+    stateDirty = true;
+}
+
+void QTiledImagePaintEngine::renderHintsChanged()
+{
+    stateDirty = true;
+}
+
+void QTiledImagePaintEngine::transformChanged()
+{
+    stateDirty = true;
+}
+
+void QTiledImagePaintEngine::clipEnabledChanged()
+{
+    stateDirty = true;
+}
+
+// QPainter keeps the clip operations in its state, and that is what gets
+// replayed, so the operation itself only needs to invalidate the state.
+void QTiledImagePaintEngine::clip(const QVectorPath &, Qt::ClipOperation)
+{
+    stateDirty = true;
+}
+
+int QTiledImagePaintEngine::currentClip()
+{
+    const QPainterState *s = state();
+
+    // Changing the clip stack detaches it from the copy in the last snapshot.
+    if (!clips.isEmpty()) {
+        const QTiledPaintClip &last = clips.constLast();
+        if (last.enabled == s->clipEnabled && last.info.isSharedWith(s->clipInfo))
+            return clips.size() - 1;
+    }
+
+    QTiledPaintClip clip;
+    clip.enabled = s->clipEnabled;
+    clip.bounded = false;
+    clip.info = s->clipInfo;
+
+    for (const QPainterClipInfo &info : qAsConst(clip.info)) {
+        if (info.operation == Qt::NoClip) {
+            clip.bounded = false;
+            continue;
+        }
+
+        QRectF rect;
+        switch (info.clipType) {
+        case QPainterClipInfo::RegionClip:
+            rect = info.region.boundingRect();
+            break;
+        case QPainterClipInfo::PathClip:
+            if (!info.path.isEmpty())
+                (void) qtVectorPathForPath(info.path).controlPointRect();
+            rect = info.path.controlPointRect();
+            break;
+        case QPainterClipInfo::RectClip:
+            rect = info.rect;
+            break;
+        case QPainterClipInfo::RectFClip:
+            rect = info.rectf;
+            break;
+        }
+
+        const QRect bounds = mapToDevice(info.matrix, rect, 0, deviceRect);
+        if (clip.bounded && info.operation == Qt::IntersectClip)
+            clip.bounds &= bounds;
+        else
+            clip.bounds = bounds;
+        clip.bounded = true;
+    }
+    if (!clip.enabled)
+        clip.bounded = false;
+
+    clips.append(clip);
+    return clips.size() - 1;
+}
+
+int QTiledImagePaintEngine::currentState()
+{
+    const QPainterState *s = state();
+
+    // QPainter adjusts the matrix without notifying the engine when it draws
+    // static text, so that has to be compared as well.
+    if (!stateDirty && states.constLast().matrix == s->matrix)
+        return states.size() - 1;
+
+    QTiledPaintState snapshot;
+    snapshot.pen = s->pen;
+    snapshot.brush = s->brush;
+    snapshot.brushOrigin = s->brushOrigin;
+    snapshot.opacity = s->opacity;
+    snapshot.compositionMode = s->composition_mode;
+    snapshot.renderHints = s->renderHints;
+    snapshot.matrix = s->matrix;
+    snapshot.clip = currentClip();
+    if (prepareForSharing(snapshot.pen))
+        usesPixmaps = true;
+    if (prepareForSharing(snapshot.brush))
+        usesPixmaps = true;
+
+    states.append(snapshot);
+    stateDirty = false;
+    return states.size() - 1;
+}
+
+// Returns the device pixels that an operation inside the logical rectangle
+// rect can change under the current state and clip, and selects the state
+// snapshot that the next recorded operation refers to.
+QRect QTiledImagePaintEngine::deviceBounds(const QRectF &rect, qreal margin)
+{
+    return deviceBounds(state()->matrix, rect, margin);
+}
+
+QRect QTiledImagePaintEngine::deviceBounds(const QTransform &matrix, const QRectF &rect, qreal margin)
+{
+    operationState = currentState();
+    QRect bounds = mapToDevice(matrix, rect, margin, deviceRect);
+    const QTiledPaintClip &clip = clips.at(states.at(operationState).clip);
+    if (clip.bounded)
+        bounds &= clip.bounds;
+    return bounds;
+}
+
+// Returns how far the stroke drawn with pen can reach beyond the outline
+// that it follows, in device pixels.
+qreal QTiledImagePaintEngine::strokeMargin(const QPen &pen) const
+{
+    if (pen.style() == Qt::NoPen)
+        return 0;
+
+    qreal width = pen.widthF();
+    if (width == 0)
+        width = 1;
+    if (pen.joinStyle() == Qt::MiterJoin || pen.joinStyle() == Qt::SvgMiterJoin)
+        width *= qMax(pen.miterLimit(), qreal(1));
+
+    // Cosmetic pens are not transformed; the Frobenius norm bounds how much
+    // the matrix can stretch all others.
+    const QTransform &m = state()->matrix;
+    const qreal scale = qSqrt(m.m11() * m.m11() + m.m12() * m.m12()
+                              + m.m21() * m.m21() + m.m22() * m.m22());
+    return width * qMax(scale, qreal(1));
+}
+
+// Returns whether lines drawn with pen are wider than a pixel, in which
+// case the raster engine rasterizes them itself instead of handing them to
+// the cosmetic stroker, and clips them against the tile.
+bool QTiledImagePaintEngine::isWidePen(const QPen &pen) const
+{
+    if (pen.style() == Qt::NoPen)
+        return false;
+    const QPainterState *s = state();
+    if (qt_pen_is_cosmetic(pen, s->renderHints))
+        return pen.widthF() > 1;
+
+    // Sheared lines are stroked into a path, which is filled exactly.
+    qreal scale;
+    if (!qt_scaleForTransform(s->matrix, &scale))
+        return false;
+    return pen.widthF() * scale > 1;
+}
+
+// Returns whether rectangles and images are rotated on the device, in
+// which case the raster engine clips their edges against the tile.
+bool QTiledImagePaintEngine::isRotated() const
+{
+    return state()->matrix.type() >= QTransform::TxRotate;
+}
+
+template <typename T>
+static bool isHorizontal(const T &line)
+{
+    return line.y1() == line.y2();
+}
+
+// Records operation, which can change the device pixels in bounds. Unless
+// it is tiled, it is painted on the whole image by one thread, in order
+// with the operations around it.
+void QTiledImagePaintEngine::record(const QTiledPaintOperation &operation, const QRect &bounds, bool tiled)
+{
+    const int index = operations.size();
+    operations.append(operation);
+    operations.last().state = operationState;
+
+    if (passes.isEmpty() || passes.constLast().tiled != tiled) {
+        QTiledPaintPass pass;
+        pass.tiled = tiled;
+        pass.bins.resize(tiled ? tileCount : 1);
+        passes.append(pass);
+    }
+
+    QVector<QVector<int> > &bins = passes.last().bins;
+    if (!tiled) {
+        bins.first().append(index);
+        return;
+    }
+    const int lastTile = bounds.bottom() / tileHeight;
+    for (int tile = bounds.top() / tileHeight; tile <= lastTile; ++tile)
+        bins[tile].append(index);
+}
+
+void QTiledImagePaintEngine::recordVectorPath(QTiledPaintOperation &operation, const QVectorPath &path)
+{
+    operation.count = path.elementCount();
+    operation.geometry = copyArray(path.points(), operation.count * 2);
+    if (path.elements())
+        operation.elements = copyArray(path.elements(), operation.count);
+    // The cached data belongs to the path that was passed in.
+    operation.mode = path.hints() & ~(QVectorPath::IsCachedHint | QVectorPath::ShouldUseCacheHint
+                                      | QVectorPath::ControlPointRect);
+}
+
+void QTiledImagePaintEngine::fill(const QVectorPath &path, const QBrush &brush)
+{
+    if (path.isEmpty())
+        return;
+    const QRect bounds = deviceBounds(path.controlPointRect(), 0);
+    if (bounds.isEmpty())
+        return;
+
+    QTiledPaintOperation operation(QTiledPaintOperation::Fill);
+    recordVectorPath(operation, path);
+    operation.brush = brush;
+    if (prepareForSharing(brush))
+        usesPixmaps = true;
+    record(operation, bounds, path.shape() != QVectorPath::RectangleHint || !isRotated());
+}
+
+void QTiledImagePaintEngine::stroke(const QVectorPath &path, const QPen &pen)
+{
+    if (path.isEmpty())
+        return;
+    const QRect bounds = deviceBounds(path.controlPointRect(), strokeMargin(pen));
+    if (bounds.isEmpty())
+        return;
+
+    bool tiled = true;
+    if (path.shape() == QVectorPath::LinesHint && isWidePen(pen)) {
+        tiled = !isRotated();
+        const QLineF *lines = reinterpret_cast<const QLineF *>(path.points());
+        for (int i = 0; tiled && i < path.elementCount() / 2; ++i)
+            tiled = isHorizontal(lines[i]);
+    }
+
+    QTiledPaintOperation operation(QTiledPaintOperation::Stroke);
+    recordVectorPath(operation, path);
+    operation.pen = pen;
+    if (prepareForSharing(pen))
+        usesPixmaps = true;
+    record(operation, bounds, tiled);
+}
+
+void QTiledImagePaintEngine::fillRect(const QRectF &rect, const QBrush &brush)
+{
+    const QRect bounds = deviceBounds(rect, 0);
+    if (bounds.isEmpty())
+        return;
+
+    QTiledPaintOperation operation(QTiledPaintOperation::FillRect);
+    operation.rect = rect;
+    operation.brush = brush;
+    if (prepareForSharing(brush))
+        usesPixmaps = true;
+    record(operation, bounds, !isRotated());
+}
+
+void QTiledImagePaintEngine::fillRect(const QRectF &rect, const QColor &color)
+{
+    const QRect bounds = deviceBounds(rect, 0);
+    if (bounds.isEmpty())
+        return;
+
+    QTiledPaintOperation operation(QTiledPaintOperation::FillRectColor);
+    operation.rect = rect;
+    operation.brush = color;
+    record(operation, bounds, !isRotated());
+}
+
+void QTiledImagePaintEngine::drawRects(const QRect *rects, int rectCount)
+{
+    if (rectCount <= 0)
+        return;
+    QTiledBounds rectBounds;
+    for (int i = 0; i < rectCount; ++i) {
+        const QRectF rect(rects[i]);
+        rectBounds.add(rect.topLeft());
+        rectBounds.add(rect.bottomRight());
+    }
+    const QRect bounds = deviceBounds(rectBounds.rect(), strokeMargin(state()->pen));
+    if (bounds.isEmpty())
+        return;
+
+    QTiledPaintOperation operation(QTiledPaintOperation::DrawRects);
+    operation.count = rectCount;
+    operation.geometry = copyArray(rects, rectCount);
+    record(operation, bounds, state()->brush.style() == Qt::NoBrush || !isRotated());
+}
+
+void QTiledImagePaintEngine::drawRects(const QRectF *rects, int rectCount)
+{
+    if (rectCount <= 0)
+        return;
+    QTiledBounds rectBounds;
+    for (int i = 0; i < rectCount; ++i) {
+        rectBounds.add(rects[i].topLeft());
+        rectBounds.add(rects[i].bottomRight());
+    }
+    const QRect bounds = deviceBounds(rectBounds.rect(), strokeMargin(state()->pen));
+    if (bounds.isEmpty())
+        return;
+
+    QTiledPaintOperation operation(QTiledPaintOperation::DrawRectFs);
+    operation.count = rectCount;
+    operation.geometry = copyArray(rects, rectCount);
+    record(operation, bounds, state()->brush.style() == Qt::NoBrush || !isRotated());
+}
+
+void QTiledImagePaintEngine::drawLines(const QLine *lines, int lineCount)
+{
+    if (lineCount <= 0)
+        return;
+    QTiledBounds lineBounds;
+    for (int i = 0; i < lineCount; ++i) {
+        lineBounds.add(lines[i].p1());
+        lineBounds.add(lines[i].p2());
+    }
+    const QRect bounds = deviceBounds(lineBounds.rect(), strokeMargin(state()->pen));
+    if (bounds.isEmpty())
+        return;
+
+    bool tiled = true;
+    if (isWidePen(state()->pen)) {
+        tiled = !isRotated();
+        for (int i = 0; tiled && i < lineCount; ++i)
+            tiled = isHorizontal(lines[i]);
+    }
+
+    QTiledPaintOperation operation(QTiledPaintOperation::DrawLines);
+    operation.count = lineCount;
+    operation.geometry = copyArray(lines, lineCount);
+    record(operation, bounds, tiled);
+}
+
+void QTiledImagePaintEngine::drawLines(const QLineF *lines, int lineCount)
+{
+    if (lineCount <= 0)
+        return;
+    QTiledBounds lineBounds;
+    for (int i = 0; i < lineCount; ++i) {
+        lineBounds.add(lines[i].p1());
+        lineBounds.add(lines[i].p2());
+    }
+    const QRect bounds = deviceBounds(lineBounds.rect(), strokeMargin(state()->pen));
+    if (bounds.isEmpty())
+        return;
+
+    bool tiled = true;
+    if (isWidePen(state()->pen)) {
+        tiled = !isRotated();
+        for (int i = 0; tiled && i < lineCount; ++i)
+            tiled = isHorizontal(lines[i]);
+    }
+
+    QTiledPaintOperation operation(QTiledPaintOperation::DrawLineFs);
+    operation.count = lineCount;
+    operation.geometry = copyArray(lines, lineCount);
+    record(operation, bounds, tiled);
+}
+
+void QTiledImagePaintEngine::drawEllipse(const QRectF &rect)
+{
+    const QRect bounds = deviceBounds(rect, strokeMargin(state()->pen));
+    if (bounds.isEmpty())
+        return;
+
+    QTiledPaintOperation operation(QTiledPaintOperation::DrawEllipse);
+    operation.rect = rect;
+    record(operation, bounds);
+}
+
+void QTiledImagePaintEngine::drawPoints(const QPointF *points, int pointCount)
+{
+    if (pointCount <= 0)
+        return;
+    QTiledBounds pointBounds;
+    for (int i = 0; i < pointCount; ++i)
+        pointBounds.add(points[i]);
+    const QRect bounds = deviceBounds(pointBounds.rect(), strokeMargin(state()->pen));
+    if (bounds.isEmpty())
+        return;
+
+    QTiledPaintOperation operation(QTiledPaintOperation::DrawPointFs);
+    operation.count = pointCount;
+    operation.geometry = copyArray(points, pointCount);
+    // Wide points are drawn as short horizontal lines.
+    record(operation, bounds, !isWidePen(state()->pen) || !isRotated());
+}
+
+void QTiledImagePaintEngine::drawPoints(const QPoint *points, int pointCount)
+{
+    if (pointCount <= 0)
+        return;
+    QTiledBounds pointBounds;
+    for (int i = 0; i < pointCount; ++i)
+        pointBounds.add(points[i]);
+    const QRect bounds = deviceBounds(pointBounds.rect(), strokeMargin(state()->pen));
+    if (bounds.isEmpty())
+        return;
+
+    QTiledPaintOperation operation(QTiledPaintOperation::DrawPoints);
+    operation.count = pointCount;
+    operation.geometry = copyArray(points, pointCount);
+    // Wide points are drawn as short horizontal lines.
+    record(operation, bounds, !isWidePen(state()->pen) || !isRotated());
+}
+
+void QTiledImagePaintEngine::drawPolygon(const QPointF *points, int pointCount, PolygonDrawMode mode)
+{
+    if (pointCount <= 0)
+        return;
+    QTiledBounds pointBounds;
+    for (int i = 0; i < pointCount; ++i)
+        pointBounds.add(points[i]);
+    const QRect bounds = deviceBounds(pointBounds.rect(), strokeMargin(state()->pen));
+    if (bounds.isEmpty())
+        return;
+
+    QTiledPaintOperation operation(QTiledPaintOperation::DrawPolygonF);
+    operation.count = pointCount;
+    operation.geometry = copyArray(points, pointCount);
+    operation.mode = mode;
+    record(operation, bounds);
+}
+
+void QTiledImagePaintEngine::drawPolygon(const QPoint *points, int pointCount, PolygonDrawMode mode)
+{
+    if (pointCount <= 0)
+        return;
+    QTiledBounds pointBounds;
+    for (int i = 0; i < pointCount; ++i)
+        pointBounds.add(points[i]);
+    const QRect bounds = deviceBounds(pointBounds.rect(), strokeMargin(state()->pen));
+    if (bounds.isEmpty())
+        return;
+
+    QTiledPaintOperation operation(QTiledPaintOperation::DrawPolygon);
+    operation.count = pointCount;
+    operation.geometry = copyArray(points, pointCount);
+    operation.mode = mode;
+    record(operation, bounds);
+}
+
+void QTiledImagePaintEngine::drawPixmap(const QPointF &pos, const QPixmap &pixmap)
+{
+    const QSizeF size = QSizeF(pixmap.size()) / qMin(pixmap.devicePixelRatio(), qreal(1));
+    const QRect bounds = deviceBounds(QRectF(pos, size), 0);
+    if (bounds.isEmpty())
+        return;
+
+    QTiledPaintOperation operation(QTiledPaintOperation::DrawPixmapAt);
+    operation.point = pos;
+    operation.pixmap = pixmap;
+    usesPixmaps = true;
+    record(operation, bounds, !isRotated());
+}
+
+void QTiledImagePaintEngine::drawPixmap(const QRectF &rect, const QPixmap &pixmap, const QRectF &sourceRect)
+{
+    const QRect bounds = deviceBounds(rect, 0);
+    if (bounds.isEmpty())
+        return;
+
+    QTiledPaintOperation operation(QTiledPaintOperation::DrawPixmap);
+    operation.rect = rect;
+    operation.sourceRect = sourceRect;
+    operation.pixmap = pixmap;
+    usesPixmaps = true;
+    record(operation, bounds, !isRotated());
+}
+
+void QTiledImagePaintEngine::drawTiledPixmap(const QRectF &rect, const QPixmap &pixmap, const QPointF &offset)
+{
+    const QRect bounds = deviceBounds(rect, 0);
+    if (bounds.isEmpty())
+        return;
+
+    QTiledPaintOperation operation(QTiledPaintOperation::DrawTiledPixmap);
+    operation.rect = rect;
+    operation.point = offset;
+    operation.pixmap = pixmap;
+    usesPixmaps = true;
+    record(operation, bounds, !isRotated());
+}
+
+void QTiledImagePaintEngine::drawImage(const QPointF &pos, const QImage &image)
+{
+    const QSizeF size = QSizeF(image.size()) / qMin(image.devicePixelRatio(), qreal(1));
+    const QRect bounds = deviceBounds(QRectF(pos, size), 0);
+    if (bounds.isEmpty())
+        return;
+
+    QTiledPaintOperation operation(QTiledPaintOperation::DrawImageAt);
+    operation.point = pos;
+    operation.image = image;
+    record(operation, bounds, !isRotated());
+}
+
+void QTiledImagePaintEngine::drawImage(const QRectF &rect, const QImage &image, const QRectF &sourceRect,
+                                       Qt::ImageConversionFlags flags)
+{
+    const QRect bounds = deviceBounds(rect, 0);
+    if (bounds.isEmpty())
+        return;
+
+    QTiledPaintOperation operation(QTiledPaintOperation::DrawImage);
+    operation.rect = rect;
+    operation.sourceRect = sourceRect;
+    operation.image = image;
+    operation.mode = flags;
+    record(operation, bounds, !isRotated());
+}
+
+void QTiledImagePaintEngine::drawTextItem(const QPointF &pos, const QTextItem &textItem)
+{
+    const QTextItemInt &ti = static_cast<const QTextItemInt &>(textItem);
+    const int glyphCount = ti.glyphs.numGlyphs;
+    if (glyphCount == 0)
+        return;
+
+    const qreal margin = textMargin(ti.fontEngine);
+    const QRectF rect(pos.x() - margin, pos.y() - ti.ascent.toReal() - margin,
+                      ti.width.toReal() + 2 * margin, (ti.ascent + ti.descent).toReal() + 2 * margin);
+    const QRect bounds = deviceBounds(rect, 0);
+    if (bounds.isEmpty())
+        return;
+
+    // The glyph arrays only live as long as this call, so take a deep copy.
+    QTiledPaintText *text = new QTiledPaintText;
+    text->glyphData.resize(glyphCount * QGlyphLayout::SpaceNeeded);
+    text->glyphs = QGlyphLayout(text->glyphData.data(), glyphCount);
+    memcpy(text->glyphs.offsets, ti.glyphs.offsets, glyphCount * sizeof(QFixedPoint));
+    memcpy(text->glyphs.glyphs, ti.glyphs.glyphs, glyphCount * sizeof(glyph_t));
+    memcpy(text->glyphs.advances, ti.glyphs.advances, glyphCount * sizeof(QFixed));
+    memcpy(text->glyphs.justifications, ti.glyphs.justifications, glyphCount * sizeof(QGlyphJustification));
+    memcpy(text->glyphs.attributes, ti.glyphs.attributes, glyphCount * sizeof(QGlyphAttributes));
+    if (ti.f)
+        text->font = *ti.f;
+    text->fontEngine = ti.fontEngine;
+    text->flags = ti.flags;
+    text->ascent = ti.ascent;
+    text->descent = ti.descent;
+    text->width = ti.width;
+
+    QTiledPaintOperation operation(QTiledPaintOperation::DrawTextItem);
+    operation.point = pos;
+    operation.text = texts.size();
+    texts.append(text);
+    record(operation, bounds);
+}
+
+void QTiledImagePaintEngine::drawStaticTextItem(QStaticTextItem *textItem)
+{
+    const int glyphCount = textItem->numGlyphs;
+    if (glyphCount == 0)
+        return;
+
+    QTiledBounds glyphBounds;
+    for (int i = 0; i < glyphCount; ++i)
+        glyphBounds.add(QPointF(textItem->glyphPositions[i].x.toReal(), textItem->glyphPositions[i].y.toReal()));
+    const qreal margin = textMargin(textItem->fontEngine());
+    QRect bounds;
+    const QTransform &matrix = state()->matrix;
+    if (imageEngine->requiresPretransformedGlyphPositions(textItem->fontEngine(), matrix)) {
+        // The positions are in device coordinates already, but the glyphs
+        // are still drawn with the rest of the transformation.
+        const QRectF glyphRect = QTransform(matrix.m11(), matrix.m12(), matrix.m21(), matrix.m22(), 0, 0)
+                .mapRect(QRectF(-margin, -margin, 2 * margin, 2 * margin));
+        bounds = deviceBounds(QTransform::fromTranslate(matrix.dx(), matrix.dy()),
+                              glyphBounds.rect().adjusted(glyphRect.left(), glyphRect.top(),
+                                                          glyphRect.right(), glyphRect.bottom()), 0);
+    } else {
+        bounds = deviceBounds(glyphBounds.rect().adjusted(-margin, -margin, margin, margin), 0);
+    }
+    if (bounds.isEmpty())
+        return;
+
+    QTiledPaintText *text = new QTiledPaintText;
+    text->glyphIds = QVector<glyph_t>(glyphCount);
+    memcpy(text->glyphIds.data(), textItem->glyphs, glyphCount * sizeof(glyph_t));
+    text->glyphPositions = QVector<QFixedPoint>(glyphCount);
+    memcpy(text->glyphPositions.data(), textItem->glyphPositions, glyphCount * sizeof(QFixedPoint));
+    text->staticTextItem = *textItem;
+    text->staticTextItem.setUserData(0);
+    text->staticTextItem.glyphs = text->glyphIds.data();
+    text->staticTextItem.glyphPositions = text->glyphPositions.data();
+
+    QTiledPaintOperation operation(QTiledPaintOperation::DrawStaticTextItem);
+    operation.text = texts.size();
+    texts.append(text);
+    record(operation, bounds);
+}
+
+bool QTiledImagePaintEngine::requiresPretransformedGlyphPositions(QFontEngine *fontEngine, const QTransform &m) const
+{
+    return imageEngine->requiresPretransformedGlyphPositions(fontEngine, m);
+}
+
+bool QTiledImagePaintEngine::shouldDrawCachedGlyphs(QFontEngine *fontEngine, const QTransform &m) const
+{
+    return imageEngine->shouldDrawCachedGlyphs(fontEngine, m);
+}
+
+// Replays the operations of one pass tile by tile. Every thread that takes
+// part paints through the raster engine of its own QImage, which shares the
+// pixels of the target image, with the system clip set to the current tile.
+// A pass that is not tiled is painted without a system clip.
+class QTiledImageRenderer
+{
+public:
+    QTiledImageRenderer(const QTiledImagePaintEngine *engine, const QTiledPaintPass *pass, QImage *image);
+
+    int tileCount() const { return tiles.size(); }
+    void renderTiles();
+
+private:
+    void renderTile(QImage *view, int tile);
+    void replay(QPaintEngineEx *paintEngine, const QTiledPaintOperation &operation);
+
+    const QTiledImagePaintEngine *engine;
+    const QTiledPaintPass *pass;
+    uchar *bits;
+    int width;
+    int height;
+    int bytesPerLine;
+    QImage::Format format;
+    QVector<int> tiles;
+    QAtomicInt nextTile;
+    // Drawing text fills the glyph caches of the font engine, which are
+    // not thread-safe, and every thread draws with the font engines that
+    // were current when the text was recorded. Font engines cannot be
+    // created per thread either, since the glyph positions were computed
+    // with the recorded ones, so text is drawn by one thread at a time.
+    QMutex textMutex;
+};
+
+QTiledImageRenderer::QTiledImageRenderer(const QTiledImagePaintEngine *engine, const QTiledPaintPass *pass,
+                                         QImage *image)
+    : engine(engine),
+      pass(pass),
+      bits(image->bits()),
+      width(image->width()),
+      height(image->height()),
+      bytesPerLine(image->bytesPerLine()),
+      format(image->format()),
+      nextTile(0)
+{
+    for (int i = 0; i < pass->bins.size(); ++i) {
+        if (!pass->bins.at(i).isEmpty())
+            tiles.append(i);
+    }
+}
+
+void QTiledImageRenderer::renderTiles()
+{
+    QImage view(bits, width, height, bytesPerLine, format);
+    for (int i = nextTile.fetchAndAddRelaxed(1); i < tiles.size(); i = nextTile.fetchAndAddRelaxed(1))
+        renderTile(&view, tiles.at(i));
+}
+
+// Rebuilds the clip from the painter's clip stack. The painter must not
+// have a clip yet, so that the raster engine sets it up like it did when it
+// was first recorded.
+static void applyClip(QPainter *painter, const QTiledPaintClip &clip)
+{
+    for (const QPainterClipInfo &info : clip.info) {
+        painter->setTransform(info.matrix);
+        switch (info.clipType) {
+        case QPainterClipInfo::RegionClip:
+            painter->setClipRegion(info.region, info.operation);
+            break;
+        case QPainterClipInfo::PathClip:
+            painter->setClipPath(info.path, info.operation);
+            break;
+        case QPainterClipInfo::RectClip:
+            painter->setClipRect(info.rect, info.operation);
+            break;
+        case QPainterClipInfo::RectFClip:
+            painter->setClipRect(info.rectf, info.operation);
+            break;
+        }
+    }
+    if (!clip.enabled)
+        painter->setClipping(false);
+}
+
+static void applyState(QPainter *painter, const QTiledPaintState &state)
+{
+    painter->setTransform(state.matrix);
+    painter->setPen(state.pen);
+    painter->setBrush(state.brush);
+    painter->setBrushOrigin(state.brushOrigin);
+    painter->setOpacity(state.opacity);
+    painter->setCompositionMode(state.compositionMode);
+    painter->setRenderHints(painter->renderHints() & ~state.renderHints, false);
+    painter->setRenderHints(state.renderHints, true);
+}
+
+void QTiledImageRenderer::renderTile(QImage *view, int tile)
+{
+    if (pass->tiled) {
+        const QRect tileRect(0, tile * engine->tileHeight, engine->deviceRect.width(), engine->tileHeight);
+        view->paintEngine()->setSystemClip(QRegion(tileRect & engine->deviceRect));
+    }
+
+    QPainter painter(view);
+    QPaintEngineEx *paintEngine = static_cast<QPaintEngineEx *>(painter.paintEngine());
+    painter.save();
+    int currentState = -1;
+    int currentClip = -1;
+    for (int index : pass->bins.at(tile)) {
+        const QTiledPaintOperation &operation = engine->operations.at(index);
+        if (operation.state != currentState) {
+            const QTiledPaintState &state = engine->states.at(operation.state);
+            if (state.clip != currentClip) {
+                if (currentClip != -1) {
+                    painter.restore();
+                    painter.save();
+                }
+                applyClip(&painter, engine->clips.at(state.clip));
+                currentClip = state.clip;
+            }
+            applyState(&painter, state);
+            currentState = operation.state;
+        }
+        replay(paintEngine, operation);
+    }
+    painter.restore();
+}
+
+void QTiledImageRenderer::replay(QPaintEngineEx *paintEngine, const QTiledPaintOperation &operation)
+{
+    switch (operation.type) {
+    case QTiledPaintOperation::Fill:
+    case QTiledPaintOperation::Stroke: {
+        const QPainterPath::ElementType *elements = operation.elements.isEmpty()
+                ? 0 : arrayData<QPainterPath::ElementType>(operation.elements);
+        const QVectorPath path(arrayData<qreal>(operation.geometry), operation.count, elements, operation.mode);
+        if (operation.type == QTiledPaintOperation::Fill)
+            paintEngine->fill(path, operation.brush);
+        else
+            paintEngine->stroke(path, operation.pen);
+        break;
+    }
+    case QTiledPaintOperation::FillRect:
+        paintEngine->fillRect(operation.rect, operation.brush);
+        break;
+    case QTiledPaintOperation::FillRectColor:
+        paintEngine->fillRect(operation.rect, operation.brush.color());
+        break;
+    case QTiledPaintOperation::DrawRects:
+        paintEngine->drawRects(arrayData<QRect>(operation.geometry), operation.count);
+        break;
+    case QTiledPaintOperation::DrawRectFs:
+        paintEngine->drawRects(arrayData<QRectF>(operation.geometry), operation.count);
+        break;
+    case QTiledPaintOperation::DrawLines:
+        paintEngine->drawLines(arrayData<QLine>(operation.geometry), operation.count);
+        break;
+    case QTiledPaintOperation::DrawLineFs:
+        paintEngine->drawLines(arrayData<QLineF>(operation.geometry), operation.count);
+        break;
+    case QTiledPaintOperation::DrawEllipse:
+        paintEngine->drawEllipse(operation.rect);
+        break;
+    case QTiledPaintOperation::DrawPoints:
+        paintEngine->drawPoints(arrayData<QPoint>(operation.geometry), operation.count);
+        break;
+    case QTiledPaintOperation::DrawPointFs:
+        paintEngine->drawPoints(arrayData<QPointF>(operation.geometry), operation.count);
+        break;
+    case QTiledPaintOperation::DrawPolygon:
+        paintEngine->drawPolygon(arrayData<QPoint>(operation.geometry), operation.count,
+                                 QPaintEngine::PolygonDrawMode(operation.mode));
+        break;
+    case QTiledPaintOperation::DrawPolygonF:
+        paintEngine->drawPolygon(arrayData<QPointF>(operation.geometry), operation.count,
+                                 QPaintEngine::PolygonDrawMode(operation.mode));
+        break;
+    case QTiledPaintOperation::DrawPixmap:
+        paintEngine->drawPixmap(operation.rect, operation.pixmap, operation.sourceRect);
+        break;
+    case QTiledPaintOperation::DrawPixmapAt:
+        paintEngine->drawPixmap(operation.point, operation.pixmap);
+        break;
+    case QTiledPaintOperation::DrawTiledPixmap:
+        paintEngine->drawTiledPixmap(operation.rect, operation.pixmap, operation.point);
+        break;
+    case QTiledPaintOperation::DrawImage:
+        paintEngine->drawImage(operation.rect, operation.image, operation.sourceRect,
+                               Qt::ImageConversionFlags(operation.mode));
+        break;
+    case QTiledPaintOperation::DrawImageAt:
+        paintEngine->drawImage(operation.point, operation.image);
+        break;
+    case QTiledPaintOperation::DrawTextItem: {
+        const QTiledPaintText *text = engine->texts.at(operation.text);
+        QTextItemInt ti;
+        ti.glyphs = text->glyphs;
+        ti.fontEngine = text->fontEngine.data();
+        ti.f = &text->font;
+        ti.flags = text->flags;
+        ti.ascent = text->ascent;
+        ti.descent = text->descent;
+        ti.width = text->width;
+        // Glyph caches are shared between all users of a font engine.
+        QMutexLocker locker(&textMutex);
+        paintEngine->drawTextItem(operation.point, ti);
+        break;
+    }
+    case QTiledPaintOperation::DrawStaticTextItem: {
+        QMutexLocker locker(&textMutex);
+        QStaticTextItem textItem = engine->texts.at(operation.text)->staticTextItem;
+        paintEngine->drawStaticTextItem(&textItem);
+        break;
+    }
+    }
+}
+
+#ifndef QT_NO_THREAD
+namespace {
+class QTiledImageRenderTask : public QRunnable
+{
+public:
+    QTiledImageRenderTask(QTiledImageRenderer *renderer, QSemaphore *done)
+        : renderer(renderer), done(done)
+    {
+    }
+
+    void run() override
+    {
+        renderer->renderTiles();
+        done->release();
+    }
+
+private:
+    QTiledImageRenderer *renderer;
+    QSemaphore *done;
+};
+}
+#endif // QT_NO_THREAD
+
+void QTiledImagePaintEngine::render()
+{
+#ifndef QT_NO_THREAD
+    int maxThreads = QThreadPool::globalInstance()->maxThreadCount();
+    if (usesPixmaps) {
+        // Painting a pixmap, or with a pixmap brush, may convert or copy it.
+        const QPlatformIntegration *integration = QGuiApplicationPrivate::platformIntegration();
+        if (!integration || !integration->hasCapability(QPlatformIntegration::ThreadedPixmaps))
+            maxThreads = 1;
+    }
+#endif
+
+    for (const QTiledPaintPass &pass : qAsConst(passes)) {
+        QTiledImageRenderer renderer(this, &pass, device->image);
+
+#ifndef QT_NO_THREAD
+        const int threads = qMin(maxThreads, renderer.tileCount());
+
+        // The calling thread paints too, and picks up any tiles that are
+        // left when no pool thread is available.
+        QThreadPool *pool = QThreadPool::globalInstance();
+        QSemaphore done;
+        int started = 0;
+        for (int i = 1; i < threads; ++i) {
+            QTiledImageRenderTask *task = new QTiledImageRenderTask(&renderer, &done);
+            if (!pool->tryStart(task)) {
+                delete task;
+                break;
+            }
+            ++started;
+        }
+        renderer.renderTiles();
+        done.acquire(started);
+#else
+        renderer.renderTiles();
+#endif
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,270 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QTILEDIMAGEPAINTDEVICE_P_H
+#define QTILEDIMAGEPAINTDEVICE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtGui/private/qtguiglobal_p.h>
+#include "qtiledimagepaintdevice.h"
+
+#include <private/qpaintengineex_p.h>
+#include <private/qpainter_p.h>
+#include <private/qtextengine_p.h>
+#include <private/qstatictext_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class QTiledImagePaintEngine;
+
+// The painter state that was active when an operation was recorded.
+struct QTiledPaintState
+{
+    QPen pen;
+    QBrush brush;
+    QPointF brushOrigin;
+    qreal opacity;
+    QPainter::CompositionMode compositionMode;
+    QPainter::RenderHints renderHints;
+    QTransform matrix;
+    int clip;
+};
+
+// The clip that was active when an operation was recorded. The clip is
+// replayed from the painter's clip stack; bounds is the device rectangle
+// that contains it and is only meaningful when the clip is bounded.
+struct QTiledPaintClip
+{
+    bool enabled;
+    bool bounded;
+    QRect bounds;
+    QVector<QPainterClipInfo> info;
+};
+
+// Owned copy of a text item, since the glyph arrays handed to the engine
+// only live for the duration of the draw call.
+struct QTiledPaintText
+{
+    QByteArray glyphData;
+    QGlyphLayout glyphs;
+    QFont font;
+    QExplicitlySharedDataPointer<QFontEngine> fontEngine;
+    QTextItem::RenderFlags flags;
+    QFixed ascent;
+    QFixed descent;
+    QFixed width;
+
+    QVector<glyph_t> glyphIds;
+    QVector<QFixedPoint> glyphPositions;
+    QStaticTextItem staticTextItem;
+};
+
+struct QTiledPaintOperation
+{
+    enum Type {
+        Fill,
+        Stroke,
+        FillRect,
+        FillRectColor,
+        DrawRects,
+        DrawRectFs,
+        DrawLines,
+        DrawLineFs,
+        DrawEllipse,
+        DrawPoints,
+        DrawPointFs,
+        DrawPolygon,
+        DrawPolygonF,
+        DrawPixmap,
+        DrawPixmapAt,
+        DrawTiledPixmap,
+        DrawImage,
+        DrawImageAt,
+        DrawTextItem,
+        DrawStaticTextItem
+    };
+
+    explicit QTiledPaintOperation(Type type = Fill)
+        : type(type), state(-1), count(0), mode(0), text(-1)
+    {
+    }
+
+    Type type;
+    int state;
+    int count;          // number of elements in geometry
+    uint mode;          // path hints, polygon mode or image conversion flags
+    int text;           // index into QTiledImagePaintEngine::texts
+
+    QByteArray geometry;
+    QByteArray elements;
+    QRectF rect;
+    QRectF sourceRect;
+    QPointF point;
+    QBrush brush;
+    QPen pen;
+    QPixmap pixmap;
+    QImage image;
+};
+Q_DECLARE_TYPEINFO(QTiledPaintOperation, Q_MOVABLE_TYPE);
+
+// A run of consecutive operations. The operations of a tiled pass are
+// sorted into the tiles that they touch, and the tiles are painted in
+// parallel. A pass that is not tiled has a single bin, which is painted on
+// the whole image by one thread; it holds the operations that the raster
+// engine would paint differently when clipped to a tile.
+struct QTiledPaintPass
+{
+    bool tiled;
+    QVector<QVector<int> > bins;
+};
+Q_DECLARE_TYPEINFO(QTiledPaintPass, Q_MOVABLE_TYPE);
+
+class QTiledImagePaintDevicePrivate
+{
+public:
+    explicit QTiledImagePaintDevicePrivate(QImage *image);
+    ~QTiledImagePaintDevicePrivate();
+
+    QImage *image;
+    int tileHeight;
+    QScopedPointer<QTiledImagePaintEngine> engine;
+};
+
+class QTiledImagePaintEngine : public QPaintEngineEx
+{
+public:
+    explicit QTiledImagePaintEngine(QTiledImagePaintDevicePrivate *device);
+    ~QTiledImagePaintEngine();
+
+    bool begin(QPaintDevice *device) Q_DECL_OVERRIDE;
+    bool end() Q_DECL_OVERRIDE;
+
+    Type type() const Q_DECL_OVERRIDE { return User; }
+
+    void setState(QPainterState *s) Q_DECL_OVERRIDE;
+
+    void penChanged() Q_DECL_OVERRIDE;
+    void brushChanged() Q_DECL_OVERRIDE;
+    void brushOriginChanged() Q_DECL_OVERRIDE;
+    void opacityChanged() Q_DECL_OVERRIDE;
+    void compositionModeChanged() Q_DECL_OVERRIDE;
+    void renderHintsChanged() Q_DECL_OVERRIDE;
+    void transformChanged() Q_DECL_OVERRIDE;
+    void clipEnabledChanged() Q_DECL_OVERRIDE;
+
+    void clip(const QVectorPath &path, Qt::ClipOperation op) Q_DECL_OVERRIDE;
+
+    void fill(const QVectorPath &path, const QBrush &brush) Q_DECL_OVERRIDE;
+    void stroke(const QVectorPath &path, const QPen &pen) Q_DECL_OVERRIDE;
+
+    void fillRect(const QRectF &rect, const QBrush &brush) Q_DECL_OVERRIDE;
+    void fillRect(const QRectF &rect, const QColor &color) Q_DECL_OVERRIDE;
+
+    void drawRects(const QRect *rects, int rectCount) Q_DECL_OVERRIDE;
+    void drawRects(const QRectF *rects, int rectCount) Q_DECL_OVERRIDE;
+
+    void drawLines(const QLine *lines, int lineCount) Q_DECL_OVERRIDE;
+    void drawLines(const QLineF *lines, int lineCount) Q_DECL_OVERRIDE;
+
+    void drawEllipse(const QRectF &rect) Q_DECL_OVERRIDE;
+
+    void drawPoints(const QPointF *points, int pointCount) Q_DECL_OVERRIDE;
+    void drawPoints(const QPoint *points, int pointCount) Q_DECL_OVERRIDE;
+
+    void drawPolygon(const QPointF *points, int pointCount, PolygonDrawMode mode) Q_DECL_OVERRIDE;
+    void drawPolygon(const QPoint *points, int pointCount, PolygonDrawMode mode) Q_DECL_OVERRIDE;
+
+    void drawPixmap(const QPointF &pos, const QPixmap &pixmap) Q_DECL_OVERRIDE;
+    void drawPixmap(const QRectF &rect, const QPixmap &pixmap, const QRectF &sourceRect) Q_DECL_OVERRIDE;
+    void drawTiledPixmap(const QRectF &rect, const QPixmap &pixmap, const QPointF &offset) Q_DECL_OVERRIDE;
+
+    void drawImage(const QPointF &pos, const QImage &image) Q_DECL_OVERRIDE;
+    void drawImage(const QRectF &rect, const QImage &image, const QRectF &sourceRect,
+                   Qt::ImageConversionFlags flags = Qt::AutoColor) Q_DECL_OVERRIDE;
+
+    void drawTextItem(const QPointF &pos, const QTextItem &textItem) Q_DECL_OVERRIDE;
+    void drawStaticTextItem(QStaticTextItem *textItem) Q_DECL_OVERRIDE;
+
+    bool requiresPretransformedGlyphPositions(QFontEngine *fontEngine, const QTransform &m) const Q_DECL_OVERRIDE;
+    bool shouldDrawCachedGlyphs(QFontEngine *fontEngine, const QTransform &m) const Q_DECL_OVERRIDE;
+
+private:
+    int currentState();
+    int currentClip();
+    QRect deviceBounds(const QRectF &rect, qreal margin);
+    QRect deviceBounds(const QTransform &matrix, const QRectF &rect, qreal margin);
+    qreal strokeMargin(const QPen &pen) const;
+    bool isWidePen(const QPen &pen) const;
+    bool isRotated() const;
+    void record(const QTiledPaintOperation &operation, const QRect &bounds, bool tiled = true);
+    void recordVectorPath(QTiledPaintOperation &operation, const QVectorPath &path);
+    void render();
+    void reset();
+
+    QTiledImagePaintDevicePrivate *device;
+    QPaintEngineEx *imageEngine;
+    QRect deviceRect;
+    int tileHeight;
+    int tileCount;
+
+    QVector<QTiledPaintState> states;
+    QVector<QTiledPaintClip> clips;
+    QVector<QTiledPaintOperation> operations;
+    QVector<QTiledPaintText *> texts;
+    QVector<QTiledPaintPass> passes;
+    int operationState;
+    bool stateDirty;
+    bool usesPixmaps;
+
+    friend class QTiledImageRenderer;
+};
+
+QT_END_NAMESPACE
+
+#endif // QTILEDIMAGEPAINTDEVICE_P_H
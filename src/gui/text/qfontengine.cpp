@@ -40,6 +40,7 @@
 #include <qdebug.h>
 #include <private/qfontengine_p.h>
 #include <private/qfontengineglyphcache_p.h>
+#include <private/qtextshapingcache_p.h>
 #include <private/qguiapplication_p.h>
 
 #include <qpa/qplatformfontdatabase.h>
@@ -274,6 +275,7 @@ QFontEngine::~QFontEngine()
     if (enginesCollector)
         enginesCollector->removeOne(this);
 #endif
+    QTextShapingCache::fontEngineDestroyed(this);
 }
 
 QFixed QFontEngine::lineThickness() const
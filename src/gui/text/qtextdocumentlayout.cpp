@@ -461,6 +461,15 @@ public:
     mutable QBasicTimer sizeChangedTimer;
     uint showLayoutProgress : 1;
     uint insideDocumentChange : 1;
+    uint layoutOnDemand : 1;
+
+    // In layoutOnDemand mode, root frame blocks in
+    // [reusableLayoutStart, reusableLayoutEnd) only moved since they were
+    // last laid out, and pendingFlowEnd is where the root frame flow ends
+    // once everything after currentLazyLayoutPosition is laid out (or -1).
+    int reusableLayoutStart;
+    int reusableLayoutEnd;
+    QFixed pendingFlowEnd;
 
     int lastPageCount;
     qreal idealWidth;
@@ -525,6 +534,9 @@ public:
     { ensureLayoutedByPosition(INT_MAX); }
     void layoutStep() const;
 
+    void moveLayoutPositions(int from, int oldLength, int length);
+    QSizeF estimatedDocumentSize() const;
+
     QRectF frameBoundingRectInternal(QTextFrame *frame) const;
 
     qreal scaleToDevice(qreal value) const;
@@ -536,10 +548,14 @@ QTextDocumentLayoutPrivate::QTextDocumentLayoutPrivate()
       cursorWidth(1),
       currentLazyLayoutPosition(-1),
       lazyLayoutStepSize(1000),
+      reusableLayoutStart(-1),
+      reusableLayoutEnd(-1),
+      pendingFlowEnd(-1),
       lastPageCount(-1)
 {
     showLayoutProgress = true;
     insideDocumentChange = false;
+    layoutOnDemand = false;
     idealWidth = 0;
     contentHasAlignment = false;
 }
@@ -2247,6 +2263,11 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
 
     QTextFrame::Iterator previousIt;
 
+    // the check points after the change, with which we can tell when the
+    // rest of the flow is unaffected by it
+    QVector<QCheckPoint> oldCheckPoints;
+    int oldCheckPoint = 0;
+
     const bool inRootFrame = (it.parentFrame() == document->rootFrame());
     if (inRootFrame) {
         bool redoCheckPoints = layoutStruct->fullLayout || checkPoints.isEmpty();
@@ -2269,7 +2290,10 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
                 }
 
                 it = frameIteratorForTextPosition(checkPoint->positionInFrame);
-                checkPoints.resize(checkPoint - checkPoints.begin() + 1);
+                const int checkPointCount = checkPoint - checkPoints.begin() + 1;
+                if (layoutOnDemand && layoutStruct->pageHeight == QFIXED_MAX && fd->floats.isEmpty())
+                    oldCheckPoints = checkPoints.mid(checkPointCount);
+                checkPoints.resize(checkPointCount);
 
                 if (checkPoint != checkPoints.begin()) {
                     previousIt = it;
@@ -2281,6 +2305,8 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
         }
 
         if (redoCheckPoints) {
+            reusableLayoutStart = reusableLayoutEnd = -1;
+            pendingFlowEnd = -1;
             checkPoints.clear();
             QCheckPoint cp;
             cp.y = layoutStruct->y;
@@ -2296,6 +2322,7 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
     QTextBlockFormat previousBlockFormat = previousIt.currentBlock().blockFormat();
 
     QFixed maximumBlockWidth = 0;
+    int previousDocPos = -1;
     while (!it.atEnd()) {
         QTextFrame *c = it.currentFrame();
 
@@ -2305,6 +2332,48 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
         else
             docPos = it.currentBlock().position();
 
+        if (oldCheckPoint < oldCheckPoints.size()) {
+            while (oldCheckPoint < oldCheckPoints.size()
+                   && oldCheckPoints.at(oldCheckPoint).positionInFrame < docPos)
+                ++oldCheckPoint;
+
+            // Once the flow reaches an old check point after the changed
+            // range, everything that follows only moves by the same amount.
+            // Leave it to be laid out on demand, reusing the block layouts.
+            if (oldCheckPoint < oldCheckPoints.size()
+                && oldCheckPoints.at(oldCheckPoint).positionInFrame == docPos
+                && previousDocPos > layoutTo
+                && fd->floats.isEmpty()) {
+                const QFixed delta = layoutStruct->y - oldCheckPoints.at(oldCheckPoint).y;
+                if (currentLazyLayoutPosition == -1) {
+                    pendingFlowEnd = oldCheckPoints.constLast().y + delta;
+                    reusableLayoutEnd = docPrivate->length();
+                } else {
+                    if (pendingFlowEnd != -1)
+                        pendingFlowEnd += delta;
+                    if (reusableLayoutEnd == -1)
+                        reusableLayoutEnd = currentLazyLayoutPosition;
+                }
+                reusableLayoutStart = docPos;
+
+                if (delta != 0)
+                    layoutStruct->updateRect.setBottom(qreal(INT_MAX));
+
+                if (checkPoints.constLast().positionInFrame != docPos) {
+                    QCheckPoint p;
+                    p.y = layoutStruct->y;
+                    p.frameY = layoutStruct->frameY;
+                    p.positionInFrame = docPos;
+                    p.minimumWidth = layoutStruct->minimumWidth;
+                    p.maximumWidth = layoutStruct->maximumWidth;
+                    p.contentsWidth = layoutStruct->contentsWidth;
+                    checkPoints.append(p);
+                }
+                break;
+            }
+        }
+        previousDocPos = docPos;
+
         if (inRootFrame) {
             if (qAbs(layoutStruct->y - checkPoints.constLast().y) > 2000) {
                 QFixed left, right;
@@ -2547,6 +2616,8 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
         if (it.atEnd()) {
             //qDebug("layout done!");
             currentLazyLayoutPosition = -1;
+            reusableLayoutStart = reusableLayoutEnd = -1;
+            pendingFlowEnd = -1;
             QCheckPoint cp;
             cp.y = layoutStruct->y;
             cp.positionInFrame = docPrivate->length();
@@ -2623,8 +2694,15 @@ void QTextDocumentLayoutPrivate::layoutBlock(const QTextBlock &bl, int blockPosi
     const QPointF oldPosition = tl->position();
     tl->setPosition(QPointF(layoutStruct->x_left.toReal(), layoutStruct->y.toReal()));
 
+    // blocks that were only moved by an earlier change keep their lines
+    const bool reuseLines = reusableLayoutStart != -1
+            && blockPosition >= reusableLayoutStart
+            && blockPosition + blockLength <= reusableLayoutEnd
+            && layoutStruct->frame == document->rootFrame()
+            && tl->lineCount() > 0;
+
     if (layoutStruct->fullLayout
-        || (blockPosition + blockLength > layoutFrom && blockPosition <= layoutTo)
+        || (blockPosition + blockLength > layoutFrom && blockPosition <= layoutTo && !reuseLines)
         // force relayout if we cross a page boundary
         || (layoutStruct->pageHeight != QFIXED_MAX && layoutStruct->absoluteY() + QFixed::fromReal(tl->boundingRect().height()) > layoutStruct->pageBottom)) {
 
@@ -2954,23 +3032,32 @@ void QTextDocumentLayout::documentChanged(int from, int oldLength, int length)
     else
         d->showLayoutProgress = true;
 
+    if (d->layoutOnDemand && !fullLayout)
+        d->moveLayoutPositions(from, oldLength, length);
+
     if (fullLayout) {
         d->contentHasAlignment = false;
         d->currentLazyLayoutPosition = 0;
         d->checkPoints.clear();
         d->layoutStep();
+    } else if (d->layoutOnDemand && d->currentLazyLayoutPosition != -1
+               && from >= d->currentLazyLayoutPosition) {
+        // nothing to do until the changed part of the document is needed
+        d->pendingFlowEnd = -1;
+        const qreal laidOutHeight = data(d->docPrivate->rootFrame())->size.height.toReal();
+        updateRect = QRectF(QPointF(0, laidOutHeight), QSizeF(qreal(INT_MAX), qreal(INT_MAX)));
     } else {
         d->ensureLayoutedByPosition(from);
         updateRect = doLayout(from, oldLength, length);
     }
 
-    if (!d->layoutTimer.isActive() && d->currentLazyLayoutPosition != -1)
+    if (!d->layoutTimer.isActive() && d->currentLazyLayoutPosition != -1 && !d->layoutOnDemand)
         d->layoutTimer.start(10, this);
 
     d->insideDocumentChange = false;
 
     if (d->showLayoutProgress) {
-        const QSizeF newSize = dynamicDocumentSize();
+        const QSizeF newSize = d->layoutOnDemand ? d->estimatedDocumentSize() : dynamicDocumentSize();
         if (newSize != d->lastReportedSize) {
             d->lastReportedSize = newSize;
             emit documentSizeChanged(newSize);
@@ -3142,6 +3229,8 @@ int QTextDocumentLayout::pageCount() const
 QSizeF QTextDocumentLayout::documentSize() const
 {
     Q_D(const QTextDocumentLayout);
+    if (d->layoutOnDemand)
+        return d->estimatedDocumentSize();
     d->ensureLayoutFinished();
     return dynamicDocumentSize();
 }
@@ -3180,6 +3269,58 @@ void QTextDocumentLayoutPrivate::layoutStep() const
     lazyLayoutStepSize = qMin(200000, lazyLayoutStepSize * 2);
 }
 
+// Moves the positions we keep past the changed range of the document, so
+// that a relayout of that range can tell where the old layout continues.
+void QTextDocumentLayoutPrivate::moveLayoutPositions(int from, int oldLength, int length)
+{
+    const int oldEnd = from + oldLength;
+    const int delta = length - oldLength;
+
+    for (int i = 0; i < checkPoints.size(); ++i) {
+        int &position = checkPoints[i].positionInFrame;
+        if (position > from)
+            position = position >= oldEnd ? position + delta : from;
+    }
+
+    if (currentLazyLayoutPosition > from)
+        currentLazyLayoutPosition = currentLazyLayoutPosition >= oldEnd ? currentLazyLayoutPosition + delta : from;
+
+    if (reusableLayoutStart != -1) {
+        if (oldEnd < reusableLayoutStart) {
+            reusableLayoutStart += delta;
+            reusableLayoutEnd += delta;
+        } else if (from < reusableLayoutEnd) {
+            reusableLayoutEnd = from;
+        }
+        if (reusableLayoutEnd <= reusableLayoutStart)
+            reusableLayoutStart = reusableLayoutEnd = -1;
+    }
+}
+
+QSizeF QTextDocumentLayoutPrivate::estimatedDocumentSize() const
+{
+    const QTextFrameData *fd = data(document->rootFrame());
+    QSizeF size = fd->size.toSizeF();
+    if (currentLazyLayoutPosition == -1 || checkPoints.isEmpty())
+        return size;
+
+    const QFixed bottom = fd->border + fd->padding + fd->bottomMargin;
+    if (pendingFlowEnd != -1) {
+        size.setHeight((pendingFlowEnd + bottom).toReal());
+        return size;
+    }
+
+    // assume the blocks that are not laid out yet are as high as the others
+    const int laidOutBlocks = document->findBlock(currentLazyLayoutPosition).blockNumber();
+    if (laidOutBlocks > 0) {
+        const QFixed flowStart = checkPoints.constFirst().y;
+        const QFixed flowEnd = checkPoints.constLast().y;
+        const qreal blockHeight = (flowEnd - flowStart).toReal() / laidOutBlocks;
+        size.setHeight((flowEnd + bottom).toReal() + blockHeight * (document->blockCount() - laidOutBlocks));
+    }
+    return size;
+}
+
 void QTextDocumentLayout::setCursorWidth(int width)
 {
     Q_D(QTextDocumentLayout);
@@ -3192,6 +3333,28 @@ int QTextDocumentLayout::cursorWidth() const
     return d->cursorWidth;
 }
 
+void QTextDocumentLayout::setLayoutOnDemand(bool enable)
+{
+    Q_D(QTextDocumentLayout);
+    if (d->layoutOnDemand == enable)
+        return;
+    d->layoutOnDemand = enable;
+    if (enable) {
+        d->layoutTimer.stop();
+    } else {
+        d->reusableLayoutStart = d->reusableLayoutEnd = -1;
+        d->pendingFlowEnd = -1;
+        if (d->currentLazyLayoutPosition != -1)
+            d->layoutTimer.start(10, this);
+    }
+}
+
+bool QTextDocumentLayout::layoutOnDemand() const
+{
+    Q_D(const QTextDocumentLayout);
+    return d->layoutOnDemand;
+}
+
 void QTextDocumentLayout::setFixedColumnWidth(int width)
 {
     Q_D(QTextDocumentLayout);
@@ -3312,7 +3475,7 @@ void QTextDocumentLayout::timerEvent(QTimerEvent *e)
         if (d->currentLazyLayoutPosition != -1)
             d->layoutStep();
     } else if (e->timerId() == d->sizeChangedTimer.timerId()) {
-        d->lastReportedSize = dynamicDocumentSize();
+        d->lastReportedSize = d->layoutOnDemand ? d->estimatedDocumentSize() : dynamicDocumentSize();
         emit documentSizeChanged(d->lastReportedSize);
         d->sizeChangedTimer.stop();
 
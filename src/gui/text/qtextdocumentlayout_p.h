@@ -69,6 +69,7 @@ class Q_GUI_EXPORT QTextDocumentLayout : public QAbstractTextDocumentLayout
     Q_PROPERTY(int cursorWidth READ cursorWidth WRITE setCursorWidth)
     Q_PROPERTY(qreal idealWidth READ idealWidth)
     Q_PROPERTY(bool contentHasAlignment READ contentHasAlignment)
+    Q_PROPERTY(bool layoutOnDemand READ layoutOnDemand WRITE setLayoutOnDemand)
 public:
     explicit QTextDocumentLayout(QTextDocument *doc);
 
@@ -82,6 +83,10 @@ public:
     void setCursorWidth(int width);
     int cursorWidth() const;
 
+    // only lay out what is painted or queried, estimate the rest
+    void setLayoutOnDemand(bool enable);
+    bool layoutOnDemand() const;
+
     // internal, to support the ugly FixedColumnWidth wordwrap mode in QTextEdit
     void setFixedColumnWidth(int width);
 
@@ -53,6 +53,7 @@
 #include "qtextdocument_p.h"
 #include "qrawfont.h"
 #include "qrawfont_p.h"
+#include "qtextshapingcache_p.h"
 #include <qguiapplication.h>
 #include <qinputmethod.h>
 #include <algorithm>
@@ -958,6 +959,14 @@ void QTextEngine::shapeLine(const QScriptLine &line)
 
 #if QT_CONFIG(harfbuzz)
 extern bool qt_useHarfbuzzNG(); // defined in qfontengine.cpp
+
+template <typename T>
+static inline QVector<T> qt_vectorFromArray(const T *data, int size)
+{
+    QVector<T> vector(size);
+    memcpy(vector.data(), data, size * sizeof(T));
+    return vector;
+}
 #endif
 
 void QTextEngine::shapeText(int item) const
@@ -1033,74 +1042,136 @@ void QTextEngine::shapeText(int item) const
             letterSpacing *= font.d->dpi / qt_defaultDpiY();
     }
 
-    // split up the item into parts that come from different font engines
-    // k * 3 entries, array[k] == index in string, array[k + 1] == index in glyphs, array[k + 2] == engine index
-    QVector<uint> itemBoundaries;
-    itemBoundaries.reserve(24);
-
-    QGlyphLayout initialGlyphs = availableGlyphs(&si);
-    int nGlyphs = initialGlyphs.numGlyphs;
-    if (fontEngine->type() == QFontEngine::Multi || !shapingEnabled) {
-        // ask the font engine to find out which glyphs (as an index in the specific font)
-        // to use for the text in one item.
-        QFontEngine::ShaperFlags shaperFlags =
-                shapingEnabled
-                    ? QFontEngine::GlyphIndicesOnly
-                    : QFontEngine::ShaperFlag(0);
-        if (!fontEngine->stringToCMap(reinterpret_cast<const QChar *>(string), itemLength, &initialGlyphs, &nGlyphs, shaperFlags))
-            Q_UNREACHABLE();
-    }
-
-    if (fontEngine->type() == QFontEngine::Multi) {
-        uint lastEngine = ~0u;
-        for (int i = 0, glyph_pos = 0; i < itemLength; ++i, ++glyph_pos) {
-            const uint engineIdx = initialGlyphs.glyphs[glyph_pos] >> 24;
-            if (lastEngine != engineIdx) {
-                itemBoundaries.append(i);
-                itemBoundaries.append(glyph_pos);
-                itemBoundaries.append(engineIdx);
-
-                if (engineIdx != 0) {
-                    QFontEngine *actualFontEngine = static_cast<QFontEngineMulti *>(fontEngine)->engine(engineIdx);
-                    si.ascent = qMax(actualFontEngine->ascent(), si.ascent);
-                    si.descent = qMax(actualFontEngine->descent(), si.descent);
-                    si.leading = qMax(actualFontEngine->leading(), si.leading);
+#if QT_CONFIG(harfbuzz)
+    // The shaped glyphs only depend on the text, the font engine and a few flags,
+    // so reuse the result of an identical item shaped before by any layout.
+    QTextShapingCache *shapingCache = nullptr;
+    QTextShapingCacheKey shapingCacheKey;
+    if (Q_LIKELY(shapingEnabled && qt_useHarfbuzzNG())) {
+        shapingCache = QTextShapingCache::instance();
+        if (shapingCache && !shapingCache->isEnabled())
+            shapingCache = nullptr;
+    }
+    if (shapingCache) {
+        shapingCacheKey.text = QString::fromRawData(reinterpret_cast<const QChar *>(string), itemLength);
+        shapingCacheKey.fontEngine = fontEngine;
+        shapingCacheKey.script = si.analysis.script;
+        if (si.analysis.bidiLevel % 2)
+            shapingCacheKey.flags |= QTextShapingCacheKey::RightToLeft;
+        if (kerningEnabled)
+            shapingCacheKey.flags |= QTextShapingCacheKey::Kerning;
+        if (letterSpacing != 0)
+            shapingCacheKey.flags |= QTextShapingCacheKey::LetterSpacing;
+        if (option.useDesignMetrics())
+            shapingCacheKey.flags |= QTextShapingCacheKey::DesignMetrics;
+
+        QTextShapingCacheEntry cached;
+        if (shapingCache->find(shapingCacheKey, &cached)) {
+            const int numGlyphs = cached.glyphs.size();
+            if (Q_LIKELY(ensureSpace(numGlyphs))) {
+                QGlyphLayout g = availableGlyphs(&si);
+                memcpy(g.glyphs, cached.glyphs.constData(), numGlyphs * sizeof(glyph_t));
+                memcpy(g.advances, cached.advances.constData(), numGlyphs * sizeof(QFixed));
+                memcpy(g.offsets, cached.offsets.constData(), numGlyphs * sizeof(QFixedPoint));
+                memcpy(g.attributes, cached.attributes.constData(), numGlyphs * sizeof(QGlyphAttributes));
+                memcpy(logClusters(&si), cached.logClusters.constData(), itemLength * sizeof(ushort));
+                si.ascent = cached.ascent;
+                si.descent = cached.descent;
+                si.leading = cached.leading;
+                si.num_glyphs = numGlyphs;
+            }
+        }
+    }
+#endif
+
+    if (!si.num_glyphs) {
+        // split up the item into parts that come from different font engines
+        // k * 3 entries, array[k] == index in string, array[k + 1] == index in glyphs, array[k + 2] == engine index
+        QVector<uint> itemBoundaries;
+        itemBoundaries.reserve(24);
+
+        QGlyphLayout initialGlyphs = availableGlyphs(&si);
+        int nGlyphs = initialGlyphs.numGlyphs;
+        if (fontEngine->type() == QFontEngine::Multi || !shapingEnabled) {
+            // ask the font engine to find out which glyphs (as an index in the specific font)
+            // to use for the text in one item.
+            QFontEngine::ShaperFlags shaperFlags =
+                    shapingEnabled
+                        ? QFontEngine::GlyphIndicesOnly
+                        : QFontEngine::ShaperFlag(0);
+            if (!fontEngine->stringToCMap(reinterpret_cast<const QChar *>(string), itemLength, &initialGlyphs, &nGlyphs, shaperFlags))
+                Q_UNREACHABLE();
+        }
+
+        if (fontEngine->type() == QFontEngine::Multi) {
+            uint lastEngine = ~0u;
+            for (int i = 0, glyph_pos = 0; i < itemLength; ++i, ++glyph_pos) {
+                const uint engineIdx = initialGlyphs.glyphs[glyph_pos] >> 24;
+                if (lastEngine != engineIdx) {
+                    itemBoundaries.append(i);
+                    itemBoundaries.append(glyph_pos);
+                    itemBoundaries.append(engineIdx);
+
+                    if (engineIdx != 0) {
+                        QFontEngine *actualFontEngine = static_cast<QFontEngineMulti *>(fontEngine)->engine(engineIdx);
+                        si.ascent = qMax(actualFontEngine->ascent(), si.ascent);
+                        si.descent = qMax(actualFontEngine->descent(), si.descent);
+                        si.leading = qMax(actualFontEngine->leading(), si.leading);
+                    }
+
+                    lastEngine = engineIdx;
                 }
 
-                lastEngine = engineIdx;
+                if (QChar::isHighSurrogate(string[i]) && i + 1 < itemLength && QChar::isLowSurrogate(string[i + 1]))
+                    ++i;
             }
-
-            if (QChar::isHighSurrogate(string[i]) && i + 1 < itemLength && QChar::isLowSurrogate(string[i + 1]))
-                ++i;
+        } else {
+            itemBoundaries.append(0);
+            itemBoundaries.append(0);
+            itemBoundaries.append(0);
         }
-    } else {
-        itemBoundaries.append(0);
-        itemBoundaries.append(0);
-        itemBoundaries.append(0);
-    }
-
-    if (Q_UNLIKELY(!shapingEnabled)) {
-        ushort *log_clusters = logClusters(&si);
-
-        int glyph_pos = 0;
-        for (int i = 0; i < itemLength; ++i, ++glyph_pos) {
-            log_clusters[i] = glyph_pos;
-            initialGlyphs.attributes[glyph_pos].clusterStart = true;
-            if (QChar::isHighSurrogate(string[i])
-                    && i + 1 < itemLength
-                    && QChar::isLowSurrogate(string[i + 1])) {
-                ++i;
+
+        if (Q_UNLIKELY(!shapingEnabled)) {
+            ushort *log_clusters = logClusters(&si);
+
+            int glyph_pos = 0;
+            for (int i = 0; i < itemLength; ++i, ++glyph_pos) {
                 log_clusters[i] = glyph_pos;
+                initialGlyphs.attributes[glyph_pos].clusterStart = true;
+                if (QChar::isHighSurrogate(string[i])
+                        && i + 1 < itemLength
+                        && QChar::isLowSurrogate(string[i + 1])) {
+                    ++i;
+                    log_clusters[i] = glyph_pos;
+                }
             }
+
+            si.num_glyphs = glyph_pos;
+#if QT_CONFIG(harfbuzz)
+        } else if (Q_LIKELY(qt_useHarfbuzzNG())) {
+            si.num_glyphs = shapeTextWithHarfbuzzNG(si, string, itemLength, fontEngine, itemBoundaries, kerningEnabled, letterSpacing != 0);
+#endif
+        } else {
+            si.num_glyphs = shapeTextWithHarfbuzz(si, string, itemLength, fontEngine, itemBoundaries, kerningEnabled);
         }
 
-        si.num_glyphs = glyph_pos;
 #if QT_CONFIG(harfbuzz)
-    } else if (Q_LIKELY(qt_useHarfbuzzNG())) {
-        si.num_glyphs = shapeTextWithHarfbuzzNG(si, string, itemLength, fontEngine, itemBoundaries, kerningEnabled, letterSpacing != 0);
+        if (shapingCache && si.num_glyphs) {
+            const QGlyphLayout g = availableGlyphs(&si).mid(0, si.num_glyphs);
+            const ushort *log_clusters = logClusters(&si);
+
+            QTextShapingCacheEntry entry;
+            entry.glyphs = qt_vectorFromArray(g.glyphs, g.numGlyphs);
+            entry.advances = qt_vectorFromArray(g.advances, g.numGlyphs);
+            entry.offsets = qt_vectorFromArray(g.offsets, g.numGlyphs);
+            entry.attributes = qt_vectorFromArray(g.attributes, g.numGlyphs);
+            entry.logClusters = qt_vectorFromArray(log_clusters, itemLength);
+            entry.ascent = si.ascent;
+            entry.descent = si.descent;
+            entry.leading = si.leading;
+            shapingCache->insert(shapingCacheKey, entry);
+        }
 #endif
-    } else {
-        si.num_glyphs = shapeTextWithHarfbuzz(si, string, itemLength, fontEngine, itemBoundaries, kerningEnabled);
     }
     if (Q_UNLIKELY(si.num_glyphs == 0)) {
         Q_UNREACHABLE(); // ### report shaping errors somehow
@@ -0,0 +1,235 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qtextshapingcache_p.h"
+
+#include <QtCore/qglobal.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+    \class QTextShapingCache
+    \since 5.11
+
+    \brief The QTextShapingCache class caches shaped glyph runs across text layouts.
+
+    QTextEngine::shapeText() looks up every item it is about to shape with
+    HarfBuzz in this cache. The key consists of the item text after case
+    mapping, the font engine, the script, the direction and the flags that
+    influence shaping (kerning, letter spacing and design metrics). The value
+    holds everything shaping writes into the layout: the glyph indices,
+    advances, offsets and attributes, the log clusters and the metrics of any
+    fallback engines used by a multi font engine.
+
+    There is one cache per process, shared by all threads. It is bounded by
+    the number of bytes its entries occupy and discards the least recently
+    used entries first. The default limit is 2 MB and can be changed with the
+    \c QT_TEXT_SHAPING_CACHE_SIZE environment variable, given in kilobytes;
+    a value of 0 disables the cache.
+
+    Entries refer to font engines by address only, so QFontEngine's destructor
+    calls fontEngineDestroyed() to drop the entries of the engine before the
+    address can be reused.
+*/
+
+static const int defaultShapingCacheSize = 2 * 1024 * 1024;
+
+Q_GLOBAL_STATIC(QTextShapingCache, theShapingCache)
+
+static int shapingCacheCost(const QTextShapingCacheKey &key, const QTextShapingCacheEntry &entry)
+{
+    return int(sizeof(QTextShapingCacheKey) + sizeof(QTextShapingCacheEntry))
+            + key.text.size() * int(sizeof(QChar))
+            + entry.glyphs.size() * int(QGlyphLayout::SpaceNeeded)
+            + entry.logClusters.size() * int(sizeof(ushort));
+}
+
+QTextShapingCache::QTextShapingCache()
+    : m_cache(defaultShapingCacheSize)
+    , m_hits(0)
+    , m_misses(0)
+{
+    bool ok = false;
+    const int size = qEnvironmentVariableIntValue("QT_TEXT_SHAPING_CACHE_SIZE", &ok);
+    if (ok)
+        m_cache.setMaxCost(qMax(0, size) * 1024);
+    m_enabled.store(m_cache.maxCost() > 0);
+}
+
+QTextShapingCache::~QTextShapingCache()
+{
+    // the nodes update m_fontEngines when they are deleted
+    m_cache.clear();
+}
+
+QTextShapingCache::Node::Node(QTextShapingCache *cache, QFontEngine *fontEngine,
+                              const QTextShapingCacheEntry &entry)
+    : entry(entry), cache(cache), fontEngine(fontEngine)
+{
+    ++cache->m_fontEngines[fontEngine];
+}
+
+// Called with the mutex held, whether QCache evicts the node, replaces it or
+// the entry is removed explicitly
+QTextShapingCache::Node::~Node()
+{
+    const auto it = cache->m_fontEngines.find(fontEngine);
+    if (--it.value() == 0)
+        cache->m_fontEngines.erase(it);
+}
+
+/*!
+    Returns the process-wide cache, or \nullptr while the application is
+    shutting down.
+*/
+QTextShapingCache *QTextShapingCache::instance()
+{
+    return theShapingCache();
+}
+
+/*!
+    Drops the cached results of \a fontEngine. Unlike removeFontEngine(), this
+    does not create the cache if it does not exist yet.
+*/
+void QTextShapingCache::fontEngineDestroyed(QFontEngine *fontEngine)
+{
+    if (theShapingCache.exists() && !theShapingCache.isDestroyed())
+        theShapingCache()->removeFontEngine(fontEngine);
+}
+
+/*!
+    Looks up \a key and, if present, stores the cached result in \a entry and
+    marks it as the most recently used one. The entry data is implicitly
+    shared, so this is cheap. Returns \c true on a cache hit.
+*/
+bool QTextShapingCache::find(const QTextShapingCacheKey &key, QTextShapingCacheEntry *entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (const Node *cached = m_cache.object(key)) {
+        *entry = cached->entry;
+        ++m_hits;
+        return true;
+    }
+    ++m_misses;
+    return false;
+}
+
+/*!
+    Stores \a entry for \a key, evicting the least recently used entries when
+    the cache would exceed its maximum cost. Results larger than the whole
+    cache are not stored.
+*/
+void QTextShapingCache::insert(const QTextShapingCacheKey &key, const QTextShapingCacheEntry &entry)
+{
+    const int cost = shapingCacheCost(key, entry);
+
+    QMutexLocker locker(&m_mutex);
+    if (cost > m_cache.maxCost())
+        return;
+
+    QTextShapingCacheKey storedKey = key;
+    storedKey.text = QString(key.text.constData(), key.text.size());
+    m_cache.insert(storedKey, new Node(this, key.fontEngine, entry), cost);
+}
+
+/*!
+    Removes all entries that were shaped with \a fontEngine.
+*/
+void QTextShapingCache::removeFontEngine(QFontEngine *fontEngine)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_fontEngines.contains(fontEngine))
+        return;
+
+    const QList<QTextShapingCacheKey> keys = m_cache.keys();
+    for (const QTextShapingCacheKey &key : keys) {
+        if (key.fontEngine == fontEngine)
+            m_cache.remove(key);
+    }
+}
+
+void QTextShapingCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+/*!
+    Sets the maximum total size of the cached entries to \a maxCost bytes.
+    A value of 0 disables the cache.
+*/
+void QTextShapingCache::setMaxCost(int maxCost)
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.setMaxCost(qMax(0, maxCost));
+    m_enabled.store(maxCost > 0);
+}
+
+int QTextShapingCache::maxCost() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.maxCost();
+}
+
+/*!
+    Returns the number of hits and misses since the last call to
+    resetStatistics(), along with the current fill state of the cache.
+*/
+QTextShapingCache::Statistics QTextShapingCache::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+    Statistics stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.count = m_cache.count();
+    stats.fontEngineCount = m_fontEngines.size();
+    stats.totalCost = m_cache.totalCost();
+    stats.maxCost = m_cache.maxCost();
+    return stats;
+}
+
+void QTextShapingCache::resetStatistics()
+{
+    QMutexLocker locker(&m_mutex);
+    m_hits = 0;
+    m_misses = 0;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,171 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QTEXTSHAPINGCACHE_P_H
+#define QTEXTSHAPINGCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtGui/private/qtguiglobal_p.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+#include "private/qtextengine_p.h"
+
+QT_BEGIN_NAMESPACE
+
+class QFontEngine;
+
+struct QTextShapingCacheKey
+{
+    QTextShapingCacheKey() : fontEngine(nullptr), script(0), flags(0) {}
+
+    enum Flag {
+        RightToLeft = 0x1,
+        Kerning = 0x2,
+        LetterSpacing = 0x4,
+        DesignMetrics = 0x8
+    };
+
+    // For lookups, text may be created with QString::fromRawData();
+    // QTextShapingCache::insert() always stores a deep copy.
+    QString text;
+    QFontEngine *fontEngine;
+    ushort script;
+    ushort flags;
+};
+
+inline bool operator==(const QTextShapingCacheKey &k1, const QTextShapingCacheKey &k2)
+{
+    return k1.fontEngine == k2.fontEngine
+        && k1.script == k2.script
+        && k1.flags == k2.flags
+        && k1.text == k2.text;
+}
+
+inline uint qHash(const QTextShapingCacheKey &key, uint seed = 0) Q_DECL_NOTHROW
+{
+    QtPrivate::QHashCombine hash;
+    seed = hash(seed, key.text);
+    seed = hash(seed, key.fontEngine);
+    seed = hash(seed, (uint(key.script) << 16) | key.flags);
+    return seed;
+}
+
+struct QTextShapingCacheEntry
+{
+    QVector<glyph_t> glyphs;
+    QVector<QFixed> advances;
+    QVector<QFixedPoint> offsets;
+    QVector<QGlyphAttributes> attributes;
+    QVector<ushort> logClusters;
+    QFixed ascent;
+    QFixed descent;
+    QFixed leading;
+};
+
+class Q_GUI_EXPORT QTextShapingCache
+{
+public:
+    struct Statistics
+    {
+        quint64 hits;
+        quint64 misses;
+        int count;
+        int fontEngineCount;
+        int totalCost;
+        int maxCost;
+    };
+
+    QTextShapingCache();
+    ~QTextShapingCache();
+
+    static QTextShapingCache *instance();
+    static void fontEngineDestroyed(QFontEngine *fontEngine);
+
+    bool isEnabled() const { return m_enabled.load(); }
+
+    bool find(const QTextShapingCacheKey &key, QTextShapingCacheEntry *entry);
+    void insert(const QTextShapingCacheKey &key, const QTextShapingCacheEntry &entry);
+    void removeFontEngine(QFontEngine *fontEngine);
+    void clear();
+
+    void setMaxCost(int maxCost);
+    int maxCost() const;
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    Q_DISABLE_COPY(QTextShapingCache)
+
+    // Counts the entries of its font engine for as long as QCache keeps it
+    struct Node
+    {
+        Node(QTextShapingCache *cache, QFontEngine *fontEngine, const QTextShapingCacheEntry &entry);
+        ~Node();
+
+        QTextShapingCacheEntry entry;
+        QTextShapingCache *cache;
+        QFontEngine *fontEngine;
+    };
+
+    mutable QMutex m_mutex;
+    QCache<QTextShapingCacheKey, Node> m_cache;
+    // number of cached entries per font engine
+    QHash<QFontEngine *, int> m_fontEngines;
+    QAtomicInt m_enabled;
+    quint64 m_hits;
+    quint64 m_misses;
+};
+
+QT_END_NAMESPACE
+
+#endif // QTEXTSHAPINGCACHE_P_H
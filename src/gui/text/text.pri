@@ -10,6 +10,7 @@ HEADERS += \
     text/qfont_p.h \
     text/qfontsubset_p.h \
     text/qtextengine_p.h \
+    text/qtextshapingcache_p.h \
     text/qtextlayout.h \
     text/qtextformat.h \
     text/qtextformat_p.h \
@@ -50,6 +51,7 @@ SOURCES += \
     text/qfontmetrics.cpp \
     text/qfontdatabase.cpp \
     text/qtextengine.cpp \
+    text/qtextshapingcache.cpp \
     text/qtextlayout.cpp \
     text/qtextformat.cpp \
     text/qtextobject.cpp \
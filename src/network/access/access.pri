@@ -2,6 +2,7 @@
 
 HEADERS += \
     access/qhttpnetworkheader_p.h \
+    access/qhttpcontentdecoder_p.h \
     access/qhttpnetworkrequest_p.h \
     access/qhttpnetworkreply_p.h \
     access/qhttpnetworkconnection_p.h \
@@ -42,6 +43,7 @@ HEADERS += \
 
 SOURCES += \
     access/qhttpnetworkheader.cpp \
+    access/qhttpcontentdecoder.cpp \
     access/qhttpnetworkrequest.cpp \
     access/qhttpnetworkreply.cpp \
     access/qhttpnetworkconnection.cpp \
@@ -93,5 +95,8 @@ qtConfig(networkdiskcache) {
 
 mac: LIBS_PRIVATE += -framework Security
 
+qtConfig(brotli): QMAKE_USE_PRIVATE += brotli
+qtConfig(zstd): QMAKE_USE_PRIVATE += zstd
+
 include($$PWD/../../3rdparty/zlib_dependency.pri)
 include($$PWD/http2/http2.pri)
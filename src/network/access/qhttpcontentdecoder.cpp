@@ -0,0 +1,318 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qhttpcontentdecoder_p.h"
+
+#include <private/qbytedata_p.h>
+
+#ifndef QT_NO_COMPRESS
+#include <zlib.h>
+#endif
+#if QT_CONFIG(brotli)
+#include <brotli/decode.h>
+#endif
+#if QT_CONFIG(zstd)
+#include <zstd.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+QHttpContentDecoder::~QHttpContentDecoder()
+{
+}
+
+namespace {
+
+#ifndef QT_NO_COMPRESS
+class QZlibDecoder : public QHttpContentDecoder
+{
+public:
+    QZlibDecoder()
+        : initialized(false), triedRawDeflate(false), finished(false)
+    {
+        memset(&inflateStrm, 0, sizeof(inflateStrm));
+        // "windowBits can also be greater than 15 for optional gzip decoding.
+        // Add 32 to windowBits to enable zlib and gzip decoding with automatic header detection"
+        // http://www.zlib.net/manual.html
+        initialized = (inflateInit2(&inflateStrm, MAX_WBITS + 32) == Z_OK);
+    }
+
+    ~QZlibDecoder()
+    {
+        if (initialized)
+            inflateEnd(&inflateStrm);
+    }
+
+    bool decode(const char *data, qint64 size, QByteDataBuffer *out) Q_DECL_OVERRIDE
+    {
+        if (!initialized)
+            return false;
+
+        // input bytes will not be changed by zlib, so it is safe to const_cast here
+        inflateStrm.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        inflateStrm.avail_in = uInt(size);
+
+        char buffer[OutputChunkSize];
+        while (!finished && (inflateStrm.avail_in > 0 || inflateStrm.avail_out == 0)) {
+            inflateStrm.next_out = reinterpret_cast<Bytef *>(buffer);
+            inflateStrm.avail_out = sizeof(buffer);
+
+            int ret = inflate(&inflateStrm, Z_NO_FLUSH);
+            // in the case where we get Z_DATA_ERROR this could be because we received raw deflate compressed data.
+            if (ret == Z_DATA_ERROR && !triedRawDeflate && inflateStrm.total_out == 0) {
+                inflateEnd(&inflateStrm);
+                triedRawDeflate = true;
+                memset(&inflateStrm, 0, sizeof(inflateStrm));
+                initialized = (inflateInit2(&inflateStrm, -MAX_WBITS) == Z_OK);
+                if (!initialized)
+                    return false;
+                inflateStrm.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+                inflateStrm.avail_in = uInt(size);
+                continue;
+            }
+            if (ret == Z_BUF_ERROR && inflateStrm.avail_in == 0)
+                break; // the output buffer was filled exactly; wait for more input
+            // All negative return codes are errors, in the context of HTTP compression, Z_NEED_DICT is also an error.
+            if (ret < 0 || ret == Z_NEED_DICT)
+                return false;
+
+            const int produced = int(sizeof(buffer) - inflateStrm.avail_out);
+            if (produced > 0)
+                out->append(QByteArray(buffer, produced));
+            if (ret == Z_STREAM_END)
+                finished = true;
+        }
+        return true;
+    }
+
+private:
+    z_stream inflateStrm;
+    bool initialized;
+    bool triedRawDeflate;
+    bool finished;
+};
+#endif // QT_NO_COMPRESS
+
+#if QT_CONFIG(brotli)
+class QBrotliDecoder : public QHttpContentDecoder
+{
+public:
+    QBrotliDecoder()
+        : state(BrotliDecoderCreateInstance(nullptr, nullptr, nullptr)), finished(false)
+    {
+    }
+
+    ~QBrotliDecoder()
+    {
+        if (state)
+            BrotliDecoderDestroyInstance(state);
+    }
+
+    bool decode(const char *data, qint64 size, QByteDataBuffer *out) Q_DECL_OVERRIDE
+    {
+        if (!state)
+            return false;
+
+        const uint8_t *nextIn = reinterpret_cast<const uint8_t *>(data);
+        size_t availIn = size_t(size);
+
+        char buffer[OutputChunkSize];
+        while (!finished) {
+            uint8_t *nextOut = reinterpret_cast<uint8_t *>(buffer);
+            size_t availOut = sizeof(buffer);
+
+            const BrotliDecoderResult result =
+                    BrotliDecoderDecompressStream(state, &availIn, &nextIn, &availOut, &nextOut, nullptr);
+            if (result == BROTLI_DECODER_RESULT_ERROR)
+                return false;
+
+            const int produced = int(sizeof(buffer) - availOut);
+            if (produced > 0)
+                out->append(QByteArray(buffer, produced));
+
+            if (result == BROTLI_DECODER_RESULT_SUCCESS)
+                finished = true;
+            else if (result == BROTLI_DECODER_RESULT_NEEDS_MORE_INPUT)
+                break;
+            // BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT: go around again
+        }
+        return true;
+    }
+
+private:
+    BrotliDecoderState *state;
+    bool finished;
+};
+#endif // QT_CONFIG(brotli)
+
+#if QT_CONFIG(zstd)
+class QZstdDecoder : public QHttpContentDecoder
+{
+public:
+    // RFC 8878 limits the window of zstd content-coding to 8 MB; refusing
+    // larger windows keeps the decoder's memory use bounded.
+    enum { MaxWindowLog = 23 };
+
+    QZstdDecoder()
+        : context(ZSTD_createDCtx())
+    {
+        if (context && ZSTD_isError(ZSTD_DCtx_setParameter(context, ZSTD_d_windowLogMax, MaxWindowLog))) {
+            ZSTD_freeDCtx(context);
+            context = nullptr;
+        }
+    }
+
+    ~QZstdDecoder()
+    {
+        if (context)
+            ZSTD_freeDCtx(context);
+    }
+
+    bool decode(const char *data, qint64 size, QByteDataBuffer *out) Q_DECL_OVERRIDE
+    {
+        if (!context)
+            return false;
+
+        ZSTD_inBuffer input = { data, size_t(size), 0 };
+
+        char buffer[OutputChunkSize];
+        forever {
+            ZSTD_outBuffer output = { buffer, sizeof(buffer), 0 };
+            const size_t ret = ZSTD_decompressStream(context, &output, &input);
+            if (ZSTD_isError(ret))
+                return false;
+
+            if (output.pos > 0)
+                out->append(QByteArray(buffer, int(output.pos)));
+
+            // a partially filled output buffer means everything that could
+            // be decoded from the input so far has been flushed
+            if (input.pos == input.size && output.pos < output.size)
+                break;
+        }
+        return true;
+    }
+
+private:
+    ZSTD_DCtx *context;
+};
+#endif // QT_CONFIG(zstd)
+
+typedef QHttpContentDecoder *(*DecoderFactory)();
+
+template <typename Decoder>
+QHttpContentDecoder *createDecoder()
+{
+    return new Decoder;
+}
+
+struct DecoderEntry
+{
+    const char *encoding;
+    DecoderFactory create;
+};
+
+// The supported content-codings, in the order they are advertised in
+// Accept-Encoding. Further decoders are added here.
+const DecoderEntry decoders[] = {
+#ifndef QT_NO_COMPRESS
+    { "gzip", createDecoder<QZlibDecoder> },
+    { "deflate", createDecoder<QZlibDecoder> },
+#endif
+#if QT_CONFIG(brotli)
+    { "br", createDecoder<QBrotliDecoder> },
+#endif
+#if QT_CONFIG(zstd)
+    { "zstd", createDecoder<QZstdDecoder> },
+#endif
+    { nullptr, nullptr }
+};
+
+const DecoderEntry *findDecoder(const QByteArray &encoding)
+{
+    const QByteArray trimmed = encoding.trimmed();
+    for (const DecoderEntry *entry = decoders; entry->encoding; ++entry) {
+        if (qstricmp(trimmed.constData(), entry->encoding) == 0)
+            return entry;
+    }
+    return nullptr;
+}
+
+} // unnamed namespace
+
+/*!
+    \internal
+
+    Returns a new decoder for the content-coding \a encoding, or
+    \nullptr if it is not supported. The caller takes ownership.
+*/
+QHttpContentDecoder *QHttpContentDecoder::create(const QByteArray &encoding)
+{
+    const DecoderEntry *entry = findDecoder(encoding);
+    return entry ? entry->create() : nullptr;
+}
+
+/*!
+    \internal
+
+    Returns \c true if create() can make a decoder for \a encoding.
+*/
+bool QHttpContentDecoder::isSupported(const QByteArray &encoding)
+{
+    return findDecoder(encoding) != nullptr;
+}
+
+/*!
+    \internal
+
+    Returns the value to send in the Accept-Encoding header: all supported
+    content-codings, or an empty byte array if there are none.
+*/
+QByteArray QHttpContentDecoder::acceptEncoding()
+{
+    QByteArray value;
+    for (const DecoderEntry *entry = decoders; entry->encoding; ++entry) {
+        if (!value.isEmpty())
+            value += ", ";
+        value += entry->encoding;
+    }
+    return value;
+}
+
+QT_END_NAMESPACE
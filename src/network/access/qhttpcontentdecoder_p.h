@@ -0,0 +1,88 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QHTTPCONTENTDECODER_P_H
+#define QHTTPCONTENTDECODER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+
+#include <QtCore/qbytearray.h>
+
+QT_BEGIN_NAMESPACE
+
+class QByteDataBuffer;
+
+// Streaming decoder for one HTTP Content-Encoding. Input may be fed in
+// arbitrarily sized pieces; output is produced in chunks of bounded size.
+class Q_AUTOTEST_EXPORT QHttpContentDecoder
+{
+public:
+    virtual ~QHttpContentDecoder();
+
+    // Appends the decoded form of \a data to \a out. Returns false if the
+    // input is not valid for this encoding; the decoder is unusable then.
+    virtual bool decode(const char *data, qint64 size, QByteDataBuffer *out) = 0;
+
+    static QHttpContentDecoder *create(const QByteArray &encoding);
+    static bool isSupported(const QByteArray &encoding);
+    static QByteArray acceptEncoding();
+
+protected:
+    QHttpContentDecoder() {}
+
+    enum { OutputChunkSize = 16 * 1024 };
+
+private:
+    Q_DISABLE_COPY(QHttpContentDecoder)
+};
+
+QT_END_NAMESPACE
+
+#endif // QHTTPCONTENTDECODER_P_H
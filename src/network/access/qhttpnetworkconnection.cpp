@@ -298,19 +298,20 @@ void QHttpNetworkConnectionPrivate::prepareRequest(HttpMessagePair &messagePair)
 #endif
 
     // If the request had a accept-encoding set, we better not mess
-    // with it. If it was not set, we announce that we understand gzip
-    // and remember this fact in request.d->autoDecompress so that
-    // we can later decompress the HTTP reply if it has such an
-    // encoding.
+    // with it. If it was not set, we announce the encodings we have
+    // decoders for (gzip, and brotli or zstd if built in) and remember
+    // this fact in request.d->autoDecompress so that we can later
+    // decompress the HTTP reply if it has such an encoding.
     value = request.headerField("accept-encoding");
     if (value.isEmpty()) {
-#ifndef QT_NO_COMPRESS
-        request.setHeaderField("Accept-Encoding", "gzip, deflate");
-        request.d->autoDecompress = true;
-#else
-        // if zlib is not available set this to false always
-        request.d->autoDecompress = false;
-#endif
+        static const QByteArray acceptEncoding = QHttpContentDecoder::acceptEncoding();
+        if (!acceptEncoding.isEmpty()) {
+            request.setHeaderField("Accept-Encoding", acceptEncoding);
+            request.d->autoDecompress = true;
+        } else {
+            // no decoders available, set this to false always
+            request.d->autoDecompress = false;
+        }
     }
 
     // some websites mandate an accept-language header and fail
@@ -57,10 +57,6 @@
 
 #include <qplatformdefs.h>
 
-#ifndef QT_NO_COMPRESS
-struct z_stream_s;
-#endif
-
 #include <QtNetwork/qtcpsocket.h>
 // it's safe to include these even if SSL support is not enabled
 #include <QtNetwork/qsslsocket.h>
@@ -76,6 +72,7 @@ struct z_stream_s;
 #include <private/qauthenticator_p.h>
 #include <private/qringbuffer_p.h>
 #include <private/qbytedata_p.h>
+#include <private/qhttpcontentdecoder_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -273,11 +270,9 @@ public:
     char* userProvidedDownloadBuffer;
     QUrl redirectUrl;
 
-#ifndef QT_NO_COMPRESS
-    z_stream_s *inflateStrm;
-    int initializeInflateStream();
+    QScopedPointer<QHttpContentDecoder> decoder;
+    bool initializeDecoder();
     qint64 uncompressBodyData(QByteDataBuffer *in, QByteDataBuffer *out);
-#endif
 };
 
 
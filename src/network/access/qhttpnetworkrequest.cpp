@@ -39,6 +39,7 @@
 
 #include "qhttpnetworkrequest_p.h"
 #include "private/qnoncontiguousbytedevice_p.h"
+#include <qfile.h>
 
 #ifndef QT_NO_HTTP
 
@@ -47,7 +48,7 @@ QT_BEGIN_NAMESPACE
 QHttpNetworkRequestPrivate::QHttpNetworkRequestPrivate(QHttpNetworkRequest::Operation op,
         QHttpNetworkRequest::Priority pri, const QUrl &newUrl)
     : QHttpNetworkHeaderPrivate(newUrl), operation(op), priority(pri), uploadByteDevice(0),
-      autoDecompress(false), pipeliningAllowed(false), spdyAllowed(false), http2Allowed(false),
+      uploadFileOffset(0), autoDecompress(false), pipeliningAllowed(false), spdyAllowed(false), http2Allowed(false),
       withCredentials(true), preConnect(false), redirectCount(0),
       redirectPolicy(QNetworkRequest::ManualRedirectPolicy)
 {
@@ -59,6 +60,8 @@ QHttpNetworkRequestPrivate::QHttpNetworkRequestPrivate(const QHttpNetworkRequest
       customVerb(other.customVerb),
       priority(other.priority),
       uploadByteDevice(other.uploadByteDevice),
+      uploadFile(other.uploadFile),
+      uploadFileOffset(other.uploadFileOffset),
       autoDecompress(other.autoDecompress),
       pipeliningAllowed(other.pipeliningAllowed),
       spdyAllowed(other.spdyAllowed),
@@ -81,6 +84,8 @@ bool QHttpNetworkRequestPrivate::operator==(const QHttpNetworkRequestPrivate &ot
         && (operation == other.operation)
         && (priority == other.priority)
         && (uploadByteDevice == other.uploadByteDevice)
+        && (uploadFile == other.uploadFile)
+        && (uploadFileOffset == other.uploadFileOffset)
         && (autoDecompress == other.autoDecompress)
         && (pipeliningAllowed == other.pipeliningAllowed)
         && (spdyAllowed == other.spdyAllowed)
@@ -375,6 +380,22 @@ QNonContiguousByteDevice* QHttpNetworkRequest::uploadByteDevice() const
     return d->uploadByteDevice;
 }
 
+void QHttpNetworkRequest::setUploadFile(const QSharedPointer<QFile> &file, qint64 offset)
+{
+    d->uploadFile = file;
+    d->uploadFileOffset = offset;
+}
+
+QSharedPointer<QFile> QHttpNetworkRequest::uploadFile() const
+{
+    return d->uploadFile;
+}
+
+qint64 QHttpNetworkRequest::uploadFileOffset() const
+{
+    return d->uploadFileOffset;
+}
+
 int QHttpNetworkRequest::majorVersion() const
 {
     return 1;
@@ -57,10 +57,12 @@
 #include <private/qhttpnetworkheader_p.h>
 #include <QtNetwork/qnetworkrequest.h>
 #include <qmetatype.h>
+#include <qsharedpointer.h>
 
 QT_BEGIN_NAMESPACE
 
 class QNonContiguousByteDevice;
+class QFile;
 
 class QHttpNetworkRequestPrivate;
 class Q_AUTOTEST_EXPORT QHttpNetworkRequest: public QHttpNetworkHeader
@@ -141,6 +143,12 @@ public:
     void setUploadByteDevice(QNonContiguousByteDevice *bd);
     QNonContiguousByteDevice* uploadByteDevice() const;
 
+    // optional: lets QHttpProtocolHandler send the upload data straight from
+    // the file; uploadByteDevice() is still needed and is kept in step with it
+    void setUploadFile(const QSharedPointer<QFile> &file, qint64 offset);
+    QSharedPointer<QFile> uploadFile() const;
+    qint64 uploadFileOffset() const;
+
     QByteArray methodName() const;
     QByteArray uri(bool throughProxy) const;
 
@@ -169,6 +177,8 @@ public:
     QByteArray customVerb;
     QHttpNetworkRequest::Priority priority;
     mutable QNonContiguousByteDevice* uploadByteDevice;
+    QSharedPointer<QFile> uploadFile;
+    qint64 uploadFileOffset;
     bool autoDecompress;
     bool pipeliningAllowed;
     bool spdyAllowed;
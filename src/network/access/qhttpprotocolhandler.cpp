@@ -42,6 +42,19 @@
 #include <private/qnoncontiguousbytedevice_p.h>
 #include <private/qhttpnetworkconnectionchannel_p.h>
 
+#ifdef Q_OS_LINUX
+#include <private/qcore_unix_p.h>
+#include <qfile.h>
+#include <private/qabstractsocket_p.h>
+#ifndef QT_NO_NETWORKPROXY
+#include <qnetworkproxy.h>
+#endif
+#include <sys/sendfile.h>
+#ifndef QT_NO_SSL
+#include <private/qsslsocket_p.h>
+#endif
+#endif
+
 #ifndef QT_NO_HTTP
 
 QT_BEGIN_NAMESPACE
@@ -351,6 +364,11 @@ bool QHttpProtocolHandler::sendRequest()
             break;
         }
 
+#ifdef Q_OS_LINUX
+        if (m_channel->request.uploadFile() && sendUploadFile())
+            break;
+#endif
+
         // only feed the QTcpSocket buffer when there is less than 32 kB in it
         const qint64 socketBufferFill = 32*1024;
         const qint64 socketWriteMaxSize = 16*1024;
@@ -436,6 +454,98 @@ bool QHttpProtocolHandler::sendRequest()
     return true;
 }
 
+#ifdef Q_OS_LINUX
+// Sends the upload data straight from the file to the socket with sendfile(),
+// instead of copying it to the HTTP thread and through the QTcpSocket write buffer.
+// The upload byte device is advanced along, so that progress reporting and resetting
+// keep working. Returns false if the data has to be sent through the byte device.
+bool QHttpProtocolHandler::sendUploadFile()
+{
+    QNonContiguousByteDevice *uploadByteDevice = m_channel->request.uploadByteDevice();
+    const QSharedPointer<QFile> file = m_channel->request.uploadFile();
+    const int socketDescriptor = int(m_socket->socketDescriptor());
+
+    // Wait for the header (or the last chunk below) to be flushed first. Over
+    // TLS, this is also when QSslSocket has decided about kernel encryption.
+#ifndef QT_NO_SSL
+    QSslSocket *sslSocket = m_channel->ssl ? qobject_cast<QSslSocket *>(m_socket) : 0;
+    if (m_socket->bytesToWrite() > 0 || (sslSocket && sslSocket->encryptedBytesToWrite() > 0))
+        return true;
+#else
+    if (m_socket->bytesToWrite() > 0)
+        return true;
+#endif
+
+    // The raw bytes may only go to a plain TCP connection, or to a TLS one
+    // whose records are encrypted by the kernel.
+    if (socketDescriptor == -1 || file->handle() == -1
+#ifndef QT_NO_NETWORKPROXY
+        || m_socket->proxy().type() != QNetworkProxy::NoProxy
+#endif
+#ifndef QT_NO_SSL
+        || (m_channel->ssl && !QSslSocketPrivate::hasKernelTlsTransmit(sslSocket))
+#else
+        || m_channel->ssl
+#endif
+        || m_channel->written != uploadByteDevice->pos()) {
+        m_channel->request.setUploadFile(QSharedPointer<QFile>(), 0);
+        return false;
+    }
+
+    qt_ignore_sigpipe();
+
+    // Upload progress is reported after each call, so that applications asking
+    // for all progress signals get about as many as from the buffered path.
+    const qint64 sendFileMaxSize = 64*1024;
+
+    while (m_channel->written != m_channel->bytesTotal) {
+        const qint64 remaining = m_channel->bytesTotal - m_channel->written;
+        off_t offset = m_channel->request.uploadFileOffset() + m_channel->written;
+        ssize_t sent;
+        EINTR_LOOP(sent, ::sendfile(socketDescriptor, file->handle(), &offset,
+                                    size_t(qMin(remaining, sendFileMaxSize))));
+
+        if (sent == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // The kernel buffer is full. QTcpSocket only watches for writability
+            // while its own write buffer holds data, which it does not here, so
+            // ask it to emit bytesWritten() when there is room again; that ends
+            // up in sendRequest() through the channel.
+            if (QAbstractSocketPrivate::requestWriteNotification(plainSocket()))
+                return true;
+            break;
+        } else if (sent <= 0) {
+            // File shorter than announced, or sendfile() cannot handle it.
+            break;
+        } else {
+            m_channel->written += sent;
+            uploadByteDevice->advanceReadPointer(sent);
+            emit m_reply->dataSendProgress(m_channel->written, m_channel->bytesTotal);
+        }
+    }
+
+    if (m_channel->written != m_channel->bytesTotal) {
+        // Let the byte device continue where we stopped, it also reports any error.
+        m_channel->request.setUploadFile(QSharedPointer<QFile>(), 0);
+        return false;
+    }
+
+    m_channel->state = QHttpNetworkConnectionChannel::WaitingState;
+    sendRequest();
+    return true;
+}
+
+// The socket whose descriptor sendfile() writes to. Kernel TLS sends through
+// the plain socket underneath QSslSocket.
+QAbstractSocket *QHttpProtocolHandler::plainSocket() const
+{
+#ifndef QT_NO_SSL
+    if (QSslSocket *sslSocket = qobject_cast<QSslSocket *>(m_socket))
+        return static_cast<QSslSocketPrivate *>(QObjectPrivate::get(sslSocket))->plainSocket;
+#endif
+    return m_socket;
+}
+#endif // Q_OS_LINUX
+
 QT_END_NAMESPACE
 
 #endif // QT_NO_HTTP
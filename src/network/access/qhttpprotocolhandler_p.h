@@ -67,6 +67,10 @@ private:
     virtual void _q_receiveReply() Q_DECL_OVERRIDE;
     virtual void _q_readyRead() Q_DECL_OVERRIDE;
     virtual bool sendRequest() Q_DECL_OVERRIDE;
+#ifdef Q_OS_LINUX
+    bool sendUploadFile();
+    QAbstractSocket *plainSocket() const;
+#endif
 };
 
 QT_END_NAMESPACE
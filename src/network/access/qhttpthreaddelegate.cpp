@@ -231,7 +231,6 @@ QHttpThreadDelegate::QHttpThreadDelegate(QObject *parent) :
     , downloadBufferMaximumSize(0)
     , readBufferMaxSize(0)
     , bytesEmitted(0)
-    , pendingDownloadData()
     , pendingDownloadProgress()
     , synchronous(false)
     , incomingStatusCode(0)
@@ -454,6 +453,12 @@ void QHttpThreadDelegate::readBufferFreed(qint64 size)
     }
 }
 
+void QHttpThreadDelegate::pushDownloadData(const QByteArray &data)
+{
+    if (downloadDataQueue->enqueue(data))
+        emit downloadDataAvailable();
+}
+
 void QHttpThreadDelegate::readyReadSlot()
 {
     if (!httpReply)
@@ -470,13 +475,11 @@ void QHttpThreadDelegate::readyReadSlot()
                 if (httpReply->sizeNextBlock() > (readBufferMaxSize-bytesEmitted)) {
                     sizeEmitted = readBufferMaxSize-bytesEmitted;
                     bytesEmitted += sizeEmitted;
-                    pendingDownloadData->fetchAndAddRelease(1);
-                    emit downloadData(httpReply->read(sizeEmitted));
+                    pushDownloadData(httpReply->read(sizeEmitted));
                 } else {
                     sizeEmitted = httpReply->sizeNextBlock();
                     bytesEmitted += sizeEmitted;
-                    pendingDownloadData->fetchAndAddRelease(1);
-                    emit downloadData(httpReply->readAny());
+                    pushDownloadData(httpReply->readAny());
                 }
             }
         } else {
@@ -484,10 +487,8 @@ void QHttpThreadDelegate::readyReadSlot()
         }
 
     } else {
-        while (httpReply->readAnyAvailable()) {
-            pendingDownloadData->fetchAndAddRelease(1);
-            emit downloadData(httpReply->readAny());
-        }
+        while (httpReply->readAnyAvailable())
+            pushDownloadData(httpReply->readAny());
     }
 }
 
@@ -501,10 +502,8 @@ void QHttpThreadDelegate::finishedSlot()
 #endif
 
     // If there is still some data left emit that now
-    while (httpReply->readAnyAvailable()) {
-        pendingDownloadData->fetchAndAddRelease(1);
-        emit downloadData(httpReply->readAny());
-    }
+    while (httpReply->readAnyAvailable())
+        pushDownloadData(httpReply->readAny());
 
 #ifndef QT_NO_SSL
     if (ssl)
@@ -78,6 +78,88 @@ class QEventLoop;
 class QNetworkAccessCache;
 class QNetworkAccessCachedHttpConnection;
 
+// Carries the downloaded data from the HTTP thread (the only producer) to the
+// user thread (the only consumer) without locking. enqueue() reports whether the
+// consumer has to be woken up, which is only the case if it is not already about
+// to drain the queue, so a burst of chunks costs one queued signal instead of one
+// queued signal (and QMetaCallEvent) per chunk. Consumed nodes are recycled by
+// the producer.
+class QHttpDownloadDataQueue
+{
+    Q_DISABLE_COPY(QHttpDownloadDataQueue)
+
+    struct Node
+    {
+        Node() : next(0) {}
+        QByteArray data;
+        QAtomicPointer<Node> next;
+    };
+
+public:
+    QHttpDownloadDataQueue()
+        : head(new Node), tail(head.load()), first(tail), headCopy(tail), wakeupPending(0)
+    {
+    }
+
+    ~QHttpDownloadDataQueue()
+    {
+        while (first) {
+            Node *next = first->next.load();
+            delete first;
+            first = next;
+        }
+    }
+
+    // producer side
+    bool enqueue(const QByteArray &data)
+    {
+        Node *node = allocateNode();
+        node->data = data;
+        node->next.store(0);
+        tail->next.storeRelease(node);
+        tail = node;
+        return wakeupPending.testAndSetOrdered(0, 1);
+    }
+
+    // consumer side, call before draining the queue with dequeue()
+    void acknowledgeWakeup()
+    {
+        wakeupPending.fetchAndStoreOrdered(0);
+    }
+
+    bool dequeue(QByteArray *data)
+    {
+        Node *dummy = head.load();
+        Node *node = dummy->next.loadAcquire();
+        if (!node)
+            return false;
+        *data = node->data;
+        node->data.clear();
+        // node becomes the new dummy, dummy can be reused by the producer
+        head.storeRelease(node);
+        return true;
+    }
+
+private:
+    Node *allocateNode()
+    {
+        if (first == headCopy) {
+            headCopy = head.loadAcquire();
+            if (first == headCopy)
+                return new Node;
+        }
+        Node *node = first;
+        first = first->next.load();
+        return node;
+    }
+
+    QAtomicPointer<Node> head; // consumer
+    Node *tail; // producer
+    Node *first; // producer, oldest node not yet recycled
+    Node *headCopy; // producer, last seen value of head
+    QAtomicInt wakeupPending;
+};
+
 class QHttpThreadDelegate : public QObject
 {
     Q_OBJECT
@@ -95,8 +177,9 @@ public:
     qint64 downloadBufferMaximumSize;
     qint64 readBufferMaxSize;
     qint64 bytesEmitted;
+    // From backend, we fill it and emit downloadDataAvailable() when it needs draining
+    QSharedPointer<QHttpDownloadDataQueue> downloadDataQueue;
     // From backend, modified by us for signal compression
-    QSharedPointer<QAtomicInt> pendingDownloadData;
     QSharedPointer<QAtomicInt> pendingDownloadProgress;
 #ifndef QT_NO_NETWORKPROXY
     QNetworkProxy cacheProxy;
@@ -146,7 +229,7 @@ signals:
     void downloadMetaData(const QList<QPair<QByteArray,QByteArray> > &, int, const QString &, bool,
                           QSharedPointer<char>, qint64, qint64, bool);
     void downloadProgress(qint64, qint64);
-    void downloadData(const QByteArray &);
+    void downloadDataAvailable();
     void error(QNetworkReply::NetworkError, const QString &);
     void downloadFinished();
     void redirected(const QUrl &url, int httpStatus, int maxRedirectsRemainig);
@@ -160,6 +243,9 @@ public slots:
 
     // This is called with a BlockingQueuedConnection from user thread
     void startRequestSynchronously();
+protected:
+    void pushDownloadData(const QByteArray &data);
+
 protected slots:
     // From QHttp*
     void readyReadSlot();
@@ -202,6 +288,7 @@ protected:
     bool m_atEnd;
     qint64 m_size;
     qint64 m_pos; // to match calls of haveDataSlot with the expected position
+    bool m_directUpload;
 public:
     QNonContiguousByteDeviceThreadForwardImpl(bool aE, qint64 s)
         : QNonContiguousByteDevice(),
@@ -210,10 +297,17 @@ public:
           m_data(0),
           m_atEnd(aE),
           m_size(s),
-          m_pos(0)
+          m_pos(0),
+          m_directUpload(false)
     {
     }
 
+    // The request also carries the upload file, see QHttpNetworkRequest::setUploadFile()
+    void setDirectUpload(bool direct)
+    {
+        m_directUpload = direct;
+    }
+
     ~QNonContiguousByteDeviceThreadForwardImpl()
     {
     }
@@ -245,11 +339,15 @@ public:
 
     bool advanceReadPointer(qint64 a) Q_DECL_OVERRIDE
     {
-        if (m_data == 0)
+        if (m_data) {
+            m_amount -= a;
+            m_data += a;
+        } else if (!m_directUpload) {
             return false;
+        }
+        // else the HTTP code sent the data straight from the upload file,
+        // the user thread only needs to follow along
 
-        m_amount -= a;
-        m_data += a;
         m_pos += a;
 
         // To main thread to inform about our state. The m_pos will be sent as a sanity check.
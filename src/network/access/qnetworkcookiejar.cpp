@@ -43,10 +43,13 @@
 #include "QtNetwork/qnetworkcookie.h"
 #include "QtCore/qurl.h"
 #include "QtCore/qdatetime.h"
+#include "QtCore/qvarlengtharray.h"
 #if QT_CONFIG(topleveldomain)
 #include "private/qtldurl_p.h"
 #endif
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 /*!
@@ -120,7 +123,9 @@ QNetworkCookieJar::~QNetworkCookieJar()
 */
 QList<QNetworkCookie> QNetworkCookieJar::allCookies() const
 {
-    return d_func()->allCookies;
+    Q_D(const QNetworkCookieJar);
+    d->updateAllCookies();
+    return d->allCookies;
 }
 
 /*!
@@ -136,6 +141,8 @@ void QNetworkCookieJar::setAllCookies(const QList<QNetworkCookie> &cookieList)
 {
     Q_D(QNetworkCookieJar);
     d->allCookies = cookieList;
+    d->allCookiesValid = true;
+    d->rebuildIndex();
 }
 
 static inline bool isParentPath(const QString &path, const QString &reference)
@@ -165,6 +172,154 @@ static inline bool isParentDomain(const QString &domain, const QString &referenc
     return domain.endsWith(reference) || domain == reference.midRef(1);
 }
 
+namespace {
+struct IndexEntryPathLess
+{
+    typedef QNetworkCookieJarPrivate::IndexEntry IndexEntry;
+
+    bool operator()(const IndexEntry &entry, const QStringRef &path) const
+    { return path.compare(entry.cookie.path()) > 0; }
+    bool operator()(const QStringRef &path, const IndexEntry &entry) const
+    { return path.compare(entry.cookie.path()) < 0; }
+};
+
+struct IndexEntryOrder
+{
+    typedef QNetworkCookieJarPrivate::IndexEntry IndexEntry;
+
+    bool operator()(const IndexEntry &lhs, const IndexEntry &rhs) const
+    {
+        const int cmp = lhs.cookie.path().compare(rhs.cookie.path());
+        return cmp < 0 || (cmp == 0 && lhs.serial < rhs.serial);
+    }
+};
+
+// longest path first; among equal lengths, keep the order of allCookies
+struct SerialOrder
+{
+    typedef QNetworkCookieJarPrivate::IndexEntry IndexEntry;
+
+    bool operator()(const IndexEntry *lhs, const IndexEntry *rhs) const
+    { return lhs->serial < rhs->serial; }
+};
+
+struct ResultOrder
+{
+    typedef QNetworkCookieJarPrivate::IndexEntry IndexEntry;
+
+    bool operator()(const IndexEntry *lhs, const IndexEntry *rhs) const
+    {
+        const int lhsLength = lhs->cookie.path().length();
+        const int rhsLength = rhs->cookie.path().length();
+        return lhsLength > rhsLength || (lhsLength == rhsLength && lhs->serial < rhs->serial);
+    }
+};
+} // unnamed namespace
+
+/*!
+    \internal
+
+    Returns the key of the index bucket holding cookies for \a domain:
+    the registrable domain (one label below the public suffix), so that
+    cookies set for a host and for its parent domains share a bucket.
+    Domains that are themselves public suffixes, or that cannot be
+    classified, are used as they are.
+*/
+QString QNetworkCookieJarPrivate::indexKey(const QString &domain)
+{
+    QString key = domain.startsWith(QLatin1Char('.')) ? domain.mid(1) : domain;
+    key = key.toLower();
+#if QT_CONFIG(topleveldomain)
+    const QString tld = qTopLevelDomain(key);
+    if (!tld.isEmpty() && key.length() > tld.length() && key.endsWith(tld)) {
+        const int dot = key.lastIndexOf(QLatin1Char('.'), key.length() - tld.length() - 1);
+        if (dot >= 0)
+            key.remove(0, dot + 1);
+    }
+#endif
+    return key;
+}
+
+void QNetworkCookieJarPrivate::rebuildIndex()
+{
+    index.clear();
+    nextSerial = 0;
+    for (const QNetworkCookie &cookie : qAsConst(allCookies)) {
+        IndexEntry entry = { cookie, nextSerial++ };
+        index[indexKey(cookie.domain())].append(entry);
+    }
+    for (QHash<QString, IndexBucket>::iterator it = index.begin(); it != index.end(); ++it)
+        std::sort(it->begin(), it->end(), IndexEntryOrder());
+}
+
+void QNetworkCookieJarPrivate::addToIndex(const QNetworkCookie &cookie, quint64 serial)
+{
+    IndexBucket &bucket = index[indexKey(cookie.domain())];
+    const IndexEntry entry = { cookie, serial };
+    bucket.insert(std::upper_bound(bucket.begin(), bucket.end(), entry, IndexEntryOrder()), entry);
+}
+
+bool QNetworkCookieJarPrivate::removeFromIndex(const QNetworkCookie &cookie)
+{
+    QHash<QString, IndexBucket>::iterator bucket = index.find(indexKey(cookie.domain()));
+    if (bucket == index.end())
+        return false;
+
+    const QString path = cookie.path();
+    const auto range = std::equal_range(bucket->begin(), bucket->end(), QStringRef(&path),
+                                        IndexEntryPathLess());
+    for (IndexBucket::iterator it = range.first; it != range.second; ++it) {
+        if (it->cookie.hasSameIdentifier(cookie)) {
+            bucket->erase(it);
+            if (bucket->isEmpty())
+                index.erase(bucket);
+            allCookiesValid = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline bool isExpired(const QNetworkCookie &cookie, const QDateTime &now)
+{
+    return !cookie.isSessionCookie() && cookie.expirationDate() < now;
+}
+
+void QNetworkCookieJarPrivate::removeExpired(const QString &key, const QDateTime &now)
+{
+    QHash<QString, IndexBucket>::iterator bucket = index.find(key);
+    if (bucket == index.end())
+        return;
+
+    const IndexBucket::iterator end = std::remove_if(bucket->begin(), bucket->end(),
+            [&now](const IndexEntry &entry) { return isExpired(entry.cookie, now); });
+    if (end == bucket->end())
+        return;
+    bucket->erase(end, bucket->end());
+    if (bucket->isEmpty())
+        index.erase(bucket);
+    allCookiesValid = false;
+}
+
+void QNetworkCookieJarPrivate::updateAllCookies() const
+{
+    if (allCookiesValid)
+        return;
+
+    QVector<const IndexEntry *> entries;
+    for (const IndexBucket &bucket : index) {
+        for (const IndexEntry &entry : bucket)
+            entries.append(&entry);
+    }
+    std::sort(entries.begin(), entries.end(), SerialOrder());
+
+    allCookies.clear();
+    allCookies.reserve(entries.size());
+    for (const IndexEntry *entry : qAsConst(entries))
+        allCookies.append(entry->cookie);
+    allCookiesValid = true;
+}
+
 /*!
     Adds the cookies in the list \a cookieList to this cookie
     jar. Before being inserted cookies are normalized.
@@ -223,41 +378,75 @@ QList<QNetworkCookie> QNetworkCookieJar::cookiesForUrl(const QUrl &url) const
 //     http://wp.netscape.com/newsref/std/cookie_spec.html
 //     It does not implement a very good cross-domain verification yet.
 
+    typedef QNetworkCookieJarPrivate::IndexEntry IndexEntry;
+    typedef QNetworkCookieJarPrivate::IndexBucket IndexBucket;
+
     Q_D(const QNetworkCookieJar);
     const QDateTime now = QDateTime::currentDateTimeUtc();
     QList<QNetworkCookie> result;
     bool isEncrypted = url.scheme() == QLatin1String("https");
-
-    // scan our cookies for something that matches
-    QList<QNetworkCookie>::ConstIterator it = d->allCookies.constBegin(),
-                                        end = d->allCookies.constEnd();
-    for ( ; it != end; ++it) {
-        if (!isParentDomain(url.host(), it->domain()))
-            continue;
-        if (!isParentPath(url.path(), it->path()))
-            continue;
-        if (!(*it).isSessionCookie() && (*it).expirationDate() < now)
-            continue;
-        if ((*it).isSecure() && !isEncrypted)
-            continue;
-
-        // insert this cookie into result, sorted by path
-        QList<QNetworkCookie>::Iterator insertIt = result.begin();
-        while (insertIt != result.end()) {
-            if (insertIt->path().length() < it->path().length()) {
-                // insert here
-                insertIt = result.insert(insertIt, *it);
-                break;
-            } else {
-                ++insertIt;
+    const QString host = url.host();
+    const QString path = url.path();
+    const QString rootPath = QStringLiteral("/");
+
+    // a cookie path matches if it equals the request path, or is a prefix
+    // of it ending at (or just before) a '/'
+    QVarLengthArray<QStringRef, 16> candidatePaths;
+    candidatePaths.append(QStringRef(&path));
+    if (path.isEmpty())
+        candidatePaths.append(QStringRef(&rootPath));
+    for (int i = path.indexOf(QLatin1Char('/')); i >= 0; i = path.indexOf(QLatin1Char('/'), i + 1)) {
+        candidatePaths.append(path.leftRef(i));
+        candidatePaths.append(path.leftRef(i + 1));
+    }
+    std::sort(candidatePaths.begin(), candidatePaths.end());
+    candidatePaths.erase(std::unique(candidatePaths.begin(), candidatePaths.end()), candidatePaths.end());
+
+    // cookies for the host live in the bucket of its registrable domain;
+    // cookies set on a public suffix live in the buckets above it
+    QVarLengthArray<const IndexEntry *, 32> matches;
+    QVarLengthArray<QString, 4> expiredKeys;
+    const QString key = QNetworkCookieJarPrivate::indexKey(host);
+    for (int from = 0; from >= 0; ) {
+        const QString bucketKey = key.mid(from);
+        const QHash<QString, IndexBucket>::const_iterator bucket = d->index.constFind(bucketKey);
+        if (bucket != d->index.constEnd()) {
+            for (const QStringRef &candidate : qAsConst(candidatePaths)) {
+                const auto range = std::equal_range(bucket->constBegin(), bucket->constEnd(),
+                                                    candidate, IndexEntryPathLess());
+                for (IndexBucket::const_iterator it = range.first; it != range.second; ++it) {
+                    const QNetworkCookie &cookie = it->cookie;
+                    if (!isParentDomain(host, cookie.domain()))
+                        continue;
+                    if (!isParentPath(path, cookie.path()))
+                        continue;
+                    if (isExpired(cookie, now)) {
+                        if (expiredKeys.isEmpty() || expiredKeys.last() != bucketKey)
+                            expiredKeys.append(bucketKey);
+                        continue;
+                    }
+                    if (cookie.isSecure() && !isEncrypted)
+                        continue;
+                    matches.append(&*it);
+                }
             }
         }
-
-        // this is the shortest path yet, just append
-        if (insertIt == result.end())
-            result += *it;
+        from = key.indexOf(QLatin1Char('.'), from);
+        if (from >= 0)
+            ++from;
     }
 
+    // sorted decreasingly by path length
+    std::sort(matches.begin(), matches.end(), ResultOrder());
+    result.reserve(matches.size());
+    for (const IndexEntry *entry : qAsConst(matches))
+        result.append(entry->cookie);
+
+    // expired cookies are never returned again, drop the ones we came across
+    QNetworkCookieJarPrivate *mutableD = const_cast<QNetworkCookieJarPrivate *>(d);
+    for (const QString &expiredKey : qAsConst(expiredKeys))
+        mutableD->removeExpired(expiredKey, now);
+
     return result;
 }
 
@@ -280,7 +469,9 @@ bool QNetworkCookieJar::insertCookie(const QNetworkCookie &cookie)
     deleteCookie(cookie);
 
     if (!isDeletion) {
-        d->allCookies += cookie;
+        if (d->allCookiesValid)
+            d->allCookies += cookie;
+        d->addToIndex(cookie, d->nextSerial++);
         return true;
     }
     return false;
@@ -314,14 +505,7 @@ bool QNetworkCookieJar::updateCookie(const QNetworkCookie &cookie)
 bool QNetworkCookieJar::deleteCookie(const QNetworkCookie &cookie)
 {
     Q_D(QNetworkCookieJar);
-    QList<QNetworkCookie>::Iterator it;
-    for (it = d->allCookies.begin(); it != d->allCookies.end(); ++it) {
-        if (it->hasSameIdentifier(cookie)) {
-            d->allCookies.erase(it);
-            return true;
-        }
-    }
-    return false;
+    return d->removeFromIndex(cookie);
 }
 
 /*!
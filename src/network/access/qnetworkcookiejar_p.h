@@ -55,16 +55,43 @@
 #include "private/qobject_p.h"
 #include "qnetworkcookie.h"
 
+#include <QtCore/qhash.h>
+#include <QtCore/qvector.h>
+
 QT_BEGIN_NAMESPACE
 
 class QNetworkCookieJarPrivate: public QObjectPrivate
 {
 public:
-    QList<QNetworkCookie> allCookies;
+    QNetworkCookieJarPrivate() : nextSerial(0), allCookiesValid(true) {}
+
+    // The index holds the cookies: they are bucketed by registrable domain
+    // and each bucket is kept sorted by path, then by serial, which records
+    // the insertion order. allCookies is that order as a list, rebuilt from
+    // the index when it is asked for after a cookie was removed.
+    struct IndexEntry {
+        QNetworkCookie cookie;
+        quint64 serial;
+    };
+    typedef QVector<IndexEntry> IndexBucket;
+
+    static QString indexKey(const QString &domain);
+    void rebuildIndex();
+    void addToIndex(const QNetworkCookie &cookie, quint64 serial);
+    bool removeFromIndex(const QNetworkCookie &cookie);
+    void removeExpired(const QString &key, const QDateTime &now);
+    void updateAllCookies() const;
+
+    QHash<QString, IndexBucket> index;
+    quint64 nextSerial;
+    mutable QList<QNetworkCookie> allCookies;
+    mutable bool allCookiesValid;
 
     Q_DECLARE_PUBLIC(QNetworkCookieJar)
 };
 
+Q_DECLARE_TYPEINFO(QNetworkCookieJarPrivate::IndexEntry, Q_MOVABLE_TYPE);
+
 QT_END_NAMESPACE
 
 #endif
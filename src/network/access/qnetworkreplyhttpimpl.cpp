@@ -64,6 +64,11 @@
 
 #include <string.h>             // for strchr
 
+#ifdef Q_OS_LINUX
+#include <QtCore/private/qcore_unix_p.h>
+#include <QtCore/qfile.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 class QNetworkProxy;
@@ -460,7 +465,7 @@ QNetworkReplyHttpImplPrivate::QNetworkReplyHttpImplPrivate()
     , downloadBufferReadPosition(0)
     , downloadBufferCurrentSize(0)
     , downloadZerocopyBuffer(0)
-    , pendingDownloadDataEmissions(QSharedPointer<QAtomicInt>::create())
+    , downloadDataQueue(QSharedPointer<QHttpDownloadDataQueue>::create())
     , pendingDownloadProgressEmissions(QSharedPointer<QAtomicInt>::create())
     #ifndef QT_NO_SSL
     , pendingIgnoreAllSslErrors(false)
@@ -781,6 +786,13 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
     if (request.attribute(QNetworkRequest::EmitAllUploadProgressSignalsAttribute).toBool())
         emitAllUploadProgressSignals = true;
 
+    downloadTarget = qobject_cast<QIODevice *>(
+            newHttpRequest.attribute(QNetworkRequest::DownloadTargetDeviceAttribute).value<QObject *>());
+    if (downloadTarget && !downloadTarget->isWritable()) {
+        qWarning("QNetworkReply: the download target device is not open for writing");
+        downloadTarget = 0;
+    }
+
 
     // Create the HTTP thread delegate
     QHttpThreadDelegate *delegate = new QHttpThreadDelegate;
@@ -818,7 +830,10 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
     if (!synchronous) {
         // Tell our zerocopy policy to the delegate
         QVariant downloadBufferMaximumSizeAttribute = newHttpRequest.attribute(QNetworkRequest::MaximumDownloadBufferSizeAttribute);
-        if (downloadBufferMaximumSizeAttribute.isValid()) {
+        if (downloadTarget) {
+            // The data goes straight to the target device, a download buffer would only add a copy
+            delegate->downloadBufferMaximumSize = 0;
+        } else if (downloadBufferMaximumSizeAttribute.isValid()) {
             delegate->downloadBufferMaximumSize = downloadBufferMaximumSizeAttribute.toLongLong();
         } else {
             // If there is no MaximumDownloadBufferSizeAttribute set (which is for the majority
@@ -828,13 +843,14 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
         }
 
 
-        // These atomic integers are used for signal compression
-        delegate->pendingDownloadData = pendingDownloadDataEmissions;
+        // The downloaded data comes through this queue, with coalesced wakeups
+        delegate->downloadDataQueue = downloadDataQueue;
+        // This atomic integer is used for signal compression
         delegate->pendingDownloadProgress = pendingDownloadProgressEmissions;
 
         // Connect the signals of the delegate to us
-        QObject::connect(delegate, SIGNAL(downloadData(QByteArray)),
-                q, SLOT(replyDownloadData(QByteArray)),
+        QObject::connect(delegate, SIGNAL(downloadDataAvailable()),
+                q, SLOT(replyDownloadDataAvailable()),
                 Qt::QueuedConnection);
         QObject::connect(delegate, SIGNAL(downloadFinished()),
                 q, SLOT(replyFinished()),
@@ -918,6 +934,31 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
             QObject::connect(forwardUploadDevice, SIGNAL(resetData(bool*)),
                     q, SLOT(resetUploadDataSlot(bool*)),
                     Qt::BlockingQueuedConnection); // this is the only one with BlockingQueued!
+
+#ifdef Q_OS_LINUX
+            // A local file can be sent from the HTTP thread with sendfile() on
+            // unencrypted connections, and on those encrypted by the kernel,
+            // instead of being read and copied here.
+            QFile *file = qobject_cast<QFile *>(outgoingData);
+#ifndef QT_NO_SSL
+            const bool directUpload = !ssl || newHttpRequest.sslConfiguration()
+                                                   .testSslOption(QSsl::SslOptionEnableKernelTls);
+#else
+            const bool directUpload = !ssl;
+#endif
+            if (directUpload && !outgoingDataBuffer && file && file->handle() != -1
+                && !file->isSequential() && uploadByteDevice->size() >= 0) {
+                const int fd = qt_safe_dup(file->handle());
+                QSharedPointer<QFile> uploadFile(new QFile);
+                if (fd != -1 && uploadFile->open(fd, QIODevice::ReadOnly | QIODevice::Unbuffered,
+                                                 QFileDevice::AutoCloseHandle)) {
+                    delegate->httpRequest.setUploadFile(uploadFile, file->pos());
+                    forwardUploadDevice->setDirectUpload(true);
+                } else if (fd != -1) {
+                    qt_safe_close(fd);
+                }
+            }
+#endif
         }
     } else if (synchronous) {
         QObject::connect(q, SIGNAL(startHttpRequestSynchronously()), delegate, SLOT(startRequestSynchronously()), Qt::BlockingQueuedConnection);
@@ -1032,27 +1073,45 @@ void QNetworkReplyHttpImplPrivate::initCacheSaveDevice()
     }
 }
 
-void QNetworkReplyHttpImplPrivate::replyDownloadData(QByteArray d)
+void QNetworkReplyHttpImplPrivate::replyDownloadDataAvailable()
 {
     Q_Q(QNetworkReplyHttpImpl);
 
+    // Take everything the HTTP thread has queued so far. Whatever it queues
+    // from now on comes with another wakeup.
+    downloadDataQueue->acknowledgeWakeup();
+    QByteArray d;
+    while (downloadDataQueue->dequeue(&d))
+        pendingDownloadData.append(d);
+
     // If we're closed just ignore this data
-    if (!q->isOpen())
+    if (!q->isOpen()) {
+        pendingDownloadData.clear();
         return;
+    }
 
-    int pendingSignals = (int)pendingDownloadDataEmissions->fetchAndAddAcquire(-1) - 1;
+    // An earlier wakeup may already have taken it all
+    if (!pendingDownloadData.isEmpty())
+        processPendingDownloadData();
+}
 
-    if (pendingSignals > 0) {
-        // Some more signal emissions to this slot are pending.
-        // Instead of writing the downstream data, we wait
-        // and do it in the next call we get
-        // (signal comppression)
-        pendingDownloadData.append(d);
+void QNetworkReplyHttpImplPrivate::replyDownloadData(QByteArray d)
+{
+    Q_Q(QNetworkReplyHttpImpl);
+
+    // If we're closed just ignore this data
+    if (!q->isOpen())
         return;
-    }
 
     pendingDownloadData.append(d);
     d.clear();
+    processPendingDownloadData();
+}
+
+void QNetworkReplyHttpImplPrivate::processPendingDownloadData()
+{
+    Q_Q(QNetworkReplyHttpImpl);
+
     // We need to usa a copy for calling writeDownstreamData as we could
     // possibly recurse into this this function when we call
     // appendDownstreamDataSignalEmissions because the user might call
@@ -1064,6 +1123,7 @@ void QNetworkReplyHttpImplPrivate::replyDownloadData(QByteArray d)
         initCacheSaveDevice();
     }
 
+    const bool writeToTarget = downloadTarget && !isHttpRedirectResponse();
     qint64 bytesWritten = 0;
     for (int i = 0; i < pendingDownloadDataCopy.bufferCount(); i++) {
         QByteArray const &item = pendingDownloadDataCopy[i];
@@ -1076,14 +1136,33 @@ void QNetworkReplyHttpImplPrivate::replyDownloadData(QByteArray d)
         if (cacheSaveDevice)
             cacheSaveDevice->write(item.constData(), item.size());
 
-        if (!isHttpRedirectResponse())
+        if (writeToTarget) {
+            if (downloadTarget->write(item.constData(), item.size()) != item.size()) {
+                error(QNetworkReply::UnknownContentError,
+                      QCoreApplication::translate("QNetworkReply", "Error writing to the download target: %1")
+                      .arg(downloadTarget->errorString()));
+                // like abort(), but keeping the error above
+                finished();
+                state = Aborted;
+                emit q->abortHttpRequest();
+                return;
+            }
+        } else if (!isHttpRedirectResponse()) {
             buffer.append(item);
+        }
 
         bytesWritten += item.size();
     }
-    bytesBuffered += bytesWritten;
     pendingDownloadDataCopy.clear();
 
+    if (writeToTarget) {
+        // Nothing is buffered in the reply, give the HTTP thread its read buffer back right away
+        if (readBufferMaxSize)
+            emit q->readBufferFreed(bytesWritten);
+    } else {
+        bytesBuffered += bytesWritten;
+    }
+
     QVariant totalSize = cookedHeaders.value(QNetworkRequest::ContentLengthHeader);
     if (preMigrationDownloaded != Q_INT64_C(-1))
         totalSize = totalSize.toLongLong() + preMigrationDownloaded;
@@ -1093,7 +1172,8 @@ void QNetworkReplyHttpImplPrivate::replyDownloadData(QByteArray d)
 
     bytesDownloaded += bytesWritten;
 
-    emit q->readyRead();
+    if (!writeToTarget)
+        emit q->readyRead();
     // emit readyRead before downloadProgress incase this will cause events to be
     // processed and we get into a recursive call (as in QProgressDialog).
     if (downloadProgressSignalChoke.elapsed() >= progressSignalInterval) {
@@ -77,6 +77,7 @@
 QT_BEGIN_NAMESPACE
 
 class QIODevice;
+class QHttpDownloadDataQueue;
 
 class QNetworkReplyHttpImplPrivate;
 class QNetworkReplyHttpImpl: public QNetworkReply
@@ -111,7 +112,7 @@ public:
     Q_PRIVATE_SLOT(d_func(), void _q_error(QNetworkReply::NetworkError, const QString &))
 
     // From reply
-    Q_PRIVATE_SLOT(d_func(), void replyDownloadData(QByteArray))
+    Q_PRIVATE_SLOT(d_func(), void replyDownloadDataAvailable())
     Q_PRIVATE_SLOT(d_func(), void replyFinished())
     Q_PRIVATE_SLOT(d_func(), void replyDownloadMetaData(QList<QPair<QByteArray,QByteArray> >,
                                                         int, QString, bool, QSharedPointer<char>,
@@ -248,10 +249,14 @@ public:
     quint64 resumeOffset;
     qint64 preMigrationDownloaded;
 
-    QByteDataBuffer pendingDownloadData; // For signal compression
+    QByteDataBuffer pendingDownloadData; // For recursion, see replyDownloadData()
     qint64 bytesDownloaded;
     qint64 bytesBuffered;
 
+    // Set through QNetworkRequest::DownloadTargetDeviceAttribute, the body is
+    // written there instead of being buffered in the reply.
+    QPointer<QIODevice> downloadTarget;
+
     // Only used when the "zero copy" style is used.
     // Please note that the whole "zero copy" download buffer API is private right now. Do not use it.
     qint64 downloadBufferReadPosition;
@@ -259,8 +264,9 @@ public:
     QSharedPointer<char> downloadBufferPointer;
     char* downloadZerocopyBuffer;
 
+    // Filled by HTTP thread:
+    QSharedPointer<QHttpDownloadDataQueue> downloadDataQueue;
     // Will be increased by HTTP thread:
-    QSharedPointer<QAtomicInt> pendingDownloadDataEmissions;
     QSharedPointer<QAtomicInt> pendingDownloadProgressEmissions;
 
 
@@ -285,7 +291,9 @@ public:
 
 public:
     // From HTTP thread:
+    void replyDownloadDataAvailable();
     void replyDownloadData(QByteArray);
+    void processPendingDownloadData();
     void replyFinished();
     void replyDownloadMetaData(const QList<QPair<QByteArray,QByteArray> > &, int, const QString &,
                                bool, QSharedPointer<char>, qint64, qint64, bool);
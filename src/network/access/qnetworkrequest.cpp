@@ -298,6 +298,17 @@ QT_BEGIN_NAMESPACE
         This attribute obsoletes FollowRedirectsAttribute.
         (This value was introduced in 5.9.)
 
+    \value DownloadTargetDeviceAttribute
+        Requests only, type: QMetaType::QObjectStar (default: nullptr)
+        A QIODevice, typically a QFile, that is open for writing. For HTTP
+        requests the body of the response is written straight to this device
+        as it arrives from the network, instead of being buffered in the
+        reply. The reply then never has bytes available to read;
+        downloadProgress() is still emitted. This saves copying the data
+        into and out of the reply when it is only going to be stored.
+        Responses served from the cache are read from the reply as usual.
+        (This value was introduced in 5.11.)
+
     \value User
         Special type. Additional information can be passed in
         QVariants with types ranging from User to UserMax. The default
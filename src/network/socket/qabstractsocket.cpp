@@ -553,6 +553,7 @@ static bool isProxyError(QAbstractSocket::SocketError error)
 QAbstractSocketPrivate::QAbstractSocketPrivate()
     : emittedReadyRead(false),
       emittedBytesWritten(false),
+      writeNotificationRequested(false),
       abortCalled(false),
       pendingClose(false),
       pauseMode(QAbstractSocket::PauseNever),
@@ -594,6 +595,7 @@ void QAbstractSocketPrivate::resetSocketLayer()
 #endif
 
     hasPendingData = false;
+    writeNotificationRequested = false;
     if (socketEngine) {
         socketEngine->close();
         socketEngine->disconnect();
@@ -837,6 +839,10 @@ bool QAbstractSocketPrivate::writeToSocket()
         } else {
             if (socketEngine)
                 socketEngine->setWriteNotificationEnabled(false);
+            if (writeNotificationRequested && socketEngine && socketEngine->isValid()) {
+                writeNotificationRequested = false;
+                emitBytesWritten(0);
+            }
         }
 
         return false;
@@ -868,6 +874,7 @@ bool QAbstractSocketPrivate::writeToSocket()
         writeBuffer.free(written);
 
         // Emit notifications.
+        writeNotificationRequested = false;
         emitBytesWritten(written);
     }
 
@@ -1392,6 +1399,25 @@ QAbstractSocketEngine* QAbstractSocketPrivate::getSocketEngine(QAbstractSocket *
     return socket->d_func()->socketEngine;
 }
 
+/*!
+    \internal
+
+    Makes \a socket emit bytesWritten() once it can be written to, even
+    if its write buffer is empty; bytesWritten(0) is emitted in that case.
+    This is for callers that write to the socket descriptor directly, such
+    as with sendfile(), and have to wait when the kernel buffer is full.
+    Returns \c false if the socket has no valid socket engine.
+*/
+bool QAbstractSocketPrivate::requestWriteNotification(QAbstractSocket *socket)
+{
+    QAbstractSocketPrivate *d = socket->d_func();
+    if (!d->socketEngine || !d->socketEngine->isValid())
+        return false;
+    d->writeNotificationRequested = true;
+    d->socketEngine->setWriteNotificationEnabled(true);
+    return true;
+}
+
 /*!
     \internal
 
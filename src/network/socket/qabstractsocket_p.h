@@ -98,6 +98,7 @@ public:
 
     bool emittedReadyRead;
     bool emittedBytesWritten;
+    bool writeNotificationRequested;
 
     bool abortCalled;
     bool pendingClose;
@@ -164,6 +165,7 @@ public:
     static void pauseSocketNotifiers(QAbstractSocket*);
     static void resumeSocketNotifiers(QAbstractSocket*);
     static QAbstractSocketEngine* getSocketEngine(QAbstractSocket*);
+    static bool requestWriteNotification(QAbstractSocket*);
 };
 
 QT_END_NAMESPACE
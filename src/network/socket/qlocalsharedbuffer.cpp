@@ -0,0 +1,438 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qlocalsharedbuffer.h"
+
+#include <qcoreapplication.h>
+#include <qdir.h>
+#include <qfile.h>
+
+#ifdef Q_OS_UNIX
+#  include "private/qcore_unix_p.h"
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <errno.h>
+#  ifdef Q_OS_LINUX
+#    include <sys/syscall.h>
+#  endif
+#endif
+
+#ifdef Q_OS_LINUX
+// Not every C library declares these yet.
+#  ifndef MFD_CLOEXEC
+#    define MFD_CLOEXEC 0x0001U
+#  endif
+#  ifndef MFD_ALLOW_SEALING
+#    define MFD_ALLOW_SEALING 0x0002U
+#  endif
+#  ifndef F_ADD_SEALS
+#    define F_ADD_SEALS (1024 + 9)
+#    define F_GET_SEALS (1024 + 10)
+#    define F_SEAL_SEAL 0x0001
+#    define F_SEAL_SHRINK 0x0002
+#    define F_SEAL_GROW 0x0004
+#  endif
+
+// the seals that keep the size of a buffer from changing while mapped
+static const int qt_shared_buffer_seals = F_SEAL_SHRINK | F_SEAL_GROW;
+#endif
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QLocalSharedBuffer
+    \since 5.11
+    \inmodule QtNetwork
+    \ingroup network
+
+    \brief The QLocalSharedBuffer class provides a block of memory that can
+    be handed to another process over a QLocalSocket.
+
+    Large payloads such as video frames are expensive to send through a
+    socket: every byte is copied into the kernel and out again, plus once
+    more into the socket buffers on each side. A QLocalSharedBuffer is
+    instead backed by an anonymous shared memory file. One process
+    create()s it and fills data(), then passes fileDescriptor() to its peer
+    with QLocalSocket::writeFileDescriptor(). The peer attach()es the
+    descriptor it reads with QLocalSocket::readFileDescriptor() and sees the
+    same memory, without anything being copied.
+
+    \code
+    // sender
+    QLocalSharedBuffer buffer;
+    if (buffer.create(image.sizeInBytes())) {
+        memcpy(buffer.data(), image.constBits(), image.sizeInBytes());
+        socket->writeFileDescriptor(buffer.fileDescriptor());
+        socket->write(header);
+    }
+
+    // receiver, once the header has been read
+    QLocalSharedBuffer buffer;
+    if (buffer.attach(socket->readFileDescriptor(), QLocalSharedBuffer::ReadOnly))
+        process(buffer.constData(), buffer.size());
+    \endcode
+
+    On Linux the memory is a \c memfd whose size is sealed, so the receiver
+    can rely on size() not changing underneath it: a process mapping a file
+    that another process truncates is killed by \c SIGBUS when it touches
+    the lost pages. attach() therefore refuses descriptors that do not
+    carry these seals, and both functions need Linux 3.17 or later. On
+    other Unix systems an unlinked temporary file is used instead, and the
+    processes have to trust each other not to resize it. Shared buffers
+    are not supported on Windows, where create() and attach() always fail.
+
+    Creating and mapping a buffer costs more than copying a few megabytes,
+    since every page of fresh memory has to be faulted in. Buffers pay off
+    when they are reused: hand a small pool of them to the peer once, then
+    only exchange messages saying which buffer holds the next payload.
+
+    Unlike QSharedMemory, the buffer has no name and no lock: it is only
+    reachable through its file descriptor, and the processes sharing it
+    must agree on who writes to it and when, typically through the
+    messages they exchange over the socket.
+
+    \sa QLocalSocket, QSharedMemory
+*/
+
+/*!
+    \enum QLocalSharedBuffer::AccessMode
+
+    \value ReadOnly The buffer is mapped for reading only. Writing through
+    data() crashes the process.
+    \value ReadWrite The buffer is mapped for reading and writing.
+*/
+
+class QLocalSharedBufferPrivate
+{
+public:
+    QLocalSharedBufferPrivate()
+        : descriptor(-1), memory(0), size(0), mode(QLocalSharedBuffer::ReadWrite)
+    {}
+
+#ifdef Q_OS_UNIX
+    bool map(const QString &function);
+    void setErrorString(const QString &function, int errorCode);
+#endif
+
+    int descriptor;
+    void *memory;
+    qint64 size;
+    QLocalSharedBuffer::AccessMode mode;
+    QString errorString;
+};
+
+#ifdef Q_OS_UNIX
+void QLocalSharedBufferPrivate::setErrorString(const QString &function, int errorCode)
+{
+    errorString = QCoreApplication::translate("QLocalSharedBuffer", "%1: %2")
+            .arg(function, qt_error_string(errorCode));
+}
+
+bool QLocalSharedBufferPrivate::map(const QString &function)
+{
+    const int protection = (mode == QLocalSharedBuffer::ReadOnly) ? PROT_READ : PROT_READ | PROT_WRITE;
+    memory = ::mmap(0, size_t(size), protection, MAP_SHARED, descriptor, 0);
+    if (memory == MAP_FAILED) {
+        memory = 0;
+        setErrorString(function, errno);
+        return false;
+    }
+    return true;
+}
+
+static int qt_create_anonymous_file()
+{
+#if defined(Q_OS_LINUX)
+    // a temporary file cannot be sealed, and would be refused by attach()
+#  if defined(SYS_memfd_create)
+    return int(::syscall(SYS_memfd_create, "QLocalSharedBuffer", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+#  else
+    errno = ENOSYS;
+    return -1;
+#  endif
+#else
+    // a temporary file that nobody else can open
+    QByteArray path = QFile::encodeName(QDir::tempPath() + QLatin1String("/qt_shared_buffer-XXXXXX"));
+    const int tmp = ::mkstemp(path.data());
+    if (tmp == -1)
+        return -1;
+    ::unlink(path.constData());
+    ::fcntl(tmp, F_SETFD, FD_CLOEXEC);
+    return tmp;
+#endif
+}
+#endif // Q_OS_UNIX
+
+/*!
+    Constructs a shared buffer that is not attached to any memory.
+
+    \sa create(), attach()
+*/
+QLocalSharedBuffer::QLocalSharedBuffer()
+    : d_ptr(new QLocalSharedBufferPrivate)
+{
+}
+
+/*!
+    Destroys the shared buffer, detaching from the memory. The memory itself
+    lives on for as long as another process or file descriptor refers to it.
+*/
+QLocalSharedBuffer::~QLocalSharedBuffer()
+{
+    detach();
+}
+
+/*!
+    Allocates \a size bytes of zero-initialized shared memory and attaches
+    to it for reading and writing. Any memory the buffer was attached to
+    before is detached first. Returns \c true on success; otherwise returns
+    \c false and sets errorString().
+
+    \sa attach(), fileDescriptor()
+*/
+bool QLocalSharedBuffer::create(qint64 size)
+{
+    Q_D(QLocalSharedBuffer);
+    detach();
+    const QString function = QLatin1String("QLocalSharedBuffer::create");
+    if (size <= 0) {
+        d->errorString = QCoreApplication::translate("QLocalSharedBuffer", "%1: size <= 0").arg(function);
+        return false;
+    }
+
+#ifdef Q_OS_UNIX
+    d->descriptor = qt_create_anonymous_file();
+    if (d->descriptor == -1) {
+        d->setErrorString(function, errno);
+        return false;
+    }
+    if (QT_FTRUNCATE(d->descriptor, size) == -1) {
+        d->setErrorString(function, errno);
+        detach();
+        return false;
+    }
+#ifdef Q_OS_LINUX
+    // keep receivers from being hit by SIGBUS should the file shrink
+    if (::fcntl(d->descriptor, F_ADD_SEALS, qt_shared_buffer_seals | F_SEAL_SEAL) == -1) {
+        d->setErrorString(function, errno);
+        detach();
+        return false;
+    }
+#endif
+
+    d->size = size;
+    d->mode = ReadWrite;
+    if (!d->map(function)) {
+        detach();
+        return false;
+    }
+    d->errorString.clear();
+    return true;
+#else
+    d->errorString = QCoreApplication::translate("QLocalSharedBuffer", "%1: not supported on this platform")
+            .arg(function);
+    return false;
+#endif
+}
+
+/*!
+    Attaches to the shared memory referred to by \a descriptor, which is
+    usually obtained from QLocalSocket::readFileDescriptor(), using the
+    access \a mode. Any memory the buffer was attached to before is detached
+    first. Returns \c true on success; otherwise returns \c false and sets
+    errorString().
+
+    On Linux, \a descriptor must refer to a \c memfd whose size is sealed,
+    as created by create(); other descriptors are refused, since the
+    process that sent them could shrink the file while it is mapped.
+
+    The buffer takes ownership of \a descriptor and closes it when
+    detaching, including when this function fails.
+
+    \sa create(), detach()
+*/
+bool QLocalSharedBuffer::attach(qintptr descriptor, AccessMode mode)
+{
+    Q_D(QLocalSharedBuffer);
+    detach();
+    const QString function = QLatin1String("QLocalSharedBuffer::attach");
+
+#ifdef Q_OS_UNIX
+    if (descriptor < 0) {
+        d->setErrorString(function, EBADF);
+        return false;
+    }
+    d->descriptor = int(descriptor);
+
+#ifdef Q_OS_LINUX
+    const int seals = ::fcntl(d->descriptor, F_GET_SEALS);
+    if (seals == -1 || (seals & qt_shared_buffer_seals) != qt_shared_buffer_seals) {
+        d->errorString = QCoreApplication::translate("QLocalSharedBuffer", "%1: the size of the buffer is not sealed")
+                .arg(function);
+        detach();
+        return false;
+    }
+#endif
+
+    QT_STATBUF st;
+    if (QT_FSTAT(d->descriptor, &st) == -1) {
+        d->setErrorString(function, errno);
+        detach();
+        return false;
+    }
+    if (st.st_size <= 0) {
+        d->errorString = QCoreApplication::translate("QLocalSharedBuffer", "%1: size <= 0").arg(function);
+        detach();
+        return false;
+    }
+
+    d->size = st.st_size;
+    d->mode = mode;
+    if (!d->map(function)) {
+        detach();
+        return false;
+    }
+    d->errorString.clear();
+    return true;
+#else
+    Q_UNUSED(descriptor);
+    Q_UNUSED(mode);
+    d->errorString = QCoreApplication::translate("QLocalSharedBuffer", "%1: not supported on this platform")
+            .arg(function);
+    return false;
+#endif
+}
+
+/*!
+    Returns \c true if the buffer is attached to shared memory; otherwise
+    returns \c false.
+
+    \sa create(), attach()
+*/
+bool QLocalSharedBuffer::isAttached() const
+{
+    Q_D(const QLocalSharedBuffer);
+    return d->memory != 0;
+}
+
+/*!
+    Unmaps the shared memory and closes the file descriptor. Pointers
+    returned by data() become invalid.
+*/
+void QLocalSharedBuffer::detach()
+{
+    Q_D(QLocalSharedBuffer);
+#ifdef Q_OS_UNIX
+    if (d->memory)
+        ::munmap(d->memory, size_t(d->size));
+    if (d->descriptor != -1)
+        qt_safe_close(d->descriptor);
+#endif
+    d->memory = 0;
+    d->descriptor = -1;
+    d->size = 0;
+}
+
+/*!
+    Returns the size of the shared memory in bytes, or 0 if the buffer is
+    not attached.
+*/
+qint64 QLocalSharedBuffer::size() const
+{
+    Q_D(const QLocalSharedBuffer);
+    return d->size;
+}
+
+/*!
+    Returns the file descriptor referring to the shared memory, or -1 if
+    the buffer is not attached. The descriptor remains owned by the buffer;
+    pass it to QLocalSocket::writeFileDescriptor() to share the memory with
+    another process.
+*/
+qintptr QLocalSharedBuffer::fileDescriptor() const
+{
+    Q_D(const QLocalSharedBuffer);
+    return d->descriptor;
+}
+
+/*!
+    Returns a pointer to the shared memory, or a null pointer if the buffer is not
+    attached.
+
+    \sa constData()
+*/
+void *QLocalSharedBuffer::data()
+{
+    Q_D(QLocalSharedBuffer);
+    return d->memory;
+}
+
+/*!
+    \overload
+*/
+const void *QLocalSharedBuffer::data() const
+{
+    Q_D(const QLocalSharedBuffer);
+    return d->memory;
+}
+
+/*!
+    Returns a const pointer to the shared memory, or a null pointer if the buffer
+    is not attached.
+
+    \sa data()
+*/
+const void *QLocalSharedBuffer::constData() const
+{
+    Q_D(const QLocalSharedBuffer);
+    return d->memory;
+}
+
+/*!
+    Returns a description of the last error that occurred, or an empty
+    string if the last operation succeeded.
+*/
+QString QLocalSharedBuffer::errorString() const
+{
+    Q_D(const QLocalSharedBuffer);
+    return d->errorString;
+}
+
+QT_END_NAMESPACE
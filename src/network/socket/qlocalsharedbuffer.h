@@ -0,0 +1,88 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QLOCALSHAREDBUFFER_H
+#define QLOCALSHAREDBUFFER_H
+
+#include <QtNetwork/qtnetworkglobal.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qstring.h>
+
+QT_REQUIRE_CONFIG(localserver);
+
+QT_BEGIN_NAMESPACE
+
+class QLocalSharedBufferPrivate;
+
+class Q_NETWORK_EXPORT QLocalSharedBuffer
+{
+public:
+    enum AccessMode
+    {
+        ReadOnly,
+        ReadWrite
+    };
+
+    QLocalSharedBuffer();
+    ~QLocalSharedBuffer();
+
+    bool create(qint64 size);
+    bool attach(qintptr descriptor, AccessMode mode = ReadWrite);
+    bool isAttached() const;
+    void detach();
+
+    qint64 size() const;
+    qintptr fileDescriptor() const;
+
+    void *data();
+    const void *constData() const;
+    const void *data() const;
+
+    QString errorString() const;
+
+private:
+    Q_DISABLE_COPY(QLocalSharedBuffer)
+    Q_DECLARE_PRIVATE(QLocalSharedBuffer)
+    QScopedPointer<QLocalSharedBufferPrivate> d_ptr;
+};
+
+QT_END_NAMESPACE
+
+#endif // QLOCALSHAREDBUFFER_H
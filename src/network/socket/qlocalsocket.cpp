@@ -144,6 +144,66 @@ QT_BEGIN_NAMESPACE
     \sa setSocketDescriptor()
 */
 
+/*!
+    \fn bool QLocalSocket::writeFileDescriptor(qintptr descriptor)
+    \since 5.11
+
+    Queues the file descriptor \a descriptor for passing to the peer. The
+    peer receives a new descriptor referring to the same open file, pipe,
+    socket or shared memory object. Returns \c true if the descriptor was
+    queued; otherwise returns \c false and emits error().
+
+    The descriptor is duplicated, so the caller may close its own copy as
+    soon as this function returns. It is sent along with the next byte
+    written to the socket, so at least one byte must be written after
+    calling this function; the peer can read the descriptor with
+    readFileDescriptor() once that byte has been received. This is usually
+    the first byte of a message describing what the descriptor is for:
+
+    \code
+    QLocalSharedBuffer frame;
+    frame.create(frameSize);
+    renderInto(frame.data());
+
+    QByteArray header;
+    QDataStream(&header, QIODevice::WriteOnly) << quint32(frameSize);
+    socket->writeFileDescriptor(frame.fileDescriptor());
+    socket->write(header);
+    \endcode
+
+    Passing descriptors is only supported for local domain sockets on Unix.
+    On other platforms this function fails with
+    UnsupportedSocketOperationError.
+
+    \sa readFileDescriptor(), QLocalSharedBuffer
+*/
+
+/*!
+    \fn qintptr QLocalSocket::readFileDescriptor()
+    \since 5.11
+
+    Returns the next file descriptor received from the peer, or -1 if none
+    is pending. Descriptors are returned in the order they were sent, and
+    each becomes available no later than the byte written after it by the
+    peer. The caller takes ownership of the descriptor and is responsible
+    for closing it.
+
+    Descriptors that are still pending when the socket is closed are
+    closed.
+
+    \sa hasPendingFileDescriptors(), writeFileDescriptor()
+*/
+
+/*!
+    \fn bool QLocalSocket::hasPendingFileDescriptors() const
+    \since 5.11
+
+    Returns \c true if at least one file descriptor received from the peer
+    is waiting to be read; otherwise returns \c false.
+
+    \sa readFileDescriptor()
+*/
+
 /*!
     \fn qint64 QLocalSocket::readData(char *data, qint64 c)
     \reimp
@@ -108,6 +108,10 @@ public:
                              OpenMode openMode = ReadWrite);
     qintptr socketDescriptor() const;
 
+    bool writeFileDescriptor(qintptr descriptor);
+    qintptr readFileDescriptor();
+    bool hasPendingFileDescriptors() const;
+
     LocalSocketState state() const;
     bool waitForBytesWritten(int msecs = 30000) Q_DECL_OVERRIDE;
     bool waitForConnected(int msecs = 30000);
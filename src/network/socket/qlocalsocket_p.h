@@ -68,6 +68,8 @@ QT_REQUIRE_CONFIG(localserver);
 #   include <qwineventnotifier.h>
 #else
 #   include "private/qabstractsocketengine_p.h"
+#   include "private/qabstractsocket_p.h"
+#   include "private/qnativesocketengine_p.h"
 #   include <qtcpsocket.h>
 #   include <qsocketnotifier.h>
 #   include <errno.h>
@@ -108,6 +110,13 @@ public:
     {
         return QTcpSocket::writeData(data, maxSize);
     }
+
+#if !defined(QT_LOCALSOCKET_TCP)
+    inline QAbstractSocketEngine *socketEngine() const
+    {
+        return static_cast<QAbstractSocketPrivate *>(d_ptr.data())->socketEngine;
+    }
+#endif
 };
 #endif //#if !defined(Q_OS_WIN) || defined(QT_LOCALSOCKET_TCP)
 
@@ -139,7 +148,9 @@ public:
     QWindowsPipeReader *pipeReader;
     QLocalSocket::LocalSocketError error;
 #else
+    QSocketDescriptorChannel descriptorChannel;
     QLocalUnixSocket unixSocket;
+    void attachDescriptorChannel();
     QString generateErrorString(QLocalSocket::LocalSocketError, const QString &function) const;
     void errorOccurred(QLocalSocket::LocalSocketError, const QString &function);
     void _q_stateChanged(QAbstractSocket::SocketState newState);
@@ -295,6 +295,26 @@ qintptr QLocalSocket::socketDescriptor() const
     return d->tcpSocket->socketDescriptor();
 }
 
+bool QLocalSocket::writeFileDescriptor(qintptr descriptor)
+{
+    Q_D(QLocalSocket);
+    Q_UNUSED(descriptor);
+    setErrorString(d->generateErrorString(QLocalSocket::UnsupportedSocketOperationError,
+                                          QLatin1String("QLocalSocket::writeFileDescriptor")));
+    emit error(QLocalSocket::UnsupportedSocketOperationError);
+    return false;
+}
+
+qintptr QLocalSocket::readFileDescriptor()
+{
+    return -1;
+}
+
+bool QLocalSocket::hasPendingFileDescriptors() const
+{
+    return false;
+}
+
 qint64 QLocalSocket::readData(char *data, qint64 c)
 {
     Q_D(QLocalSocket);
@@ -328,6 +328,7 @@ void QLocalSocketPrivate::_q_connectToSocket()
     fullServerName = connectingPathName;
     if (unixSocket.setSocketDescriptor(connectingSocket,
         QAbstractSocket::ConnectedState, connectingOpenMode)) {
+        attachDescriptorChannel();
         q->QIODevice::open(connectingOpenMode | QIODevice::Unbuffered);
         q->emit connected();
     } else {
@@ -360,8 +361,22 @@ bool QLocalSocket::setSocketDescriptor(qintptr socketDescriptor,
     }
     QIODevice::open(openMode);
     d->state = socketState;
-    return d->unixSocket.setSocketDescriptor(socketDescriptor,
-                                             newSocketState, openMode);
+    if (!d->unixSocket.setSocketDescriptor(socketDescriptor, newSocketState, openMode))
+        return false;
+    d->attachDescriptorChannel();
+    return true;
+}
+
+/*!
+    \internal
+
+    Starts passing file descriptors over the newly set up socket.
+  */
+void QLocalSocketPrivate::attachDescriptorChannel()
+{
+    descriptorChannel.clear();
+    if (QNativeSocketEngine *engine = qobject_cast<QNativeSocketEngine *>(unixSocket.socketEngine()))
+        engine->setDescriptorChannel(&descriptorChannel);
 }
 
 void QLocalSocketPrivate::_q_abortConnectionAttempt()
@@ -388,6 +403,46 @@ qintptr QLocalSocket::socketDescriptor() const
     return d->unixSocket.socketDescriptor();
 }
 
+bool QLocalSocket::writeFileDescriptor(qintptr descriptor)
+{
+    Q_D(QLocalSocket);
+    const QLatin1String function("QLocalSocket::writeFileDescriptor");
+    if (state() != ConnectedState || !(openMode() & WriteOnly)) {
+        d->unixSocket.setSocketError(QAbstractSocket::OperationError);
+        setErrorString(d->generateErrorString(QLocalSocket::OperationError, function));
+        emit error(QLocalSocket::OperationError);
+        return false;
+    }
+
+    const int duplicate = qt_safe_dup(descriptor);
+    if (duplicate == -1) {
+        d->unixSocket.setSocketError(QAbstractSocket::SocketResourceError);
+        setErrorString(d->generateErrorString(QLocalSocket::SocketResourceError, function));
+        emit error(QLocalSocket::SocketResourceError);
+        return false;
+    }
+
+    QSocketDescriptorChannel::PendingDescriptor pending;
+    pending.offset = d->descriptorChannel.bytesSent + d->unixSocket.bytesToWrite();
+    pending.descriptor = duplicate;
+    d->descriptorChannel.outgoing.append(pending);
+    return true;
+}
+
+qintptr QLocalSocket::readFileDescriptor()
+{
+    Q_D(QLocalSocket);
+    if (d->descriptorChannel.incoming.isEmpty())
+        return -1;
+    return d->descriptorChannel.incoming.takeFirst();
+}
+
+bool QLocalSocket::hasPendingFileDescriptors() const
+{
+    Q_D(const QLocalSocket);
+    return !d->descriptorChannel.incoming.isEmpty();
+}
+
 qint64 QLocalSocket::readData(char *data, qint64 c)
 {
     Q_D(QLocalSocket);
@@ -428,6 +483,7 @@ void QLocalSocket::close()
 {
     Q_D(QLocalSocket);
     d->unixSocket.close();
+    d->descriptorChannel.clear();
     d->cancelDelayedConnect();
     if (d->connectingSocket != -1)
         ::close(d->connectingSocket);
@@ -481,6 +537,8 @@ QLocalSocket::LocalSocketError QLocalSocket::error() const
         return QLocalSocket::UnsupportedSocketOperationError;
     case QAbstractSocket::UnknownSocketError:
         return QLocalSocket::UnknownSocketError;
+    case QAbstractSocket::OperationError:
+        return QLocalSocket::OperationError;
     default:
 #if defined QLOCALSOCKET_DEBUG
         qWarning() << "QLocalSocket error not handled:" << d->unixSocket.error();
@@ -374,6 +374,27 @@ qintptr QLocalSocket::socketDescriptor() const
     return (qintptr)d->handle;
 }
 
+bool QLocalSocket::writeFileDescriptor(qintptr descriptor)
+{
+    Q_D(QLocalSocket);
+    Q_UNUSED(descriptor);
+    d->error = QLocalSocket::UnsupportedSocketOperationError;
+    setErrorString(tr("%1: The socket operation is not supported")
+                   .arg(QLatin1String("QLocalSocket::writeFileDescriptor")));
+    emit error(d->error);
+    return false;
+}
+
+qintptr QLocalSocket::readFileDescriptor()
+{
+    return -1;
+}
+
+bool QLocalSocket::hasPendingFileDescriptors() const
+{
+    return false;
+}
+
 qint64 QLocalSocket::readBufferSize() const
 {
     Q_D(const QLocalSocket);
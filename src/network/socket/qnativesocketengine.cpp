@@ -194,6 +194,9 @@ QNativeSocketEnginePrivate::QNativeSocketEnginePrivate() :
     readNotifier(0),
     writeNotifier(0),
     exceptNotifier(0)
+#ifdef Q_OS_UNIX
+    , descriptorChannel(0)
+#endif
 {
 #if defined(Q_OS_WIN) && !defined(Q_OS_WINRT)
     QSysInfo::machineHostName();        // this initializes ws2_32.dll
@@ -1381,4 +1384,20 @@ void QNativeSocketEngine::setExceptionNotificationEnabled(bool enable)
     }
 }
 
+#ifdef Q_OS_UNIX
+/*!
+    \internal
+
+    Makes the engine send the descriptors queued in \a channel along with
+    the data written, and collect the descriptors received along with the
+    data read into it. Only meaningful for local domain sockets. Passing
+    a null pointer stops passing descriptors.
+*/
+void QNativeSocketEngine::setDescriptorChannel(QSocketDescriptorChannel *channel)
+{
+    Q_D(QNativeSocketEngine);
+    d->descriptorChannel = channel;
+}
+#endif
+
 QT_END_NAMESPACE
@@ -56,6 +56,7 @@
 #include "QtNetwork/qhostaddress.h"
 #include "QtNetwork/qnetworkinterface.h"
 #include "private/qabstractsocketengine_p.h"
+#include <QtCore/qvector.h>
 #ifndef Q_OS_WIN
 #  include "qplatformdefs.h"
 #  include <netinet/in.h>
@@ -116,6 +117,34 @@ namespace SetSALen {
 }
 }
 
+#ifdef Q_OS_UNIX
+// File descriptors passed as SCM_RIGHTS ancillary data alongside the byte
+// stream of a local domain socket. The channel is owned by QLocalSocket;
+// the engine only fills and drains it.
+class QSocketDescriptorChannel
+{
+public:
+    struct PendingDescriptor
+    {
+        qint64 offset;      // stream position of the byte the descriptor travels with
+        int descriptor;     // duplicate owned by the channel
+    };
+
+    QSocketDescriptorChannel() : bytesSent(0) {}
+    ~QSocketDescriptorChannel() { clear(); }
+
+    void clear();
+
+    QVector<PendingDescriptor> outgoing;
+    QVector<int> incoming;
+    qint64 bytesSent;
+
+private:
+    Q_DISABLE_COPY(QSocketDescriptorChannel)
+};
+Q_DECLARE_TYPEINFO(QSocketDescriptorChannel::PendingDescriptor, Q_PRIMITIVE_TYPE);
+#endif
+
 class QNativeSocketEnginePrivate;
 #ifndef QT_NO_NETWORKINTERFACE
 class QNetworkInterface;
@@ -190,6 +219,10 @@ public:
     bool isExceptionNotificationEnabled() const Q_DECL_OVERRIDE;
     void setExceptionNotificationEnabled(bool enable) Q_DECL_OVERRIDE;
 
+#ifdef Q_OS_UNIX
+    void setDescriptorChannel(QSocketDescriptorChannel *channel);
+#endif
+
 public Q_SLOTS:
     // non-virtual override;
     void connectionNotification();
@@ -212,6 +245,10 @@ public:
 
     QSocketNotifier *readNotifier, *writeNotifier, *exceptNotifier;
 
+#ifdef Q_OS_UNIX
+    QSocketDescriptorChannel *descriptorChannel;
+#endif
+
 #if defined(Q_OS_WIN)
     LPFN_WSASENDMSG sendmsg;
     LPFN_WSARECVMSG recvmsg;
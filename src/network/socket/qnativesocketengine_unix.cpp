@@ -1296,12 +1296,159 @@ void QNativeSocketEnginePrivate::nativeClose()
     qt_safe_close(socketDescriptor);
 }
 
+#if defined(SCM_MAX_FD)
+enum { MaxDescriptorsPerMessage = SCM_MAX_FD };
+#else
+enum { MaxDescriptorsPerMessage = 253 };  // Linux's SCM_MAX_FD
+#endif
+
+void QSocketDescriptorChannel::clear()
+{
+    for (const PendingDescriptor &pending : qAsConst(outgoing))
+        qt_safe_close(pending.descriptor);
+    for (int descriptor : qAsConst(incoming))
+        qt_safe_close(descriptor);
+    outgoing.clear();
+    incoming.clear();
+    bytesSent = 0;
+}
+
+/*
+    Writes one segment of \a data, attaching the descriptors that travel
+    with the next byte of the stream. The segment stops short of the next
+    byte that has descriptors of its own, so each batch is received no
+    later than the byte it was queued for.
+*/
+static ssize_t qt_write_segment_with_descriptors(int socketDescriptor, QSocketDescriptorChannel *channel,
+                                                 const char *data, qint64 len)
+{
+    QVector<QSocketDescriptorChannel::PendingDescriptor> &outgoing = channel->outgoing;
+    if (outgoing.isEmpty())
+        return qt_safe_write_nosignal(socketDescriptor, data, len);
+    const qint64 nextOffset = outgoing.constFirst().offset;
+    if (nextOffset > channel->bytesSent)
+        return qt_safe_write_nosignal(socketDescriptor, data, qMin(len, nextOffset - channel->bytesSent));
+
+    int count = 0;
+    while (count < outgoing.size() && count < MaxDescriptorsPerMessage
+           && outgoing.at(count).offset <= channel->bytesSent) {
+        ++count;
+    }
+    if (count < outgoing.size())
+        len = qMin(len, qMax(outgoing.at(count).offset - channel->bytesSent, qint64(1)));
+
+    // we use quintptr to force the alignment
+    quintptr cbuf[(CMSG_SPACE(MaxDescriptorsPerMessage * sizeof(int)) + sizeof(quintptr) - 1)
+                  / sizeof(quintptr)];
+    struct msghdr msg;
+    struct iovec vec;
+    memset(&msg, 0, sizeof(msg));
+    vec.iov_base = const_cast<char *>(data);
+    vec.iov_len = len;
+    msg.msg_iov = &vec;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cbuf;
+    msg.msg_controllen = CMSG_SPACE(count * sizeof(int));
+    memset(cbuf, 0, msg.msg_controllen);
+
+    struct cmsghdr *cmsgptr = CMSG_FIRSTHDR(&msg);
+    cmsgptr->cmsg_level = SOL_SOCKET;
+    cmsgptr->cmsg_type = SCM_RIGHTS;
+    cmsgptr->cmsg_len = CMSG_LEN(count * sizeof(int));
+    int *descriptors = reinterpret_cast<int *>(CMSG_DATA(cmsgptr));
+    for (int i = 0; i < count; ++i)
+        descriptors[i] = outgoing.at(i).descriptor;
+
+    const ssize_t writtenBytes = qt_safe_sendmsg(socketDescriptor, &msg, 0);
+    if (writtenBytes > 0) {
+        // the peer holds its own references now
+        for (int i = 0; i < count; ++i)
+            qt_safe_close(outgoing.at(i).descriptor);
+        outgoing.remove(0, count);
+    }
+    return writtenBytes;
+}
+
+/*
+    Writes as much of \a data as the socket accepts, one segment per batch
+    of descriptors.
+*/
+static ssize_t qt_write_with_descriptors(int socketDescriptor, QSocketDescriptorChannel *channel,
+                                         const char *data, qint64 len)
+{
+    ssize_t totalWritten = 0;
+    while (totalWritten < len) {
+        const ssize_t written = qt_write_segment_with_descriptors(socketDescriptor, channel,
+                                                                  data + totalWritten,
+                                                                  len - totalWritten);
+        if (written <= 0)
+            return totalWritten ? totalWritten : written;
+        channel->bytesSent += written;
+        totalWritten += written;
+    }
+    return totalWritten;
+}
+
+/*
+    Reads into \a data like read(), collecting any descriptors that
+    arrive along with it.
+*/
+static ssize_t qt_read_with_descriptors(int socketDescriptor, QSocketDescriptorChannel *channel,
+                                        char *data, qint64 maxSize)
+{
+    // we use quintptr to force the alignment
+    quintptr cbuf[(CMSG_SPACE(MaxDescriptorsPerMessage * sizeof(int)) + sizeof(quintptr) - 1)
+                  / sizeof(quintptr)];
+    struct msghdr msg;
+    struct iovec vec;
+    memset(&msg, 0, sizeof(msg));
+    vec.iov_base = data;
+    vec.iov_len = maxSize;
+    msg.msg_iov = &vec;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cbuf;
+    msg.msg_controllen = sizeof(cbuf);
+
+    int flags = 0;
+#ifdef MSG_CMSG_CLOEXEC
+    flags |= MSG_CMSG_CLOEXEC;
+#endif
+    const ssize_t r = qt_safe_recvmsg(socketDescriptor, &msg, flags);
+    if (r < 0)
+        return r;
+
+    for (struct cmsghdr *cmsgptr = CMSG_FIRSTHDR(&msg); cmsgptr != NULL;
+         cmsgptr = CMSG_NXTHDR(&msg, cmsgptr)) {
+        if (cmsgptr->cmsg_level != SOL_SOCKET || cmsgptr->cmsg_type != SCM_RIGHTS)
+            continue;
+        const int count = (cmsgptr->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        const uchar *descriptors = CMSG_DATA(cmsgptr);
+        for (int i = 0; i < count; ++i) {
+            int descriptor;
+            memcpy(&descriptor, descriptors + i * sizeof(int), sizeof(int));
+#ifndef MSG_CMSG_CLOEXEC
+            ::fcntl(descriptor, F_SETFD, FD_CLOEXEC);
+#endif
+            channel->incoming.append(descriptor);
+        }
+    }
+    if (msg.msg_flags & MSG_CTRUNC)
+        qWarning("QLocalSocket: file descriptors received from the peer were discarded");
+    return r;
+}
+
 qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
 {
     Q_Q(QNativeSocketEngine);
 
     ssize_t writtenBytes;
-    writtenBytes = qt_safe_write_nosignal(socketDescriptor, data, len);
+    if (descriptorChannel && !descriptorChannel->outgoing.isEmpty()) {
+        writtenBytes = qt_write_with_descriptors(socketDescriptor, descriptorChannel, data, len);
+    } else {
+        writtenBytes = qt_safe_write_nosignal(socketDescriptor, data, len);
+        if (writtenBytes > 0 && descriptorChannel)
+            descriptorChannel->bytesSent += writtenBytes;
+    }
 
     if (writtenBytes < 0) {
         switch (errno) {
@@ -1341,7 +1488,10 @@ qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxSize)
     }
 
     ssize_t r = 0;
-    r = qt_safe_read(socketDescriptor, data, maxSize);
+    if (descriptorChannel)
+        r = qt_read_with_descriptors(socketDescriptor, descriptorChannel, data, maxSize);
+    else
+        r = qt_safe_read(socketDescriptor, data, maxSize);
 
     if (r < 0) {
         r = -1;
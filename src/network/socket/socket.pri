@@ -64,9 +64,11 @@ qtConfig(localserver) {
     HEADERS += socket/qlocalserver.h \
                socket/qlocalserver_p.h \
                socket/qlocalsocket.h \
-               socket/qlocalsocket_p.h
+               socket/qlocalsocket_p.h \
+               socket/qlocalsharedbuffer.h
     SOURCES += socket/qlocalsocket.cpp \
-               socket/qlocalserver.cpp
+               socket/qlocalserver.cpp \
+               socket/qlocalsharedbuffer.cpp
 
     intergrity|winrt {
         SOURCES += socket/qlocalsocket_tcp.cpp \
@@ -176,6 +176,21 @@ Q_LOGGING_CATEGORY(lcSsl, "qt.network.ssl");
     chosen based on the servers preferences rather than the order ciphers were
     sent by the client. This option is only relevant to server sockets, and is
     only honored by the OpenSSL backend.
+    \value SslOptionEnableKernelTls Hands the encryption of outgoing data over
+    to the operating system kernel once the handshake has completed, so that
+    written data is not encrypted and copied in user space. This is only
+    supported by the OpenSSL backend on Linux, for TLS 1.2 connections and
+    client-side TLS 1.3 connections using an AES-GCM cipher; in all other
+    cases, or when the kernel lacks TLS support, the data is encrypted as
+    usual. Such connections cannot be renegotiated. This option was introduced
+    in Qt 5.11.
+    \value SslOptionEnableServerSessionCache Lets clients resume their
+    session on any server socket of the process that has this option set,
+    not only on the connection that established it. All such server sockets
+    share their session ticket keys; sockets with a different local
+    certificate still cannot resume each other's sessions. This option is
+    only relevant to server sockets, and is only honored by the OpenSSL
+    backend. This option was introduced in Qt 5.11.
 
     By default, SslOptionDisableEmptyFragments is turned on since this causes
     problems with a large number of servers. SslOptionDisableLegacyRenegotiation
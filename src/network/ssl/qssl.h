@@ -102,7 +102,9 @@ namespace QSsl {
         SslOptionDisableLegacyRenegotiation = 0x10,
         SslOptionDisableSessionSharing = 0x20,
         SslOptionDisableSessionPersistence = 0x40,
-        SslOptionDisableServerCipherPreference = 0x80
+        SslOptionDisableServerCipherPreference = 0x80,
+        SslOptionEnableKernelTls = 0x100,
+        SslOptionEnableServerSessionCache = 0x200
     };
     Q_DECLARE_FLAGS(SslOptions, SslOption)
 }
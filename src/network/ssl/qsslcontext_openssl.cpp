@@ -44,11 +44,26 @@
 
 #include "private/qssl_p.h"
 #include "private/qsslcontext_openssl_p.h"
+#include "private/qsslsessioncache_p.h"
 #include "private/qsslsocket_openssl_p.h"
 #include "private/qsslsocket_openssl_symbols_p.h"
 
+#include <QtCore/qcryptographichash.h>
+
 QT_BEGIN_NAMESPACE
 
+#if OPENSSL_VERSION_NUMBER >= 0x10001000L
+extern "C" {
+static int q_ssl_new_session_callback(SSL *ssl, SSL_SESSION *session)
+{
+    QSslSocketBackendPrivate *d = reinterpret_cast<QSslSocketBackendPrivate *>(q_SSL_get_ex_data(ssl, QSslSocketBackendPrivate::s_indexForSSLExtraData));
+    if (d)
+        d->storeSession(session);
+    return 0; // we did not keep a reference to the session
+}
+} // extern "C"
+#endif
+
 QSslContext::QSslContext()
     : ctx(0),
     pkey(0),
@@ -74,6 +89,8 @@ QSslContext* QSslContext::fromConfiguration(QSslSocket::SslMode mode, const QSsl
 {
     QSslContext *sslContext = new QSslContext();
     initSslContext(sslContext, mode, configuration, allowRootCertOnDemandLoading);
+    if (sslContext->errorCode == QSslError::NoError)
+        sslContext->setupSessionCache(mode);
     return sslContext;
 }
 
@@ -81,9 +98,61 @@ QSharedPointer<QSslContext> QSslContext::sharedFromConfiguration(QSslSocket::Ssl
 {
     QSharedPointer<QSslContext> sslContext = QSharedPointer<QSslContext>::create();
     initSslContext(sslContext.data(), mode, configuration, allowRootCertOnDemandLoading);
+    if (sslContext->errorCode == QSslError::NoError)
+        sslContext->setupSessionCache(mode);
     return sslContext;
 }
 
+// Hooks the context up to the process wide QSslSessionCache. Client contexts
+// report every new session, so that later connections to the same peer can
+// resume it. Server contexts with SslOptionEnableServerSessionCache share
+// one set of session ticket keys, since each server socket has a context of its own
+// and could not decrypt the tickets issued by the others otherwise.
+void QSslContext::setupSessionCache(QSslSocket::SslMode mode)
+{
+    if (sslConfiguration.testSslOption(QSsl::SslOptionDisableSessionSharing))
+        return;
+
+    if (mode == QSslSocket::SslClientMode) {
+#if OPENSSL_VERSION_NUMBER >= 0x10001000L
+        if (QSslSocket::sslLibraryVersionNumber() >= 0x10001000L) {
+            q_SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT);
+            q_SSL_CTX_sess_set_new_cb(ctx, q_ssl_new_session_callback);
+        }
+#endif
+        return;
+    }
+
+    if (!sslConfiguration.testSslOption(QSsl::SslOptionEnableServerSessionCache))
+        return;
+
+    // Sessions may only be resumed by a server with the same identity.
+    // OpenSSL also refuses to resume sessions of verified peers without
+    // a session id context.
+    const QSslCertificate localCertificate = sslConfiguration.localCertificate();
+    const QByteArray idContext = localCertificate.isNull()
+            ? QByteArrayLiteral("QSslSocket")
+            : QCryptographicHash::hash(localCertificate.toDer(), QCryptographicHash::Sha256);
+    Q_STATIC_ASSERT(SSL_MAX_SID_CTX_LENGTH >= 32);
+    if (!q_SSL_CTX_set_session_id_context(ctx, reinterpret_cast<const unsigned char *>(idContext.constData()),
+                                          idContext.size())) {
+        qCWarning(lcSsl, "could not set the SSL session id context");
+        return;
+    }
+
+#ifdef SSL_CTRL_GET_TLSEXT_TICKET_KEYS
+    // without a buffer, OpenSSL tells the size of the keys, which depends
+    // on its version
+    const long size = q_SSL_CTX_ctrl(ctx, SSL_CTRL_GET_TLSEXT_TICKET_KEYS, 0, 0);
+    QByteArray keys(int(qMax(size, 0L)), Qt::Uninitialized);
+    if (keys.isEmpty() || q_SSL_CTX_ctrl(ctx, SSL_CTRL_GET_TLSEXT_TICKET_KEYS, size, keys.data()) != 1)
+        return;
+    keys = QSslSessionCache::instance()->serverTicketKeys(keys);
+    if (q_SSL_CTX_ctrl(ctx, SSL_CTRL_SET_TLSEXT_TICKET_KEYS, size, keys.data()) != 1)
+        qCWarning(lcSsl, "could not set the SSL session ticket keys");
+#endif
+}
+
 #if OPENSSL_VERSION_NUMBER >= 0x1000100fL && !defined(OPENSSL_NO_NEXTPROTONEG)
 
 static int next_proto_cb(SSL *, unsigned char **out, unsigned char *outlen,
@@ -57,6 +57,9 @@ QT_BEGIN_NAMESPACE
 
 // defined in qsslsocket_openssl.cpp:
 extern int q_X509Callback(int ok, X509_STORE_CTX *ctx);
+#ifdef QT_SSL_KERNEL_TLS
+extern void q_ssl_keylog_callback(const SSL *ssl, const char *line);
+#endif
 extern QString getErrorsFromOpenSsl();
 
 static inline QString msgErrorSettingEllipticCurves(const QString &why)
@@ -250,6 +253,12 @@ init_context:
         q_DH_free(dh);
     }
 
+#ifdef QT_SSL_KERNEL_TLS
+    // TLS 1.3 traffic secrets are only available through the key log.
+    if (client && configuration.testSslOption(QSsl::SslOptionEnableKernelTls))
+        q_SSL_CTX_set_keylog_callback(sslContext->ctx, q_ssl_keylog_callback);
+#endif
+
 #ifndef OPENSSL_NO_PSK
     if (!client)
         q_SSL_CTX_use_psk_identity_hint(sslContext->ctx, sslContext->sslConfiguration.preSharedKeyIdentityHint().constData());
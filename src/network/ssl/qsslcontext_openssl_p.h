@@ -107,6 +107,7 @@ protected:
 private:
     static void initSslContext(QSslContext* sslContext, QSslSocket::SslMode mode, const QSslConfiguration &configuration,
                                bool allowRootCertOnDemandLoading);
+    void setupSessionCache(QSslSocket::SslMode mode);
 
 private:
     SSL_CTX* ctx;
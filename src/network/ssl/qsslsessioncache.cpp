@@ -0,0 +1,234 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsslsessioncache_p.h"
+
+#include <QtNetwork/qsslcertificate.h>
+#include <QtNetwork/qsslconfiguration.h>
+#include <QtCore/qcryptographichash.h>
+
+QT_BEGIN_NAMESPACE
+
+Q_GLOBAL_STATIC(QSslSessionCache, globalSessionCache)
+
+// used when the peer gives no lifetime hint for its session ticket; the
+// session timeout OpenSSL servers use by default
+static const int defaultMaxAge = 300; // seconds
+
+/*!
+    \class QSslSessionCache
+    \internal
+    \inmodule QtNetwork
+
+    \brief The QSslSessionCache class keeps the TLS sessions of client
+    connections, so that later connections to the same peer can resume them.
+
+    Client sockets look up a session by host, port, peer verification name,
+    local certificate and the certificates they trust when they start
+    encrypting. They store the session the peer hands out only if the
+    handshake verified the peer without any error, ignored or not: a
+    resumed session is not verified again, so a session of a socket that
+    skipped or ignored verification must not be resumed by one that would
+    have rejected the peer. The cache is bounded by maxEntries(), least
+    recently used sessions are dropped first, and sessions are dropped once
+    the lifetime the peer gave for them has passed.
+
+    Server sockets with QSsl::SslOptionEnableServerSessionCache encrypt
+    their session tickets with the same keys, so that a client can
+    resume its session on any connection to the server, not only on the
+    one that issued the ticket.
+
+    All functions are thread-safe.
+*/
+
+QSslSessionCache::QSslSessionCache()
+    : cache(256)
+{
+}
+
+QSslSessionCache *QSslSessionCache::instance()
+{
+    return globalSessionCache();
+}
+
+/*!
+    Returns the key of the sessions a client socket connecting to \a host
+    on \a port can resume. The session also depends on the name the peer
+    certificate is verified against, \a peerName, and on the local
+    certificate, CA certificates and verification depth of \a configuration.
+    \a systemCaCertificates tells whether the system CA certificates are
+    loaded on demand in addition. A socket thus never resumes a session that
+    was established under a different identity, or whose peer was verified
+    against certificates the socket does not trust.
+*/
+QString QSslSessionCache::key(const QString &host, quint16 port, const QString &peerName,
+                              const QSslConfiguration &configuration, bool systemCaCertificates)
+{
+    QString key = host.toLower() + QLatin1Char(':') + QString::number(port)
+            + QLatin1Char('/') + peerName.toLower();
+    const QSslCertificate localCertificate = configuration.localCertificate();
+    if (!localCertificate.isNull()) {
+        key += QLatin1Char('/')
+            + QLatin1String(localCertificate.digest(QCryptographicHash::Sha256).toHex());
+    }
+
+    QCryptographicHash trust(QCryptographicHash::Sha256);
+    const QList<QSslCertificate> caCertificates = configuration.caCertificates();
+    for (const QSslCertificate &certificate : caCertificates)
+        trust.addData(certificate.toDer());
+    key += QLatin1Char('/') + QLatin1String(trust.result().toHex())
+        + QLatin1Char(systemCaCertificates ? 's' : '-')
+        + QString::number(configuration.peerVerifyDepth());
+    return key;
+}
+
+/*!
+    Returns the serialized session stored for \a key, or an empty byte
+    array if there is none or it has expired.
+*/
+QByteArray QSslSessionCache::session(const QString &key)
+{
+    QMutexLocker locker(&mutex);
+    ++stats.clientLookups;
+    Element *element = cache.object(key);
+    if (!element)
+        return QByteArray();
+    if (element->age.hasExpired(element->maxAge)) {
+        cache.remove(key);
+        return QByteArray();
+    }
+    ++stats.clientHits;
+    return element->session;
+}
+
+/*!
+    Stores the serialized \a session for \a key, replacing any earlier one.
+    The session is dropped after \a lifeTimeHint seconds, or after five
+    minutes if \a lifeTimeHint is not positive.
+*/
+void QSslSessionCache::insert(const QString &key, const QByteArray &session, int lifeTimeHint)
+{
+    if (session.isEmpty())
+        return;
+
+    Element *element = new Element;
+    element->session = session;
+    element->age.start();
+    element->maxAge = qint64(lifeTimeHint > 0 ? lifeTimeHint : defaultMaxAge) * 1000;
+
+    QMutexLocker locker(&mutex);
+    cache.insert(key, element); // cache will take ownership
+}
+
+void QSslSessionCache::remove(const QString &key)
+{
+    QMutexLocker locker(&mutex);
+    cache.remove(key);
+}
+
+void QSslSessionCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    cache.clear();
+}
+
+int QSslSessionCache::count() const
+{
+    QMutexLocker locker(&mutex);
+    return cache.count();
+}
+
+int QSslSessionCache::maxEntries() const
+{
+    QMutexLocker locker(&mutex);
+    return cache.maxCost();
+}
+
+void QSslSessionCache::setMaxEntries(int entries)
+{
+    QMutexLocker locker(&mutex);
+    cache.setMaxCost(qMax(entries, 0));
+}
+
+/*!
+    Returns the keys all server sockets encrypt their session tickets with.
+    The first server socket that asks provides them: \a keys are the random
+    keys of its own SSL context.
+*/
+QByteArray QSslSessionCache::serverTicketKeys(const QByteArray &keys)
+{
+    QMutexLocker locker(&mutex);
+    if (ticketKeys.isEmpty())
+        ticketKeys = keys;
+    return ticketKeys.size() == keys.size() ? ticketKeys : keys;
+}
+
+/*!
+    Counts a completed handshake of a client socket if \a client is \c true,
+    or of a server socket otherwise. \a resumed tells whether an earlier
+    session was resumed.
+*/
+void QSslSessionCache::recordHandshake(bool client, bool resumed)
+{
+    QMutexLocker locker(&mutex);
+    if (client) {
+        ++stats.clientHandshakes;
+        if (resumed)
+            ++stats.clientResumptions;
+    } else {
+        ++stats.serverHandshakes;
+        if (resumed)
+            ++stats.serverResumptions;
+    }
+}
+
+QSslSessionCache::Statistics QSslSessionCache::statistics() const
+{
+    QMutexLocker locker(&mutex);
+    return stats;
+}
+
+void QSslSessionCache::resetStatistics()
+{
+    QMutexLocker locker(&mutex);
+    stats = Statistics();
+}
+
+QT_END_NAMESPACE
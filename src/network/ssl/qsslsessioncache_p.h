@@ -0,0 +1,132 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSSLSESSIONCACHE_P_H
+#define QSSLSESSIONCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the QSslSocket backends.  This header file may change from version
+// to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qstring.h>
+
+QT_BEGIN_NAMESPACE
+
+#ifndef QT_NO_SSL
+
+class QSslConfiguration;
+
+// Process wide store of the TLS sessions of client sockets, so that a new
+// connection to a peer can resume the session of an earlier one instead of
+// doing a full handshake. Sessions are kept serialized, so that a session
+// established with one SSL context can be handed to another one. Only
+// sessions of connections that verified their peer are stored, and only
+// sockets that verify the peer the same way can resume them, since a
+// resumed session skips certificate verification.
+class Q_NETWORK_EXPORT QSslSessionCache
+{
+public:
+    struct Statistics
+    {
+        Statistics()
+            : clientLookups(0), clientHits(0), clientHandshakes(0), clientResumptions(0),
+              serverHandshakes(0), serverResumptions(0)
+        {}
+
+        qint64 clientLookups;      // new client connections that asked for a session
+        qint64 clientHits;         // ... and were offered one
+        qint64 clientHandshakes;
+        qint64 clientResumptions;  // handshakes the peer accepted a session for
+        qint64 serverHandshakes;
+        qint64 serverResumptions;
+    };
+
+    QSslSessionCache();
+
+    static QSslSessionCache *instance();
+    static QString key(const QString &host, quint16 port, const QString &peerName,
+                       const QSslConfiguration &configuration, bool systemCaCertificates);
+
+    QByteArray session(const QString &key);
+    void insert(const QString &key, const QByteArray &session, int lifeTimeHint);
+    void remove(const QString &key);
+    void clear();
+    int count() const;
+
+    int maxEntries() const;
+    void setMaxEntries(int entries);
+
+    QByteArray serverTicketKeys(const QByteArray &keys);
+
+    void recordHandshake(bool client, bool resumed);
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    struct Element
+    {
+        QByteArray session;
+        QElapsedTimer age;
+        qint64 maxAge; // ms
+    };
+
+    mutable QMutex mutex;
+    QCache<QString, Element> cache;
+    QByteArray ticketKeys;
+    Statistics stats;
+};
+
+#endif // QT_NO_SSL
+
+QT_END_NAMESPACE
+
+#endif // QSSLSESSIONCACHE_P_H
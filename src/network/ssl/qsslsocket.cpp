@@ -214,6 +214,31 @@
     \sa QSslSocket::peerVerifyMode()
 */
 
+/*!
+    \enum QSslSocket::SessionCacheCounter
+    \since 5.11
+
+    Names the counters of the process wide TLS session cache, see
+    sessionCacheCounter().
+
+    \value ClientSessionLookups The number of client sockets that looked up
+    a session to resume when they started encrypting.
+
+    \value ClientSessionHits The number of those lookups that found a session.
+
+    \value ClientHandshakes The number of completed client handshakes.
+
+    \value ClientResumedHandshakes The number of client handshakes in which
+    the server accepted the session that was offered.
+
+    \value ServerHandshakes The number of completed server handshakes.
+
+    \value ServerResumedHandshakes The number of server handshakes that
+    resumed an earlier session.
+
+    \sa QSsl::SslOptionEnableServerSessionCache
+*/
+
 /*!
     \fn QSslSocket::encrypted()
 
@@ -322,6 +347,7 @@
 #include "qsslsocket_mac_p.h"
 #endif
 #include "qsslconfiguration_p.h"
+#include "qsslsessioncache_p.h"
 
 #include <QtCore/qdebug.h>
 #include <QtCore/qdir.h>
@@ -1790,6 +1816,54 @@ QString QSslSocket::sslLibraryBuildVersionString()
     return QSslSocketPrivate::sslLibraryBuildVersionString();
 }
 
+/*!
+    \since 5.11
+
+    Returns the value of \a counter. The counters cover all QSslSocket
+    objects of the process since it started, or since the last call to
+    resetSessionCacheCounters(). Comparing ClientResumedHandshakes with
+    ClientHandshakes, for example, tells how many connections got away
+    without a full handshake.
+
+    Client sockets share their TLS sessions unless
+    QSsl::SslOptionDisableSessionSharing is set, and server sockets do so
+    with QSsl::SslOptionEnableServerSessionCache. The counters are only
+    maintained by the OpenSSL backend; with other backends they stay 0.
+
+    \sa resetSessionCacheCounters()
+*/
+qint64 QSslSocket::sessionCacheCounter(SessionCacheCounter counter)
+{
+    const QSslSessionCache::Statistics statistics = QSslSessionCache::instance()->statistics();
+    switch (counter) {
+    case ClientSessionLookups:
+        return statistics.clientLookups;
+    case ClientSessionHits:
+        return statistics.clientHits;
+    case ClientHandshakes:
+        return statistics.clientHandshakes;
+    case ClientResumedHandshakes:
+        return statistics.clientResumptions;
+    case ServerHandshakes:
+        return statistics.serverHandshakes;
+    case ServerResumedHandshakes:
+        return statistics.serverResumptions;
+    }
+    return 0;
+}
+
+/*!
+    \since 5.11
+
+    Sets all session cache counters to 0.
+
+    \sa sessionCacheCounter()
+*/
+void QSslSocket::resetSessionCacheCounters()
+{
+    QSslSessionCache::instance()->resetStatistics();
+}
+
 /*!
     Starts a delayed SSL handshake for a client connection. This
     function can be called when the socket is in the \l ConnectedState
@@ -2044,6 +2118,7 @@ QSslSocketPrivate::QSslSocketPrivate()
     , autoStartHandshake(false)
     , connectionEncrypted(false)
     , shutdown(false)
+    , kernelTlsTransmit(false)
     , ignoreAllSslErrors(false)
     , readyReadEmittedPointer(0)
     , allowRootCertOnDemandLoading(true)
@@ -2316,6 +2391,7 @@ void QSslSocketPrivate::createPlainSocket(QIODevice::OpenMode openMode)
     buffer.clear();
     writeBuffer.clear();
     connectionEncrypted = false;
+    kernelTlsTransmit = false;
     configuration.peerCertificate.clear();
     configuration.peerCertificateChain.clear();
     mode = QSslSocket::UnencryptedMode;
@@ -2713,6 +2789,18 @@ QSharedPointer<QSslContext> QSslSocketPrivate::sslContext(QSslSocket *socket)
     return (socket) ? socket->d_func()->sslContextPointer : QSharedPointer<QSslContext>();
 }
 
+/*!
+    \internal
+
+    Returns \c true if the kernel encrypts the data written to the underlying
+    socket of \a socket, so that it can be written to the socket descriptor
+    directly once bytesToWrite() and encryptedBytesToWrite() are zero.
+*/
+bool QSslSocketPrivate::hasKernelTlsTransmit(QSslSocket *socket)
+{
+    return socket && socket->d_func()->kernelTlsTransmit;
+}
+
 bool QSslSocketPrivate::isMatchingHostname(const QSslCertificate &cert, const QString &peerName)
 {
     const QString lowerPeerName = QString::fromLatin1(QUrl::toAce(peerName));
@@ -79,6 +79,15 @@ public:
         AutoVerifyPeer
     };
 
+    enum SessionCacheCounter {
+        ClientSessionLookups,
+        ClientSessionHits,
+        ClientHandshakes,
+        ClientResumedHandshakes,
+        ServerHandshakes,
+        ServerResumedHandshakes
+    };
+
     explicit QSslSocket(QObject *parent = Q_NULLPTR);
     ~QSslSocket();
     void resume() Q_DECL_OVERRIDE; // to continue after proxy authentication required, SSL errors etc.
@@ -193,6 +202,9 @@ public:
     static long sslLibraryBuildVersionNumber();
     static QString sslLibraryBuildVersionString();
 
+    static qint64 sessionCacheCounter(SessionCacheCounter counter);
+    static void resetSessionCacheCounters();
+
     void ignoreSslErrors(const QList<QSslError> &errors);
 
 public Q_SLOTS:
@@ -65,6 +65,7 @@
 #include "qsslellipticcurve.h"
 #include "qsslpresharedkeyauthenticator.h"
 #include "qsslpresharedkeyauthenticator_p.h"
+#include "qsslsessioncache_p.h"
 
 #include <QtCore/qdatetime.h>
 #include <QtCore/qdebug.h>
@@ -80,6 +81,20 @@
 
 #include <string.h>
 
+#ifdef QT_SSL_KERNEL_TLS
+#include "private/qnativesocketengine_p.h"
+#include <QtCore/qmessageauthenticationcode.h>
+#include <QtCore/private/qcore_unix_p.h>
+#include <linux/tls.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#endif
+
 QT_BEGIN_NAMESPACE
 
 #if defined(Q_OS_WIN)
@@ -137,7 +152,12 @@ QSslSocketBackendPrivate::QSslSocketBackendPrivate()
     : ssl(0),
       readBio(0),
       writeBio(0),
-      session(0)
+      session(0),
+      pendingSessionLifeTimeHint(0),
+      sessionVerified(false)
+#ifdef QT_SSL_KERNEL_TLS
+    , kernelTlsPending(false)
+#endif
 {
     // Calls SSL_library_init().
     ensureInitialized();
@@ -207,6 +227,22 @@ struct QSslErrorList
 
 Q_GLOBAL_STATIC(QSslErrorList, _q_sslErrorList)
 
+#ifdef QT_SSL_KERNEL_TLS
+void q_ssl_keylog_callback(const SSL *ssl, const char *line)
+{
+    static const char label[] = "CLIENT_TRAFFIC_SECRET_0 ";
+    if (qstrncmp(line, label, sizeof(label) - 1) != 0)
+        return;
+    QSslSocketBackendPrivate *d = reinterpret_cast<QSslSocketBackendPrivate *>(
+        q_SSL_get_ex_data(ssl, QSslSocketBackendPrivate::s_indexForSSLExtraData));
+    if (!d)
+        return;
+    // <label> <client random> <secret>, in hex
+    const QByteArray fields(line + sizeof(label) - 1);
+    d->kernelTlsSecret = QByteArray::fromHex(fields.mid(fields.indexOf(' ') + 1));
+}
+#endif
+
 int q_X509Callback(int ok, X509_STORE_CTX *ctx)
 {
     if (!ok) {
@@ -340,6 +376,9 @@ bool QSslSocketBackendPrivate::initSslContext()
         }
     }
 
+    if (mode == QSslSocket::SslClientMode)
+        resumeCachedSession();
+
     // Clear the session.
     errorList.clear();
 
@@ -381,6 +420,10 @@ bool QSslSocketBackendPrivate::initSslContext()
 
 void QSslSocketBackendPrivate::destroySslContext()
 {
+#ifdef QT_SSL_KERNEL_TLS
+    kernelTlsPending = false;
+    kernelTlsSecret.clear();
+#endif
     if (ssl) {
         q_SSL_free(ssl);
         ssl = 0;
@@ -388,6 +431,350 @@ void QSslSocketBackendPrivate::destroySslContext()
     sslContextPointer.clear();
 }
 
+/*!
+    \internal
+
+    Offers the peer the session of an earlier connection to it, unless the
+    SSL context already brought one along (e.g. one set by the user, or
+    the one shared by the channels of a QHttpNetworkConnection).
+*/
+void QSslSocketBackendPrivate::resumeCachedSession()
+{
+    Q_Q(QSslSocket);
+    sessionCacheKey.clear();
+    pendingSession.clear();
+    sessionVerified = false;
+#if OPENSSL_VERSION_NUMBER >= 0x10001000L
+    // new sessions are stored from an OpenSSL callback that needs to find
+    // this object through the extra data of the SSL structure
+    if (QSslSocket::sslLibraryVersionNumber() < 0x10001000L
+            || (configuration.sslOptions & QSsl::SslOptionDisableSessionSharing)) {
+        return;
+    }
+
+    // a resumed session skips certificate verification, so only sockets
+    // that would verify the peer the same way may share it
+    if (configuration.peerVerifyMode == QSslSocket::VerifyNone
+            || configuration.peerVerifyMode == QSslSocket::QueryPeer) {
+        return;
+    }
+    sessionCacheKey = QSslSessionCache::key(hostName.isEmpty() ? q->peerName() : hostName,
+                                            q->peerPort(), verificationPeerName,
+                                            q->sslConfiguration(), allowRootCertOnDemandLoading
+                                                && s_loadRootCertsOnDemand);
+    if (q_SSL_get_session(ssl))
+        return;
+
+    const QByteArray asn1 = QSslSessionCache::instance()->session(sessionCacheKey);
+    if (asn1.isEmpty())
+        return;
+    const unsigned char *data = reinterpret_cast<const unsigned char *>(asn1.constData());
+    if (SSL_SESSION *session = q_d2i_SSL_SESSION(0, &data, asn1.size())) {
+        if (!q_SSL_set_session(ssl, session))
+            qCWarning(lcSsl, "could not set cached SSL session");
+        q_SSL_SESSION_free(session); // SSL_set_session took its own reference
+    }
+#endif
+}
+
+/*!
+    \internal
+
+    Called by OpenSSL whenever the peer hands out a new \a session, i.e.
+    after a full handshake and, with TLS 1.3, whenever a session ticket
+    arrives. Stores it for later connections to the same peer.
+*/
+void QSslSocketBackendPrivate::storeSession(SSL_SESSION *session)
+{
+    if (sessionCacheKey.isEmpty())
+        return;
+
+    const int size = q_i2d_SSL_SESSION(session, 0);
+    if (size <= 0)
+        return;
+    QByteArray asn1(size, Qt::Uninitialized);
+    unsigned char *data = reinterpret_cast<unsigned char *>(asn1.data());
+    if (q_i2d_SSL_SESSION(session, &data) != size)
+        return;
+    const int lifeTimeHint = int(q_SSL_SESSION_get_ticket_lifetime_hint(session));
+    if (!sessionVerified) {
+        // the errors of the handshake are not known yet
+        pendingSession = asn1;
+        pendingSessionLifeTimeHint = lifeTimeHint;
+        return;
+    }
+    QSslSessionCache::instance()->insert(sessionCacheKey, asn1, lifeTimeHint);
+}
+
+/*!
+    \internal
+
+    Called once the handshake has completed. Stores the session the peer
+    handed out during the handshake, provided the peer was verified without
+    any error; if errors were found, even ignored ones, neither it nor the
+    sessions that arrive later are shared.
+*/
+void QSslSocketBackendPrivate::storePendingSession()
+{
+    if (sessionCacheKey.isEmpty())
+        return;
+    if (!sslErrors.isEmpty() || mode != QSslSocket::SslClientMode) {
+        sessionCacheKey.clear();
+    } else {
+        sessionVerified = true;
+        if (!pendingSession.isEmpty()) {
+            QSslSessionCache::instance()->insert(sessionCacheKey, pendingSession,
+                                                 pendingSessionLifeTimeHint);
+        }
+    }
+    pendingSession.clear();
+}
+
+#ifdef QT_SSL_KERNEL_TLS
+// The TLS 1.2 pseudorandom function, see RFC 5246, section 5.
+static QByteArray tls12Prf(QCryptographicHash::Algorithm method, const QByteArray &secret,
+                           const QByteArray &label, const QByteArray &seed, int length)
+{
+    const QByteArray labelAndSeed = label + seed;
+    QMessageAuthenticationCode hmac(method, secret);
+    QByteArray result;
+    QByteArray a = labelAndSeed;
+    while (result.size() < length) {
+        hmac.reset();
+        hmac.addData(a);
+        a = hmac.result();
+        hmac.reset();
+        hmac.addData(a);
+        hmac.addData(labelAndSeed);
+        result += hmac.result();
+    }
+    result.truncate(length);
+    return result;
+}
+
+// HKDF-Expand-Label with an empty context, see RFC 8446, section 7.1. The
+// lengths needed here never exceed one block of the hash.
+static QByteArray tls13ExpandLabel(QCryptographicHash::Algorithm method, const QByteArray &secret,
+                                   const QByteArray &label, int length)
+{
+    QByteArray info;
+    info += char(length >> 8);
+    info += char(length & 0xff);
+    info += char(6 + label.size());
+    info += "tls13 ";
+    info += label;
+    info += char(0);
+    info += char(1);
+    return QMessageAuthenticationCode::hash(info, secret, method).left(length);
+}
+
+/*!
+    \internal
+
+    Called when the handshake has completed. If QSsl::SslOptionEnableKernelTls
+    is set and the kernel can take over the encryption of the negotiated
+    cipher, the data written from now on is held back until the handshake
+    records have left the socket; see enableKernelTls().
+
+    Only AES-GCM is handled, and with TLS 1.3 only on the client side: a
+    TLS 1.3 server writes session tickets after the handshake, which would
+    leave the sequence number of the next record unknown. Once the kernel
+    took over, OpenSSL must not write any records of its own anymore.
+*/
+void QSslSocketBackendPrivate::prepareKernelTls()
+{
+    Q_Q(QSslSocket);
+    kernelTlsPending = false;
+    if (!(configuration.sslOptions & QSsl::SslOptionEnableKernelTls))
+        return;
+
+    const QString cipher = sessionCipher().name();
+    switch (q_SSL_version(ssl)) {
+    case 0x303: // TLS 1.2
+        if (!cipher.endsWith(QLatin1String("AES128-GCM-SHA256"))
+            && !cipher.endsWith(QLatin1String("AES256-GCM-SHA384"))) {
+            return;
+        }
+        break;
+#ifdef TLS_1_3_VERSION
+    case 0x304: // TLS 1.3
+        if (mode != QSslSocket::SslClientMode || kernelTlsSecret.isEmpty()
+            || (cipher != QLatin1String("TLS_AES_128_GCM_SHA256")
+                && cipher != QLatin1String("TLS_AES_256_GCM_SHA384"))) {
+            return;
+        }
+        break;
+#endif
+    default:
+        return;
+    }
+
+    // The bytes written to plainSocket have to go to its descriptor unchanged,
+    // which is not the case for proxied connections.
+    QAbstractSocketPrivate *plainSocketPrivate =
+        static_cast<QAbstractSocketPrivate *>(QObjectPrivate::get(plainSocket));
+    if (!qobject_cast<QNativeSocketEngine *>(plainSocketPrivate->socketEngine))
+        return;
+
+    kernelTlsPending = true;
+    // Retries once plainSocket got rid of the handshake records; queued, as
+    // plainSocket does not report the bytes written from its bytesWritten().
+    QObject::connect(plainSocket, SIGNAL(bytesWritten(qint64)),
+                     q, SLOT(_q_flushWriteBuffer()), Qt::QueuedConnection);
+}
+
+/*!
+    \internal
+
+    Installs the write key of the connection into the kernel, once the
+    records OpenSSL encrypted have all been written to the socket. If the
+    kernel lacks TLS support, the data is encrypted by OpenSSL as before.
+*/
+void QSslSocketBackendPrivate::enableKernelTls()
+{
+    Q_Q(QSslSocket);
+    if (q_BIO_pending(writeBio) > 0 || plainSocket->bytesToWrite() > 0)
+        return;
+
+    kernelTlsPending = false;
+    QObject::disconnect(plainSocket, SIGNAL(bytesWritten(qint64)),
+                        q, SLOT(_q_flushWriteBuffer()));
+
+    const bool tls13 = q_SSL_version(ssl) == 0x304;
+    const bool aes256 = sessionCipher().name().endsWith(QLatin1String("SHA384"));
+    const QCryptographicHash::Algorithm method = aes256 ? QCryptographicHash::Sha384
+                                                        : QCryptographicHash::Sha256;
+    const int keyLength = aes256 ? TLS_CIPHER_AES_GCM_256_KEY_SIZE : TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+    const int saltLength = TLS_CIPHER_AES_GCM_128_SALT_SIZE;
+    const int ivLength = TLS_CIPHER_AES_GCM_128_IV_SIZE;
+
+    // The record sequence number, and with TLS 1.2 the explicit nonce, which
+    // only has to be unique; the kernel counts both up from here.
+    unsigned char sequenceNumber[TLS_CIPHER_AES_GCM_128_REC_SEQ_SIZE] = {};
+    QByteArray key;
+    QByteArray salt;
+    QByteArray iv;
+    if (tls13) {
+        // No record has been written with the application traffic keys yet.
+        key = tls13ExpandLabel(method, kernelTlsSecret, QByteArrayLiteral("key"), keyLength);
+        const QByteArray nonce = tls13ExpandLabel(method, kernelTlsSecret, QByteArrayLiteral("iv"),
+                                                  saltLength + ivLength);
+        salt = nonce.left(saltLength);
+        iv = nonce.mid(saltLength);
+        kernelTlsSecret.fill(0);
+    } else {
+        SSL_SESSION *session = q_SSL_get_session(ssl);
+        if (!session)
+            return;
+        QByteArray masterKey(int(q_SSL_SESSION_get_master_key(session, 0, 0)), Qt::Uninitialized);
+        q_SSL_SESSION_get_master_key(session, reinterpret_cast<unsigned char *>(masterKey.data()),
+                                     masterKey.size());
+        QByteArray clientRandom(int(q_SSL_get_client_random(ssl, 0, 0)), Qt::Uninitialized);
+        q_SSL_get_client_random(ssl, reinterpret_cast<unsigned char *>(clientRandom.data()),
+                                clientRandom.size());
+        QByteArray serverRandom(int(q_SSL_get_server_random(ssl, 0, 0)), Qt::Uninitialized);
+        q_SSL_get_server_random(ssl, reinterpret_cast<unsigned char *>(serverRandom.data()),
+                                serverRandom.size());
+
+        // RFC 5246, section 6.3: AEAD ciphers have no MAC keys, the key block holds
+        // the client and server write keys followed by their 4-byte implicit nonces.
+        QByteArray keyBlock = tls12Prf(method, masterKey, QByteArrayLiteral("key expansion"),
+                                       serverRandom + clientRandom, 2 * (keyLength + saltLength));
+        masterKey.fill(0);
+        const bool client = mode == QSslSocket::SslClientMode;
+        key = keyBlock.mid(client ? 0 : keyLength, keyLength);
+        salt = keyBlock.mid(2 * keyLength + (client ? 0 : saltLength), saltLength);
+        keyBlock.fill(0);
+
+        // The Finished message was record 0 under these keys.
+        sequenceNumber[sizeof(sequenceNumber) - 1] = 1;
+        iv = QByteArray(reinterpret_cast<const char *>(sequenceNumber), sizeof(sequenceNumber));
+    }
+
+    union {
+        tls12_crypto_info_aes_gcm_128 aes128;
+        tls12_crypto_info_aes_gcm_256 aes256;
+    } cryptoInfo;
+    memset(&cryptoInfo, 0, sizeof(cryptoInfo));
+    socklen_t cryptoInfoSize;
+#ifdef TLS_1_3_VERSION
+    const unsigned short version = tls13 ? TLS_1_3_VERSION : TLS_1_2_VERSION;
+#else
+    const unsigned short version = TLS_1_2_VERSION;
+#endif
+    if (aes256) {
+        cryptoInfo.aes256.info.version = version;
+        cryptoInfo.aes256.info.cipher_type = TLS_CIPHER_AES_GCM_256;
+        memcpy(cryptoInfo.aes256.key, key.constData(), keyLength);
+        memcpy(cryptoInfo.aes256.salt, salt.constData(), saltLength);
+        memcpy(cryptoInfo.aes256.iv, iv.constData(), ivLength);
+        memcpy(cryptoInfo.aes256.rec_seq, sequenceNumber, sizeof(sequenceNumber));
+        cryptoInfoSize = sizeof(cryptoInfo.aes256);
+    } else {
+        cryptoInfo.aes128.info.version = version;
+        cryptoInfo.aes128.info.cipher_type = TLS_CIPHER_AES_GCM_128;
+        memcpy(cryptoInfo.aes128.key, key.constData(), keyLength);
+        memcpy(cryptoInfo.aes128.salt, salt.constData(), saltLength);
+        memcpy(cryptoInfo.aes128.iv, iv.constData(), ivLength);
+        memcpy(cryptoInfo.aes128.rec_seq, sequenceNumber, sizeof(sequenceNumber));
+        cryptoInfoSize = sizeof(cryptoInfo.aes128);
+    }
+    key.fill(0);
+
+    const int socketDescriptor = int(plainSocket->socketDescriptor());
+    if (::setsockopt(socketDescriptor, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) == -1) {
+#ifdef QSSLSOCKET_DEBUG
+        qCDebug(lcSsl) << "QSslSocketBackendPrivate::enableKernelTls: no kernel TLS support:"
+                       << qt_error_string(errno);
+#endif
+    } else if (::setsockopt(socketDescriptor, SOL_TLS, TLS_TX, &cryptoInfo, cryptoInfoSize) == -1) {
+        // Without TLS_TX the attached tls module passes the data through unchanged.
+#ifdef QSSLSOCKET_DEBUG
+        qCDebug(lcSsl) << "QSslSocketBackendPrivate::enableKernelTls: cipher not supported:"
+                       << qt_error_string(errno);
+#endif
+    } else {
+        kernelTlsTransmit = true;
+    }
+    memset(&cryptoInfo, 0, sizeof(cryptoInfo));
+}
+
+/*!
+    \internal
+
+    Sends the close_notify alert in a record encrypted by the kernel, once
+    the data written before has left plainSocket. Returns \c false while
+    that data is still queued.
+*/
+bool QSslSocketBackendPrivate::sendKernelTlsCloseNotify()
+{
+    plainSocket->flush();
+    if (plainSocket->bytesToWrite() > 0)
+        return false;
+
+    char alert[2] = { 1, 0 }; // warning, close_notify
+    iovec vector = { alert, sizeof(alert) };
+    char control[CMSG_SPACE(sizeof(unsigned char))];
+    memset(control, 0, sizeof(control));
+    msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    cmsghdr *header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_TLS;
+    header->cmsg_type = TLS_SET_RECORD_TYPE;
+    header->cmsg_len = CMSG_LEN(sizeof(unsigned char));
+    *CMSG_DATA(header) = 21; // alert record
+
+    ssize_t sent;
+    EINTR_LOOP(sent, ::sendmsg(int(plainSocket->socketDescriptor()), &message, MSG_NOSIGNAL));
+    Q_UNUSED(sent); // the connection is going away either way
+    return true;
+}
+#endif // QT_SSL_KERNEL_TLS
+
 /*!
     \internal
 
@@ -628,7 +1015,27 @@ void QSslSocketBackendPrivate::transmit()
         if (connectionEncrypted && !writeBuffer.isEmpty()) {
             qint64 totalBytesWritten = 0;
             int nextDataBlockSize;
+#ifdef QT_SSL_KERNEL_TLS
+            if (kernelTlsPending)
+                enableKernelTls();
+#endif
             while ((nextDataBlockSize = writeBuffer.nextDataBlockSize()) > 0) {
+#ifdef QT_SSL_KERNEL_TLS
+                // Hold the data back until the kernel either took over or declined.
+                if (kernelTlsPending)
+                    break;
+                if (kernelTlsTransmit) {
+                    const qint64 writtenBytes = plainSocket->write(writeBuffer.readPointer(),
+                                                                   nextDataBlockSize);
+                    if (writtenBytes < 0) {
+                        setErrorAndEmit(plainSocket->error(), plainSocket->errorString());
+                        return;
+                    }
+                    writeBuffer.free(writtenBytes);
+                    totalBytesWritten += writtenBytes;
+                    continue;
+                }
+#endif
                 int writtenBytes = q_SSL_write(ssl, writeBuffer.readPointer(), nextDataBlockSize);
                 if (writtenBytes <= 0) {
                     int error = q_SSL_get_error(ssl, writtenBytes);
@@ -675,6 +1082,15 @@ void QSslSocketBackendPrivate::transmit()
         // Check if we've got any data to be written to the socket.
         QVarLengthArray<char, 4096> data;
         int pendingBytes;
+#ifdef QT_SSL_KERNEL_TLS
+        if (kernelTlsTransmit && q_BIO_pending(writeBio) > 0) {
+            // OpenSSL's records cannot follow the ones encrypted by the kernel,
+            // so the connection cannot be renegotiated.
+            setErrorAndEmit(QAbstractSocket::SslInternalError,
+                            QSslSocket::tr("Cannot renegotiate a connection encrypted by the kernel"));
+            return;
+        }
+#endif
         while (plainSocket->isValid() && (pendingBytes = q_BIO_pending(writeBio)) > 0) {
             // Read encrypted data from the write BIO into a buffer.
             data.resize(pendingBytes);
@@ -1291,7 +1707,13 @@ void QSslSocketBackendPrivate::disconnectFromHost()
 {
     if (ssl) {
         if (!shutdown) {
-            q_SSL_shutdown(ssl);
+#ifdef QT_SSL_KERNEL_TLS
+            // Called again from _q_bytesWrittenSlot() while the data is still queued.
+            if (kernelTlsTransmit && !sendKernelTlsCloseNotify())
+                return;
+#endif
+            if (!kernelTlsTransmit)
+                q_SSL_shutdown(ssl);
             shutdown = true;
             transmit();
         }
@@ -61,6 +61,7 @@
 #include "qsslsocket_openssl_symbols_p.h"
 #include "qsslsocket.h"
 #include "qsslkey.h"
+#include "qsslsessioncache_p.h"
 
 #include <QtCore/qdebug.h>
 #include <QtCore/qdir.h>
@@ -193,8 +194,11 @@ void QSslSocketBackendPrivate::continueHandshake()
     if (readBufferMaxSize)
         plainSocket->setReadBufferSize(readBufferMaxSize);
 
-    if (q_SSL_session_reused(ssl))
+    const bool resumed = q_SSL_session_reused(ssl);
+    if (resumed)
         configuration.peerSessionShared = true;
+    QSslSessionCache::instance()->recordHandshake(mode == QSslSocket::SslClientMode, resumed);
+    storePendingSession();
 
 #ifdef QT_DECRYPT_SSL_TRAFFIC
     if (q_SSL_get_session(ssl)) {
@@ -274,6 +278,10 @@ void QSslSocketBackendPrivate::continueHandshake()
             configuration.ephemeralServerKey = QSslKey(key, QSsl::PublicKey);
     }
 
+#ifdef QT_SSL_KERNEL_TLS
+    prepareKernelTls();
+#endif
+
     connectionEncrypted = true;
     emit q->encrypted();
     if (autoStartHandshake && pendingClose) {
@@ -94,6 +94,9 @@ int q_SSL_session_reused(SSL *a);
 unsigned long q_SSL_CTX_set_options(SSL_CTX *ctx, unsigned long op);
 int q_OPENSSL_init_ssl(uint64_t opts, const OPENSSL_INIT_SETTINGS *settings);
 size_t q_SSL_get_client_random(SSL *a, unsigned char *out, size_t outlen);
+size_t q_SSL_get_server_random(const SSL *a, unsigned char *out, size_t outlen);
+typedef void (*q_keylog_callback_t)(const SSL *, const char *);
+void q_SSL_CTX_set_keylog_callback(SSL_CTX *a, q_keylog_callback_t b);
 size_t q_SSL_SESSION_get_master_key(const SSL_SESSION *session, unsigned char *out, size_t outlen);
 int q_CRYPTO_get_ex_new_index(int class_index, long argl, void *argp, CRYPTO_EX_new *new_func, CRYPTO_EX_dup *dup_func, CRYPTO_EX_free *free_func);
 const SSL_METHOD *q_TLS_method();
@@ -102,6 +102,10 @@
 #include <openssl/dh.h>
 #endif
 
+#if defined(Q_OS_LINUX) && QT_CONFIG(opensslv11) && QT_HAS_INCLUDE(<linux/tls.h>)
+#define QT_SSL_KERNEL_TLS
+#endif
+
 QT_BEGIN_NAMESPACE
 
 struct QSslErrorEntry {
@@ -131,6 +135,24 @@ public:
     static int s_indexForSSLExtraData; // index used in SSL_get_ex_data to get the matching QSslSocketBackendPrivate
 #endif
 
+    // Sharing sessions with other connections to the same peer
+    void resumeCachedSession();
+    void storeSession(SSL_SESSION *session);
+    void storePendingSession();
+    QString sessionCacheKey;
+    QByteArray pendingSession; // arrived before the peer was verified
+    int pendingSessionLifeTimeHint;
+    bool sessionVerified;
+
+#ifdef QT_SSL_KERNEL_TLS
+    // Handing the encryption of outgoing records over to the kernel (kTLS)
+    void prepareKernelTls();
+    void enableKernelTls();
+    bool sendKernelTlsCloseNotify();
+    bool kernelTlsPending;
+    QByteArray kernelTlsSecret; // the TLS 1.3 client application traffic secret
+#endif
+
     // Platform specific functions
     void startClientEncryption() Q_DECL_OVERRIDE;
     void startServerEncryption() Q_DECL_OVERRIDE;
@@ -60,6 +60,7 @@
 #include "qsslsocket_openssl_symbols_p.h"
 #include "qsslsocket.h"
 #include "qsslkey.h"
+#include "qsslsessioncache_p.h"
 
 #include <QtCore/qdebug.h>
 #include <QtCore/qdir.h>
@@ -322,8 +323,11 @@ void QSslSocketBackendPrivate::continueHandshake()
     if (readBufferMaxSize)
         plainSocket->setReadBufferSize(readBufferMaxSize);
 
-    if (q_SSL_ctrl((ssl), SSL_CTRL_GET_SESSION_REUSED, 0, NULL))
+    const bool resumed = q_SSL_ctrl((ssl), SSL_CTRL_GET_SESSION_REUSED, 0, NULL);
+    if (resumed)
         configuration.peerSessionShared = true;
+    QSslSessionCache::instance()->recordHandshake(mode == QSslSocket::SslClientMode, resumed);
+    storePendingSession();
 
 #ifdef QT_DECRYPT_SSL_TRAFFIC
     if (ssl->session && ssl->s3) {
@@ -111,6 +111,7 @@ public:
     bool autoStartHandshake;
     bool connectionEncrypted;
     bool shutdown;
+    bool kernelTlsTransmit; // the kernel encrypts what is written to plainSocket
     bool ignoreAllSslErrors;
     QList<QSslError> ignoreErrorsList;
     bool* readyReadEmittedPointer;
@@ -169,6 +170,7 @@ public:
     // ### The 2 methods below should be made member methods once the QSslContext class is made public
     static void checkSettingSslContext(QSslSocket*, QSharedPointer<QSslContext>);
     static QSharedPointer<QSslContext> sslContext(QSslSocket *socket);
+    static bool hasKernelTlsTransmit(QSslSocket *socket);
     bool isPaused() const;
     bool bind(const QHostAddress &address, quint16, QAbstractSocket::BindMode) Q_DECL_OVERRIDE;
     void _q_connectedSlot();
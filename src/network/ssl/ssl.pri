@@ -19,6 +19,7 @@ qtConfig(ssl) {
                ssl/qsslsocket_p.h \
                ssl/qsslpresharedkeyauthenticator.h \
                ssl/qsslpresharedkeyauthenticator_p.h \
+               ssl/qsslsessioncache_p.h \
                ssl/qsslcertificateextension.h \
                ssl/qsslcertificateextension_p.h
     SOURCES += ssl/qasn1element.cpp \
@@ -32,6 +33,7 @@ qtConfig(ssl) {
                ssl/qsslerror.cpp \
                ssl/qsslsocket.cpp \
                ssl/qsslpresharedkeyauthenticator.cpp \
+               ssl/qsslsessioncache.cpp \
                ssl/qsslcertificateextension.cpp
 
     winrt {
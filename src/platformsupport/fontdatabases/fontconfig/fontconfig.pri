@@ -1,6 +1,8 @@
 HEADERS += $$PWD/qfontconfigdatabase_p.h \
+           $$PWD/qfontconfigcache_p.h \
            $$PWD/qfontenginemultifontconfig_p.h
 SOURCES += $$PWD/qfontconfigdatabase.cpp \
+           $$PWD/qfontconfigcache.cpp \
            $$PWD/qfontenginemultifontconfig.cpp
 
 QMAKE_USE_PRIVATE += fontconfig
@@ -0,0 +1,315 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qfontconfigcache_p.h"
+
+#include <qplatformdefs.h>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+#include <fontconfig/fontconfig.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+ * QFontconfigCache stores the fonts that QFontconfigDatabase registers at
+ * startup, so that later runs can skip FcFontList() and the evaluation of
+ * every font pattern. The file holds an index of family names and aliases,
+ * followed by the font records of each family. Loading maps the file and
+ * reads just the index; the records of a family are only read when the
+ * family is populated.
+ *
+ * The file is tagged with a fingerprint of the fontconfig configuration:
+ * the fontconfig version and the modification times of all font
+ * directories and configuration files. Any change to these makes the
+ * cache stale, and it is rebuilt on the next start.
+ */
+
+static const quint32 cacheMagic = 0x51464343; // 'QFCC'
+static const quint32 cacheVersion = 1;
+
+static QDataStream &operator<<(QDataStream &stream, const QFontconfigCache::Font &font)
+{
+    stream << font.familyName << font.styleName << font.foundryName
+           << qint32(font.weight) << qint32(font.style) << qint32(font.stretch)
+           << font.antialiased << font.scalable << font.pixelSize << font.fixedPitch
+           << font.writingSystems << font.fileName << qint32(font.indexValue);
+    return stream;
+}
+
+static QDataStream &operator>>(QDataStream &stream, QFontconfigCache::Font &font)
+{
+    qint32 weight, style, stretch, indexValue;
+    stream >> font.familyName >> font.styleName >> font.foundryName
+           >> weight >> style >> stretch
+           >> font.antialiased >> font.scalable >> font.pixelSize >> font.fixedPitch
+           >> font.writingSystems >> font.fileName >> indexValue;
+    font.weight = weight;
+    font.style = style;
+    font.stretch = stretch;
+    font.indexValue = indexValue;
+    return stream;
+}
+
+QFontconfigCache::QFontconfigCache()
+    : m_data(0), m_size(0)
+{
+}
+
+QFontconfigCache::~QFontconfigCache()
+{
+}
+
+/*
+ * The cache can be turned off by setting QT_NO_FONTCONFIG_CACHE.
+ */
+bool QFontconfigCache::isEnabled()
+{
+    return qEnvironmentVariableIsEmpty("QT_NO_FONTCONFIG_CACHE");
+}
+
+QString QFontconfigCache::defaultFileName()
+{
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    if (dir.isEmpty())
+        return QString();
+    return dir + QLatin1String("/qtfontconfig/fontdatabase.cache");
+}
+
+static void addStrListToHash(QCryptographicHash *hash, FcStrList *list)
+{
+    if (!list)
+        return;
+    while (const FcChar8 *entry = FcStrListNext(list)) {
+        const char *path = reinterpret_cast<const char *>(entry);
+        QT_STATBUF st;
+        const qint64 modified = QT_STAT(path, &st) == 0 ? qint64(st.st_mtime) : -1;
+        hash->addData(path, int(qstrlen(path)) + 1);
+        hash->addData(reinterpret_cast<const char *>(&modified), sizeof(modified));
+    }
+    FcStrListDone(list);
+}
+
+/*
+ * Returns a hash of everything the population result depends on. Must be
+ * called after FcInit(). Since fontconfig rescans a directory when its
+ * modification time changes, this follows the same rules as fontconfig's
+ * own cache files.
+ */
+QByteArray QFontconfigCache::fingerprint()
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    const int versions[] = { QT_VERSION, FcGetVersion() };
+    hash.addData(reinterpret_cast<const char *>(versions), sizeof(versions));
+
+    addStrListToHash(&hash, FcConfigGetFontDirs(0));
+    addStrListToHash(&hash, FcConfigGetConfigFiles(0));
+
+    return hash.result();
+}
+
+/*
+ * Maps fileName and reads its index. Returns false if the file does not
+ * exist, is corrupt, or was written for a different fingerprint.
+ */
+bool QFontconfigCache::load(const QString &fileName, const QByteArray &fingerprint)
+{
+    if (fileName.isEmpty())
+        return false;
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return false;
+
+    m_size = m_file.size();
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        m_file.close();
+        return false;
+    }
+
+    const QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char *>(m_data), int(m_size));
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_5_10);
+
+    quint32 magic = 0, version = 0;
+    QByteArray storedFingerprint;
+    stream >> magic >> version;
+    if (magic != cacheMagic || version != cacheVersion)
+        return false;
+    stream >> storedFingerprint;
+    if (storedFingerprint != fingerprint)
+        return false;
+
+    quint32 familyCount = 0;
+    stream >> familyCount;
+    for (quint32 i = 0; i < familyCount && stream.status() == QDataStream::Ok; ++i) {
+        Family family;
+        stream >> family.name >> family.offset >> family.count;
+        m_families.insert(family.name.toCaseFolded(), family);
+        m_familyOrder.append(family.name);
+    }
+
+    quint32 aliasCount = 0;
+    stream >> aliasCount;
+    for (quint32 i = 0; i < aliasCount && stream.status() == QDataStream::Ok; ++i) {
+        QPair<QString, QString> alias;
+        stream >> alias.first >> alias.second;
+        m_aliases.append(alias);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        m_families.clear();
+        m_familyOrder.clear();
+        m_aliases.clear();
+        return false;
+    }
+
+    // make the record offsets absolute
+    const quint32 base = quint32(stream.device()->pos());
+    for (Family &family : m_families)
+        family.offset += base;
+
+    return true;
+}
+
+/*
+ * Writes the fonts and aliases added with addFont() and addAlias() to
+ * fileName, grouping the fonts by family.
+ */
+bool QFontconfigCache::save(const QString &fileName, const QByteArray &fingerprint) const
+{
+    if (fileName.isEmpty() || !QDir().mkpath(QFileInfo(fileName).absolutePath()))
+        return false;
+
+    QByteArray records;
+    QDataStream recordStream(&records, QIODevice::WriteOnly);
+    recordStream.setVersion(QDataStream::Qt_5_10);
+
+    QHash<QString, QVector<int> > fontsOfFamily;
+    for (int i = 0; i < m_fonts.size(); ++i)
+        fontsOfFamily[m_fonts.at(i).familyName.toCaseFolded()].append(i);
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_10);
+    stream << cacheMagic << cacheVersion << fingerprint;
+
+    stream << quint32(m_familyOrder.size());
+    for (const QString &name : m_familyOrder) {
+        const QVector<int> &fonts = fontsOfFamily[name.toCaseFolded()];
+        stream << name << quint32(records.size()) << quint32(fonts.size());
+        for (int i : fonts)
+            recordStream << m_fonts.at(i);
+    }
+
+    stream << quint32(m_aliases.size());
+    for (const QPair<QString, QString> &alias : m_aliases)
+        stream << alias.first << alias.second;
+
+    stream.writeRawData(records.constData(), records.size());
+
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+void QFontconfigCache::addFont(const Font &font)
+{
+    const QString key = font.familyName.toCaseFolded();
+    if (!m_families.contains(key)) {
+        Family family;
+        family.name = font.familyName;
+        family.offset = 0;
+        family.count = 0;
+        m_families.insert(key, family);
+        m_familyOrder.append(font.familyName);
+    }
+    m_fonts.append(font);
+}
+
+void QFontconfigCache::addAlias(const QString &familyName, const QString &alias)
+{
+    m_aliases.append(qMakePair(familyName, alias));
+}
+
+/*
+ * Returns the names under which the families were first registered.
+ */
+QStringList QFontconfigCache::families() const
+{
+    return m_familyOrder;
+}
+
+/*
+ * Reads the fonts of familyName from the mapped file.
+ */
+QVector<QFontconfigCache::Font> QFontconfigCache::fonts(const QString &familyName) const
+{
+    QVector<Font> fonts;
+
+    const auto it = m_families.constFind(familyName.toCaseFolded());
+    if (it == m_families.constEnd() || !m_data || it->offset >= m_size)
+        return fonts;
+    // every record takes more than 16 bytes; don't trust a corrupt count
+    if (it->count > (m_size - it->offset) / 16)
+        return fonts;
+
+    const QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char *>(m_data) + it->offset,
+                                                    int(m_size - it->offset));
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_5_10);
+
+    fonts.resize(it->count);
+    for (Font &font : fonts)
+        stream >> font;
+    if (stream.status() != QDataStream::Ok)
+        fonts.clear();
+
+    return fonts;
+}
+
+QT_END_NAMESPACE
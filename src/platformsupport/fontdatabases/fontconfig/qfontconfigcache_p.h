@@ -0,0 +1,126 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFONTCONFIGCACHE_P_H
+#define QFONTCONFIGCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+class QFontconfigCache
+{
+public:
+    struct Font
+    {
+        QString familyName;
+        QString styleName;
+        QString foundryName;
+        int weight;
+        int style;
+        int stretch;
+        bool antialiased;
+        bool scalable;
+        double pixelSize;
+        bool fixedPitch;
+        quint64 writingSystems;
+        QString fileName;
+        int indexValue;
+    };
+
+    QFontconfigCache();
+    ~QFontconfigCache();
+
+    static bool isEnabled();
+    static QString defaultFileName();
+    static QByteArray fingerprint();
+
+    bool load(const QString &fileName, const QByteArray &fingerprint);
+    bool save(const QString &fileName, const QByteArray &fingerprint) const;
+
+    void addFont(const Font &font);
+    void addAlias(const QString &familyName, const QString &alias);
+
+    QStringList families() const;
+    QVector<QPair<QString, QString> > aliases() const { return m_aliases; }
+    QVector<Font> fonts(const QString &familyName) const;
+
+private:
+    Q_DISABLE_COPY(QFontconfigCache)
+
+    struct Family
+    {
+        QString name;
+        quint32 offset;
+        quint32 count;
+    };
+
+    // families are matched case insensitively, like in QFontDatabase
+    QHash<QString, Family> m_families;
+    QStringList m_familyOrder;
+    QVector<QPair<QString, QString> > m_aliases;
+
+    // fonts recorded by addFont(), in registration order
+    QVector<Font> m_fonts;
+
+    // the loaded cache file, mapped into memory
+    QFile m_file;
+    const uchar *m_data;
+    qint64 m_size;
+};
+
+QT_END_NAMESPACE
+
+#endif // QFONTCONFIGCACHE_P_H
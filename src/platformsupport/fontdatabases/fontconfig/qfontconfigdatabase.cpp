@@ -369,7 +369,7 @@ static inline bool requiresOpenType(int writingSystem)
             || writingSystem == QFontDatabase::Khmer || writingSystem == QFontDatabase::Nko);
 }
 
-static void populateFromPattern(FcPattern *pattern)
+static void populateFromPattern(FcPattern *pattern, QFontconfigCache *recorder = 0)
 {
     QString familyName;
     QString familyNameLang;
@@ -482,6 +482,28 @@ static void populateFromPattern(FcPattern *pattern)
     QPlatformFontDatabase::registerFont(familyName,styleName,QLatin1String((const char *)foundry_value),weight,style,stretch,antialias,scalable,pixel_size,fixedPitch,writingSystems,fontFile);
 //        qDebug() << familyName << (const char *)foundry_value << weight << style << &writingSystems << scalable << true << pixel_size;
 
+    QFontconfigCache::Font cachedFont;
+    if (recorder) {
+        cachedFont.familyName = familyName;
+        cachedFont.styleName = styleName;
+        cachedFont.foundryName = QLatin1String((const char *)foundry_value);
+        cachedFont.weight = weight;
+        cachedFont.style = style;
+        cachedFont.stretch = stretch;
+        cachedFont.antialiased = antialias;
+        cachedFont.scalable = scalable;
+        cachedFont.pixelSize = pixel_size;
+        cachedFont.fixedPitch = fixedPitch;
+        cachedFont.writingSystems = 0;
+        for (int j = 0; j < QFontDatabase::WritingSystemsCount; ++j) {
+            if (writingSystems.supported(QFontDatabase::WritingSystem(j)))
+                cachedFont.writingSystems |= Q_UINT64_C(1) << j;
+        }
+        cachedFont.fileName = fontFile->fileName;
+        cachedFont.indexValue = fontFile->indexValue;
+        recorder->addFont(cachedFont);
+    }
+
     for (int k = 1; FcPatternGetString(pattern, FC_FAMILY, k, &value) == FcResultMatch; ++k) {
         const QString altFamilyName = QString::fromUtf8((const char *)value);
         // Extra family names can be aliases or subfamilies.
@@ -502,21 +524,27 @@ static void populateFromPattern(FcPattern *pattern)
         if (familyNameLang == altFamilyNameLang && altStyleName != styleName) {
             FontFile *altFontFile = new FontFile(*fontFile);
             QPlatformFontDatabase::registerFont(altFamilyName, altStyleName, QLatin1String((const char *)foundry_value),weight,style,stretch,antialias,scalable,pixel_size,fixedPitch,writingSystems,altFontFile);
+            if (recorder) {
+                QFontconfigCache::Font altCachedFont = cachedFont;
+                altCachedFont.familyName = altFamilyName;
+                altCachedFont.styleName = altStyleName;
+                recorder->addFont(altCachedFont);
+            }
         } else {
             QPlatformFontDatabase::registerAliasToFontFamily(familyName, altFamilyName);
+            if (recorder)
+                recorder->addAlias(familyName, altFamilyName);
         }
     }
 
 }
 
-void QFontconfigDatabase::populateFontDatabase()
+static FcFontSet *listFonts(FcPattern *pattern)
 {
-    FcInit();
-    FcFontSet  *fonts;
+    FcFontSet *fonts;
 
     {
         FcObjectSet *os = FcObjectSetCreate();
-        FcPattern *pattern = FcPatternCreate();
         const char *properties [] = {
             FC_FAMILY, FC_STYLE, FC_WEIGHT, FC_SLANT,
             FC_SPACING, FC_FILE, FC_INDEX,
@@ -534,13 +562,49 @@ void QFontconfigDatabase::populateFontDatabase()
         }
         fonts = FcFontList(0, pattern, os);
         FcObjectSetDestroy(os);
-        FcPatternDestroy(pattern);
     }
 
-    for (int i = 0; i < fonts->nfont; i++)
-        populateFromPattern(fonts->fonts[i]);
+    return fonts;
+}
+
+void QFontconfigDatabase::populateFontDatabase()
+{
+    FcInit();
+
+    // With an up to date cache, only register the family names now and
+    // read the fonts of a family in populateFamily() when it is needed.
+    QByteArray fingerprint;
+    QScopedPointer<QFontconfigCache> recorder;
+    m_cache.reset();
+    if (QFontconfigCache::isEnabled()) {
+        fingerprint = QFontconfigCache::fingerprint();
+        QScopedPointer<QFontconfigCache> cache(new QFontconfigCache);
+        if (cache->load(QFontconfigCache::defaultFileName(), fingerprint))
+            m_cache.swap(cache);
+        else
+            recorder.reset(new QFontconfigCache);
+    }
+
+    if (m_cache) {
+        const QStringList families = m_cache->families();
+        for (const QString &family : families)
+            registerFontFamily(family);
+        const QVector<QPair<QString, QString> > aliases = m_cache->aliases();
+        for (const QPair<QString, QString> &alias : aliases)
+            registerAliasToFontFamily(alias.first, alias.second);
+    } else {
+        FcPattern *pattern = FcPatternCreate();
+        FcFontSet *fonts = listFonts(pattern);
+        FcPatternDestroy(pattern);
+
+        for (int i = 0; i < fonts->nfont; i++)
+            populateFromPattern(fonts->fonts[i], recorder.data());
 
-    FcFontSetDestroy (fonts);
+        FcFontSetDestroy (fonts);
+
+        if (recorder)
+            recorder->save(QFontconfigCache::defaultFileName(), fingerprint);
+    }
 
     struct FcDefaultFont {
         const char *qtname;
@@ -575,8 +639,49 @@ void QFontconfigDatabase::populateFontDatabase()
 //    QApplication::setFont(font);
 }
 
+void QFontconfigDatabase::populateFamily(const QString &familyName)
+{
+    if (!m_cache)
+        return;
+
+    const QVector<QFontconfigCache::Font> fonts = m_cache->fonts(familyName);
+    if (fonts.isEmpty()) {
+        // the cache file is damaged, ask fontconfig for just this family
+        FcPattern *pattern = FcPatternCreate();
+        const QByteArray name = familyName.toUtf8();
+        FcPatternAddString(pattern, FC_FAMILY, reinterpret_cast<const FcChar8 *>(name.constData()));
+        FcFontSet *fontSet = listFonts(pattern);
+        FcPatternDestroy(pattern);
+
+        for (int i = 0; i < fontSet->nfont; i++)
+            populateFromPattern(fontSet->fonts[i]);
+
+        FcFontSetDestroy(fontSet);
+        return;
+    }
+
+    for (const QFontconfigCache::Font &font : fonts) {
+        QSupportedWritingSystems writingSystems;
+        for (int j = 0; j < QFontDatabase::WritingSystemsCount; ++j) {
+            if (font.writingSystems & (Q_UINT64_C(1) << j))
+                writingSystems.setSupported(QFontDatabase::WritingSystem(j));
+        }
+
+        FontFile *fontFile = new FontFile;
+        fontFile->fileName = font.fileName;
+        fontFile->indexValue = font.indexValue;
+
+        registerFont(font.familyName, font.styleName, font.foundryName,
+                     QFont::Weight(font.weight), QFont::Style(font.style), QFont::Stretch(font.stretch),
+                     font.antialiased, font.scalable, font.pixelSize, font.fixedPitch,
+                     writingSystems, fontFile);
+    }
+}
+
 void QFontconfigDatabase::invalidate()
 {
+    m_cache.reset();
+
     // Clear app fonts.
     FcConfigAppFontClear(0);
 }
@@ -53,6 +53,7 @@
 
 #include <qpa/qplatformfontdatabase.h>
 #include <QtFontDatabaseSupport/private/qfreetypefontdatabase_p.h>
+#include <QtFontDatabaseSupport/private/qfontconfigcache_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -62,6 +63,7 @@ class QFontconfigDatabase : public QFreeTypeFontDatabase
 {
 public:
     void populateFontDatabase() Q_DECL_OVERRIDE;
+    void populateFamily(const QString &familyName) Q_DECL_OVERRIDE;
     void invalidate() Q_DECL_OVERRIDE;
     QFontEngineMulti *fontEngineMulti(QFontEngine *fontEngine, QChar::Script script) Q_DECL_OVERRIDE;
     QFontEngine *fontEngine(const QFontDef &fontDef, void *handle) Q_DECL_OVERRIDE;
@@ -73,6 +75,8 @@ public:
 
 private:
     void setupFontEngine(QFontEngineFT *engine, const QFontDef &fontDef) const;
+
+    QScopedPointer<QFontconfigCache> m_cache;
 };
 
 QT_END_NAMESPACE
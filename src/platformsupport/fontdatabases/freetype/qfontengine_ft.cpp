@@ -55,6 +55,7 @@
 #include "qfileinfo.h"
 #include <qscopedvaluerollback.h>
 #include "qthreadstorage.h"
+#include "qreadwritelock.h"
 #include <qmath.h>
 #include <qendian.h>
 
@@ -178,6 +179,220 @@ FT_Library qt_getFreetype()
     return freetypeData->library;
 }
 
+// -------------------------- Shared glyph cache ------------------------------
+
+/*
+ * Every thread has its own FreeType library, faces and font engines, so
+ * threads rendering the same text would each rasterize the same glyphs.
+ * This cache keeps copies of rendered glyphs for the whole process, keyed
+ * by everything that influences the rendering. It is split into shards that
+ * are guarded by read-write locks, so that lookups from different threads
+ * proceed concurrently. Memory is bounded; when a shard is full, glyphs that
+ * have not been used since the last sweep are evicted first.
+ */
+class QFreetypeSharedGlyphCache
+{
+public:
+    struct Key
+    {
+        QFontEngine::FaceId faceId;
+        glyph_t glyph;
+        int subPixelPosition;
+        int format;
+        int xsize;
+        int ysize;
+        FT_Fixed matrix[4];
+        int loadFlags;
+        int renderFlags;
+    };
+
+    QFreetypeSharedGlyphCache();
+    ~QFreetypeSharedGlyphCache();
+
+    bool isEnabled() const { return maxShardCost > 0; }
+
+    QFontEngineFT::Glyph *find(const Key &key, QFontEngineFT::Glyph *g);
+    void insert(const Key &key, const QFontEngineFT::Glyph *g, int dataSize);
+
+private:
+    struct Entry
+    {
+        int linearAdvance;
+        unsigned char width;
+        unsigned char height;
+        short x;
+        short y;
+        short advance;
+        QByteArray data;
+        mutable QAtomicInt used;
+    };
+
+    enum { ShardCount = 16 };
+    struct Shard
+    {
+        Shard() : cost(0) {}
+        QReadWriteLock lock;
+        QHash<Key, Entry *> entries;
+        int cost;
+    };
+
+    static int entryCost(const Entry *entry) { return int(sizeof(Entry)) + entry->data.size(); }
+    void evict(Shard *shard, int cost);
+
+    Shard shards[ShardCount];
+    int maxShardCost;
+};
+
+static inline bool operator==(const QFreetypeSharedGlyphCache::Key &k1, const QFreetypeSharedGlyphCache::Key &k2)
+{
+    return k1.glyph == k2.glyph
+        && k1.subPixelPosition == k2.subPixelPosition
+        && k1.format == k2.format
+        && k1.xsize == k2.xsize
+        && k1.ysize == k2.ysize
+        && memcmp(k1.matrix, k2.matrix, sizeof(k1.matrix)) == 0
+        && k1.loadFlags == k2.loadFlags
+        && k1.renderFlags == k2.renderFlags
+        && k1.faceId == k2.faceId;
+}
+
+static inline uint qHash(const QFreetypeSharedGlyphCache::Key &key, uint seed = 0)
+{
+    QtPrivate::QHashCombine hash;
+    seed = hash(seed, key.faceId);
+    seed = hash(seed, key.glyph);
+    seed = hash(seed, key.subPixelPosition);
+    seed = hash(seed, (key.format << 24) ^ key.loadFlags ^ (key.renderFlags << 16));
+    seed = hash(seed, key.xsize);
+    seed = hash(seed, key.ysize);
+    for (FT_Fixed m : key.matrix)
+        seed = hash(seed, quint64(m));
+    return seed;
+}
+
+QFreetypeSharedGlyphCache::QFreetypeSharedGlyphCache()
+{
+    // size in kilobytes, 0 disables the cache
+    bool ok = false;
+    int size = qEnvironmentVariableIntValue("QT_FREETYPE_SHARED_GLYPH_CACHE_SIZE", &ok);
+    if (!ok)
+        size = 8 * 1024;
+    maxShardCost = qMax(0, size) * (1024 / ShardCount);
+}
+
+QFreetypeSharedGlyphCache::~QFreetypeSharedGlyphCache()
+{
+    for (Shard &shard : shards)
+        qDeleteAll(shard.entries);
+}
+
+/*
+ * Fills g (or a new glyph if g is null) with the cached rendering for key.
+ * Returns null if the glyph is not in the cache.
+ */
+QFontEngineFT::Glyph *QFreetypeSharedGlyphCache::find(const Key &key, QFontEngineFT::Glyph *g)
+{
+    Shard &shard = shards[qHash(key) % ShardCount];
+
+    QFontEngineFT::GlyphInfo info;
+    QByteArray data;
+    {
+        QReadLocker locker(&shard.lock);
+        const Entry *entry = shard.entries.value(key);
+        if (!entry)
+            return 0;
+        entry->used.store(1);
+        info.linearAdvance = entry->linearAdvance;
+        info.width = entry->width;
+        info.height = entry->height;
+        info.x = entry->x;
+        info.y = entry->y;
+        info.xOff = entry->advance;
+        data = entry->data;
+    }
+
+    uchar *buffer = 0;
+    if (!data.isEmpty()) {
+        buffer = new uchar[data.size()];
+        memcpy(buffer, data.constData(), data.size());
+    }
+
+    if (!g) {
+        g = new QFontEngineFT::Glyph;
+        g->data = 0;
+    }
+    g->linearAdvance = info.linearAdvance;
+    g->width = info.width;
+    g->height = info.height;
+    g->x = info.x;
+    g->y = info.y;
+    g->advance = info.xOff;
+    g->format = key.format;
+    delete [] g->data;
+    g->data = buffer;
+    return g;
+}
+
+void QFreetypeSharedGlyphCache::insert(const Key &key, const QFontEngineFT::Glyph *g, int dataSize)
+{
+    Entry *entry = new Entry;
+    entry->linearAdvance = g->linearAdvance;
+    entry->width = g->width;
+    entry->height = g->height;
+    entry->x = g->x;
+    entry->y = g->y;
+    entry->advance = g->advance;
+    entry->data = QByteArray(reinterpret_cast<const char *>(g->data), dataSize);
+
+    const int cost = entryCost(entry);
+    if (cost > maxShardCost) {
+        delete entry;
+        return;
+    }
+
+    Shard &shard = shards[qHash(key) % ShardCount];
+
+    QWriteLocker locker(&shard.lock);
+    if (shard.entries.contains(key)) {
+        // another thread rendered the same glyph in the meantime
+        delete entry;
+        return;
+    }
+    if (shard.cost + cost > maxShardCost)
+        evict(&shard, cost);
+    shard.entries.insert(key, entry);
+    shard.cost += cost;
+}
+
+// Called with the shard locked for writing. Frees at least a quarter of the
+// shard besides the room needed for cost, giving recently used glyphs a
+// second chance.
+void QFreetypeSharedGlyphCache::evict(Shard *shard, int cost)
+{
+    const int target = qMax(0, maxShardCost - maxShardCost / 4 - cost);
+    while (shard->cost > target) {
+        for (QHash<Key, Entry *>::iterator it = shard->entries.begin(); it != shard->entries.end() && shard->cost > target; ) {
+            Entry *entry = it.value();
+            if (entry->used.load()) {
+                entry->used.store(0);
+                ++it;
+            } else {
+                shard->cost -= entryCost(entry);
+                delete entry;
+                it = shard->entries.erase(it);
+            }
+        }
+    }
+}
+
+Q_GLOBAL_STATIC(QFreetypeSharedGlyphCache, theSharedGlyphCache)
+
+static QFreetypeSharedGlyphCache *qt_sharedGlyphCache()
+{
+    QFreetypeSharedGlyphCache *cache = theSharedGlyphCache();
+    return cache && cache->isEnabled() ? cache : 0;
+}
+
 int QFreetypeFace::fsType() const
 {
     int fsType = 0;
@@ -1073,6 +1288,34 @@ QFontEngineFT::Glyph *QFontEngineFT::loadGlyph(QGlyphSet *set, uint glyph,
     if (transform || (format != Format_Mono && !isScalableBitmap()))
         load_flags |= FT_LOAD_NO_BITMAP;
 
+    // Glyphs of fonts loaded from memory are not shared, since their face ids
+    // can be reused once the application font is removed.
+    QFreetypeSharedGlyphCache *sharedCache = 0;
+    QFreetypeSharedGlyphCache::Key sharedKey;
+    if (set && !fetchMetricsOnly && !(set->outline_drawing && !disableOutlineDrawing)
+            && freetype->fontData.isEmpty()) {
+        sharedCache = qt_sharedGlyphCache();
+    }
+    if (sharedCache) {
+        sharedKey.faceId = face_id;
+        sharedKey.glyph = glyph;
+        sharedKey.subPixelPosition = v.x;
+        sharedKey.format = format;
+        sharedKey.xsize = xsize;
+        sharedKey.ysize = ysize;
+        sharedKey.matrix[0] = matrix.xx;
+        sharedKey.matrix[1] = matrix.xy;
+        sharedKey.matrix[2] = matrix.yx;
+        sharedKey.matrix[3] = matrix.yy;
+        sharedKey.loadFlags = load_flags;
+        sharedKey.renderFlags = int(embolden) | (int(obliquen) << 1) | (int(subpixelType) << 2) | (lcdFilterType << 8);
+
+        if (Glyph *cached = sharedCache->find(sharedKey, g)) {
+            set->setGlyph(glyph, subPixelPosition, cached);
+            return cached;
+        }
+    }
+
     FT_Error err = FT_Load_Glyph(face, glyph, load_flags);
     if (err && (load_flags & FT_LOAD_NO_BITMAP)) {
         load_flags &= ~FT_LOAD_NO_BITMAP;
@@ -1370,6 +1613,8 @@ QFontEngineFT::Glyph *QFontEngineFT::loadGlyph(QGlyphSet *set, uint glyph,
 
     if (set)
         set->setGlyph(glyph, subPixelPosition, g);
+    if (sharedCache)
+        sharedCache->insert(sharedKey, g, glyph_buffer_size);
 
     return g;
 }
@@ -61,7 +61,7 @@ QGifPlugin::~QGifPlugin()
 QImageIOPlugin::Capabilities QGifPlugin::capabilities(QIODevice *device, const QByteArray &format) const
 {
     if (format == "gif" || (device && device->isReadable() && QGifHandler::canRead(device)))
-        return Capabilities(CanRead);
+        return Capabilities(CanRead | CanReadIncremental);
     return 0;
 }
 
@@ -74,6 +74,7 @@ public:
 
     bool newFrame;
     bool partialNewFrame;
+    QRect changed;
 
 private:
     void fillRect(QImage *image, int x, int y, int w, int h, QRgb col);
@@ -179,7 +180,7 @@ void QGIFFormat::disposePrevious(QImage *image)
 {
     if (out_of_bounds) {
         // flush anything that survived
-        // ### Changed: QRect(0, 0, swidth, sheight)
+        changed |= QRect(0, 0, swidth, sheight);
     }
 
     // Handle disposal of previous image before processing next one
@@ -208,7 +209,7 @@ void QGIFFormat::disposePrevious(QImage *image)
             const QRgb *bits = reinterpret_cast<const QRgb *>(image->constBits());
             fillRect(image, l, t, r-l+1, b-t+1, bits[0]);
         }
-        // ### Changed: QRect(l, t, r-l+1, b-t+1)
+        changed |= QRect(l, t, r-l+1, b-t+1);
         break;
       case RestoreImage: {
         if (frame >= 0) {
@@ -217,7 +218,7 @@ void QGIFFormat::disposePrevious(QImage *image)
                     backingstore.constScanLine(ln-t),
                     (r-l+1)*sizeof(QRgb));
             }
-            // ### Changed: QRect(l, t, r-l+1, b-t+1)
+            changed |= QRect(l, t, r-l+1, b-t+1);
         }
       }
     }
@@ -393,10 +394,10 @@ int QGIFFormat::decode(QImage *image, const uchar *buffer, int length,
                         // Not full-size image - erase with bg or transparent
                         if (trans_index >= 0) {
                             fillRect(image, 0, 0, swidth, sheight, color(trans_index));
-                            // ### Changed: QRect(0, 0, swidth, sheight)
+                            changed |= QRect(0, 0, swidth, sheight);
                         } else if (bgcol>=0) {
                             fillRect(image, 0, 0, swidth, sheight, color(bgcol));
-                            // ### Changed: QRect(0, 0, swidth, sheight)
+                            changed |= QRect(0, 0, swidth, sheight);
                         }
                     }
                 }
@@ -659,6 +660,9 @@ int QGIFFormat::decode(QImage *image, const uchar *buffer, int length,
             return -1; // Called again after done.
         }
     }
+    // The row being decoded may be partially done
+    if ((state == ImageDataBlock || state == ImageDataBlockSize) && x > left && !out_of_bounds)
+        changed |= QRect(left, y, x - left, 1);
     return initial-length;
 }
 
@@ -947,9 +951,7 @@ void QGIFFormat::nextY(unsigned char *bits, int bpl)
     int my;
     switch (interlace) {
     case 0: // Non-interlaced
-        // if (!out_of_bounds) {
-        //     ### Changed: QRect(left, y, right - left + 1, 1);
-        // }
+        changed |= QRect(left, y, right - left + 1, 1);
         y++;
         break;
     case 1: {
@@ -963,11 +965,7 @@ void QGIFFormat::nextY(unsigned char *bits, int bpl)
             }
         }
 
-        // if (!out_of_bounds) {
-        //     ### Changed: QRect(left, y, right - left + 1, my + 1);
-        // }
-//        if (!out_of_bounds)
-//            qDebug("consumer->changed(QRect(%d, %d, %d, %d))", left, y, right-left+1, my+1);
+        changed |= QRect(left, y, right - left + 1, my + 1);
         y+=8;
         if (y>bottom) {
             interlace++; y=top+4;
@@ -992,9 +990,7 @@ void QGIFFormat::nextY(unsigned char *bits, int bpl)
             }
         }
 
-        // if (!out_of_bounds) {
-        //     ### Changed: QRect(left, y, right - left + 1, my + 1);
-        // }
+        changed |= QRect(left, y, right - left + 1, my + 1);
         y+=8;
         if (y>bottom) {
             interlace++; y=top+2;
@@ -1015,16 +1011,12 @@ void QGIFFormat::nextY(unsigned char *bits, int bpl)
                        (right-left+1)*sizeof(QRgb));
             }
         }
-        // if (!out_of_bounds) {
-        //     ### Changed: QRect(left, y, right - left + 1, my + 1);
-        // }
+        changed |= QRect(left, y, right - left + 1, my + 1);
         y+=4;
         if (y>bottom) { interlace++; y=top+1; }
     } break;
     case 4:
-        // if (!out_of_bounds) {
-        //     ### Changed: QRect(left, y, right - left + 1, 1);
-        // }
+        changed |= QRect(left, y, right - left + 1, 1);
         y+=2;
     }
 
@@ -1053,6 +1045,8 @@ QGifHandler::QGifHandler()
     loopCnt = -1;
     frameNumber = -1;
     scanIsCached = false;
+    incrementalReading = false;
+    incrementalFinished = false;
 }
 
 QGifHandler::~QGifHandler()
@@ -1108,6 +1102,9 @@ bool QGifHandler::canRead(QIODevice *device)
 
 bool QGifHandler::read(QImage *image)
 {
+    if (incrementalReading)
+        return readIncrementally(image);
+
     const int GifChunkSize = 4096;
 
     while (!gifFormat->newFrame) {
@@ -1134,6 +1131,51 @@ bool QGifHandler::read(QImage *image)
     return false;
 }
 
+// Decodes the data that is currently available on the device, without
+// waiting for the rest of the frame
+
+bool QGifHandler::readIncrementally(QImage *image)
+{
+    const int GifChunkSize = 4096;
+
+    if (incrementalFinished) {
+        // continue with the next frame
+        incrementalFinished = false;
+        gifFormat->newFrame = false;
+        gifFormat->partialNewFrame = false;
+    }
+
+    // If the caller passed back the frame we returned last time, drop its
+    // reference so that decoding the next rows does not detach the image.
+    if (!image->isNull() && image->constBits() == lastImage.constBits())
+        *image = QImage();
+
+    while (!gifFormat->newFrame) {
+        if (buffer.isEmpty()) {
+            buffer += device()->read(GifChunkSize);
+            if (buffer.isEmpty())
+                break;
+        }
+
+        int decoded = gifFormat->decode(&lastImage, (const uchar *)buffer.constData(), buffer.size(),
+                                        &nextDelay, &loopCnt);
+        if (decoded == -1)
+            return false;
+        buffer.remove(0, decoded);
+    }
+    incrementalUpdate = gifFormat->changed & lastImage.rect();
+    gifFormat->changed = QRect();
+
+    // like read(), accept a frame that lacks its terminator at the end of a file
+    if (gifFormat->newFrame
+        || (gifFormat->partialNewFrame && !device()->isSequential() && device()->atEnd())) {
+        incrementalFinished = true;
+        ++frameNumber;
+    }
+    *image = lastImage;
+    return true;
+}
+
 bool QGifHandler::write(const QImage &image)
 {
     Q_UNUSED(image);
@@ -1143,10 +1185,12 @@ bool QGifHandler::write(const QImage &image)
 bool QGifHandler::supportsOption(ImageOption option) const
 {
     if (!device() || device()->isSequential())
-        return option == Animation;
+        return option == Animation
+            || option == IncrementalReading;
     else
         return option == Size
-            || option == Animation;
+            || option == Animation
+            || option == IncrementalReading;
 }
 
 QVariant QGifHandler::option(ImageOption option) const
@@ -1166,14 +1210,18 @@ QVariant QGifHandler::option(ImageOption option) const
         return imageSizes.at(frameNumber + 1);
     } else if (option == Animation) {
         return true;
+    } else if (option == IncrementalReading) {
+        return incrementalReading;
+    } else if (option == IncrementalReadFinished) {
+        return incrementalFinished;
     }
     return QVariant();
 }
 
 void QGifHandler::setOption(ImageOption option, const QVariant &value)
 {
-    Q_UNUSED(option);
-    Q_UNUSED(value);
+    if (option == IncrementalReading)
+        incrementalReading = value.toBool();
 }
 
 int QGifHandler::nextImageDelay() const
@@ -1210,6 +1258,11 @@ int QGifHandler::currentImageNumber() const
     return frameNumber;
 }
 
+QRect QGifHandler::currentImageRect() const
+{
+    return incrementalUpdate;
+}
+
 QByteArray QGifHandler::name() const
 {
     return "gif";
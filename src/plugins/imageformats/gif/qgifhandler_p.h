@@ -59,6 +59,7 @@
 #include <QtGui/qimageiohandler.h>
 #include <QtGui/qimage.h>
 #include <QtCore/qbytearray.h>
+#include <QtCore/qrect.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -85,9 +86,11 @@ public:
     int loopCount() const override;
     int nextImageDelay() const override;
     int currentImageNumber() const override;
+    QRect currentImageRect() const override;
 
 private:
     bool imageIsComing() const;
+    bool readIncrementally(QImage *image);
     QGIFFormat *gifFormat;
     QString fileName;
     mutable QByteArray buffer;
@@ -98,6 +101,9 @@ private:
     int frameNumber;
     mutable QVector<QSize> imageSizes;
     mutable bool scanIsCached;
+    bool incrementalReading;
+    bool incrementalFinished;
+    QRect incrementalUpdate;
 };
 
 QT_END_NAMESPACE
@@ -74,6 +74,11 @@ extern "C" {
 #endif
 }
 
+// libjpeg-turbo 1.5 and later can skip rows and columns while decoding
+#if defined(LIBJPEG_TURBO_VERSION_NUMBER) && LIBJPEG_TURBO_VERSION_NUMBER >= 1005000
+#  define QT_JPEG_PARTIAL_DECODE
+#endif
+
 QT_BEGIN_NAMESPACE
 QT_WARNING_DISABLE_GCC("-Wclobbered")
 
@@ -305,31 +310,23 @@ static bool read_jpeg_image(QImage *outImage,
                 info->scale_num   = qBound(1, qCeil(8/f), 8);
                 info->scale_denom = 8;
             } else {
-                info->scale_denom = qMin(clipRect.width() / scaledSize.width(),
-                                         clipRect.height() / scaledSize.height());
-
-                // Only scale by powers of two when clipping so we can
-                // keep the exact pixel boundaries
-                if (info->scale_denom < 2)
-                    info->scale_denom = 1;
-                else if (info->scale_denom < 4)
-                    info->scale_denom = 2;
-                else if (info->scale_denom < 8)
-                    info->scale_denom = 4;
-                else
-                    info->scale_denom = 8;
-                info->scale_num = 1;
-
-                // Correct the scale factor so that we clip accurately.
+                double f = qMin(double(clipRect.width()) / scaledSize.width(),
+                                double(clipRect.height()) / scaledSize.height());
+                int num = qBound(1, qCeil(8/f), 8);
+
+                // Correct the scale factor so that we clip accurately:
+                // the clip rectangle has to map to whole output pixels.
                 // It is recommended that the clip rectangle be aligned
                 // on an 8-pixel boundary for best performance.
-                while (info->scale_denom > 1 &&
-                       ((clipRect.x() % info->scale_denom) != 0 ||
-                        (clipRect.y() % info->scale_denom) != 0 ||
-                        (clipRect.width() % info->scale_denom) != 0 ||
-                        (clipRect.height() % info->scale_denom) != 0)) {
-                    info->scale_denom /= 2;
+                while (num < 8 &&
+                       ((clipRect.x() * num % 8) != 0 ||
+                        (clipRect.y() * num % 8) != 0 ||
+                        (clipRect.width() * num % 8) != 0 ||
+                        (clipRect.height() * num % 8) != 0)) {
+                    ++num;
                 }
+                info->scale_num = num;
+                info->scale_denom = 8;
             }
         }
 
@@ -351,10 +348,12 @@ static bool read_jpeg_image(QImage *outImage,
         } else {
             // The scale factor was corrected above to ensure that
             // we don't miss pixels when we scale the clip rectangle.
-            clip = QRect(clipRect.x() / int(info->scale_denom),
-                         clipRect.y() / int(info->scale_denom),
-                         clipRect.width() / int(info->scale_denom),
-                         clipRect.height() / int(info->scale_denom));
+            const int num = info->scale_num;
+            const int denom = info->scale_denom;
+            clip = QRect(clipRect.x() * num / denom,
+                         clipRect.y() * num / denom,
+                         clipRect.width() * num / denom,
+                         clipRect.height() * num / denom);
             clip = clip.intersected(imageRect);
         }
 
@@ -378,6 +377,28 @@ static bool read_jpeg_image(QImage *outImage,
 
             (void) jpeg_start_decompress(info);
 
+            // Offset of the clip region in the decoded rows
+            int clipX = clip.x();
+#ifdef QT_JPEG_PARTIAL_DECODE
+            // Only decode the iMCU columns and rows that the clip region
+            // covers. Merged upsampling, used without fancy upsampling,
+            // does not support this in all libjpeg-turbo versions.
+            if (clip != imageRect && info->do_fancy_upsampling) {
+                // Fancy upsampling treats the edges of the cropped area like
+                // image edges, so decode a margin on either side.
+                const int left = qMax(0, clip.x() - 2);
+                const int right = qMin(int(info->output_width), clip.x() + clip.width() + 2);
+                if (right - left < int(info->output_width)) {
+                    JDIMENSION xoffset = left;
+                    JDIMENSION width = right - left;
+                    jpeg_crop_scanline(info, &xoffset, &width);
+                    clipX = clip.x() - int(xoffset);
+                }
+                if (clip.y() > 0)
+                    (void) jpeg_skip_scanlines(info, clip.y());
+            }
+#endif
+
             while (info->output_scanline < info->output_height) {
                 int y = int(info->output_scanline) - clip.y();
                 if (y >= clip.height())
@@ -389,12 +410,12 @@ static bool read_jpeg_image(QImage *outImage,
                     continue;   // Haven't reached the starting line yet.
 
                 if (info->output_components == 3) {
-                    uchar *in = rows[0] + clip.x() * 3;
+                    uchar *in = rows[0] + clipX * 3;
                     QRgb *out = (QRgb*)outImage->scanLine(y);
                     converter(out, in, clip.width());
                 } else if (info->out_color_space == JCS_CMYK) {
                     // Convert CMYK->RGB.
-                    uchar *in = rows[0] + clip.x() * 4;
+                    uchar *in = rows[0] + clipX * 4;
                     QRgb *out = (QRgb*)outImage->scanLine(y);
                     for (int i = 0; i < clip.width(); ++i) {
                         int k = in[3];
@@ -405,7 +426,7 @@ static bool read_jpeg_image(QImage *outImage,
                 } else if (info->output_components == 1) {
                     // Grayscale.
                     memcpy(outImage->scanLine(y),
-                           rows[0] + clip.x(), clip.width());
+                           rows[0] + clipX, clip.width());
                 }
             }
         } else {
@@ -42,6 +42,8 @@
 #include <qcoreapplication.h>
 #include <qvariant.h>
 #include <qdatetime.h>
+#include <qendian.h>
+#include <qqueue.h>
 #include <qregexp.h>
 #include <qsqlerror.h>
 #include <qsqlfield.h>
@@ -51,14 +53,19 @@
 #include <qsocketnotifier.h>
 #include <qstringlist.h>
 #include <qlocale.h>
+#include <qnumeric.h>
+#include <qpointer.h>
 #include <QtSql/private/qsqlresult_p.h>
 #include <QtSql/private/qsqldriver_p.h>
+#include <QtSql/private/qsqlasyncquery_p.h>
 
 #include <libpq-fe.h>
 #include <pg_config.h>
 
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <limits>
 // below code taken from an example at http://www.gnu.org/software/hello/manual/autoconf/Function-Portability.html
 #ifndef isnan
     # define isnan(x) \
@@ -83,9 +90,11 @@
 
 // workaround for postgres defining their OIDs in a private header file
 #define QBOOLOID 16
+#define QNAMEOID 19
 #define QINT8OID 20
 #define QINT2OID 21
 #define QINT4OID 23
+#define QTEXTOID 25
 #define QNUMERICOID 1700
 #define QFLOAT4OID 700
 #define QFLOAT8OID 701
@@ -98,6 +107,8 @@
 #define QTIMESTAMPTZOID 1184
 #define QOIDOID 2278
 #define QBYTEAOID 17
+#define QBPCHAROID 1042
+#define QVARCHAROID 1043
 #define QREGPROCOID 24
 #define QXIDOID 28
 #define QCIDOID 29
@@ -107,6 +118,15 @@
 
 #define VARHDRSZ 4
 
+// libpq format codes for parameters and results
+#define QPSQL_TEXT_FORMAT 0
+#define QPSQL_BINARY_FORMAT 1
+
+// PQsetSingleRowMode() was added in libpq 9.2
+#if defined PG_VERSION_NUM && PG_VERSION_NUM-0 >= 90200
+#define QPSQL_HAVE_SINGLE_ROW_MODE
+#endif
+
 /* This is a compile time switch - if PQfreemem is declared, the compiler will use that one,
    otherwise it'll run in this template */
 template <typename T>
@@ -126,10 +146,12 @@ inline void qPQfreemem(void *buffer)
 }
 
 class QPSQLResultPrivate;
+class QPSQLAsyncExecutor;
 
 class QPSQLResult: public QSqlResult
 {
     Q_DECLARE_PRIVATE(QPSQLResult)
+    friend class QPSQLAsyncExecutor;
 
 public:
     QPSQLResult(const QPSQLDriver *db);
@@ -152,6 +174,19 @@ protected:
     QVariant lastInsertId() const Q_DECL_OVERRIDE;
     bool prepare(const QString &query) Q_DECL_OVERRIDE;
     bool exec() Q_DECL_OVERRIDE;
+    bool execBatch(bool arrayBind = false) Q_DECL_OVERRIDE;
+    void detachFromResultSet() Q_DECL_OVERRIDE;
+};
+
+// Parameter arrays for PQexecPrepared() and friends; data owns the bytes values points to.
+struct QPSQLParams
+{
+    QVector<QByteArray> data;
+    QVector<const char *> values;
+    QVector<int> lengths;
+    QVector<int> formats;
+
+    int count() const { return values.count(); }
 };
 
 class QPSQLDriverPrivate : public QSqlDriverPrivate
@@ -164,7 +199,10 @@ public:
         pro(QPSQLDriver::Version6),
         sn(0),
         pendingNotifyCheck(false),
-        hasBackslashEscape(false)
+        hasBackslashEscape(false),
+        integerDateTimes(false),
+        singleRowMode(false),
+        pendingResult(0)
     { dbmsType = QSqlDriver::PostgreSQL; }
 
     PGconn *connection;
@@ -174,15 +212,32 @@ public:
     QStringList seid;
     mutable bool pendingNotifyCheck;
     bool hasBackslashEscape;
+    bool integerDateTimes;
+    // forward-only queries stream their rows, set by the QPSQL_SINGLE_ROW_MODE connect option
+    bool singleRowMode;
+    // forward-only result whose rows are still being streamed over the connection
+    mutable QPSQLResultPrivate *pendingResult;
 
     void appendTables(QStringList &tl, QSqlQuery &t, QChar type);
     PGresult * exec(const char * stmt) const;
     PGresult * exec(const QString & stmt) const;
+    PGresult *prepare(const QString &stmtId, const QString &query,
+                      const QVector<Oid> &paramTypes = QVector<Oid>()) const;
+    PGresult *describePrepared(const QString &stmtId) const;
+    PGresult *execPrepared(const QString &stmtId, const QPSQLParams &params, int resultFormat) const;
+    bool sendQuery(const QString &stmt) const;
+    bool sendQueryPrepared(const QString &stmtId, const QPSQLParams &params, int resultFormat) const;
+    void finishPendingResult() const;
+    void checkPendingNotifications() const;
+    QSqlAsyncExecutor *createAsyncExecutor(QSqlAsyncQueryPrivate *sink) Q_DECL_OVERRIDE;
+    QByteArray encode(const QString &str) const
+    { return isUtf8 ? str.toUtf8() : str.toLocal8Bit(); }
     QPSQLDriver::Protocol getPSQLVersion();
     bool setEncodingUtf8();
     void setDatestyle();
     void setByteaOutput();
     void detectBackslashEscape();
+    void detectIntegerDateTimes();
 };
 
 void QPSQLDriverPrivate::appendTables(QStringList &tl, QSqlQuery &t, QChar type)
@@ -209,20 +264,70 @@ void QPSQLDriverPrivate::appendTables(QStringList &tl, QSqlQuery &t, QChar type)
     }
 }
 
-PGresult * QPSQLDriverPrivate::exec(const char * stmt) const
+void QPSQLDriverPrivate::checkPendingNotifications() const
 {
     Q_Q(const QPSQLDriver);
-    PGresult *result = PQexec(connection, stmt);
     if (seid.size() && !pendingNotifyCheck) {
         pendingNotifyCheck = true;
         QMetaObject::invokeMethod(const_cast<QPSQLDriver*>(q), "_q_handleNotification", Qt::QueuedConnection, Q_ARG(int,0));
     }
+}
+
+PGresult * QPSQLDriverPrivate::exec(const char * stmt) const
+{
+    finishPendingResult();
+    PGresult *result = PQexec(connection, stmt);
+    checkPendingNotifications();
     return result;
 }
 
 PGresult * QPSQLDriverPrivate::exec(const QString & stmt) const
 {
-    return exec(isUtf8 ? stmt.toUtf8().constData() : stmt.toLocal8Bit().constData());
+    return exec(encode(stmt).constData());
+}
+
+PGresult *QPSQLDriverPrivate::prepare(const QString &stmtId, const QString &query,
+                                      const QVector<Oid> &paramTypes) const
+{
+    finishPendingResult();
+    return PQprepare(connection, stmtId.toLatin1().constData(), encode(query).constData(),
+                     paramTypes.count(), paramTypes.isEmpty() ? 0 : paramTypes.constData());
+}
+
+PGresult *QPSQLDriverPrivate::describePrepared(const QString &stmtId) const
+{
+    finishPendingResult();
+    return PQdescribePrepared(connection, stmtId.toLatin1().constData());
+}
+
+PGresult *QPSQLDriverPrivate::execPrepared(const QString &stmtId, const QPSQLParams &params,
+                                           int resultFormat) const
+{
+    finishPendingResult();
+    PGresult *result = PQexecPrepared(connection, stmtId.toLatin1().constData(), params.count(),
+                                      params.values.constData(), params.lengths.constData(),
+                                      params.formats.constData(), resultFormat);
+    checkPendingNotifications();
+    return result;
+}
+
+bool QPSQLDriverPrivate::sendQuery(const QString &stmt) const
+{
+    finishPendingResult();
+    const bool ok = PQsendQuery(connection, encode(stmt).constData());
+    checkPendingNotifications();
+    return ok;
+}
+
+bool QPSQLDriverPrivate::sendQueryPrepared(const QString &stmtId, const QPSQLParams &params,
+                                           int resultFormat) const
+{
+    finishPendingResult();
+    const bool ok = PQsendQueryPrepared(connection, stmtId.toLatin1().constData(), params.count(),
+                                        params.values.constData(), params.lengths.constData(),
+                                        params.formats.constData(), resultFormat);
+    checkPendingNotifications();
+    return ok;
 }
 
 class QPSQLResultPrivate : public QSqlResultPrivate
@@ -234,7 +339,12 @@ public:
       : QSqlResultPrivate(q, drv),
         result(0),
         currentSize(-1),
-        preparedQueriesEnabled(false)
+        preparedQueriesEnabled(false),
+        binaryResults(false),
+        singleRow(false),
+        rowPending(false),
+        recordCached(false),
+        asyncExecutor(0)
     { }
 
     QString fieldSerial(int i) const Q_DECL_OVERRIDE { return QLatin1Char('$') + QString::number(i + 1); }
@@ -244,8 +354,31 @@ public:
     int currentSize;
     bool preparedQueriesEnabled;
     QString preparedStmtId;
+    // parameter types the server inferred for the prepared statement
+    QVector<Oid> paramTypes;
+    // whether all result columns of the prepared statement can be fetched in binary
+    bool binaryResults;
+    // COPY statement equivalent to the prepared INSERT, used by execBatch()
+    QString copyStmt;
+
+    // single row mode: result holds the current row only and further rows
+    // come from the connection or, once detached, from bufferedRows
+    bool singleRow;
+    bool rowPending;
+    QQueue<PGresult *> bufferedRows;
+
+    mutable QSqlRecord cachedRecord;
+    mutable bool recordCached;
+    // streams this result without blocking for a QSqlAsyncQuery
+    QPSQLAsyncExecutor *asyncExecutor;
 
     bool processResults();
+    bool startSingleRowResult();
+    bool nextRow();
+    void bufferPendingRows();
+    void discardPendingRows();
+    void bindParams(QPSQLParams *params) const;
+    bool canCopyBatch() const;
 };
 
 static QSqlError qMakeError(const QString& err, QSqlError::ErrorType type,
@@ -261,6 +394,42 @@ static QSqlError qMakeError(const QString& err, QSqlError::ErrorType type,
     return QSqlError(QLatin1String("QPSQL: ") + err, msg, type, errorCode);
 }
 
+#ifdef QPSQL_HAVE_SINGLE_ROW_MODE
+// Runs a QSqlAsyncQuery on the connection of the driver. The rows are read
+// in single row mode whenever the socket of the connection becomes readable,
+// so the thread of the query never waits for the server.
+class QPSQLAsyncExecutor : public QSqlAsyncExecutor
+{
+public:
+    QPSQLAsyncExecutor(const QPSQLDriver *driver, QSqlAsyncQueryPrivate *sink);
+    ~QPSQLAsyncExecutor();
+
+    bool start() Q_DECL_OVERRIDE;
+    void cancel() Q_DECL_OVERRIDE;
+    QVariant lastInsertId() const Q_DECL_OVERRIDE;
+
+    void scheduleRead();
+
+private:
+    void readResults();
+    void discardResults();
+    void finish();
+
+    QPSQLResult result;
+    QSocketNotifier *notifier;
+    // last result that isn't a row, it decides how the query ended
+    PGresult *lastResult;
+    QSqlRecord rec;
+    int generation;
+    bool running;
+    // cancelled, but the server may still send results; they arrive
+    // through the notifier and are dropped
+    bool draining;
+    // the statement ended with PGRES_COMMAND_OK, so lastval() refers to it
+    bool commandFinished;
+};
+#endif
+
 bool QPSQLResultPrivate::processResults()
 {
     Q_Q(QPSQLResult);
@@ -284,6 +453,117 @@ bool QPSQLResultPrivate::processResults()
     return false;
 }
 
+static inline bool qIsSingleRow(const PGresult *result)
+{
+#ifdef QPSQL_HAVE_SINGLE_ROW_MODE
+    return PQresultStatus(result) == PGRES_SINGLE_TUPLE;
+#else
+    Q_UNUSED(result);
+    return false;
+#endif
+}
+
+bool QPSQLResultPrivate::startSingleRowResult()
+{
+    Q_Q(QPSQLResult);
+    PGconn *connection = drv_d_func()->connection;
+#ifdef QPSQL_HAVE_SINGLE_ROW_MODE
+    PQsetSingleRowMode(connection);
+#endif
+    result = PQgetResult(connection);
+    if (qIsSingleRow(result)) {
+        singleRow = true;
+        rowPending = true;
+        drv_d_func()->pendingResult = this;
+        q->setSelect(true);
+        q->setActive(true);
+        currentSize = -1;
+        return true;
+    }
+
+    // no rows to stream; collect the remaining results and keep the last one like PQexec() does
+    while (PGresult *next = PQgetResult(connection)) {
+        PQclear(result);
+        result = next;
+    }
+    return processResults();
+}
+
+bool QPSQLResultPrivate::nextRow()
+{
+    Q_Q(QPSQLResult);
+    if (rowPending) {
+        rowPending = false;
+        return true;
+    }
+
+    QPSQLDriverPrivate *drv = drv_d_func();
+    PGresult *next = 0;
+    if (!bufferedRows.isEmpty())
+        next = bufferedRows.dequeue();
+    else if (drv && drv->pendingResult == this)
+        next = PQgetResult(drv->connection);
+
+    if (qIsSingleRow(next)) {
+        PQclear(result);
+        result = next;
+        return true;
+    }
+
+    // end of the result set, make the connection available again
+    discardPendingRows();
+    singleRow = true;
+    if (PQresultStatus(next) == PGRES_TUPLES_OK) {
+        // the final result has no rows but still describes the columns
+        PQclear(result);
+        result = next;
+    } else if (next) {
+        if (drv) {
+            q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                            "Unable to fetch row"), QSqlError::StatementError, drv, next));
+        }
+        PQclear(next);
+    }
+    return false;
+}
+
+void QPSQLResultPrivate::bufferPendingRows()
+{
+    QPSQLDriverPrivate *drv = drv_d_func();
+    if (!drv || drv->pendingResult != this)
+        return;
+    drv->pendingResult = 0;
+    while (PGresult *next = PQgetResult(drv->connection))
+        bufferedRows.enqueue(next);
+#ifdef QPSQL_HAVE_SINGLE_ROW_MODE
+    // the socket won't tell the executor about the rows read here
+    if (asyncExecutor)
+        asyncExecutor->scheduleRead();
+#endif
+}
+
+void QPSQLResultPrivate::discardPendingRows()
+{
+    QPSQLDriverPrivate *drv = drv_d_func();
+    if (drv && drv->pendingResult == this) {
+        drv->pendingResult = 0;
+        while (PGresult *next = PQgetResult(drv->connection))
+            PQclear(next);
+    }
+    while (!bufferedRows.isEmpty())
+        PQclear(bufferedRows.dequeue());
+    singleRow = false;
+    rowPending = false;
+}
+
+void QPSQLDriverPrivate::finishPendingResult() const
+{
+    // libpq runs one command at a time, so the rows of a streamed result
+    // have to be read before anything else can be sent on the connection
+    if (pendingResult)
+        pendingResult->bufferPendingRows();
+}
+
 static QVariant::Type qDecodePSQLType(int t)
 {
     QVariant::Type type = QVariant::Invalid;
@@ -330,6 +610,291 @@ static QVariant::Type qDecodePSQLType(int t)
     return type;
 }
 
+// PostgreSQL counts dates and timestamps from 2000-01-01
+static const qint64 qPSQLEpochMSecs = Q_INT64_C(946684800000);
+
+static inline QDate qPSQLEpochDate()
+{
+    return QDate(2000, 1, 1);
+}
+
+template <typename T>
+static inline void qAppendBigEndian(QByteArray *out, T value)
+{
+    const int pos = out->size();
+    out->resize(pos + int(sizeof(T)));
+    qToBigEndian(value, out->data() + pos);
+}
+
+static bool qIsBinaryResultType(Oid type, bool integerDateTimes)
+{
+    switch (type) {
+    case QBOOLOID:
+    case QINT2OID:
+    case QINT4OID:
+    case QINT8OID:
+    case QFLOAT8OID:
+    case QBYTEAOID:
+    case QNAMEOID:
+    case QTEXTOID:
+    case QBPCHAROID:
+    case QVARCHAROID:
+    case QDATEOID:
+        return true;
+    case QTIMEOID:
+        // servers built with --disable-integer-datetimes send floating point seconds
+        return integerDateTimes;
+    default:
+        // timestamps are left to the server's conversion to text, so that
+        // they come out in its session time zone as before
+        return false;
+    }
+}
+
+static QTime qTimeFromPSQLBinary(qint64 usecs)
+{
+    // round to milliseconds like the ISO date parser does for the text format
+    const int msecs = int(usecs / 1000000) * 1000 + qMin(int((usecs % 1000000 + 500) / 1000), 999);
+    return QTime::fromMSecsSinceStartOfDay(msecs);
+}
+
+// Converts a value received in binary format; returns the same variant types as
+// the text format conversion in QPSQLResult::data().
+static QVariant qFromPSQLBinary(const char *val, int len, Oid type, bool isUtf8)
+{
+    switch (type) {
+    case QBOOLOID:
+        return QVariant(val[0] != 0);
+    case QINT2OID:
+        return QVariant(int(qFromBigEndian<qint16>(val)));
+    case QINT4OID:
+        return QVariant(int(qFromBigEndian<qint32>(val)));
+    case QINT8OID: {
+        const qint64 v = qFromBigEndian<qint64>(val);
+        if (v < 0)
+            return QVariant(qlonglong(v));
+        return QVariant(qulonglong(v));
+    }
+    case QFLOAT8OID: {
+        const quint64 bits = qFromBigEndian<quint64>(val);
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        return QVariant(d);
+    }
+    case QBYTEAOID:
+        return QVariant(QByteArray(val, len));
+    case QDATEOID: {
+        const qint32 days = qFromBigEndian<qint32>(val);
+        if (days == std::numeric_limits<qint32>::max() || days == std::numeric_limits<qint32>::min())
+            return QVariant(QDate());
+        return QVariant(qPSQLEpochDate().addDays(days));
+    }
+    case QTIMEOID:
+        return QVariant(qTimeFromPSQLBinary(qFromBigEndian<qint64>(val)));
+    default:
+        return isUtf8 ? QString::fromUtf8(val, len) : QString::fromLatin1(val, len);
+    }
+}
+
+// Returns val in the text input syntax of the given type.
+static QByteArray qToPSQLText(const QVariant &val, const QPSQLDriverPrivate *drv)
+{
+    switch (int(val.type())) {
+    case QVariant::Bool:
+        return val.toBool() ? QByteArrayLiteral("true") : QByteArrayLiteral("false");
+    case QMetaType::Float:
+    case QVariant::Double: {
+        const double d = val.toDouble();
+        if (qIsNaN(d))
+            return QByteArrayLiteral("NaN");
+        if (qIsInf(d))
+            return d > 0 ? QByteArrayLiteral("Infinity") : QByteArrayLiteral("-Infinity");
+        break;
+    }
+#ifndef QT_NO_DATESTRING
+    case QVariant::DateTime:
+        // in UTC, as QPSQLDriver::formatValue() does
+        return QLocale::c().toString(val.toDateTime().toUTC(), QLatin1String("yyyy-MM-ddThh:mm:ss.zzz")).toLatin1() + 'Z';
+    case QVariant::Date:
+        return val.toDate().toString(Qt::ISODate).toLatin1();
+    case QVariant::Time:
+        return val.toTime().toString(QLatin1String("hh:mm:ss.zzz")).toLatin1();
+#endif
+    case QVariant::ByteArray:
+        return val.toByteArray();
+    default:
+        break;
+    }
+    return drv->encode(val.toString());
+}
+
+// Appends val in the binary format of the given type. Returns false, without
+// touching out, if there is no binary conversion of val to that type.
+static bool qAppendPSQLBinary(QByteArray *out, const QVariant &val, Oid type,
+                              const QPSQLDriverPrivate *drv)
+{
+    switch (type) {
+    case QBOOLOID:
+        switch (int(val.type())) {
+        case QVariant::Bool:
+        case QVariant::Int:
+        case QVariant::UInt:
+        case QVariant::LongLong:
+        case QVariant::ULongLong:
+            out->append(char(val.toBool()));
+            return true;
+        default:
+            return false;
+        }
+    case QINT2OID:
+    case QINT4OID:
+    case QINT8OID: {
+        if (val.type() == QVariant::ULongLong
+                && val.toULongLong() > quint64(std::numeric_limits<qint64>::max())) {
+            return false;
+        }
+        bool ok;
+        const qlonglong v = val.toLongLong(&ok);
+        if (!ok)
+            return false;
+        if (type == QINT2OID) {
+            if (v < std::numeric_limits<qint16>::min() || v > std::numeric_limits<qint16>::max())
+                return false;
+            qAppendBigEndian(out, qint16(v));
+        } else if (type == QINT4OID) {
+            if (v < std::numeric_limits<qint32>::min() || v > std::numeric_limits<qint32>::max())
+                return false;
+            qAppendBigEndian(out, qint32(v));
+        } else {
+            qAppendBigEndian(out, qint64(v));
+        }
+        return true;
+    }
+    case QFLOAT4OID:
+    case QFLOAT8OID: {
+        bool ok;
+        const double d = val.toDouble(&ok);
+        if (!ok)
+            return false;
+        if (type == QFLOAT4OID) {
+            const float f = float(d);
+            quint32 bits;
+            memcpy(&bits, &f, sizeof(bits));
+            qAppendBigEndian(out, bits);
+        } else {
+            quint64 bits;
+            memcpy(&bits, &d, sizeof(bits));
+            qAppendBigEndian(out, bits);
+        }
+        return true;
+    }
+    case QBYTEAOID:
+        if (val.type() != QVariant::ByteArray)
+            return false;
+        out->append(val.toByteArray());
+        return true;
+    case QNAMEOID:
+    case QTEXTOID:
+    case QBPCHAROID:
+    case QVARCHAROID:
+        // the binary format of text types is the text itself
+        out->append(qToPSQLText(val, drv));
+        return true;
+    case QDATEOID: {
+        // date times are sent in UTC, like everywhere else in the driver
+        QDate date;
+        if (val.type() == QVariant::Date)
+            date = val.toDate();
+        else if (val.type() == QVariant::DateTime)
+            date = val.toDateTime().toUTC().date();
+        else
+            return false;
+        qAppendBigEndian(out, qint32(qPSQLEpochDate().daysTo(date)));
+        return true;
+    }
+    case QTIMEOID:
+        if (!drv->integerDateTimes || val.type() != QVariant::Time)
+            return false;
+        qAppendBigEndian(out, qint64(val.toTime().msecsSinceStartOfDay()) * 1000);
+        return true;
+    case QTIMESTAMPTZOID:
+        // a date is midnight in the session time zone, leave that to the server
+        if (!drv->integerDateTimes || val.type() != QVariant::DateTime)
+            return false;
+        qAppendBigEndian(out, (val.toDateTime().toMSecsSinceEpoch() - qPSQLEpochMSecs) * 1000);
+        return true;
+    default:
+        return false;
+    }
+}
+
+void QPSQLResultPrivate::bindParams(QPSQLParams *params) const
+{
+    const QPSQLDriverPrivate *drv = drv_d_func();
+    const int count = values.count();
+    params->data.resize(count);
+    params->values.resize(count);
+    params->lengths.resize(count);
+    params->formats.resize(count);
+    for (int i = 0; i < count; ++i) {
+        const QVariant &val = values.at(i);
+        QByteArray &data = params->data[i];
+        params->formats[i] = QPSQL_TEXT_FORMAT;
+        if (val.isNull()) {
+            params->values[i] = 0;
+            params->lengths[i] = 0;
+            continue;
+        }
+        const Oid type = paramTypes.value(i);
+        if (qAppendPSQLBinary(&data, val, type, drv)) {
+            params->formats[i] = QPSQL_BINARY_FORMAT;
+        } else if (val.type() == QVariant::ByteArray) {
+            // sent as it is: a text format parameter would end at the first NUL
+            data = val.toByteArray();
+            params->formats[i] = QPSQL_BINARY_FORMAT;
+        } else {
+            data = qToPSQLText(val, drv);
+        }
+        params->values[i] = data.constData();
+        params->lengths[i] = data.size();
+    }
+}
+
+bool QPSQLResultPrivate::canCopyBatch() const
+{
+    if (copyStmt.isEmpty() || values.isEmpty() || values.count() != paramTypes.count())
+        return false;
+
+    // COPY has no text fallback for single values, so all of them must convert
+    const QPSQLDriverPrivate *drv = drv_d_func();
+    const int rowCount = values.at(0).toList().count();
+    QByteArray scratch;
+    for (int i = 0; i < values.count(); ++i) {
+        const QVariantList column = values.at(i).toList();
+        if (column.count() != rowCount)
+            return false;
+        for (const QVariant &val : column) {
+            scratch.resize(0);
+            if (!val.isNull() && !qAppendPSQLBinary(&scratch, val, paramTypes.at(i), drv))
+                return false;
+        }
+    }
+    return true;
+}
+
+static QString qMakeCopyStatement(const QString &query, int paramCount)
+{
+    // INSERT INTO table (columns) VALUES (?, ...) loads the same rows as COPY table (columns)
+    QRegExp rx(QStringLiteral("\\s*INSERT\\s+INTO\\s+([^\\s(]+)\\s*\\(([^)]+)\\)\\s*VALUES\\s*"
+                              "\\(\\s*\\?(?:\\s*,\\s*\\?)*\\s*\\)\\s*;?\\s*"), Qt::CaseInsensitive);
+    if (paramCount == 0 || !rx.exactMatch(query))
+        return QString();
+    if (rx.cap(2).split(QLatin1Char(',')).count() != paramCount)
+        return QString();
+    return QLatin1String("COPY ") + rx.cap(1) + QLatin1String(" (") + rx.cap(2)
+            + QLatin1String(") FROM STDIN BINARY");
+}
+
 void QPSQLResultPrivate::deallocatePreparedStmt()
 {
     const QString stmt = QLatin1String("DEALLOCATE ") + preparedStmtId;
@@ -366,9 +931,12 @@ QVariant QPSQLResult::handle() const
 void QPSQLResult::cleanup()
 {
     Q_D(QPSQLResult);
+    d->discardPendingRows();
     if (d->result)
         PQclear(d->result);
     d->result = 0;
+    d->recordCached = false;
+    d->cachedRecord.clear();
     setAt(QSql::BeforeFirstRow);
     d->currentSize = -1;
     setActive(false);
@@ -376,11 +944,24 @@ void QPSQLResult::cleanup()
 
 bool QPSQLResult::fetch(int i)
 {
-    Q_D(const QPSQLResult);
+    Q_D(QPSQLResult);
     if (!isActive())
         return false;
     if (i < 0)
         return false;
+    if (d->singleRow) {
+        // rows arrive one by one, so we can only move forward
+        if (at() == QSql::AfterLastRow || i < at())
+            return false;
+        while (at() < i) {
+            if (!d->nextRow()) {
+                setAt(QSql::AfterLastRow);
+                return false;
+            }
+            setAt(at() + 1);
+        }
+        return true;
+    }
     if (i >= d->currentSize)
         return false;
     if (at() == i)
@@ -396,7 +977,21 @@ bool QPSQLResult::fetchFirst()
 
 bool QPSQLResult::fetchLast()
 {
-    Q_D(const QPSQLResult);
+    Q_D(QPSQLResult);
+    if (d->singleRow) {
+        if (!isActive() || at() == QSql::AfterLastRow)
+            return false;
+        // read the rest of the result to find out how many rows are left
+        d->bufferPendingRows();
+        int rows = d->rowPending ? 1 : 0;
+        for (const PGresult *row : qAsConst(d->bufferedRows)) {
+            if (qIsSingleRow(row))
+                ++rows;
+        }
+        if (rows == 0)
+            return at() >= 0;
+        return fetch(at() + rows);
+    }
     return fetch(PQntuples(d->result) - 1);
 }
 
@@ -407,11 +1002,14 @@ QVariant QPSQLResult::data(int i)
         qWarning("QPSQLResult::data: column %d out of range", i);
         return QVariant();
     }
+    const int row = d->singleRow ? 0 : at();
     int ptype = PQftype(d->result, i);
     QVariant::Type type = qDecodePSQLType(ptype);
-    const char *val = PQgetvalue(d->result, at(), i);
-    if (PQgetisnull(d->result, at(), i))
+    const char *val = PQgetvalue(d->result, row, i);
+    if (PQgetisnull(d->result, row, i))
         return QVariant(type);
+    if (PQfformat(d->result, i) == QPSQL_BINARY_FORMAT)
+        return qFromPSQLBinary(val, PQgetlength(d->result, row, i), ptype, d->drv_d_func()->isUtf8);
     switch (type) {
     case QVariant::Bool:
         return QVariant((bool)(val[0] == 't'));
@@ -495,8 +1093,9 @@ QVariant QPSQLResult::data(int i)
 bool QPSQLResult::isNull(int field)
 {
     Q_D(const QPSQLResult);
-    PQgetvalue(d->result, at(), field);
-    return PQgetisnull(d->result, at(), field);
+    const int row = d->singleRow ? 0 : at();
+    PQgetvalue(d->result, row, field);
+    return PQgetisnull(d->result, row, field);
 }
 
 bool QPSQLResult::reset (const QString& query)
@@ -507,6 +1106,16 @@ bool QPSQLResult::reset (const QString& query)
         return false;
     if (!driver()->isOpen() || driver()->isOpenError())
         return false;
+#ifdef QPSQL_HAVE_SINGLE_ROW_MODE
+    if (isForwardOnly() && d->drv_d_func()->singleRowMode) {
+        if (!d->drv_d_func()->sendQuery(query)) {
+            setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                         "Unable to create query"), QSqlError::StatementError, d->drv_d_func()));
+            return false;
+        }
+        return d->startSingleRowResult();
+    }
+#endif
     d->result = d->drv_d_func()->exec(query);
     return d->processResults();
 }
@@ -539,59 +1148,70 @@ QVariant QPSQLResult::lastInsertId() const
     return QVariant();
 }
 
+// Describes column i of result, without the table name.
+static QSqlField qMakeField(const PGresult *result, int i, bool isUtf8)
+{
+    QSqlField f;
+    if (isUtf8)
+        f.setName(QString::fromUtf8(PQfname(result, i)));
+    else
+        f.setName(QString::fromLocal8Bit(PQfname(result, i)));
+    int ptype = PQftype(result, i);
+    f.setType(qDecodePSQLType(ptype));
+    int len = PQfsize(result, i);
+    int precision = PQfmod(result, i);
+
+    switch (ptype) {
+    case QTIMESTAMPOID:
+    case QTIMESTAMPTZOID:
+        precision = 3;
+        break;
+
+    case QNUMERICOID:
+        if (precision != -1) {
+            len = (precision >> 16);
+            precision = ((precision - VARHDRSZ) & 0xffff);
+        }
+        break;
+    case QBITOID:
+    case QVARBITOID:
+        len = precision;
+        precision = -1;
+        break;
+    default:
+        if (len == -1 && precision >= VARHDRSZ) {
+            len = precision - VARHDRSZ;
+            precision = -1;
+        }
+    }
+
+    f.setLength(len);
+    f.setPrecision(precision);
+    f.setSqlType(ptype);
+    return f;
+}
+
 QSqlRecord QPSQLResult::record() const
 {
     Q_D(const QPSQLResult);
     QSqlRecord info;
     if (!isActive() || !isSelect())
         return info;
+    if (d->recordCached)
+        return d->cachedRecord;
 
     int count = PQnfields(d->result);
     for (int i = 0; i < count; ++i) {
-        QSqlField f;
-        if (d->drv_d_func()->isUtf8)
-            f.setName(QString::fromUtf8(PQfname(d->result, i)));
-        else
-            f.setName(QString::fromLocal8Bit(PQfname(d->result, i)));
+        QSqlField f = qMakeField(d->result, i, d->drv_d_func()->isUtf8);
         QSqlQuery qry(driver()->createResult());
         if (qry.exec(QStringLiteral("SELECT relname FROM pg_class WHERE pg_class.oid = %1")
                      .arg(PQftable(d->result, i))) && qry.next()) {
             f.setTableName(qry.value(0).toString());
         }
-        int ptype = PQftype(d->result, i);
-        f.setType(qDecodePSQLType(ptype));
-        int len = PQfsize(d->result, i);
-        int precision = PQfmod(d->result, i);
-
-        switch (ptype) {
-        case QTIMESTAMPOID:
-        case QTIMESTAMPTZOID:
-            precision = 3;
-            break;
-
-        case QNUMERICOID:
-            if (precision != -1) {
-                len = (precision >> 16);
-                precision = ((precision - VARHDRSZ) & 0xffff);
-            }
-            break;
-        case QBITOID:
-        case QVARBITOID:
-            len = precision;
-            precision = -1;
-            break;
-        default:
-            if (len == -1 && precision >= VARHDRSZ) {
-                len = precision - VARHDRSZ;
-                precision = -1;
-            }
-        }
-
-        f.setLength(len);
-        f.setPrecision(precision);
-        f.setSqlType(ptype);
         info.append(f);
     }
+    d->cachedRecord = info;
+    d->recordCached = true;
     return info;
 }
 
@@ -602,28 +1222,6 @@ void QPSQLResult::virtual_hook(int id, void *data)
     QSqlResult::virtual_hook(id, data);
 }
 
-static QString qCreateParamString(const QVector<QVariant> &boundValues, const QSqlDriver *driver)
-{
-    if (boundValues.isEmpty())
-        return QString();
-
-    QString params;
-    QSqlField f;
-    for (int i = 0; i < boundValues.count(); ++i) {
-        const QVariant &val = boundValues.at(i);
-
-        f.setType(val.type());
-        if (val.isNull())
-            f.clear();
-        else
-            f.setValue(val);
-        if(!params.isNull())
-            params.append(QLatin1String(", "));
-        params.append(driver->formatValue(f));
-    }
-    return params;
-}
-
 QString qMakePreparedStmtId()
 {
     static QBasicAtomicInt qPreparedStmtCount = Q_BASIC_ATOMIC_INITIALIZER(0);
@@ -642,21 +1240,58 @@ bool QPSQLResult::prepare(const QString &query)
     if (!d->preparedStmtId.isEmpty())
         d->deallocatePreparedStmt();
 
-    const QString stmtId = qMakePreparedStmtId();
-    const QString stmt = QString::fromLatin1("PREPARE %1 AS ").arg(stmtId).append(d->positionalToNamedBinding(query));
+    d->paramTypes.clear();
+    d->binaryResults = false;
+    d->copyStmt.clear();
 
-    PGresult *result = d->drv_d_func()->exec(stmt);
+    const QString preparedQuery = d->positionalToNamedBinding(query);
+    QVector<Oid> declaredTypes;
+    forever {
+        const QString stmtId = qMakePreparedStmtId();
+        PGresult *result = d->drv_d_func()->prepare(stmtId, preparedQuery, declaredTypes);
+
+        if (PQresultStatus(result) != PGRES_COMMAND_OK) {
+            setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                                    "Unable to prepare statement"), QSqlError::StatementError, d->drv_d_func(), result));
+            PQclear(result);
+            d->preparedStmtId.clear();
+            return false;
+        }
 
-    if (PQresultStatus(result) != PGRES_COMMAND_OK) {
-        setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
-                                "Unable to prepare statement"), QSqlError::StatementError, d->drv_d_func(), result));
         PQclear(result);
-        d->preparedStmtId.clear();
-        return false;
+        d->preparedStmtId = stmtId;
+
+        // the types the server inferred decide which values can be transferred in binary
+        result = d->drv_d_func()->describePrepared(stmtId);
+        if (PQresultStatus(result) == PGRES_COMMAND_OK) {
+            const int paramCount = PQnparams(result);
+            d->paramTypes.resize(paramCount);
+            for (int i = 0; i < paramCount; ++i)
+                d->paramTypes[i] = PQparamtype(result, i);
+
+            const int fieldCount = PQnfields(result);
+            d->binaryResults = fieldCount > 0;
+            for (int i = 0; d->binaryResults && i < fieldCount; ++i)
+                d->binaryResults = qIsBinaryResultType(PQftype(result, i), d->drv_d_func()->integerDateTimes);
+        }
+        PQclear(result);
+
+        // Date times used to be bound as TIMESTAMP WITH TIME ZONE literals, which
+        // the server converts to its session time zone where a timestamp without
+        // time zone is expected. Declare such parameters as timestamptz to keep that.
+        if (!declaredTypes.isEmpty() || !d->paramTypes.contains(QTIMESTAMPOID))
+            break;
+        declaredTypes = d->paramTypes;
+        for (Oid &type : declaredTypes) {
+            if (type == QTIMESTAMPOID)
+                type = QTIMESTAMPTZOID;
+        }
+        d->deallocatePreparedStmt();
     }
 
-    PQclear(result);
-    d->preparedStmtId = stmtId;
+    // COPY would store the timestamps without that conversion
+    if (declaredTypes.isEmpty())
+        d->copyStmt = qMakeCopyStatement(query, d->paramTypes.count());
     return true;
 }
 
@@ -668,18 +1303,402 @@ bool QPSQLResult::exec()
 
     cleanup();
 
-    QString stmt;
-    const QString params = qCreateParamString(boundValues(), driver());
-    if (params.isEmpty())
-        stmt = QString::fromLatin1("EXECUTE %1").arg(d->preparedStmtId);
-    else
-        stmt = QString::fromLatin1("EXECUTE %1 (%2)").arg(d->preparedStmtId, params);
+    QPSQLParams params;
+    d->bindParams(&params);
+    const int resultFormat = d->binaryResults ? QPSQL_BINARY_FORMAT : QPSQL_TEXT_FORMAT;
 
-    d->result = d->drv_d_func()->exec(stmt);
+#ifdef QPSQL_HAVE_SINGLE_ROW_MODE
+    if (isForwardOnly() && d->drv_d_func()->singleRowMode) {
+        if (!d->drv_d_func()->sendQueryPrepared(d->preparedStmtId, params, resultFormat)) {
+            setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                         "Unable to create query"), QSqlError::StatementError, d->drv_d_func()));
+            return false;
+        }
+        return d->startSingleRowResult();
+    }
+#endif
 
+    d->result = d->drv_d_func()->execPrepared(d->preparedStmtId, params, resultFormat);
     return d->processResults();
 }
 
+bool QPSQLResult::execBatch(bool arrayBind)
+{
+    Q_D(QPSQLResult);
+    if (!d->canCopyBatch())
+        return QSqlResult::execBatch(arrayBind);
+
+    cleanup();
+
+    QPSQLDriverPrivate *drv = d->drv_d_func();
+    PGresult *result = drv->exec(d->copyStmt);
+    if (PQresultStatus(result) != PGRES_COPY_IN) {
+        // e.g. the table is a view; outside of a transaction block nothing
+        // has been aborted and the rows can still be inserted one by one
+        if (PQtransactionStatus(drv->connection) == PQTRANS_IDLE) {
+            PQclear(result);
+            return QSqlResult::execBatch(arrayBind);
+        }
+        setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                                "Unable to execute batch"), QSqlError::StatementError, drv, result));
+        PQclear(result);
+        return false;
+    }
+    PQclear(result);
+
+    QVector<QVariantList> columns;
+    columns.reserve(d->values.count());
+    for (const QVariant &column : qAsConst(d->values))
+        columns.append(column.toList());
+    const int columnCount = columns.count();
+    const int rowCount = columns.at(0).count();
+
+    const int chunkSize = 64 * 1024;
+    QByteArray buffer;
+    buffer.reserve(chunkSize + 1024);
+    // signature, flags and header extension length
+    buffer.append("PGCOPY\n\377\r\n\0", 11);
+    qAppendBigEndian(&buffer, qint32(0));
+    qAppendBigEndian(&buffer, qint32(0));
+
+    bool ok = true;
+    for (int row = 0; ok && row < rowCount; ++row) {
+        qAppendBigEndian(&buffer, qint16(columnCount));
+        for (int col = 0; col < columnCount; ++col) {
+            const QVariant &val = columns.at(col).at(row);
+            if (val.isNull()) {
+                qAppendBigEndian(&buffer, qint32(-1));
+                continue;
+            }
+            const int lengthPos = buffer.size();
+            qAppendBigEndian(&buffer, qint32(0));
+            qAppendPSQLBinary(&buffer, val, d->paramTypes.at(col), drv);
+            qToBigEndian(qint32(buffer.size() - lengthPos - 4), buffer.data() + lengthPos);
+        }
+        if (buffer.size() >= chunkSize) {
+            ok = PQputCopyData(drv->connection, buffer.constData(), buffer.size()) == 1;
+            buffer.resize(0);
+        }
+    }
+    qAppendBigEndian(&buffer, qint16(-1));
+    if (ok)
+        ok = PQputCopyData(drv->connection, buffer.constData(), buffer.size()) == 1;
+    PQputCopyEnd(drv->connection, ok ? 0 : "QPSQL: unable to send batch data");
+
+    d->result = PQgetResult(drv->connection);
+    while (PGresult *next = PQgetResult(drv->connection))
+        PQclear(next);
+    return d->processResults();
+}
+
+void QPSQLResult::detachFromResultSet()
+{
+    Q_D(QPSQLResult);
+    d->discardPendingRows();
+}
+
+#ifdef QPSQL_HAVE_SINGLE_ROW_MODE
+QPSQLAsyncExecutor::QPSQLAsyncExecutor(const QPSQLDriver *driver, QSqlAsyncQueryPrivate *sink)
+    : QSqlAsyncExecutor(sink),
+      result(driver),
+      notifier(0),
+      lastResult(0),
+      generation(0),
+      running(false),
+      draining(false),
+      commandFinished(false)
+{
+}
+
+QPSQLAsyncExecutor::~QPSQLAsyncExecutor()
+{
+    cancel();
+    // the result goes away with the executor, so the results the server
+    // still sends for it have to be read now
+    result.cleanup();
+    result.d_func()->asyncExecutor = 0;
+}
+
+bool QPSQLAsyncExecutor::start()
+{
+    cancel();
+
+    QPSQLResultPrivate *d = result.d_func();
+    QPSQLDriverPrivate *drv = d->drv_d_func();
+    // the notifier for notifications already watches the socket
+    if (!drv || !drv->connection || drv->sn)
+        return false;
+    // named placeholders are left to QSqlQuery on the worker thread
+    const QVector<QVariant> &values = sink->values;
+    if (!values.isEmpty() && !sink->query.contains(QLatin1Char('?')))
+        return false;
+
+    drv->finishPendingResult();
+    if (draining)
+        discardResults();
+    bool ok;
+    if (values.isEmpty()) {
+        ok = PQsendQuery(drv->connection, drv->encode(sink->query).constData());
+    } else {
+        QPSQLParams params;
+        const int count = values.count();
+        params.data.resize(count);
+        params.values.resize(count);
+        params.lengths.resize(count);
+        params.formats.fill(QPSQL_TEXT_FORMAT, count);
+        // date times are in UTC, let the server convert them like a
+        // TIMESTAMP WITH TIME ZONE literal
+        QVector<Oid> types(count, 0);
+        for (int i = 0; i < count; ++i) {
+            const QVariant &val = values.at(i);
+            if (val.type() == QVariant::DateTime)
+                types[i] = QTIMESTAMPTZOID;
+            if (val.isNull()) {
+                params.values[i] = 0;
+                params.lengths[i] = 0;
+                continue;
+            }
+            if (val.type() == QVariant::ByteArray) {
+                // a text format parameter would end at the first NUL
+                types[i] = QBYTEAOID;
+                params.formats[i] = QPSQL_BINARY_FORMAT;
+                params.data[i] = val.toByteArray();
+            } else {
+                params.data[i] = qToPSQLText(val, drv);
+            }
+            params.values[i] = params.data.at(i).constData();
+            params.lengths[i] = params.data.at(i).size();
+        }
+        const QByteArray stmt = drv->encode(d->positionalToNamedBinding(sink->query));
+        ok = PQsendQueryParams(drv->connection, stmt.constData(), count, types.constData(),
+                               params.values.constData(), params.lengths.constData(),
+                               params.formats.constData(), QPSQL_TEXT_FORMAT);
+    }
+    if (!ok)
+        return false;
+    PQsetSingleRowMode(drv->connection);
+
+    // the rows are read through the result, so anything else that needs the
+    // connection buffers them like it does for a forward-only QSqlQuery
+    d->singleRow = true;
+    d->asyncExecutor = this;
+    drv->pendingResult = d;
+    running = true;
+
+    const int socket = PQsocket(drv->connection);
+    if (notifier && notifier->socket() != socket) {
+        delete notifier;
+        notifier = 0;
+    }
+    if (!notifier) {
+        notifier = new QSocketNotifier(socket, QSocketNotifier::Read, this);
+        QObject::connect(notifier, &QSocketNotifier::activated, this, [this]() { readResults(); });
+    }
+    notifier->setEnabled(true);
+    return true;
+}
+
+void QPSQLAsyncExecutor::cancel()
+{
+    QPSQLResultPrivate *d = result.d_func();
+    QPSQLDriverPrivate *drv = d->drv_d_func();
+    ++generation;
+    if (running && drv && drv->connection && drv->pendingResult == d) {
+        if (PGcancel *cancel = PQgetCancel(drv->connection)) {
+            char errbuf[256];
+            PQcancel(cancel, errbuf, sizeof(errbuf));
+            PQfreeCancel(cancel);
+        }
+        // don't wait for the server here, readResults() drops what it sends
+        draining = true;
+    }
+    running = false;
+    commandFinished = false;
+    if (!draining) {
+        if (notifier)
+            notifier->setEnabled(false);
+        result.cleanup();
+        d->asyncExecutor = 0;
+    }
+    if (lastResult)
+        PQclear(lastResult);
+    lastResult = 0;
+    rec.clear();
+}
+
+// The result of the executor is never active, and while a statement runs
+// the connection belongs to it, so QPSQLResult::lastInsertId() can't be
+// used. Servers without lastval() report the OID with the finished signal.
+QVariant QPSQLAsyncExecutor::lastInsertId() const
+{
+    const QPSQLDriverPrivate *drv = result.d_func()->drv_d_func();
+    if (commandFinished && drv && drv->connection && drv->pro >= QPSQLDriver::Version8_1) {
+        QSqlQuery qry(result.driver()->createResult());
+        if (qry.exec(QLatin1String("SELECT lastval();")) && qry.next())
+            return qry.value(0);
+        return QVariant();
+    }
+    return QSqlAsyncExecutor::lastInsertId();
+}
+
+void QPSQLAsyncExecutor::scheduleRead()
+{
+    const int current = generation;
+    QMetaObject::invokeMethod(this, [this, current]() {
+        if (current == generation)
+            readResults();
+    }, Qt::QueuedConnection);
+}
+
+void QPSQLAsyncExecutor::readResults()
+{
+    if (draining) {
+        discardResults();
+        return;
+    }
+    if (!running)
+        return;
+
+    QPSQLResultPrivate *d = result.d_func();
+    QPSQLDriverPrivate *drv = d->drv_d_func();
+    if (!drv || !drv->connection) {
+        running = false;
+        notifier->setEnabled(false);
+        sink->reportFinished(QSqlError(QCoreApplication::translate("QPSQLResult", "Unable to fetch row"),
+                                       QCoreApplication::translate("QPSQLResult", "Not connected"),
+                                       QSqlError::ConnectionError));
+        return;
+    }
+    if (drv->pendingResult == d && !PQconsumeInput(drv->connection)) {
+        drv->pendingResult = 0;
+        running = false;
+        notifier->setEnabled(false);
+        sink->reportFinished(qMakeError(QCoreApplication::translate("QPSQLResult",
+                             "Unable to fetch row"), QSqlError::ConnectionError, drv));
+        return;
+    }
+
+    // the slots connected to the query may cancel or restart it
+    QPointer<QObject> guard(this);
+    const int current = generation;
+    for (;;) {
+        PGresult *next = 0;
+        if (!d->bufferedRows.isEmpty()) {
+            next = d->bufferedRows.dequeue();
+        } else if (drv->pendingResult == d) {
+            if (PQisBusy(drv->connection))
+                break;
+            next = PQgetResult(drv->connection);
+            if (!next)
+                drv->pendingResult = 0;
+        }
+        if (!next) {
+            finish();
+            return;
+        }
+        if (!qIsSingleRow(next)) {
+            if (lastResult)
+                PQclear(lastResult);
+            lastResult = next;
+            continue;
+        }
+
+        PQclear(d->result);
+        d->result = next;
+        if (rec.isEmpty()) {
+            for (int i = 0; i < PQnfields(next); ++i)
+                rec.append(qMakeField(next, i, drv->isUtf8));
+            sink->reportRecord(rec);
+        }
+        QSqlRecord row = rec;
+        for (int i = 0; i < row.count(); ++i)
+            row.setValue(i, result.data(i));
+        sink->reportRow(row);
+        if (!guard || current != generation)
+            return;
+    }
+    sink->flush();
+}
+
+// Drops the results of a cancelled statement that have arrived so far. Once
+// the last one is read, the connection is free again.
+void QPSQLAsyncExecutor::discardResults()
+{
+    QPSQLResultPrivate *d = result.d_func();
+    QPSQLDriverPrivate *drv = d->drv_d_func();
+    if (drv && drv->connection && drv->pendingResult == d) {
+        if (!PQconsumeInput(drv->connection))
+            drv->pendingResult = 0;
+        while (drv->pendingResult == d && !PQisBusy(drv->connection)) {
+            PGresult *next = PQgetResult(drv->connection);
+            if (!next)
+                drv->pendingResult = 0;
+            PQclear(next);
+        }
+        if (drv->pendingResult == d)
+            return;
+    }
+
+    // also drops the rows another query buffered while it needed the connection
+    draining = false;
+    notifier->setEnabled(false);
+    result.cleanup();
+    d->asyncExecutor = 0;
+}
+
+void QPSQLAsyncExecutor::finish()
+{
+    QPSQLDriverPrivate *drv = result.d_func()->drv_d_func();
+    running = false;
+    notifier->setEnabled(false);
+    result.d_func()->asyncExecutor = 0;
+
+    PGresult *last = lastResult;
+    lastResult = 0;
+    QSqlError error;
+    int numRowsAffected = -1;
+    QVariant insertId;
+    switch (last ? PQresultStatus(last) : PGRES_EMPTY_QUERY) {
+    case PGRES_TUPLES_OK:
+        if (rec.isEmpty()) {
+            for (int i = 0; i < PQnfields(last); ++i)
+                rec.append(qMakeField(last, i, drv->isUtf8));
+            sink->reportRecord(rec);
+        }
+        break;
+    case PGRES_COMMAND_OK: {
+        numRowsAffected = QString::fromLatin1(PQcmdTuples(last)).toInt();
+        commandFinished = true;
+        const Oid id = PQoidValue(last);
+        if (id != InvalidOid)
+            insertId = QVariant(id);
+        break;
+    }
+    case PGRES_EMPTY_QUERY:
+        break;
+    default:
+        error = qMakeError(QCoreApplication::translate("QPSQLResult", "Unable to create query"),
+                           QSqlError::StatementError, drv, last);
+        break;
+    }
+    if (last)
+        PQclear(last);
+    sink->reportFinished(error, numRowsAffected, insertId);
+}
+#endif
+
+QSqlAsyncExecutor *QPSQLDriverPrivate::createAsyncExecutor(QSqlAsyncQueryPrivate *sink)
+{
+#ifdef QPSQL_HAVE_SINGLE_ROW_MODE
+    Q_Q(QPSQLDriver);
+    if (connection)
+        return new QPSQLAsyncExecutor(q, sink);
+#else
+    Q_UNUSED(sink);
+#endif
+    return 0;
+}
+
 ///////////////////////////////////////////////////////////////////
 
 bool QPSQLDriverPrivate::setEncodingUtf8()
@@ -730,6 +1749,13 @@ void QPSQLDriverPrivate::detectBackslashEscape()
     }
 }
 
+void QPSQLDriverPrivate::detectIntegerDateTimes()
+{
+    // reported by the server on connect since 8.0, older servers use floating point
+    const char *value = PQparameterStatus(connection, "integer_datetimes");
+    integerDateTimes = value && qstrcmp(value, "on") == 0;
+}
+
 static QPSQLDriver::Protocol qMakePSQLVersion(int vMaj, int vMin)
 {
     switch (vMaj) {
@@ -868,6 +1894,7 @@ QPSQLDriver::QPSQLDriver(PGconn *conn, QObject *parent)
     if (conn) {
         d->pro = d->getPSQLVersion();
         d->detectBackslashEscape();
+        d->detectIntegerDateTimes();
         setOpen(true);
         setOpenError(false);
     }
@@ -876,6 +1903,7 @@ QPSQLDriver::QPSQLDriver(PGconn *conn, QObject *parent)
 QPSQLDriver::~QPSQLDriver()
 {
     Q_D(QPSQLDriver);
+    d->pendingResult = 0;
     if (d->connection)
         PQfinish(d->connection);
 }
@@ -890,8 +1918,10 @@ bool QPSQLDriver::hasFeature(DriverFeature f) const
 {
     Q_D(const QPSQLDriver);
     switch (f) {
-    case Transactions:
     case QuerySize:
+        // streamed forward-only results do not know their size
+        return !d->singleRowMode;
+    case Transactions:
     case LastInsertId:
     case LowPrecisionNumbers:
     case EventNotifications:
@@ -951,10 +1981,18 @@ bool QPSQLDriver::open(const QString & db,
         connectString.append(QLatin1String(" port=")).append(qQuote(QString::number(port)));
 
     // add any connect options - the server will handle error detection
-    if (!connOpts.isEmpty()) {
-        QString opt = connOpts;
-        opt.replace(QLatin1Char(';'), QLatin1Char(' '), Qt::CaseInsensitive);
-        connectString.append(QLatin1Char(' ')).append(opt);
+    d->singleRowMode = false;
+    const QStringList opts = connOpts.split(QLatin1Char(';'), QString::SkipEmptyParts);
+    for (const QString &opt : opts) {
+        if (opt.trimmed() == QLatin1String("QPSQL_SINGLE_ROW_MODE")) {
+#ifdef QPSQL_HAVE_SINGLE_ROW_MODE
+            d->singleRowMode = true;
+#else
+            qWarning("QPSQLDriver::open: QPSQL_SINGLE_ROW_MODE needs libpq 9.2 or later");
+#endif
+        } else {
+            connectString.append(QLatin1Char(' ')).append(opt);
+        }
     }
 
     d->connection = PQconnectdb(std::move(connectString).toLocal8Bit().constData());
@@ -968,6 +2006,7 @@ bool QPSQLDriver::open(const QString & db,
 
     d->pro = d->getPSQLVersion();
     d->detectBackslashEscape();
+    d->detectIntegerDateTimes();
     d->isUtf8 = d->setEncodingUtf8();
     d->setDatestyle();
     d->setByteaOutput();
@@ -989,6 +2028,7 @@ void QPSQLDriver::close()
             d->sn = 0;
         }
 
+        d->pendingResult = 0;
         if (d->connection)
             PQfinish(d->connection);
         d->connection = 0;
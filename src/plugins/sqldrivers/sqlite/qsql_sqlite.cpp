@@ -51,8 +51,8 @@
 #include <qstringlist.h>
 #include <qvector.h>
 #include <qdebug.h>
-#ifndef QT_NO_REGULAREXPRESSION
 #include <qcache.h>
+#ifndef QT_NO_REGULAREXPRESSION
 #include <qregularexpression.h>
 #endif
 #include <QTimeZone>
@@ -136,6 +136,15 @@ protected:
     QSqlRecord record() const Q_DECL_OVERRIDE;
     void detachFromResultSet() Q_DECL_OVERRIDE;
     void virtual_hook(int id, void *data) Q_DECL_OVERRIDE;
+    bool execBatch(bool arrayBind = false) Q_DECL_OVERRIDE;
+};
+
+// a prepared statement that is not in use by any result
+struct QSQLiteCachedStatement
+{
+    explicit QSQLiteCachedStatement(sqlite3_stmt *s) : stmt(s) { }
+    ~QSQLiteCachedStatement() { sqlite3_finalize(stmt); }
+    sqlite3_stmt *stmt;
 };
 
 class QSQLiteDriverPrivate : public QSqlDriverPrivate
@@ -143,12 +152,42 @@ class QSQLiteDriverPrivate : public QSqlDriverPrivate
     Q_DECLARE_PUBLIC(QSQLiteDriver)
 
 public:
-    inline QSQLiteDriverPrivate() : QSqlDriverPrivate(), access(0) { dbmsType = QSqlDriver::SQLite; }
+    enum { DefaultStatementCacheSize = 32 };
+
+    inline QSQLiteDriverPrivate()
+        : QSqlDriverPrivate(), access(0), statementCache(DefaultStatementCacheSize),
+          columnarCache(false)
+    { dbmsType = QSqlDriver::SQLite; }
     sqlite3 *access;
     QList <QSQLiteResult *> results;
     QStringList notificationid;
+    // least recently used statements get finalized first
+    QCache<QString, QSQLiteCachedStatement> statementCache;
+    bool columnarCache;
+
+    sqlite3_stmt *takeStatement(const QString &query);
+    void releaseStatement(const QString &query, sqlite3_stmt *stmt);
 };
 
+sqlite3_stmt *QSQLiteDriverPrivate::takeStatement(const QString &query)
+{
+    QSQLiteCachedStatement *cached = statementCache.take(query);
+    if (!cached)
+        return 0;
+    sqlite3_stmt *stmt = cached->stmt;
+    cached->stmt = 0;
+    delete cached;
+    return stmt;
+}
+
+void QSQLiteDriverPrivate::releaseStatement(const QString &query, sqlite3_stmt *stmt)
+{
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    // replaces and finalizes an equal statement released earlier
+    statementCache.insert(query, new QSQLiteCachedStatement(stmt));
+}
+
 
 class QSQLiteResultPrivate: public QSqlCachedResultPrivate
 {
@@ -162,8 +201,11 @@ public:
     // initializes the recordInfo and the cache
     void initColumns(bool emptyResultset);
     void finalize();
+    bool bindValues(QVector<QVariant> values);
+    bool execRow(const QVector<QVariant> &values);
 
     sqlite3_stmt *stmt;
+    QString stmtQuery; // key of stmt in the driver's statement cache
 
     bool skippedStatus; // the status of the fetchNext() that's skipped
     bool skipRow; // skip the next fetchNext()?
@@ -196,8 +238,13 @@ void QSQLiteResultPrivate::finalize()
     if (!stmt)
         return;
 
-    sqlite3_finalize(stmt);
+    QSQLiteDriverPrivate *drv = drv_d_func();
+    if (drv && !stmtQuery.isEmpty())
+        drv->releaseStatement(stmtQuery, stmt);
+    else
+        sqlite3_finalize(stmt);
     stmt = 0;
+    stmtQuery.clear();
 }
 
 void QSQLiteResultPrivate::initColumns(bool emptyResultset)
@@ -207,6 +254,8 @@ void QSQLiteResultPrivate::initColumns(bool emptyResultset)
     if (nCols <= 0)
         return;
 
+    if (const QSQLiteDriverPrivate *drv = drv_d_func())
+        columnarRequested = drv->columnarCache;
     q->init(nCols);
 
     for (int i = 0; i < nCols; ++i) {
@@ -270,10 +319,8 @@ bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int i
     }
     skipRow = initialFetch;
 
-    if(initialFetch) {
+    if(initialFetch)
         firstRow.clear();
-        firstRow.resize(sqlite3_column_count(stmt));
-    }
 
     if (!stmt) {
         q->setLastError(QSqlError(QCoreApplication::translate("QSQLiteResult", "Unable to fetch row"),
@@ -283,6 +330,12 @@ bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int i
     }
     res = sqlite3_step(stmt);
 
+    // a statement prepared before a schema change, for instance one from the
+    // statement cache, is compiled again by sqlite3_step() and may have other
+    // columns now
+    if (initialFetch)
+        firstRow.resize(sqlite3_column_count(stmt));
+
     switch(res) {
     case SQLITE_ROW:
         // check to see if should fill out columns
@@ -393,6 +446,12 @@ bool QSQLiteResult::prepare(const QString &query)
 
     setSelect(false);
 
+    d->stmt = d->drv_d_func()->takeStatement(query);
+    if (d->stmt) {
+        d->stmtQuery = query;
+        return true;
+    }
+
     const void *pzTail = NULL;
 
 #if (SQLITE_VERSION_NUMBER >= 3003011)
@@ -414,6 +473,7 @@ bool QSQLiteResult::prepare(const QString &query)
         d->finalize();
         return false;
     }
+    d->stmtQuery = query;
     return true;
 }
 
@@ -443,26 +503,11 @@ static QString timespecToString(const QDateTime &dateTime)
     }
 }
 
-bool QSQLiteResult::exec()
+bool QSQLiteResultPrivate::bindValues(QVector<QVariant> values)
 {
-    Q_D(QSQLiteResult);
-    QVector<QVariant> values = boundValues();
-
-    d->skippedStatus = false;
-    d->skipRow = false;
-    d->rInf.clear();
-    clearValues();
-    setLastError(QSqlError());
-
-    int res = sqlite3_reset(d->stmt);
-    if (res != SQLITE_OK) {
-        setLastError(qMakeError(d->drv_d_func()->access, QCoreApplication::translate("QSQLiteResult",
-                     "Unable to reset statement"), QSqlError::StatementError, res));
-        d->finalize();
-        return false;
-    }
-
-    int paramCount = sqlite3_bind_parameter_count(d->stmt);
+    Q_Q(QSQLiteResult);
+    int res;
+    int paramCount = sqlite3_bind_parameter_count(stmt);
     bool paramCountIsValid = paramCount == values.count();
 
 #if (SQLITE_VERSION_NUMBER >= 3003011)
@@ -472,8 +517,8 @@ bool QSQLiteResult::exec()
                                       return counter + indexList.length();
                                   };
 
-        const int bindParamCount = std::accumulate(d->indexes.cbegin(),
-                                                   d->indexes.cend(),
+        const int bindParamCount = std::accumulate(indexes.cbegin(),
+                                                   indexes.cend(),
                                                    0,
                                                    countIndexes);
 
@@ -486,9 +531,9 @@ bool QSQLiteResult::exec()
         for (int i = 0, currentIndex = 0; i < values.size(); ++i) {
             if (handledIndexes.contains(i))
                 continue;
-            const auto placeHolder = QString::fromUtf8(sqlite3_bind_parameter_name(d->stmt, currentIndex + 1));
-            handledIndexes << d->indexes[placeHolder];
-            prunedValues << values.at(d->indexes[placeHolder].first());
+            const auto placeHolder = QString::fromUtf8(sqlite3_bind_parameter_name(stmt, currentIndex + 1));
+            handledIndexes << indexes[placeHolder];
+            prunedValues << values.at(indexes[placeHolder].first());
             ++currentIndex;
         }
         values = prunedValues;
@@ -501,65 +546,115 @@ bool QSQLiteResult::exec()
             const QVariant value = values.at(i);
 
             if (value.isNull()) {
-                res = sqlite3_bind_null(d->stmt, i + 1);
+                res = sqlite3_bind_null(stmt, i + 1);
             } else {
                 switch (value.type()) {
                 case QVariant::ByteArray: {
                     const QByteArray *ba = static_cast<const QByteArray*>(value.constData());
-                    res = sqlite3_bind_blob(d->stmt, i + 1, ba->constData(),
+                    res = sqlite3_bind_blob(stmt, i + 1, ba->constData(),
                                             ba->size(), SQLITE_STATIC);
                     break; }
                 case QVariant::Int:
                 case QVariant::Bool:
-                    res = sqlite3_bind_int(d->stmt, i + 1, value.toInt());
+                    res = sqlite3_bind_int(stmt, i + 1, value.toInt());
                     break;
                 case QVariant::Double:
-                    res = sqlite3_bind_double(d->stmt, i + 1, value.toDouble());
+                    res = sqlite3_bind_double(stmt, i + 1, value.toDouble());
                     break;
                 case QVariant::UInt:
                 case QVariant::LongLong:
-                    res = sqlite3_bind_int64(d->stmt, i + 1, value.toLongLong());
+                    res = sqlite3_bind_int64(stmt, i + 1, value.toLongLong());
                     break;
                 case QVariant::DateTime: {
                     const QDateTime dateTime = value.toDateTime();
                     const QString str = dateTime.toString(QLatin1String("yyyy-MM-ddThh:mm:ss.zzz") + timespecToString(dateTime));
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.utf16(),
+                    res = sqlite3_bind_text16(stmt, i + 1, str.utf16(),
                                               str.size() * sizeof(ushort), SQLITE_TRANSIENT);
                     break;
                 }
                 case QVariant::Time: {
                     const QTime time = value.toTime();
                     const QString str = time.toString(QStringViewLiteral("hh:mm:ss.zzz"));
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.utf16(),
+                    res = sqlite3_bind_text16(stmt, i + 1, str.utf16(),
                                               str.size() * sizeof(ushort), SQLITE_TRANSIENT);
                     break;
                 }
                 case QVariant::String: {
                     // lifetime of string == lifetime of its qvariant
                     const QString *str = static_cast<const QString*>(value.constData());
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str->utf16(),
+                    res = sqlite3_bind_text16(stmt, i + 1, str->utf16(),
                                               (str->size()) * sizeof(QChar), SQLITE_STATIC);
                     break; }
                 default: {
                     QString str = value.toString();
                     // SQLITE_TRANSIENT makes sure that sqlite buffers the data
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.utf16(),
+                    res = sqlite3_bind_text16(stmt, i + 1, str.utf16(),
                                               (str.size()) * sizeof(QChar), SQLITE_TRANSIENT);
                     break; }
                 }
             }
             if (res != SQLITE_OK) {
-                setLastError(qMakeError(d->drv_d_func()->access, QCoreApplication::translate("QSQLiteResult",
+                q->setLastError(qMakeError(drv_d_func()->access, QCoreApplication::translate("QSQLiteResult",
                              "Unable to bind parameters"), QSqlError::StatementError, res));
-                d->finalize();
+                finalize();
                 return false;
             }
         }
     } else {
-        setLastError(QSqlError(QCoreApplication::translate("QSQLiteResult",
+        q->setLastError(QSqlError(QCoreApplication::translate("QSQLiteResult",
                         "Parameter count mismatch"), QString(), QSqlError::StatementError));
         return false;
     }
+    return true;
+}
+
+bool QSQLiteResultPrivate::execRow(const QVector<QVariant> &values)
+{
+    Q_Q(QSQLiteResult);
+    int res = sqlite3_reset(stmt);
+    if (res != SQLITE_OK) {
+        q->setLastError(qMakeError(drv_d_func()->access, QCoreApplication::translate("QSQLiteResult",
+                        "Unable to reset statement"), QSqlError::StatementError, res));
+        return false;
+    }
+    if (!bindValues(values))
+        return false;
+
+    do {
+        res = sqlite3_step(stmt);
+    } while (res == SQLITE_ROW);
+    if (res != SQLITE_DONE) {
+        // sqlite3_reset() returns the specific error code
+        res = sqlite3_reset(stmt);
+        q->setLastError(qMakeError(drv_d_func()->access, QCoreApplication::translate("QSQLiteResult",
+                        "Unable to execute statement"), QSqlError::StatementError, res));
+        return false;
+    }
+    return true;
+}
+
+bool QSQLiteResult::exec()
+{
+    Q_D(QSQLiteResult);
+    QVector<QVariant> values = boundValues();
+
+    d->skippedStatus = false;
+    d->skipRow = false;
+    d->rInf.clear();
+    clearValues();
+    setLastError(QSqlError());
+
+    int res = sqlite3_reset(d->stmt);
+    if (res != SQLITE_OK) {
+        setLastError(qMakeError(d->drv_d_func()->access, QCoreApplication::translate("QSQLiteResult",
+                     "Unable to reset statement"), QSqlError::StatementError, res));
+        d->finalize();
+        return false;
+    }
+
+    if (!d->bindValues(values))
+        return false;
+
     d->skippedStatus = d->fetchNext(d->firstRow, 0, true);
     if (lastError().isValid()) {
         setSelect(false);
@@ -571,6 +666,78 @@ bool QSQLiteResult::exec()
     return true;
 }
 
+bool QSQLiteResult::execBatch(bool arrayBind)
+{
+    Q_UNUSED(arrayBind);
+    Q_D(QSQLiteResult);
+    const QVector<QVariant> columns = boundValues();
+    if (columns.isEmpty()) {
+        setLastError(QSqlError(QCoreApplication::translate("QSQLiteResult", "Unable to execute statement"),
+                               QCoreApplication::translate("QSQLiteResult", "No values bound"),
+                               QSqlError::StatementError));
+        return false;
+    }
+    if (!d->stmt) {
+        setLastError(QSqlError(QCoreApplication::translate("QSQLiteResult", "Unable to execute statement"),
+                               QCoreApplication::translate("QSQLiteResult", "No query"), QSqlError::StatementError));
+        return false;
+    }
+
+    d->skippedStatus = false;
+    d->skipRow = false;
+    d->rInf.clear();
+    clearValues();
+    setLastError(QSqlError());
+    setSelect(false);
+    setActive(false);
+
+    QVector<QVariantList> lists;
+    lists.reserve(columns.count());
+    for (const QVariant &column : columns)
+        lists.append(column.toList());
+    const int rowCount = lists.at(0).count();
+    for (const QVariantList &list : qAsConst(lists)) {
+        if (list.count() != rowCount) {
+            setLastError(QSqlError(QCoreApplication::translate("QSQLiteResult", "Unable to execute statement"),
+                                   QCoreApplication::translate("QSQLiteResult", "Bound lists differ in length"),
+                                   QSqlError::StatementError));
+            return false;
+        }
+    }
+
+    // without a transaction every single row would be committed to disk
+    sqlite3 *access = d->drv_d_func()->access;
+    const bool ownTransaction = sqlite3_get_autocommit(access);
+    if (ownTransaction && sqlite3_exec(access, "BEGIN", NULL, NULL, NULL) != SQLITE_OK) {
+        setLastError(qMakeError(access, QCoreApplication::translate("QSQLiteResult",
+                     "Unable to begin transaction"), QSqlError::TransactionError));
+        return false;
+    }
+
+    QVector<QVariant> row(lists.count());
+    bool ok = true;
+    for (int i = 0; ok && i < rowCount; ++i) {
+        for (int j = 0; j < lists.count(); ++j)
+            row[j] = lists.at(j).at(i);
+        ok = d->execRow(row);
+    }
+    if (d->stmt)
+        sqlite3_reset(d->stmt);
+
+    if (ownTransaction) {
+        if (ok && sqlite3_exec(access, "COMMIT", NULL, NULL, NULL) != SQLITE_OK) {
+            setLastError(qMakeError(access, QCoreApplication::translate("QSQLiteResult",
+                         "Unable to commit transaction"), QSqlError::TransactionError));
+            ok = false;
+        }
+        if (!ok)
+            sqlite3_exec(access, "ROLLBACK", NULL, NULL, NULL);
+    }
+
+    setActive(ok);
+    return ok;
+}
+
 bool QSQLiteResult::gotoNext(QSqlCachedResult::ValueCache& row, int idx)
 {
     Q_D(QSQLiteResult);
@@ -718,7 +885,9 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
 
 
     int timeOut = 5000;
+    int statementCacheSize = QSQLiteDriverPrivate::DefaultStatementCacheSize;
     bool sharedCache = false;
+    bool columnarCache = false;
     bool openReadOnlyOption = false;
     bool openUriOption = false;
 #ifndef QT_NO_REGULAREXPRESSION
@@ -738,12 +907,22 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
                 if (ok)
                     timeOut = nt;
             }
+        } else if (option.startsWith(QLatin1String("QSQLITE_STATEMENT_CACHE_SIZE"))) {
+            option = option.mid(28).trimmed();
+            if (option.startsWith(QLatin1Char('='))) {
+                bool ok;
+                const int size = option.mid(1).trimmed().toInt(&ok);
+                if (ok && size >= 0)
+                    statementCacheSize = size;
+            }
         } else if (option == QLatin1String("QSQLITE_OPEN_READONLY")) {
             openReadOnlyOption = true;
         } else if (option == QLatin1String("QSQLITE_OPEN_URI")) {
             openUriOption = true;
         } else if (option == QLatin1String("QSQLITE_ENABLE_SHARED_CACHE")) {
             sharedCache = true;
+        } else if (option == QLatin1String("QSQLITE_COLUMNAR_CACHE")) {
+            columnarCache = true;
         }
 #ifndef QT_NO_REGULAREXPRESSION
         else if (option.startsWith(regexpConnectOption)) {
@@ -772,6 +951,8 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
 
     if (sqlite3_open_v2(db.toUtf8().constData(), &d->access, openMode, NULL) == SQLITE_OK) {
         sqlite3_busy_timeout(d->access, timeOut);
+        d->statementCache.setMaxCost(statementCacheSize);
+        d->columnarCache = columnarCache;
         setOpen(true);
         setOpenError(false);
 #ifndef QT_NO_REGULAREXPRESSION
@@ -801,6 +982,7 @@ void QSQLiteDriver::close()
     if (isOpen()) {
         for (QSQLiteResult *result : qAsConst(d->results))
             result->d_func()->finalize();
+        d->statementCache.clear();
 
         if (d->access && (d->notificationid.count() > 0)) {
             d->notificationid.clear();
@@ -60,3 +60,11 @@ model.setQuery("select * from MyTable");
 if (model.lastError().isValid())
     qDebug() << model.lastError();
 //! [1]
+
+
+//! [2]
+QSqlAsyncQuery *query = new QSqlAsyncQuery(db, model);
+query->prepare("SELECT name, salary FROM employee WHERE salary > ?");
+query->addBindValue(50000);
+model->setQuery(query);
+//! [2]
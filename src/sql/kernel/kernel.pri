@@ -2,6 +2,9 @@ HEADERS +=      kernel/qtsqlglobal.h \
                 kernel/qtsqlglobal_p.h \
                 kernel/qsqlquery.h \
                 kernel/qsqldatabase.h \
+                kernel/qsqlconnectionpool.h \
+                kernel/qsqlasyncquery.h \
+                kernel/qsqlasyncquery_p.h \
                 kernel/qsqlfield.h \
                 kernel/qsqlrecord.h \
                 kernel/qsqldriver.h \
@@ -16,6 +19,8 @@ HEADERS +=      kernel/qtsqlglobal.h \
 
 SOURCES +=      kernel/qsqlquery.cpp \
                 kernel/qsqldatabase.cpp \
+                kernel/qsqlconnectionpool.cpp \
+                kernel/qsqlasyncquery.cpp \
                 kernel/qsqlfield.cpp \
                 kernel/qsqlrecord.cpp \
                 kernel/qsqldriver.cpp \
@@ -0,0 +1,675 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsqlasyncquery.h"
+#include "qsqlasyncquery_p.h"
+#include "qsqldriver_p.h"
+#include "qsqlquery.h"
+#include "qsqlrecord.h"
+#include "qcoreapplication.h"
+#include "qglobalstatic.h"
+#include "qhash.h"
+#include "qmutex.h"
+#include "qsharedpointer.h"
+#include "qthread.h"
+
+QT_BEGIN_NAMESPACE
+
+// Worker thread with its own clone of a connection, shared by all
+// QSqlAsyncQuery objects that use that connection. Once released, the
+// worker is deleted in its own thread and the thread object after it has
+// finished, so nothing waits for a query that is still running.
+class QSqlAsyncWorker
+{
+public:
+    QSqlAsyncWorker(const QSqlDatabase &db, const QString &name)
+        : thread(new QThread), context(new QObject), source(db), connectionName(name), ref(1)
+    {
+        thread->setObjectName(QLatin1String("QSqlAsyncQuery"));
+        QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+        context->moveToThread(thread);
+        thread->start();
+    }
+    ~QSqlAsyncWorker() { context->deleteLater(); }
+
+    QSqlDatabase database();
+
+    QThread *thread;
+    QObject *context;
+    QSqlDatabase source;
+    QString connectionName;
+    int ref;
+};
+
+// Only called from the worker thread, so the clone is created there.
+QSqlDatabase QSqlAsyncWorker::database()
+{
+    QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+    if (!db.isValid()) {
+        db = QSqlDatabase::cloneDatabase(source, connectionName);
+        source = QSqlDatabase();
+    }
+    if (!db.isOpen())
+        db.open();
+    return db;
+}
+
+struct QSqlAsyncWorkers
+{
+    QMutex mutex;
+    QHash<QString, QSqlAsyncWorker *> workers;
+};
+
+Q_GLOBAL_STATIC(QSqlAsyncWorkers, qSqlAsyncWorkers)
+
+static QSqlAsyncWorker *qAcquireAsyncWorker(const QSqlDatabase &db)
+{
+    QSqlAsyncWorkers *w = qSqlAsyncWorkers();
+    QMutexLocker locker(&w->mutex);
+    QSqlAsyncWorker *&worker = w->workers[db.connectionName()];
+    if (worker) {
+        ++worker->ref;
+    } else {
+        static QBasicAtomicInt serial = Q_BASIC_ATOMIC_INITIALIZER(0);
+        const QString name = QLatin1String("qt_sql_async_")
+                + QString::number(serial.fetchAndAddRelaxed(1) + 1, 16);
+        worker = new QSqlAsyncWorker(db, name);
+    }
+    return worker;
+}
+
+static void qReleaseAsyncWorker(QSqlAsyncWorker *worker)
+{
+    QSqlAsyncWorkers *w = qSqlAsyncWorkers();
+    {
+        QMutexLocker locker(&w->mutex);
+        if (--worker->ref > 0)
+            return;
+        for (auto it = w->workers.begin(); it != w->workers.end(); ++it) {
+            if (it.value() == worker) {
+                w->workers.erase(it);
+                break;
+            }
+        }
+    }
+
+    // the clone has to be closed in the thread that created it, after the
+    // jobs that are still queued have seen that they were cancelled
+    QMetaObject::invokeMethod(worker->context, [worker]() {
+        QThread *thread = worker->thread;
+        const QString connectionName = worker->connectionName;
+        delete worker;
+        QSqlDatabase::removeDatabase(connectionName);
+        thread->quit();
+    }, Qt::QueuedConnection);
+}
+
+// State of one exec() shared between the caller and the worker thread.
+// Once the caller drops the job nothing is delivered to it any more, not
+// even what was posted before, so a query that is cancelled and executed
+// again never sees the events of the previous run.
+class QSqlAsyncJob : public QEnableSharedFromThis<QSqlAsyncJob>
+{
+public:
+    explicit QSqlAsyncJob(QObject *receiver) : receiver(receiver) { }
+
+    bool isCancelled() const { return cancelled.load(); }
+    void cancel()
+    {
+        QMutexLocker locker(&mutex);
+        cancelled.store(1);
+        receiver = nullptr;
+    }
+
+    template <typename Func>
+    void post(Func f)
+    {
+        QMutexLocker locker(&mutex);
+        if (!receiver)
+            return;
+        const QSharedPointer<QSqlAsyncJob> job = sharedFromThis();
+        QMetaObject::invokeMethod(receiver, [job, f]() {
+            if (!job->isCancelled())
+                f();
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    QMutex mutex;
+    QObject *receiver;
+    QAtomicInt cancelled;
+};
+
+class QSqlAsyncThreadExecutor : public QSqlAsyncExecutor
+{
+public:
+    QSqlAsyncThreadExecutor(QSqlAsyncQueryPrivate *sink, QSqlAsyncWorker *worker)
+        : QSqlAsyncExecutor(sink), worker(worker)
+    { }
+    ~QSqlAsyncThreadExecutor();
+
+    bool start() override;
+    void cancel() override;
+
+private:
+    static void run(QSqlAsyncWorker *worker, const QSharedPointer<QSqlAsyncJob> &job,
+                    QSqlAsyncThreadExecutor *executor, const QString &query,
+                    const QVector<QVariant> &values,
+                    const QVector<QPair<QString, QVariant> > &namedValues, int batchSize);
+
+    QSqlAsyncWorker *worker;
+    QSharedPointer<QSqlAsyncJob> job;
+};
+
+QSqlAsyncThreadExecutor::~QSqlAsyncThreadExecutor()
+{
+    cancel();
+    qReleaseAsyncWorker(worker);
+}
+
+bool QSqlAsyncThreadExecutor::start()
+{
+    cancel();
+    job = QSharedPointer<QSqlAsyncJob>::create(this);
+
+    QSqlAsyncWorker *worker = this->worker;
+    QSharedPointer<QSqlAsyncJob> job = this->job;
+    const QString query = sink->query;
+    const QVector<QVariant> values = sink->values;
+    const QVector<QPair<QString, QVariant> > namedValues = sink->namedValues;
+    const int batchSize = sink->batchSize;
+    QMetaObject::invokeMethod(worker->context, [=]() {
+        run(worker, job, this, query, values, namedValues, batchSize);
+    }, Qt::QueuedConnection);
+    return true;
+}
+
+void QSqlAsyncThreadExecutor::cancel()
+{
+    if (job) {
+        job->cancel();
+        job.reset();
+    }
+}
+
+// Runs in the worker thread. Everything that is reported back is posted
+// to the executor, which discards it once the job has been cancelled.
+void QSqlAsyncThreadExecutor::run(QSqlAsyncWorker *worker, const QSharedPointer<QSqlAsyncJob> &job,
+                                  QSqlAsyncThreadExecutor *executor, const QString &query,
+                                  const QVector<QVariant> &values,
+                                  const QVector<QPair<QString, QVariant> > &namedValues,
+                                  int batchSize)
+{
+    if (job->isCancelled())
+        return;
+
+    QSqlDatabase db = worker->database();
+    if (!db.isOpen()) {
+        const QSqlError error = db.lastError();
+        job->post([executor, error]() { executor->sink->reportFinished(error); });
+        return;
+    }
+
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    bool ok;
+    if (values.isEmpty() && namedValues.isEmpty()) {
+        ok = q.exec(query);
+    } else {
+        ok = q.prepare(query);
+        for (int i = 0; i < values.count(); ++i)
+            q.bindValue(i, values.at(i));
+        for (const auto &value : namedValues)
+            q.bindValue(value.first, value.second);
+        ok = ok && q.exec();
+    }
+    if (!ok) {
+        const QSqlError error = q.lastError();
+        job->post([executor, error]() { executor->sink->reportFinished(error); });
+        return;
+    }
+
+    if (!q.isSelect()) {
+        const int numRowsAffected = q.numRowsAffected();
+        const QVariant lastInsertId = q.lastInsertId();
+        job->post([executor, numRowsAffected, lastInsertId]() {
+            executor->sink->reportFinished(QSqlError(), numRowsAffected, lastInsertId);
+        });
+        return;
+    }
+
+    const QSqlRecord record = q.record();
+    job->post([executor, record]() { executor->sink->reportRecord(record); });
+
+    const int count = record.count();
+    QVector<QSqlRecord> rows;
+    rows.reserve(batchSize);
+    while (q.next()) {
+        if (job->isCancelled())
+            return;
+        QSqlRecord row = record;
+        for (int i = 0; i < count; ++i)
+            row.setValue(i, q.value(i));
+        rows.append(row);
+        if (rows.count() >= batchSize) {
+            job->post([executor, rows]() { executor->sink->reportRows(rows); });
+            rows.clear();
+            rows.reserve(batchSize);
+        }
+    }
+    if (!rows.isEmpty())
+        job->post([executor, rows]() { executor->sink->reportRows(rows); });
+
+    QSqlError error;
+    if (q.lastError().isValid())
+        error = q.lastError();
+    job->post([executor, error]() { executor->sink->reportFinished(error); });
+}
+
+QSqlAsyncExecutor::QSqlAsyncExecutor(QSqlAsyncQueryPrivate *sink)
+    : sink(sink)
+{
+}
+
+QSqlAsyncExecutor::~QSqlAsyncExecutor()
+{
+}
+
+QVariant QSqlAsyncExecutor::lastInsertId() const
+{
+    return sink->insertId;
+}
+
+QSqlAsyncExecutor *QSqlAsyncQueryPrivate::createNativeExecutor()
+{
+    QSqlDriver *driver = db.driver();
+    if (!driver || !db.isOpen() || driver->thread() != QThread::currentThread())
+        return nullptr;
+    QSqlDriverPrivate *drv = static_cast<QSqlDriverPrivate *>(QObjectPrivate::get(driver));
+    return drv->createAsyncExecutor(this);
+}
+
+void QSqlAsyncQueryPrivate::reportRecord(const QSqlRecord &record)
+{
+    rec = record;
+}
+
+void QSqlAsyncQueryPrivate::reportRow(const QSqlRecord &row)
+{
+    batch.append(row);
+    if (batch.count() >= batchSize)
+        flush();
+}
+
+void QSqlAsyncQueryPrivate::reportRows(const QVector<QSqlRecord> &rows)
+{
+    Q_Q(QSqlAsyncQuery);
+    flush();
+    if (active)
+        emit q->rowsReady(rows);
+}
+
+void QSqlAsyncQueryPrivate::flush()
+{
+    Q_Q(QSqlAsyncQuery);
+    if (batch.isEmpty() || !active)
+        return;
+    QVector<QSqlRecord> rows;
+    rows.swap(batch);
+    emit q->rowsReady(rows);
+}
+
+void QSqlAsyncQueryPrivate::reportFinished(const QSqlError &error, int numRowsAffected,
+                                           const QVariant &lastInsertId)
+{
+    Q_Q(QSqlAsyncQuery);
+    flush();
+    if (!active)
+        return;
+    active = false;
+    this->error = error;
+    this->numRowsAffected = numRowsAffected;
+    insertId = lastInsertId;
+    emit q->finished();
+}
+
+/*!
+    \class QSqlAsyncQuery
+    \brief The QSqlAsyncQuery class executes SQL statements without
+    blocking the calling thread.
+    \since 5.11
+
+    \ingroup database
+    \inmodule QtSql
+
+    QSqlAsyncQuery runs a statement in the background and delivers the
+    rows of its result set in batches through the rowsReady() signal as
+    they are read, followed by finished() once the whole result has
+    been read or an error occurred. The thread that calls exec() keeps
+    running its event loop in the meantime, so a GUI stays responsive
+    while a large result is transferred:
+
+    \snippet code/src_sql_kernel_qsqlasyncquery.cpp 0
+
+    By default the statement is executed on a worker thread that is
+    shared by all QSqlAsyncQuery objects using the same connection. The
+    worker thread works on its own clone of the connection (see
+    QSqlDatabase::cloneDatabase()), which is a separate database
+    session: it does not see uncommitted changes of the original
+    connection, and in-memory SQLite databases are not shared with it.
+    Drivers that can stream a result from the server without blocking,
+    such as the PostgreSQL driver, execute the statement on the
+    original connection in the calling thread instead. The connection
+    should not be used for anything else until finished() has been
+    emitted in that case.
+
+    Values are bound like with QSqlQuery, using prepare() followed by
+    bindValue() or addBindValue(). A QSqlQueryModel can be populated
+    incrementally from a QSqlAsyncQuery, see QSqlQueryModel::setQuery().
+
+    \sa QSqlQuery, QSqlQueryModel
+*/
+
+/*!
+    \fn void QSqlAsyncQuery::rowsReady(const QVector<QSqlRecord> &rows)
+
+    This signal is emitted when a batch of \a rows of the result set
+    has been read. Each record holds the values of one row. At most
+    batchSize() rows are delivered at a time.
+
+    \sa record(), finished()
+*/
+
+/*!
+    \fn void QSqlAsyncQuery::finished()
+
+    This signal is emitted when the statement has completed, all rows
+    of its result set have been delivered through rowsReady() or an
+    error occurred. lastError() tells whether the statement succeeded.
+    It is not emitted for statements that are cancelled.
+*/
+
+/*!
+    Creates a QSqlAsyncQuery for the default connection with the given
+    \a parent.
+*/
+QSqlAsyncQuery::QSqlAsyncQuery(QObject *parent)
+    : QObject(*new QSqlAsyncQueryPrivate, parent)
+{
+    Q_D(QSqlAsyncQuery);
+    d->db = QSqlDatabase::database(QLatin1String(QSqlDatabase::defaultConnection), false);
+}
+
+/*!
+    Creates a QSqlAsyncQuery for the connection \a db with the given
+    \a parent.
+*/
+QSqlAsyncQuery::QSqlAsyncQuery(const QSqlDatabase &db, QObject *parent)
+    : QObject(*new QSqlAsyncQueryPrivate, parent)
+{
+    Q_D(QSqlAsyncQuery);
+    d->db = db;
+}
+
+/*!
+    Destroys the query, cancelling it if it is still running.
+*/
+QSqlAsyncQuery::~QSqlAsyncQuery()
+{
+    Q_D(QSqlAsyncQuery);
+    cancel();
+    delete d->nativeExecutor;
+    delete d->threadExecutor;
+}
+
+/*!
+    Returns the connection the query is executed on.
+*/
+QSqlDatabase QSqlAsyncQuery::database() const
+{
+    Q_D(const QSqlAsyncQuery);
+    return d->db;
+}
+
+/*!
+    Sets the maximum number of rows delivered in one rowsReady() signal
+    to \a rows. The default is 256.
+*/
+void QSqlAsyncQuery::setBatchSize(int rows)
+{
+    Q_D(QSqlAsyncQuery);
+    d->batchSize = qMax(rows, 1);
+}
+
+/*!
+    Returns the maximum number of rows delivered in one rowsReady() signal.
+*/
+int QSqlAsyncQuery::batchSize() const
+{
+    Q_D(const QSqlAsyncQuery);
+    return d->batchSize;
+}
+
+/*!
+    Sets the statement to execute with the next exec() to \a query and
+    clears all bound values. Placeholders are used as in
+    QSqlQuery::prepare(). The statement is only sent to the database
+    by exec().
+*/
+void QSqlAsyncQuery::prepare(const QString &query)
+{
+    Q_D(QSqlAsyncQuery);
+    d->query = query;
+    d->values.clear();
+    d->namedValues.clear();
+}
+
+/*!
+    Binds the value \a val to the named \a placeholder.
+
+    \sa QSqlQuery::bindValue()
+*/
+void QSqlAsyncQuery::bindValue(const QString &placeholder, const QVariant &val)
+{
+    Q_D(QSqlAsyncQuery);
+    for (auto &value : d->namedValues) {
+        if (value.first == placeholder) {
+            value.second = val;
+            return;
+        }
+    }
+    d->namedValues.append(qMakePair(placeholder, val));
+}
+
+/*!
+    \overload
+
+    Binds the value \a val to the placeholder at position \a pos.
+*/
+void QSqlAsyncQuery::bindValue(int pos, const QVariant &val)
+{
+    Q_D(QSqlAsyncQuery);
+    if (pos < 0)
+        return;
+    if (pos >= d->values.count())
+        d->values.resize(pos + 1);
+    d->values[pos] = val;
+}
+
+/*!
+    Binds the value \a val to the next positional placeholder.
+
+    \sa QSqlQuery::addBindValue()
+*/
+void QSqlAsyncQuery::addBindValue(const QVariant &val)
+{
+    Q_D(QSqlAsyncQuery);
+    d->values.append(val);
+}
+
+/*!
+    Returns the statement set with prepare() or exec().
+*/
+QString QSqlAsyncQuery::lastQuery() const
+{
+    Q_D(const QSqlAsyncQuery);
+    return d->query;
+}
+
+/*!
+    Starts executing \a query without any bound values. Returns \c true
+    if the query was started; the result is reported through
+    rowsReady() and finished().
+
+    \sa prepare()
+*/
+bool QSqlAsyncQuery::exec(const QString &query)
+{
+    prepare(query);
+    return exec();
+}
+
+/*!
+    \overload
+
+    Starts executing the statement set with prepare() using the values
+    bound to it. Any query that is still running is cancelled first.
+    Returns \c false, without emitting any signals, if the connection
+    is not valid.
+*/
+bool QSqlAsyncQuery::exec()
+{
+    Q_D(QSqlAsyncQuery);
+    cancel();
+    d->rec.clear();
+    d->error = QSqlError();
+    d->numRowsAffected = -1;
+    d->insertId = QVariant();
+
+    if (!d->db.isValid()) {
+        d->error = QSqlError(QLatin1String("Driver not loaded"), QLatin1String("Driver not loaded"),
+                             QSqlError::ConnectionError);
+        return false;
+    }
+
+    d->active = true;
+    if (d->namedValues.isEmpty()) {
+        if (!d->nativeExecutor)
+            d->nativeExecutor = d->createNativeExecutor();
+        if (d->nativeExecutor && d->nativeExecutor->start()) {
+            d->executor = d->nativeExecutor;
+            return true;
+        }
+    }
+    if (!d->threadExecutor)
+        d->threadExecutor = new QSqlAsyncThreadExecutor(d, qAcquireAsyncWorker(d->db));
+    d->executor = d->threadExecutor;
+    return d->executor->start();
+}
+
+/*!
+    Cancels the running query. No further signals are emitted for it.
+    Rows that have already been delivered are not affected.
+
+    A statement that is being executed on the worker thread still runs to
+    completion there, but its result is no longer read.
+*/
+void QSqlAsyncQuery::cancel()
+{
+    Q_D(QSqlAsyncQuery);
+    if (d->executor)
+        d->executor->cancel();
+    d->executor = nullptr;
+    d->batch.clear();
+    d->active = false;
+}
+
+/*!
+    Returns \c true while the query is running, that is from exec() until
+    finished() is emitted or the query is cancelled.
+*/
+bool QSqlAsyncQuery::isActive() const
+{
+    Q_D(const QSqlAsyncQuery);
+    return d->active;
+}
+
+/*!
+    Returns a record describing the columns of the result set. It is
+    available before the first rowsReady() signal is emitted.
+*/
+QSqlRecord QSqlAsyncQuery::record() const
+{
+    Q_D(const QSqlAsyncQuery);
+    return d->rec;
+}
+
+/*!
+    Returns the error of the last query, if any.
+*/
+QSqlError QSqlAsyncQuery::lastError() const
+{
+    Q_D(const QSqlAsyncQuery);
+    return d->error;
+}
+
+/*!
+    Returns the number of rows affected by the last non-SELECT statement,
+    or -1 if it is unknown.
+*/
+int QSqlAsyncQuery::numRowsAffected() const
+{
+    Q_D(const QSqlAsyncQuery);
+    return d->numRowsAffected;
+}
+
+/*!
+    Returns the object ID of the most recently inserted row, if the
+    driver supports it.
+
+    \sa QSqlQuery::lastInsertId()
+*/
+QVariant QSqlAsyncQuery::lastInsertId() const
+{
+    Q_D(const QSqlAsyncQuery);
+    return d->executor ? d->executor->lastInsertId() : d->insertId;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,98 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSQLASYNCQUERY_H
+#define QSQLASYNCQUERY_H
+
+#include <QtSql/qtsqlglobal.h>
+#include <QtSql/qsqldatabase.h>
+#include <QtSql/qsqlrecord.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+
+class QSqlAsyncQueryPrivate;
+class QSqlError;
+class QVariant;
+
+class Q_SQL_EXPORT QSqlAsyncQuery : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QSqlAsyncQuery)
+
+public:
+    explicit QSqlAsyncQuery(QObject *parent = nullptr);
+    explicit QSqlAsyncQuery(const QSqlDatabase &db, QObject *parent = nullptr);
+    ~QSqlAsyncQuery();
+
+    QSqlDatabase database() const;
+
+    void setBatchSize(int rows);
+    int batchSize() const;
+
+    void prepare(const QString &query);
+    void bindValue(const QString &placeholder, const QVariant &val);
+    void bindValue(int pos, const QVariant &val);
+    void addBindValue(const QVariant &val);
+    QString lastQuery() const;
+
+    bool exec(const QString &query);
+    bool exec();
+    void cancel();
+
+    bool isActive() const;
+    QSqlRecord record() const;
+    QSqlError lastError() const;
+    int numRowsAffected() const;
+    QVariant lastInsertId() const;
+
+Q_SIGNALS:
+    void rowsReady(const QVector<QSqlRecord> &rows);
+    void finished();
+
+private:
+    Q_DISABLE_COPY(QSqlAsyncQuery)
+};
+
+QT_END_NAMESPACE
+
+#endif // QSQLASYNCQUERY_H
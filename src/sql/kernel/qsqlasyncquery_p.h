@@ -0,0 +1,129 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSQLASYNCQUERY_P_H
+#define QSQLASYNCQUERY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the QtSQL module and its drivers.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtSql/private/qtsqlglobal_p.h>
+#include "private/qobject_p.h"
+#include "QtSql/qsqlasyncquery.h"
+#include "QtSql/qsqlerror.h"
+#include "QtCore/qpair.h"
+#include "QtCore/qvariant.h"
+
+QT_BEGIN_NAMESPACE
+
+class QSqlAsyncQueryPrivate;
+
+// Runs the query of a QSqlAsyncQuery and reports the result back to it.
+// Drivers that can stream a result without blocking provide one through
+// QSqlDriverPrivate::createAsyncExecutor(); all others run the query on
+// a worker thread. Executors live in the thread of the QSqlAsyncQuery
+// and must only call the report functions of the sink from there.
+class Q_SQL_EXPORT QSqlAsyncExecutor : public QObject
+{
+public:
+    explicit QSqlAsyncExecutor(QSqlAsyncQueryPrivate *sink);
+    ~QSqlAsyncExecutor();
+
+    // Starts the query and the bound values of the sink, cancelling any
+    // query that is still running. Returns false if the executor can't run
+    // this query, in which case it is run on the worker thread instead.
+    virtual bool start() = 0;
+    virtual void cancel() = 0;
+    virtual QVariant lastInsertId() const;
+
+protected:
+    QSqlAsyncQueryPrivate *sink;
+};
+
+class Q_SQL_EXPORT QSqlAsyncQueryPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QSqlAsyncQuery)
+
+public:
+    QSqlAsyncQueryPrivate()
+        : nativeExecutor(nullptr),
+          threadExecutor(nullptr),
+          executor(nullptr),
+          batchSize(256),
+          numRowsAffected(-1),
+          active(false)
+    { }
+
+    QSqlAsyncExecutor *createNativeExecutor();
+
+    void reportRecord(const QSqlRecord &record);
+    void reportRow(const QSqlRecord &row);
+    void reportRows(const QVector<QSqlRecord> &rows);
+    void flush();
+    void reportFinished(const QSqlError &error, int numRowsAffected = -1,
+                        const QVariant &lastInsertId = QVariant());
+
+    QSqlDatabase db;
+    QString query;
+    QVector<QVariant> values;
+    QVector<QPair<QString, QVariant> > namedValues;
+    QSqlRecord rec;
+    QSqlError error;
+    QVector<QSqlRecord> batch;
+    QSqlAsyncExecutor *nativeExecutor;
+    QSqlAsyncExecutor *threadExecutor;
+    QSqlAsyncExecutor *executor;
+    QVariant insertId;
+    int batchSize;
+    int numRowsAffected;
+    bool active;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSQLASYNCQUERY_P_H
@@ -56,21 +56,235 @@ QT_BEGIN_NAMESPACE
    will give you an index where you can start filling in your data. Special
    case: If the user actually wants a forward-only query, idx will be -1
    to indicate that we are not interested in the actual values.
+
+   If a driver sets columnarRequested, scrollable results are not kept as
+   one QVariant per cell. gotoNext() then always fills the first row of the
+   cache, and that row is packed into one QSqlCachedColumn per column:
+   typed vectors of 64 bit integers, doubles or bits, or a string arena,
+   plus a null bitmap. QVariants are only created again when a value is
+   read. A column whose values do not share one type falls back to
+   storing QVariants. Setting QT_SQL_COLUMNAR_CACHE to 1 or 0 overrides
+   the driver's choice for all results.
 */
 
 static const uint initial_cache_size = 128;
 
+// -1 if QT_SQL_COLUMNAR_CACHE is not set, otherwise whether it enables the columnar cache
+static int columnarOverride()
+{
+    static const int value = qEnvironmentVariableIsSet("QT_SQL_COLUMNAR_CACHE")
+                             ? (qEnvironmentVariableIntValue("QT_SQL_COLUMNAR_CACHE") > 0) : -1;
+    return value;
+}
+
+static const int max_arena_size = 1 << 29;
+
+QSqlCachedColumn::Storage QSqlCachedColumn::storageFor(int type)
+{
+    switch (type) {
+    case QVariant::Int:
+    case QVariant::UInt:
+    case QVariant::LongLong:
+    case QVariant::ULongLong:
+        return Integer;
+    case QVariant::Double:
+        return Real;
+    case QVariant::Bool:
+        return Boolean;
+    case QVariant::String:
+        return String;
+    default:
+        return Generic;
+    }
+}
+
+void QSqlCachedColumn::setStorage(Storage s)
+{
+    // all rows stored so far are null, they still need a slot
+    storage = s;
+    switch (s) {
+    case Integer:
+        integers.fill(0, rows);
+        break;
+    case Real:
+        reals.fill(0.0, rows);
+        break;
+    case Boolean:
+        booleans.fill(0, (rows + 63) / 64);
+        break;
+    case String:
+        offsets.fill(0, rows);
+        break;
+    case Empty:
+    case Generic:
+        break;
+    }
+}
+
+void QSqlCachedColumn::makeGeneric()
+{
+    QVector<QVariant> values;
+    values.reserve(rows + 1);
+    for (int row = 0; row < rows; ++row)
+        values.append(value(row));
+    const int count = rows;
+    clear();
+    variants.swap(values);
+    rows = count;
+    storage = Generic;
+}
+
+void QSqlCachedColumn::append(const QVariant &v)
+{
+    const bool null = v.isNull();
+    const int type = v.userType();
+    if (storage != Generic) {
+        if (null) {
+            if (nullType == -1)
+                nullType = type;
+            else if (nullType != type)
+                makeGeneric();
+        } else if (storage == Empty) {
+            const Storage s = storageFor(type);
+            if (s == Generic) {
+                makeGeneric();
+            } else {
+                valueType = type;
+                setStorage(s);
+            }
+        } else if (type != valueType) {
+            makeGeneric();
+        } else if (storage == String
+                   && v.constData() && static_cast<const QString *>(v.constData())->size() > max_arena_size - arena.size()) {
+            makeGeneric();
+        }
+    }
+
+    switch (storage) {
+    case Empty:
+        break;
+    case Integer: {
+        qint64 i = 0;
+        if (!null) {
+            switch (valueType) {
+            case QVariant::Int:
+                i = *static_cast<const int *>(v.constData());
+                break;
+            case QVariant::UInt:
+                i = *static_cast<const uint *>(v.constData());
+                break;
+            default:
+                i = *static_cast<const qint64 *>(v.constData());
+                break;
+            }
+        }
+        integers.append(i);
+        break;
+    }
+    case Real:
+        reals.append(null ? 0.0 : *static_cast<const double *>(v.constData()));
+        break;
+    case Boolean:
+        appendBit(booleans, !null && *static_cast<const bool *>(v.constData()));
+        break;
+    case String:
+        if (!null)
+            arena.append(*static_cast<const QString *>(v.constData()));
+        offsets.append(arena.size());
+        break;
+    case Generic:
+        variants.append(v);
+        ++rows;
+        return;
+    }
+    appendBit(nulls, null);
+    ++rows;
+}
+
+QVariant QSqlCachedColumn::value(int row) const
+{
+    switch (storage) {
+    case Generic:
+        return variants.at(row);
+    case Empty:
+        return QVariant(QVariant::Type(nullType));
+    default:
+        break;
+    }
+    if (testBit(nulls, row))
+        return QVariant(QVariant::Type(nullType));
+
+    switch (storage) {
+    case Integer: {
+        const qint64 i = integers.at(row);
+        switch (valueType) {
+        case QVariant::Int:
+            return QVariant(int(i));
+        case QVariant::UInt:
+            return QVariant(uint(i));
+        case QVariant::ULongLong:
+            return QVariant(qulonglong(i));
+        default:
+            return QVariant(qlonglong(i));
+        }
+    }
+    case Real:
+        return QVariant(reals.at(row));
+    case Boolean:
+        return QVariant(testBit(booleans, row));
+    case String: {
+        const int begin = row ? offsets.at(row - 1) : 0;
+        return QVariant(QString(arena.constData() + begin, offsets.at(row) - begin));
+    }
+    default:
+        Q_UNREACHABLE();
+        return QVariant();
+    }
+}
+
+bool QSqlCachedColumn::isNull(int row) const
+{
+    switch (storage) {
+    case Generic:
+        return variants.at(row).isNull();
+    case Empty:
+        return true;
+    default:
+        return testBit(nulls, row);
+    }
+}
+
+void QSqlCachedColumn::clear()
+{
+    storage = Empty;
+    valueType = QVariant::Invalid;
+    nullType = -1;
+    rows = 0;
+    nulls.clear();
+    integers.clear();
+    reals.clear();
+    booleans.clear();
+    arena.clear();
+    offsets.clear();
+    variants.clear();
+}
+
+//////////////
+
 QSqlCachedResultPrivate::QSqlCachedResultPrivate(QSqlCachedResult *q, const QSqlDriver *drv)
     : QSqlResultPrivate(q, drv),
       rowCacheEnd(0),
       colCount(0),
-      atEnd(false)
+      atEnd(false),
+      columnarRequested(false),
+      columnar(false)
 {
 }
 
 void QSqlCachedResultPrivate::cleanup()
 {
     cache.clear();
+    columns.clear();
     atEnd = false;
     colCount = 0;
     rowCacheEnd = 0;
@@ -82,9 +296,14 @@ void QSqlCachedResultPrivate::init(int count, bool fo)
     cleanup();
     forwardOnly = fo;
     colCount = count;
+    const int forced = columnarOverride();
+    columnar = !fo && (forced < 0 ? columnarRequested : forced != 0);
     if (fo) {
         cache.resize(count);
         rowCacheEnd = count;
+    } else if (columnar) {
+        cache.resize(count);
+        columns.resize(count);
     } else {
         cache.resize(initial_cache_size * count);
     }
@@ -94,6 +313,10 @@ int QSqlCachedResultPrivate::nextIndex()
 {
     if (forwardOnly)
         return 0;
+    if (columnar) {
+        rowCacheEnd += colCount;
+        return 0;
+    }
     int newIdx = rowCacheEnd;
     if (newIdx + colCount > cache.size())
         cache.resize(qMin(cache.size() * 2, cache.size() + 10000));
@@ -116,6 +339,12 @@ void QSqlCachedResultPrivate::revertLast()
     rowCacheEnd -= colCount;
 }
 
+void QSqlCachedResultPrivate::storeRow()
+{
+    for (int i = 0; i < colCount; ++i)
+        columns[i].append(cache.at(i));
+}
+
 inline int QSqlCachedResultPrivate::cacheCount() const
 {
     Q_ASSERT(!forwardOnly);
@@ -230,6 +459,8 @@ QVariant QSqlCachedResult::data(int i)
     int idx = d->forwardOnly ? i : at() * d->colCount + i;
     if (i >= d->colCount || i < 0 || at() < 0 || idx >= d->rowCacheEnd)
         return QVariant();
+    if (d->columnar)
+        return d->columns.at(i).value(at());
 
     return d->cache.at(idx);
 }
@@ -240,6 +471,8 @@ bool QSqlCachedResult::isNull(int i)
     int idx = d->forwardOnly ? i : at() * d->colCount + i;
     if (i >= d->colCount || i < 0 || at() < 0 || idx >= d->rowCacheEnd)
         return true;
+    if (d->columnar)
+        return d->columns.at(i).isNull(at());
 
     return d->cache.at(idx).isNull();
 }
@@ -258,6 +491,8 @@ void QSqlCachedResult::clearValues()
     setAt(QSql::BeforeFirstRow);
     d->rowCacheEnd = 0;
     d->atEnd = false;
+    for (QSqlCachedColumn &column : d->columns)
+        column.clear();
 }
 
 bool QSqlCachedResult::cacheNext()
@@ -275,6 +510,8 @@ bool QSqlCachedResult::cacheNext()
         d->atEnd = true;
         return false;
     }
+    if (d->columnar)
+        d->storeRow();
     setAt(at() + 1);
     return true;
 }
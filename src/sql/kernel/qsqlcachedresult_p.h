@@ -54,12 +54,12 @@
 #include <QtSql/private/qtsqlglobal_p.h>
 #include "QtSql/qsqlresult.h"
 #include "QtSql/private/qsqlresult_p.h"
+#include <QtCore/qstring.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
 
 QT_BEGIN_NAMESPACE
 
-class QVariant;
-template <typename T> class QVector;
-
 class QSqlCachedResultPrivate;
 
 class Q_SQL_EXPORT QSqlCachedResult: public QSqlResult
@@ -96,6 +96,44 @@ private:
     bool cacheNext();
 };
 
+class QSqlCachedColumn
+{
+public:
+    void append(const QVariant &value);
+    QVariant value(int row) const;
+    bool isNull(int row) const;
+    void clear();
+
+private:
+    enum Storage { Empty, Integer, Real, Boolean, String, Generic };
+
+    static Storage storageFor(int type);
+    void setStorage(Storage s);
+    void makeGeneric();
+
+    inline bool testBit(const QVector<quint64> &bits, int row) const
+    { return bits.at(row >> 6) & (Q_UINT64_C(1) << (row & 63)); }
+    inline void appendBit(QVector<quint64> &bits, bool on)
+    {
+        if (!(rows & 63))
+            bits.append(0);
+        if (on)
+            bits.last() |= Q_UINT64_C(1) << (rows & 63);
+    }
+
+    Storage storage = Empty;
+    int valueType = QVariant::Invalid;
+    int nullType = -1;
+    int rows = 0;
+    QVector<quint64> nulls;
+    QVector<qint64> integers;
+    QVector<double> reals;
+    QVector<quint64> booleans;
+    QString arena;
+    QVector<int> offsets;
+    QVector<QVariant> variants;
+};
+
 class Q_SQL_EXPORT QSqlCachedResultPrivate: public QSqlResultPrivate
 {
     Q_DECLARE_PUBLIC(QSqlCachedResult)
@@ -108,11 +146,15 @@ public:
     void cleanup();
     int nextIndex();
     void revertLast();
+    void storeRow();
 
     QSqlCachedResult::ValueCache cache;
+    QVector<QSqlCachedColumn> columns;
     int rowCacheEnd;
     int colCount;
     bool atEnd;
+    bool columnarRequested;
+    bool columnar;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,495 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsqlconnectionpool.h"
+#include "qsqlquery.h"
+#include "qdebug.h"
+#include "qelapsedtimer.h"
+#include "qhash.h"
+#include "qmutex.h"
+#include "qstringlist.h"
+#include "qthread.h"
+#include "qvector.h"
+#include "qwaitcondition.h"
+
+QT_BEGIN_NAMESPACE
+
+void qt_sqlDatabaseDetach(const QString &name);
+
+class QSqlConnectionPoolPrivate
+{
+public:
+    struct Connection
+    {
+        QString name;
+        QThread *thread;
+        qint64 idleSince;
+        bool inUse;
+    };
+
+    explicit QSqlConnectionPoolPrivate(const QSqlDatabase &db)
+        : prototype(db),
+          maxConnections(qMax(QThread::idealThreadCount(), 1)),
+          idleTimeout(30000),
+          serial(0)
+    {
+        clock.start();
+    }
+
+    int findIdle(QThread *thread) const;
+    int findLeastRecentlyUsed() const;
+    QStringList takeExpired();
+    QStringList takeThreadConnections(QThread *thread);
+    void watchThread(QThread *thread, const QSharedPointer<QSqlConnectionPoolPrivate> &self);
+    bool isHealthy(QSqlDatabase &db) const;
+
+    QMutex mutex;
+    QWaitCondition connectionReleased;
+    QSqlDatabase prototype;
+    QString healthCheckQuery;
+    QVector<Connection> connections;
+    QHash<QThread *, QMetaObject::Connection> watchedThreads;
+    QElapsedTimer clock;
+    int maxConnections;
+    int idleTimeout;
+    int serial;
+};
+
+// Returns an idle connection created in \a thread, or any idle connection if
+// \a thread is null. Must be called with the mutex locked.
+int QSqlConnectionPoolPrivate::findIdle(QThread *thread) const
+{
+    for (int i = connections.size() - 1; i >= 0; --i) {
+        const Connection &c = connections.at(i);
+        if (!c.inUse && (!thread || c.thread == thread))
+            return i;
+    }
+    return -1;
+}
+
+// Returns the idle connection that was released first, of any thread.
+int QSqlConnectionPoolPrivate::findLeastRecentlyUsed() const
+{
+    int found = -1;
+    for (int i = 0; i < connections.size(); ++i) {
+        const Connection &c = connections.at(i);
+        if (!c.inUse && (found < 0 || c.idleSince < connections.at(found).idleSince))
+            found = i;
+    }
+    return found;
+}
+
+QStringList QSqlConnectionPoolPrivate::takeExpired()
+{
+    QStringList names;
+    if (idleTimeout < 0)
+        return names;
+    const qint64 now = clock.elapsed();
+    for (int i = connections.size() - 1; i >= 0; --i) {
+        const Connection &c = connections.at(i);
+        if (!c.inUse && now - c.idleSince >= idleTimeout)
+            names.append(connections.takeAt(i).name);
+    }
+    if (!names.isEmpty())
+        connectionReleased.wakeAll();
+    return names;
+}
+
+QStringList QSqlConnectionPoolPrivate::takeThreadConnections(QThread *thread)
+{
+    QStringList names;
+    for (int i = connections.size() - 1; i >= 0; --i) {
+        if (connections.at(i).thread == thread)
+            names.append(connections.takeAt(i).name);
+    }
+    QObject::disconnect(watchedThreads.take(thread));
+    if (!names.isEmpty())
+        connectionReleased.wakeAll();
+    return names;
+}
+
+void QSqlConnectionPoolPrivate::watchThread(QThread *thread,
+                                            const QSharedPointer<QSqlConnectionPoolPrivate> &self)
+{
+    if (watchedThreads.contains(thread))
+        return;
+
+    // finished() is emitted from the finishing thread itself, so its
+    // connections are closed in the thread they belong to
+    watchedThreads.insert(thread, QObject::connect(thread, &QThread::finished, [self, thread]() {
+        QStringList names;
+        {
+            QMutexLocker locker(&self->mutex);
+            names = self->takeThreadConnections(thread);
+        }
+        for (const QString &name : qAsConst(names))
+            QSqlDatabase::removeDatabase(name);
+    }));
+}
+
+bool QSqlConnectionPoolPrivate::isHealthy(QSqlDatabase &db) const
+{
+    if (!db.isOpen() || db.isOpenError())
+        return false;
+    if (healthCheckQuery.isEmpty())
+        return true;
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    return query.exec(healthCheckQuery);
+}
+
+/*!
+    \class QSqlConnectionPool
+    \brief The QSqlConnectionPool class hands out database connections to
+    worker threads and reuses them.
+
+    \ingroup database
+    \inmodule QtSql
+    \since 5.11
+    \threadsafe
+
+    A QSqlDatabase connection can only be used from the thread that created
+    it. Code that runs queries from several threads, for example from
+    QThreadPool or Qt Concurrent tasks, would otherwise need to clone the
+    connection under a unique name in each task and remove it again
+    afterwards, paying for a new database connection every time.
+
+    QSqlConnectionPool creates its connections with
+    QSqlDatabase::cloneDatabase() from a \e prototype connection that holds
+    the driver and connection parameters. acquire() returns an open
+    connection that was created in the calling thread, opening a new one if
+    the thread has no idle connection left. release() gives it back, after
+    which it can be acquired again by the same thread:
+
+    \code
+    QSqlDatabase prototype = QSqlDatabase::addDatabase("QSQLITE", "prototype");
+    prototype.setDatabaseName("data.db");
+    QSqlConnectionPool pool(prototype);
+
+    QtConcurrent::map(ids, [&pool](int id) {
+        QSqlDatabase db = pool.acquire();
+        {
+            QSqlQuery query(db);
+            query.prepare("UPDATE items SET seen = 1 WHERE id = ?");
+            query.addBindValue(id);
+            query.exec();
+        }
+        pool.release(db);
+    });
+    \endcode
+
+    The prototype itself is never opened by the pool. At most
+    maxConnections() connections exist at a time; when the limit is
+    reached, acquire() closes the least recently used idle connection of
+    another thread to make room, or waits until a connection is released.
+    Connections that stay idle longer than idleTimeout() are closed, and a
+    thread's connections are closed when the thread finishes. Before an
+    idle connection is handed out again it is checked with the
+    healthCheckQuery(), if one is set, and reopened if the check fails.
+
+    A connection must be released by the thread that acquired it, and
+    queries on it should be finished and transactions committed or rolled
+    back before that. The handle must not be used after release(). If it is
+    still held when the pool removes the connection, the connection is
+    closed when the handle is destroyed. Idle connections of another
+    thread are closed from the thread that removes them, so drivers whose
+    connections need their own thread's event loop, such as ones
+    subscribed to notifications, should not be pooled.
+
+    \sa QSqlDatabase, {Threads and the SQL Module}
+*/
+
+/*!
+    Constructs a connection pool whose connections are clones of
+    \a prototype.
+*/
+QSqlConnectionPool::QSqlConnectionPool(const QSqlDatabase &prototype)
+    : d(new QSqlConnectionPoolPrivate(prototype))
+{
+}
+
+/*!
+    Destroys the pool and removes all of its connections. Connections that
+    are still acquired become invalid.
+*/
+QSqlConnectionPool::~QSqlConnectionPool()
+{
+    QStringList names;
+    {
+        QMutexLocker locker(&d->mutex);
+        for (const QMetaObject::Connection &connection : qAsConst(d->watchedThreads))
+            QObject::disconnect(connection);
+        d->watchedThreads.clear();
+        for (const QSqlConnectionPoolPrivate::Connection &c : qAsConst(d->connections))
+            names.append(c.name);
+        d->connections.clear();
+    }
+    for (const QString &name : qAsConst(names))
+        QSqlDatabase::removeDatabase(name);
+}
+
+/*!
+    Returns the connection the pool clones its connections from.
+*/
+QSqlDatabase QSqlConnectionPool::prototype() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->prototype;
+}
+
+/*!
+    Sets the maximum number of connections the pool keeps open at the same
+    time, acquired or idle, to \a count. The default is
+    QThread::idealThreadCount().
+*/
+void QSqlConnectionPool::setMaxConnections(int count)
+{
+    QMutexLocker locker(&d->mutex);
+    d->maxConnections = qMax(count, 1);
+    d->connectionReleased.wakeAll();
+}
+
+/*!
+    Returns the maximum number of connections.
+
+    \sa setMaxConnections()
+*/
+int QSqlConnectionPool::maxConnections() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->maxConnections;
+}
+
+/*!
+    Sets the time after which an idle connection is closed to \a msecs
+    milliseconds. A negative value keeps idle connections open until their
+    thread finishes. The default is 30 seconds.
+
+    The pool has no timer of its own; expired connections are closed by the
+    next call to acquire(). Call closeIdleConnections() to close idle
+    connections when the pool is not going to be used for a while.
+*/
+void QSqlConnectionPool::setIdleTimeout(int msecs)
+{
+    QMutexLocker locker(&d->mutex);
+    d->idleTimeout = msecs;
+}
+
+/*!
+    Returns the idle timeout in milliseconds.
+
+    \sa setIdleTimeout()
+*/
+int QSqlConnectionPool::idleTimeout() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->idleTimeout;
+}
+
+/*!
+    Sets the statement that is executed on an idle connection before it is
+    handed out again to \a query, for example \c{SELECT 1}. A connection on
+    which it fails is closed and opened again. If \a query is empty, which is
+    the default, only QSqlDatabase::isOpen() is checked.
+*/
+void QSqlConnectionPool::setHealthCheckQuery(const QString &query)
+{
+    QMutexLocker locker(&d->mutex);
+    d->healthCheckQuery = query;
+}
+
+/*!
+    Returns the health check statement.
+
+    \sa setHealthCheckQuery()
+*/
+QString QSqlConnectionPool::healthCheckQuery() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->healthCheckQuery;
+}
+
+/*!
+    Returns a connection for use in the calling thread and marks it as
+    acquired until it is passed to release().
+
+    If the thread has an idle connection, that connection is returned.
+    Otherwise a new connection is cloned from the prototype and opened. If
+    the pool already has maxConnections() connections, an idle connection of
+    another thread is closed to make room; if all connections are acquired,
+    the call blocks for up to \a timeout milliseconds until one is released.
+    A negative \a timeout waits forever.
+
+    Returns an invalid QSqlDatabase if the timeout expires. If the connection
+    could not be opened, it is returned anyway with the error in
+    QSqlDatabase::lastError(), and must still be released.
+*/
+QSqlDatabase QSqlConnectionPool::acquire(int timeout)
+{
+    QThread *thread = QThread::currentThread();
+    QElapsedTimer waited;
+    waited.start();
+
+    QStringList obsolete;
+    QString name;
+    bool created = false;
+    {
+        QMutexLocker locker(&d->mutex);
+        forever {
+            obsolete += d->takeExpired();
+            int i = d->findIdle(thread);
+            if (i >= 0) {
+                d->connections[i].inUse = true;
+                name = d->connections.at(i).name;
+                break;
+            }
+            if (d->connections.size() >= d->maxConnections) {
+                i = d->findLeastRecentlyUsed();
+                if (i >= 0)
+                    obsolete.append(d->connections.takeAt(i).name);
+            }
+            if (d->connections.size() < d->maxConnections) {
+                name = QLatin1String("qt_sql_pool_") + QString::number(quintptr(d.data()), 16)
+                        + QLatin1Char('_') + QString::number(++d->serial);
+                const QSqlConnectionPoolPrivate::Connection c = { name, thread, 0, true };
+                d->connections.append(c);
+                d->watchThread(thread, d);
+                QSqlDatabase::cloneDatabase(d->prototype, name);
+                created = true;
+                break;
+            }
+
+            // all connections are acquired; release() wakes us up
+            if (timeout < 0) {
+                d->connectionReleased.wait(&d->mutex);
+            } else {
+                const qint64 remaining = timeout - waited.elapsed();
+                if (remaining <= 0)
+                    break;
+                d->connectionReleased.wait(&d->mutex, ulong(remaining));
+            }
+        }
+    }
+
+    for (const QString &obsoleteName : qAsConst(obsolete))
+        qt_sqlDatabaseDetach(obsoleteName);
+    if (name.isEmpty())
+        return QSqlDatabase();
+
+    QSqlDatabase db = QSqlDatabase::database(name, false);
+    if (created) {
+        db.open();
+    } else if (!d->isHealthy(db)) {
+        db.close();
+        db.open();
+    }
+    return db;
+}
+
+/*!
+    Returns \a db, which must have been acquired by the calling thread from
+    this pool, to the pool.
+
+    \sa acquire()
+*/
+void QSqlConnectionPool::release(const QSqlDatabase &db)
+{
+    const QString name = db.connectionName();
+    QMutexLocker locker(&d->mutex);
+    for (QSqlConnectionPoolPrivate::Connection &c : d->connections) {
+        if (c.name != name)
+            continue;
+        if (!c.inUse) {
+            qWarning("QSqlConnectionPool::release: connection '%s' was not acquired",
+                     qPrintable(name));
+            return;
+        }
+        if (c.thread != QThread::currentThread())
+            qWarning("QSqlConnectionPool::release: connection '%s' is released by another thread",
+                     qPrintable(name));
+        c.inUse = false;
+        c.idleSince = d->clock.elapsed();
+        d->connectionReleased.wakeOne();
+        return;
+    }
+    qWarning("QSqlConnectionPool::release: connection '%s' does not belong to this pool",
+             qPrintable(name));
+}
+
+/*!
+    Returns the number of connections in the pool, acquired or idle.
+*/
+int QSqlConnectionPool::connectionCount() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->connections.size();
+}
+
+/*!
+    Returns the number of connections that are open but not acquired.
+*/
+int QSqlConnectionPool::idleConnectionCount() const
+{
+    QMutexLocker locker(&d->mutex);
+    int count = 0;
+    for (const QSqlConnectionPoolPrivate::Connection &c : qAsConst(d->connections))
+        count += !c.inUse;
+    return count;
+}
+
+/*!
+    Closes and removes all idle connections, regardless of the thread that
+    created them.
+*/
+void QSqlConnectionPool::closeIdleConnections()
+{
+    QStringList names;
+    {
+        QMutexLocker locker(&d->mutex);
+        for (int i = d->connections.size() - 1; i >= 0; --i) {
+            if (!d->connections.at(i).inUse)
+                names.append(d->connections.takeAt(i).name);
+        }
+        d->connectionReleased.wakeAll();
+    }
+    for (const QString &name : qAsConst(names))
+        qt_sqlDatabaseDetach(name);
+}
+
+QT_END_NAMESPACE
@@ -121,6 +121,8 @@ public:
     static void invalidateDb(const QSqlDatabase &db, const QString &name, bool doWarn = true);
     static DriverDict &driverDict();
     static void cleanConnections();
+    static void detachDatabase(const QString &name);
+    static QSqlDatabase forDriver(const QSqlDriver *driver);
 };
 
 QSqlDatabasePrivate::QSqlDatabasePrivate(const QSqlDatabasePrivate &other) : ref(1)
@@ -205,6 +207,46 @@ void QSqlDatabasePrivate::removeDatabase(const QString &name)
     invalidateDb(dict->take(name), name);
 }
 
+void QSqlDatabasePrivate::detachDatabase(const QString &name)
+{
+    QConnectionDict *dict = dbDict();
+    Q_ASSERT(dict);
+    QSqlDatabase db;
+    {
+        QWriteLocker locker(&dict->lock);
+        db = dict->take(name);
+    }
+    // db goes out of scope here; if a handle is still held elsewhere, the
+    // connection stays usable and is closed when that handle is destroyed
+}
+
+// used by QSqlConnectionPool to remove a released connection whose last user
+// may still hold a QSqlDatabase handle, without invalidating that handle
+void qt_sqlDatabaseDetach(const QString &name)
+{
+    QSqlDatabasePrivate::detachDatabase(name);
+}
+
+QSqlDatabase QSqlDatabasePrivate::forDriver(const QSqlDriver *driver)
+{
+    const QConnectionDict *dict = dbDict();
+    Q_ASSERT(dict);
+    QReadLocker locker(&dict->lock);
+
+    for (QConnectionDict::const_iterator it = dict->constBegin(); it != dict->constEnd(); ++it) {
+        if (it.value().d->driver == driver)
+            return it.value();
+    }
+    return QSqlDatabase();
+}
+
+// used by QSqlQueryModel to find the connection of a query it clones for
+// fetching rows in the background
+QSqlDatabase qt_sqlDatabaseForDriver(const QSqlDriver *driver)
+{
+    return QSqlDatabasePrivate::forDriver(driver);
+}
+
 void QSqlDatabasePrivate::addDatabase(const QSqlDatabase &db, const QString &name)
 {
     QConnectionDict *dict = dbDict();
@@ -1157,6 +1199,7 @@ QSqlRecord QSqlDatabase::record(const QString& tablename) const
     \li tty
     \li requiressl
     \li service
+    \li QPSQL_SINGLE_ROW_MODE
     \endlist
 
     \header \li DB2 \li OCI \li TDS
@@ -1187,6 +1230,8 @@ QSqlRecord QSqlDatabase::record(const QString& tablename) const
     \li QSQLITE_OPEN_URI
     \li QSQLITE_ENABLE_SHARED_CACHE
     \li QSQLITE_ENABLE_REGEXP
+    \li QSQLITE_STATEMENT_CACHE_SIZE
+    \li QSQLITE_COLUMNAR_CACHE
     \endlist
 
     \li
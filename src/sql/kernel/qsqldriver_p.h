@@ -58,6 +58,9 @@
 
 QT_BEGIN_NAMESPACE
 
+class QSqlAsyncExecutor;
+class QSqlAsyncQueryPrivate;
+
 class QSqlDriverPrivate : public QObjectPrivate
 {
     Q_DECLARE_PUBLIC(QSqlDriver)
@@ -71,6 +74,11 @@ public:
         dbmsType(QSqlDriver::UnknownDbms)
     { }
 
+    // Returns an executor that runs queries of sink without blocking, or
+    // nullptr if they have to be run on a worker thread.
+    virtual QSqlAsyncExecutor *createAsyncExecutor(QSqlAsyncQueryPrivate *sink)
+    { Q_UNUSED(sink); return nullptr; }
+
     uint isOpen;
     uint isOpenError;
     QSqlError error;
@@ -43,6 +43,8 @@
 #include <qdebug.h>
 #include <qsqldriver.h>
 #include <qsqlfield.h>
+#include <qmutex.h>
+#include <qthread.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -83,6 +85,374 @@ void QSqlQueryModelPrivate::prefetch(int limit)
     }
 }
 
+void QSqlQueryModelPrivate::updateAsyncRecord()
+{
+    Q_Q(QSqlQueryModel);
+    const QSqlRecord newRec = asyncQuery->record();
+    if (!rec.isEmpty() || newRec.isEmpty())
+        return;
+    q->beginInsertColumns(QModelIndex(), 0, newRec.count() - 1);
+    rec = newRec;
+    initColOffsets(rec.count());
+    bottom = q->createIndex(asyncRows.count() - 1, rec.count() - 1);
+    q->endInsertColumns();
+}
+
+void QSqlQueryModelPrivate::appendAsyncRows(const QVector<QSqlRecord> &rows)
+{
+    Q_Q(QSqlQueryModel);
+    updateAsyncRecord();
+    if (rows.isEmpty())
+        return;
+    const int first = asyncRows.count();
+    q->beginInsertRows(QModelIndex(), first, first + rows.count() - 1);
+    asyncRows += rows;
+    bottom = q->createIndex(asyncRows.count() - 1, rec.count() - 1);
+    q->endInsertRows();
+}
+
+void QSqlQueryModelPrivate::detachAsyncQuery()
+{
+    QObject::disconnect(asyncRowsConnection);
+    QObject::disconnect(asyncFinishedConnection);
+    asyncQuery = nullptr;
+    asyncRows.clear();
+    async = false;
+}
+
+QSqlDatabase qt_sqlDatabaseForDriver(const QSqlDriver *driver);
+
+// Reads the rows of a windowed model on a worker thread, using its own clone
+// of the connection of the model's query. Drivers that report the query
+// size get a scrollable query; otherwise the rows are counted with a second
+// query while windows are read from a forward-only one.
+class QSqlQueryModelFetcher : public QObject
+{
+public:
+    QSqlQueryModelFetcher(QSqlQueryModel *model, QSqlQueryModelPrivate *d, const QSqlDatabase &db,
+                          const QSqlQuery &query);
+    ~QSqlQueryModelFetcher();
+
+    void start();
+    void fetch(int first, int count, int request);
+    void stop();
+
+    QAtomicInt latestRequest;
+
+private:
+    bool exec(QSqlQuery &q, bool forwardOnly);
+    void countRows();
+    template <typename Func>
+    void report(Func f);
+
+    bool isStopped();
+
+    QSqlQueryModel *model;
+    QSqlQueryModelPrivate *d;
+    int generation;
+    // guards model and d, which must not be used once the model has let go
+    // of the fetcher
+    QMutex mutex;
+    bool stopped;
+    QSqlDatabase source;
+    QString connectionName;
+    QString queryText;
+    QVector<QVariant> values;
+    QSql::NumericalPrecisionPolicy precisionPolicy;
+    QSqlQuery cursor;
+    QSqlQuery counter;
+    int pos;
+    int counted;
+    bool scrollable;
+};
+
+QSqlQueryModelFetcher::QSqlQueryModelFetcher(QSqlQueryModel *model, QSqlQueryModelPrivate *d,
+                                             const QSqlDatabase &db, const QSqlQuery &query)
+    : model(model),
+      d(d),
+      generation(d->fetchGeneration),
+      stopped(false),
+      source(db),
+      queryText(query.lastQuery()),
+      precisionPolicy(query.numericalPrecisionPolicy()),
+      pos(-1),
+      counted(0),
+      scrollable(false)
+{
+    static QBasicAtomicInt serial = Q_BASIC_ATOMIC_INITIALIZER(0);
+    connectionName = QLatin1String("qt_sql_model_") + QString::number(serial.fetchAndAddRelaxed(1) + 1, 16);
+    const int count = query.boundValues().count();
+    values.reserve(count);
+    for (int i = 0; i < count; ++i)
+        values.append(query.boundValue(i));
+}
+
+QSqlQueryModelFetcher::~QSqlQueryModelFetcher()
+{
+    cursor = QSqlQuery();
+    counter = QSqlQuery();
+    source = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+// Called by the model, which won't hear from the fetcher any more. Whatever
+// the fetcher is doing, it is abandoned as soon as it checks isStopped().
+void QSqlQueryModelFetcher::stop()
+{
+    QMutexLocker locker(&mutex);
+    stopped = true;
+    latestRequest.store(-1);
+}
+
+bool QSqlQueryModelFetcher::isStopped()
+{
+    QMutexLocker locker(&mutex);
+    return stopped;
+}
+
+// Runs f on the model's private in the model's thread, unless the model has
+// moved on to another query meanwhile.
+template <typename Func>
+void QSqlQueryModelFetcher::report(Func f)
+{
+    QMutexLocker locker(&mutex);
+    if (stopped)
+        return;
+    QSqlQueryModelPrivate *d = this->d;
+    const int generation = this->generation;
+    QMetaObject::invokeMethod(model, [d, generation, f]() {
+        if (d->fetchGeneration == generation)
+            f(d);
+    }, Qt::QueuedConnection);
+}
+
+bool QSqlQueryModelFetcher::exec(QSqlQuery &q, bool forwardOnly)
+{
+    q.setForwardOnly(forwardOnly);
+    q.setNumericalPrecisionPolicy(precisionPolicy);
+    if (values.isEmpty())
+        return q.exec(queryText);
+    if (!q.prepare(queryText))
+        return false;
+    for (int i = 0; i < values.count(); ++i)
+        q.bindValue(i, values.at(i));
+    return q.exec();
+}
+
+void QSqlQueryModelFetcher::start()
+{
+    if (isStopped())
+        return;
+    QSqlDatabase db = QSqlDatabase::cloneDatabase(source, connectionName);
+    source = QSqlDatabase();
+    if (!db.open()) {
+        const QSqlError error = db.lastError();
+        report([error](QSqlQueryModelPrivate *d) { d->error = error; });
+        return;
+    }
+
+    scrollable = db.driver()->hasFeature(QSqlDriver::QuerySize);
+    cursor = QSqlQuery(db);
+    if (!exec(cursor, !scrollable)) {
+        const QSqlError error = cursor.lastError();
+        report([error](QSqlQueryModelPrivate *d) { d->error = error; });
+        return;
+    }
+    if (scrollable) {
+        const int size = qMax(cursor.size(), 0);
+        report([size](QSqlQueryModelPrivate *d) { d->updateRowCount(size, true); });
+        return;
+    }
+
+    counter = QSqlQuery(db);
+    if (exec(counter, true))
+        countRows();
+}
+
+// Counts a chunk of rows and queues the next chunk, so that window requests
+// are handled in between.
+void QSqlQueryModelFetcher::countRows()
+{
+    if (isStopped())
+        return;
+    const int chunk = 16384;
+    int i = 0;
+    bool final = false;
+    while (i < chunk) {
+        if (!counter.next()) {
+            final = true;
+            break;
+        }
+        ++i;
+    }
+    counted += i;
+    const int rows = counted;
+    report([rows, final](QSqlQueryModelPrivate *d) { d->updateRowCount(rows, final); });
+    if (final)
+        counter = QSqlQuery();
+    else
+        QMetaObject::invokeMethod(this, [this]() { countRows(); }, Qt::QueuedConnection);
+}
+
+void QSqlQueryModelFetcher::fetch(int first, int count, int request)
+{
+    if (!cursor.isActive())
+        return;
+
+    bool ok;
+    if (scrollable) {
+        ok = cursor.seek(first);
+        pos = ok ? first : -1;
+    } else {
+        // rows can only be read forwards, start over to go back
+        if (first < pos) {
+            exec(cursor, true);
+            pos = -1;
+        }
+        while (pos < first && cursor.next())
+            ++pos;
+        ok = pos == first;
+    }
+
+    QVector<QSqlRecord> rows;
+    rows.reserve(count);
+    if (ok) {
+        const QSqlRecord rec = cursor.record();
+        const int columns = rec.count();
+        do {
+            QSqlRecord row = rec;
+            for (int i = 0; i < columns; ++i)
+                row.setValue(i, cursor.value(i));
+            rows.append(row);
+            // a newer request makes the rest of this window useless
+            if (latestRequest.load() != request)
+                return;
+            if (rows.count() < count && cursor.next())
+                ++pos;
+            else
+                break;
+        } while (true);
+    }
+
+    report([first, rows](QSqlQueryModelPrivate *d) { d->setWindow(first, rows); });
+}
+
+// A clone of an in-memory SQLite database is a new, empty database.
+static bool qIsPrivateDatabase(const QSqlDatabase &db)
+{
+    if (!db.driverName().startsWith(QLatin1String("QSQLITE")))
+        return false;
+    const QString name = db.databaseName();
+    return name.isEmpty() || name == QLatin1String(":memory:")
+            || name.contains(QLatin1String("mode=memory"));
+}
+
+bool QSqlQueryModelPrivate::startFetcher(const QSqlQuery &query)
+{
+    Q_Q(QSqlQueryModel);
+    const QSqlDatabase db = qt_sqlDatabaseForDriver(query.driver());
+    if (!db.isValid() || qIsPrivateDatabase(db))
+        return false;
+
+    ++fetchGeneration;
+    fetcher = new QSqlQueryModelFetcher(q, this, db, query);
+    QThread *thread = new QThread;
+    thread->setObjectName(QLatin1String("QSqlQueryModel"));
+    QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    fetcher->moveToThread(thread);
+    thread->start();
+    QSqlQueryModelFetcher *fetcher = this->fetcher;
+    QMetaObject::invokeMethod(fetcher, [fetcher]() { fetcher->start(); }, Qt::QueuedConnection);
+    return true;
+}
+
+void QSqlQueryModelPrivate::stopFetcher()
+{
+    if (fetcher) {
+        // the model doesn't wait for a statement that is still running; the
+        // fetcher removes its clone in the thread that created it once it
+        // gets to it, and the thread is deleted after it has finished
+        QSqlQueryModelFetcher *fetcher = this->fetcher;
+        fetcher->stop();
+        QMetaObject::invokeMethod(fetcher, [fetcher]() {
+            delete fetcher;
+            QThread::currentThread()->quit();
+        }, Qt::QueuedConnection);
+        this->fetcher = nullptr;
+    }
+    ++fetchGeneration;
+    window.clear();
+    windowStart = 0;
+    requestedStart = -1;
+    requestedFirst = -1;
+    rowsCounted = false;
+}
+
+// Asks for the rows around row unless the window covers it with some margin
+// or they have been asked for already. When scrolling forwards only the rows
+// following the window are fetched, so a forward-only cursor can go on
+// where it stopped.
+void QSqlQueryModelPrivate::requestWindow(int row)
+{
+    const int rowCount = bottom.row() + 1;
+    const int margin = windowSize / 4;
+    const int windowEnd = windowStart + window.count();
+    if ((row >= windowStart + margin || windowStart == 0)
+            && (row < windowEnd - margin || (rowsCounted && windowEnd >= rowCount))) {
+        return;
+    }
+    if (requestedFirst >= 0 && row >= requestedStart && row < requestedStart + windowSize)
+        return;
+
+    const int start = qMax(row - windowSize / 2, 0);
+    const int first = start >= windowStart && start < windowEnd ? windowEnd : start;
+    const int count = start + windowSize - first;
+    if (count <= 0)
+        return;
+    requestedStart = start;
+    requestedFirst = first;
+    const int request = fetcher->latestRequest.fetchAndAddRelaxed(1) + 1;
+    QSqlQueryModelFetcher *fetcher = this->fetcher;
+    QMetaObject::invokeMethod(fetcher, [fetcher, first, count, request]() {
+        if (fetcher->latestRequest.load() == request)
+            fetcher->fetch(first, count, request);
+    }, Qt::QueuedConnection);
+}
+
+void QSqlQueryModelPrivate::updateRowCount(int rows, bool final)
+{
+    Q_Q(QSqlQueryModel);
+    rowsCounted = final;
+    if (rows > bottom.row() + 1) {
+        q->beginInsertRows(QModelIndex(), bottom.row() + 1, rows - 1);
+        bottom = q->createIndex(rows - 1, rec.count() - 1);
+        q->endInsertRows();
+    }
+}
+
+void QSqlQueryModelPrivate::setWindow(int first, const QVector<QSqlRecord> &rows)
+{
+    Q_Q(QSqlQueryModel);
+    if (first == requestedFirst)
+        requestedFirst = -1;
+    if (first == windowStart + window.count() && !window.isEmpty()) {
+        window += rows;
+        // slide the window, dropping the rows scrolled past
+        const int excess = window.count() - windowSize;
+        if (excess > 0) {
+            window.remove(0, excess);
+            windowStart += excess;
+        }
+    } else {
+        windowStart = first;
+        window = rows;
+    }
+    if (!rows.isEmpty() && rec.count() > 0) {
+        emit q->dataChanged(q->createIndex(first, 0),
+                            q->createIndex(first + rows.count() - 1, rec.count() - 1));
+    }
+}
+
 QSqlQueryModelPrivate::~QSqlQueryModelPrivate()
 {
 }
@@ -170,6 +540,8 @@ QSqlQueryModel::QSqlQueryModel(QSqlQueryModelPrivate &dd, QObject *parent)
 */
 QSqlQueryModel::~QSqlQueryModel()
 {
+    Q_D(QSqlQueryModel);
+    d->stopFetcher();
 }
 
 /*!
@@ -375,6 +747,17 @@ QVariant QSqlQueryModel::data(const QModelIndex &item, int role) const
     if (!d->rec.isGenerated(item.column()))
         return v;
     QModelIndex dItem = indexInQuery(item);
+    if (d->async)
+        return d->asyncRows.value(dItem.row()).value(dItem.column());
+
+    if (d->fetcher) {
+        const_cast<QSqlQueryModelPrivate *>(d)->requestWindow(dItem.row());
+        const int offset = dItem.row() - d->windowStart;
+        if (offset < 0 || offset >= d->window.count())
+            return v;
+        return d->window.at(offset).value(dItem.column());
+    }
+
     if (dItem.row() > d->bottom.row())
         const_cast<QSqlQueryModelPrivate *>(d)->prefetch(dItem.row());
 
@@ -435,6 +818,8 @@ void QSqlQueryModel::setQuery(const QSqlQuery &query)
     Q_D(QSqlQueryModel);
     beginResetModel();
 
+    d->detachAsyncQuery();
+    d->stopFetcher();
     QSqlRecord newRec = query.record();
     bool columnsChanged = (newRec != d->rec);
 
@@ -447,6 +832,16 @@ void QSqlQueryModel::setQuery(const QSqlQuery &query)
     d->rec = newRec;
     d->atEnd = true;
 
+    if (d->windowSize > 0 && query.isActive() && query.isSelect() && d->startFetcher(query)) {
+        // the rows are read by the fetcher from now on, don't keep the
+        // result set of the query open
+        d->query.finish();
+        d->bottom = createIndex(-1, d->rec.count() - 1);
+        endResetModel();
+        queryChange();
+        return;
+    }
+
     if (query.isForwardOnly()) {
         d->error = QSqlError(QLatin1String("Forward-only queries "
                                            "cannot be used in a data model"),
@@ -495,6 +890,110 @@ void QSqlQueryModel::setQuery(const QString &query, const QSqlDatabase &db)
     setQuery(QSqlQuery(query, db));
 }
 
+/*! \overload
+    \since 5.11
+
+    Resets the model and populates it incrementally from the asynchronous
+    \a query, which is executed by this function. Rows are appended to
+    the model as the query delivers them, so a view shows the first rows
+    while the rest of the result set is still being read and the thread
+    of the model is never blocked by the database.
+
+    The columns of the model are known once the query reports its record.
+    lastError() is updated when the query has finished. All rows are kept
+    in the model, canFetchMore() always returns \c false and query()
+    returns an empty QSqlQuery.
+
+    Example:
+
+    \snippet code/src_sql_models_qsqlquerymodel.cpp 2
+
+    \sa QSqlAsyncQuery
+*/
+void QSqlQueryModel::setQuery(QSqlAsyncQuery *query)
+{
+    Q_D(QSqlQueryModel);
+    beginResetModel();
+
+    d->detachAsyncQuery();
+    d->stopFetcher();
+    d->query = QSqlQuery();
+    d->error = QSqlError();
+    d->rec = QSqlRecord();
+    d->colOffsets.clear();
+    d->bottom = QModelIndex();
+    d->atEnd = true;
+
+    if (query) {
+        d->async = true;
+        d->asyncQuery = query;
+        d->asyncRowsConnection = connect(query, &QSqlAsyncQuery::rowsReady, this,
+                                         [d](const QVector<QSqlRecord> &rows) {
+            d->appendAsyncRows(rows);
+        });
+        d->asyncFinishedConnection = connect(query, &QSqlAsyncQuery::finished, this, [d]() {
+            d->updateAsyncRecord();
+            d->error = d->asyncQuery->lastError();
+        });
+        if (!query->exec())
+            d->error = query->lastError();
+    }
+
+    endResetModel();
+    queryChange();
+}
+
+/*!
+    \since 5.11
+
+    Sets the number of rows the model keeps in memory to \a rows. The
+    default of 0 keeps every row that has been fetched for the lifetime
+    of the query, which lets memory grow with the size of the result set.
+
+    With a positive window size, queries set afterwards with setQuery()
+    are read on a worker thread that uses its own clone of the query's
+    connection (see QSqlDatabase::cloneDatabase()). The model only holds
+    a window of \a rows rows around the rows last asked for through data().
+    The window is moved in the background when data() asks for rows near
+    its edge; rows that are not in memory yet are returned as invalid
+    QVariant values and dataChanged() is emitted once they have been
+    fetched.
+
+    If the driver reports the size of a query, the rows are read through
+    a scrollable query and rowCount() is known right away. Otherwise the
+    worker thread counts the rows and rowCount() grows as they are
+    counted; going back beyond the window then executes the query again.
+    canFetchMore() always returns \c false in this mode, and the query
+    passed to setQuery() may be forward-only. It is finished by setQuery(),
+    as the model does not read its rows.
+
+    The window size does not affect queries that are not SELECT statements
+    or whose connection can't be found. Queries on in-memory and temporary
+    SQLite databases are not windowed either, because a clone of their
+    connection would not see their data; all of their rows are kept.
+
+    \sa windowSize(), setQuery()
+*/
+void QSqlQueryModel::setWindowSize(int rows)
+{
+    Q_D(QSqlQueryModel);
+    d->windowSize = qMax(rows, 0);
+}
+
+/*!
+    \since 5.11
+
+    Returns the number of rows kept in memory in windowed mode, or 0 if
+    all fetched rows are kept.
+
+    \sa setWindowSize()
+*/
+int QSqlQueryModel::windowSize() const
+{
+    Q_D(const QSqlQueryModel);
+    return d->windowSize;
+}
+
 /*!
     Clears the model and releases any acquired resource.
 */
@@ -504,6 +1003,8 @@ void QSqlQueryModel::clear()
     beginResetModel();
     d->error = QSqlError();
     d->atEnd = true;
+    d->detachAsyncQuery();
+    d->stopFetcher();
     d->query.clear();
     d->rec.clear();
     d->colOffsets.clear();
@@ -51,6 +51,7 @@ class QSqlQueryModelPrivate;
 class QSqlError;
 class QSqlRecord;
 class QSqlQuery;
+class QSqlAsyncQuery;
 
 class Q_SQL_EXPORT QSqlQueryModel: public QAbstractTableModel
 {
@@ -77,8 +78,12 @@ public:
 
     void setQuery(const QSqlQuery &query);
     void setQuery(const QString &query, const QSqlDatabase &db = QSqlDatabase());
+    void setQuery(QSqlAsyncQuery *query);
     QSqlQuery query() const;
 
+    void setWindowSize(int rows);
+    int windowSize() const;
+
     virtual void clear();
 
     QSqlError lastError() const;
@@ -53,23 +53,38 @@
 
 #include <QtSql/private/qtsqlglobal_p.h>
 #include "private/qabstractitemmodel_p.h"
+#include "QtSql/qsqlasyncquery.h"
 #include "QtSql/qsqlerror.h"
 #include "QtSql/qsqlquery.h"
 #include "QtSql/qsqlrecord.h"
 #include "QtCore/qhash.h"
+#include "QtCore/qpointer.h"
 #include "QtCore/qvarlengtharray.h"
 #include "QtCore/qvector.h"
 
 QT_BEGIN_NAMESPACE
 
+class QSqlQueryModelFetcher;
+
 class QSqlQueryModelPrivate: public QAbstractItemModelPrivate
 {
     Q_DECLARE_PUBLIC(QSqlQueryModel)
 public:
-    QSqlQueryModelPrivate() : atEnd(false), nestedResetLevel(0) {}
+    QSqlQueryModelPrivate()
+        : atEnd(false), async(false), windowSize(0), windowStart(0), requestedStart(-1),
+          requestedFirst(-1), rowsCounted(false), fetchGeneration(0), fetcher(nullptr),
+          nestedResetLevel(0) {}
     ~QSqlQueryModelPrivate();
 
     void prefetch(int);
+    void updateAsyncRecord();
+    void appendAsyncRows(const QVector<QSqlRecord> &rows);
+    void detachAsyncQuery();
+    bool startFetcher(const QSqlQuery &query);
+    void stopFetcher();
+    void requestWindow(int row);
+    void updateRowCount(int rows, bool final);
+    void setWindow(int first, const QVector<QSqlRecord> &rows);
     void initColOffsets(int size);
     int columnInQuery(int modelColumn) const;
 
@@ -78,6 +93,21 @@ public:
     QModelIndex bottom;
     QSqlRecord rec;
     uint atEnd : 1;
+    uint async : 1; // rows come from asyncQuery and are kept in asyncRows
+    QPointer<QSqlAsyncQuery> asyncQuery;
+    QVector<QSqlRecord> asyncRows;
+    QMetaObject::Connection asyncRowsConnection;
+    QMetaObject::Connection asyncFinishedConnection;
+    // windowed mode: only windowSize rows around the rows last asked for are
+    // kept, they are fetched by fetcher on a thread of its own
+    int windowSize;
+    int windowStart;
+    int requestedStart;
+    int requestedFirst;
+    bool rowsCounted;
+    int fetchGeneration;
+    QVector<QSqlRecord> window;
+    QSqlQueryModelFetcher *fetcher;
     QVector<QHash<int, QVariant> > headers;
     QVarLengthArray<int, 56> colOffsets; // used to calculate indexInQuery of columns
     int nestedResetLevel;
@@ -252,7 +252,8 @@ static QSize documentSize(QWidgetTextControl *control)
 
     QSize docSize;
 
-    if (QTextDocumentLayout *tlayout = qobject_cast<QTextDocumentLayout *>(layout)) {
+    QTextDocumentLayout *tlayout = qobject_cast<QTextDocumentLayout *>(layout);
+    if (tlayout && !tlayout->layoutOnDemand()) {
         docSize = tlayout->dynamicDocumentSize().toSize();
         int percentageDone = tlayout->layoutStatus();
         // extrapolate height
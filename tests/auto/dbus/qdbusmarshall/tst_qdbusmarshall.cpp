@@ -98,6 +98,9 @@ private slots:
     void demarshallInvalidByteArray_data();
     void demarshallInvalidByteArray();
 
+    void demarshallFixedArrays();
+    void demarshallVariantMap();
+
 private:
     int fileDescriptorForTest();
 
@@ -1496,5 +1499,116 @@ void tst_QDBusMarshall::demarshallInvalidByteArray()
     QVERIFY(receiveArg.atEnd());
 }
 
+template <typename T>
+static void compareFixedArray(const QDBusArgument &receiveArg, const QVector<T> &expected)
+{
+    QVector<T> vector;
+    receiveArg >> vector;
+    QCOMPARE(vector, expected);
+}
+
+void tst_QDBusMarshall::demarshallFixedArrays()
+{
+    QDBusConnection con = QDBusConnection::sessionBus();
+
+    QVERIFY(con.isConnected());
+
+    // Arrays of fixed-size types are copied as a whole, in both directions,
+    // from and to both QVector and QList.
+    const QVector<uchar> bytes = { 0, 1, 255 };
+    const QVector<short> shorts = { -32768, 0, 32767 };
+    const QVector<ushort> ushorts = { 0, 65535 };
+    const QVector<int> ints = { -2147483647 - 1, -1, 0, 42, 2147483647 };
+    const QVector<uint> uints = { 0, 4294967295U };
+    const QVector<qlonglong> longlongs = { Q_INT64_C(-9223372036854775807) - 1, Q_INT64_C(9223372036854775807) };
+    const QVector<qulonglong> ulonglongs = { 0, Q_UINT64_C(18446744073709551615) };
+    const QVector<double> doubles = { -1.5, 0, 3.14159 };
+    const QVector<int> empty;
+
+    QDBusMessage msg = QDBusMessage::createMethodCall(serviceName, objectPath,
+                                                      interfaceName, "ping");
+    QDBusArgument sendArg;
+    sendArg.beginStructure();
+    sendArg << bytes << shorts << ushorts << ints << uints << longlongs << ulonglongs << doubles << empty;
+    sendArg << bytes.toList() << ints.toList() << doubles.toList();
+    sendArg.endStructure();
+    QCOMPARE(sendArg.currentSignature(), QString("(ayanaqaiauaxatadaiayaiad)"));
+    msg.setArguments(QVariantList() << QVariant::fromValue(sendArg));
+    QDBusMessage reply = con.call(msg);
+
+    const QDBusArgument receiveArg = qvariant_cast<QDBusArgument>(reply.arguments().at(0));
+    receiveArg.beginStructure();
+    compareFixedArray(receiveArg, bytes);
+    compareFixedArray(receiveArg, shorts);
+    compareFixedArray(receiveArg, ushorts);
+    compareFixedArray(receiveArg, ints);
+    compareFixedArray(receiveArg, uints);
+    compareFixedArray(receiveArg, longlongs);
+    compareFixedArray(receiveArg, ulonglongs);
+    compareFixedArray(receiveArg, doubles);
+    QVector<int> emptyVector(3);
+    receiveArg >> emptyVector;
+    QVERIFY(emptyVector.isEmpty());
+    QList<uchar> byteList;
+    receiveArg >> byteList;
+    QCOMPARE(byteList, bytes.toList());
+    QList<int> intList;
+    receiveArg >> intList;
+    QCOMPARE(intList, ints.toList());
+    QVector<double> doubleVector;
+    receiveArg >> doubleVector;
+    QCOMPARE(doubleVector, doubles);
+    receiveArg.endStructure();
+    QVERIFY(receiveArg.atEnd());
+}
+
+void tst_QDBusMarshall::demarshallVariantMap()
+{
+    QDBusConnection con = QDBusConnection::sessionBus();
+
+    QVERIFY(con.isConnected());
+
+    QVariantMap nested;
+    nested["list"] = QVariant::fromValue(QList<int>() << 1 << 2 << 3);
+    QVariantMap map;
+    map["int"] = 42;
+    map["string"] = QString("Hello, World");
+    map["bytes"] = QByteArray("\0\1\2", 3);
+    map["strings"] = QStringList() << "a" << "b";
+    map["nested"] = nested;
+
+    QDBusMessage msg = QDBusMessage::createMethodCall(serviceName, objectPath,
+                                                      interfaceName, "ping");
+    QDBusArgument sendArg;
+    sendArg.beginStructure();
+    sendArg << map << QVariantMap();
+    sendArg.endStructure();
+    QCOMPARE(sendArg.currentSignature(), QString("(a{sv}a{sv})"));
+    msg.setArguments(QVariantList() << QVariant::fromValue(sendArg));
+    QDBusMessage reply = con.call(msg);
+
+    const QDBusArgument receiveArg = qvariant_cast<QDBusArgument>(reply.arguments().at(0));
+    receiveArg.beginStructure();
+    QVariantMap received;
+    receiveArg >> received;
+    QCOMPARE(received.keys(), map.keys());
+    QCOMPARE(received.value("int"), map.value("int"));
+    QCOMPARE(received.value("string"), map.value("string"));
+    QCOMPARE(received.value("bytes"), map.value("bytes"));
+    QCOMPARE(received.value("strings"), map.value("strings"));
+
+    // containers other than byte and string arrays are decoded on demand
+    const QVariant receivedNested = received.value("nested");
+    QCOMPARE(receivedNested.userType(), qMetaTypeId<QDBusArgument>());
+    const QVariantMap nestedMap = qdbus_cast<QVariantMap>(receivedNested);
+    QCOMPARE(nestedMap.keys(), nested.keys());
+    QCOMPARE(qdbus_cast<QList<int> >(nestedMap.value("list")), QList<int>() << 1 << 2 << 3);
+
+    receiveArg >> received;
+    QVERIFY(received.isEmpty());
+    receiveArg.endStructure();
+    QVERIFY(receiveArg.atEnd());
+}
+
 QTEST_MAIN(tst_QDBusMarshall)
 #include "tst_qdbusmarshall.moc"
@@ -34,6 +34,7 @@
 #include <qlist.h>
 #include <qmatrix.h>
 #include <qrandom.h>
+#include <qthreadpool.h>
 #include <stdio.h>
 
 #include <qpainter.h>
@@ -215,6 +216,11 @@ private slots:
 
     void complexTransform8bit();
 
+    void threadedConversion_data();
+    void threadedConversion();
+    void threadedSmoothScale_data();
+    void threadedSmoothScale();
+
 #ifdef Q_OS_DARWIN
     void toCGImage_data();
     void toCGImage();
@@ -3396,6 +3402,132 @@ void tst_QImage::complexTransform8bit()
     QCOMPARE(img2.colorCount(), 0);
 }
 
+// Large enough to be split over several threads, with a height that is
+// not a multiple of the segment size.
+static QImage largeTestImage(QImage::Format format)
+{
+    QImage image(1000, 777, QImage::Format_ARGB32);
+    QRandomGenerator generator(4711);
+    for (int y = 0; y < image.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < image.width(); ++x)
+            line[x] = generator.generate();
+    }
+    return image.convertToFormat(format);
+}
+
+class ImageThreadingGuard
+{
+public:
+    ImageThreadingGuard()
+        : maxThreadCount(QThreadPool::globalInstance()->maxThreadCount())
+    {
+        // Ensure there are threads to split over even on single-core machines.
+        QThreadPool::globalInstance()->setMaxThreadCount(4);
+    }
+    ~ImageThreadingGuard()
+    {
+        QThreadPool::globalInstance()->setMaxThreadCount(maxThreadCount);
+        qunsetenv("QT_IMAGE_MAX_THREADS");
+    }
+
+    void setThreaded(bool threaded)
+    {
+        if (threaded)
+            qunsetenv("QT_IMAGE_MAX_THREADS");
+        else
+            qputenv("QT_IMAGE_MAX_THREADS", "1");
+    }
+
+private:
+    const int maxThreadCount;
+};
+
+void tst_QImage::threadedConversion_data()
+{
+    QTest::addColumn<QImage::Format>("fromFormat");
+    QTest::addColumn<QImage::Format>("toFormat");
+    QTest::addColumn<int>("flags");
+
+    const int none = Qt::AutoColor;
+    const int dither = Qt::PreferDither | Qt::OrderedDither;
+
+    QTest::newRow("ARGB32 -> ARGB32_Premultiplied")
+            << QImage::Format_ARGB32 << QImage::Format_ARGB32_Premultiplied << none;
+    QTest::newRow("ARGB32_Premultiplied -> ARGB32")
+            << QImage::Format_ARGB32_Premultiplied << QImage::Format_ARGB32 << none;
+    QTest::newRow("RGB888 -> RGB32")
+            << QImage::Format_RGB888 << QImage::Format_RGB32 << none;
+    QTest::newRow("ARGB32 -> RGBA8888")
+            << QImage::Format_ARGB32 << QImage::Format_RGBA8888 << none;
+    QTest::newRow("RGBA8888 -> RGB32")
+            << QImage::Format_RGBA8888 << QImage::Format_RGB32 << none;
+    QTest::newRow("RGB32 -> RGB30")
+            << QImage::Format_RGB32 << QImage::Format_RGB30 << none;
+    QTest::newRow("ARGB32_Premultiplied -> RGB888")
+            << QImage::Format_ARGB32_Premultiplied << QImage::Format_RGB888 << none;
+    QTest::newRow("ARGB32 -> RGB16 dithered")
+            << QImage::Format_ARGB32 << QImage::Format_RGB16 << dither;
+    QTest::newRow("RGB16 -> RGB555 dithered")
+            << QImage::Format_RGB16 << QImage::Format_RGB555 << dither;
+}
+
+void tst_QImage::threadedConversion()
+{
+    QFETCH(QImage::Format, fromFormat);
+    QFETCH(QImage::Format, toFormat);
+    QFETCH(int, flags);
+
+    const QImage source = largeTestImage(fromFormat);
+    ImageThreadingGuard guard;
+
+    guard.setThreaded(false);
+    const QImage expected = source.convertToFormat(toFormat, Qt::ImageConversionFlags(flags));
+    QImage expectedInplace = source.copy();
+    expectedInplace = std::move(expectedInplace).convertToFormat(toFormat, Qt::ImageConversionFlags(flags));
+
+    guard.setThreaded(true);
+    const QImage converted = source.convertToFormat(toFormat, Qt::ImageConversionFlags(flags));
+    QImage convertedInplace = source.copy();
+    convertedInplace = std::move(convertedInplace).convertToFormat(toFormat, Qt::ImageConversionFlags(flags));
+
+    QCOMPARE(converted.format(), toFormat);
+    QCOMPARE(converted, expected);
+    QCOMPARE(convertedInplace.format(), toFormat);
+    QCOMPARE(convertedInplace, expectedInplace);
+}
+
+void tst_QImage::threadedSmoothScale_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+    QTest::addColumn<QSize>("size");
+
+    QTest::newRow("RGB32 down") << QImage::Format_RGB32 << QSize(613, 401);
+    QTest::newRow("RGB32 up") << QImage::Format_RGB32 << QSize(1733, 1311);
+    QTest::newRow("RGB32 up x, down y") << QImage::Format_RGB32 << QSize(1733, 611);
+    QTest::newRow("ARGB32_Premultiplied down")
+            << QImage::Format_ARGB32_Premultiplied << QSize(613, 401);
+    QTest::newRow("ARGB32_Premultiplied down x, up y")
+            << QImage::Format_ARGB32_Premultiplied << QSize(613, 1311);
+}
+
+void tst_QImage::threadedSmoothScale()
+{
+    QFETCH(QImage::Format, format);
+    QFETCH(QSize, size);
+
+    const QImage source = largeTestImage(format);
+    ImageThreadingGuard guard;
+
+    guard.setThreaded(false);
+    const QImage expected = source.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    guard.setThreaded(true);
+    const QImage scaled = source.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+    QCOMPARE(scaled.size(), size);
+    QCOMPARE(scaled, expected);
+}
+
 #ifdef Q_OS_DARWIN
 
 void tst_QImage::toCGImage_data()
@@ -0,0 +1,352 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qimagecache.h>
+#include <qpixmap.h>
+#include <qthread.h>
+#include <qpa/qplatformpixmap.h>
+
+class tst_QImageCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertFind();
+    void replace();
+    void remove();
+    void clear();
+    void rejectsTooLarge();
+    void pixmap();
+    void costLimit();
+    void lru2();
+    void lru2AcrossShards();
+    void scanResistance();
+    void memoryPressure();
+    void trim();
+    void statistics();
+    void threads();
+};
+
+static QImage filledImage(int width, int height, QRgb color)
+{
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    image.fill(color);
+    return image;
+}
+
+static const int imageCost = 16 * 16 * 4;
+
+static bool use(QImageCache &cache, const QString &key)
+{
+    QImage image;
+    return cache.find(key, &image);
+}
+
+void tst_QImageCache::insertFind()
+{
+    QImageCache cache;
+    const QImage image = filledImage(16, 16, 0xff0000ff);
+    QVERIFY(cache.insert(QStringLiteral("blue"), image));
+    QCOMPARE(cache.count(), 1);
+    QCOMPARE(cache.totalCost(), qint64(imageCost));
+    QVERIFY(cache.contains(QStringLiteral("blue")));
+
+    QImage found;
+    QVERIFY(cache.find(QStringLiteral("blue"), &found));
+    QCOMPARE(found, image);
+    QCOMPARE(found.cacheKey(), image.cacheKey());
+
+    QVERIFY(!cache.find(QStringLiteral("red"), &found));
+    QCOMPARE(found, image);
+    QVERIFY(!cache.contains(QStringLiteral("red")));
+
+    QVERIFY(!cache.insert(QStringLiteral("null"), QImage()));
+    QCOMPARE(cache.count(), 1);
+}
+
+void tst_QImageCache::replace()
+{
+    QImageCache cache;
+    QVERIFY(cache.insert(QStringLiteral("a"), filledImage(16, 16, 0xff0000ff)));
+    const QImage larger = filledImage(32, 16, 0xffff0000);
+    QVERIFY(cache.insert(QStringLiteral("a"), larger));
+    QCOMPARE(cache.count(), 1);
+    QCOMPARE(cache.totalCost(), qint64(2 * imageCost));
+
+    QImage found;
+    QVERIFY(cache.find(QStringLiteral("a"), &found));
+    QCOMPARE(found, larger);
+}
+
+void tst_QImageCache::remove()
+{
+    QImageCache cache;
+    QVERIFY(cache.insert(QStringLiteral("a"), filledImage(16, 16, 0xff0000ff)));
+    QVERIFY(cache.insert(QStringLiteral("b"), filledImage(16, 16, 0xff00ff00)));
+    QVERIFY(cache.remove(QStringLiteral("a")));
+    QVERIFY(!cache.remove(QStringLiteral("a")));
+    QCOMPARE(cache.count(), 1);
+    QCOMPARE(cache.totalCost(), qint64(imageCost));
+    QVERIFY(!cache.contains(QStringLiteral("a")));
+    QVERIFY(cache.contains(QStringLiteral("b")));
+    QCOMPARE(cache.evictionCount(), quint64(0));
+}
+
+void tst_QImageCache::clear()
+{
+    QImageCache cache;
+    for (int i = 0; i < 20; ++i)
+        QVERIFY(cache.insert(QString::number(i), filledImage(16, 16, 0xff0000ff)));
+    QCOMPARE(cache.count(), 20);
+    cache.clear();
+    QCOMPARE(cache.count(), 0);
+    QCOMPARE(cache.totalCost(), qint64(0));
+    QVERIFY(!cache.contains(QStringLiteral("3")));
+}
+
+void tst_QImageCache::rejectsTooLarge()
+{
+    QImageCache cache;
+    cache.setMaxCost(imageCost);
+    QVERIFY(cache.insert(QStringLiteral("a"), filledImage(16, 16, 0xff0000ff)));
+    QVERIFY(!cache.insert(QStringLiteral("a"), filledImage(17, 16, 0xff0000ff)));
+    QVERIFY(!cache.contains(QStringLiteral("a")));
+    QCOMPARE(cache.totalCost(), qint64(0));
+}
+
+void tst_QImageCache::pixmap()
+{
+    QPixmap pixmap(16, 16);
+    pixmap.fill(Qt::red);
+    if (pixmap.handle()->classId() != QPlatformPixmap::RasterClass)
+        QSKIP("Pixmaps are not backed by the raster platform pixmap");
+
+    QImageCache cache;
+    QVERIFY(cache.insert(QStringLiteral("red"), pixmap));
+
+    QImage image;
+    QVERIFY(cache.find(QStringLiteral("red"), &image));
+    QCOMPARE(image.size(), QSize(16, 16));
+    QCOMPARE(image.pixel(3, 3), QColor(Qt::red).rgb());
+    QCOMPARE(image.cacheKey(), pixmap.toImage().cacheKey());
+
+    QPixmap found;
+    QVERIFY(cache.find(QStringLiteral("red"), &found));
+    QCOMPARE(found.toImage().constBits(), image.constBits());
+
+    QVERIFY(!cache.insert(QStringLiteral("null"), QPixmap()));
+}
+
+void tst_QImageCache::costLimit()
+{
+    QImageCache cache;
+    QCOMPARE(cache.maxCost(), qint64(10 * 1024 * 1024));
+    cache.setMaxCost(10 * imageCost);
+    for (int i = 0; i < 100; ++i) {
+        QVERIFY(cache.insert(QString::number(i), filledImage(16, 16, 0xff0000ff)));
+        QVERIFY(cache.totalCost() <= cache.maxCost());
+    }
+    QCOMPARE(cache.count(), 10);
+    QCOMPARE(cache.evictionCount(), quint64(90));
+    QVERIFY(cache.contains(QStringLiteral("99")));
+
+    cache.setMaxCost(4 * imageCost);
+    QCOMPARE(cache.count(), 4);
+    QCOMPARE(cache.totalCost(), qint64(4 * imageCost));
+}
+
+// Entries used only once are discarded before entries used twice
+void tst_QImageCache::lru2()
+{
+    QImageCache cache;
+    cache.setMaxCost(3 * imageCost);
+    QVERIFY(cache.insert(QStringLiteral("a"), filledImage(16, 16, 0xff0000ff)));
+    QVERIFY(cache.insert(QStringLiteral("b"), filledImage(16, 16, 0xff00ff00)));
+    QVERIFY(cache.insert(QStringLiteral("c"), filledImage(16, 16, 0xffff0000)));
+    QVERIFY(use(cache, QStringLiteral("a")));
+    QVERIFY(use(cache, QStringLiteral("b")));
+
+    QVERIFY(cache.insert(QStringLiteral("d"), filledImage(16, 16, 0xffffffff)));
+    QVERIFY(cache.contains(QStringLiteral("a")));
+    QVERIFY(cache.contains(QStringLiteral("b")));
+    QVERIFY(!cache.contains(QStringLiteral("c")));
+    QVERIFY(cache.contains(QStringLiteral("d")));
+
+    // the entry just inserted is never discarded to make room for itself
+    QVERIFY(cache.insert(QStringLiteral("e"), filledImage(16, 16, 0xffffffff)));
+    QVERIFY(cache.contains(QStringLiteral("e")));
+    QVERIFY(!cache.contains(QStringLiteral("d")));
+    QCOMPARE(cache.count(), 3);
+}
+
+// Entries are discarded in the same order, whichever shards they are in
+void tst_QImageCache::lru2AcrossShards()
+{
+    QImageCache cache;
+    for (int i = 0; i < 64; ++i)
+        QVERIFY(cache.insert(QString::number(i), filledImage(16, 16, 0xff0000ff)));
+    for (int i = 0; i < 64; ++i)
+        QVERIFY(use(cache, QString::number(i)));
+    for (int i = 0; i < 8; ++i)
+        QVERIFY(cache.insert(QLatin1String("once") + QString::number(i), filledImage(16, 16, 0xff00ff00)));
+
+    cache.trim(16 * imageCost);
+    QCOMPARE(cache.count(), 16);
+    for (int i = 0; i < 64; ++i)
+        QCOMPARE(cache.contains(QString::number(i)), i >= 48);
+}
+
+// A single pass over many images does not push out the images in use
+void tst_QImageCache::scanResistance()
+{
+    QImageCache cache;
+    cache.setMaxCost(40 * imageCost);
+    for (int i = 0; i < 20; ++i) {
+        const QString key = QLatin1String("hot") + QString::number(i);
+        QVERIFY(cache.insert(key, filledImage(16, 16, 0xff0000ff)));
+        QVERIFY(use(cache, key));
+    }
+    for (int i = 0; i < 1000; ++i)
+        QVERIFY(cache.insert(QLatin1String("scan") + QString::number(i), filledImage(16, 16, 0xff00ff00)));
+
+    for (int i = 0; i < 20; ++i)
+        QVERIFY(cache.contains(QLatin1String("hot") + QString::number(i)));
+    QCOMPARE(cache.count(), 40);
+}
+
+void tst_QImageCache::memoryPressure()
+{
+    QImageCache cache;
+    cache.setMaxCost(2 * imageCost);
+    QSignalSpy spy(&cache, &QImageCache::memoryPressure);
+    QVERIFY(cache.insert(QStringLiteral("a"), filledImage(16, 16, 0xff0000ff)));
+    QVERIFY(cache.insert(QStringLiteral("b"), filledImage(16, 16, 0xff0000ff)));
+    QCOMPARE(spy.count(), 0);
+
+    QVERIFY(cache.insert(QStringLiteral("c"), filledImage(16, 16, 0xff0000ff)));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toLongLong(), qint64(2 * imageCost));
+    QCOMPARE(spy.at(0).at(1).toLongLong(), qint64(2 * imageCost));
+
+    // slots may use the cache
+    connect(&cache, &QImageCache::memoryPressure, &cache, [&cache]() { cache.trim(0); });
+    QVERIFY(cache.insert(QStringLiteral("d"), filledImage(16, 16, 0xff0000ff)));
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(cache.count(), 0);
+}
+
+void tst_QImageCache::trim()
+{
+    QImageCache cache;
+    for (int i = 0; i < 10; ++i)
+        QVERIFY(cache.insert(QString::number(i), filledImage(16, 16, 0xff0000ff)));
+    QVERIFY(use(cache, QStringLiteral("0")));
+    cache.trim(imageCost);
+    QCOMPARE(cache.count(), 1);
+    QVERIFY(cache.contains(QStringLiteral("0")));
+    QCOMPARE(cache.maxCost(), qint64(10 * 1024 * 1024));
+    cache.trim(0);
+    QCOMPARE(cache.count(), 0);
+}
+
+void tst_QImageCache::statistics()
+{
+    QImageCache cache;
+    cache.setMaxCost(imageCost);
+    QVERIFY(cache.insert(QStringLiteral("a"), filledImage(16, 16, 0xff0000ff)));
+    QVERIFY(use(cache, QStringLiteral("a")));
+    QVERIFY(use(cache, QStringLiteral("a")));
+    QVERIFY(!use(cache, QStringLiteral("b")));
+    QVERIFY(cache.contains(QStringLiteral("a")));
+    QVERIFY(cache.insert(QStringLiteral("b"), filledImage(16, 16, 0xff0000ff)));
+    QCOMPARE(cache.hitCount(), quint64(2));
+    QCOMPARE(cache.missCount(), quint64(1));
+    QCOMPARE(cache.evictionCount(), quint64(1));
+
+    cache.resetStatistics();
+    QCOMPARE(cache.hitCount(), quint64(0));
+    QCOMPARE(cache.missCount(), quint64(0));
+    QCOMPARE(cache.evictionCount(), quint64(0));
+    QCOMPARE(cache.count(), 1);
+}
+
+class CacheUser : public QThread
+{
+public:
+    CacheUser(QImageCache *cache, int id) : cache(cache), id(id), hits(0), corrupt(false) {}
+
+    void run() override
+    {
+        for (int i = 0; i < 2000; ++i) {
+            const QString key = QString::number((i * 7 + id) % 100);
+            QImage image;
+            if (cache->find(key, &image)) {
+                ++hits;
+                if (image.pixel(0, 0) != qRgb(key.toInt(), 0, 0))
+                    corrupt = true;
+            } else {
+                cache->insert(key, filledImage(16, 16, qRgb(key.toInt(), 0, 0)));
+            }
+            if (i % 100 == 99)
+                cache->remove(QString::number(i % 100));
+        }
+    }
+
+    QImageCache *cache;
+    int id;
+    int hits;
+    bool corrupt;
+};
+
+void tst_QImageCache::threads()
+{
+    QImageCache cache;
+    cache.setMaxCost(50 * imageCost);
+    QVector<CacheUser *> users;
+    for (int i = 0; i < 8; ++i)
+        users << new CacheUser(&cache, i);
+    for (CacheUser *user : qAsConst(users))
+        user->start();
+    quint64 hits = 0;
+    for (CacheUser *user : qAsConst(users)) {
+        QVERIFY(user->wait());
+        QVERIFY(!user->corrupt);
+        hits += user->hits;
+    }
+    qDeleteAll(users);
+
+    QVERIFY(cache.totalCost() <= cache.maxCost());
+    QCOMPARE(cache.totalCost(), qint64(cache.count()) * imageCost);
+    QCOMPARE(cache.hitCount(), hits);
+    QCOMPARE(cache.hitCount() + cache.missCount(), quint64(8 * 2000));
+}
+
+QTEST_MAIN(tst_QImageCache)
+#include "tst_qimagecache.moc"
@@ -81,6 +81,9 @@ private slots:
     void readImage_data();
     void readImage();
     void jpegRgbCmyk();
+    void jpegRegionDecode_data();
+    void jpegRegionDecode();
+    void jpegScaledClipRect();
 
     void setScaledSize_data();
     void setScaledSize();
@@ -164,6 +167,13 @@ private slots:
     void preserveTexts_data();
     void preserveTexts();
 
+    void readIncrementally_data();
+    void readIncrementally();
+    void readIncrementallyAnimation();
+    void readIncrementallyCorrupt();
+
+    void readThumbnails();
+
 private:
     QString prefix;
     QTemporaryDir m_temporaryDir;
@@ -333,6 +343,97 @@ void tst_QImageReader::jpegRgbCmyk()
     }
 }
 
+static QByteArray generatedJpeg(int quality)
+{
+    QImage image(300, 200, QImage::Format_RGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x)
+            image.setPixel(x, y, qRgb(x * 255 / 300, y * 255 / 200, (x * y) & 0xff));
+    }
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "jpeg", quality);
+    return data;
+}
+
+void tst_QImageReader::jpegRegionDecode_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QRect>("clipRect");
+    QTest::addColumn<int>("quality");
+
+    if (!QImageReader::supportedImageFormats().contains("jpeg"))
+        return;
+
+    const QByteArray generated = generatedJpeg(90);
+    QTest::newRow("unaligned") << generated << QRect(37, 53, 101, 67) << -1;
+    QTest::newRow("aligned") << generated << QRect(64, 64, 64, 64) << -1;
+    QTest::newRow("rows") << generated << QRect(0, 100, 300, 50) << -1;
+    QTest::newRow("columns") << generated << QRect(150, 0, 150, 200) << -1;
+    QTest::newRow("fast decoding") << generated << QRect(37, 53, 101, 67) << 25;
+
+    QFile gray(prefix + "beavis.jpg");
+    QVERIFY(gray.open(QIODevice::ReadOnly));
+    QTest::newRow("grayscale") << gray.readAll() << QRect(33, 21, 150, 100) << -1;
+    QFile cmyk(prefix + "YCbCr_cmyk.jpg");
+    QVERIFY(cmyk.open(QIODevice::ReadOnly));
+    QTest::newRow("cmyk") << cmyk.readAll() << QRect(9, 17, 40, 20) << -1;
+}
+
+// The handler only decodes the MCU rows and columns the clip rectangle
+// covers; the result must match clipping a full decode.
+void tst_QImageReader::jpegRegionDecode()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QRect, clipRect);
+    QFETCH(int, quality);
+
+    SKIP_IF_UNSUPPORTED("jpeg");
+
+    QBuffer buffer(&data);
+    QImageReader reader(&buffer, "jpeg");
+    reader.setQuality(quality);
+    reader.setClipRect(clipRect);
+    const QImage image = reader.read();
+    QVERIFY2(!image.isNull(), qPrintable(reader.errorString()));
+    QCOMPARE(image.size(), clipRect.size());
+
+    QBuffer originalBuffer(&data);
+    QImageReader originalReader(&originalBuffer, "jpeg");
+    originalReader.setQuality(quality);
+    const QImage original = originalReader.read();
+    QCOMPARE(image, original.copy(clipRect));
+}
+
+void tst_QImageReader::jpegScaledClipRect()
+{
+    SKIP_IF_UNSUPPORTED("jpeg");
+
+    // A clip rectangle scaled by a factor that is not a power of two is
+    // decoded at 3/8 size and then scaled the rest of the way.
+    QByteArray data = generatedJpeg(90);
+    QBuffer buffer(&data);
+    QImageReader reader(&buffer, "jpeg");
+    reader.setClipRect(QRect(64, 32, 160, 160));
+    reader.setScaledSize(QSize(53, 53));
+    const QImage image = reader.read();
+    QCOMPARE(image.size(), QSize(53, 53));
+
+    QBuffer originalBuffer(&data);
+    const QImage expected = QImageReader(&originalBuffer, "jpeg").read()
+            .copy(QRect(64, 32, 160, 160)).scaled(53, 53, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    for (int y = 0; y < image.height(); y += 13) {
+        for (int x = 0; x < image.width(); x += 13) {
+            const QRgb a = image.pixel(x, y);
+            const QRgb b = expected.pixel(x, y);
+            QVERIFY(qAbs(qRed(a) - qRed(b)) < 24);
+            QVERIFY(qAbs(qGreen(a) - qGreen(b)) < 24);
+            QVERIFY(qAbs(qBlue(a) - qBlue(b)) < 24);
+        }
+    }
+}
+
 void tst_QImageReader::setScaledSize_data()
 {
     QTest::addColumn<QString>("fileName");
@@ -1597,7 +1698,8 @@ void tst_QImageReader::supportsOption_data()
                               << QImageIOHandler::Description
                               << QImageIOHandler::Quality
                               << QImageIOHandler::Size
-                              << QImageIOHandler::ScaledSize);
+                              << QImageIOHandler::ScaledSize
+                              << QImageIOHandler::IncrementalReading);
 }
 
 void tst_QImageReader::supportsOption()
@@ -1966,6 +2068,154 @@ void tst_QImageReader::preserveTexts()
     QCOMPARE(r.text(key3), text3.simplified());
 }
 
+// sequential device that hands out the data fed to it so far, like a
+// network reply does
+class IncrementalDevice : public QIODevice
+{
+public:
+    IncrementalDevice() { open(QIODevice::ReadOnly); }
+
+    void feed(const QByteArray &data) { pending += data; }
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override { return pending.size() + QIODevice::bytesAvailable(); }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        const int n = int(qMin<qint64>(maxSize, pending.size()));
+        memcpy(data, pending.constData(), n);
+        pending.remove(0, n);
+        return n;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    QByteArray pending;
+};
+
+void tst_QImageReader::readIncrementally_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<int>("chunkSize");
+
+    QTest::newRow("png") << QString("kollada.png") << 97;
+    QTest::newRow("png, interlaced") << QString("txts.png") << 61;
+    QTest::newRow("png, one chunk") << QString("image.png") << 4096;
+    QTest::newRow("gif") << QString("trolltech.gif") << 509;
+    QTest::newRow("gif, transparent") << QString("trans.gif") << 31;
+}
+
+void tst_QImageReader::readIncrementally()
+{
+    QFETCH(QString, fileName);
+    QFETCH(int, chunkSize);
+
+    QFile file(prefix + fileName);
+    QVERIFY2(file.open(QIODevice::ReadOnly), msgFileOpenReadFailed(file).constData());
+    const QByteArray data = file.readAll();
+    const QImage expected = QImageReader(prefix + fileName).read();
+    QVERIFY(!expected.isNull());
+
+    IncrementalDevice device;
+    QImageReader reader(&device);
+    QImage image;
+    QRect updated;
+    QRect covered;
+    int partialUpdates = 0;
+    for (int pos = 0; pos < data.size() && !reader.isIncrementalReadFinished(); pos += chunkSize) {
+        device.feed(data.mid(pos, chunkSize));
+        QVERIFY2(reader.readIncrementally(&image, &updated), qPrintable(reader.errorString()));
+        QVERIFY(image.rect().contains(updated) || updated.isNull());
+        covered |= updated;
+        if (!reader.isIncrementalReadFinished() && !updated.isEmpty())
+            ++partialUpdates;
+    }
+
+    QVERIFY(reader.isIncrementalReadFinished());
+    QCOMPARE(image, expected);
+    QCOMPARE(covered, expected.rect());
+    if (chunkSize < data.size())
+        QVERIFY(partialUpdates > 0);
+}
+
+void tst_QImageReader::readIncrementallyAnimation()
+{
+    QFile file(prefix + "four-frames.gif");
+    QVERIFY2(file.open(QIODevice::ReadOnly), msgFileOpenReadFailed(file).constData());
+    const QByteArray data = file.readAll();
+
+    QList<QImage> expected;
+    QImageReader frameReader(prefix + "four-frames.gif");
+    for (QImage frame = frameReader.read(); !frame.isNull(); frame = frameReader.read())
+        expected << frame;
+    QCOMPARE(expected.size(), 4);
+
+    IncrementalDevice device;
+    QImageReader reader(&device);
+    QImage image;
+    QList<QImage> frames;
+    for (int pos = 0; pos < data.size(); pos += 16) {
+        device.feed(data.mid(pos, 16));
+        QVERIFY(reader.readIncrementally(&image));
+        if (reader.isIncrementalReadFinished())
+            frames << image;
+    }
+    QCOMPARE(frames, expected);
+}
+
+void tst_QImageReader::readIncrementallyCorrupt()
+{
+    QFile file(prefix + "kollada.png");
+    QVERIFY2(file.open(QIODevice::ReadOnly), msgFileOpenReadFailed(file).constData());
+    QByteArray data = file.readAll();
+    // damage the image data; libpng notices when the row filter is invalid
+    for (int i = data.size() / 2; i < data.size() / 2 + 512; ++i)
+        data[i] = char(0xff);
+
+    IncrementalDevice device;
+    QImageReader reader(&device);
+    QImage image;
+    bool ok = true;
+    for (int pos = 0; ok && pos < data.size(); pos += 256) {
+        device.feed(data.mid(pos, 256));
+        ok = reader.readIncrementally(&image);
+    }
+    QVERIFY(!ok);
+    QCOMPARE(reader.error(), QImageReader::InvalidDataError);
+    QVERIFY(!reader.isIncrementalReadFinished());
+}
+
+void tst_QImageReader::readThumbnails()
+{
+    QStringList fileNames;
+    fileNames << prefix + "kollada.png"             // 436x160
+              << prefix + "image.png"               // 22x22, smaller than the thumbnail
+              << prefix + "does-not-exist.png"
+              << prefix + "trolltech.gif";          // 128x64
+    if (QImageReader::supportedImageFormats().contains("jpeg"))
+        fileNames << prefix + "beavis.jpg";
+    // more files than threads
+    for (int i = 0; i < 3; ++i)
+        fileNames += fileNames;
+
+    const QSize size(64, 64);
+    const QVector<QImage> thumbnails = QImageReader::readThumbnails(fileNames, size);
+    QCOMPARE(thumbnails.size(), fileNames.size());
+
+    for (int i = 0; i < fileNames.size(); ++i) {
+        const QImage &thumbnail = thumbnails.at(i);
+        if (fileNames.at(i).endsWith("does-not-exist.png")) {
+            QVERIFY(thumbnail.isNull());
+            continue;
+        }
+        const QSize imageSize = QImageReader(fileNames.at(i)).size();
+        QSize expectedSize = imageSize;
+        if (imageSize.width() > size.width() || imageSize.height() > size.height())
+            expectedSize = imageSize.scaled(size, Qt::KeepAspectRatio);
+        QCOMPARE(thumbnail.size(), expectedSize);
+    }
+}
 
 QTEST_MAIN(tst_QImageReader)
 #include "tst_qimagereader.moc"
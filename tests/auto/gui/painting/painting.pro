@@ -3,6 +3,7 @@ SUBDIRS=\
    qpainterpath \
    qpainterpathstroker \
    qcolor \
+   qdrawhelper \
    qbrush \
    qregion \
    qpagelayout \
@@ -12,11 +13,13 @@ SUBDIRS=\
    qpdfwriter \
    qpen \
    qpaintengine \
+   qtiledimagepaintdevice \
    qtransform \
    qwmatrix \
    qpolygon \
 
 !qtConfig(private_tests): SUBDIRS -= \
     qpathclipper \
+    qdrawhelper \
 
 
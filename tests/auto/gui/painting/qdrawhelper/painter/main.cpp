@@ -0,0 +1,220 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+// Paints every scene that tst_QDrawHelper compares onto each destination
+// format and writes the raw pixels to the directory given as the first
+// argument. tst_QDrawHelper runs this with different QT_NO_CPU_FEATURE
+// values, since the raster engine picks its SIMD functions once per process.
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtGui/QImage>
+#include <QtGui/QLinearGradient>
+#include <QtGui/QPainter>
+
+#include <stdio.h>
+
+static const struct {
+    QImage::Format format;
+    const char *name;
+} destinationFormats[] = {
+    { QImage::Format_RGB32, "RGB32" },
+    { QImage::Format_ARGB32, "ARGB32" },
+    { QImage::Format_ARGB32_Premultiplied, "ARGB32_Premultiplied" },
+    { QImage::Format_RGB16, "RGB16" },
+    { QImage::Format_RGBX8888, "RGBX8888" },
+    { QImage::Format_RGBA8888, "RGBA8888" },
+    { QImage::Format_RGBA8888_Premultiplied, "RGBA8888_Premultiplied" },
+    { QImage::Format_BGR30, "BGR30" },
+    { QImage::Format_A2BGR30_Premultiplied, "A2BGR30_Premultiplied" },
+    { QImage::Format_RGB30, "RGB30" },
+    { QImage::Format_A2RGB30_Premultiplied, "A2RGB30_Premultiplied" },
+    { QImage::Format_Grayscale8, "Grayscale8" }
+};
+
+static const QImage::Format sourceFormats[] = {
+    QImage::Format_ARGB32,
+    QImage::Format_ARGB32_Premultiplied,
+    QImage::Format_RGBA8888,
+    QImage::Format_RGBA8888_Premultiplied,
+    QImage::Format_A2BGR30_Premultiplied,
+    QImage::Format_RGB30,
+    QImage::Format_A2RGB30_Premultiplied,
+    QImage::Format_Grayscale8
+};
+
+// Odd sizes, so that the SIMD functions also go through their unaligned
+// heads and partial tails.
+static const int ImageWidth = 211;
+static const int RowHeight = 2;
+static const int CompositionModeCount = QPainter::CompositionMode_Exclusion + 1;
+
+// Sets the pixels one by one, so that the images do not depend on the
+// conversion functions that are being compared.
+static QImage createImage(const QSize &size, QImage::Format format, bool translucent)
+{
+    QImage image(size, format);
+    for (int y = 0; y < size.height(); ++y) {
+        for (int x = 0; x < size.width(); ++x) {
+            const int alpha = translucent ? (x * 7 + y * 31) % 256 : 255;
+            image.setPixelColor(x, y, QColor((x * 5) % 256, (x + y * 11) % 256, (x * 3 + y * 7) % 256, alpha));
+        }
+    }
+    return image;
+}
+
+// Draws every source format with every composition mode, each onto its own
+// rows and at its own offset.
+static void drawImages(QPainter *p)
+{
+    int row = 0;
+    for (QImage::Format format : sourceFormats) {
+        const QImage source = createImage(QSize(ImageWidth - 9, RowHeight), format, true);
+        for (int mode = 0; mode < CompositionModeCount; ++mode) {
+            for (qreal opacity : { qreal(1), qreal(0.5) }) {
+                p->setCompositionMode(QPainter::CompositionMode(mode));
+                p->setOpacity(opacity);
+                p->drawImage(QPoint(row % 9, row * RowHeight), source);
+                ++row;
+            }
+        }
+    }
+}
+
+static void drawFills(QPainter *p)
+{
+    int row = 0;
+    for (const QColor &color : { QColor(40, 160, 220), QColor(40, 160, 220, 140), QColor(255, 255, 255, 1) }) {
+        for (int mode = 0; mode < CompositionModeCount; ++mode) {
+            for (qreal opacity : { qreal(1), qreal(0.5) }) {
+                p->setCompositionMode(QPainter::CompositionMode(mode));
+                p->setOpacity(opacity);
+                p->fillRect(QRect(row % 9, row * RowHeight, ImageWidth - 2 * (row % 9), RowHeight), color);
+                ++row;
+            }
+        }
+    }
+}
+
+// Linear gradients that go through the fixed point loop, with and without
+// wrapping around, and in both directions.
+static void drawGradients(QPainter *p)
+{
+    const QLineF lines[] = {
+        QLineF(10, 0, 190, 0),
+        QLineF(190.5, 0, 10.25, 0),
+        QLineF(100, 0, 117, 3),
+        QLineF(60, 0, 54.5, 40),
+        QLineF(-3000, 0, -2983, 0),
+        QLineF(0, 0, 0.75, 0)
+    };
+
+    int row = 0;
+    for (const QLineF &line : lines) {
+        for (int spread = QGradient::PadSpread; spread <= QGradient::RepeatSpread; ++spread) {
+            for (bool translucent : { false, true }) {
+                for (QPainter::CompositionMode mode : { QPainter::CompositionMode_Source,
+                                                        QPainter::CompositionMode_SourceOver,
+                                                        QPainter::CompositionMode_Plus }) {
+                    QLinearGradient gradient(line.p1(), line.p2());
+                    gradient.setSpread(QGradient::Spread(spread));
+                    gradient.setColorAt(0, QColor(255, 0, 0, translucent ? 30 : 255));
+                    gradient.setColorAt(0.4, QColor(0, 255, 0, translucent ? 200 : 255));
+                    gradient.setColorAt(1, QColor(0, 0, 255, translucent ? 100 : 255));
+                    p->setCompositionMode(mode);
+                    p->fillRect(QRect(row % 7, row * RowHeight, ImageWidth - row % 7, RowHeight), gradient);
+                    ++row;
+                }
+            }
+        }
+    }
+}
+
+// Scaled images, which go through the bilinear fetch functions. Rotated
+// images are left out: the AVX2 version of the rotating fetch interpolates
+// with more precision than the generic one.
+static void drawScaledImages(QPainter *p)
+{
+    const QImage source = createImage(QSize(37, 23), QImage::Format_ARGB32_Premultiplied, true);
+    p->setRenderHint(QPainter::SmoothPixmapTransform);
+    p->drawImage(QRectF(0.5, 0.25, ImageWidth - 1, 60), source);
+    p->drawImage(QRectF(3, 64, 20.5, 16), source);
+    p->drawImage(QRectF(30.25, 85.5, 170, 70), source, QRectF(3.5, 2.25, 30, 19));
+}
+
+static const struct {
+    const char *name;
+    void (*draw)(QPainter *);
+    int height;
+} scenes[] = {
+    { "images", drawImages, int(sizeof(sourceFormats) / sizeof(sourceFormats[0])) * CompositionModeCount * 2 * RowHeight },
+    { "fills", drawFills, 3 * CompositionModeCount * 2 * RowHeight },
+    { "gradients", drawGradients, 6 * 3 * 2 * 3 * RowHeight },
+    { "scaled", drawScaledImages, 160 }
+};
+
+static bool writeImage(const QString &fileName, const QImage &image)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    QDataStream stream(&file);
+    stream << int(image.format()) << image.size()
+           << QByteArray::fromRawData(reinterpret_cast<const char *>(image.constBits()), image.sizeInBytes());
+    return stream.status() == QDataStream::Ok;
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <output directory>\n", argv[0]);
+        return 1;
+    }
+    const QDir output(QString::fromLocal8Bit(argv[1]));
+
+    for (const auto &scene : scenes) {
+        for (const auto &destination : destinationFormats) {
+            QImage image = createImage(QSize(ImageWidth, scene.height), destination.format, true);
+            QPainter p(&image);
+            scene.draw(&p);
+            p.end();
+
+            const QString fileName = output.filePath(QString::fromLatin1("%1, %2").arg(QLatin1String(scene.name),
+                                                                                      QLatin1String(destination.name)));
+            if (!writeImage(fileName, image)) {
+                fprintf(stderr, "Cannot write %s\n", qPrintable(fileName));
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,11 @@
+TEMPLATE = app
+
+TARGET = painter
+QT = core gui
+
+DESTDIR = ./
+
+CONFIG -= app_bundle
+CONFIG += console
+
+SOURCES += main.cpp
@@ -0,0 +1,6 @@
+CONFIG += testcase
+TARGET = ../tst_qdrawhelper
+QT = core-private gui testlib
+SOURCES = ../tst_qdrawhelper.cpp
+
+TEST_HELPER_INSTALLS = ../painter/painter
@@ -0,0 +1,180 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QProcess>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/private/qsimd_p.h>
+#include <QtGui/QImage>
+
+// The raster engine picks the SIMD versions of its blend, conversion and
+// gradient functions once, when QtGui is loaded. The painter helper is run
+// with QT_NO_CPU_FEATURE set to turn them off, and the images that it paints
+// are compared to the ones painted with them.
+class tst_QDrawHelper : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void identicalToGeneric_data();
+    void identicalToGeneric();
+
+private:
+    bool paint(const QString &variant, const QByteArray &disabledFeatures);
+
+    QTemporaryDir outputDir;
+    QString painterExe;
+};
+
+// The generic path still uses SSE2, which the x86-64 builds require.
+static const char genericFeatures[] = "avx512f avx2 avx sse4.2 sse4.1 ssse3 sse3";
+
+static bool hasAvx512()
+{
+#ifdef Q_PROCESSOR_X86
+    return qCpuHasFeature(AVX512F) && qCpuHasFeature(AVX512CD) && qCpuHasFeature(AVX512BW)
+            && qCpuHasFeature(AVX512DQ) && qCpuHasFeature(AVX512VL);
+#else
+    return false;
+#endif
+}
+
+static bool hasAvx2()
+{
+#ifdef Q_PROCESSOR_X86
+    return qCpuHasFeature(AVX2);
+#else
+    return false;
+#endif
+}
+
+static QImage readImage(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return QImage();
+    QDataStream stream(&file);
+    int format;
+    QSize size;
+    QByteArray bits;
+    stream >> format >> size >> bits;
+    if (stream.status() != QDataStream::Ok)
+        return QImage();
+    QImage image(size, QImage::Format(format));
+    if (image.sizeInBytes() != bits.size())
+        return QImage();
+    memcpy(image.bits(), bits.constData(), bits.size());
+    return image;
+}
+
+void tst_QDrawHelper::initTestCase()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+    if (!hasAvx2())
+        QSKIP("The processor does not support AVX2");
+    QVERIFY(outputDir.isValid());
+
+    const QString painterDir = QFINDTESTDATA("painter");
+    QVERIFY2(!painterDir.isEmpty(), qPrintable(
+        QString::fromLatin1("Couldn't find helper app dir starting from %1.").arg(QDir::currentPath())));
+    painterExe = painterDir + QLatin1String("/painter");
+
+    QVERIFY(paint(QStringLiteral("generic"), genericFeatures));
+    QVERIFY(paint(QStringLiteral("avx2"), "avx512f"));
+    if (hasAvx512())
+        QVERIFY(paint(QStringLiteral("avx512"), QByteArray()));
+#endif
+}
+
+bool tst_QDrawHelper::paint(const QString &variant, const QByteArray &disabledFeatures)
+{
+#if QT_CONFIG(process)
+    QDir dir(outputDir.path());
+    if (!dir.mkdir(variant))
+        return false;
+
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    if (disabledFeatures.isEmpty())
+        environment.remove(QStringLiteral("QT_NO_CPU_FEATURE"));
+    else
+        environment.insert(QStringLiteral("QT_NO_CPU_FEATURE"), QString::fromLatin1(disabledFeatures));
+
+    QProcess process;
+    process.setProcessEnvironment(environment);
+    process.setProcessChannelMode(QProcess::ForwardedChannels);
+    process.start(painterExe, QStringList(dir.filePath(variant)));
+    if (!process.waitForStarted()) {
+        qWarning("Could not start %s: %s", qPrintable(painterExe), qPrintable(process.errorString()));
+        return false;
+    }
+    return process.waitForFinished(60000) && process.exitStatus() == QProcess::NormalExit
+            && process.exitCode() == 0;
+#else
+    Q_UNUSED(variant);
+    Q_UNUSED(disabledFeatures);
+    return false;
+#endif
+}
+
+void tst_QDrawHelper::identicalToGeneric_data()
+{
+    QTest::addColumn<QString>("variant");
+    QTest::addColumn<QString>("scene");
+
+    const QStringList scenes = QDir(outputDir.path() + QLatin1String("/generic")).entryList(QDir::Files);
+    QVERIFY(!scenes.isEmpty());
+    QStringList variants(QStringLiteral("avx2"));
+    if (hasAvx512())
+        variants << QStringLiteral("avx512");
+    for (const QString &variant : qAsConst(variants)) {
+        for (const QString &scene : scenes)
+            QTest::newRow(qPrintable(variant + QLatin1String(", ") + scene)) << variant << scene;
+    }
+}
+
+void tst_QDrawHelper::identicalToGeneric()
+{
+    QFETCH(QString, variant);
+    QFETCH(QString, scene);
+
+    const QImage generic = readImage(outputDir.path() + QLatin1String("/generic/") + scene);
+    const QImage image = readImage(outputDir.path() + QLatin1Char('/') + variant + QLatin1Char('/') + scene);
+    QVERIFY(!generic.isNull());
+    QVERIFY(!image.isNull());
+    QCOMPARE(image, generic);
+}
+
+QTEST_MAIN(tst_QDrawHelper)
+#include "tst_qdrawhelper.moc"
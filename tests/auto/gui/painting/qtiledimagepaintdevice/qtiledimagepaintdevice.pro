@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qtiledimagepaintdevice
+SOURCES += tst_qtiledimagepaintdevice.cpp
+QT += testlib
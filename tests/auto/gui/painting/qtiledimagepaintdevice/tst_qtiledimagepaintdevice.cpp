@@ -0,0 +1,443 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qimage.h>
+#include <qpainter.h>
+#include <qpainterpath.h>
+#include <qpixmap.h>
+#include <qstatictext.h>
+#include <qthreadpool.h>
+#include <qtiledimagepaintdevice.h>
+
+Q_DECLARE_METATYPE(QImage::Format)
+
+class tst_QTiledImagePaintDevice : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void tileHeight();
+    void metrics();
+    void unsupportedFormat();
+    void emptyPainting();
+    void identicalToSerial_data();
+    void identicalToSerial();
+    void clippedToTiles();
+    void rotatedOutlines_data();
+    void rotatedOutlines();
+
+private:
+    int maxThreadCount;
+};
+
+static QImage checkerImage(int size, const QColor &first, const QColor &second)
+{
+    QImage image(size, size, QImage::Format_ARGB32);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x)
+            image.setPixelColor(x, y, ((x / 4 + y / 4) & 1) ? first : second);
+    }
+    return image;
+}
+
+// Draws a bit of everything that the raster engine handles itself, with
+// state changes, transforms and clips in between.
+static void drawScene(QPainter *p, const QSize &size)
+{
+    const int w = size.width();
+    const int h = size.height();
+
+    QLinearGradient background(0, 0, w, h);
+    background.setColorAt(0, QColor(255, 255, 240));
+    background.setColorAt(1, QColor(40, 60, 120));
+    p->fillRect(QRect(0, 0, w, h), background);
+    p->fillRect(QRectF(w * 0.1, h * 0.1, w * 0.3, h * 0.2), QColor(200, 30, 30, 128));
+
+    p->setRenderHint(QPainter::Antialiasing);
+    for (int i = 0; i < 12; ++i) {
+        QRadialGradient gradient(QPointF(i * w / 12.0, h / 3.0), w / 8.0);
+        gradient.setColorAt(0, QColor::fromHsv(i * 30, 255, 255, 200));
+        gradient.setColorAt(1, Qt::transparent);
+        p->setBrush(gradient);
+        p->setPen(QPen(QColor::fromHsv(i * 30, 200, 120), 1.5));
+        p->drawEllipse(QPointF(i * w / 12.0, h / 3.0), w / 10.0, h / 12.0);
+    }
+
+    QPainterPath path;
+    path.moveTo(w * 0.05, h * 0.9);
+    path.cubicTo(w * 0.3, h * 0.2, w * 0.6, h * 1.1, w * 0.95, h * 0.5);
+    path.lineTo(w * 0.7, h * 0.95);
+    path.closeSubpath();
+    p->setBrush(QColor(30, 160, 90, 150));
+    p->setPen(QPen(Qt::darkBlue, 7, Qt::DashDotLine, Qt::RoundCap, Qt::MiterJoin));
+    p->drawPath(path);
+
+    p->save();
+    p->translate(w / 2.0, h / 2.0);
+    p->scale(1.5, 0.75);
+    p->setOpacity(0.6);
+    p->setPen(QPen(Qt::black, 0));
+    p->setBrush(Qt::Dense4Pattern);
+    p->drawRect(QRectF(-w / 4.0, -h / 6.0, w / 2.0, h / 3.0));
+    p->drawRoundedRect(QRectF(-w / 8.0, -h / 8.0, w / 4.0, h / 4.0), 10, 10);
+    p->restore();
+
+    p->setRenderHint(QPainter::Antialiasing, false);
+    p->setPen(QPen(Qt::darkGreen, 0));
+    QVector<QLine> lines;
+    for (int i = 0; i < 40; ++i)
+        lines << QLine(i * w / 40, 0, w - i * w / 40, h);
+    p->drawLines(lines);
+    p->setPen(QPen(Qt::darkGreen, 3));
+    QVector<QPointF> points;
+    for (int i = 0; i < 200; ++i)
+        points << QPointF((i * 37) % w, (i * 53) % h);
+    p->drawPoints(points.constData(), points.size());
+    const QPoint polygon[] = { QPoint(w / 10, h / 2), QPoint(w / 4, h / 3), QPoint(w / 3, h * 2 / 3),
+                               QPoint(w / 6, h * 3 / 4) };
+    p->setBrush(QColor(250, 200, 0));
+    p->drawPolygon(polygon, 4, Qt::WindingFill);
+    p->drawPolyline(polygon, 4);
+
+    const QImage checker = checkerImage(32, QColor(255, 0, 0, 160), QColor(0, 0, 255, 220));
+    p->drawImage(QPointF(w * 0.6, h * 0.05), checker);
+    p->setRenderHint(QPainter::SmoothPixmapTransform);
+    p->drawImage(QRectF(w * 0.55, h * 0.55, w * 0.4, h * 0.3), checker, QRectF(2, 2, 27, 27));
+    p->save();
+    p->translate(w * 0.3, h * 0.6);
+    p->rotate(-15);
+    p->scale(1.7, 0.8);
+    p->drawImage(QPointF(0, 0), checker);
+    p->drawPixmap(QPointF(40, 0), QPixmap::fromImage(checker));
+    p->restore();
+    p->drawPixmap(QRectF(w * 0.05, h * 0.05, 50, 20), QPixmap::fromImage(checker), QRectF(0, 0, 32, 12));
+    p->drawTiledPixmap(QRectF(w * 0.8, h * 0.3, w * 0.15, h * 0.4), QPixmap::fromImage(checker), QPointF(3, 5));
+
+    QBrush texture(checker);
+    p->setBrushOrigin(7, 3);
+    p->setPen(Qt::NoPen);
+    p->setBrush(texture);
+    p->drawEllipse(QRectF(w * 0.4, h * 0.7, w * 0.2, h * 0.25));
+
+    p->save();
+    p->setClipRect(QRectF(w * 0.1, h * 0.1, w * 0.5, h * 0.5));
+    QPainterPath clipPath;
+    clipPath.addEllipse(QRectF(w * 0.2, h * 0.2, w * 0.5, h * 0.5));
+    p->setClipPath(clipPath, Qt::IntersectClip);
+    p->setCompositionMode(QPainter::CompositionMode_Multiply);
+    p->fillRect(QRect(0, 0, w, h), QColor(120, 200, 255));
+    p->setClipping(false);
+    p->setCompositionMode(QPainter::CompositionMode_SourceOver);
+    p->fillRect(QRect(w / 2 - 4, 0, 8, h), QColor(0, 0, 0, 60));
+    p->setClipping(true);
+    p->fillRect(QRect(0, h / 2 - 4, w, 8), QColor(255, 255, 255, 120));
+    p->restore();
+
+    p->setClipRegion(QRegion(QRect(0, 0, w / 2, h)) - QRegion(QRect(w / 8, h / 8, w / 8, h / 8)));
+    p->setPen(QPen(QColor(90, 0, 90), 2));
+    QFont font;
+    font.setPixelSize(qMax(8, h / 20));
+    p->setFont(font);
+    p->drawText(QRectF(0, 0, w, h), Qt::AlignCenter | Qt::TextWordWrap,
+                QStringLiteral("The quick brown fox jumps over the lazy dog"));
+    p->setClipping(false);
+    p->rotate(10);
+    p->drawStaticText(QPointF(w * 0.2, h * 0.1), QStaticText(QStringLiteral("Static text")));
+    p->drawText(QPointF(w * 0.1, h * 0.95), QStringLiteral("Rotated text"));
+}
+
+static QImage paintSerially(QImage image)
+{
+    QPainter p(&image);
+    drawScene(&p, image.size() / image.devicePixelRatio());
+    p.end();
+    return image;
+}
+
+static QImage paintTiled(QImage image, int tileHeight)
+{
+    QTiledImagePaintDevice device(&image);
+    device.setTileHeight(tileHeight);
+    QPainter p(&device);
+    drawScene(&p, image.size() / image.devicePixelRatio());
+    p.end();
+    return image;
+}
+
+void tst_QTiledImagePaintDevice::initTestCase()
+{
+    // Make sure that several threads take part, even on single core machines.
+    maxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount(4);
+}
+
+void tst_QTiledImagePaintDevice::cleanupTestCase()
+{
+    QThreadPool::globalInstance()->setMaxThreadCount(maxThreadCount);
+}
+
+void tst_QTiledImagePaintDevice::tileHeight()
+{
+    QImage image(10, 10, QImage::Format_RGB32);
+    QTiledImagePaintDevice device(&image);
+    QCOMPARE(device.image(), &image);
+    QCOMPARE(device.tileHeight(), 64);
+
+    device.setTileHeight(32);
+    QCOMPARE(device.tileHeight(), 32);
+
+    QTest::ignoreMessage(QtWarningMsg, "QTiledImagePaintDevice::setTileHeight: Invalid tile height 0");
+    device.setTileHeight(0);
+    QCOMPARE(device.tileHeight(), 32);
+
+    QPainter p(&device);
+    QTest::ignoreMessage(QtWarningMsg, "QTiledImagePaintDevice::setTileHeight: Cannot change the tile height while painting");
+    device.setTileHeight(16);
+    QCOMPARE(device.tileHeight(), 32);
+}
+
+void tst_QTiledImagePaintDevice::metrics()
+{
+    QImage image(300, 200, QImage::Format_ARGB32_Premultiplied);
+    image.setDotsPerMeterX(4000);
+    image.setDotsPerMeterY(2000);
+    image.setDevicePixelRatio(2);
+    QTiledImagePaintDevice device(&image);
+
+    QCOMPARE(device.width(), image.width());
+    QCOMPARE(device.height(), image.height());
+    QCOMPARE(device.widthMM(), image.widthMM());
+    QCOMPARE(device.heightMM(), image.heightMM());
+    QCOMPARE(device.depth(), image.depth());
+    QCOMPARE(device.logicalDpiX(), image.logicalDpiX());
+    QCOMPARE(device.logicalDpiY(), image.logicalDpiY());
+    QCOMPARE(device.devicePixelRatioF(), image.devicePixelRatioF());
+}
+
+void tst_QTiledImagePaintDevice::unsupportedFormat()
+{
+    QImage image(16, 16, QImage::Format_Indexed8);
+    QTiledImagePaintDevice device(&image);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Cannot paint on an image of format"));
+    QTest::ignoreMessage(QtWarningMsg, "QPainter::begin(): Returned false");
+    QPainter p;
+    QVERIFY(!p.begin(&device));
+}
+
+void tst_QTiledImagePaintDevice::emptyPainting()
+{
+    QImage image(64, 64, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+    const QImage before = image.copy();
+
+    QTiledImagePaintDevice device(&image);
+    QPainter p(&device);
+    p.fillRect(QRect(100, 100, 10, 10), Qt::blue);
+    p.setClipRect(QRect(0, 0, 10, 10));
+    p.fillRect(QRect(20, 20, 10, 10), Qt::blue);
+    QVERIFY(p.end());
+    QCOMPARE(image, before);
+}
+
+void tst_QTiledImagePaintDevice::identicalToSerial_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+    QTest::addColumn<QSize>("imageSize");
+    QTest::addColumn<int>("tileHeight");
+    QTest::addColumn<qreal>("devicePixelRatio");
+
+    QTest::newRow("argb32pm") << QImage::Format_ARGB32_Premultiplied << QSize(400, 300) << 64 << qreal(1);
+    QTest::newRow("argb32pm, odd tiles") << QImage::Format_ARGB32_Premultiplied << QSize(401, 299) << 37 << qreal(1);
+    QTest::newRow("argb32pm, one tile") << QImage::Format_ARGB32_Premultiplied << QSize(200, 150) << 256 << qreal(1);
+    QTest::newRow("rgb32") << QImage::Format_RGB32 << QSize(400, 300) << 50 << qreal(1);
+    QTest::newRow("argb32") << QImage::Format_ARGB32 << QSize(320, 240) << 64 << qreal(1);
+    QTest::newRow("rgb16") << QImage::Format_RGB16 << QSize(320, 240) << 64 << qreal(1);
+    QTest::newRow("rgb888") << QImage::Format_RGB888 << QSize(320, 240) << 60 << qreal(1);
+    QTest::newRow("a2rgb30pm") << QImage::Format_A2RGB30_Premultiplied << QSize(320, 240) << 64 << qreal(1);
+    QTest::newRow("grayscale8") << QImage::Format_Grayscale8 << QSize(320, 240) << 64 << qreal(1);
+    QTest::newRow("argb32pm, dpr 2") << QImage::Format_ARGB32_Premultiplied << QSize(640, 480) << 96 << qreal(2);
+}
+
+void tst_QTiledImagePaintDevice::identicalToSerial()
+{
+    QFETCH(QImage::Format, format);
+    QFETCH(QSize, imageSize);
+    QFETCH(int, tileHeight);
+    QFETCH(qreal, devicePixelRatio);
+
+    QImage image(imageSize, format);
+    image.fill(QColor(10, 20, 30, 40));
+    image.setDevicePixelRatio(devicePixelRatio);
+
+    const QImage serial = paintSerially(image);
+    const QImage tiled = paintTiled(image, tileHeight);
+    QCOMPARE(tiled.size(), serial.size());
+    QCOMPARE(tiled, serial);
+
+    // The tiles are handed out to whichever thread asks first; that must
+    // not change the result.
+    QCOMPARE(paintTiled(image, tileHeight), tiled);
+}
+
+void tst_QTiledImagePaintDevice::clippedToTiles()
+{
+    // A command is replayed once per tile that it touches, so blending
+    // must still only happen once per pixel.
+    QImage image(100, 100, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QTiledImagePaintDevice device(&image);
+    device.setTileHeight(16);
+    QPainter p(&device);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.setPen(QPen(QColor(0, 0, 255, 128), 9));
+    p.setBrush(QColor(255, 0, 0, 128));
+    p.drawEllipse(QRectF(10.5, 10.5, 80, 80));
+    p.end();
+
+    QImage expected(100, 100, QImage::Format_ARGB32_Premultiplied);
+    expected.fill(Qt::transparent);
+    QPainter q(&expected);
+    q.setRenderHint(QPainter::Antialiasing);
+    q.setPen(QPen(QColor(0, 0, 255, 128), 9));
+    q.setBrush(QColor(255, 0, 0, 128));
+    q.drawEllipse(QRectF(10.5, 10.5, 80, 80));
+    q.end();
+
+    QCOMPARE(image, expected);
+}
+
+void tst_QTiledImagePaintDevice::rotatedOutlines_data()
+{
+    QTest::addColumn<int>("scene");
+
+    QTest::newRow("rotated fills") << 0;
+    QTest::newRow("wide aliased lines") << 1;
+    QTest::newRow("wide antialiased lines") << 2;
+    QTest::newRow("rotated images and pixmaps") << 3;
+    QTest::newRow("scaled fractional rects") << 4;
+    QTest::newRow("wide points") << 5;
+}
+
+static void drawOutlines(QPainter *p, int scene)
+{
+    switch (scene) {
+    case 0:
+        p->translate(200, 150);
+        p->rotate(27);
+        for (bool antialiased : { true, false }) {
+            p->setRenderHint(QPainter::Antialiasing, antialiased);
+            p->setPen(QPen(Qt::black, 0));
+            p->setBrush(Qt::Dense4Pattern);
+            p->drawRect(QRectF(-100, -50, 200, 100));
+            p->setPen(Qt::NoPen);
+            p->setBrush(QColor(255, 0, 0, 120));
+            p->drawRect(QRectF(-60.3, -80.7, 90.2, 130.1));
+            p->fillRect(QRectF(-120.6, 20.3, 70.7, 40.2), QColor(0, 0, 255, 90));
+            p->rotate(31);
+        }
+        break;
+    case 1:
+        p->setPen(QPen(Qt::darkGreen, 3));
+        for (int i = 0; i < 40; ++i)
+            p->drawLine(i * 10, 0, 400 - i * 10, 300);
+        p->setPen(QPen(Qt::darkRed, 5.3, Qt::DashLine));
+        for (int i = 0; i < 40; ++i)
+            p->drawLine(QLineF(3.3 + i, i * 7.31, 390.2 - i, i * 7.31));
+        break;
+    case 2:
+        p->setRenderHint(QPainter::Antialiasing);
+        p->setPen(QPen(Qt::darkGreen, 3));
+        for (int i = 0; i < 40; ++i)
+            p->drawLine(i * 10, 0, 400 - i * 10, 300);
+        p->setPen(QPen(Qt::darkRed, 5.3));
+        for (int i = 0; i < 40; ++i)
+            p->drawLine(QLineF(3.3 + i, i * 7.31, 390.2 - i, i * 7.31));
+        break;
+    case 3: {
+        const QImage checker = checkerImage(32, QColor(255, 0, 0, 160), QColor(0, 0, 255, 220));
+        p->setRenderHint(QPainter::SmoothPixmapTransform);
+        p->translate(200, 100);
+        p->rotate(33);
+        p->scale(3.3, 2.7);
+        p->drawImage(QPointF(10.3, 5.7), checker);
+        p->drawPixmap(QPointF(-30.3, 5.7), QPixmap::fromImage(checker));
+        p->drawTiledPixmap(QRectF(-40, -30, 50, 30), QPixmap::fromImage(checker));
+        break;
+    }
+    case 4:
+        p->setRenderHint(QPainter::Antialiasing);
+        p->scale(1.37, 1.21);
+        p->setPen(Qt::NoPen);
+        for (int i = 0; i < 30; ++i) {
+            p->setBrush(QColor::fromHsv(i * 12, 200, 200, 150));
+            p->drawRect(QRectF(i * 9.3, i * 7.1, 50.7, 60.3));
+            p->fillRect(QRectF(i * 8.3 + 0.4, 200 - i * 6.1, 30.7, 40.3), QColor(0, 0, 255, 90));
+        }
+        break;
+    case 5:
+        p->translate(200, 150);
+        p->rotate(17);
+        p->scale(1.7, 1.3);
+        p->setPen(QPen(Qt::red, 4));
+        for (int i = 0; i < 300; ++i)
+            p->drawPoint(QPointF((i * 37) % 230 - 115.7, (i * 53) % 230 - 115.3));
+        break;
+    }
+}
+
+void tst_QTiledImagePaintDevice::rotatedOutlines()
+{
+    // The raster engine clips rotated rects, wide lines and transformed
+    // images against the device before rounding them; the result must still
+    // be the same as painting on the image directly.
+    QFETCH(int, scene);
+
+    QImage image(400, 300, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+
+    QImage tiled = image;
+    QTiledImagePaintDevice device(&tiled);
+    device.setTileHeight(37);
+    QPainter serialPainter(&image);
+    QPainter tiledPainter(&device);
+    for (QPainter *p : { &serialPainter, &tiledPainter }) {
+        drawOutlines(p, scene);
+        p->end();
+    }
+
+    QCOMPARE(tiled, image);
+}
+
+QTEST_MAIN(tst_QTiledImagePaintDevice)
+#include "tst_qtiledimagepaintdevice.moc"
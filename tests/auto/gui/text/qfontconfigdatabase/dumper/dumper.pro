@@ -0,0 +1,11 @@
+TEMPLATE = app
+
+TARGET = dumper
+QT = core gui
+
+DESTDIR = ./
+
+CONFIG -= app_bundle
+CONFIG += console
+
+SOURCES += main.cpp
@@ -0,0 +1,92 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+// Prints what QFontDatabase knows about every family, one line per family
+// and style, followed by how a few generic families resolve.
+
+#include <QtGui/QFontDatabase>
+#include <QtGui/QFontInfo>
+#include <QtGui/QGuiApplication>
+
+#include <stdio.h>
+
+static QString writingSystems(const QList<QFontDatabase::WritingSystem> &systems)
+{
+    QStringList names;
+    for (QFontDatabase::WritingSystem system : systems)
+        names.append(QString::number(system));
+    return names.join(QLatin1Char(' '));
+}
+
+static QString sizes(const QList<int> &sizes)
+{
+    QStringList names;
+    for (int size : sizes)
+        names.append(QString::number(size));
+    return names.join(QLatin1Char(' '));
+}
+
+int main(int argc, char **argv)
+{
+    QGuiApplication app(argc, argv);
+
+    QFontDatabase db;
+    QStringList lines;
+    lines.append(QLatin1String("writing systems: ") + writingSystems(db.writingSystems()));
+
+    const QStringList families = db.families();
+    for (const QString &family : families) {
+        lines.append(QString::fromLatin1("%1: fixed %2, scalable %3, smooth %4, private %5, writing systems %6")
+                     .arg(family)
+                     .arg(db.isFixedPitch(family))
+                     .arg(db.isScalable(family))
+                     .arg(db.isSmoothlyScalable(family))
+                     .arg(db.isPrivateFamily(family))
+                     .arg(writingSystems(db.writingSystems(family))));
+        const QStringList styles = db.styles(family);
+        for (const QString &style : styles) {
+            lines.append(QString::fromLatin1("%1, %2: weight %3, italic %4, bitmap %5, sizes %6")
+                         .arg(family, style)
+                         .arg(db.weight(family, style))
+                         .arg(db.italic(family, style))
+                         .arg(db.isBitmapScalable(family, style))
+                         .arg(sizes(db.smoothSizes(family, style))));
+        }
+    }
+
+    for (const char *family : { "Sans Serif", "Serif", "Monospace" }) {
+        const QFont font(QString::fromLatin1(family));
+        const QFontInfo info(font);
+        lines.append(QString::fromLatin1("%1 resolves to %2, %3").arg(QLatin1String(family), info.family(), info.styleName()));
+    }
+
+    for (const QString &line : qAsConst(lines))
+        printf("%s\n", line.toUtf8().constData());
+    return 0;
+}
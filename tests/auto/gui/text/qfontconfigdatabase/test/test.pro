@@ -0,0 +1,6 @@
+CONFIG += testcase
+TARGET = ../tst_qfontconfigdatabase
+QT = core gui testlib
+SOURCES = ../tst_qfontconfigdatabase.cpp
+
+TEST_HELPER_INSTALLS = ../dumper/dumper
@@ -0,0 +1,178 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QProcess>
+#include <QtCore/QTemporaryDir>
+
+// The fontconfig database caches the fonts that it registers in
+// $XDG_CACHE_HOME/qtfontconfig/fontdatabase.cache. The dumper helper prints
+// what QFontDatabase knows, which must be the same whether the database was
+// populated from fontconfig, while writing the cache, or from the cache.
+class tst_QFontconfigDatabase : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cache();
+    void damagedCache();
+
+private:
+    QStringList dump(const QString &cacheHome, bool useCache);
+    static QString cacheFileName(const QString &cacheHome);
+
+    QString dumperExe;
+    QStringList uncached;
+};
+
+QString tst_QFontconfigDatabase::cacheFileName(const QString &cacheHome)
+{
+    return cacheHome + QLatin1String("/qtfontconfig/fontdatabase.cache");
+}
+
+QStringList tst_QFontconfigDatabase::dump(const QString &cacheHome, bool useCache)
+{
+#if QT_CONFIG(process)
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert(QStringLiteral("XDG_CACHE_HOME"), cacheHome);
+    if (useCache)
+        environment.remove(QStringLiteral("QT_NO_FONTCONFIG_CACHE"));
+    else
+        environment.insert(QStringLiteral("QT_NO_FONTCONFIG_CACHE"), QStringLiteral("1"));
+
+    QProcess process;
+    process.setProcessEnvironment(environment);
+    process.setProcessChannelMode(QProcess::SeparateChannels);
+    process.setReadChannel(QProcess::StandardOutput);
+    process.start(dumperExe);
+    if (!process.waitForStarted()) {
+        qWarning("Could not start %s: %s", qPrintable(dumperExe), qPrintable(process.errorString()));
+        return QStringList();
+    }
+    if (!process.waitForFinished(60000) || process.exitStatus() != QProcess::NormalExit
+            || process.exitCode() != 0) {
+        qWarning("%s failed: %s", qPrintable(dumperExe), process.readAllStandardError().constData());
+        return QStringList();
+    }
+    return QString::fromUtf8(process.readAllStandardOutput()).split(QLatin1Char('\n'), QString::SkipEmptyParts);
+#else
+    Q_UNUSED(cacheHome);
+    Q_UNUSED(useCache);
+    return QStringList();
+#endif
+}
+
+void tst_QFontconfigDatabase::initTestCase()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+    const QString dumperDir = QFINDTESTDATA("dumper");
+    QVERIFY2(!dumperDir.isEmpty(), qPrintable(
+        QString::fromLatin1("Couldn't find helper app dir starting from %1.").arg(QDir::currentPath())));
+    dumperExe = dumperDir + QLatin1String("/dumper");
+
+    QTemporaryDir cacheHome;
+    QVERIFY(cacheHome.isValid());
+    uncached = dump(cacheHome.path(), false);
+    QVERIFY(!uncached.isEmpty());
+    QVERIFY(!QFile::exists(cacheFileName(cacheHome.path())));
+
+    // Find out whether the platform uses the fontconfig database at all.
+    QCOMPARE(dump(cacheHome.path(), true), uncached);
+    if (!QFile::exists(cacheFileName(cacheHome.path())))
+        QSKIP("The platform does not use the fontconfig database");
+#endif
+}
+
+void tst_QFontconfigDatabase::cache()
+{
+    QTemporaryDir cacheHome;
+    QVERIFY(cacheHome.isValid());
+    const QString fileName = cacheFileName(cacheHome.path());
+
+    // The first run populates the database from fontconfig and writes the
+    // cache, the second one reads it.
+    QCOMPARE(dump(cacheHome.path(), true), uncached);
+    QVERIFY(QFile::exists(fileName));
+    const QDateTime written = QFileInfo(fileName).lastModified();
+    QCOMPARE(dump(cacheHome.path(), true), uncached);
+    QCOMPARE(QFileInfo(fileName).lastModified(), written);
+}
+
+// Returns the offset of the font records in the cache file, which follow
+// the index of families and aliases.
+static qint64 recordsOffset(QFile *file)
+{
+    QDataStream stream(file);
+    stream.setVersion(QDataStream::Qt_5_10);
+
+    quint32 magic, version, count;
+    QByteArray fingerprint;
+    stream >> magic >> version >> fingerprint >> count;
+    for (quint32 i = 0; i < count; ++i) {
+        QString name;
+        quint32 offset, fontCount;
+        stream >> name >> offset >> fontCount;
+    }
+    stream >> count;
+    for (quint32 i = 0; i < count; ++i) {
+        QString family, alias;
+        stream >> family >> alias;
+    }
+    return stream.status() == QDataStream::Ok ? file->pos() : -1;
+}
+
+void tst_QFontconfigDatabase::damagedCache()
+{
+    QTemporaryDir cacheHome;
+    QVERIFY(cacheHome.isValid());
+    const QString fileName = cacheFileName(cacheHome.path());
+    QCOMPARE(dump(cacheHome.path(), true), uncached);
+
+    // Cut the font records off, but keep the index. The cache is still
+    // used, and every family is populated from fontconfig instead.
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    const qint64 offset = recordsOffset(&file);
+    QVERIFY(offset > 0);
+    QVERIFY(offset < file.size());
+    QVERIFY(file.resize(offset + 1));
+    file.close();
+
+    QCOMPARE(dump(cacheHome.path(), true), uncached);
+    QCOMPARE(QFileInfo(fileName).size(), offset + 1);
+}
+
+QTEST_MAIN(tst_QFontconfigDatabase)
+#include "tst_qfontconfigdatabase.moc"
@@ -0,0 +1,161 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+// Draws text with every combination of transformation, subpixel position
+// and synthesized style that the FreeType font engine renders differently,
+// and writes the raw pixels to the directory given as the first argument.
+// The second argument is the font file to use. Every scene is drawn twice,
+// on two new threads one after the other. Each thread has its own font
+// engines, so the second thread takes its glyphs from the shared glyph
+// cache, unless QT_FREETYPE_SHARED_GLYPH_CACHE_SIZE is 0.
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QThread>
+#include <QtGui/QFontDatabase>
+#include <QtGui/QGuiApplication>
+#include <QtGui/QImage>
+#include <QtGui/QPainter>
+
+#include <stdio.h>
+
+static const struct {
+    const char *name;
+    bool bold;
+    bool italic;
+} styles[] = {
+    { "regular", false, false },
+    { "embolden", true, false },
+    { "oblique", false, true },
+    { "embolden oblique", true, true }
+};
+
+static const struct {
+    const char *name;
+    QTransform transform;
+} transforms[] = {
+    { "untransformed", QTransform() },
+    { "scaled", QTransform::fromScale(1.7, 1.3) },
+    { "rotated", QTransform().rotate(17) },
+    { "sheared", QTransform().shear(0.3, 0.1) }
+};
+
+static const int ImageWidth = 480;
+static const int ImageHeight = 320;
+
+static QImage drawScene(const QString &family, int style, int transform)
+{
+    QImage image(ImageWidth, ImageHeight, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+
+    QPainter p(&image);
+    p.setPen(Qt::black);
+    p.setTransform(transforms[transform].transform);
+
+    qreal y = 14;
+    for (bool antialias : { true, false }) {
+        for (QFont::HintingPreference hinting : { QFont::PreferNoHinting, QFont::PreferFullHinting }) {
+            QFont font(family);
+            font.setPixelSize(13);
+            font.setBold(styles[style].bold);
+            font.setItalic(styles[style].italic);
+            font.setHintingPreference(hinting);
+            if (!antialias)
+                font.setStyleStrategy(QFont::NoAntialias);
+            p.setFont(font);
+
+            // Unhinted glyphs are rendered at four subpixel positions.
+            for (qreal offset : { 0.0, 0.25, 0.5, 0.75 }) {
+                p.drawText(QPointF(4 + offset, y),
+                           QStringLiteral("The quick brown fox jumps over the lazy dog 0123456789"));
+                y += 16;
+            }
+        }
+    }
+    p.end();
+    return image;
+}
+
+static bool writeImage(const QString &fileName, const QImage &image)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    QDataStream stream(&file);
+    stream << int(image.format()) << image.size()
+           << QByteArray::fromRawData(reinterpret_cast<const char *>(image.constBits()), image.sizeInBytes());
+    return stream.status() == QDataStream::Ok;
+}
+
+static bool drawScenes(const QDir &output, const QString &family, const char *pass)
+{
+    for (int style = 0; style < int(sizeof(styles) / sizeof(styles[0])); ++style) {
+        for (int transform = 0; transform < int(sizeof(transforms) / sizeof(transforms[0])); ++transform) {
+            const QString fileName = output.filePath(QString::fromLatin1("%1, %2, %3")
+                                                     .arg(QLatin1String(transforms[transform].name),
+                                                          QLatin1String(styles[style].name),
+                                                          QLatin1String(pass)));
+            if (!writeImage(fileName, drawScene(family, style, transform))) {
+                fprintf(stderr, "Cannot write %s\n", qPrintable(fileName));
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    QGuiApplication app(argc, argv);
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <output directory> <font file>\n", argv[0]);
+        return 1;
+    }
+    const QDir output(QString::fromLocal8Bit(argv[1]));
+
+    // Fonts added from memory are not shared, so add the file.
+    const int id = QFontDatabase::addApplicationFont(QString::fromLocal8Bit(argv[2]));
+    const QStringList families = QFontDatabase::applicationFontFamilies(id);
+    if (families.isEmpty()) {
+        fprintf(stderr, "Cannot load %s\n", argv[2]);
+        return 1;
+    }
+
+    for (const char *pass : { "first thread", "second thread" }) {
+        bool ok = false;
+        QThread *thread = QThread::create([&] { ok = drawScenes(output, families.first(), pass); });
+        thread->start();
+        thread->wait();
+        delete thread;
+        if (!ok)
+            return 1;
+    }
+    return 0;
+}
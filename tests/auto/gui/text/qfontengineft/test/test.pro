@@ -0,0 +1,7 @@
+CONFIG += testcase
+TARGET = ../tst_qfontengineft
+QT = core gui-private testlib
+SOURCES = ../tst_qfontengineft.cpp
+
+TESTDATA += ../../../../shared/resources/testfont.ttf
+TEST_HELPER_INSTALLS = ../renderer/renderer
@@ -0,0 +1,161 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QProcess>
+#include <QtCore/QTemporaryDir>
+#include <QtGui/QFontDatabase>
+#include <QtGui/QImage>
+#include <QtGui/private/qfont_p.h>
+#include <QtGui/private/qfontengine_p.h>
+
+// The size of the FreeType engine's shared glyph cache is read once per
+// process. The renderer helper is run with the cache disabled and with its
+// default size, and the text that it draws must come out the same.
+class tst_QFontEngineFT : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void sharedGlyphCache_data();
+    void sharedGlyphCache();
+
+private:
+    bool render(const QString &variant, const QByteArray &cacheSize);
+
+    QTemporaryDir outputDir;
+    QString rendererExe;
+    QString testFont;
+};
+
+static QImage readImage(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return QImage();
+    QDataStream stream(&file);
+    int format;
+    QSize size;
+    QByteArray bits;
+    stream >> format >> size >> bits;
+    if (stream.status() != QDataStream::Ok)
+        return QImage();
+    QImage image(size, QImage::Format(format));
+    if (image.sizeInBytes() != bits.size())
+        return QImage();
+    memcpy(image.bits(), bits.constData(), bits.size());
+    return image;
+}
+
+void tst_QFontEngineFT::initTestCase()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+    testFont = QFINDTESTDATA("../../../shared/resources/testfont.ttf");
+    QVERIFY(!testFont.isEmpty());
+
+    const int id = QFontDatabase::addApplicationFont(testFont);
+    QVERIFY(id >= 0);
+    QFont font(QFontDatabase::applicationFontFamilies(id).value(0));
+    QFontEngine *engine = QFontPrivate::get(font)->engineForScript(QChar::Script_Common);
+    QVERIFY(engine);
+    if (engine->type() == QFontEngine::Multi)
+        engine = static_cast<QFontEngineMulti *>(engine)->engine(0);
+    if (engine->type() != QFontEngine::Freetype)
+        QSKIP("The platform does not draw text with the FreeType font engine");
+
+    QVERIFY(outputDir.isValid());
+    const QString rendererDir = QFINDTESTDATA("renderer");
+    QVERIFY2(!rendererDir.isEmpty(), qPrintable(
+        QString::fromLatin1("Couldn't find helper app dir starting from %1.").arg(QDir::currentPath())));
+    rendererExe = rendererDir + QLatin1String("/renderer");
+
+    QVERIFY(render(QStringLiteral("uncached"), "0"));
+    QVERIFY(render(QStringLiteral("cached"), QByteArray()));
+#endif
+}
+
+bool tst_QFontEngineFT::render(const QString &variant, const QByteArray &cacheSize)
+{
+#if QT_CONFIG(process)
+    QDir dir(outputDir.path());
+    if (!dir.mkdir(variant))
+        return false;
+
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    if (cacheSize.isEmpty())
+        environment.remove(QStringLiteral("QT_FREETYPE_SHARED_GLYPH_CACHE_SIZE"));
+    else
+        environment.insert(QStringLiteral("QT_FREETYPE_SHARED_GLYPH_CACHE_SIZE"), QString::fromLatin1(cacheSize));
+
+    QProcess process;
+    process.setProcessEnvironment(environment);
+    process.setProcessChannelMode(QProcess::ForwardedChannels);
+    process.start(rendererExe, QStringList() << dir.filePath(variant) << testFont);
+    if (!process.waitForStarted()) {
+        qWarning("Could not start %s: %s", qPrintable(rendererExe), qPrintable(process.errorString()));
+        return false;
+    }
+    return process.waitForFinished(60000) && process.exitStatus() == QProcess::NormalExit
+            && process.exitCode() == 0;
+#else
+    Q_UNUSED(variant);
+    Q_UNUSED(cacheSize);
+    return false;
+#endif
+}
+
+void tst_QFontEngineFT::sharedGlyphCache_data()
+{
+    QTest::addColumn<QString>("scene");
+
+    const QStringList scenes = QDir(outputDir.path() + QLatin1String("/uncached")).entryList(QDir::Files);
+    QVERIFY(!scenes.isEmpty());
+    for (const QString &scene : scenes)
+        QTest::newRow(qPrintable(scene)) << scene;
+}
+
+void tst_QFontEngineFT::sharedGlyphCache()
+{
+    QFETCH(QString, scene);
+
+    const QImage uncached = readImage(outputDir.path() + QLatin1String("/uncached/") + scene);
+    const QImage cached = readImage(outputDir.path() + QLatin1String("/cached/") + scene);
+    QVERIFY(!uncached.isNull());
+    QVERIFY(!cached.isNull());
+    QCOMPARE(cached, uncached);
+}
+
+QTEST_MAIN(tst_QFontEngineFT)
+#include "tst_qfontengineft.moc"
@@ -58,6 +58,7 @@ private slots:
     void floatingTablePageBreak();
     void imageAtRightAlignedTab();
     void blockVisibility();
+    void layoutOnDemand();
 
 private:
     QTextDocument *doc;
@@ -344,5 +345,86 @@ void tst_QTextDocumentLayout::blockVisibility()
     QCOMPARE(doc->size(), halfSize);
 }
 
+static void compareBlockRects(QTextDocument *doc, QTextDocument *reference)
+{
+    QCOMPARE(doc->blockCount(), reference->blockCount());
+    for (int i = 0; i < doc->blockCount(); i += 37) {
+        const QTextBlock block = doc->findBlockByNumber(i);
+        const QTextBlock referenceBlock = reference->findBlockByNumber(i);
+        QCOMPARE(doc->documentLayout()->blockBoundingRect(block),
+                 reference->documentLayout()->blockBoundingRect(referenceBlock));
+    }
+}
+
+void tst_QTextDocumentLayout::layoutOnDemand()
+{
+    QString text;
+    for (int i = 0; i < 3000; ++i) {
+        text += QString::fromLatin1("Line %1").arg(i);
+        if (i % 7 == 0)
+            text += QString::fromLatin1(" with enough words in it to wrap onto more than one line");
+        text += QLatin1Char('\n');
+    }
+
+    QTextDocument reference;
+    reference.setTextWidth(300);
+    reference.setPlainText(text);
+
+    doc->documentLayout()->setProperty("layoutOnDemand", true);
+    doc->setTextWidth(300);
+    doc->setPlainText(text);
+
+    // the size is estimated without laying out the whole document
+    const QSizeF estimatedSize = doc->size();
+    QCOMPARE(estimatedSize.width(), reference.size().width());
+    QVERIFY(estimatedSize.height() > reference.size().height() / 2);
+    QVERIFY(estimatedSize.height() < reference.size().height() * 2);
+
+    QImage image(300, 200, QImage::Format_ARGB32_Premultiplied);
+    {
+        QPainter painter(&image);
+        QAbstractTextDocumentLayout::PaintContext context;
+        context.clip = QRectF(0, 0, 300, 200);
+        doc->documentLayout()->draw(&painter, context);
+    }
+
+    compareBlockRects(doc, &reference);
+    QCOMPARE(doc->size(), reference.size());
+
+    QTextCursor cursor(doc);
+    QTextCursor referenceCursor(&reference);
+    const auto edit = [&](int position, const QString &insert, int remove) {
+        for (QTextCursor *c : { &cursor, &referenceCursor }) {
+            c->setPosition(position);
+            c->setPosition(position + remove, QTextCursor::KeepAnchor);
+            c->insertText(insert);
+        }
+    };
+
+    const auto blockPosition = [&](int blockNumber) {
+        return doc->findBlockByNumber(blockNumber).position();
+    };
+
+    // edits only lay out the changed part of the document, and still know its size
+    edit(0, QString::fromLatin1("A new first line\n"), 0);
+    QCOMPARE(doc->size(), reference.size());
+    edit(blockPosition(10), QString::fromLatin1("x\ny\nz"), 3);
+    QCOMPARE(doc->size(), reference.size());
+    compareBlockRects(doc, &reference);
+
+    edit(blockPosition(1500), QString::fromLatin1("and a lot more text to make it wrap twice or even three times "), 0);
+    QCOMPARE(doc->size(), reference.size());
+    edit(blockPosition(700), QString(), blockPosition(705) - blockPosition(700));
+    QCOMPARE(doc->size(), reference.size());
+    compareBlockRects(doc, &reference);
+
+    // changes to the part that is not laid out yet are laid out when needed
+    edit(blockPosition(5), QString::fromLatin1("y"), 1);
+    edit(blockPosition(2500), QString::fromLatin1("Inserted line\n"), 0);
+    edit(doc->characterCount() - 1, QString::fromLatin1("\nThe end"), 0);
+    compareBlockRects(doc, &reference);
+    QCOMPARE(doc->size(), reference.size());
+}
+
 QTEST_MAIN(tst_QTextDocumentLayout)
 #include "tst_qtextdocumentlayout.moc"
@@ -37,6 +37,7 @@
 
 
 #include <private/qtextengine_p.h>
+#include <private/qtextshapingcache_p.h>
 #include <qtextlayout.h>
 
 #include <qdebug.h>
@@ -137,6 +138,8 @@ private slots:
     void nbspWithFormat();
     void noModificationOfInputString();
     void superscriptCrash_qtbug53911();
+    void shapingCache();
+    void shapingCacheEviction();
 
 private:
     QFont testFont;
@@ -2291,5 +2294,89 @@ void tst_QTextLayout::nbspWithFormat()
     QCOMPARE(layout.lineAt(1).textLength(), s2.length() + 1 + s3.length());
 }
 
+static QList<QGlyphRun> shapedGlyphRuns(const QString &text, qreal lineWidth)
+{
+    QTextLayout layout(text, QFont());
+    layout.setCacheEnabled(false);
+    layout.beginLayout();
+    qreal y = 0;
+    forever {
+        QTextLine line = layout.createLine();
+        if (!line.isValid())
+            break;
+        line.setLineWidth(lineWidth);
+        line.setPosition(QPointF(0, y));
+        y += line.height();
+    }
+    layout.endLayout();
+    return layout.glyphRuns();
+}
+
+void tst_QTextLayout::shapingCache()
+{
+    QTextShapingCache *cache = QTextShapingCache::instance();
+    QVERIFY(cache);
+    const int maxCost = cache->maxCost();
+
+    const QString text = QString::fromUtf8("Shaping Ø¹Ø±Ø¨Ù "
+                                           "Î±Î²Î³ office affluent ")
+            .repeated(4);
+
+    cache->setMaxCost(0);
+    const QList<QGlyphRun> uncached = shapedGlyphRuns(text, 120);
+
+    cache->setMaxCost(1024 * 1024);
+    cache->clear();
+    cache->resetStatistics();
+    const QList<QGlyphRun> first = shapedGlyphRuns(text, 120);
+    const QTextShapingCache::Statistics afterFirst = cache->statistics();
+    const QList<QGlyphRun> second = shapedGlyphRuns(text, 120);
+    const QTextShapingCache::Statistics afterSecond = cache->statistics();
+
+    cache->setMaxCost(maxCost);
+
+    QCOMPARE(first, uncached);
+    QCOMPARE(second, uncached);
+    QVERIFY(afterFirst.count > 0);
+    QVERIFY(afterSecond.hits > afterFirst.hits);
+    QCOMPARE(afterSecond.misses, afterFirst.misses);
+}
+
+void tst_QTextLayout::shapingCacheEviction()
+{
+    QTextShapingCache cache;
+    QTextShapingCacheEntry entry;
+    entry.glyphs.fill(1, 8);
+    entry.logClusters.fill(0, 8);
+
+    // the engines are only used as keys, never dereferenced
+    QTextShapingCacheKey first;
+    first.fontEngine = reinterpret_cast<QFontEngine *>(quintptr(0x1000));
+    first.text = QStringLiteral("first");
+    QTextShapingCacheKey second = first;
+    second.fontEngine = reinterpret_cast<QFontEngine *>(quintptr(0x2000));
+
+    cache.setMaxCost(1024 * 1024);
+    cache.insert(first, entry);
+    cache.insert(second, entry);
+    QCOMPARE(cache.statistics().fontEngineCount, 2);
+
+    // replacing an entry keeps its engine
+    cache.insert(first, entry);
+    QCOMPARE(cache.statistics().fontEngineCount, 2);
+
+    // evicting the last entry of an engine forgets the engine
+    cache.setMaxCost(cache.statistics().totalCost / 2);
+    QCOMPARE(cache.statistics().count, 1);
+    QCOMPARE(cache.statistics().fontEngineCount, 1);
+    QTextShapingCacheEntry found;
+    QVERIFY(cache.find(first, &found));
+    QVERIFY(!cache.find(second, &found));
+
+    cache.removeFontEngine(first.fontEngine);
+    QCOMPARE(cache.statistics().count, 0);
+    QCOMPARE(cache.statistics().fontEngineCount, 0);
+}
+
 QTEST_MAIN(tst_QTextLayout)
 #include "tst_qtextlayout.moc"
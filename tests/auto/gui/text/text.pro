@@ -4,7 +4,9 @@ SUBDIRS=\
    qcssparser \
    qfont \
    qfontcache \
+   qfontconfigdatabase \
    qfontdatabase \
+   qfontengineft \
    qfontmetrics \
    qglyphrun \
    qrawfont \
@@ -30,6 +32,7 @@ win32:SUBDIRS -= qtextpiecetable
 
 !qtConfig(private_tests): SUBDIRS -= \
            qfontcache \
+           qfontengineft \
            qcssparser \
            qtextlayout \
            qtextpiecetable \
@@ -47,6 +47,8 @@ private slots:
     void setCookiesFromUrl();
     void cookiesForUrl_data();
     void cookiesForUrl();
+    void insertDeleteCookie();
+    void expiredCookiesRemoved();
 #ifdef QT_BUILD_INTERNAL
     void effectiveTLDs_data();
     void effectiveTLDs();
@@ -366,6 +368,88 @@ void tst_QNetworkCookieJar::cookiesForUrl()
     QCOMPARE(result, expectedResult);
 }
 
+class CookieEditor: public MyCookieJar
+{
+public:
+    using QNetworkCookieJar::insertCookie;
+    using QNetworkCookieJar::updateCookie;
+    using QNetworkCookieJar::deleteCookie;
+};
+
+static QNetworkCookie makeCookie(const QByteArray &name, const QString &domain, const QString &path,
+                                 const QByteArray &value = QByteArray())
+{
+    QNetworkCookie cookie(name, value);
+    cookie.setDomain(domain);
+    cookie.setPath(path);
+    return cookie;
+}
+
+void tst_QNetworkCookieJar::insertDeleteCookie()
+{
+    CookieEditor jar;
+    const QNetworkCookie a = makeCookie("a", ".example.com", "/");
+    const QNetworkCookie b = makeCookie("b", "www.example.com", "/dir");
+    const QNetworkCookie c = makeCookie("c", "qt-project.org", "/");
+    const QNetworkCookie d = makeCookie("d", ".example.com", "/dir");
+
+    QVERIFY(jar.insertCookie(a));
+    QVERIFY(jar.insertCookie(b));
+    QVERIFY(jar.insertCookie(c));
+    QVERIFY(jar.insertCookie(d));
+    QCOMPARE(jar.allCookies(), QList<QNetworkCookie>() << a << b << c << d);
+
+    // deleting keeps the insertion order of the others
+    QVERIFY(jar.deleteCookie(b));
+    QVERIFY(!jar.deleteCookie(b));
+    QVERIFY(!jar.deleteCookie(makeCookie("a", ".example.com", "/dir")));
+    QCOMPARE(jar.allCookies(), QList<QNetworkCookie>() << a << c << d);
+    QCOMPARE(jar.cookiesForUrl(QUrl("http://www.example.com/dir")),
+             QList<QNetworkCookie>() << d << a);
+
+    // replacing a cookie moves it to the end
+    const QNetworkCookie newA = makeCookie("a", ".example.com", "/", "new");
+    QVERIFY(jar.updateCookie(newA));
+    QVERIFY(!jar.updateCookie(b));
+    QCOMPARE(jar.allCookies(), QList<QNetworkCookie>() << c << d << newA);
+    QVERIFY(jar.insertCookie(b));
+    QCOMPARE(jar.allCookies(), QList<QNetworkCookie>() << c << d << newA << b);
+
+    QVERIFY(jar.deleteCookie(c));
+    QVERIFY(jar.deleteCookie(d));
+    QVERIFY(jar.deleteCookie(newA));
+    QVERIFY(jar.deleteCookie(b));
+    QVERIFY(jar.allCookies().isEmpty());
+    QVERIFY(jar.cookiesForUrl(QUrl("http://www.example.com/dir")).isEmpty());
+}
+
+void tst_QNetworkCookieJar::expiredCookiesRemoved()
+{
+    MyCookieJar jar;
+    QNetworkCookie expired = makeCookie("expired", ".example.com", "/");
+    expired.setExpirationDate(QDateTime::currentDateTimeUtc().addDays(-1));
+    QNetworkCookie valid = makeCookie("valid", ".example.com", "/");
+    valid.setExpirationDate(QDateTime::currentDateTimeUtc().addDays(1));
+    const QNetworkCookie session = makeCookie("session", ".example.com", "/");
+    const QNetworkCookie other = makeCookie("other", "qt-project.org", "/");
+    QNetworkCookie otherExpired = makeCookie("expired", "qt-project.org", "/");
+    otherExpired.setExpirationDate(expired.expirationDate());
+
+    const QList<QNetworkCookie> all = QList<QNetworkCookie>()
+            << expired << valid << other << session << otherExpired;
+    jar.setAllCookies(all);
+    QCOMPARE(jar.allCookies(), all);
+
+    // looking up a host drops the expired cookies found on the way,
+    // cookies of other hosts are left alone
+    QCOMPARE(jar.cookiesForUrl(QUrl("http://www.example.com/")),
+             QList<QNetworkCookie>() << valid << session);
+    QCOMPARE(jar.allCookies(), QList<QNetworkCookie>() << valid << other << session << otherExpired);
+
+    QCOMPARE(jar.cookiesForUrl(QUrl("http://qt-project.org/")), QList<QNetworkCookie>() << other);
+    QCOMPARE(jar.allCookies(), QList<QNetworkCookie>() << valid << other << session);
+}
+
 // This test requires private API.
 #ifdef QT_BUILD_INTERNAL
 void tst_QNetworkCookieJar::effectiveTLDs_data()
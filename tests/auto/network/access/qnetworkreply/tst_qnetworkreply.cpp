@@ -299,6 +299,11 @@ private Q_SLOTS:
     void ioGetFromHttpStatus100();
     void ioGetFromHttpNoHeaders_data();
     void ioGetFromHttpNoHeaders();
+    void ioGetFromHttpToTargetDevice_data();
+    void ioGetFromHttpToTargetDevice();
+    void ioGetFromHttpToTargetDeviceWriteError_data();
+    void ioGetFromHttpToTargetDeviceWriteError();
+    void ioGetFromHttpToTargetDeviceNotWritable();
     void ioGetFromHttpWithCache_data();
     void ioGetFromHttpWithCache();
 
@@ -321,6 +326,8 @@ private Q_SLOTS:
     void ioPutToHttpFromFile();
     void ioPostToHttpFromFile_data();
     void ioPostToHttpFromFile();
+    void ioPostToHttpFromFileRange_data();
+    void ioPostToHttpFromFileRange();
 #ifndef QT_NO_NETWORKPROXY
     void ioPostToHttpFromSocket_data();
     void ioPostToHttpFromSocket();
@@ -418,6 +425,10 @@ private Q_SLOTS:
     void ioGetFromHttpBrokenChunkedEncoding();
     void qtbug12908compressedHttpReply();
     void compressedHttpReplyBrokenGzip();
+    void compressedHttpReply_data();
+    void compressedHttpReply();
+    void acceptEncodingHeader_data();
+    void acceptEncodingHeader();
 
     void getFromUnreachableIp();
 
@@ -3816,6 +3827,160 @@ void tst_QNetworkReply::ioGetFromHttpNoHeaders()
     QCOMPARE(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 200);
 }
 
+// Accepts at most maximumWrite bytes per write(), or fails every write if it is negative
+class TargetDevice : public QIODevice
+{
+public:
+    explicit TargetDevice(qint64 maximumWrite = std::numeric_limits<qint64>::max())
+        : writeCount(0), maximumWrite(maximumWrite)
+    {
+        open(QIODevice::WriteOnly);
+    }
+
+    QByteArray written;
+    int writeCount;
+
+protected:
+    qint64 readData(char *, qint64) override { return -1; }
+    qint64 writeData(const char *data, qint64 len) override
+    {
+        ++writeCount;
+        if (maximumWrite < 0) {
+            setErrorString(QStringLiteral("Disk full"));
+            return -1;
+        }
+        len = qMin(len, maximumWrite);
+        written.append(data, int(len));
+        return len;
+    }
+
+private:
+    qint64 maximumWrite;
+};
+
+static QByteArray patternData(int size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i)
+        data[i] = char((i * 7) ^ (i >> 11));
+    return data;
+}
+
+static QByteArray chunkedResponse(const QByteArray &body, int chunkSize)
+{
+    QByteArray response = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n";
+    for (int pos = 0; pos < body.size(); pos += chunkSize) {
+        const QByteArray chunk = body.mid(pos, chunkSize);
+        response += QByteArray::number(chunk.size(), 16) + "\r\n" + chunk + "\r\n";
+    }
+    return response + "0\r\n\r\n";
+}
+
+void tst_QNetworkReply::ioGetFromHttpToTargetDevice_data()
+{
+    QTest::addColumn<QByteArray>("dataToSend");
+    QTest::addColumn<QByteArray>("body");
+
+    const QByteArray small = "Hello, world";
+    QTest::newRow("small") << QByteArray("HTTP/1.0 200 OK\r\nContent-Length: 12\r\n\r\n" + small) << small;
+    QTest::newRow("empty") << QByteArray("HTTP/1.0 200 OK\r\nContent-Length: 0\r\n\r\n") << QByteArray();
+    QTest::newRow("no-content-length") << QByteArray("HTTP/1.0 200 OK\r\n\r\n" + small) << small;
+
+    const QByteArray large = patternData(3 * 1024 * 1024 + 17);
+    QTest::newRow("large") << QByteArray("HTTP/1.0 200 OK\r\nContent-Length: "
+                                         + QByteArray::number(large.size()) + "\r\n\r\n" + large)
+                           << large;
+    QTest::newRow("chunked") << chunkedResponse(large, 1000) << large;
+}
+
+// The body must end up in the target device, written in pieces as it
+// arrives, and never in the reply.
+void tst_QNetworkReply::ioGetFromHttpToTargetDevice()
+{
+    QFETCH(QByteArray, dataToSend);
+    QFETCH(QByteArray, body);
+    MiniHttpServer server(dataToSend);
+    server.doClose = true;
+
+    TargetDevice target;
+
+    QNetworkRequest request(QUrl("http://localhost:" + QString::number(server.serverPort())));
+    request.setAttribute(QNetworkRequest::DownloadTargetDeviceAttribute,
+                         QVariant::fromValue<QObject *>(&target));
+    QNetworkReplyPtr reply(manager.get(request));
+    QSignalSpy readyRead(reply.data(), SIGNAL(readyRead()));
+    QSignalSpy progress(reply.data(), SIGNAL(downloadProgress(qint64,qint64)));
+
+    QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 200);
+    QCOMPARE(target.written.size(), body.size());
+    QVERIFY(target.written == body);
+    QCOMPARE(reply->bytesAvailable(), qint64(0));
+    QVERIFY(reply->readAll().isEmpty());
+    QCOMPARE(readyRead.count(), 0);
+    QVERIFY(!progress.isEmpty());
+    QCOMPARE(progress.last().at(0).toLongLong(), qint64(body.size()));
+    if (body.size() > 1024 * 1024)
+        QVERIFY(target.writeCount > 1);
+}
+
+void tst_QNetworkReply::ioGetFromHttpToTargetDeviceWriteError_data()
+{
+    QTest::addColumn<qint64>("maximumWrite");
+
+    QTest::newRow("partial-write") << qint64(100);
+    QTest::newRow("failed-write") << qint64(-1);
+}
+
+// A target device that does not take all of the data aborts the download
+void tst_QNetworkReply::ioGetFromHttpToTargetDeviceWriteError()
+{
+    QFETCH(qint64, maximumWrite);
+    const QByteArray body = patternData(64 * 1024);
+    MiniHttpServer server("HTTP/1.0 200 OK\r\nContent-Length: " + QByteArray::number(body.size())
+                          + "\r\n\r\n" + body);
+    server.doClose = true;
+
+    TargetDevice target(maximumWrite);
+    QNetworkRequest request(QUrl("http://localhost:" + QString::number(server.serverPort())));
+    request.setAttribute(QNetworkRequest::DownloadTargetDeviceAttribute,
+                         QVariant::fromValue<QObject *>(&target));
+    QNetworkReplyPtr reply(manager.get(request));
+    QSignalSpy errorSpy(reply.data(), SIGNAL(error(QNetworkReply::NetworkError)));
+
+    QCOMPARE(waitForFinish(reply), int(Failure));
+    QVERIFY(reply->isFinished());
+    QCOMPARE(reply->error(), QNetworkReply::UnknownContentError);
+    QCOMPARE(errorSpy.count(), 1);
+    if (maximumWrite < 0)
+        QVERIFY(reply->errorString().contains(QLatin1String("Disk full")));
+    QVERIFY(target.written.size() < body.size());
+    QVERIFY(body.startsWith(target.written));
+}
+
+// A device that cannot be written to is ignored, the reply buffers the body as usual
+void tst_QNetworkReply::ioGetFromHttpToTargetDeviceNotWritable()
+{
+    const QByteArray body = "Hello, world";
+    MiniHttpServer server("HTTP/1.0 200 OK\r\nContent-Length: 12\r\n\r\n" + body);
+    server.doClose = true;
+
+    QByteArray targetData;
+    QBuffer target(&targetData);
+    QVERIFY(target.open(QIODevice::ReadOnly));
+    QNetworkRequest request(QUrl("http://localhost:" + QString::number(server.serverPort())));
+    request.setAttribute(QNetworkRequest::DownloadTargetDeviceAttribute,
+                         QVariant::fromValue<QObject *>(&target));
+    QTest::ignoreMessage(QtWarningMsg, "QNetworkReply: the download target device is not open for writing");
+    QNetworkReplyPtr reply(manager.get(request));
+
+    QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+    QCOMPARE(reply->readAll(), body);
+    QVERIFY(targetData.isEmpty());
+}
+
 void tst_QNetworkReply::ioGetFromHttpWithCache_data()
 {
     qRegisterMetaType<MyMemoryCache::CachedContent>();
@@ -4544,6 +4709,68 @@ void tst_QNetworkReply::ioPostToHttpFromFile()
     QCOMPARE(reply->readAll().trimmed(), md5sum(sourceFile.readAll()).toHex());
 }
 
+void tst_QNetworkReply::ioPostToHttpFromFileRange_data()
+{
+    QTest::addColumn<qint64>("offset");
+    QTest::addColumn<qint64>("size");
+    QTest::addColumn<bool>("buffered");
+
+    // large enough to fill the socket buffers on the way
+    const qint64 fileSize = 8 * 1024 * 1024 + 123;
+    QTest::newRow("whole-file") << qint64(0) << fileSize << false;
+    QTest::newRow("offset") << qint64(4097) << fileSize - 4097 << false;
+    QTest::newRow("offset-and-size") << qint64(100000) << qint64(5 * 1024 * 1024) << false;
+    QTest::newRow("small") << qint64(10) << qint64(1000) << false;
+    QTest::newRow("buffered") << qint64(4097) << qint64(1024 * 1024) << true;
+}
+
+// Uploads a range of a file, starting at the current position of the file
+// and as long as the Content-Length header says. Unbuffered uploads of a
+// local file are sent with sendfile() where that is available.
+void tst_QNetworkReply::ioPostToHttpFromFileRange()
+{
+    QFETCH(qint64, offset);
+    QFETCH(qint64, size);
+    QFETCH(bool, buffered);
+
+    const QByteArray contents = patternData(8 * 1024 * 1024 + 123);
+    QTemporaryFile sourceFile;
+    QVERIFY(sourceFile.open());
+    QCOMPARE(sourceFile.write(contents), qint64(contents.size()));
+    QVERIFY(sourceFile.flush());
+    QVERIFY(sourceFile.seek(offset));
+
+    MiniHttpServer server("HTTP/1.0 200 OK\r\nContent-Length: 0\r\n\r\n");
+    server.doClose = true;
+
+    QNetworkRequest request(QUrl("http://localhost:" + QString::number(server.serverPort())));
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/octet-stream");
+    request.setHeader(QNetworkRequest::ContentLengthHeader, size);
+    if (!buffered)
+        request.setAttribute(QNetworkRequest::DoNotBufferUploadDataAttribute, true);
+    QNetworkReplyPtr reply(manager.post(request, &sourceFile));
+    QSignalSpy uploadProgress(reply.data(), SIGNAL(uploadProgress(qint64,qint64)));
+
+    QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+
+    const int headerEnd = server.receivedData.indexOf("\r\n\r\n") + 4;
+    QVERIFY(headerEnd > 4);
+    const QByteArray received = server.receivedData.mid(headerEnd);
+    QCOMPARE(received.size(), int(size));
+    QVERIFY(received == contents.mid(int(offset), int(size)));
+    // Progress is throttled and its total is what the device had left to read,
+    // so only check that it never goes back nor past the range. The reply
+    // reports (0, 0) once the upload is done.
+    QVERIFY(!uploadProgress.isEmpty());
+    qint64 sent = 0;
+    for (int i = 0; i < uploadProgress.count() - 1; ++i) {
+        QVERIFY(uploadProgress.at(i).at(0).toLongLong() >= sent);
+        sent = uploadProgress.at(i).at(0).toLongLong();
+    }
+    QVERIFY(sent <= size);
+}
+
 #ifndef QT_NO_NETWORKPROXY
 void tst_QNetworkReply::ioPostToHttpFromSocket_data()
 {
@@ -6765,6 +6992,136 @@ void tst_QNetworkReply::compressedHttpReplyBrokenGzip()
     QCOMPARE(reply->error(), QNetworkReply::ProtocolFailure);
 }
 
+static QByteArray encodedReplyBody()
+{
+    QByteArray body;
+    for (int i = 0; i < 100; ++i)
+        body += "line " + QByteArray::number(i) + " of the decoded body\n";
+    return body;
+}
+
+void tst_QNetworkReply::compressedHttpReply_data()
+{
+    QTest::addColumn<QByteArray>("encoding");
+    QTest::addColumn<QByteArray>("encodedBody");
+
+#if QT_CONFIG(brotli)
+    // python3 -c "print(''.join('line %d of the decoded body\n' % i for i in range(100)), end='')" | brotli -q 11 | base64 -w 0
+    QTest::newRow("br") << QByteArray("br") << QByteArray::fromBase64(
+        "G+UKAIyUqeObioekA2xej/lSAaSMQnYA0OEjpdk8tCGHbF2+JLj6X71rmr/Mr/0wAolCY7BxcPHWmGSLKFVqjbaOLl5lKZQq"
+        "tUZbRxevqhRKlVqjraOLV10KpUqt0dbRxasphVKl1mjr6OLVLoVSpdZo6+ji1SmFUqXWaOvo4tUthVKl1mjr6OLVK4VSpdZo"
+        "6+ieDw==");
+#endif
+#if QT_CONFIG(zstd)
+    // python3 -c "print(''.join('line %d of the decoded body\n' % i for i in range(100)), end='')" | zstd -19 | base64 -w 0
+    QTest::newRow("zstd") << QByteArray("zstd") << QByteArray::fromBase64(
+        "KLUv/QRoNQQAcggXEbA759tCcHzDyKakpASCI3MJ4715NVGM8d68mih+vDevJgof782riaLHe/NqouDx3ryaKHa8N68mCh3v"
+        "zauJIsd782qiwPHevJoInmkkmGNaOSac5AJqQYTD1ApkqBGgX/834OcRJAT/CsEsPzOQ4jKR3kykNxPpjfhBY4x3RuxAqgIb"
+        "/2yL");
+#endif
+#if !QT_CONFIG(brotli) && !QT_CONFIG(zstd)
+    QSKIP("Neither brotli nor zstd decoding is built in");
+#endif
+}
+
+// Decodes the body, and fails for corrupt data like compressedHttpReplyBrokenGzip.
+// A truncated body is not an error, as for gzip, but must not decode to anything
+// that is not in the original.
+void tst_QNetworkReply::compressedHttpReply()
+{
+    QFETCH(QByteArray, encoding);
+    QFETCH(QByteArray, encodedBody);
+    const QByteArray body = encodedReplyBody();
+
+    const auto get = [this, &encoding](const QByteArray &data) {
+        MiniHttpServer *server = new MiniHttpServer("HTTP/1.0 200 OK\r\nContent-Encoding: " + encoding
+                                                    + "\r\nContent-Length: " + QByteArray::number(data.size())
+                                                    + "\r\n\r\n" + data);
+        server->doClose = true;
+        QNetworkRequest request(QUrl("http://localhost:" + QString::number(server->serverPort())));
+        QNetworkReply *reply = manager.get(request);
+        server->setParent(reply);
+        return reply;
+    };
+
+    QNetworkReplyPtr reply(get(encodedBody));
+    QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->rawHeader("Content-Encoding"), encoding);
+    QCOMPARE(reply->readAll(), body);
+
+    QByteArray corrupt = encodedBody;
+    corrupt[10] = corrupt.at(10) ^ 0xff;
+    reply.reset(get(corrupt));
+    QCOMPARE(waitForFinish(reply), int(Failure));
+    QCOMPARE(reply->error(), QNetworkReply::ProtocolFailure);
+
+    reply.reset(get(encodedBody.left(encodedBody.size() / 2)));
+    QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    const QByteArray truncated = reply->readAll();
+    QVERIFY(truncated.size() < body.size());
+    QVERIFY(body.startsWith(truncated));
+}
+
+void tst_QNetworkReply::acceptEncodingHeader_data()
+{
+    QTest::addColumn<QByteArray>("requestHeader");
+    QTest::addColumn<QByteArray>("sentHeader");
+    QTest::addColumn<bool>("decoded");
+
+    QByteArray builtIn;
+#ifndef QT_NO_COMPRESS
+    builtIn = "gzip, deflate";
+#endif
+#if QT_CONFIG(brotli)
+    builtIn += builtIn.isEmpty() ? "br" : ", br";
+#endif
+#if QT_CONFIG(zstd)
+    builtIn += builtIn.isEmpty() ? "zstd" : ", zstd";
+#endif
+    QTest::newRow("default") << QByteArray() << builtIn << !builtIn.isEmpty();
+    QTest::newRow("set-by-application") << QByteArray("gzip") << QByteArray("gzip") << false;
+}
+
+// Unless the application sets its own, the request announces every built-in
+// decoder, and the reply is decoded only then.
+void tst_QNetworkReply::acceptEncodingHeader()
+{
+    QFETCH(QByteArray, requestHeader);
+    QFETCH(QByteArray, sentHeader);
+    QFETCH(bool, decoded);
+
+    // printf 'Hello, world\n' | gzip -9 -n | base64 -w 0
+    const QByteArray encodedBody = QByteArray::fromBase64("H4sIAAAAAAACA/NIzcnJ11Eozy/KSeECAKY/WkcNAAAA");
+    MiniHttpServer server("HTTP/1.0 200 OK\r\nContent-Encoding: gzip\r\nContent-Length: "
+                          + QByteArray::number(encodedBody.size()) + "\r\n\r\n" + encodedBody);
+    server.doClose = true;
+
+    QNetworkRequest request(QUrl("http://localhost:" + QString::number(server.serverPort())));
+    if (!requestHeader.isEmpty())
+        request.setRawHeader("Accept-Encoding", requestHeader);
+    QNetworkReplyPtr reply(manager.get(request));
+    QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+
+    const QByteArray receivedHeaders = server.receivedData.left(server.receivedData.indexOf("\r\n\r\n"));
+    QByteArray acceptEncoding;
+    const QList<QByteArray> lines = receivedHeaders.split('\n');
+    for (const QByteArray &line : lines) {
+        if (line.toLower().startsWith("accept-encoding:")) {
+            QVERIFY2(acceptEncoding.isEmpty(), "Accept-Encoding sent more than once");
+            acceptEncoding = line.mid(int(qstrlen("accept-encoding:"))).trimmed();
+        }
+    }
+    QCOMPARE(acceptEncoding, sentHeader);
+
+    const QByteArray body = reply->readAll();
+    if (decoded)
+        QCOMPARE(body, QByteArray("Hello, world\n"));
+    else
+        QCOMPARE(body, encodedBody);
+}
+
 // TODO add similar test for FTP
 void tst_QNetworkReply::getFromUnreachableIp()
 {
@@ -34,6 +34,7 @@
 #include <qdatastream.h>
 #include <QtNetwork/qlocalsocket.h>
 #include <QtNetwork/qlocalserver.h>
+#include <QtNetwork/qlocalsharedbuffer.h>
 
 #ifdef Q_OS_UNIX
 #include <sys/types.h>
@@ -41,6 +42,10 @@
 #include <sys/un.h>
 #include <unistd.h> // for unlink()
 #endif
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <sys/syscall.h>
+#endif
 
 Q_DECLARE_METATYPE(QLocalSocket::LocalSocketError)
 Q_DECLARE_METATYPE(QLocalSocket::LocalSocketState)
@@ -116,6 +121,9 @@ private slots:
     void verifyListenWithDescriptor();
     void verifyListenWithDescriptor_data();
 
+    void passFileDescriptors();
+    void sharedBuffer();
+    void sharedBufferUnsealed();
 };
 
 tst_QLocalSocket::tst_QLocalSocket()
@@ -1405,6 +1413,160 @@ void tst_QLocalSocket::verifyListenWithDescriptor_data()
 
 }
 
+void tst_QLocalSocket::passFileDescriptors()
+{
+#if !defined(Q_OS_UNIX) || defined(QT_LOCALSOCKET_TCP)
+    QSKIP("Passing file descriptors is only supported with local domain sockets");
+#else
+    const QString name = QStringLiteral("tst_passFileDescriptors");
+    LocalServer server;
+    QVERIFY(server.listen(name));
+    LocalSocket socket;
+    QVERIFY(!socket.writeFileDescriptor(0));
+    QCOMPARE(socket.error(), QLocalSocket::OperationError);
+
+    socket.connectToServer(name);
+    QVERIFY(socket.waitForConnected(3000));
+    QVERIFY(server.waitForNewConnection(3000));
+    QLocalSocket *serverSocket = server.nextPendingConnection();
+    QVERIFY(serverSocket);
+    QVERIFY(!serverSocket->hasPendingFileDescriptors());
+    QCOMPARE(serverSocket->readFileDescriptor(), qintptr(-1));
+
+    int first[2];
+    int second[2];
+    QVERIFY(::pipe(first) == 0);
+    QVERIFY(::pipe(second) == 0);
+
+    // the descriptors travel with "b" and "c" respectively; the socket
+    // keeps its own copies, so ours can be closed right away
+    socket.write("a");
+    QVERIFY(socket.writeFileDescriptor(first[0]));
+    socket.write("b");
+    QVERIFY(socket.writeFileDescriptor(second[0]));
+    socket.write("c");
+    ::close(first[0]);
+    ::close(second[0]);
+    QVERIFY(socket.waitForBytesWritten(3000));
+
+    QByteArray received;
+    while (received.size() < 3 && serverSocket->waitForReadyRead(3000))
+        received += serverSocket->readAll();
+    QCOMPARE(received, QByteArray("abc"));
+    QVERIFY(serverSocket->hasPendingFileDescriptors());
+
+    const int firstReceived = int(serverSocket->readFileDescriptor());
+    const int secondReceived = int(serverSocket->readFileDescriptor());
+    QVERIFY(firstReceived != -1);
+    QVERIFY(secondReceived != -1);
+    QVERIFY(!serverSocket->hasPendingFileDescriptors());
+    QCOMPARE(serverSocket->readFileDescriptor(), qintptr(-1));
+
+    // the received descriptors refer to the pipes we still write to
+    char buffer[8];
+    QCOMPARE(::write(first[1], "one", 3), ssize_t(3));
+    QCOMPARE(::write(second[1], "two", 3), ssize_t(3));
+    QCOMPARE(::read(firstReceived, buffer, sizeof buffer), ssize_t(3));
+    QCOMPARE(QByteArray(buffer, 3), QByteArray("one"));
+    QCOMPARE(::read(secondReceived, buffer, sizeof buffer), ssize_t(3));
+    QCOMPARE(QByteArray(buffer, 3), QByteArray("two"));
+
+    ::close(first[1]);
+    ::close(second[1]);
+    ::close(firstReceived);
+    ::close(secondReceived);
+#endif
+}
+
+void tst_QLocalSocket::sharedBuffer()
+{
+#if !defined(Q_OS_UNIX) || defined(QT_LOCALSOCKET_TCP)
+    QSKIP("Shared buffers are only supported with local domain sockets");
+#else
+    QLocalSharedBuffer empty;
+    QVERIFY(!empty.isAttached());
+    QVERIFY(!empty.create(0));
+    QVERIFY(!empty.errorString().isEmpty());
+    QVERIFY(!empty.attach(-1));
+    QCOMPARE(empty.fileDescriptor(), qintptr(-1));
+    QVERIFY(!empty.data());
+
+    const QString name = QStringLiteral("tst_sharedBuffer");
+    LocalServer server;
+    QVERIFY(server.listen(name));
+    LocalSocket socket;
+    socket.connectToServer(name);
+    QVERIFY(socket.waitForConnected(3000));
+    QVERIFY(server.waitForNewConnection(3000));
+    QLocalSocket *serverSocket = server.nextPendingConnection();
+    QVERIFY(serverSocket);
+
+    const qint64 size = 1024 * 1024 + 3;
+    QLocalSharedBuffer buffer;
+    QVERIFY2(buffer.create(size), qPrintable(buffer.errorString()));
+    QVERIFY(buffer.isAttached());
+    QCOMPARE(buffer.size(), size);
+    uchar *data = static_cast<uchar *>(buffer.data());
+    for (qint64 i = 0; i < size; ++i)
+        data[i] = uchar(i * 7);
+
+    QVERIFY(socket.writeFileDescriptor(buffer.fileDescriptor()));
+    socket.write("frame");
+    QVERIFY(socket.waitForBytesWritten(3000));
+
+    QByteArray received;
+    while (received.size() < 5 && serverSocket->waitForReadyRead(3000))
+        received += serverSocket->readAll();
+    QCOMPARE(received, QByteArray("frame"));
+
+    QLocalSharedBuffer attached;
+    QVERIFY2(attached.attach(serverSocket->readFileDescriptor(), QLocalSharedBuffer::ReadOnly),
+             qPrintable(attached.errorString()));
+    QCOMPARE(attached.size(), size);
+    QVERIFY(memcmp(attached.constData(), buffer.constData(), size) == 0);
+
+    // both sides map the same memory
+    data[size - 1] = 0x5a;
+    QCOMPARE(static_cast<const uchar *>(attached.constData())[size - 1], uchar(0x5a));
+
+    attached.detach();
+    QVERIFY(!attached.isAttached());
+    QCOMPARE(attached.size(), qint64(0));
+#endif
+}
+
+void tst_QLocalSocket::sharedBufferUnsealed()
+{
+#if !defined(Q_OS_LINUX) || !defined(SYS_memfd_create) || !defined(F_ADD_SEALS)
+    QSKIP("Seals are only checked on Linux");
+#else
+    // the sender could shrink a buffer whose size is not sealed while the
+    // receiver has it mapped, killing the receiver with SIGBUS
+    const int unsealable = int(::syscall(SYS_memfd_create, "tst_qlocalsocket", 0));
+    if (unsealable == -1 && errno == ENOSYS)
+        QSKIP("memfd_create() is not supported by this kernel");
+    QVERIFY(unsealable != -1);
+    QCOMPARE(::ftruncate(unsealable, 4096), 0);
+    QLocalSharedBuffer buffer;
+    QVERIFY(!buffer.attach(unsealable, QLocalSharedBuffer::ReadOnly));
+    QVERIFY(!buffer.isAttached());
+    QVERIFY(!buffer.errorString().isEmpty());
+
+    const int growOnly = int(::syscall(SYS_memfd_create, "tst_qlocalsocket", 0x0002U /* MFD_ALLOW_SEALING */));
+    QVERIFY(growOnly != -1);
+    QCOMPARE(::ftruncate(growOnly, 4096), 0);
+    QCOMPARE(::fcntl(growOnly, F_ADD_SEALS, F_SEAL_GROW), 0);
+    QVERIFY(!buffer.attach(growOnly, QLocalSharedBuffer::ReadOnly));
+    QVERIFY(!buffer.isAttached());
+
+    // a buffer created by QLocalSharedBuffer is accepted
+    QLocalSharedBuffer created;
+    QVERIFY2(created.create(4096), qPrintable(created.errorString()));
+    QVERIFY2(buffer.attach(::fcntl(int(created.fileDescriptor()), F_DUPFD_CLOEXEC, 0)),
+             qPrintable(buffer.errorString()));
+    QCOMPARE(buffer.size(), qint64(4096));
+#endif
+}
+
 QTEST_MAIN(tst_QLocalSocket)
 #include "tst_qlocalsocket.moc"
-
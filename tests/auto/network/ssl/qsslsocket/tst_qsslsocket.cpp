@@ -52,6 +52,7 @@
 #ifndef QT_NO_OPENSSL
 #include "private/qsslsocket_openssl_p.h"
 #include "private/qsslsocket_openssl_symbols_p.h"
+#include "private/qsslsessioncache_p.h"
 #endif
 #include "private/qsslsocket_p.h"
 #include "private/qsslconfiguration_p.h"
@@ -238,6 +239,8 @@ private slots:
     void allowedProtocolNegotiation();
     void pskServer();
     void forwardReadChannelFinished();
+    void sessionCache();
+    void kernelTls();
 #endif
 
     void setEmptyDefaultConfiguration(); // this test should be last
@@ -3866,6 +3869,186 @@ void tst_QSslSocket::forwardReadChannelFinished()
     QVERIFY(readChannelFinishedSpy.count());
 }
 
+void tst_QSslSocket::sessionCache()
+{
+    if (!QSslSocket::supportsSsl())
+        QSKIP("Needs SSL");
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        QSKIP("This test doesn't work via a proxy");
+
+    QSslSessionCache *cache = QSslSessionCache::instance();
+    cache->clear();
+    QSslSocket::resetSessionCacheCounters();
+
+    SslServer server(SRCDIR "certs/bogus-server.key", SRCDIR "certs/bogus-server.crt");
+    server.protocol = QSsl::SecureProtocols;
+    server.config.setSslOption(QSsl::SslOptionEnableServerSessionCache, true);
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    const QString host = QHostAddress(QHostAddress::LocalHost).toString();
+    const QString peerName = QStringLiteral("Bogus Server");
+    const QList<QSslCertificate> caCertificates = QSslCertificate::fromPath(SRCDIR "certs/bogus-ca.crt");
+    QCOMPARE(caCertificates.size(), 1);
+
+    // the first connection does a full handshake, the others resume its
+    // session, although each server socket has an SSL context of its own
+    for (int i = 0; i < 3; ++i) {
+        QSslSocket client;
+        client.setCaCertificates(caCertificates);
+        connect(&client, &QSslSocket::encrypted, &QTestEventLoop::instance(), &QTestEventLoop::exitLoop);
+        client.connectToHostEncrypted(host, server.serverPort(), peerName);
+        enterLoop(10);
+        QVERIFY(client.isEncrypted());
+        // with TLS 1.3 the session ticket only arrives after the handshake
+        QTRY_COMPARE(cache->count(), 1);
+        QTRY_COMPARE(QSslSocket::sessionCacheCounter(QSslSocket::ServerHandshakes), qint64(i + 1));
+    }
+    QCOMPARE(QSslSocket::sessionCacheCounter(QSslSocket::ClientSessionLookups), qint64(3));
+    QCOMPARE(QSslSocket::sessionCacheCounter(QSslSocket::ClientSessionHits), qint64(2));
+    QCOMPARE(QSslSocket::sessionCacheCounter(QSslSocket::ClientHandshakes), qint64(3));
+    QCOMPARE(QSslSocket::sessionCacheCounter(QSslSocket::ClientResumedHandshakes), qint64(2));
+    QCOMPARE(QSslSocket::sessionCacheCounter(QSslSocket::ServerResumedHandshakes), qint64(2));
+
+    // sockets that must not share sessions do a full handshake
+    {
+        QSslSocket client;
+        client.setCaCertificates(caCertificates);
+        QSslConfiguration config = client.sslConfiguration();
+        config.setSslOption(QSsl::SslOptionDisableSessionSharing, true);
+        client.setSslConfiguration(config);
+        connect(&client, &QSslSocket::encrypted, &QTestEventLoop::instance(), &QTestEventLoop::exitLoop);
+        client.connectToHostEncrypted(host, server.serverPort(), peerName);
+        enterLoop(10);
+        QVERIFY(client.isEncrypted());
+        QTRY_COMPARE(QSslSocket::sessionCacheCounter(QSslSocket::ServerHandshakes), qint64(4));
+    }
+    QCOMPARE(QSslSocket::sessionCacheCounter(QSslSocket::ClientHandshakes), qint64(4));
+    QCOMPARE(QSslSocket::sessionCacheCounter(QSslSocket::ClientResumedHandshakes), qint64(2));
+
+    // a session is only resumed by sockets that trust the same certificates,
+    // a socket that doesn't trust the server still gets its errors
+    {
+        QSslSocket client;
+        QSignalSpy sslErrorsSpy(&client, SIGNAL(sslErrors(QList<QSslError>)));
+        connect(&client, SIGNAL(error(QAbstractSocket::SocketError)), &QTestEventLoop::instance(), SLOT(exitLoop()));
+        client.connectToHostEncrypted(host, server.serverPort(), peerName);
+        enterLoop(10);
+        QVERIFY(!client.isEncrypted());
+        QCOMPARE(sslErrorsSpy.count(), 1);
+    }
+    QCOMPARE(QSslSocket::sessionCacheCounter(QSslSocket::ClientResumedHandshakes), qint64(2));
+
+    // sessions of sockets that didn't verify the peer, or ignored errors,
+    // are not stored: a resumed session skips certificate verification
+    cache->clear();
+    for (int i = 0; i < 2; ++i) {
+        QSslSocket client;
+        if (i == 0)
+            client.setPeerVerifyMode(QSslSocket::VerifyNone);
+        else
+            connect(&client, SIGNAL(sslErrors(QList<QSslError>)), &client, SLOT(ignoreSslErrors()));
+        connect(&client, &QSslSocket::encrypted, &QTestEventLoop::instance(), &QTestEventLoop::exitLoop);
+        client.connectToHostEncrypted(host, server.serverPort(), peerName);
+        enterLoop(10);
+        QVERIFY(client.isEncrypted());
+        // give TLS 1.3 session tickets time to arrive
+        QTest::qWait(100);
+    }
+    QCOMPARE(cache->count(), 0);
+    {
+        QSslSocket client;
+        QSignalSpy sslErrorsSpy(&client, SIGNAL(sslErrors(QList<QSslError>)));
+        connect(&client, SIGNAL(error(QAbstractSocket::SocketError)), &QTestEventLoop::instance(), SLOT(exitLoop()));
+        client.connectToHostEncrypted(host, server.serverPort(), peerName);
+        enterLoop(10);
+        QVERIFY(!client.isEncrypted());
+        QCOMPARE(sslErrorsSpy.count(), 1);
+    }
+
+    // without the server cache, the server cannot resume the session
+    server.config.setSslOption(QSsl::SslOptionEnableServerSessionCache, false);
+    QSslSocket::resetSessionCacheCounters();
+    for (int i = 0; i < 2; ++i) {
+        QSslSocket client;
+        client.setCaCertificates(caCertificates);
+        connect(&client, &QSslSocket::encrypted, &QTestEventLoop::instance(), &QTestEventLoop::exitLoop);
+        client.connectToHostEncrypted(host, server.serverPort(), peerName);
+        enterLoop(10);
+        QVERIFY(client.isEncrypted());
+        QTRY_COMPARE(cache->count(), 1);
+        QTRY_COMPARE(QSslSocket::sessionCacheCounter(QSslSocket::ServerHandshakes), qint64(i + 1));
+    }
+    QCOMPARE(QSslSocket::sessionCacheCounter(QSslSocket::ClientHandshakes), qint64(2));
+    QCOMPARE(QSslSocket::sessionCacheCounter(QSslSocket::ClientSessionHits), qint64(1));
+    QCOMPARE(QSslSocket::sessionCacheCounter(QSslSocket::ClientResumedHandshakes), qint64(0));
+    QCOMPARE(QSslSocket::sessionCacheCounter(QSslSocket::ServerResumedHandshakes), qint64(0));
+
+    // the cache is bounded, least recently used sessions go first
+    cache->clear();
+    const int maxEntries = cache->maxEntries();
+    cache->setMaxEntries(2);
+    cache->insert(QStringLiteral("a"), "session a", 0);
+    cache->insert(QStringLiteral("b"), "session b", 0);
+    QCOMPARE(cache->session(QStringLiteral("a")), QByteArray("session a"));
+    cache->insert(QStringLiteral("c"), "session c", 0);
+    QCOMPARE(cache->session(QStringLiteral("a")), QByteArray("session a"));
+    QVERIFY(cache->session(QStringLiteral("b")).isEmpty());
+    QCOMPARE(cache->session(QStringLiteral("c")), QByteArray("session c"));
+
+    cache->setMaxEntries(maxEntries);
+    cache->clear();
+    QSslSocket::resetSessionCacheCounters();
+}
+
+void tst_QSslSocket::kernelTls()
+{
+    if (!QSslSocket::supportsSsl())
+        QSKIP("Needs SSL");
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        QSKIP("This test doesn't work via a proxy");
+
+    // Whether or not the kernel takes over the encryption, the data has to
+    // arrive unchanged in both directions, and the connection has to close
+    // cleanly.
+    SslServer server(SRCDIR "certs/bogus-server.key", SRCDIR "certs/bogus-server.crt");
+    server.protocol = QSsl::SecureProtocols;
+    server.config.setSslOption(QSsl::SslOptionEnableKernelTls, true);
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QSslSocket client;
+    QSslConfiguration config = client.sslConfiguration();
+    config.setPeerVerifyMode(QSslSocket::VerifyNone);
+    config.setSslOption(QSsl::SslOptionEnableKernelTls, true);
+    client.setSslConfiguration(config);
+    connect(&client, &QSslSocket::encrypted, &QTestEventLoop::instance(), &QTestEventLoop::exitLoop);
+    client.connectToHostEncrypted(QHostAddress(QHostAddress::LocalHost).toString(), server.serverPort());
+    enterLoop(10);
+    QVERIFY(client.isEncrypted());
+    QTRY_VERIFY(server.socket && server.socket->isEncrypted());
+
+    QByteArray data(1024 * 1024, Qt::Uninitialized);
+    for (int i = 0; i < data.size(); ++i)
+        data[i] = char(qrand());
+
+    QByteArray received;
+    connect(server.socket, &QSslSocket::readyRead, this, [&]() { received += server.socket->readAll(); });
+    for (int i = 0; i < data.size(); i += 64 * 1024)
+        client.write(data.mid(i, 64 * 1024));
+    QTRY_COMPARE(received.size(), data.size());
+    QVERIFY(received == data);
+
+    received.clear();
+    connect(&client, &QSslSocket::readyRead, this, [&]() { received += client.readAll(); });
+    server.socket->write(data);
+    QTRY_COMPARE(received.size(), data.size());
+    QVERIFY(received == data);
+
+    QSignalSpy disconnectedSpy(server.socket, SIGNAL(disconnected()));
+    client.disconnectFromHost();
+    QTRY_COMPARE(disconnectedSpy.count(), 1);
+}
+
 #endif // QT_NO_OPENSSL
 
 #endif // QT_NO_SSL
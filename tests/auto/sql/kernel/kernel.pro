@@ -2,6 +2,8 @@ TEMPLATE=subdirs
 SUBDIRS=\
    qsqlfield \
    qsqldatabase \
+   qsqlconnectionpool \
+   qsqlasyncquery \
    qsqlerror \
    qsqldriver \
    qsqlquery \
@@ -0,0 +1,434 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtSql/QtSql>
+
+#include "../qsqldatabase/tst_databases.h"
+
+class tst_QSqlAsyncQuery : public QObject
+{
+    Q_OBJECT
+
+public slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+private slots:
+    void select();
+    void bindValues();
+    void emptyResult();
+    void nonSelect();
+    void error();
+    void cancel();
+    void sharedWorker();
+    void releaseWhileRunning();
+    void model();
+    void psql_nativeExecutor_data() { generic_data("QPSQL"); }
+    void psql_nativeExecutor();
+
+private:
+    void generic_data(const QString &engine);
+
+    tst_Databases dbs;
+    QTemporaryDir dir;
+    QSqlDatabase db;
+};
+
+static const int rowCount = 1000;
+
+void tst_QSqlAsyncQuery::initTestCase()
+{
+    QVERIFY(dbs.open());
+    if (!QSqlDatabase::isDriverAvailable(QStringLiteral("QSQLITE")))
+        QSKIP("The QSQLITE driver is not available");
+    QVERIFY(dir.isValid());
+
+    QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), QStringLiteral("setup"));
+    db.setDatabaseName(dir.filePath(QStringLiteral("async.db")));
+    QVERIFY(db.open());
+    QSqlQuery q(db);
+    QVERIFY(q.exec(QStringLiteral("CREATE TABLE items (id integer PRIMARY KEY, name text)")));
+    QVERIFY(db.transaction());
+    QVERIFY(q.prepare(QStringLiteral("INSERT INTO items VALUES (?, ?)")));
+    for (int i = 0; i < rowCount; ++i) {
+        q.addBindValue(i);
+        q.addBindValue(QString::number(i));
+        QVERIFY(q.exec());
+    }
+    QVERIFY(db.commit());
+    q.clear();
+    db.close();
+}
+
+void tst_QSqlAsyncQuery::cleanupTestCase()
+{
+    dbs.close();
+}
+
+void tst_QSqlAsyncQuery::generic_data(const QString &engine)
+{
+    if (dbs.fillTestTable(engine) == 0)
+        QSKIP(qPrintable(QString("No database drivers of type %1 are available in this Qt configuration").arg(engine)));
+}
+
+void tst_QSqlAsyncQuery::init()
+{
+    db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), QStringLiteral("async"));
+    db.setDatabaseName(dir.filePath(QStringLiteral("async.db")));
+    QVERIFY(db.open());
+}
+
+void tst_QSqlAsyncQuery::cleanup()
+{
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(QStringLiteral("async"));
+}
+
+void tst_QSqlAsyncQuery::select()
+{
+    QSqlAsyncQuery query(db);
+    query.setBatchSize(100);
+    QCOMPARE(query.batchSize(), 100);
+
+    QVector<QSqlRecord> rows;
+    int batches = 0;
+    connect(&query, &QSqlAsyncQuery::rowsReady, [&](const QVector<QSqlRecord> &batch) {
+        QVERIFY(batch.count() <= 100);
+        QCOMPARE(query.record().count(), 2);
+        rows += batch;
+        ++batches;
+    });
+    QSignalSpy finished(&query, &QSqlAsyncQuery::finished);
+
+    QVERIFY(query.exec(QStringLiteral("SELECT id, name FROM items ORDER BY id")));
+    QVERIFY(query.isActive());
+    // nothing is delivered before the event loop runs
+    QCOMPARE(rows.count(), 0);
+
+    QVERIFY(finished.wait(30000));
+    QCOMPARE(finished.count(), 1);
+    QVERIFY(!query.isActive());
+    QVERIFY2(!query.lastError().isValid(), qPrintable(query.lastError().text()));
+    QCOMPARE(batches, rowCount / 100);
+    QCOMPARE(rows.count(), rowCount);
+    for (int i = 0; i < rowCount; ++i) {
+        QCOMPARE(rows.at(i).value(0).toInt(), i);
+        QCOMPARE(rows.at(i).value(QStringLiteral("name")).toString(), QString::number(i));
+    }
+    QCOMPARE(query.record().fieldName(0), QStringLiteral("id"));
+    QCOMPARE(query.record().fieldName(1), QStringLiteral("name"));
+}
+
+void tst_QSqlAsyncQuery::bindValues()
+{
+    QSqlAsyncQuery query(db);
+    QVector<QSqlRecord> rows;
+    connect(&query, &QSqlAsyncQuery::rowsReady, [&](const QVector<QSqlRecord> &batch) {
+        rows += batch;
+    });
+    QSignalSpy finished(&query, &QSqlAsyncQuery::finished);
+
+    query.prepare(QStringLiteral("SELECT name FROM items WHERE id >= ? AND id < ? ORDER BY id"));
+    query.addBindValue(10);
+    query.addBindValue(20);
+    QVERIFY(query.exec());
+    QVERIFY(finished.wait(30000));
+    QCOMPARE(rows.count(), 10);
+    QCOMPARE(rows.first().value(0).toString(), QStringLiteral("10"));
+
+    rows.clear();
+    query.prepare(QStringLiteral("SELECT name FROM items WHERE id = :id"));
+    query.bindValue(QStringLiteral(":id"), 42);
+    QVERIFY(query.exec());
+    QVERIFY(finished.wait(30000));
+    QCOMPARE(rows.count(), 1);
+    QCOMPARE(rows.first().value(0).toString(), QStringLiteral("42"));
+    QCOMPARE(query.lastQuery(), QStringLiteral("SELECT name FROM items WHERE id = :id"));
+}
+
+void tst_QSqlAsyncQuery::emptyResult()
+{
+    QSqlAsyncQuery query(db);
+    int batches = 0;
+    connect(&query, &QSqlAsyncQuery::rowsReady, [&batches]() { ++batches; });
+    QSignalSpy finished(&query, &QSqlAsyncQuery::finished);
+
+    QVERIFY(query.exec(QStringLiteral("SELECT id, name FROM items WHERE id < 0")));
+    QVERIFY(finished.wait(30000));
+    QCOMPARE(batches, 0);
+    QVERIFY(!query.lastError().isValid());
+    QCOMPARE(query.record().count(), 2);
+}
+
+void tst_QSqlAsyncQuery::nonSelect()
+{
+    QSqlAsyncQuery query(db);
+    QSignalSpy finished(&query, &QSqlAsyncQuery::finished);
+
+    QVERIFY(query.exec(QStringLiteral("CREATE TEMPORARY TABLE scratch (id integer PRIMARY KEY, name text)")));
+    QVERIFY(finished.wait(30000));
+    QVERIFY2(!query.lastError().isValid(), qPrintable(query.lastError().text()));
+
+    query.prepare(QStringLiteral("INSERT INTO scratch (name) VALUES (?)"));
+    query.addBindValue(QStringLiteral("first"));
+    QVERIFY(query.exec());
+    QVERIFY(finished.wait(30000));
+    QVERIFY2(!query.lastError().isValid(), qPrintable(query.lastError().text()));
+    QCOMPARE(query.numRowsAffected(), 1);
+    QCOMPARE(query.lastInsertId().toInt(), 1);
+
+    // the worker has its own session, the temporary table isn't visible here
+    QVERIFY(!db.tables(QSql::AllTables).contains(QStringLiteral("scratch")));
+}
+
+void tst_QSqlAsyncQuery::error()
+{
+    QSqlAsyncQuery query(db);
+    QSignalSpy finished(&query, &QSqlAsyncQuery::finished);
+
+    QVERIFY(query.exec(QStringLiteral("SELECT * FROM no_such_table")));
+    QVERIFY(finished.wait(30000));
+    QVERIFY(query.lastError().isValid());
+    QVERIFY(!query.isActive());
+
+    QSqlAsyncQuery invalid(QSqlDatabase::database(QStringLiteral("no_such_connection"), false));
+    QVERIFY(!invalid.exec(QStringLiteral("SELECT 1")));
+    QVERIFY(invalid.lastError().isValid());
+    QVERIFY(!invalid.isActive());
+}
+
+void tst_QSqlAsyncQuery::cancel()
+{
+    QSqlAsyncQuery query(db);
+    query.setBatchSize(10);
+    QVector<QSqlRecord> rows;
+    bool restarted = false;
+    connect(&query, &QSqlAsyncQuery::rowsReady, [&](const QVector<QSqlRecord> &batch) {
+        rows += batch;
+        if (restarted)
+            return;
+        // the rows and the finished() of the cancelled statement are
+        // still being posted by the worker, none of them may arrive
+        restarted = true;
+        query.cancel();
+        rows.clear();
+        query.exec(QStringLiteral("SELECT count(*) AS total FROM items"));
+    });
+    QSignalSpy finished(&query, &QSqlAsyncQuery::finished);
+
+    QVERIFY(query.exec(QStringLiteral("SELECT id FROM items")));
+    QVERIFY(finished.wait(30000));
+    QVERIFY(restarted);
+    QVERIFY(!query.lastError().isValid());
+    QCOMPARE(query.record().count(), 1);
+    QCOMPARE(query.record().fieldName(0), QStringLiteral("total"));
+    QCOMPARE(rows.count(), 1);
+    QCOMPARE(rows.first().value(0).toInt(), rowCount);
+    QCOMPARE(finished.count(), 1);
+}
+
+void tst_QSqlAsyncQuery::sharedWorker()
+{
+    QSqlAsyncQuery first(db);
+    QSqlAsyncQuery second(db);
+    QSignalSpy firstFinished(&first, &QSqlAsyncQuery::finished);
+    QSignalSpy secondFinished(&second, &QSqlAsyncQuery::finished);
+
+    QVERIFY(first.exec(QStringLiteral("SELECT id FROM items")));
+    QVERIFY(second.exec(QStringLiteral("SELECT name FROM items")));
+    QTRY_COMPARE_WITH_TIMEOUT(firstFinished.count() + secondFinished.count(), 2, 30000);
+    QVERIFY(!first.lastError().isValid());
+    QVERIFY(!second.lastError().isValid());
+}
+
+static QStringList asyncConnectionNames()
+{
+    return QSqlDatabase::connectionNames().filter(QRegExp(QStringLiteral("^qt_sql_async_")));
+}
+
+void tst_QSqlAsyncQuery::releaseWhileRunning()
+{
+    // workers of the previous tests may still be closing their connections
+    QTRY_VERIFY_WITH_TIMEOUT(asyncConnectionNames().isEmpty(), 30000);
+
+    QSqlAsyncQuery *query = new QSqlAsyncQuery(db);
+    QVERIFY(query->exec(QStringLiteral("WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c "
+                                       "WHERE x < 1000000) SELECT count(*) FROM c")));
+    QTRY_VERIFY_WITH_TIMEOUT(!asyncConnectionNames().isEmpty(), 30000);
+
+    // deleting the last query of a connection doesn't wait for the worker;
+    // its connection is removed once the statement is done
+    delete query;
+    QVERIFY(!asyncConnectionNames().isEmpty());
+    QTRY_VERIFY_WITH_TIMEOUT(asyncConnectionNames().isEmpty(), 30000);
+}
+
+void tst_QSqlAsyncQuery::model()
+{
+    QSqlQueryModel model;
+    QSqlAsyncQuery *query = new QSqlAsyncQuery(db, &model);
+    query->setBatchSize(100);
+    query->prepare(QStringLiteral("SELECT id, name FROM items WHERE id < ? ORDER BY id"));
+    query->addBindValue(500);
+
+    QSignalSpy rowsInserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy columnsInserted(&model, &QAbstractItemModel::columnsInserted);
+    QSignalSpy finished(query, &QSqlAsyncQuery::finished);
+
+    model.setQuery(query);
+    QVERIFY(query->isActive());
+    QCOMPARE(model.rowCount(), 0);
+    QVERIFY(!model.canFetchMore());
+
+    QVERIFY(finished.wait(30000));
+    QVERIFY(!model.lastError().isValid());
+    QCOMPARE(columnsInserted.count(), 1);
+    QCOMPARE(rowsInserted.count(), 5);
+    QCOMPARE(model.rowCount(), 500);
+    QCOMPARE(model.columnCount(), 2);
+    QCOMPARE(model.headerData(1, Qt::Horizontal).toString(), QStringLiteral("name"));
+    QCOMPARE(model.data(model.index(123, 0)).toInt(), 123);
+    QCOMPARE(model.record(321).value(QStringLiteral("name")).toString(), QStringLiteral("321"));
+    QVERIFY(!model.canFetchMore());
+
+    // a plain query replaces the rows of the asynchronous one
+    model.setQuery(QSqlQuery(QStringLiteral("SELECT id FROM items WHERE id < 3"), db));
+    QCOMPARE(model.columnCount(), 1);
+    QCOMPARE(model.data(model.index(2, 0)).toInt(), 2);
+
+    model.setQuery(query);
+    QVERIFY(finished.wait(30000));
+    QCOMPARE(model.rowCount(), 500);
+    model.clear();
+    QCOMPARE(model.rowCount(), 0);
+    QCOMPARE(model.columnCount(), 0);
+}
+
+void tst_QSqlAsyncQuery::psql_nativeExecutor()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    const QString tableName = qTableName("async_native", __FILE__, db);
+    tst_Databases::safeDropTable(db, tableName);
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id serial PRIMARY KEY, name varchar(20))"));
+    QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " (name) SELECT 'name ' || i FROM generate_series(1, "
+                        + QString::number(rowCount) + ") AS i"));
+
+    QSqlAsyncQuery query(db);
+    QVector<QSqlRecord> rows;
+    connect(&query, &QSqlAsyncQuery::rowsReady, [&](const QVector<QSqlRecord> &batch) {
+        rows += batch;
+    });
+    QSignalSpy finished(&query, &QSqlAsyncQuery::finished);
+
+    // the statement runs on the connection itself, not on a clone in a worker
+    QVERIFY_SQL(q, exec("SELECT pg_backend_pid()"));
+    QVERIFY_SQL(q, next());
+    const int pid = q.value(0).toInt();
+    q.finish();
+    QVERIFY(query.exec("SELECT pg_backend_pid()"));
+    QVERIFY(finished.wait(30000));
+    QCOMPARE(rows.count(), 1);
+    QCOMPARE(rows.first().value(0).toInt(), pid);
+
+    // other queries can use the connection while rows are streamed
+    rows.clear();
+    query.setBatchSize(100);
+    query.prepare("SELECT id, name FROM " + tableName + " WHERE id > ? ORDER BY id");
+    query.addBindValue(0);
+    QVERIFY(query.exec());
+    QVERIFY_SQL(q, exec("SELECT count(*) FROM " + tableName));
+    QVERIFY_SQL(q, next());
+    QCOMPARE(q.value(0).toInt(), rowCount);
+    q.finish();
+    QVERIFY(finished.wait(30000));
+    QVERIFY2(!query.lastError().isValid(), qPrintable(query.lastError().text()));
+    QCOMPARE(rows.count(), rowCount);
+    QCOMPARE(rows.last().value(1).toString(), QString("name %1").arg(rowCount));
+
+    // lastInsertId() is answered by the executor once the INSERT is done
+    query.prepare("INSERT INTO " + tableName + " (name) VALUES (?)");
+    query.addBindValue("inserted");
+    QVERIFY(query.exec());
+    QVERIFY(!query.lastInsertId().isValid());
+    QVERIFY(finished.wait(30000));
+    QVERIFY2(!query.lastError().isValid(), qPrintable(query.lastError().text()));
+    QCOMPARE(query.numRowsAffected(), 1);
+    QCOMPARE(query.lastInsertId().toInt(), rowCount + 1);
+
+    // a cancelled query leaves the connection usable
+    rows.clear();
+    query.setBatchSize(10);
+    QVERIFY(query.exec("SELECT id FROM " + tableName));
+    QTRY_VERIFY(!rows.isEmpty());
+    query.cancel();
+    QVERIFY_SQL(q, exec("SELECT count(*) FROM " + tableName));
+    QVERIFY_SQL(q, next());
+    QCOMPARE(q.value(0).toInt(), rowCount + 1);
+    q.finish();
+
+    // cancel() doesn't wait for the server, the next statement still only
+    // sees its own result
+    rows.clear();
+    QVERIFY(query.exec("SELECT id FROM " + tableName));
+    QTRY_VERIFY(!rows.isEmpty());
+    query.cancel();
+    rows.clear();
+    QVERIFY(query.exec("SELECT count(*) AS total FROM " + tableName));
+    QVERIFY(finished.wait(30000));
+    QVERIFY2(!query.lastError().isValid(), qPrintable(query.lastError().text()));
+    QCOMPARE(query.record().fieldName(0), QString("total"));
+    QCOMPARE(rows.count(), 1);
+    QCOMPARE(rows.first().value(0).toInt(), rowCount + 1);
+
+    // byte arrays are sent whole, not cut at the first NUL
+    rows.clear();
+    const QByteArray bytes("a\0b\xff", 4);
+    query.prepare("SELECT ?::bytea");
+    query.addBindValue(bytes);
+    QVERIFY(query.exec());
+    QVERIFY(finished.wait(30000));
+    QVERIFY2(!query.lastError().isValid(), qPrintable(query.lastError().text()));
+    QCOMPARE(rows.count(), 1);
+    QCOMPARE(rows.first().value(0).toByteArray(), bytes);
+
+    QVERIFY(query.exec("SELECT * FROM " + qTableName("no_such_table", __FILE__, db)));
+    QVERIFY(finished.wait(30000));
+    QVERIFY(query.lastError().isValid());
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
+QTEST_MAIN(tst_QSqlAsyncQuery)
+#include "tst_qsqlasyncquery.moc"
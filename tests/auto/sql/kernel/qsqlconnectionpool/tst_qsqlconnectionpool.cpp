@@ -0,0 +1,313 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtSql/QtSql>
+
+#include <functional>
+
+class tst_QSqlConnectionPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void reuseInSameThread();
+    void connectionPerThread();
+    void maxConnections();
+    void releaseWakesWaiter();
+    void idleTimeout();
+    void healthCheck();
+    void threadPool();
+
+private:
+    QTemporaryDir dir;
+    QSqlDatabase prototype;
+};
+
+class FunctionThread : public QThread
+{
+public:
+    explicit FunctionThread(const std::function<void()> &f) : function(f) {}
+protected:
+    void run() override { function(); }
+private:
+    std::function<void()> function;
+};
+
+class FunctionRunnable : public QRunnable
+{
+public:
+    explicit FunctionRunnable(const std::function<void()> &f) : function(f) {}
+    void run() override { function(); }
+private:
+    std::function<void()> function;
+};
+
+static void runInThread(const std::function<void()> &f)
+{
+    FunctionThread thread(f);
+    thread.start();
+    QVERIFY(thread.wait(30000));
+}
+
+void tst_QSqlConnectionPool::initTestCase()
+{
+    if (!QSqlDatabase::isDriverAvailable(QStringLiteral("QSQLITE")))
+        QSKIP("The QSQLITE driver is not available");
+    QVERIFY(dir.isValid());
+
+    QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), QStringLiteral("setup"));
+    db.setDatabaseName(dir.filePath(QStringLiteral("pool.db")));
+    QVERIFY(db.open());
+    QSqlQuery q(db);
+    QVERIFY(q.exec(QStringLiteral("CREATE TABLE items (id integer PRIMARY KEY, name text)")));
+    QVERIFY(q.exec(QStringLiteral("INSERT INTO items VALUES (1, 'one')")));
+    q.clear();
+    db.close();
+}
+
+void tst_QSqlConnectionPool::init()
+{
+    prototype = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), QStringLiteral("prototype"));
+    prototype.setDatabaseName(dir.filePath(QStringLiteral("pool.db")));
+}
+
+void tst_QSqlConnectionPool::cleanup()
+{
+    prototype = QSqlDatabase();
+    QSqlDatabase::removeDatabase(QStringLiteral("prototype"));
+}
+
+void tst_QSqlConnectionPool::reuseInSameThread()
+{
+    QSqlConnectionPool pool(prototype);
+    pool.setMaxConnections(2);
+    QString name;
+    {
+        QSqlDatabase db = pool.acquire();
+        QVERIFY(db.isOpen());
+        QVERIFY(db.connectionName() != prototype.connectionName());
+        QSqlQuery q(db);
+        QVERIFY(q.exec(QStringLiteral("SELECT name FROM items WHERE id = 1")));
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toString(), QStringLiteral("one"));
+        name = db.connectionName();
+        pool.release(db);
+    }
+    QCOMPARE(pool.idleConnectionCount(), 1);
+    QVERIFY(!prototype.isOpen());
+
+    QSqlDatabase db = pool.acquire();
+    QCOMPARE(db.connectionName(), name);
+    QCOMPARE(pool.connectionCount(), 1);
+    QCOMPARE(pool.idleConnectionCount(), 0);
+
+    // a second acquire in the same thread gets its own connection
+    QSqlDatabase second = pool.acquire();
+    QVERIFY(second.isOpen());
+    QVERIFY(second.connectionName() != name);
+    QCOMPARE(pool.connectionCount(), 2);
+    pool.release(second);
+    pool.release(db);
+    second = db = QSqlDatabase();
+
+    pool.closeIdleConnections();
+    QCOMPARE(pool.connectionCount(), 0);
+}
+
+void tst_QSqlConnectionPool::connectionPerThread()
+{
+    QSqlConnectionPool pool(prototype);
+    pool.setMaxConnections(2);
+    QSqlDatabase db = pool.acquire();
+    const QString mainName = db.connectionName();
+    pool.release(db);
+    db = QSqlDatabase();
+
+    QString workerName;
+    bool workerOpen = false;
+    runInThread([&]() {
+        QSqlDatabase workerDb = pool.acquire();
+        workerName = workerDb.connectionName();
+        workerOpen = workerDb.isOpen() && workerDb.driver()->thread() == QThread::currentThread();
+        pool.release(workerDb);
+    });
+    QVERIFY(workerOpen);
+    QVERIFY(workerName != mainName);
+
+    // the worker's connection was closed when its thread finished
+    QCOMPARE(pool.connectionCount(), 1);
+    QVERIFY(!QSqlDatabase::contains(workerName));
+    QVERIFY(QSqlDatabase::contains(mainName));
+}
+
+void tst_QSqlConnectionPool::maxConnections()
+{
+    QSqlConnectionPool pool(prototype);
+    pool.setMaxConnections(1);
+    QCOMPARE(pool.maxConnections(), 1);
+
+    QSqlDatabase db = pool.acquire();
+    QVERIFY(db.isOpen());
+    const QString mainName = db.connectionName();
+
+    bool timedOut = false;
+    runInThread([&]() {
+        timedOut = !pool.acquire(50).isValid();
+    });
+    QVERIFY(timedOut);
+
+    pool.release(db);
+    db = QSqlDatabase();
+
+    // the idle connection of the main thread makes room for the worker
+    QString workerName;
+    runInThread([&]() {
+        QSqlDatabase workerDb = pool.acquire(1000);
+        workerName = workerDb.connectionName();
+        pool.release(workerDb);
+    });
+    QVERIFY(!workerName.isEmpty());
+    QVERIFY(workerName != mainName);
+    QVERIFY(!QSqlDatabase::contains(mainName));
+    QCOMPARE(pool.connectionCount(), 0);
+}
+
+void tst_QSqlConnectionPool::releaseWakesWaiter()
+{
+    QSqlConnectionPool pool(prototype);
+    pool.setMaxConnections(1);
+
+    QSqlDatabase db = pool.acquire();
+    const QString mainName = db.connectionName();
+
+    QSemaphore waiting;
+    QString workerName;
+    FunctionThread worker([&]() {
+        waiting.release();
+        QSqlDatabase workerDb = pool.acquire(30000);
+        workerName = workerDb.connectionName();
+        pool.release(workerDb);
+    });
+    worker.start();
+    waiting.acquire();
+    QTest::qSleep(50);
+
+    // the waiter gets a connection even though this thread still holds the
+    // handle of the one it released
+    pool.release(db);
+    QVERIFY(worker.wait(30000));
+    QVERIFY(!workerName.isEmpty());
+    QVERIFY(workerName != mainName);
+    QVERIFY(!QSqlDatabase::contains(mainName));
+
+    // the removed connection stays usable until the handle goes away
+    QVERIFY(db.isOpen());
+    QSqlQuery q(db);
+    QVERIFY(q.exec(QStringLiteral("SELECT name FROM items WHERE id = 1")));
+    QVERIFY(q.next());
+    q.clear();
+    db = QSqlDatabase();
+}
+
+void tst_QSqlConnectionPool::idleTimeout()
+{
+    QSqlConnectionPool pool(prototype);
+    pool.setIdleTimeout(0);
+    QCOMPARE(pool.idleTimeout(), 0);
+
+    QSqlDatabase db = pool.acquire();
+    const QString name = db.connectionName();
+    pool.release(db);
+    db = QSqlDatabase();
+
+    db = pool.acquire();
+    QVERIFY(db.isOpen());
+    QVERIFY(db.connectionName() != name);
+    QVERIFY(!QSqlDatabase::contains(name));
+    QCOMPARE(pool.connectionCount(), 1);
+    pool.release(db);
+}
+
+void tst_QSqlConnectionPool::healthCheck()
+{
+    QSqlConnectionPool pool(prototype);
+    pool.setHealthCheckQuery(QStringLiteral("SELECT 1"));
+    QCOMPARE(pool.healthCheckQuery(), QStringLiteral("SELECT 1"));
+
+    QSqlDatabase db = pool.acquire();
+    const QString name = db.connectionName();
+    db.close();
+    pool.release(db);
+
+    db = pool.acquire();
+    QCOMPARE(db.connectionName(), name);
+    QVERIFY(db.isOpen());
+    QSqlQuery q(db);
+    QVERIFY(q.exec(QStringLiteral("SELECT count(*) FROM items")));
+    q.clear();
+    pool.release(db);
+}
+
+void tst_QSqlConnectionPool::threadPool()
+{
+    QSqlConnectionPool pool(prototype);
+    pool.setMaxConnections(3);
+
+    QThreadPool threads;
+    threads.setMaxThreadCount(4);
+    QAtomicInt found;
+    QAtomicInt failed;
+    for (int i = 0; i < 200; ++i) {
+        threads.start(new FunctionRunnable([&]() {
+            QSqlDatabase db = pool.acquire();
+            {
+                QSqlQuery q(db);
+                if (q.exec(QStringLiteral("SELECT name FROM items WHERE id = 1")) && q.next())
+                    found.ref();
+                else
+                    failed.ref();
+            }
+            if (pool.connectionCount() > 3)
+                failed.ref();
+            pool.release(db);
+        }));
+    }
+    QVERIFY(threads.waitForDone(30000));
+    QCOMPARE(found.load(), 200);
+    QCOMPARE(failed.load(), 0);
+}
+
+QTEST_MAIN(tst_QSqlConnectionPool)
+
+#include "tst_qsqlconnectionpool.moc"
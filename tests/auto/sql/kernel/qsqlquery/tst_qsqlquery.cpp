@@ -158,6 +158,12 @@ private slots:
     void psql_bindWithDoubleColonCastOperator();
     void psql_specialFloatValues_data() { generic_data("QPSQL"); }
     void psql_specialFloatValues();
+    void psql_binaryParameters_data() { generic_data("QPSQL"); }
+    void psql_binaryParameters();
+    void psql_copyBatch_data() { generic_data("QPSQL"); }
+    void psql_copyBatch();
+    void psql_singleRowMode_data() { generic_data("QPSQL"); }
+    void psql_singleRowMode();
     void queryOnInvalidDatabase_data() { generic_data(); }
     void queryOnInvalidDatabase();
     void createQueryOnClosedDatabase_data() { generic_data(); }
@@ -239,6 +245,13 @@ private slots:
     void sqlite_real_data() { generic_data("QSQLITE"); }
     void sqlite_real();
 
+    void sqlite_batchExec_data() { generic_data("QSQLITE"); }
+    void sqlite_batchExec();
+    void sqlite_statementCache_data() { generic_data("QSQLITE"); }
+    void sqlite_statementCache();
+    void sqlite_statementCacheDisabled_data() { generic_data("QSQLITE"); }
+    void sqlite_statementCacheDisabled();
+
     void aggregateFunctionTypes_data() { generic_data(); }
     void aggregateFunctionTypes();
 
@@ -248,6 +261,9 @@ private slots:
     void QTBUG_57138_data() { generic_data("QSQLITE"); }
     void QTBUG_57138();
 
+    void columnarCache_data() { generic_data("QSQLITE"); }
+    void columnarCache();
+
 private:
     // returns all database connections
     void generic_data(const QString &engine=QString());
@@ -351,6 +367,7 @@ void tst_QSqlQuery::dropTestTables( QSqlDatabase db )
                << qTableName("blobstest", __FILE__, db)
                << qTableName("oraRowId", __FILE__, db)
                << qTableName("qtest_batch", __FILE__, db)
+               << qTableName("qtest_columnar", __FILE__, db)
                << qTableName("bug43874", __FILE__, db)
                << qTableName("bug6421", __FILE__, db).toUpper()
                << qTableName("bug5765", __FILE__, db)
@@ -2487,6 +2504,277 @@ void tst_QSqlQuery::psql_specialFloatValues()
     QVERIFY_SQL( query, exec("drop table " + tableName) );
 }
 
+// Prepared statements send and receive values in binary where the types
+// allow it; the values must be the same as through the text format.
+void tst_QSqlQuery::psql_binaryParameters()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    const QString tableName = qTableName("psql_binary", __FILE__, db);
+    tst_Databases::safeDropTable(db, tableName);
+
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id int4, b bool, i2 int2, i8 int8, d float8,"
+                        " ba bytea, t text, vc varchar(20), dt date, tm time, ts timestamp, tstz timestamptz)"));
+
+    const QDateTime dateTime(QDate(2017, 6, 15), QTime(13, 45, 12, 345));
+    const QByteArray bytes("\0\1\2\377binary\\data'", 16);
+    const QVariantList row1 = QVariantList() << 1 << true << -12345 << Q_INT64_C(-9000000000) << 1.5
+                                             << bytes << QString::fromUtf8("text \xc3\xa4\xe2\x82\xac")
+                                             << QString("varchar") << QDate(1999, 12, 31)
+                                             << QTime(23, 59, 58, 123) << dateTime << dateTime;
+    // values that need a conversion, and NULLs
+    const QVariantList row2 = QVariantList() << 2 << 0 << QString("42") << QString("7") << 10
+                                             << QVariant(QVariant::ByteArray) << 99 << QVariant(QVariant::String)
+                                             << QDate(2000, 1, 1) << QVariant(QVariant::Time)
+                                             << QDate(2017, 6, 15) << QVariant(QVariant::DateTime);
+
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, b, i2, i8, d, ba, t, vc, dt, tm, ts, tstz)"
+                           " VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"));
+    for (const QVariantList &row : { row1, row2 }) {
+        for (int i = 0; i < row.count(); ++i)
+            q.bindValue(i, row.at(i));
+        QVERIFY_SQL(q, exec());
+    }
+
+    const QString select = "SELECT id, b, i2, i8, d, ba, t, vc, dt, tm, ts, tstz FROM " + tableName
+            + " WHERE id = ?";
+    QSqlQuery text(db);
+    for (int id = 1; id <= 2; ++id) {
+        QVERIFY_SQL(q, prepare(select));
+        q.addBindValue(id);
+        QVERIFY_SQL(q, exec());
+        QVERIFY_SQL(q, next());
+        QVERIFY_SQL(text, exec(QString(select).replace('?', QString::number(id))));
+        QVERIFY_SQL(text, next());
+        QCOMPARE(q.record().count(), 12);
+        for (int i = 0; i < 12; ++i) {
+            QCOMPARE(q.isNull(i), text.isNull(i));
+            QCOMPARE(q.value(i).type(), text.value(i).type());
+            QCOMPARE(q.value(i), text.value(i));
+        }
+    }
+
+    QVERIFY_SQL(q, prepare(select));
+    q.addBindValue(1);
+    QVERIFY_SQL(q, exec());
+    QVERIFY_SQL(q, next());
+    QCOMPARE(q.value(1).toBool(), true);
+    QCOMPARE(q.value(2).toInt(), -12345);
+    QCOMPARE(q.value(3).toLongLong(), Q_INT64_C(-9000000000));
+    QCOMPARE(q.value(4).toDouble(), 1.5);
+    QCOMPARE(q.value(5).toByteArray(), bytes);
+    QCOMPARE(q.value(6).toString(), QString::fromUtf8("text \xc3\xa4\xe2\x82\xac"));
+    QCOMPARE(q.value(7).toString(), QString("varchar"));
+    QCOMPARE(q.value(8).toDate(), QDate(1999, 12, 31));
+    QCOMPARE(q.value(9).toTime(), QTime(23, 59, 58, 123));
+    QCOMPARE(q.value(10).toDateTime(), dateTime);
+    QCOMPARE(q.value(11).toDateTime(), dateTime);
+
+    QVERIFY_SQL(q, prepare(select));
+    q.addBindValue(2);
+    QVERIFY_SQL(q, exec());
+    QVERIFY_SQL(q, next());
+    QCOMPARE(q.value(1).toBool(), false);
+    QCOMPARE(q.value(2).toInt(), 42);
+    QCOMPARE(q.value(3).toLongLong(), Q_INT64_C(7));
+    QCOMPARE(q.value(4).toDouble(), 10.0);
+    QVERIFY(q.isNull(5));
+    QCOMPARE(q.value(6).toString(), QString("99"));
+    QVERIFY(q.isNull(7));
+    QCOMPARE(q.value(8).toDate(), QDate(2000, 1, 1));
+    QVERIFY(q.isNull(9));
+    QCOMPARE(q.value(10).toDateTime(), QDateTime(QDate(2017, 6, 15), QTime(0, 0)));
+    QVERIFY(q.isNull(11));
+
+    // a date time bound to a date is taken in UTC, like the date times above
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, dt) VALUES (?, ?)"));
+    q.addBindValue(3);
+    q.addBindValue(QDateTime(QDate(2017, 6, 16), QTime(1, 30), Qt::OffsetFromUTC, 2 * 3600));
+    QVERIFY_SQL(q, exec());
+    QVERIFY_SQL(q, exec("SELECT dt FROM " + tableName + " WHERE id = 3"));
+    QVERIFY_SQL(q, next());
+    QCOMPARE(q.value(0).toDate(), QDate(2017, 6, 15));
+
+    // a value that does not fit the parameter type is an error, not a truncation
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, i2) VALUES (?, ?)"));
+    q.addBindValue(4);
+    q.addBindValue(100000);
+    QVERIFY(!q.exec());
+
+    tst_Databases::safeDropTable(db, tableName);
+
+    // byte arrays are sent whole to types without a binary conversion in the
+    // driver, such as a domain over bytea, not up to their first NUL
+    const QString domainName = qTableName("psql_bytes", __FILE__, db);
+    q.exec("DROP TABLE " + tableName);
+    q.exec("DROP DOMAIN " + domainName);
+    QVERIFY_SQL(q, exec("CREATE DOMAIN " + domainName + " AS bytea"));
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id int4, ba " + domainName + ")"));
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, ba) VALUES (?, ?)"));
+    q.addBindValue(1);
+    q.addBindValue(bytes);
+    QVERIFY_SQL(q, exec());
+    QVERIFY_SQL(q, exec("SELECT ba::bytea FROM " + tableName + " WHERE id = 1"));
+    QVERIFY_SQL(q, next());
+    QCOMPARE(q.value(0).toByteArray(), bytes);
+
+    tst_Databases::safeDropTable(db, tableName);
+    QVERIFY_SQL(q, exec("DROP DOMAIN " + domainName));
+}
+
+// execBatch() of a prepared INSERT loads the rows with COPY, all or nothing
+void tst_QSqlQuery::psql_copyBatch()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    const QString tableName = qTableName("psql_copy", __FILE__, db);
+    tst_Databases::safeDropTable(db, tableName);
+
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName
+                        + " (id int4 NOT NULL, name varchar(20), value float8, data bytea, ts timestamp)"));
+
+    const int rowCount = 5000;
+    QVariantList ids, names, values, data;
+    for (int i = 0; i < rowCount; ++i) {
+        ids << i;
+        names << (i % 7 ? QVariant(QString("name %1").arg(i)) : QVariant(QVariant::String));
+        values << i / 4.0;
+        data << (i % 5 ? QVariant(QByteArray(i % 100, char(i))) : QVariant(QVariant::ByteArray));
+    }
+
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, name, value, data) VALUES (?, ?, ?, ?)"));
+    q.addBindValue(ids);
+    q.addBindValue(names);
+    q.addBindValue(values);
+    q.addBindValue(data);
+    QVERIFY_SQL(q, execBatch());
+
+    QVERIFY_SQL(q, exec("SELECT id, name, value, data FROM " + tableName + " ORDER BY id"));
+    for (int i = 0; i < rowCount; ++i) {
+        QVERIFY_SQL(q, next());
+        QCOMPARE(q.value(0).toInt(), i);
+        QCOMPARE(q.isNull(1), names.at(i).isNull());
+        QCOMPARE(q.value(1).toString(), names.at(i).toString());
+        QCOMPARE(q.value(2).toDouble(), values.at(i).toDouble());
+        QCOMPARE(q.isNull(3), data.at(i).isNull());
+        QCOMPARE(q.value(3).toByteArray(), data.at(i).toByteArray());
+    }
+    QVERIFY(!q.next());
+
+    // a failing row keeps all of the batch out of the table
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, name) VALUES (?, ?)"));
+    q.addBindValue(QVariantList() << rowCount << QVariant(QVariant::Int) << rowCount + 1);
+    q.addBindValue(QVariantList() << "a" << "b" << "c");
+    QVERIFY(!q.execBatch());
+    QVERIFY_SQL(q, exec("SELECT count(*) FROM " + tableName));
+    QVERIFY_SQL(q, next());
+    QCOMPARE(q.value(0).toInt(), rowCount);
+
+    // timestamps are inserted row by row, converted by the server as for exec()
+    const QDateTime dateTime(QDate(2017, 6, 15), QTime(13, 45, 12, 345));
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, ts) VALUES (?, ?)"));
+    q.addBindValue(QVariantList() << -1 << -2);
+    q.addBindValue(QVariantList() << dateTime << dateTime.addDays(1));
+    QVERIFY_SQL(q, execBatch());
+    QVERIFY_SQL(q, exec("SELECT ts FROM " + tableName + " WHERE id < 0 ORDER BY id DESC"));
+    QVERIFY_SQL(q, next());
+    QCOMPARE(q.value(0).toDateTime(), dateTime);
+    QVERIFY_SQL(q, next());
+    QCOMPARE(q.value(0).toDateTime(), dateTime.addDays(1));
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
+// With the QPSQL_SINGLE_ROW_MODE connect option, forward-only queries stream
+// their rows and have no size; without it nothing changes.
+void tst_QSqlQuery::psql_singleRowMode()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    const QString tableName = qTableName("psql_singlerow", __FILE__, db);
+    tst_Databases::safeDropTable(db, tableName);
+
+    const int rowCount = 1000;
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id int4, name varchar(20))"));
+    QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " SELECT i, 'name ' || i FROM generate_series(0, "
+                        + QString::number(rowCount - 1) + ") AS i"));
+    const QString select = "SELECT id, name FROM " + tableName + " ORDER BY id";
+
+    QVERIFY(db.driver()->hasFeature(QSqlDriver::QuerySize));
+    q.setForwardOnly(true);
+    QVERIFY_SQL(q, exec(select));
+    QCOMPARE(q.size(), rowCount);
+    q.finish();
+
+    {
+        QSqlDatabase streaming = QSqlDatabase::cloneDatabase(db, "psql_singleRowMode");
+        streaming.setConnectOptions(db.connectOptions() + ";QPSQL_SINGLE_ROW_MODE");
+        QVERIFY2(streaming.open(), qPrintable(streaming.lastError().text()));
+        QVERIFY(!streaming.driver()->hasFeature(QSqlDriver::QuerySize));
+
+        for (bool prepared : { false, true }) {
+            QSqlQuery rows(streaming);
+            rows.setForwardOnly(true);
+            if (prepared) {
+                QVERIFY_SQL(rows, prepare("SELECT id, name FROM " + tableName + " WHERE id >= ? ORDER BY id"));
+                rows.addBindValue(0);
+                QVERIFY_SQL(rows, exec());
+            } else {
+                QVERIFY_SQL(rows, exec(select));
+            }
+            QVERIFY(rows.isActive());
+            QVERIFY(rows.isSelect());
+            QCOMPARE(rows.size(), -1);
+            QCOMPARE(rows.record().count(), 2);
+
+            // another query on the connection in the middle of the result
+            // must neither fail nor lose rows
+            QSqlQuery other(streaming);
+            for (int i = 0; i < rowCount; ++i) {
+                QVERIFY_SQL(rows, next());
+                QCOMPARE(rows.value(0).toInt(), i);
+                QCOMPARE(rows.value(1).toString(), QString("name %1").arg(i));
+                if (i == rowCount / 2) {
+                    QVERIFY_SQL(other, exec("SELECT count(*) FROM " + tableName));
+                    QVERIFY_SQL(other, next());
+                    QCOMPARE(other.value(0).toInt(), rowCount);
+                }
+            }
+            QVERIFY(!rows.next());
+            QCOMPARE(rows.at(), int(QSql::AfterLastRow));
+        }
+
+        // not forward-only: the whole result as before
+        QSqlQuery scrollable(streaming);
+        QVERIFY_SQL(scrollable, exec(select));
+        QCOMPARE(scrollable.size(), rowCount);
+        QVERIFY_SQL(scrollable, last());
+        QCOMPARE(scrollable.value(0).toInt(), rowCount - 1);
+
+        // finishing early makes the connection available again
+        QSqlQuery partial(streaming);
+        partial.setForwardOnly(true);
+        QVERIFY_SQL(partial, exec(select));
+        QVERIFY_SQL(partial, next());
+        partial.finish();
+        QVERIFY_SQL(scrollable, exec("SELECT 1"));
+        QVERIFY_SQL(scrollable, next());
+        QCOMPARE(scrollable.value(0).toInt(), 1);
+    }
+    QSqlDatabase::removeDatabase("psql_singleRowMode");
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
 /* For task 157397: Using QSqlQuery with an invalid QSqlDatabase
    does not set the last error of the query.
    This test function will output some warnings, that's ok.
@@ -3890,6 +4178,210 @@ void tst_QSqlQuery::sqlite_real()
     QCOMPARE(q.value(0).toDouble(), 5.6);
 }
 
+// The SQLite driver runs all rows of a batch with one statement, inside one
+// transaction unless the caller has already started one.
+void tst_QSqlQuery::sqlite_batchExec()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName(qTableName("sqlite_batch", __FILE__, db));
+    tst_Databases::safeDropTable(db, tableName);
+
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INTEGER PRIMARY KEY, name TEXT, num REAL)"));
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, name, num) VALUES (?, ?, ?)"));
+    q.addBindValue(QVariantList() << 1 << 2 << 3);
+    q.addBindValue(QVariantList() << "harald" << QVariant(QVariant::String) << "boris");
+    q.addBindValue(QVariantList() << 2.5 << 3.5 << QVariant(QVariant::Double));
+    QVERIFY_SQL(q, execBatch());
+    QCOMPARE(q.numRowsAffected(), 1);
+
+    QVERIFY_SQL(q, exec("SELECT id, name, num FROM " + tableName + " ORDER BY id"));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 1);
+    QCOMPARE(q.value(1).toString(), QString("harald"));
+    QCOMPARE(q.value(2).toDouble(), 2.5);
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 2);
+    QVERIFY(q.value(1).isNull());
+    QCOMPARE(q.value(2).toDouble(), 3.5);
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 3);
+    QCOMPARE(q.value(1).toString(), QString("boris"));
+    QVERIFY(q.value(2).isNull());
+    QVERIFY(!q.next());
+
+    // a failing row rolls back the whole batch
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, name) VALUES (?, ?)"));
+    q.addBindValue(QVariantList() << 4 << 1);
+    q.addBindValue(QVariantList() << "new" << "duplicate");
+    QVERIFY(!q.execBatch());
+    QCOMPARE(q.lastError().type(), QSqlError::StatementError);
+    QVERIFY_SQL(q, exec("SELECT COUNT(*) FROM " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 3);
+
+    // inside the caller's transaction, the caller decides
+    QVERIFY_SQL(db, transaction());
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, name) VALUES (?, ?)"));
+    q.addBindValue(QVariantList() << 4 << 5);
+    q.addBindValue(QVariantList() << "four" << "five");
+    QVERIFY_SQL(q, execBatch());
+    QVERIFY_SQL(db, rollback());
+    QVERIFY_SQL(q, exec("SELECT COUNT(*) FROM " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 3);
+
+    // nothing bound, or lists of different lengths
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " (id, name) VALUES (?, ?)"));
+    QVERIFY(!q.execBatch());
+    QCOMPARE(q.lastError().type(), QSqlError::StatementError);
+    q.addBindValue(QVariantList() << 6 << 7);
+    q.addBindValue(QVariantList() << "six");
+    QVERIFY(!q.execBatch());
+    QCOMPARE(q.lastError().type(), QSqlError::StatementError);
+    QVERIFY_SQL(q, exec("SELECT COUNT(*) FROM " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 3);
+    q.finish();
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
+static const void *sqliteStatement(const QSqlQuery &q)
+{
+    const QVariant handle = q.result()->handle();
+    if (qstrcmp(handle.typeName(), "sqlite3_stmt*") != 0)
+        return 0;
+    return *static_cast<void *const *>(handle.constData());
+}
+
+// Finished statements are kept per connection and used again when the same
+// query is prepared; changes to the schema must still be seen.
+void tst_QSqlQuery::sqlite_statementCache()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName(qTableName("sqlite_stmtcache", __FILE__, db));
+    tst_Databases::safeDropTable(db, tableName);
+
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INTEGER)"));
+    QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " (id) VALUES (1)"));
+
+    const QString select = "SELECT * FROM " + tableName + " WHERE id = ?";
+    const void *statement;
+    {
+        QSqlQuery first(db);
+        QVERIFY_SQL(first, prepare(select));
+        statement = sqliteStatement(first);
+        QVERIFY(statement);
+        first.addBindValue(1);
+        QVERIFY_SQL(first, exec());
+        QVERIFY_SQL(first, next());
+        QCOMPARE(first.record().count(), 1);
+
+        // a statement in use is not handed out twice
+        QSqlQuery concurrent(db);
+        QVERIFY_SQL(concurrent, prepare(select));
+        QVERIFY(sqliteStatement(concurrent) != statement);
+    }
+
+    // the statement comes back reset, without the old bindings
+    QSqlQuery second(db);
+    QVERIFY_SQL(second, prepare(select));
+    QCOMPARE(sqliteStatement(second), statement);
+    second.addBindValue(2);
+    QVERIFY_SQL(second, exec());
+    QVERIFY(!second.next());
+    second.addBindValue(1);
+    QVERIFY_SQL(second, exec());
+    QVERIFY_SQL(second, next());
+    QCOMPARE(second.value(0).toInt(), 1);
+
+    // preparing another query puts it back
+    QVERIFY_SQL(second, prepare("SELECT 1"));
+    QVERIFY_SQL(q, exec("ALTER TABLE " + tableName + " ADD COLUMN name TEXT"));
+    QVERIFY_SQL(q, exec("UPDATE " + tableName + " SET name = 'harald'"));
+
+    QVERIFY_SQL(second, prepare(select));
+    QCOMPARE(sqliteStatement(second), statement);
+    second.addBindValue(1);
+    QVERIFY_SQL(second, exec());
+    QVERIFY_SQL(second, next());
+    QCOMPARE(second.record().count(), 2);
+    QCOMPARE(second.value(1).toString(), QString("harald"));
+
+    // a table dropped and created anew, with other columns
+    second.finish();
+    QVERIFY_SQL(second, prepare("SELECT 1"));
+    tst_Databases::safeDropTable(db, tableName);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INTEGER, num REAL, name TEXT, extra TEXT)"));
+    QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " (id, num, extra) VALUES (1, 2.5, 'x')"));
+    QVERIFY_SQL(second, prepare(select));
+    second.addBindValue(1);
+    QVERIFY_SQL(second, exec());
+    QVERIFY_SQL(second, next());
+    QCOMPARE(second.record().count(), 4);
+    QCOMPARE(second.record().fieldName(1), QString("num"));
+    QCOMPARE(second.value(1).toDouble(), 2.5);
+    QCOMPARE(second.value(3).toString(), QString("x"));
+
+    // without the table, preparing fails as it would without the cache
+    QVERIFY_SQL(second, prepare("SELECT 1"));
+    tst_Databases::safeDropTable(db, tableName);
+    QSqlQuery third(db);
+    QVERIFY(!third.prepare(select) || !third.exec());
+
+    // closing the connection finalizes the cached statements
+    q.clear();
+    second.clear();
+    third.clear();
+    db.close();
+    QVERIFY_SQL(db, open());
+}
+
+void tst_QSqlQuery::sqlite_statementCacheDisabled()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    const QString connectionName = QStringLiteral("sqlite_statementCacheDisabled");
+    {
+        QSqlDatabase uncached = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        uncached.setDatabaseName(":memory:");
+        uncached.setConnectOptions("QSQLITE_STATEMENT_CACHE_SIZE=0");
+        QVERIFY_SQL(uncached, open());
+
+        QSqlQuery q(uncached);
+        QVERIFY_SQL(q, exec("CREATE TABLE cached (id INTEGER)"));
+        QVERIFY_SQL(q, prepare("INSERT INTO cached (id) VALUES (?)"));
+        q.addBindValue(QVariantList() << 1 << 2 << 3);
+        QVERIFY_SQL(q, execBatch());
+
+        // every prepare() compiles the statement anew
+        const QString select = QStringLiteral("SELECT id FROM cached WHERE id > ? ORDER BY id");
+        for (int i = 0; i < 3; ++i) {
+            QSqlQuery other(uncached);
+            QVERIFY_SQL(other, prepare(select));
+            QVERIFY(sqliteStatement(other));
+            other.addBindValue(i);
+            QVERIFY_SQL(other, exec());
+            QVERIFY_SQL(other, next());
+            QCOMPARE(other.value(0).toInt(), i + 1);
+        }
+
+        QVERIFY_SQL(q, exec("ALTER TABLE cached ADD COLUMN name TEXT"));
+        QVERIFY_SQL(q, exec("SELECT * FROM cached"));
+        QVERIFY_SQL(q, next());
+        QCOMPARE(q.record().count(), 2);
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
 void tst_QSqlQuery::aggregateFunctionTypes()
 {
     QFETCH(QString, dbName);
@@ -4167,5 +4659,66 @@ void tst_QSqlQuery::QTBUG_57138()
     QCOMPARE(q.value(2).toDateTime(), tzoffset);
 }
 
+void tst_QSqlQuery::columnarCache()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQuery create(db);
+    const QString tableName = qTableName("qtest_columnar", __FILE__, db);
+
+    // "mixed" has no type, so it keeps both the integers and the strings
+    QVERIFY_SQL(create, exec("create table " + tableName + " (id int, num real, txt varchar(20), mixed)"));
+    QVERIFY_SQL(create, prepare("insert into " + tableName + " (id, num, txt, mixed) values (?, ?, ?, ?)"));
+
+    const int rows = 200;
+    for (int i = 0; i < rows; ++i) {
+        create.addBindValue(i);
+        create.addBindValue(i % 3 ? QVariant(i * 0.25) : QVariant(QVariant::Double));
+        if (i % 5)
+            create.addBindValue(QString::number(i));
+        else
+            create.addBindValue(i % 10 ? QVariant(QString("")) : QVariant(QVariant::String));
+        create.addBindValue(i < rows / 2 ? QVariant(i) : QVariant(QString("row %1").arg(i)));
+        QVERIFY_SQL(create, exec());
+    }
+
+    const QString select = "select id, num, txt, mixed from " + tableName + " order by id";
+    QSqlQuery plain(db);
+    QVERIFY_SQL(plain, exec(select));
+
+    QSqlDatabase columnarDb = QSqlDatabase::cloneDatabase(db, "columnarCache");
+    columnarDb.setConnectOptions("QSQLITE_COLUMNAR_CACHE");
+    QVERIFY2(columnarDb.open(), qPrintable(columnarDb.lastError().text()));
+    QSqlQuery columnar(columnarDb);
+    QVERIFY_SQL(columnar, exec(select));
+
+    // walk backwards, so that every row is read back from the cache
+    QVERIFY(plain.last());
+    QVERIFY(columnar.last());
+    QCOMPARE(columnar.at(), rows - 1);
+    do {
+        QCOMPARE(columnar.at(), plain.at());
+        for (int i = 0; i < 4; ++i) {
+            QCOMPARE(columnar.isNull(i), plain.isNull(i));
+            QCOMPARE(columnar.value(i).userType(), plain.value(i).userType());
+            QCOMPARE(columnar.value(i), plain.value(i));
+        }
+    } while (plain.previous() && columnar.previous());
+    QCOMPARE(plain.at(), int(QSql::BeforeFirstRow));
+    QCOMPARE(columnar.at(), 0);
+
+    QVERIFY(columnar.seek(rows / 2));
+    QCOMPARE(columnar.value(3).toString(), QString("row %1").arg(rows / 2));
+    QVERIFY(columnar.seek(5));
+    QCOMPARE(columnar.value(2).toString(), QString(""));
+    QVERIFY(!columnar.value(2).isNull());
+
+    columnar = QSqlQuery();
+    columnarDb = QSqlDatabase();
+    QSqlDatabase::removeDatabase("columnarCache");
+}
+
 QTEST_MAIN( tst_QSqlQuery )
 #include "tst_qsqlquery.moc"
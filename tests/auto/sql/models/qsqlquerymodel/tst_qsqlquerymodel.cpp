@@ -70,6 +70,8 @@ private slots:
     void setHeaderData();
     void fetchMore_data() { generic_data(); }
     void fetchMore();
+    void windowed_data() { generic_data(); }
+    void windowed();
 
     //problem specific tests
     void withSortFilterProxyModel_data() { generic_data(); }
@@ -532,6 +534,49 @@ void tst_QSqlQueryModel::withSortFilterProxyModel()
     QCOMPARE(modelRowsInsertedSpy.value(0).value(2).toInt(), 510);
 }
 
+void tst_QSqlQueryModel::windowed()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQueryModel model;
+    model.setWindowSize(100);
+    QCOMPARE(model.windowSize(), 100);
+    QSqlQuery query("select id, name from " + qTableName("many", __FILE__, db) + " order by id", db);
+    model.setQuery(query);
+    QVERIFY(!model.lastError().isValid());
+    if (db.driverName().startsWith("QSQLITE") && db.databaseName() == QLatin1String(":memory:")) {
+        // another connection can't see the rows, so they are all kept
+        QVERIFY(query.isActive());
+        while (model.canFetchMore())
+            model.fetchMore();
+        QCOMPARE(model.rowCount(), 2048);
+        QCOMPARE(model.data(model.index(1500, 0)).toInt(), 1500);
+        return;
+    }
+    // the model reads the rows on its own connection
+    QVERIFY(!query.isActive());
+    QCOMPARE(model.columnCount(), 2);
+    QVERIFY(!model.canFetchMore());
+    QTRY_COMPARE(model.rowCount(), 2048);
+
+    // rows outside of the window are fetched in the background
+    QSignalSpy dataChangedSpy(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+    for (int row : {0, 1500, 99, 2047, 10}) {
+        const QModelIndex index = model.index(row, 0);
+        model.data(index);
+        QTRY_VERIFY(model.data(index).isValid());
+        QCOMPARE(model.data(index).toInt(), row);
+        QCOMPARE(model.data(model.index(row, 1)).toString(), QString("harry"));
+        QCOMPARE(model.record(row).value(0).toInt(), row);
+    }
+    QVERIFY(dataChangedSpy.count() >= 5);
+
+    model.clear();
+    QCOMPARE(model.rowCount(), 0);
+}
+
 // For task 155402: When the model is already empty when setQuery() is called
 // no rows have to be removed and rowsAboutToBeRemoved and rowsRemoved should
 // not be emitted.
@@ -1,5 +1,6 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+        qdbusmarshall \
         qdbustype
 
 qtConfig(process): SUBDIRS += \
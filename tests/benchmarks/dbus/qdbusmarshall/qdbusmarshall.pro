@@ -0,0 +1,5 @@
+TARGET = tst_bench_qdbusmarshall
+QT -= gui
+QT += dbus testlib
+
+SOURCES += tst_qdbusmarshall.cpp
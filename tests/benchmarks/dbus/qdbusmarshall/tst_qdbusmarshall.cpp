@@ -0,0 +1,250 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtDBus/QtDBus>
+
+static const char objectPath[] = "/org/qtproject/benchmarks/qdbusmarshall";
+static const char interfaceName[] = "org.qtproject.benchmarks.qdbusmarshall";
+
+// Sends every call back to its sender.
+class Echo : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.qtproject.benchmarks.qdbusmarshall")
+public slots:
+    void echo(const QDBusMessage &message)
+    {
+        setDelayedReply(true);
+        connection().send(message.createReply(message.arguments()));
+    }
+};
+
+class tst_QDBusMarshall : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Payload {
+        ByteArray,
+        IntVector,
+        IntList,
+        DoubleVector,
+        VariantMap
+    };
+    Q_ENUM(Payload)
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void marshall_data();
+    void marshall();
+    void demarshall_data();
+    void demarshall();
+    void roundTrip_data();
+    void roundTrip();
+
+private:
+    QDBusMessage callEcho(const QDBusMessage &call);
+
+    Echo echoObject;
+    QDBusServer *server;
+    QDBusConnection peer = QDBusConnection(QString());
+};
+
+void tst_QDBusMarshall::initTestCase()
+{
+    qDBusRegisterMetaType<QVector<int> >();
+    qDBusRegisterMetaType<QVector<double> >();
+
+    server = new QDBusServer;
+    if (!server->isConnected())
+        QSKIP("Cannot create a D-Bus server");
+    connect(server, &QDBusServer::newConnection, this, [this](const QDBusConnection &connection) {
+        QDBusConnection(connection).registerObject(objectPath, &echoObject, QDBusConnection::ExportAllSlots);
+        QTestEventLoop::instance().exitLoop();
+    });
+    peer = QDBusConnection::connectToPeer(server->address(), QStringLiteral("echo"));
+    QTestEventLoop::instance().enterLoop(5);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QVERIFY(peer.isConnected());
+}
+
+void tst_QDBusMarshall::cleanupTestCase()
+{
+    QDBusConnection::disconnectFromPeer(QStringLiteral("echo"));
+    delete server;
+}
+
+// The echo object lives in this thread, so the reply is waited for in an
+// event loop rather than with a blocking call.
+QDBusMessage tst_QDBusMarshall::callEcho(const QDBusMessage &call)
+{
+    QDBusPendingCallWatcher watcher(peer.asyncCall(call));
+    QEventLoop loop;
+    connect(&watcher, &QDBusPendingCallWatcher::finished, &loop, &QEventLoop::quit);
+    loop.exec();
+    return watcher.reply();
+}
+
+static QVariant payloadValue(tst_QDBusMarshall::Payload payload, int size)
+{
+    switch (payload) {
+    case tst_QDBusMarshall::ByteArray:
+        return QByteArray(size, 'x');
+    case tst_QDBusMarshall::IntVector:
+        return QVariant::fromValue(QVector<int>(size, 42));
+    case tst_QDBusMarshall::IntList: {
+        QList<int> list;
+        list.reserve(size);
+        for (int i = 0; i < size; ++i)
+            list.append(i);
+        return QVariant::fromValue(list);
+    }
+    case tst_QDBusMarshall::DoubleVector:
+        return QVariant::fromValue(QVector<double>(size, 0.5));
+    case tst_QDBusMarshall::VariantMap: {
+        QVariantMap map;
+        for (int i = 0; i < size; ++i) {
+            const QString key = QString::number(i);
+            switch (i % 3) {
+            case 0: map.insert(key, i); break;
+            case 1: map.insert(key, key); break;
+            case 2: map.insert(key, QByteArray(64, 'x')); break;
+            }
+        }
+        return map;
+    }
+    }
+    return QVariant();
+}
+
+// A structure holding the value, so that it is not demarshalled on arrival.
+static QDBusArgument structure(const QVariant &value)
+{
+    QDBusArgument arg;
+    arg.beginStructure();
+    arg.appendVariant(value);
+    arg.endStructure();
+    return arg;
+}
+
+void tst_QDBusMarshall::marshall_data()
+{
+    QTest::addColumn<Payload>("payload");
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("ay-64k") << ByteArray << 65536;
+    QTest::newRow("ai-vector-1k") << IntVector << 1024;
+    QTest::newRow("ai-vector-256k") << IntVector << 262144;
+    QTest::newRow("ai-list-1k") << IntList << 1024;
+    QTest::newRow("ai-list-256k") << IntList << 262144;
+    QTest::newRow("ad-vector-256k") << DoubleVector << 262144;
+    QTest::newRow("a{sv}-10") << VariantMap << 10;
+    QTest::newRow("a{sv}-1000") << VariantMap << 1000;
+}
+
+void tst_QDBusMarshall::marshall()
+{
+    QFETCH(Payload, payload);
+    QFETCH(int, size);
+
+    const QVariant value = payloadValue(payload, size);
+    QBENCHMARK {
+        structure(value);
+    }
+}
+
+void tst_QDBusMarshall::demarshall_data()
+{
+    marshall_data();
+}
+
+void tst_QDBusMarshall::demarshall()
+{
+    QFETCH(Payload, payload);
+    QFETCH(int, size);
+
+    QDBusMessage call = QDBusMessage::createMethodCall(QString(), objectPath, interfaceName, "echo");
+    call << QVariant::fromValue(structure(payloadValue(payload, size)));
+    const QDBusMessage reply = callEcho(call);
+    QCOMPARE(reply.type(), QDBusMessage::ReplyMessage);
+    const QDBusArgument received = qvariant_cast<QDBusArgument>(reply.arguments().at(0));
+
+    int count = 0;
+    QBENCHMARK {
+        // reading advances the argument, so read from a copy
+        const QDBusArgument arg = received;
+        arg.beginStructure();
+        switch (payload) {
+        case ByteArray:
+            count = qdbus_cast<QByteArray>(arg).size();
+            break;
+        case IntVector:
+            count = qdbus_cast<QVector<int> >(arg).size();
+            break;
+        case IntList:
+            count = qdbus_cast<QList<int> >(arg).size();
+            break;
+        case DoubleVector:
+            count = qdbus_cast<QVector<double> >(arg).size();
+            break;
+        case VariantMap:
+            count = qdbus_cast<QVariantMap>(arg).size();
+            break;
+        }
+        arg.endStructure();
+    }
+    QCOMPARE(count, size);
+}
+
+void tst_QDBusMarshall::roundTrip_data()
+{
+    marshall_data();
+}
+
+// The complete call to the peer: marshalling, sending, demarshalling and
+// marshalling the reply and demarshalling it.
+void tst_QDBusMarshall::roundTrip()
+{
+    QFETCH(Payload, payload);
+    QFETCH(int, size);
+
+    QDBusMessage call = QDBusMessage::createMethodCall(QString(), objectPath, interfaceName, "echo");
+    call << QVariant::fromValue(structure(payloadValue(payload, size)));
+
+    QBENCHMARK {
+        const QDBusMessage reply = callEcho(call);
+        QCOMPARE(reply.type(), QDBusMessage::ReplyMessage);
+    }
+}
+
+QTEST_MAIN(tst_QDBusMarshall)
+
+#include "tst_qdbusmarshall.moc"
@@ -1,6 +1,7 @@
 TEMPLATE = subdirs
 SUBDIRS = \
         blendbench \
+        qimagecache \
         qimageconversion \
         qimagereader \
         qimagescale \
@@ -0,0 +1,150 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QCache>
+#include <QImageCache>
+#include <QMutex>
+#include <QThread>
+
+class tst_QImageCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void concurrentInsertFind_data();
+    void concurrentInsertFind();
+};
+
+static const int keyCount = 1000;
+static const int operationsPerThread = 200000;
+
+// What a QCache shared between threads needs: one lock around everything
+class LockedCache
+{
+public:
+    LockedCache() : cache(keyCount / 2) {}
+
+    bool find(const QString &key, QImage *image)
+    {
+        QMutexLocker locker(&mutex);
+        const QImage *cached = cache.object(key);
+        if (!cached)
+            return false;
+        *image = *cached;
+        return true;
+    }
+
+    void insert(const QString &key, const QImage &image)
+    {
+        QMutexLocker locker(&mutex);
+        cache.insert(key, new QImage(image));
+    }
+
+private:
+    QMutex mutex;
+    QCache<QString, QImage> cache;
+};
+
+template <typename Cache>
+class Worker : public QThread
+{
+public:
+    Worker(Cache *cache, const QVector<QString> &keys, const QImage &image, int seed)
+        : cache(cache), keys(keys), image(image), seed(seed) {}
+
+    void run() override
+    {
+        // one insertion for every nine lookups, over keys that do not all fit
+        uint state = uint(seed) * 2654435761u + 1;
+        QImage found;
+        for (int i = 0; i < operationsPerThread; ++i) {
+            state = state * 1103515245u + 12345u;
+            const QString &key = keys.at((state >> 8) % keyCount);
+            if ((state >> 4) % 10 == 0 || !cache->find(key, &found))
+                cache->insert(key, image);
+        }
+    }
+
+private:
+    Cache *cache;
+    const QVector<QString> &keys;
+    QImage image;
+    int seed;
+};
+
+template <typename Cache>
+static void runWorkers(Cache *cache, const QVector<QString> &keys, const QImage &image, int threadCount)
+{
+    QVector<QThread *> workers;
+    for (int i = 0; i < threadCount; ++i)
+        workers << new Worker<Cache>(cache, keys, image, i);
+    for (QThread *worker : qAsConst(workers))
+        worker->start();
+    for (QThread *worker : qAsConst(workers))
+        worker->wait();
+    qDeleteAll(workers);
+}
+
+void tst_QImageCache::concurrentInsertFind_data()
+{
+    QTest::addColumn<bool>("sharded");
+    QTest::addColumn<int>("threadCount");
+
+    for (int threadCount = 1; threadCount <= 8; threadCount *= 2) {
+        const QByteArray threads = QByteArray::number(threadCount) + " threads";
+        QTest::newRow("QCache + QMutex, " + threads) << false << threadCount;
+        QTest::newRow("QImageCache, " + threads) << true << threadCount;
+    }
+}
+
+void tst_QImageCache::concurrentInsertFind()
+{
+    QFETCH(bool, sharded);
+    QFETCH(int, threadCount);
+
+    QVector<QString> keys;
+    for (int i = 0; i < keyCount; ++i)
+        keys << QLatin1String("image") + QString::number(i);
+    QImage image(16, 16, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::red);
+
+    QBENCHMARK {
+        if (sharded) {
+            QImageCache cache;
+            cache.setMaxCost(keyCount / 2 * image.sizeInBytes());
+            runWorkers(&cache, keys, image, threadCount);
+        } else {
+            LockedCache cache;
+            runWorkers(&cache, keys, image, threadCount);
+        }
+    }
+}
+
+QTEST_MAIN(tst_QImageCache)
+#include "tst_qimagecache.moc"
@@ -56,6 +56,9 @@ private slots:
     void convertGenericInplace_data();
     void convertGenericInplace();
 
+    void convertLarge_data();
+    void convertLarge();
+
 private:
     QImage generateImageRgb888(int width, int height);
     QImage generateImageRgb16(int width, int height);
@@ -354,6 +357,42 @@ void tst_QImageConversion::convertGenericInplace()
     }
 }
 
+void tst_QImageConversion::convertLarge_data()
+{
+    QTest::addColumn<QImage>("inputImage");
+    QTest::addColumn<QImage::Format>("outputFormat");
+    QTest::addColumn<bool>("threaded");
+
+    // 24 megapixels, the size of a typical camera picture.
+    QImage argb32 = generateImageArgb32(6000, 4000);
+    QImage rgb888 = argb32.convertToFormat(QImage::Format_RGB888);
+    QImage rgba8888 = argb32.convertToFormat(QImage::Format_RGBA8888);
+
+    for (bool threaded : { false, true }) {
+        const char *mode = threaded ? "threaded" : "single";
+        QTest::addRow("6000x4000 argb32 -> argb32pm, %s", mode) << argb32 << QImage::Format_ARGB32_Premultiplied << threaded;
+        QTest::addRow("6000x4000 rgb888 -> rgb32, %s", mode) << rgb888 << QImage::Format_RGB32 << threaded;
+        QTest::addRow("6000x4000 rgba8888 -> argb32, %s", mode) << rgba8888 << QImage::Format_ARGB32 << threaded;
+        QTest::addRow("6000x4000 argb32 -> rgb16, %s", mode) << argb32 << QImage::Format_RGB16 << threaded;
+        QTest::addRow("6000x4000 argb32 -> rgb30, %s", mode) << argb32 << QImage::Format_RGB30 << threaded;
+    }
+}
+
+void tst_QImageConversion::convertLarge()
+{
+    QFETCH(QImage, inputImage);
+    QFETCH(QImage::Format, outputFormat);
+    QFETCH(bool, threaded);
+
+    if (!threaded)
+        qputenv("QT_IMAGE_MAX_THREADS", "1");
+    QBENCHMARK {
+        QImage output = inputImage.convertToFormat(outputFormat);
+        output.constBits();
+    }
+    qunsetenv("QT_IMAGE_MAX_THREADS");
+}
+
 /*
  Fill a RGB888 image with "random" pixel values.
  */
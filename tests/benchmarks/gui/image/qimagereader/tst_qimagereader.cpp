@@ -37,6 +37,7 @@
 #include <QSet>
 #include <QTcpSocket>
 #include <QTcpServer>
+#include <QTemporaryDir>
 #include <QTimer>
 
 typedef QMap<QString, QString> QStringMap;
@@ -69,6 +70,23 @@ private slots:
     void setScaledClipRect_data();
     void setScaledClipRect();
 
+    void timeToFirstPixels_data();
+    void timeToFirstPixels();
+
+    void readIncrementally_data();
+    void readIncrementally();
+
+#if defined QTEST_HAVE_JPEG
+    void jpegScaledSize_data();
+    void jpegScaledSize();
+
+    void jpegClipRect_data();
+    void jpegClipRect();
+
+    void readThumbnails_data();
+    void readThumbnails();
+#endif
+
 private:
     QList< QPair<QString, QByteArray> > images; // filename, format
 };
@@ -215,5 +233,241 @@ void tst_QImageReader::setScaledClipRect()
     }
 }
 
+// sequential device that hands out the data fed to it so far, like a
+// network reply does
+class IncrementalDevice : public QIODevice
+{
+public:
+    IncrementalDevice() { open(QIODevice::ReadOnly); }
+
+    void feed(const QByteArray &data) { pending += data; }
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override { return pending.size() + QIODevice::bytesAvailable(); }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        const int n = int(qMin<qint64>(maxSize, pending.size()));
+        memcpy(data, pending.constData(), n);
+        pending.remove(0, n);
+        return n;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    QByteArray pending;
+};
+
+static void addIncrementalRows()
+{
+    QList<QPair<QString, QByteArray> > files;
+    files << qMakePair(QStringLiteral("kollada.png"), QByteArray());
+#if defined QTEST_HAVE_GIF
+    files << qMakePair(QStringLiteral("earth.gif"), QByteArray());
+    files << qMakePair(QStringLiteral("trolltech.gif"), QByteArray());
+#endif
+
+    QImage large(2048, 2048, QImage::Format_ARGB32);
+    for (int y = 0; y < large.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(large.scanLine(y));
+        for (int x = 0; x < large.width(); ++x)
+            line[x] = qRgba(x, y, x ^ y, 255 - (y >> 3));
+    }
+    QByteArray largePng;
+    QBuffer buffer(&largePng);
+    buffer.open(QIODevice::WriteOnly);
+    large.save(&buffer, "png");
+    files << qMakePair(QStringLiteral("2048x2048.png"), largePng);
+
+    for (int i = 0; i < files.size(); ++i) {
+        QByteArray data = files.at(i).second;
+        if (data.isEmpty()) {
+            QFile file("images/" + files.at(i).first);
+            if (!file.open(QIODevice::ReadOnly))
+                continue;
+            data = file.readAll();
+        }
+        const QByteArray name = files.at(i).first.toLatin1();
+        QTest::newRow(name + ", read()") << data << false;
+        QTest::newRow(name + ", readIncrementally()") << data << true;
+    }
+}
+
+void tst_QImageReader::timeToFirstPixels_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<bool>("incremental");
+
+    addIncrementalRows();
+}
+
+// Time until the first rows of an image arriving in 16 KB pieces can be
+// shown. A blocking read() has to wait for the whole image.
+void tst_QImageReader::timeToFirstPixels()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(bool, incremental);
+    const int chunkSize = 16 * 1024;
+
+    QBENCHMARK {
+        IncrementalDevice device;
+        QImageReader reader(&device);
+        QImage image;
+        if (incremental) {
+            QRect updated;
+            for (int pos = 0; updated.isEmpty(); pos += chunkSize) {
+                QVERIFY(pos < data.size());
+                device.feed(data.mid(pos, chunkSize));
+                QVERIFY(reader.readIncrementally(&image, &updated));
+            }
+        } else {
+            device.feed(data);
+            QVERIFY(reader.read(&image));
+        }
+    }
+}
+
+void tst_QImageReader::readIncrementally_data()
+{
+    timeToFirstPixels_data();
+}
+
+// Cost of decoding the whole image in 16 KB pieces compared to one read()
+void tst_QImageReader::readIncrementally()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(bool, incremental);
+    const int chunkSize = 16 * 1024;
+
+    QBENCHMARK {
+        IncrementalDevice device;
+        QImageReader reader(&device);
+        QImage image;
+        if (incremental) {
+            for (int pos = 0; pos < data.size() && !reader.isIncrementalReadFinished(); pos += chunkSize) {
+                device.feed(data.mid(pos, chunkSize));
+                QVERIFY(reader.readIncrementally(&image));
+            }
+        } else {
+            device.feed(data);
+            QVERIFY(reader.read(&image));
+        }
+        QVERIFY(!image.isNull());
+    }
+}
+
+#if defined QTEST_HAVE_JPEG
+static QByteArray largeJpeg()
+{
+    QImage large(3000, 2000, QImage::Format_RGB32);
+    for (int y = 0; y < large.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(large.scanLine(y));
+        for (int x = 0; x < large.width(); ++x)
+            line[x] = qRgb(x, y, (x * y) >> 8);
+    }
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    large.save(&buffer, "jpeg", 90);
+    return data;
+}
+
+void tst_QImageReader::jpegScaledSize_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QSize>("size");
+
+    const QByteArray data = largeJpeg();
+    QTest::newRow("3000x2000, no scaling") << data << QSize(3000, 2000);
+    QTest::newRow("3000x2000 -> 1500x1000") << data << QSize(1500, 1000);
+    QTest::newRow("3000x2000 -> 1000x667") << data << QSize(1000, 667);
+    QTest::newRow("3000x2000 -> 640x427") << data << QSize(640, 427);
+    QTest::newRow("3000x2000 -> 160x107") << data << QSize(160, 107);
+}
+
+void tst_QImageReader::jpegScaledSize()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QSize, size);
+
+    QBENCHMARK {
+        QBuffer buffer(&data);
+        QImageReader reader(&buffer, "jpeg");
+        reader.setScaledSize(size);
+        QImage image = reader.read();
+        QCOMPARE(image.size(), size);
+    }
+}
+
+void tst_QImageReader::jpegClipRect_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QRect>("rect");
+
+    const QByteArray data = largeJpeg();
+    QTest::newRow("whole image") << data << QRect(0, 0, 3000, 2000);
+    QTest::newRow("top left") << data << QRect(0, 0, 256, 256);
+    QTest::newRow("center") << data << QRect(1372, 872, 256, 256);
+    QTest::newRow("bottom right") << data << QRect(2744, 1744, 256, 256);
+    QTest::newRow("column") << data << QRect(1500, 0, 100, 2000);
+}
+
+void tst_QImageReader::jpegClipRect()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QRect, rect);
+
+    QBENCHMARK {
+        QBuffer buffer(&data);
+        QImageReader reader(&buffer, "jpeg");
+        reader.setClipRect(rect);
+        QImage image = reader.read();
+        QCOMPARE(image.size(), rect.size());
+    }
+}
+
+void tst_QImageReader::readThumbnails_data()
+{
+    QTest::addColumn<bool>("parallel");
+
+    QTest::newRow("sequential") << false;
+    QTest::newRow("readThumbnails()") << true;
+}
+
+// Thumbnails of a directory of photos, one at a time or with readThumbnails()
+void tst_QImageReader::readThumbnails()
+{
+    QFETCH(bool, parallel);
+    const QSize size(160, 160);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QByteArray data = largeJpeg();
+    QStringList fileNames;
+    for (int i = 0; i < 16; ++i) {
+        QFile file(dir.path() + QLatin1Char('/') + QString::number(i) + QLatin1String(".jpg"));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(data);
+        fileNames << file.fileName();
+    }
+
+    QBENCHMARK {
+        QVector<QImage> thumbnails;
+        if (parallel) {
+            thumbnails = QImageReader::readThumbnails(fileNames, size);
+        } else {
+            for (const QString &fileName : qAsConst(fileNames)) {
+                QImageReader reader(fileName);
+                reader.setScaledSize(reader.size().scaled(size, Qt::KeepAspectRatio));
+                thumbnails << reader.read();
+            }
+        }
+        QCOMPARE(thumbnails.size(), fileNames.size());
+        QCOMPARE(thumbnails.last().size(), QSize(160, 106));
+    }
+}
+#endif
+
 QTEST_MAIN(tst_QImageReader)
 #include "tst_qimagereader.moc"
@@ -39,6 +39,9 @@ private slots:
     void scaleArgb32pm_data();
     void scaleArgb32pm();
 
+    void scaleLarge_data();
+    void scaleLarge();
+
 private:
     QImage generateImageRgb32(int width, int height);
     QImage generateImageArgb32(int width, int height);
@@ -100,6 +103,39 @@ void tst_QImageScale::scaleArgb32pm()
     }
 }
 
+void tst_QImageScale::scaleLarge_data()
+{
+    QTest::addColumn<QImage>("inputImage");
+    QTest::addColumn<QSize>("outputSize");
+    QTest::addColumn<bool>("threaded");
+
+    // 24 megapixels, the size of a typical camera picture.
+    QImage rgb32 = generateImageRgb32(6000, 4000);
+    QImage argb32pm = generateImageArgb32(6000, 4000).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    for (bool threaded : { false, true }) {
+        const char *mode = threaded ? "threaded" : "single";
+        QTest::addRow("rgb32 6000x4000 -> 1920x1280, %s", mode) << rgb32 << QSize(1920, 1280) << threaded;
+        QTest::addRow("rgb32 6000x4000 -> 8000x6000, %s", mode) << rgb32 << QSize(8000, 6000) << threaded;
+        QTest::addRow("argb32pm 6000x4000 -> 1920x1280, %s", mode) << argb32pm << QSize(1920, 1280) << threaded;
+    }
+}
+
+void tst_QImageScale::scaleLarge()
+{
+    QFETCH(QImage, inputImage);
+    QFETCH(QSize, outputSize);
+    QFETCH(bool, threaded);
+
+    if (!threaded)
+        qputenv("QT_IMAGE_MAX_THREADS", "1");
+    QBENCHMARK {
+        QImage output = inputImage.scaled(outputSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        output.constBits();
+    }
+    qunsetenv("QT_IMAGE_MAX_THREADS");
+}
+
 /*
  Fill a RGB32 image with "random" pixel values.
  */
@@ -0,0 +1,313 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+// This file contains benchmarks for the raster engine's per-format fetch and
+// store functions and its composition and gradient functions. Compare runs
+// with QT_NO_CPU_FEATURE set (for instance to "avx2 avx512f") to measure the
+// SIMD versions against each other.
+
+#include <qtest.h>
+#include <QtGui/QImage>
+#include <QtGui/QLinearGradient>
+#include <QtGui/QPainter>
+
+Q_DECLARE_METATYPE(QImage::Format)
+Q_DECLARE_METATYPE(QPainter::CompositionMode)
+Q_DECLARE_METATYPE(QGradient::Type)
+Q_DECLARE_METATYPE(QGradient::Spread)
+
+static const int ImageSize = 512;
+
+static const struct {
+    QImage::Format format;
+    const char *name;
+} imageFormats[] = {
+    { QImage::Format_Mono, "Mono" },
+    { QImage::Format_MonoLSB, "MonoLSB" },
+    { QImage::Format_Indexed8, "Indexed8" },
+    { QImage::Format_RGB32, "RGB32" },
+    { QImage::Format_ARGB32, "ARGB32" },
+    { QImage::Format_ARGB32_Premultiplied, "ARGB32_Premultiplied" },
+    { QImage::Format_RGB16, "RGB16" },
+    { QImage::Format_ARGB8565_Premultiplied, "ARGB8565_Premultiplied" },
+    { QImage::Format_RGB666, "RGB666" },
+    { QImage::Format_ARGB6666_Premultiplied, "ARGB6666_Premultiplied" },
+    { QImage::Format_RGB555, "RGB555" },
+    { QImage::Format_ARGB8555_Premultiplied, "ARGB8555_Premultiplied" },
+    { QImage::Format_RGB888, "RGB888" },
+    { QImage::Format_RGB444, "RGB444" },
+    { QImage::Format_ARGB4444_Premultiplied, "ARGB4444_Premultiplied" },
+    { QImage::Format_RGBX8888, "RGBX8888" },
+    { QImage::Format_RGBA8888, "RGBA8888" },
+    { QImage::Format_RGBA8888_Premultiplied, "RGBA8888_Premultiplied" },
+    { QImage::Format_BGR30, "BGR30" },
+    { QImage::Format_A2BGR30_Premultiplied, "A2BGR30_Premultiplied" },
+    { QImage::Format_RGB30, "RGB30" },
+    { QImage::Format_A2RGB30_Premultiplied, "A2RGB30_Premultiplied" },
+    { QImage::Format_Alpha8, "Alpha8" },
+    { QImage::Format_Grayscale8, "Grayscale8" }
+};
+
+static const char *compositionModeNames[] = {
+    "SourceOver", "DestinationOver", "Clear", "Source", "Destination",
+    "SourceIn", "DestinationIn", "SourceOut", "DestinationOut",
+    "SourceAtop", "DestinationAtop", "Xor", "Plus", "Multiply", "Screen",
+    "Overlay", "Darken", "Lighten", "ColorDodge", "ColorBurn",
+    "HardLight", "SoftLight", "Difference", "Exclusion"
+};
+
+// The destination formats that the composition functions write through: the
+// 32-bit ARGB32_Premultiplied pipeline and the 64-bit one used for formats
+// with more than 8 bits per color channel.
+static const QImage::Format compositionFormats[] = {
+    QImage::Format_ARGB32_Premultiplied,
+    QImage::Format_A2RGB30_Premultiplied
+};
+
+static const char *formatName(QImage::Format format)
+{
+    for (const auto &entry : imageFormats) {
+        if (entry.format == format)
+            return entry.name;
+    }
+    return "Unknown";
+}
+
+static QImage createImage(QImage::Format format, bool translucent)
+{
+    QImage image(ImageSize, ImageSize, QImage::Format_ARGB32_Premultiplied);
+    QPainter p(&image);
+    p.setCompositionMode(QPainter::CompositionMode_Source);
+    QLinearGradient gradient(0, 0, ImageSize, ImageSize);
+    gradient.setColorAt(0, QColor(255, 0, 0, translucent ? 50 : 255));
+    gradient.setColorAt(0.5, QColor(0, 255, 0, translucent ? 200 : 255));
+    gradient.setColorAt(1, QColor(0, 0, 255, translucent ? 120 : 255));
+    p.fillRect(image.rect(), gradient);
+    p.end();
+    return image.convertToFormat(format);
+}
+
+class tst_DrawHelper : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fetch_data();
+    void fetch();
+    void store_data();
+    void store();
+    void compositionMode_data();
+    void compositionMode();
+    void solidCompositionMode_data();
+    void solidCompositionMode();
+    void gradient_data();
+    void gradient();
+};
+
+// Draws every source format onto ARGB32_Premultiplied, which goes through
+// the source format's fetch and conversion functions.
+void tst_DrawHelper::fetch_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+    QTest::addColumn<bool>("transformed");
+
+    for (const auto &entry : imageFormats) {
+        QTest::newRow(entry.name) << entry.format << false;
+        QTest::newRow(QByteArray(entry.name) + ", scaled") << entry.format << true;
+    }
+}
+
+void tst_DrawHelper::fetch()
+{
+    QFETCH(QImage::Format, format);
+    QFETCH(bool, transformed);
+
+    const QImage source = createImage(format, true);
+    QImage destination(ImageSize, ImageSize, QImage::Format_ARGB32_Premultiplied);
+    destination.fill(Qt::white);
+
+    QBENCHMARK {
+        QPainter p(&destination);
+        p.setCompositionMode(QPainter::CompositionMode_Source);
+        if (transformed) {
+            p.setRenderHint(QPainter::SmoothPixmapTransform);
+            p.drawImage(QRectF(0, 0, ImageSize, ImageSize), source, QRectF(0, 0, ImageSize * 0.8, ImageSize * 0.8));
+        } else {
+            p.drawImage(0, 0, source);
+        }
+    }
+}
+
+// Blends a translucent ARGB32_Premultiplied image onto every destination
+// format, which goes through the destination format's fetch and store
+// functions.
+void tst_DrawHelper::store_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+
+    for (const auto &entry : imageFormats) {
+        // Painting on these formats is not supported.
+        if (entry.format == QImage::Format_Mono || entry.format == QImage::Format_MonoLSB
+                || entry.format == QImage::Format_Indexed8)
+            continue;
+        QTest::newRow(entry.name) << entry.format;
+    }
+}
+
+void tst_DrawHelper::store()
+{
+    QFETCH(QImage::Format, format);
+
+    const QImage source = createImage(QImage::Format_ARGB32_Premultiplied, true);
+    QImage destination = createImage(format, false);
+
+    QBENCHMARK {
+        QPainter p(&destination);
+        p.drawImage(0, 0, source);
+    }
+}
+
+void tst_DrawHelper::compositionMode_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+    QTest::addColumn<QPainter::CompositionMode>("mode");
+    QTest::addColumn<qreal>("opacity");
+
+    for (QImage::Format format : compositionFormats) {
+        for (int mode = QPainter::CompositionMode_SourceOver; mode <= QPainter::CompositionMode_Exclusion; ++mode) {
+            for (qreal opacity : { qreal(1), qreal(0.5) }) {
+                QTest::addRow("%s, %s, opacity %g", formatName(format), compositionModeNames[mode], opacity)
+                        << format << QPainter::CompositionMode(mode) << opacity;
+            }
+        }
+    }
+}
+
+void tst_DrawHelper::compositionMode()
+{
+    QFETCH(QImage::Format, format);
+    QFETCH(QPainter::CompositionMode, mode);
+    QFETCH(qreal, opacity);
+
+    // Use a source format that needs no conversion, so that the time is spent
+    // in the composition function.
+    const QImage source = createImage(format, true);
+    QImage destination = createImage(format, false);
+
+    QBENCHMARK {
+        QPainter p(&destination);
+        p.setCompositionMode(mode);
+        p.setOpacity(opacity);
+        p.drawImage(0, 0, source);
+    }
+}
+
+void tst_DrawHelper::solidCompositionMode_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+    QTest::addColumn<QPainter::CompositionMode>("mode");
+
+    for (QImage::Format format : compositionFormats) {
+        for (int mode = QPainter::CompositionMode_SourceOver; mode <= QPainter::CompositionMode_Exclusion; ++mode) {
+            QTest::addRow("%s, %s", formatName(format), compositionModeNames[mode])
+                    << format << QPainter::CompositionMode(mode);
+        }
+    }
+}
+
+void tst_DrawHelper::solidCompositionMode()
+{
+    QFETCH(QImage::Format, format);
+    QFETCH(QPainter::CompositionMode, mode);
+
+    QImage destination = createImage(format, false);
+
+    QBENCHMARK {
+        QPainter p(&destination);
+        p.setCompositionMode(mode);
+        p.fillRect(destination.rect(), QColor(40, 160, 220, 140));
+    }
+}
+
+void tst_DrawHelper::gradient_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+    QTest::addColumn<QGradient::Type>("type");
+    QTest::addColumn<QGradient::Spread>("spread");
+
+    static const char *typeNames[] = { "linear", "radial", "conical" };
+    static const char *spreadNames[] = { "pad", "reflect", "repeat" };
+
+    for (QImage::Format format : compositionFormats) {
+        for (int type = QGradient::LinearGradient; type <= QGradient::ConicalGradient; ++type) {
+            for (int spread = QGradient::PadSpread; spread <= QGradient::RepeatSpread; ++spread) {
+                // Conical gradients do not have a spread.
+                if (type == QGradient::ConicalGradient && spread != QGradient::PadSpread)
+                    continue;
+                QTest::addRow("%s, %s, %s", formatName(format), typeNames[type], spreadNames[spread])
+                        << format << QGradient::Type(type) << QGradient::Spread(spread);
+            }
+        }
+    }
+}
+
+void tst_DrawHelper::gradient()
+{
+    QFETCH(QImage::Format, format);
+    QFETCH(QGradient::Type, type);
+    QFETCH(QGradient::Spread, spread);
+
+    const QPointF center(ImageSize / 2, ImageSize / 2);
+    QGradient gradient;
+    switch (type) {
+    case QGradient::LinearGradient:
+        gradient = QLinearGradient(center, center + QPointF(ImageSize / 8, ImageSize / 16));
+        break;
+    case QGradient::RadialGradient:
+        gradient = QRadialGradient(center, ImageSize / 8);
+        break;
+    default:
+        gradient = QConicalGradient(center, 30);
+        break;
+    }
+    gradient.setSpread(spread);
+    gradient.setColorAt(0, QColor(255, 0, 0, 200));
+    gradient.setColorAt(0.5, QColor(0, 255, 0));
+    gradient.setColorAt(1, QColor(0, 0, 255, 100));
+
+    QImage destination = createImage(format, false);
+
+    QBENCHMARK {
+        QPainter p(&destination);
+        p.setCompositionMode(QPainter::CompositionMode_Source);
+        p.fillRect(destination.rect(), gradient);
+    }
+}
+
+QTEST_MAIN(tst_DrawHelper)
+
+#include "main.moc"
@@ -1,10 +1,12 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+        drawhelper \
         qcolor \
         qpainter \
         qregion \
         qtransform \
-        qtbench
+        qtbench \
+        qtiledimagepaintdevice
 
 !qtHaveModule(widgets): SUBDIRS -= \
     qpainter \
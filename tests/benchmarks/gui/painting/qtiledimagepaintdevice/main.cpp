@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+// This file contains benchmarks for QTiledImagePaintDevice.
+
+#include <qtest.h>
+#include <QtGui/QImage>
+#include <QtGui/QPainter>
+#include <QtGui/QPainterPath>
+#include <QtGui/QTiledImagePaintDevice>
+
+class tst_QTiledImagePaintDevice : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Scene {
+        GradientEllipses,
+        StrokedPaths,
+        TransformedImages,
+        Text
+    };
+
+private slots:
+    void paint_data();
+    void paint();
+};
+
+Q_DECLARE_METATYPE(tst_QTiledImagePaintDevice::Scene)
+
+static void drawScene(QPainter *p, tst_QTiledImagePaintDevice::Scene scene, const QSize &size)
+{
+    const int w = size.width();
+    const int h = size.height();
+    p->setRenderHint(QPainter::Antialiasing);
+
+    switch (scene) {
+    case tst_QTiledImagePaintDevice::GradientEllipses:
+        for (int i = 0; i < 500; ++i) {
+            const QPointF center((i * 97) % w, (i * 61) % h);
+            QRadialGradient gradient(center, 120);
+            gradient.setColorAt(0, QColor::fromHsv((i * 7) % 360, 255, 255, 180));
+            gradient.setColorAt(1, Qt::transparent);
+            p->setPen(QPen(Qt::black, 1.5));
+            p->setBrush(gradient);
+            p->drawEllipse(center, 120, 80);
+        }
+        break;
+    case tst_QTiledImagePaintDevice::StrokedPaths:
+        for (int i = 0; i < 200; ++i) {
+            QPainterPath path;
+            path.moveTo((i * 37) % w, 0);
+            for (int j = 1; j <= 8; ++j)
+                path.cubicTo((i * 37 + j * 50) % w, j * h / 8 - h / 10,
+                             (i * 53 + j * 30) % w, j * h / 8 + h / 10,
+                             (i * 37 + j * 90) % w, j * h / 8);
+            p->setPen(QPen(QColor::fromHsv((i * 11) % 360, 200, 160, 200), 4, Qt::DashLine));
+            p->setBrush(QColor::fromHsv((i * 11) % 360, 100, 255, 40));
+            p->drawPath(path);
+        }
+        break;
+    case tst_QTiledImagePaintDevice::TransformedImages: {
+        QImage tile(256, 256, QImage::Format_ARGB32_Premultiplied);
+        QPainter tilePainter(&tile);
+        tilePainter.fillRect(tile.rect(), QLinearGradient(0, 0, 256, 256));
+        tilePainter.fillRect(QRect(64, 64, 128, 128), QColor(255, 0, 0, 128));
+        tilePainter.end();
+        p->setRenderHint(QPainter::SmoothPixmapTransform);
+        for (int i = 0; i < 100; ++i) {
+            p->save();
+            p->translate((i * 97) % w, (i * 61) % h);
+            p->rotate(i * 13);
+            p->scale(1.5, 1.5);
+            p->drawImage(QPointF(-128, -128), tile);
+            p->restore();
+        }
+        break;
+    }
+    case tst_QTiledImagePaintDevice::Text: {
+        QFont font;
+        font.setPixelSize(14);
+        p->setFont(font);
+        p->setPen(Qt::black);
+        const QString line = QStringLiteral("The quick brown fox jumps over the lazy dog. ");
+        for (int y = 16; y < h; y += 18)
+            p->drawText(QPointF(4, y), line.repeated(6));
+        break;
+    }
+    }
+}
+
+void tst_QTiledImagePaintDevice::paint_data()
+{
+    QTest::addColumn<Scene>("scene");
+    QTest::addColumn<bool>("tiled");
+
+    QTest::newRow("gradient ellipses, serial") << GradientEllipses << false;
+    QTest::newRow("gradient ellipses, tiled") << GradientEllipses << true;
+    QTest::newRow("stroked paths, serial") << StrokedPaths << false;
+    QTest::newRow("stroked paths, tiled") << StrokedPaths << true;
+    QTest::newRow("transformed images, serial") << TransformedImages << false;
+    QTest::newRow("transformed images, tiled") << TransformedImages << true;
+    QTest::newRow("text, serial") << Text << false;
+    QTest::newRow("text, tiled") << Text << true;
+}
+
+void tst_QTiledImagePaintDevice::paint()
+{
+    QFETCH(Scene, scene);
+    QFETCH(bool, tiled);
+
+    QImage image(2048, 2048, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    QTiledImagePaintDevice device(&image);
+
+    QBENCHMARK {
+        QPainter p;
+        if (tiled)
+            p.begin(&device);
+        else
+            p.begin(&image);
+        drawScene(&p, scene, image.size());
+        p.end();
+    }
+}
+
+QTEST_MAIN(tst_QTiledImagePaintDevice)
+
+#include "main.moc"
@@ -0,0 +1,117 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtGui/QFontDatabase>
+#include <QtGui/QFontInfo>
+
+// Measures how long it takes the font database to become usable, as it
+// happens before the first window of an application is shown. Removing an
+// application font invalidates the database, so the next query populates
+// it again from the platform.
+class tst_QFontDatabase : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void populate_data();
+    void populate();
+    void populateAllFamilies_data();
+    void populateAllFamilies();
+
+private:
+    void invalidate();
+
+    int m_appFont;
+};
+
+void tst_QFontDatabase::initTestCase()
+{
+    m_appFont = QFontDatabase::addApplicationFont(QStringLiteral(":/testfont.ttf"));
+    QVERIFY(m_appFont >= 0);
+}
+
+void tst_QFontDatabase::invalidate()
+{
+    QFontDatabase::removeApplicationFont(m_appFont);
+}
+
+void tst_QFontDatabase::populate_data()
+{
+    QTest::addColumn<bool>("useCache");
+
+    QTest::newRow("without cache") << false;
+    QTest::newRow("with cache") << true;
+}
+
+// Startup: populate the database and look up the default family.
+void tst_QFontDatabase::populate()
+{
+    QFETCH(bool, useCache);
+
+    if (!useCache)
+        qputenv("QT_NO_FONTCONFIG_CACHE", "1");
+    const QString family = QFontInfo(QFont()).family();
+
+    QBENCHMARK {
+        invalidate();
+        QFontDatabase db;
+        QVERIFY(db.hasFamily(family));
+    }
+
+    qunsetenv("QT_NO_FONTCONFIG_CACHE");
+}
+
+void tst_QFontDatabase::populateAllFamilies_data()
+{
+    populate_data();
+}
+
+// Worst case for lazy population: every family is needed.
+void tst_QFontDatabase::populateAllFamilies()
+{
+    QFETCH(bool, useCache);
+
+    if (!useCache)
+        qputenv("QT_NO_FONTCONFIG_CACHE", "1");
+
+    QBENCHMARK {
+        invalidate();
+        QFontDatabase db;
+        const QStringList families = db.families();
+        for (const QString &family : families)
+            db.styles(family);
+    }
+
+    qunsetenv("QT_NO_FONTCONFIG_CACHE");
+}
+
+QTEST_MAIN(tst_QFontDatabase)
+
+#include "main.moc"
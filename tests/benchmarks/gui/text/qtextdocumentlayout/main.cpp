@@ -0,0 +1,241 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtGui/QImage>
+#include <QtGui/QPainter>
+#include <QtGui/QTextBlock>
+#include <QtGui/QTextCursor>
+#include <QtGui/QTextDocument>
+#include <QtGui/private/qtextdocumentlayout_p.h>
+
+class tst_QTextDocumentLayout : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void openDocument_data();
+    void openDocument();
+    void appendLines_data();
+    void appendLines();
+    void insertAtTop_data();
+    void insertAtTop();
+    void typeInMiddle_data();
+    void typeInMiddle();
+
+private:
+    void createDocument(int lineCount, bool layoutOnDemand);
+    void paintAround(int position);
+
+    QTextDocument *m_document;
+    QImage m_viewport;
+};
+
+static QString logLine(int i)
+{
+    return QStringLiteral("2017-06-12 10:%1:%2.%3 [worker-%4] processed request %5 in %6 ms")
+            .arg((i / 60) % 60, 2, 10, QLatin1Char('0'))
+            .arg(i % 60, 2, 10, QLatin1Char('0'))
+            .arg(i % 1000, 3, 10, QLatin1Char('0'))
+            .arg(i % 8).arg(i).arg(i % 97);
+}
+
+static QString logText(int lineCount)
+{
+    QString text;
+    text.reserve(lineCount * 70);
+    for (int i = 0; i < lineCount; ++i) {
+        if (i)
+            text += QLatin1Char('\n');
+        text += logLine(i);
+    }
+    return text;
+}
+
+static void addRows()
+{
+    QTest::addColumn<int>("lineCount");
+    QTest::addColumn<bool>("layoutOnDemand");
+
+    QTest::newRow("100k lines") << 100000 << false;
+    QTest::newRow("100k lines, on demand") << 100000 << true;
+    QTest::newRow("1M lines") << 1000000 << false;
+    QTest::newRow("1M lines, on demand") << 1000000 << true;
+}
+
+void tst_QTextDocumentLayout::init()
+{
+    m_document = 0;
+    m_viewport = QImage(800, 600, QImage::Format_ARGB32_Premultiplied);
+}
+
+void tst_QTextDocumentLayout::cleanup()
+{
+    delete m_document;
+    m_document = 0;
+}
+
+void tst_QTextDocumentLayout::createDocument(int lineCount, bool layoutOnDemand)
+{
+    m_document = new QTextDocument;
+    m_document->documentLayout()->setProperty("layoutOnDemand", layoutOnDemand);
+    m_document->setTextWidth(m_viewport.width());
+    m_document->setPlainText(logText(lineCount));
+}
+
+// Does what a text view does after an edit: update the scroll bar range
+// and repaint the part of the document around the edit.
+void tst_QTextDocumentLayout::paintAround(int position)
+{
+    QAbstractTextDocumentLayout *layout = m_document->documentLayout();
+    const QSizeF size = layout->documentSize();
+    Q_UNUSED(size);
+
+    const QRectF blockRect = layout->blockBoundingRect(m_document->findBlock(position));
+    const qreal top = qMax(qreal(0), blockRect.bottom() - m_viewport.height());
+
+    QPainter painter(&m_viewport);
+    painter.translate(0, -top);
+    QAbstractTextDocumentLayout::PaintContext context;
+    context.clip = QRectF(0, top, m_viewport.width(), m_viewport.height());
+    layout->draw(&painter, context);
+}
+
+void tst_QTextDocumentLayout::openDocument_data()
+{
+    addRows();
+}
+
+void tst_QTextDocumentLayout::openDocument()
+{
+    QFETCH(int, lineCount);
+    QFETCH(bool, layoutOnDemand);
+    const QString text = logText(lineCount);
+
+    QBENCHMARK {
+        QTextDocument document;
+        document.documentLayout()->setProperty("layoutOnDemand", layoutOnDemand);
+        document.setTextWidth(m_viewport.width());
+        document.setPlainText(text);
+
+        QVERIFY(document.size().height() > lineCount);
+        QPainter painter(&m_viewport);
+        QAbstractTextDocumentLayout::PaintContext context;
+        context.clip = QRectF(QPointF(0, 0), m_viewport.size());
+        document.documentLayout()->draw(&painter, context);
+    }
+}
+
+void tst_QTextDocumentLayout::appendLines_data()
+{
+    QTest::addColumn<int>("lineCount");
+    QTest::addColumn<bool>("layoutOnDemand");
+    QTest::addColumn<bool>("followEnd");
+
+    QTest::newRow("1M lines, view at top") << 1000000 << false << false;
+    QTest::newRow("1M lines, view at top, on demand") << 1000000 << true << false;
+    QTest::newRow("1M lines, view at end") << 1000000 << false << true;
+    QTest::newRow("1M lines, view at end, on demand") << 1000000 << true << true;
+}
+
+void tst_QTextDocumentLayout::appendLines()
+{
+    QFETCH(int, lineCount);
+    QFETCH(bool, layoutOnDemand);
+    QFETCH(bool, followEnd);
+    createDocument(lineCount, layoutOnDemand);
+
+    QTextCursor cursor(m_document);
+    cursor.movePosition(QTextCursor::End);
+    paintAround(followEnd ? cursor.position() : 0);
+
+    int line = lineCount;
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i) {
+            cursor.movePosition(QTextCursor::End);
+            cursor.insertBlock();
+            cursor.insertText(logLine(line++));
+            paintAround(followEnd ? cursor.position() : 0);
+        }
+    }
+}
+
+void tst_QTextDocumentLayout::insertAtTop_data()
+{
+    addRows();
+}
+
+void tst_QTextDocumentLayout::insertAtTop()
+{
+    QFETCH(int, lineCount);
+    QFETCH(bool, layoutOnDemand);
+    createDocument(lineCount, layoutOnDemand);
+    paintAround(0);
+
+    QTextCursor cursor(m_document);
+    int line = lineCount;
+    QBENCHMARK {
+        for (int i = 0; i < 10; ++i) {
+            cursor.setPosition(0);
+            cursor.insertText(logLine(line++));
+            cursor.insertBlock();
+            paintAround(0);
+        }
+    }
+}
+
+void tst_QTextDocumentLayout::typeInMiddle_data()
+{
+    addRows();
+}
+
+void tst_QTextDocumentLayout::typeInMiddle()
+{
+    QFETCH(int, lineCount);
+    QFETCH(bool, layoutOnDemand);
+    createDocument(lineCount, layoutOnDemand);
+
+    QTextCursor cursor(m_document->findBlockByNumber(lineCount / 2));
+    cursor.movePosition(QTextCursor::EndOfBlock);
+    paintAround(cursor.position());
+
+    QBENCHMARK {
+        for (int i = 0; i < 10; ++i) {
+            cursor.insertText(QStringLiteral("x"));
+            paintAround(cursor.position());
+        }
+    }
+}
+
+QTEST_MAIN(tst_QTextDocumentLayout)
+
+#include "main.moc"
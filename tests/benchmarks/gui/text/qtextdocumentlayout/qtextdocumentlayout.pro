@@ -0,0 +1,5 @@
+TEMPLATE = app
+TARGET = tst_bench_qtextdocumentlayout
+QT += gui-private testlib
+CONFIG += release
+SOURCES += main.cpp
@@ -0,0 +1,220 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QThreadPool>
+#include <QtGui/QTextLayout>
+#include <QtGui/private/qtextshapingcache_p.h>
+
+Q_DECLARE_METATYPE(QFont)
+
+class tst_QTextShapingCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void cleanupTestCase();
+
+    void layout_data();
+    void layout();
+    void layoutParallel_data();
+    void layoutParallel();
+    void lookup();
+
+private:
+    QByteArray m_currentRow;
+    int m_defaultMaxCost;
+};
+
+static QString sampleText(const QString &script)
+{
+    if (script == QLatin1String("latin")) {
+        return QStringLiteral("The quick brown fox jumps over the lazy dog. Pack my box with five "
+                              "dozen liquor jugs; sphinx of black quartz, judge my vow! ");
+    } else if (script == QLatin1String("arabic")) {
+        return QString::fromUtf8("\330\247\331\204\330\263\331\204\330\247\331\205 \330\271\331\204\331\212"
+                                 "\331\203\331\205 \331\210\330\261\330\255\331\205\330\251 \330\247\331\204\331\204"
+                                 "\331\207 \331\210\330\250\330\261\331\203\330\247\330\252\331\207 ");
+    } else {
+        return QString::fromUtf8("Mixed \330\271\330\261\330\250\331\212 text \316\261\316\262\316\263 "
+                                 "\320\272\320\270\321\200\320\270\320\273\320\273\320\270\321\206\320\260 ");
+    }
+}
+
+static qreal layoutText(const QString &text, const QFont &font, qreal lineWidth)
+{
+    QTextLayout layout(text, font);
+    layout.setCacheEnabled(false);
+    layout.beginLayout();
+    qreal height = 0;
+    forever {
+        QTextLine line = layout.createLine();
+        if (!line.isValid())
+            break;
+        line.setLineWidth(lineWidth);
+        line.setPosition(QPointF(0, height));
+        height += line.height();
+    }
+    layout.endLayout();
+    return height;
+}
+
+static void reportHitRate(const QByteArray &row)
+{
+    const QTextShapingCache::Statistics stats = QTextShapingCache::instance()->statistics();
+    const quint64 lookups = stats.hits + stats.misses;
+    if (lookups)
+        qDebug("%s: hit rate %.1f%% (%llu of %llu lookups), %d entries, %d of %d bytes",
+               row.constData(), 100.0 * stats.hits / lookups, stats.hits, lookups,
+               stats.count, stats.totalCost, stats.maxCost);
+}
+
+// QBENCHMARK runs each row several times; start from an empty cache and
+// report the hit rate once per row rather than once per run.
+void tst_QTextShapingCache::init()
+{
+    const QByteArray row = QByteArray(QTest::currentTestFunction()) + '(' + QTest::currentDataTag() + ')';
+    if (row == m_currentRow)
+        return;
+    if (!m_currentRow.isEmpty())
+        reportHitRate(m_currentRow);
+    m_currentRow = row;
+
+    QTextShapingCache *cache = QTextShapingCache::instance();
+    m_defaultMaxCost = cache->maxCost();
+    cache->clear();
+    cache->resetStatistics();
+}
+
+void tst_QTextShapingCache::cleanup()
+{
+    QTextShapingCache::instance()->setMaxCost(m_defaultMaxCost);
+}
+
+void tst_QTextShapingCache::cleanupTestCase()
+{
+    reportHitRate(m_currentRow);
+}
+
+void tst_QTextShapingCache::layout_data()
+{
+    QTest::addColumn<QString>("script");
+    QTest::addColumn<bool>("cached");
+
+    const char *scripts[] = { "latin", "arabic", "mixed" };
+    for (const char *script : scripts) {
+        QTest::newRow(QByteArray(script) + "-uncached") << QString::fromLatin1(script) << false;
+        QTest::newRow(QByteArray(script) + "-cached") << QString::fromLatin1(script) << true;
+    }
+}
+
+// Rebuilds the same paragraph over and over, as happens on every
+// relayout of a label or a text document block.
+void tst_QTextShapingCache::layout()
+{
+    QFETCH(QString, script);
+    QFETCH(bool, cached);
+
+    if (!cached)
+        QTextShapingCache::instance()->setMaxCost(0);
+
+    const QString text = sampleText(script).repeated(8);
+    const QFont font;
+
+    QBENCHMARK {
+        layoutText(text, font, 300);
+    }
+}
+
+void tst_QTextShapingCache::layoutParallel_data()
+{
+    layout_data();
+}
+
+// Lays out the same paragraph on all threads of the global thread pool,
+// which all share the process-wide cache.
+void tst_QTextShapingCache::layoutParallel()
+{
+    QFETCH(QString, script);
+    QFETCH(bool, cached);
+
+    if (!cached)
+        QTextShapingCache::instance()->setMaxCost(0);
+
+    const QString text = sampleText(script).repeated(8);
+    const int threads = qMax(2, QThreadPool::globalInstance()->maxThreadCount());
+
+    class LayoutTask : public QRunnable
+    {
+    public:
+        explicit LayoutTask(const QString &text) : m_text(text) {}
+        void run() override
+        {
+            const QFont font;
+            for (int i = 0; i < 20; ++i)
+                layoutText(m_text, font, 300);
+        }
+    private:
+        QString m_text;
+    };
+
+    QBENCHMARK {
+        for (int i = 0; i < threads; ++i)
+            QThreadPool::globalInstance()->start(new LayoutTask(text));
+        QThreadPool::globalInstance()->waitForDone();
+    }
+}
+
+// Measures the cost of a cache hit alone, without any layout around it.
+void tst_QTextShapingCache::lookup()
+{
+    QTextShapingCache *cache = QTextShapingCache::instance();
+
+    QTextShapingCacheKey key;
+    key.text = sampleText(QStringLiteral("latin"));
+    key.script = QChar::Script_Latin;
+
+    QTextShapingCacheEntry entry;
+    entry.glyphs.resize(key.text.size());
+    entry.advances.resize(key.text.size());
+    entry.offsets.resize(key.text.size());
+    entry.attributes.resize(key.text.size());
+    entry.logClusters.resize(key.text.size());
+    cache->insert(key, entry);
+
+    QTextShapingCacheEntry result;
+    QBENCHMARK {
+        QVERIFY(cache->find(key, &result));
+    }
+}
+
+QTEST_MAIN(tst_QTextShapingCache)
+
+#include "main.moc"
@@ -1,5 +1,9 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+        qfontdatabase \
         qfontmetrics \
         qtext \
-        qtextdocument
+        qtextshapingcache \
+        qtextdocument \
+        qtextdocumentlayout \
+        threadedtextrendering
@@ -0,0 +1,102 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QThread>
+#include <QtGui/QImage>
+#include <QtGui/QPainter>
+
+// Renders the same text into separate images on several threads at once.
+// Every iteration starts new threads, and thus new font engines, so that
+// glyphs are not served from the per-engine caches of earlier iterations.
+class tst_ThreadedTextRendering : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void drawText_data();
+    void drawText();
+};
+
+static void renderText(int pixelSize, bool antialias)
+{
+    static const char text[] =
+        "The quick brown fox jumps over the lazy dog. Pack my box with five dozen "
+        "liquor jugs. Sphinx of black quartz, judge my vow! 0123456789 (){}[]<>";
+
+    QImage image(512, 256, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+
+    QFont font;
+    font.setPixelSize(pixelSize);
+    if (!antialias)
+        font.setStyleStrategy(QFont::NoAntialias);
+
+    QPainter p(&image);
+    p.setFont(font);
+    p.setPen(Qt::black);
+    p.drawText(image.rect(), Qt::TextWordWrap, QString::fromLatin1(text));
+}
+
+void tst_ThreadedTextRendering::drawText_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<int>("pixelSize");
+    QTest::addColumn<bool>("antialias");
+
+    const int threadCounts[] = { 1, 4, 16 };
+    for (int threadCount : threadCounts) {
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 threads, 12px").arg(threadCount))) << threadCount << 12 << true;
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 threads, 32px").arg(threadCount))) << threadCount << 32 << true;
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 threads, 12px mono").arg(threadCount))) << threadCount << 12 << false;
+    }
+}
+
+void tst_ThreadedTextRendering::drawText()
+{
+    QFETCH(int, threadCount);
+    QFETCH(int, pixelSize);
+    QFETCH(bool, antialias);
+
+    QBENCHMARK {
+        QVector<QThread *> threads;
+        for (int i = 0; i < threadCount; ++i) {
+            QThread *thread = QThread::create(renderText, pixelSize, antialias);
+            thread->start();
+            threads.append(thread);
+        }
+        for (QThread *thread : qAsConst(threads)) {
+            thread->wait();
+            delete thread;
+        }
+    }
+}
+
+QTEST_MAIN(tst_ThreadedTextRendering)
+
+#include "main.moc"
@@ -0,0 +1,5 @@
+TEMPLATE = app
+TARGET = tst_bench_threadedtextrendering
+QT += testlib
+CONFIG += release
+SOURCES += main.cpp
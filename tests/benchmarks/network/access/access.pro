@@ -3,4 +3,7 @@ SUBDIRS = \
         qfile_vs_qnetworkaccessmanager \
         qnetworkreply \
         qnetworkreply_from_cache \
-        qnetworkdiskcache
+        qnetworkdiskcache \
+        qnetworkcookiejar \
+        qhttpcontentdecoder \
+        qnetworkaccessmanager
@@ -0,0 +1,20 @@
+TEMPLATE = app
+TARGET = tst_bench_qhttpcontentdecoder
+
+QT = core network-private testlib
+
+CONFIG += release
+
+SOURCES += tst_qhttpcontentdecoder.cpp
+
+# the encoders are only needed to produce the test data
+packagesExist(libbrotlienc) {
+    CONFIG += link_pkgconfig
+    PKGCONFIG += libbrotlienc
+    DEFINES += HAVE_BROTLIENC
+}
+packagesExist(libzstd) {
+    CONFIG += link_pkgconfig
+    PKGCONFIG += libzstd
+    DEFINES += HAVE_ZSTD
+}
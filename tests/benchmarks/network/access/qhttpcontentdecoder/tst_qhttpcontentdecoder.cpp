@@ -0,0 +1,147 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/private/qbytedata_p.h>
+#include <QtNetwork/private/qhttpcontentdecoder_p.h>
+
+#ifdef HAVE_BROTLIENC
+#include <brotli/encode.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+class tst_QHttpContentDecoder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void decode_data();
+    void decode();
+
+private:
+    QByteArray payload;
+};
+
+void tst_QHttpContentDecoder::initTestCase()
+{
+    // JSON-like API response: repetitive structure with varying values
+    QByteArray data;
+    data.reserve(8 * 1024 * 1024);
+    data += "[";
+    for (int i = 0; data.size() < 8 * 1024 * 1024; ++i) {
+        data += "{\"id\":" + QByteArray::number(i)
+                + ",\"name\":\"item" + QByteArray::number(i * 7919 % 100003)
+                + "\",\"price\":" + QByteArray::number(i % 1000 / 10.0)
+                + ",\"tags\":[\"alpha\",\"beta\",\"" + QByteArray::number(i % 17, 16)
+                + "\"],\"active\":" + (i % 3 ? "true" : "false") + "},";
+    }
+    data += "{}]";
+    payload = data;
+}
+
+void tst_QHttpContentDecoder::decode_data()
+{
+    QTest::addColumn<QByteArray>("encoding");
+    QTest::addColumn<QByteArray>("encoded");
+    QTest::addColumn<int>("pieceSize");
+
+    QList<QPair<QByteArray, QByteArray> > encodings;
+    // qCompress() prefixes the zlib stream with the uncompressed size
+    encodings << qMakePair(QByteArray("deflate"), qCompress(payload, 6).mid(4));
+
+#ifdef HAVE_BROTLIENC
+    if (QHttpContentDecoder::isSupported("br")) {
+        QByteArray encoded(int(BrotliEncoderMaxCompressedSize(payload.size())), Qt::Uninitialized);
+        size_t encodedSize = encoded.size();
+        if (BrotliEncoderCompress(5, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, payload.size(),
+                                  reinterpret_cast<const uint8_t *>(payload.constData()),
+                                  &encodedSize, reinterpret_cast<uint8_t *>(encoded.data()))) {
+            encoded.resize(int(encodedSize));
+            encodings << qMakePair(QByteArray("br"), encoded);
+        }
+    }
+#endif
+#ifdef HAVE_ZSTD
+    if (QHttpContentDecoder::isSupported("zstd")) {
+        QByteArray encoded(int(ZSTD_compressBound(payload.size())), Qt::Uninitialized);
+        const size_t encodedSize = ZSTD_compress(encoded.data(), encoded.size(),
+                                                 payload.constData(), payload.size(), 3);
+        if (!ZSTD_isError(encodedSize)) {
+            encoded.resize(int(encodedSize));
+            encodings << qMakePair(QByteArray("zstd"), encoded);
+        }
+    }
+#endif
+
+    for (const auto &encoding : qAsConst(encodings)) {
+        // typical socket reads and a whole-body feed
+        const int pieceSizes[] = { 1460, 16 * 1024, encoding.second.size() };
+        for (int pieceSize : pieceSizes) {
+            QTest::newRow((encoding.first + '-' + QByteArray::number(pieceSize)).constData())
+                    << encoding.first << encoding.second << pieceSize;
+        }
+    }
+}
+
+void tst_QHttpContentDecoder::decode()
+{
+    QFETCH(QByteArray, encoding);
+    QFETCH(QByteArray, encoded);
+    QFETCH(int, pieceSize);
+
+    qint64 decodedBytes = 0;
+    int iterations = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        QScopedPointer<QHttpContentDecoder> decoder(QHttpContentDecoder::create(encoding));
+        QVERIFY(decoder);
+        QByteDataBuffer out;
+        for (int offset = 0; offset < encoded.size(); offset += pieceSize) {
+            QVERIFY(decoder->decode(encoded.constData() + offset,
+                                    qMin(pieceSize, encoded.size() - offset), &out));
+            // the consumer drains the buffer as data arrives
+            decodedBytes += out.byteAmount();
+            out.clear();
+        }
+        ++iterations;
+    } while (timer.elapsed() < 500);
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    QCOMPARE(decodedBytes, qint64(payload.size()) * iterations);
+    QTest::setBenchmarkResult(decodedBytes * 1e9 / elapsed, QTest::BytesPerSecond);
+}
+
+QTEST_MAIN(tst_QHttpContentDecoder)
+
+#include "tst_qhttpcontentdecoder.moc"
@@ -0,0 +1,411 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "benchserver.h"
+
+#include <QtNetwork/private/bitstreams_p.h>
+
+#include <QtCore/qendian.h>
+
+#include <algorithm>
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Http2;
+
+namespace {
+
+// Stop filling the socket's write buffer beyond this; the rest is sent
+// when bytesWritten() reports progress.
+enum { WriteBufferLimit = 256 * 1024 };
+
+qint64 requestedSize(const QByteArray &path)
+{
+    // "/<n>"
+    return path.startsWith('/') ? qMax<qint64>(0, path.mid(1).toLongLong()) : 0;
+}
+
+}
+
+BenchServer::BenchServer(Protocol protocol, QObject *parent)
+    : QTcpServer(parent),
+      serverProtocol(protocol)
+{
+}
+
+const QByteArray &BenchServer::payload()
+{
+    static const QByteArray data = [] {
+        QByteArray result(1024 * 1024, Qt::Uninitialized);
+        quint32 seed = 0x2545f491;
+        for (int i = 0; i < result.size(); ++i) {
+            seed = seed * 1103515245 + 12345;
+            result[i] = char(seed >> 24);
+        }
+        return result;
+    }();
+    return data;
+}
+
+quint16 BenchServer::start()
+{
+    if (!listen(QHostAddress::LocalHost))
+        return 0;
+    return serverPort();
+}
+
+void BenchServer::incomingConnection(qintptr socketDescriptor)
+{
+    if (serverProtocol == Http1)
+        new Http1Connection(socketDescriptor, this);
+    else
+        new Http2Connection(socketDescriptor, this);
+}
+
+Http1Connection::Http1Connection(qintptr socketDescriptor, QObject *parent)
+    : QObject(parent),
+      bodyOffset(0),
+      bodySize(0),
+      sendingBody(false)
+{
+    socket.setSocketDescriptor(socketDescriptor);
+    connect(&socket, SIGNAL(readyRead()), this, SLOT(readReady()));
+    connect(&socket, SIGNAL(bytesWritten(qint64)), this, SLOT(sendPending()));
+    connect(&socket, SIGNAL(disconnected()), this, SLOT(deleteLater()));
+}
+
+void Http1Connection::readReady()
+{
+    inbound += socket.readAll();
+
+    int headerEnd;
+    while ((headerEnd = inbound.indexOf("\r\n\r\n")) >= 0) {
+        const QList<QByteArray> requestLine = inbound.left(inbound.indexOf("\r\n")).split(' ');
+        inbound.remove(0, headerEnd + 4);
+        if (requestLine.size() != 3 || requestLine.at(0) != "GET") {
+            socket.disconnectFromHost();
+            return;
+        }
+        pendingResponses.enqueue(requestedSize(requestLine.at(1)));
+    }
+
+    sendPending();
+}
+
+void Http1Connection::sendPending()
+{
+    const QByteArray &data = BenchServer::payload();
+
+    while (socket.bytesToWrite() < WriteBufferLimit) {
+        if (!sendingBody) {
+            if (pendingResponses.isEmpty())
+                return;
+            bodySize = pendingResponses.dequeue();
+            bodyOffset = 0;
+            sendingBody = true;
+            socket.write("HTTP/1.1 200 OK\r\n"
+                         "Content-Type: application/octet-stream\r\n"
+                         "Content-Length: " + QByteArray::number(bodySize) + "\r\n\r\n");
+        }
+
+        const int offset = int(bodyOffset % data.size());
+        const qint64 chunk = qMin<qint64>(bodySize - bodyOffset, data.size() - offset);
+        if (chunk > 0) {
+            socket.write(data.constData() + offset, chunk);
+            bodyOffset += chunk;
+        }
+        if (bodyOffset == bodySize)
+            sendingBody = false;
+    }
+}
+
+Http2Connection::Http2Connection(qintptr socketDescriptor, QObject *parent)
+    : QObject(parent),
+      state(ReadingUpgradeRequest),
+      upgradeRequested(false),
+      decoder(HPack::FieldLookupTable::DefaultSize),
+      encoder(HPack::FieldLookupTable::DefaultSize, true),
+      lastServedStream(0),
+      sessionSendWindow(defaultSessionWindowSize),
+      initialStreamWindow(defaultSessionWindowSize),
+      peerMaxFrameSize(maxFrameSize)
+{
+    socket.setSocketDescriptor(socketDescriptor);
+    connect(&socket, SIGNAL(readyRead()), this, SLOT(readReady()));
+    connect(&socket, SIGNAL(bytesWritten(qint64)), this, SLOT(sendPending()));
+    connect(&socket, SIGNAL(disconnected()), this, SLOT(deleteLater()));
+}
+
+void Http2Connection::readReady()
+{
+    if (state == ReadingUpgradeRequest)
+        handleUpgradeRequest();
+    if (state == ReadingClientPreface)
+        handleClientPreface();
+
+    while (state == ReadingFrames) {
+        const FrameStatus status = reader.read(socket);
+        if (status == FrameStatus::incompleteFrame)
+            break;
+        if (status != FrameStatus::goodFrame) {
+            sendGOAWAY(PROTOCOL_ERROR);
+            return;
+        }
+        inboundFrame = std::move(reader.inboundFrame());
+        handleFrame();
+    }
+
+    sendPending();
+}
+
+void Http2Connection::handleUpgradeRequest()
+{
+    // The first request arrives as HTTP/1.1 with "Upgrade: h2c"; it is
+    // answered on stream 1 once we have switched protocols.
+    while (socket.canReadLine()) {
+        const QByteArray line = socket.readLine();
+        if (upgradeRequestLine.isEmpty()) {
+            upgradeRequestLine = line.trimmed();
+            continue;
+        }
+        if (line == "\r\n") {
+            const QList<QByteArray> requestLine = upgradeRequestLine.split(' ');
+            if (!upgradeRequested || requestLine.size() != 3 || requestLine.at(0) != "GET") {
+                state = ConnectionError;
+                socket.disconnectFromHost();
+                return;
+            }
+
+            socket.write("HTTP/1.1 101 Switching Protocols\r\n"
+                         "Connection: Upgrade\r\n"
+                         "Upgrade: h2c\r\n\r\n");
+            state = ReadingClientPreface;
+            sendSETTINGS();
+            sendResponseHeaders(1, requestedSize(requestLine.at(1)));
+            return;
+        }
+        const QByteArray field = line.toLower();
+        if (field.startsWith("upgrade:") && field.contains("h2c"))
+            upgradeRequested = true;
+    }
+}
+
+void Http2Connection::handleClientPreface()
+{
+    if (socket.bytesAvailable() < clientPrefaceLength)
+        return;
+
+    char preface[clientPrefaceLength] = {};
+    socket.read(preface, clientPrefaceLength);
+    if (std::memcmp(preface, Http2clientPreface, clientPrefaceLength)) {
+        sendGOAWAY(PROTOCOL_ERROR);
+        return;
+    }
+
+    state = ReadingFrames;
+}
+
+void Http2Connection::handleFrame()
+{
+    switch (inboundFrame.type()) {
+    case FrameType::SETTINGS:
+        handleSETTINGS();
+        break;
+    case FrameType::HEADERS:
+    case FrameType::CONTINUATION:
+        continuedHeaders.push_back(std::move(inboundFrame));
+        if (continuedHeaders.back().flags().testFlag(FrameFlag::END_HEADERS))
+            handleHEADERS();
+        break;
+    case FrameType::WINDOW_UPDATE:
+        handleWINDOW_UPDATE();
+        break;
+    case FrameType::PING:
+        if (!inboundFrame.flags().testFlag(FrameFlag::ACK)) {
+            writer.start(FrameType::PING, FrameFlag::ACK, connectionStreamID);
+            writer.append(inboundFrame.dataBegin(), inboundFrame.dataBegin() + inboundFrame.dataSize());
+            writer.write(socket);
+        }
+        break;
+    case FrameType::RST_STREAM:
+        streams.erase(inboundFrame.streamID());
+        break;
+    case FrameType::GOAWAY:
+        state = ConnectionError;
+        socket.disconnectFromHost();
+        break;
+    default:
+        // DATA (we do not accept request bodies), PRIORITY and unknown
+        // frames are ignored.
+        break;
+    }
+}
+
+void Http2Connection::handleSETTINGS()
+{
+    if (inboundFrame.flags().testFlag(FrameFlag::ACK))
+        return;
+
+    const uchar *src = inboundFrame.dataBegin();
+    const uchar *end = src + inboundFrame.dataSize();
+    for (; src + 6 <= end; src += 6) {
+        const Settings identifier = Settings(qFromBigEndian<quint16>(src));
+        const quint32 value = qFromBigEndian<quint32>(src + 2);
+        if (identifier == Settings::INITIAL_WINDOW_SIZE_ID) {
+            // HTTP/2 6.9.2: the change applies to all open streams
+            const qint64 delta = qint64(value) - initialStreamWindow;
+            for (auto &stream : streams)
+                stream.second.sendWindow += delta;
+            initialStreamWindow = value;
+        } else if (identifier == Settings::MAX_FRAME_SIZE_ID) {
+            peerMaxFrameSize = value;
+        }
+    }
+
+    writer.start(FrameType::SETTINGS, FrameFlag::ACK, connectionStreamID);
+    writer.write(socket);
+}
+
+void Http2Connection::handleHEADERS()
+{
+    const quint32 streamID = continuedHeaders.front().streamID();
+
+    std::vector<uchar> hpackBlock;
+    for (const Frame &frame : continuedHeaders)
+        hpackBlock.insert(hpackBlock.end(), frame.dataBegin(), frame.dataBegin() + frame.dataSize());
+    continuedHeaders.clear();
+
+    HPack::BitIStream inputStream(hpackBlock.data(), hpackBlock.data() + hpackBlock.size());
+    if (!decoder.decodeHeaderFields(inputStream)) {
+        sendGOAWAY(COMPRESSION_ERROR);
+        return;
+    }
+
+    QByteArray path;
+    for (const HPack::HeaderField &field : decoder.decodedHeader()) {
+        if (field.name == ":path")
+            path = field.value;
+    }
+    sendResponseHeaders(streamID, requestedSize(path));
+}
+
+void Http2Connection::handleWINDOW_UPDATE()
+{
+    const quint32 delta = qFromBigEndian<quint32>(inboundFrame.dataBegin()) & 0x7fffffff;
+    const quint32 streamID = inboundFrame.streamID();
+    if (streamID == connectionStreamID) {
+        sessionSendWindow += delta;
+    } else {
+        const auto it = streams.find(streamID);
+        if (it != streams.end())
+            it->second.sendWindow += delta;
+    }
+}
+
+void Http2Connection::sendSETTINGS()
+{
+    writer.start(FrameType::SETTINGS, FrameFlag::EMPTY, connectionStreamID);
+    writer.append(Settings::MAX_CONCURRENT_STREAMS_ID);
+    writer.append(quint32(maxPeerConcurrentStreams));
+    writer.write(socket);
+}
+
+void Http2Connection::sendResponseHeaders(quint32 streamID, qint64 bodySize)
+{
+    const HPack::HttpHeader header = {
+        {":status", "200"},
+        {"content-type", "application/octet-stream"},
+        {"content-length", QByteArray::number(bodySize)}
+    };
+
+    writer.start(FrameType::HEADERS, FrameFlag::END_HEADERS, streamID);
+    if (!bodySize)
+        writer.addFlag(FrameFlag::END_STREAM);
+    HPack::BitOStream outputStream(writer.outboundFrame().buffer);
+    encoder.encodeResponse(outputStream, header);
+    writer.writeHEADERS(socket, peerMaxFrameSize);
+
+    if (bodySize) {
+        const Stream stream = { 0, bodySize, initialStreamWindow };
+        streams[streamID] = stream;
+    }
+}
+
+void Http2Connection::sendGOAWAY(quint32 error)
+{
+    writer.start(FrameType::GOAWAY, FrameFlag::EMPTY, connectionStreamID);
+    writer.append(quint32(0));
+    writer.append(error);
+    writer.write(socket);
+    state = ConnectionError;
+}
+
+void Http2Connection::sendPending()
+{
+    if (state != ReadingClientPreface && state != ReadingFrames)
+        return;
+
+    const QByteArray &data = BenchServer::payload();
+
+    // Interleave DATA frames of all open streams, within flow control limits.
+    while (socket.bytesToWrite() < WriteBufferLimit && sessionSendWindow > 0 && !streams.empty()) {
+        auto it = streams.upper_bound(lastServedStream);
+        std::size_t candidates = streams.size();
+        for (; candidates; --candidates, ++it) {
+            if (it == streams.end())
+                it = streams.begin();
+            if (it->second.sendWindow > 0)
+                break;
+        }
+        if (!candidates)
+            return; // waiting for WINDOW_UPDATE
+
+        Stream &stream = it->second;
+        const int offset = int(stream.bodyOffset % data.size());
+        const qint64 chunk = std::min({ stream.bodySize - stream.bodyOffset, stream.sendWindow,
+                                        sessionSendWindow, qint64(peerMaxFrameSize),
+                                        qint64(data.size() - offset) });
+        const bool last = stream.bodyOffset + chunk == stream.bodySize;
+
+        writer.start(FrameType::DATA, last ? FrameFlag::END_STREAM : FrameFlag::EMPTY, it->first);
+        writer.setPayloadSize(quint32(chunk));
+        writer.write(socket);
+        socket.write(data.constData() + offset, chunk);
+
+        stream.bodyOffset += chunk;
+        stream.sendWindow -= chunk;
+        sessionSendWindow -= chunk;
+        lastServedStream = it->first;
+        if (last)
+            streams.erase(it);
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,154 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef BENCHSERVER_H
+#define BENCHSERVER_H
+
+#include <QtNetwork/private/http2protocol_p.h>
+#include <QtNetwork/private/http2frames_p.h>
+#include <QtNetwork/private/hpack_p.h>
+
+#include <QtNetwork/qtcpserver.h>
+#include <QtNetwork/qtcpsocket.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qqueue.h>
+
+#include <map>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+// A minimal origin server for benchmarking QNetworkAccessManager on
+// loopback. A GET for "/<n>" is answered with n bytes of payload; request
+// bodies are not supported. Responses are written as the socket drains so
+// that large downloads do not pile up in the socket's write buffer.
+class BenchServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    enum Protocol {
+        Http1,      // HTTP/1.1 with keep-alive and pipelining
+        Http2Clear  // HTTP/2 via the HTTP/1.1 "Upgrade: h2c" handshake
+    };
+
+    explicit BenchServer(Protocol protocol, QObject *parent = nullptr);
+
+    Protocol protocol() const { return serverProtocol; }
+
+    // Payload served to all clients; repeated for large responses.
+    static const QByteArray &payload();
+
+public slots:
+    // Meant to be invoked in the server's thread.
+    quint16 start();
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) Q_DECL_OVERRIDE;
+
+private:
+    Protocol serverProtocol;
+};
+
+class Http1Connection : public QObject
+{
+    Q_OBJECT
+public:
+    Http1Connection(qintptr socketDescriptor, QObject *parent);
+
+private slots:
+    void readReady();
+    void sendPending();
+
+private:
+    QTcpSocket socket;
+    QByteArray inbound;
+    // pipelined requests are answered in order
+    QQueue<qint64> pendingResponses;
+    qint64 bodyOffset;
+    qint64 bodySize;
+    bool sendingBody;
+};
+
+class Http2Connection : public QObject
+{
+    Q_OBJECT
+public:
+    Http2Connection(qintptr socketDescriptor, QObject *parent);
+
+private slots:
+    void readReady();
+    void sendPending();
+
+private:
+    enum State {
+        ReadingUpgradeRequest,
+        ReadingClientPreface,
+        ReadingFrames,
+        ConnectionError
+    };
+
+    struct Stream {
+        qint64 bodyOffset;
+        qint64 bodySize;
+        qint64 sendWindow;
+    };
+
+    void handleUpgradeRequest();
+    void handleClientPreface();
+    void handleFrame();
+    void handleSETTINGS();
+    void handleHEADERS();
+    void handleWINDOW_UPDATE();
+    void sendSETTINGS();
+    void sendResponseHeaders(quint32 streamID, qint64 bodySize);
+    void sendGOAWAY(quint32 error);
+
+    QTcpSocket socket;
+    State state;
+    QByteArray upgradeRequestLine;
+    bool upgradeRequested;
+
+    Http2::FrameReader reader;
+    Http2::Frame inboundFrame;
+    Http2::FrameWriter writer;
+    std::vector<Http2::Frame> continuedHeaders;
+
+    HPack::Decoder decoder;
+    HPack::Encoder encoder;
+
+    std::map<quint32, Stream> streams;
+    quint32 lastServedStream;
+    qint64 sessionSendWindow;
+    qint64 initialStreamWindow;
+    quint32 peerMaxFrameSize;
+};
+
+QT_END_NAMESPACE
+
+#endif // BENCHSERVER_H
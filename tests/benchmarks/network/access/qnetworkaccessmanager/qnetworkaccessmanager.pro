@@ -0,0 +1,9 @@
+TEMPLATE = app
+TARGET = tst_bench_qnetworkaccessmanager
+
+QT = core network network-private testlib
+
+CONFIG += release c++11
+
+HEADERS += benchserver.h
+SOURCES += tst_qnetworkaccessmanager.cpp benchserver.cpp
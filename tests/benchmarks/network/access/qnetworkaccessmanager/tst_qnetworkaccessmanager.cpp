@@ -0,0 +1,381 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtNetwork/qnetworkrequest.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qeventloop.h>
+#include <QtCore/qthread.h>
+
+#include "benchserver.h"
+
+#include <algorithm>
+#include <vector>
+
+Q_DECLARE_METATYPE(BenchServer::Protocol)
+
+// Runs a BenchServer in its own thread for the lifetime of the object.
+class ServerRunner
+{
+public:
+    explicit ServerRunner(BenchServer::Protocol protocol)
+        : server(new BenchServer(protocol)), port(0)
+    {
+        thread.start();
+        server->moveToThread(&thread);
+        QMetaObject::invokeMethod(server, "start", Qt::BlockingQueuedConnection,
+                                  Q_RETURN_ARG(quint16, port));
+    }
+
+    ~ServerRunner()
+    {
+        QMetaObject::invokeMethod(server, "deleteLater");
+        thread.quit();
+        thread.wait();
+    }
+
+    QUrl url(qint64 responseSize) const
+    {
+        return QUrl(QString::fromLatin1("http://127.0.0.1:%1/%2").arg(port).arg(responseSize));
+    }
+
+    bool isListening() const { return port != 0; }
+
+private:
+    QThread thread;
+    BenchServer *server;
+    quint16 port;
+};
+
+struct WorkloadResult
+{
+    int completed = 0;
+    int failed = 0;
+    qint64 bytes = 0;
+    qint64 elapsedNs = 0;
+    std::vector<qint64> latenciesNs;
+
+    qreal requestsPerSecond() const { return completed * 1e9 / qMax<qint64>(elapsedNs, 1); }
+    qreal bytesPerSecond() const { return bytes * 1e9 / qMax<qint64>(elapsedNs, 1); }
+    qreal latencyMs(qreal percentile)
+    {
+        if (latenciesNs.empty())
+            return 0;
+        std::sort(latenciesNs.begin(), latenciesNs.end());
+        const std::size_t index = std::min(latenciesNs.size() - 1,
+                                           std::size_t(percentile * latenciesNs.size()));
+        return latenciesNs[index] / 1e6;
+    }
+};
+
+// Issues 'total' GET requests, keeping 'concurrency' of them in flight.
+class Workload : public QObject
+{
+    Q_OBJECT
+public:
+    Workload(QNetworkAccessManager *manager, const QNetworkRequest &request,
+             int total, int concurrency)
+        : manager(manager), request(request), total(total), concurrency(concurrency), issued(0)
+    {
+    }
+
+    WorkloadResult run()
+    {
+        result = WorkloadResult();
+        result.latenciesNs.reserve(total);
+        issued = 0;
+        timer.start();
+        while (issued < qMin(total, concurrency))
+            startRequest();
+        QTimer::singleShot(120000, &loop, SLOT(quit()));
+        loop.exec();
+        result.elapsedNs = timer.nsecsElapsed();
+        return result;
+    }
+
+private slots:
+    void replyReadyRead()
+    {
+        QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
+        result.bytes += reply->readAll().size();
+    }
+
+    void replyFinished()
+    {
+        QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
+        result.bytes += reply->readAll().size();
+        result.latenciesNs.push_back(timer.nsecsElapsed() - startTimes.take(reply));
+        if (reply->error() == QNetworkReply::NoError)
+            ++result.completed;
+        else
+            ++result.failed;
+        reply->deleteLater();
+
+        if (issued < total)
+            startRequest();
+        else if (startTimes.isEmpty())
+            loop.quit();
+    }
+
+private:
+    void startRequest()
+    {
+        ++issued;
+        QNetworkReply *reply = manager->get(request);
+        startTimes.insert(reply, timer.nsecsElapsed());
+        connect(reply, SIGNAL(readyRead()), this, SLOT(replyReadyRead()));
+        connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+    }
+
+    QNetworkAccessManager *manager;
+    QNetworkRequest request;
+    int total;
+    int concurrency;
+    int issued;
+    QHash<QNetworkReply *, qint64> startTimes;
+    QElapsedTimer timer;
+    QEventLoop loop;
+    WorkloadResult result;
+};
+
+class tst_QNetworkAccessManager : public QObject
+{
+    Q_OBJECT
+public:
+    enum Metric {
+        RequestsPerSecond,
+        MedianLatency,
+        TailLatency,
+        Throughput
+    };
+    Q_ENUM(Metric)
+
+private slots:
+    void manySmallRequests_data();
+    void manySmallRequests();
+    void largeDownload_data();
+    void largeDownload();
+    void pipelining_data();
+    void pipelining();
+    void http2Multiplexing_data();
+    void http2Multiplexing();
+
+private:
+    void addMetricRows(const QByteArray &name, const QVariantList &values,
+                       const QList<Metric> &metrics);
+    void runAndReport(BenchServer::Protocol protocol, qint64 responseSize, int total,
+                      int concurrency, bool pipelining, Metric metric);
+};
+
+static const char *protocolName(BenchServer::Protocol protocol)
+{
+    return protocol == BenchServer::Http1 ? "http1.1" : "h2c";
+}
+
+static const char *metricName(tst_QNetworkAccessManager::Metric metric)
+{
+    switch (metric) {
+    case tst_QNetworkAccessManager::RequestsPerSecond:
+        return "requests/s";
+    case tst_QNetworkAccessManager::MedianLatency:
+        return "p50";
+    case tst_QNetworkAccessManager::TailLatency:
+        return "p99";
+    case tst_QNetworkAccessManager::Throughput:
+        return "bytes/s";
+    }
+    return "";
+}
+
+void tst_QNetworkAccessManager::runAndReport(BenchServer::Protocol protocol, qint64 responseSize,
+                                             int total, int concurrency, bool pipelining,
+                                             Metric metric)
+{
+    ServerRunner server(protocol);
+    QVERIFY(server.isListening());
+
+    QNetworkAccessManager manager;
+    QNetworkRequest request(server.url(responseSize));
+    request.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, pipelining);
+    request.setAttribute(QNetworkRequest::HTTP2AllowedAttribute,
+                         protocol == BenchServer::Http2Clear);
+
+    // Establish the connections (and, for h2c, the protocol upgrade)
+    // outside of the measurement.
+    Workload warmup(&manager, request, qMin(total, 2 * concurrency), concurrency);
+    const WorkloadResult warmupResult = warmup.run();
+    QCOMPARE(warmupResult.failed, 0);
+
+    Workload workload(&manager, request, total, concurrency);
+    WorkloadResult result = workload.run();
+    QCOMPARE(result.failed, 0);
+    QCOMPARE(result.completed, total);
+    QCOMPARE(result.bytes, responseSize * total);
+
+    switch (metric) {
+    case RequestsPerSecond:
+        // events: completed requests per second
+        QTest::setBenchmarkResult(result.requestsPerSecond(), QTest::Events);
+        break;
+    case MedianLatency:
+        QTest::setBenchmarkResult(result.latencyMs(0.5), QTest::WalltimeMilliseconds);
+        break;
+    case TailLatency:
+        QTest::setBenchmarkResult(result.latencyMs(0.99), QTest::WalltimeMilliseconds);
+        break;
+    case Throughput:
+        QTest::setBenchmarkResult(result.bytesPerSecond(), QTest::BytesPerSecond);
+        break;
+    }
+}
+
+void tst_QNetworkAccessManager::manySmallRequests_data()
+{
+    QTest::addColumn<BenchServer::Protocol>("protocol");
+    QTest::addColumn<int>("concurrency");
+    QTest::addColumn<Metric>("metric");
+
+    const BenchServer::Protocol protocols[] = { BenchServer::Http1, BenchServer::Http2Clear };
+    const int concurrencies[] = { 1, 6, 100 };
+    const Metric metrics[] = { RequestsPerSecond, MedianLatency, TailLatency };
+    for (BenchServer::Protocol protocol : protocols) {
+        for (int concurrency : concurrencies) {
+            for (Metric metric : metrics) {
+                const QByteArray name = QByteArray(protocolName(protocol)) + "-c"
+                        + QByteArray::number(concurrency) + '-' + metricName(metric);
+                QTest::newRow(name.constData()) << protocol << concurrency << metric;
+            }
+        }
+    }
+}
+
+void tst_QNetworkAccessManager::manySmallRequests()
+{
+    QFETCH(BenchServer::Protocol, protocol);
+    QFETCH(int, concurrency);
+    QFETCH(Metric, metric);
+
+    runAndReport(protocol, 512, 2000, concurrency, false, metric);
+}
+
+void tst_QNetworkAccessManager::largeDownload_data()
+{
+    QTest::addColumn<BenchServer::Protocol>("protocol");
+    QTest::addColumn<qint64>("responseSize");
+    QTest::addColumn<int>("concurrency");
+
+    const BenchServer::Protocol protocols[] = { BenchServer::Http1, BenchServer::Http2Clear };
+    const qint64 sizes[] = { 1024 * 1024, 64 * 1024 * 1024 };
+    const int concurrencies[] = { 1, 4 };
+    for (BenchServer::Protocol protocol : protocols) {
+        for (qint64 size : sizes) {
+            for (int concurrency : concurrencies) {
+                const QByteArray name = QByteArray(protocolName(protocol)) + '-'
+                        + QByteArray::number(size / (1024 * 1024)) + "MB-c"
+                        + QByteArray::number(concurrency);
+                QTest::newRow(name.constData()) << protocol << size << concurrency;
+            }
+        }
+    }
+}
+
+void tst_QNetworkAccessManager::largeDownload()
+{
+    QFETCH(BenchServer::Protocol, protocol);
+    QFETCH(qint64, responseSize);
+    QFETCH(int, concurrency);
+
+    // keep the amount of data per row roughly constant
+    const int total = int(qMax<qint64>(concurrency, (256 * 1024 * 1024) / responseSize));
+    runAndReport(protocol, responseSize, total, concurrency, false, Throughput);
+}
+
+void tst_QNetworkAccessManager::pipelining_data()
+{
+    QTest::addColumn<bool>("pipelining");
+    QTest::addColumn<int>("concurrency");
+    QTest::addColumn<Metric>("metric");
+
+    const int concurrencies[] = { 6, 100 };
+    const Metric metrics[] = { RequestsPerSecond, TailLatency };
+    for (bool pipelining : { false, true }) {
+        for (int concurrency : concurrencies) {
+            for (Metric metric : metrics) {
+                const QByteArray name = QByteArray(pipelining ? "pipelined" : "sequential")
+                        + "-c" + QByteArray::number(concurrency) + '-' + metricName(metric);
+                QTest::newRow(name.constData()) << pipelining << concurrency << metric;
+            }
+        }
+    }
+}
+
+void tst_QNetworkAccessManager::pipelining()
+{
+    QFETCH(bool, pipelining);
+    QFETCH(int, concurrency);
+    QFETCH(Metric, metric);
+
+    runAndReport(BenchServer::Http1, 512, 2000, concurrency, pipelining, metric);
+}
+
+void tst_QNetworkAccessManager::http2Multiplexing_data()
+{
+    QTest::addColumn<int>("concurrency");
+    QTest::addColumn<qint64>("responseSize");
+    QTest::addColumn<Metric>("metric");
+
+    const int concurrencies[] = { 1, 10, 100, 1000 };
+    const qint64 sizes[] = { 512, 64 * 1024 };
+    const Metric metrics[] = { RequestsPerSecond, TailLatency, Throughput };
+    for (int concurrency : concurrencies) {
+        for (qint64 size : sizes) {
+            for (Metric metric : metrics) {
+                const QByteArray name = "c" + QByteArray::number(concurrency) + '-'
+                        + QByteArray::number(size) + "B-" + metricName(metric);
+                QTest::newRow(name.constData()) << concurrency << size << metric;
+            }
+        }
+    }
+}
+
+void tst_QNetworkAccessManager::http2Multiplexing()
+{
+    QFETCH(int, concurrency);
+    QFETCH(qint64, responseSize);
+    QFETCH(Metric, metric);
+
+    runAndReport(BenchServer::Http2Clear, responseSize, qMax(2000, 2 * concurrency),
+                 concurrency, false, metric);
+}
+
+QTEST_MAIN(tst_QNetworkAccessManager)
+
+#include "tst_qnetworkaccessmanager.moc"
@@ -0,0 +1,130 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtNetwork/QNetworkCookie>
+#include <QtNetwork/QNetworkCookieJar>
+
+class CookieJar : public QNetworkCookieJar
+{
+public:
+    using QNetworkCookieJar::allCookies;
+    using QNetworkCookieJar::setAllCookies;
+};
+
+class tst_QNetworkCookieJar : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void cookiesForUrl_data();
+    void cookiesForUrl();
+    void setCookiesFromUrl();
+    void setAllCookies();
+
+private:
+    static QString hostName(int host) { return QString::fromLatin1("www.host%1.example%2.com").arg(host).arg(host % 97); }
+
+    QList<QNetworkCookie> cookies;
+};
+
+enum { HostCount = 10000, CookiesPerHost = 10 };
+
+void tst_QNetworkCookieJar::initTestCase()
+{
+    // 100k cookies: per host, a few on the host itself, a few on its parent
+    // domain and a few scoped to deeper paths
+    const QDateTime expiry = QDateTime::currentDateTimeUtc().addDays(1);
+    cookies.reserve(HostCount * CookiesPerHost);
+    for (int host = 0; host < HostCount; ++host) {
+        const QString name = hostName(host);
+        for (int i = 0; i < CookiesPerHost; ++i) {
+            QNetworkCookie cookie(QByteArray("cookie") + QByteArray::number(i), "value");
+            cookie.setDomain(i % 3 == 0 ? name.mid(3).prepend(QLatin1Char('.')) : name);
+            cookie.setPath(i % 2 ? QString::fromLatin1("/") : QString::fromLatin1("/path%1").arg(i % 4));
+            if (i % 5 == 0)
+                cookie.setExpirationDate(expiry);
+            cookies.append(cookie);
+        }
+    }
+}
+
+void tst_QNetworkCookieJar::cookiesForUrl_data()
+{
+    QTest::addColumn<QUrl>("url");
+
+    QTest::newRow("root") << QUrl(QLatin1String("http://") + hostName(HostCount / 2) + QLatin1Char('/'));
+    QTest::newRow("deep-path") << QUrl(QLatin1String("http://") + hostName(HostCount / 2)
+                                       + QLatin1String("/path1/a/b/c/index.html"));
+    QTest::newRow("unknown-host") << QUrl(QLatin1String("http://www.unknown.example.org/path2"));
+}
+
+void tst_QNetworkCookieJar::cookiesForUrl()
+{
+    QFETCH(QUrl, url);
+
+    CookieJar jar;
+    jar.setAllCookies(cookies);
+
+    QBENCHMARK {
+        const QList<QNetworkCookie> result = jar.cookiesForUrl(url);
+        Q_UNUSED(result);
+    }
+}
+
+void tst_QNetworkCookieJar::setCookiesFromUrl()
+{
+    CookieJar jar;
+    jar.setAllCookies(cookies);
+
+    const QUrl url(QLatin1String("http://") + hostName(HostCount / 3) + QLatin1String("/path3/"));
+    QList<QNetworkCookie> update;
+    for (int i = 0; i < CookiesPerHost; ++i)
+        update.append(QNetworkCookie(QByteArray("cookie") + QByteArray::number(i), "updated"));
+
+    QBENCHMARK {
+        QVERIFY(jar.setCookiesFromUrl(update, url));
+    }
+    QCOMPARE(jar.allCookies().count(), cookies.count() + CookiesPerHost);
+}
+
+void tst_QNetworkCookieJar::setAllCookies()
+{
+    CookieJar jar;
+
+    QBENCHMARK {
+        jar.setAllCookies(cookies);
+    }
+}
+
+QTEST_MAIN(tst_QNetworkCookieJar)
+
+#include "tst_qnetworkcookiejar.moc"
@@ -462,10 +462,15 @@ private slots:
     void uploadPerformance();
     void performanceControlRate();
     void httpUploadPerformance();
+    void httpUploadPerformanceFile();
     void httpDownloadPerformance_data();
     void httpDownloadPerformance();
     void httpDownloadPerformanceDownloadBuffer_data();
     void httpDownloadPerformanceDownloadBuffer();
+    void httpDownloadPerformanceToFile_data();
+    void httpDownloadPerformanceToFile();
+    void httpDownloadPerformanceLoadedEventLoop_data();
+    void httpDownloadPerformanceLoadedEventLoop();
     void httpsRequestChain();
     void httpsUpload();
     void preConnect_data();
@@ -696,6 +701,43 @@ void tst_qnetworkreply::httpUploadPerformance()
               << ((UploadSize/1024.0)/(elapsed/1000.0)) << " kB/sec";
 }
 
+void tst_qnetworkreply::httpUploadPerformanceFile()
+{
+    // Same as httpUploadPerformance, but uploading a QFile, which on Linux is
+    // sent with sendfile() instead of being copied through QNetworkAccessManager
+    enum {UploadSize = 128*1024*1024}; // 128 MB
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    const QByteArray block(1024*1024, '@');
+    for (int i = 0; i < UploadSize / block.size(); ++i)
+        QCOMPARE(file.write(block), qint64(block.size()));
+    QVERIFY(file.flush());
+    QVERIFY(file.seek(0));
+
+    ThreadedDataReaderHttpServer reader;
+
+    QNetworkRequest request(QUrl("http://127.0.0.1:" + QString::number(reader.serverPort()) + "/?bare=1"));
+    request.setHeader(QNetworkRequest::ContentLengthHeader, UploadSize);
+
+    QTime time;
+    QNetworkReplyPtr reply;
+    QBENCHMARK_ONCE {
+        time.start();
+        reply.reset(manager.put(request, &file));
+        connect(reply, SIGNAL(finished()), &QTestEventLoop::instance(), SLOT(exitLoop()));
+        QTestEventLoop::instance().enterLoop(40);
+    }
+    qint64 elapsed = time.elapsed();
+    reader.exit();
+    reader.wait();
+    QVERIFY(reply->isFinished());
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+
+    qDebug() << "tst_QNetworkReply::httpUploadPerformanceFile" << elapsed << "msec, "
+            << ((UploadSize/1024.0)/(elapsed/1000.0)) << " kB/sec";
+}
 
 void tst_qnetworkreply::performanceControlRate()
 {
@@ -839,6 +881,130 @@ void tst_qnetworkreply::httpDownloadPerformanceDownloadBuffer()
 }
 
 
+class HttpDownloadPerformanceClientToFile : QObject {
+    Q_OBJECT
+    QIODevice *device;
+    QFile *file;
+public:
+    HttpDownloadPerformanceClientToFile (QIODevice *dev, QFile *f) : device(dev), file(f) {
+        connect(dev, SIGNAL(readyRead()), this, SLOT(readyReadSlot()));
+    }
+
+public slots:
+    void readyReadSlot() {
+        file->write(device->readAll());
+    }
+};
+
+void tst_qnetworkreply::httpDownloadPerformanceToFile_data()
+{
+    QTest::addColumn<bool>("useDownloadTarget");
+
+    QTest::newRow("read-and-write") << false;
+    QTest::newRow("download-target-device") << true;
+}
+
+void tst_qnetworkreply::httpDownloadPerformanceToFile()
+{
+    QFETCH(bool, useDownloadTarget);
+
+    enum {DownloadSize = 128*1024*1024}; // 128 MB
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+
+    HttpDownloadPerformanceServer server(DownloadSize, true, false);
+
+    QNetworkRequest request(QUrl("http://127.0.0.1:" + QString::number(server.serverPort()) + "/?bare=1"));
+    if (useDownloadTarget)
+        request.setAttribute(QNetworkRequest::DownloadTargetDeviceAttribute, QVariant::fromValue<QObject *>(&file));
+
+    QNetworkAccessManager manager;
+    QNetworkReplyPtr reply(manager.get(request));
+    connect(reply, SIGNAL(finished()), &QTestEventLoop::instance(), SLOT(exitLoop()), Qt::QueuedConnection);
+    HttpDownloadPerformanceClientToFile client(reply.data(), &file);
+
+    QTime time;
+    time.start();
+    QBENCHMARK_ONCE {
+        QTestEventLoop::instance().enterLoop(40);
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QVERIFY(reply->isFinished());
+        QVERIFY(!QTestEventLoop::instance().timeout());
+    }
+    qint64 elapsed = time.elapsed();
+    QCOMPARE(file.size(), qint64(DownloadSize));
+
+    qDebug() << "tst_QNetworkReply::httpDownloadPerformanceToFile" << elapsed << "msec, "
+            << ((DownloadSize/1024.0)/(elapsed/1000.0)) << " kB/sec";
+}
+
+// Keeps the event loop of the thread it lives in busy, like a GUI thread that
+// has to paint while the download is running.
+class EventLoopLoad : public QObject
+{
+    Q_OBJECT
+public:
+    EventLoopLoad() : ticks(0) { startTimer(0); }
+    qint64 ticks;
+
+protected:
+    void timerEvent(QTimerEvent *)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        while (timer.nsecsElapsed() < 100000) // 0.1 ms of "work" per iteration
+            ;
+        ++ticks;
+    }
+};
+
+void tst_qnetworkreply::httpDownloadPerformanceLoadedEventLoop_data()
+{
+    QTest::addColumn<bool>("loaded");
+    QTest::addColumn<qint64>("readBufferSize");
+
+    QTest::newRow("idle-event-loop") << false << qint64(0);
+    QTest::newRow("loaded-event-loop") << true << qint64(0);
+    QTest::newRow("loaded-event-loop-limited-read-buffer") << true << qint64(256*1024);
+}
+
+void tst_qnetworkreply::httpDownloadPerformanceLoadedEventLoop()
+{
+    QFETCH(bool, loaded);
+    QFETCH(qint64, readBufferSize);
+
+    enum {DownloadSize = 128*1024*1024}; // 128 MB
+
+    HttpDownloadPerformanceServer server(DownloadSize, true, false);
+
+    QNetworkRequest request(QUrl("http://127.0.0.1:" + QString::number(server.serverPort()) + "/?bare=1"));
+    // do not use the zerocopy download buffer, the data has to go through the reply
+    request.setAttribute(QNetworkRequest::MaximumDownloadBufferSizeAttribute, 0);
+
+    QNetworkAccessManager manager;
+    QNetworkReplyPtr reply(manager.get(request));
+    reply->setReadBufferSize(readBufferSize);
+    connect(reply, SIGNAL(finished()), &QTestEventLoop::instance(), SLOT(exitLoop()), Qt::QueuedConnection);
+    HttpDownloadPerformanceClient client(reply.data());
+
+    QScopedPointer<EventLoopLoad> load(loaded ? new EventLoopLoad : 0);
+
+    QTime time;
+    time.start();
+    QBENCHMARK_ONCE {
+        QTestEventLoop::instance().enterLoop(120);
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QVERIFY(reply->isFinished());
+        QVERIFY(!QTestEventLoop::instance().timeout());
+    }
+    qint64 elapsed = time.elapsed();
+
+    qDebug() << "tst_QNetworkReply::httpDownloadPerformanceLoadedEventLoop" << elapsed << "msec, "
+            << ((DownloadSize/1024.0)/(elapsed/1000.0)) << " kB/sec,"
+            << (load ? load->ticks : 0) << "event loop load iterations";
+}
+
 class HttpsRequestChainHelper : public QObject {
     Q_OBJECT
 public:
@@ -0,0 +1,8 @@
+TEMPLATE = app
+TARGET = tst_bench_qlocalsocket
+
+QT = core network testlib
+
+CONFIG += release
+
+SOURCES += tst_qlocalsocket.cpp
@@ -0,0 +1,210 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtNetwork/qlocalserver.h>
+#include <QtNetwork/qlocalsharedbuffer.h>
+#include <QtNetwork/qlocalsocket.h>
+
+class tst_QLocalSocket : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Transport {
+        Stream,
+        FreshSharedBuffer,
+        PooledSharedBuffer
+    };
+    Q_ENUM(Transport)
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void frames_data();
+    void frames();
+
+private:
+    QLocalServer server;
+    QLocalSocket client;
+    QLocalSocket *peer = nullptr;
+};
+
+static const qint64 transferSize = 256 * 1024 * 1024;
+
+void tst_QLocalSocket::initTestCase()
+{
+    const QString name = QStringLiteral("tst_bench_qlocalsocket");
+    QLocalServer::removeServer(name);
+    QVERIFY(server.listen(name));
+    client.connectToServer(name);
+    QVERIFY(client.waitForConnected(5000));
+    QVERIFY(server.waitForNewConnection(5000));
+    peer = server.nextPendingConnection();
+    QVERIFY(peer);
+}
+
+void tst_QLocalSocket::cleanupTestCase()
+{
+    client.disconnectFromServer();
+    server.close();
+}
+
+void tst_QLocalSocket::frames_data()
+{
+    QTest::addColumn<Transport>("transport");
+    QTest::addColumn<int>("frameSize");
+
+    for (int frameSize : { 64 * 1024, 1024 * 1024, 8 * 1024 * 1024 }) {
+        const QByteArray size = QByteArray::number(frameSize / 1024) + 'k';
+        QTest::newRow("stream-" + size) << Stream << frameSize;
+        QTest::newRow("shared-fresh-" + size) << FreshSharedBuffer << frameSize;
+        QTest::newRow("shared-pooled-" + size) << PooledSharedBuffer << frameSize;
+    }
+}
+
+// Moves frames of a fixed size from one local socket to the other, keeping
+// two frames in flight, and reports bytes per second. In the stream rows
+// the frame contents go through the socket. In the shared rows each frame
+// is copied into shared memory and only a small header goes through the
+// socket: the fresh rows create a new buffer per frame and pass its
+// descriptor along with the header, while the pooled rows hand over two
+// buffers up front and take turns filling them.
+void tst_QLocalSocket::frames()
+{
+    QFETCH(Transport, transport);
+    QFETCH(int, frameSize);
+
+    QByteArray source(frameSize, 'q');
+    QByteArray frame(frameSize, Qt::Uninitialized);
+    const int frameCount = int(transferSize / frameSize);
+
+    QLocalSharedBuffer senderPool[2];
+    QLocalSharedBuffer receiverPool[2];
+    if (transport == PooledSharedBuffer) {
+        for (QLocalSharedBuffer &buffer : senderPool) {
+            QVERIFY(buffer.create(frameSize));
+            QVERIFY(client.writeFileDescriptor(buffer.fileDescriptor()));
+        }
+        QVERIFY(client.putChar('\0'));
+        QVERIFY(client.waitForBytesWritten(5000));
+        QVERIFY(peer->waitForReadyRead(5000));
+        QVERIFY(peer->getChar(nullptr));
+        for (QLocalSharedBuffer &buffer : receiverPool)
+            QVERIFY(buffer.attach(peer->readFileDescriptor(), QLocalSharedBuffer::ReadOnly));
+    }
+
+    int sent = 0;
+    int received = 0;
+    int inFrame = 0;
+    bool failed = false;
+    QEventLoop loop;
+
+    auto sendMore = [&]() {
+        while (sent < frameCount && sent - received < 2) {
+            if (transport == Stream) {
+                client.write(source);
+            } else if (transport == PooledSharedBuffer) {
+                // the receiver is done with the frame sent two frames ago
+                const qint32 slot = sent % 2;
+                memcpy(senderPool[slot].data(), source.constData(), frameSize);
+                client.write(reinterpret_cast<const char *>(&slot), sizeof slot);
+            } else {
+                QLocalSharedBuffer buffer;
+                if (!buffer.create(frameSize)) {
+                    failed = true;
+                    loop.quit();
+                    return;
+                }
+                memcpy(buffer.data(), source.constData(), frameSize);
+                client.writeFileDescriptor(buffer.fileDescriptor());
+                const qint32 header = frameSize;
+                client.write(reinterpret_cast<const char *>(&header), sizeof header);
+            }
+            ++sent;
+        }
+    };
+
+    auto receive = [&]() {
+        if (transport == Stream) {
+            while (peer->bytesAvailable()) {
+                inFrame += int(peer->read(frame.data() + inFrame, frameSize - inFrame));
+                if (inFrame == frameSize) {
+                    inFrame = 0;
+                    ++received;
+                }
+            }
+        } else if (transport == PooledSharedBuffer) {
+            qint32 slot;
+            while (peer->bytesAvailable() >= qint64(sizeof slot)) {
+                peer->read(reinterpret_cast<char *>(&slot), sizeof slot);
+                if (static_cast<const char *>(receiverPool[slot].constData())[frameSize - 1] != 'q') {
+                    failed = true;
+                    loop.quit();
+                    return;
+                }
+                ++received;
+            }
+        } else {
+            qint32 header;
+            while (peer->bytesAvailable() >= qint64(sizeof header)) {
+                peer->read(reinterpret_cast<char *>(&header), sizeof header);
+                QLocalSharedBuffer buffer;
+                if (!buffer.attach(peer->readFileDescriptor(), QLocalSharedBuffer::ReadOnly)
+                        || buffer.size() != header
+                        || static_cast<const char *>(buffer.constData())[header - 1] != 'q') {
+                    failed = true;
+                    loop.quit();
+                    return;
+                }
+                ++received;
+            }
+        }
+        if (received == frameCount)
+            loop.quit();
+        else
+            sendMore();
+    };
+
+    QMetaObject::Connection readyRead = connect(peer, &QLocalSocket::readyRead, &loop, receive);
+
+    QElapsedTimer timer;
+    timer.start();
+    sendMore();
+    loop.exec();
+    const qint64 elapsed = timer.nsecsElapsed();
+    disconnect(readyRead);
+
+    QVERIFY(!failed);
+    QCOMPARE(received, frameCount);
+    QTest::setBenchmarkResult(frameCount * qint64(frameSize) * 1e9 / elapsed, QTest::BytesPerSecond);
+}
+
+QTEST_MAIN(tst_QLocalSocket)
+
+#include "tst_qlocalsocket.moc"
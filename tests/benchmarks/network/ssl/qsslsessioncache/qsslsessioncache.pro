@@ -0,0 +1,10 @@
+TEMPLATE = app
+TARGET = tst_bench_qsslsessioncache
+
+QT = core network network-private testlib
+
+CONFIG += release
+
+SOURCES += tst_qsslsessioncache.cpp
+
+TESTDATA += certs
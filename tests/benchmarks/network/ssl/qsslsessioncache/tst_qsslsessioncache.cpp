@@ -0,0 +1,174 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtNetwork/qsslconfiguration.h>
+#include <QtNetwork/qsslkey.h>
+#include <QtNetwork/qsslsocket.h>
+#include <QtNetwork/qtcpserver.h>
+
+#include <QtNetwork/private/qsslsessioncache_p.h>
+
+Q_DECLARE_METATYPE(QSsl::SslProtocol)
+
+// Encrypts every connection and greets the client with a byte once the
+// handshake is done, so that the client also receives the session tickets
+// TLS 1.3 servers send after the handshake.
+class HandshakeServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    QSslConfiguration configuration;
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) Q_DECL_OVERRIDE
+    {
+        QSslSocket *socket = new QSslSocket(this);
+        socket->setSslConfiguration(configuration);
+        connect(socket, &QSslSocket::encrypted, socket, [socket]() { socket->write("x", 1); });
+        connect(socket, &QSslSocket::disconnected, socket, &QObject::deleteLater);
+        if (!socket->setSocketDescriptor(socketDescriptor)) {
+            delete socket;
+            return;
+        }
+        socket->startServerEncryption();
+    }
+};
+
+class tst_QSslSessionCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void handshakes_data();
+    void handshakes();
+
+private:
+    bool connectOnce(const QSslConfiguration &configuration);
+
+    HandshakeServer server;
+    QList<QSslCertificate> caCertificates;
+};
+
+void tst_QSslSessionCache::initTestCase()
+{
+    if (!QSslSocket::supportsSsl())
+        QSKIP("Needs SSL");
+
+    QFile keyFile(QFINDTESTDATA("certs/bogus-server.key"));
+    QVERIFY(keyFile.open(QIODevice::ReadOnly));
+    const QSslKey key(keyFile.readAll(), QSsl::Rsa, QSsl::Pem, QSsl::PrivateKey);
+    QVERIFY(!key.isNull());
+    const QList<QSslCertificate> certificates = QSslCertificate::fromPath(QFINDTESTDATA("certs/bogus-server.crt"));
+    QCOMPARE(certificates.size(), 1);
+
+    server.configuration = QSslConfiguration::defaultConfiguration();
+    server.configuration.setPrivateKey(key);
+    server.configuration.setLocalCertificate(certificates.first());
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    // only sessions of verified peers are shared
+    caCertificates = QSslCertificate::fromPath(QFINDTESTDATA("certs/bogus-ca.crt"));
+    QCOMPARE(caCertificates.size(), 1);
+}
+
+void tst_QSslSessionCache::cleanupTestCase()
+{
+    QSslSessionCache::instance()->clear();
+}
+
+// Opens a connection, waits for the greeting and drops the connection.
+bool tst_QSslSessionCache::connectOnce(const QSslConfiguration &configuration)
+{
+    QSslSocket socket;
+    socket.setSslConfiguration(configuration);
+    QEventLoop loop;
+    connect(&socket, &QSslSocket::readyRead, &loop, &QEventLoop::quit);
+    connect(&socket, QOverload<QAbstractSocket::SocketError>::of(&QSslSocket::error),
+            &loop, &QEventLoop::quit);
+    QTimer::singleShot(5000, &loop, &QEventLoop::quit);
+    socket.connectToHostEncrypted(QHostAddress(QHostAddress::LocalHost).toString(), server.serverPort(),
+                                  QStringLiteral("Bogus Server"));
+    loop.exec();
+    const bool ok = socket.isEncrypted() && socket.bytesAvailable() > 0;
+    socket.abort();
+    return ok;
+}
+
+void tst_QSslSessionCache::handshakes_data()
+{
+    QTest::addColumn<QSsl::SslProtocol>("protocol");
+    QTest::addColumn<bool>("resume");
+
+    QTest::newRow("tls1.2-full") << QSsl::TlsV1_2 << false;
+    QTest::newRow("tls1.2-resumed") << QSsl::TlsV1_2 << true;
+    QTest::newRow("secure-full") << QSsl::SecureProtocols << false;
+    QTest::newRow("secure-resumed") << QSsl::SecureProtocols << true;
+}
+
+// Connects to a local server over and over, either resuming the session of
+// the previous connection or doing a full handshake every time. Reports
+// handshakes per second.
+void tst_QSslSessionCache::handshakes()
+{
+    QFETCH(QSsl::SslProtocol, protocol);
+    QFETCH(bool, resume);
+
+    QSslSessionCache *cache = QSslSessionCache::instance();
+    cache->clear();
+    server.configuration.setProtocol(protocol);
+    server.configuration.setSslOption(QSsl::SslOptionEnableServerSessionCache, resume);
+
+    QSslConfiguration configuration = QSslConfiguration::defaultConfiguration();
+    configuration.setProtocol(protocol);
+    configuration.setCaCertificates(caCertificates);
+    configuration.setSslOption(QSsl::SslOptionDisableSessionSharing, !resume);
+
+    // the first connection always does a full handshake
+    QVERIFY(connectOnce(configuration));
+    QSslSocket::resetSessionCacheCounters();
+
+    const int count = 200;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < count; ++i)
+        QVERIFY(connectOnce(configuration));
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    QCOMPARE(QSslSocket::sessionCacheCounter(QSslSocket::ClientHandshakes), qint64(count));
+    QCOMPARE(QSslSocket::sessionCacheCounter(QSslSocket::ClientResumedHandshakes),
+             resume ? qint64(count) : qint64(0));
+    QTest::setBenchmarkResult(count * 1e9 / elapsed, QTest::Events);
+}
+
+QTEST_MAIN(tst_QSslSessionCache)
+
+#include "tst_qsslsessioncache.moc"
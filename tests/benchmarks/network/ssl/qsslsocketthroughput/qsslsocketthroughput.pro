@@ -0,0 +1,10 @@
+TEMPLATE = app
+TARGET = tst_bench_qsslsocketthroughput
+
+QT = core network testlib
+
+CONFIG += release
+
+SOURCES += tst_qsslsocketthroughput.cpp
+
+TESTDATA += certs
@@ -0,0 +1,269 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtNetwork/qnetworkrequest.h>
+#include <QtNetwork/qsslconfiguration.h>
+#include <QtNetwork/qsslkey.h>
+#include <QtNetwork/qsslsocket.h>
+#include <QtNetwork/qtcpserver.h>
+
+// Discards everything written to it. In HTTP mode, it reads a request with a
+// Content-Length and answers it once the body has arrived. Lives in a thread
+// of its own, so that the handshakes do not wait for the client side.
+class SinkServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    QSslConfiguration configuration;
+
+public slots:
+    void reset(bool httpMode)
+    {
+        http = httpMode;
+        received = 0;
+    }
+
+signals:
+    void receivedChanged(qint64 received);
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) Q_DECL_OVERRIDE
+    {
+        QSslSocket *socket = new QSslSocket(this);
+        socket->setSslConfiguration(configuration);
+        connect(socket, &QSslSocket::readyRead, this, [this, socket]() { readFrom(socket); });
+        connect(socket, &QSslSocket::disconnected, socket, &QObject::deleteLater);
+        if (!socket->setSocketDescriptor(socketDescriptor)) {
+            delete socket;
+            return;
+        }
+        socket->startServerEncryption();
+    }
+
+private:
+    void readFrom(QSslSocket *socket)
+    {
+        if (http && bodyRemaining < 0) {
+            header += socket->readAll();
+            const int end = header.indexOf("\r\n\r\n");
+            if (end == -1)
+                return;
+            const QByteArray fields = header.left(end).toLower();
+            const int field = fields.indexOf("content-length:");
+            bodyRemaining = field == -1 ? 0 : fields.mid(field + 15).split('\r').first().trimmed().toLongLong();
+            const qint64 bodyStart = header.size() - end - 4;
+            received += bodyStart;
+            bodyRemaining -= bodyStart;
+            header.clear();
+        }
+        char buffer[64 * 1024];
+        qint64 read;
+        while ((read = socket->read(buffer, sizeof(buffer))) > 0) {
+            received += read;
+            bodyRemaining -= read;
+        }
+        if (http && bodyRemaining == 0) {
+            socket->write("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n");
+            bodyRemaining = -1;
+        }
+        emit receivedChanged(received);
+    }
+
+    bool http = false;
+    qint64 received = 0;
+    QByteArray header;
+    qint64 bodyRemaining = -1;
+};
+
+class tst_QSslSocketThroughput : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void socketWrite_data();
+    void socketWrite();
+    void httpsUploadFile_data();
+    void httpsUploadFile();
+
+private:
+    QSslConfiguration clientConfiguration() const;
+
+    QThread serverThread;
+    SinkServer server;
+    quint16 serverPort = 0;
+    QByteArray chunk;
+};
+
+static const qint64 transferSize = 64 * 1024 * 1024;
+
+void tst_QSslSocketThroughput::initTestCase()
+{
+    if (!QSslSocket::supportsSsl())
+        QSKIP("Needs SSL");
+
+    QFile keyFile(QFINDTESTDATA("certs/bogus-server.key"));
+    QVERIFY(keyFile.open(QIODevice::ReadOnly));
+    const QSslKey key(keyFile.readAll(), QSsl::Rsa, QSsl::Pem, QSsl::PrivateKey);
+    QVERIFY(!key.isNull());
+    const QList<QSslCertificate> certificates = QSslCertificate::fromPath(QFINDTESTDATA("certs/bogus-server.crt"));
+    QCOMPARE(certificates.size(), 1);
+
+    server.configuration = QSslConfiguration::defaultConfiguration();
+    server.configuration.setPrivateKey(key);
+    server.configuration.setLocalCertificate(certificates.first());
+    server.moveToThread(&serverThread);
+    serverThread.start();
+    QMetaObject::invokeMethod(&server, [this]() {
+        if (server.listen(QHostAddress::LocalHost))
+            serverPort = server.serverPort();
+    }, Qt::BlockingQueuedConnection);
+    QVERIFY(serverPort != 0);
+
+    // not compressible, so that the cipher does the work
+    chunk.resize(64 * 1024);
+    for (int i = 0; i < chunk.size(); ++i)
+        chunk[i] = char(qrand());
+}
+
+void tst_QSslSocketThroughput::cleanupTestCase()
+{
+    QMetaObject::invokeMethod(&server, [this]() {
+        server.close();
+        server.moveToThread(QCoreApplication::instance()->thread());
+    }, Qt::BlockingQueuedConnection);
+    serverThread.quit();
+    serverThread.wait();
+}
+
+QSslConfiguration tst_QSslSocketThroughput::clientConfiguration() const
+{
+    QFETCH(bool, kernel);
+
+    QSslConfiguration configuration = QSslConfiguration::defaultConfiguration();
+    configuration.setPeerVerifyMode(QSslSocket::VerifyNone);
+    configuration.setSslOption(QSsl::SslOptionEnableKernelTls, kernel);
+    return configuration;
+}
+
+void tst_QSslSocketThroughput::socketWrite_data()
+{
+    QTest::addColumn<bool>("kernel");
+
+    QTest::newRow("userspace") << false;
+    QTest::newRow("kernel") << true;
+}
+
+// Writes a large amount of data through an encrypted loopback connection,
+// keeping about 1 MB queued in the client socket. Without kernel support for
+// TLS, or for the negotiated cipher, the kernel row measures the regular
+// path. Reports bytes per second.
+void tst_QSslSocketThroughput::socketWrite()
+{
+    QMetaObject::invokeMethod(&server, "reset", Qt::BlockingQueuedConnection, Q_ARG(bool, false));
+
+    QSslSocket socket;
+    socket.setSslConfiguration(clientConfiguration());
+    qint64 written = 0;
+    qint64 received = 0;
+    QEventLoop loop;
+    auto writeMore = [&]() {
+        while (written < transferSize && socket.bytesToWrite() + socket.encryptedBytesToWrite() < 1024 * 1024) {
+            socket.write(chunk);
+            written += chunk.size();
+        }
+    };
+    connect(&socket, &QSslSocket::encrypted, &loop, writeMore);
+    connect(&socket, &QSslSocket::encryptedBytesWritten, &loop, writeMore);
+    connect(&socket, QOverload<QAbstractSocket::SocketError>::of(&QSslSocket::error),
+            &loop, &QEventLoop::quit);
+    connect(&server, &SinkServer::receivedChanged, &loop, [&](qint64 total) {
+        received = total;
+        if (received >= transferSize)
+            loop.quit();
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+    socket.connectToHostEncrypted(QHostAddress(QHostAddress::LocalHost).toString(), serverPort);
+    loop.exec();
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    QCOMPARE(received, transferSize);
+    socket.disconnectFromHost();
+    QTest::setBenchmarkResult(transferSize * 1e9 / elapsed, QTest::BytesPerSecond);
+}
+
+void tst_QSslSocketThroughput::httpsUploadFile_data()
+{
+    socketWrite_data();
+}
+
+// Uploads a file with QNetworkAccessManager over HTTPS; with kernel
+// encryption, the file is sent with sendfile(). Reports bytes per second.
+void tst_QSslSocketThroughput::httpsUploadFile()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    for (qint64 size = 0; size < transferSize; size += chunk.size())
+        QCOMPARE(file.write(chunk), qint64(chunk.size()));
+    QVERIFY(file.flush());
+    QVERIFY(file.seek(0));
+
+    QMetaObject::invokeMethod(&server, "reset", Qt::BlockingQueuedConnection, Q_ARG(bool, true));
+    qint64 received = 0;
+    connect(&server, &SinkServer::receivedChanged, this, [&](qint64 total) { received = total; });
+
+    QNetworkAccessManager manager;
+    QNetworkRequest request(QUrl(QLatin1String("https://127.0.0.1:")
+                                 + QString::number(serverPort) + QLatin1String("/upload")));
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/octet-stream");
+    request.setSslConfiguration(clientConfiguration());
+
+    QElapsedTimer timer;
+    timer.start();
+    QNetworkReply *reply = manager.post(request, &file);
+    QEventLoop loop;
+    connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+    loop.exec();
+    const qint64 elapsed = timer.nsecsElapsed();
+    disconnect(&server, &SinkServer::receivedChanged, this, 0);
+
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(received, transferSize);
+    delete reply;
+    QTest::setBenchmarkResult(transferSize * 1e9 / elapsed, QTest::BytesPerSecond);
+}
+
+QTEST_MAIN(tst_QSslSocketThroughput)
+
+#include "tst_qsslsocketthroughput.moc"
@@ -1,3 +1,5 @@
 TEMPLATE = subdirs
 SUBDIRS = \
-        qsslsocket
+        qsslsessioncache \
+        qsslsocket \
+        qsslsocketthroughput
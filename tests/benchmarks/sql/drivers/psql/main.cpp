@@ -0,0 +1,235 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtSql/QtSql>
+
+// Runs against a local PostgreSQL server; the connection is set up by libpq
+// from the usual PGHOST, PGPORT, PGDATABASE, PGUSER and PGPASSWORD variables.
+
+class tst_QPSQL : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void insert_data();
+    void insert();
+    void select_data();
+    void select();
+
+private:
+    bool fillTable(int rows);
+
+    QSqlDatabase db;
+    int filledRows = 0;
+};
+
+enum InsertMode { ExecPerRow, ExecBatch };
+
+static const char tableName[] = "qtbench_psql";
+
+void tst_QPSQL::initTestCase()
+{
+    if (!QSqlDatabase::isDriverAvailable(QStringLiteral("QPSQL")))
+        QSKIP("The QPSQL driver is not available");
+    db = QSqlDatabase::addDatabase(QStringLiteral("QPSQL"), QStringLiteral("tst_bench_psql"));
+    // forward-only queries stream their rows
+    db.setConnectOptions(QStringLiteral("QPSQL_SINGLE_ROW_MODE"));
+    if (!db.open())
+        QSKIP(qPrintable(QLatin1String("No local PostgreSQL server: ") + db.lastError().text()));
+
+    QSqlQuery q(db);
+    QVERIFY(q.exec(QLatin1String("SET client_min_messages = 'warning'")));
+    QVERIFY(q.exec(QLatin1String("CREATE TEMPORARY TABLE ") + QLatin1String(tableName)
+                   + QLatin1String(" (id int8 NOT NULL, value float8, name varchar(40), stamp timestamptz)")));
+}
+
+void tst_QPSQL::cleanupTestCase()
+{
+    db.close();
+}
+
+bool tst_QPSQL::fillTable(int rows)
+{
+    QSqlQuery q(db);
+    if (!q.exec(QLatin1String("TRUNCATE ") + QLatin1String(tableName)))
+        return false;
+    filledRows = 0;
+    if (rows == 0)
+        return true;
+
+    QVariantList ids, values, names, stamps;
+    ids.reserve(rows);
+    values.reserve(rows);
+    names.reserve(rows);
+    stamps.reserve(rows);
+    const QDateTime start(QDate(2017, 1, 1), QTime(0, 0), Qt::UTC);
+    for (int i = 0; i < rows; ++i) {
+        ids.append(qlonglong(i));
+        values.append(i * 0.5);
+        names.append(i % 10 ? QVariant(QStringLiteral("name %1").arg(i)) : QVariant(QVariant::String));
+        stamps.append(start.addSecs(i));
+    }
+
+    if (!q.prepare(QLatin1String("INSERT INTO ") + QLatin1String(tableName)
+                   + QLatin1String(" (id, value, name, stamp) VALUES (?, ?, ?, ?)"))) {
+        return false;
+    }
+    q.addBindValue(ids);
+    q.addBindValue(values);
+    q.addBindValue(names);
+    q.addBindValue(stamps);
+    if (!q.execBatch())
+        return false;
+    filledRows = rows;
+    return true;
+}
+
+void tst_QPSQL::insert_data()
+{
+    QTest::addColumn<int>("mode");
+    QTest::addColumn<int>("rows");
+
+    QTest::newRow("exec-10k") << int(ExecPerRow) << 10000;
+    QTest::newRow("exec-100k") << int(ExecPerRow) << 100000;
+    QTest::newRow("execBatch-100k") << int(ExecBatch) << 100000;
+    QTest::newRow("execBatch-1M") << int(ExecBatch) << 1000000;
+}
+
+void tst_QPSQL::insert()
+{
+    QFETCH(int, mode);
+    QFETCH(int, rows);
+
+    QVERIFY(fillTable(0));
+
+    QVariantList ids, values, names, stamps;
+    ids.reserve(rows);
+    values.reserve(rows);
+    names.reserve(rows);
+    stamps.reserve(rows);
+    const QDateTime start(QDate(2017, 1, 1), QTime(0, 0), Qt::UTC);
+    for (int i = 0; i < rows; ++i) {
+        ids.append(qlonglong(i));
+        values.append(i * 0.5);
+        names.append(QStringLiteral("name %1").arg(i));
+        stamps.append(start.addSecs(i));
+    }
+
+    QSqlQuery q(db);
+    QVERIFY(q.prepare(QLatin1String("INSERT INTO ") + QLatin1String(tableName)
+                      + QLatin1String(" (id, value, name, stamp) VALUES (?, ?, ?, ?)")));
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(db.transaction());
+    if (mode == ExecBatch) {
+        q.addBindValue(ids);
+        q.addBindValue(values);
+        q.addBindValue(names);
+        q.addBindValue(stamps);
+        QVERIFY2(q.execBatch(), qPrintable(q.lastError().text()));
+    } else {
+        for (int i = 0; i < rows; ++i) {
+            q.bindValue(0, ids.at(i));
+            q.bindValue(1, values.at(i));
+            q.bindValue(2, names.at(i));
+            q.bindValue(3, stamps.at(i));
+            QVERIFY2(q.exec(), qPrintable(q.lastError().text()));
+        }
+    }
+    QVERIFY(db.commit());
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    QVERIFY(q.exec(QLatin1String("SELECT count(*) FROM ") + QLatin1String(tableName)));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), rows);
+
+    // rows per second
+    QTest::setBenchmarkResult(rows * 1e9 / elapsed, QTest::Events);
+}
+
+void tst_QPSQL::select_data()
+{
+    QTest::addColumn<bool>("prepared");
+    QTest::addColumn<bool>("forwardOnly");
+
+    QTest::newRow("exec") << false << false;
+    QTest::newRow("exec-forwardOnly") << false << true;
+    QTest::newRow("prepared") << true << false;
+    QTest::newRow("prepared-forwardOnly") << true << true;
+}
+
+void tst_QPSQL::select()
+{
+    QFETCH(bool, prepared);
+    QFETCH(bool, forwardOnly);
+
+    const int rows = 1000000;
+    if (filledRows != rows)
+        QVERIFY(fillTable(rows));
+
+    const QString stmt = QLatin1String("SELECT id, value, name, stamp FROM ") + QLatin1String(tableName)
+            + QLatin1String(" WHERE id >= ") + (prepared ? QLatin1String("?") : QLatin1String("0"));
+
+    QSqlQuery q(db);
+    q.setForwardOnly(forwardOnly);
+
+    QElapsedTimer timer;
+    timer.start();
+    if (prepared) {
+        QVERIFY(q.prepare(stmt));
+        q.addBindValue(0);
+        QVERIFY2(q.exec(), qPrintable(q.lastError().text()));
+    } else {
+        QVERIFY2(q.exec(stmt), qPrintable(q.lastError().text()));
+    }
+    int count = 0;
+    qlonglong idSum = 0;
+    while (q.next()) {
+        idSum += q.value(0).toLongLong();
+        q.value(1);
+        q.value(2);
+        q.value(3);
+        ++count;
+    }
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    QCOMPARE(count, rows);
+    QCOMPARE(idSum, qlonglong(rows) * (rows - 1) / 2);
+
+    // rows per second
+    QTest::setBenchmarkResult(rows * 1e9 / elapsed, QTest::Events);
+}
+
+QTEST_MAIN(tst_QPSQL)
+
+#include "main.moc"
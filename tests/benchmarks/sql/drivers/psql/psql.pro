@@ -0,0 +1,8 @@
+TEMPLATE = app
+TARGET = tst_bench_psql
+
+QT = core sql testlib
+
+CONFIG += release
+
+SOURCES += main.cpp
@@ -0,0 +1,228 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtSql/QtSql>
+
+class tst_QSQLite : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void insert_data();
+    void insert();
+    void pointLookup_data();
+    void pointLookup();
+
+private:
+    QSqlDatabase openDatabase(const QString &connectionName, const QString &options);
+    bool fillTable(QSqlDatabase db, int rows);
+
+    QTemporaryDir dir;
+    QSqlDatabase db;
+};
+
+enum InsertMode { ExecPerRow, ExecBatch };
+
+static const char tableName[] = "qtbench_sqlite";
+
+QSqlDatabase tst_QSQLite::openDatabase(const QString &connectionName, const QString &options)
+{
+    QSqlDatabase database = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), connectionName);
+    database.setDatabaseName(dir.filePath(QStringLiteral("bench.db")));
+    database.setConnectOptions(options);
+    database.open();
+    return database;
+}
+
+void tst_QSQLite::initTestCase()
+{
+    if (!QSqlDatabase::isDriverAvailable(QStringLiteral("QSQLITE")))
+        QSKIP("The QSQLITE driver is not available");
+    QVERIFY(dir.isValid());
+    db = openDatabase(QStringLiteral("tst_bench_sqlite"), QString());
+    QVERIFY2(db.isOpen(), qPrintable(db.lastError().text()));
+
+    QSqlQuery q(db);
+    QVERIFY(q.exec(QLatin1String("CREATE TABLE ") + QLatin1String(tableName)
+                   + QLatin1String(" (id integer PRIMARY KEY, value real, name text)")));
+}
+
+void tst_QSQLite::cleanupTestCase()
+{
+    db.close();
+}
+
+bool tst_QSQLite::fillTable(QSqlDatabase database, int rows)
+{
+    QSqlQuery q(database);
+    if (!q.exec(QLatin1String("DELETE FROM ") + QLatin1String(tableName)))
+        return false;
+    if (rows == 0)
+        return true;
+
+    QVariantList ids, values, names;
+    ids.reserve(rows);
+    values.reserve(rows);
+    names.reserve(rows);
+    for (int i = 0; i < rows; ++i) {
+        ids.append(i);
+        values.append(i * 0.5);
+        names.append(QStringLiteral("name %1").arg(i));
+    }
+
+    if (!q.prepare(QLatin1String("INSERT INTO ") + QLatin1String(tableName)
+                   + QLatin1String(" (id, value, name) VALUES (?, ?, ?)"))) {
+        return false;
+    }
+    q.addBindValue(ids);
+    q.addBindValue(values);
+    q.addBindValue(names);
+    return q.execBatch();
+}
+
+void tst_QSQLite::insert_data()
+{
+    QTest::addColumn<int>("mode");
+    QTest::addColumn<int>("rows");
+
+    QTest::newRow("exec-100k") << int(ExecPerRow) << 100000;
+    QTest::newRow("exec-1M") << int(ExecPerRow) << 1000000;
+    QTest::newRow("execBatch-100k") << int(ExecBatch) << 100000;
+    QTest::newRow("execBatch-1M") << int(ExecBatch) << 1000000;
+}
+
+void tst_QSQLite::insert()
+{
+    QFETCH(int, mode);
+    QFETCH(int, rows);
+
+    QVERIFY(fillTable(db, 0));
+
+    QVariantList ids, values, names;
+    ids.reserve(rows);
+    values.reserve(rows);
+    names.reserve(rows);
+    for (int i = 0; i < rows; ++i) {
+        ids.append(i);
+        values.append(i * 0.5);
+        names.append(QStringLiteral("name %1").arg(i));
+    }
+
+    QSqlQuery q(db);
+    QVERIFY(q.prepare(QLatin1String("INSERT INTO ") + QLatin1String(tableName)
+                      + QLatin1String(" (id, value, name) VALUES (?, ?, ?)")));
+
+    QElapsedTimer timer;
+    timer.start();
+    if (mode == ExecBatch) {
+        // execBatch() opens its own transaction
+        q.addBindValue(ids);
+        q.addBindValue(values);
+        q.addBindValue(names);
+        QVERIFY2(q.execBatch(), qPrintable(q.lastError().text()));
+    } else {
+        QVERIFY(db.transaction());
+        for (int i = 0; i < rows; ++i) {
+            q.bindValue(0, ids.at(i));
+            q.bindValue(1, values.at(i));
+            q.bindValue(2, names.at(i));
+            QVERIFY2(q.exec(), qPrintable(q.lastError().text()));
+        }
+        QVERIFY(db.commit());
+    }
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    QVERIFY(q.exec(QLatin1String("SELECT count(*) FROM ") + QLatin1String(tableName)));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), rows);
+
+    // rows per second
+    QTest::setBenchmarkResult(rows * 1e9 / elapsed, QTest::Events);
+}
+
+void tst_QSQLite::pointLookup_data()
+{
+    QTest::addColumn<QString>("options");
+    QTest::addColumn<bool>("prepareEachTime");
+
+    QTest::newRow("prepareOnce") << QString() << false;
+    QTest::newRow("prepareEachTime-uncached") << QStringLiteral("QSQLITE_STATEMENT_CACHE_SIZE=0") << true;
+    QTest::newRow("prepareEachTime-cached") << QString() << true;
+}
+
+void tst_QSQLite::pointLookup()
+{
+    QFETCH(QString, options);
+    QFETCH(bool, prepareEachTime);
+
+    const int rows = 100000;
+    const int lookups = 200000;
+    QVERIFY(fillTable(db, rows));
+
+    const QString connectionName = QStringLiteral("tst_bench_sqlite_lookup");
+    {
+        QSqlDatabase lookupDb = openDatabase(connectionName, options);
+        QVERIFY2(lookupDb.isOpen(), qPrintable(lookupDb.lastError().text()));
+
+        const QString stmt = QLatin1String("SELECT value, name FROM ") + QLatin1String(tableName)
+                + QLatin1String(" WHERE id = ?");
+        QSqlQuery q(lookupDb);
+        q.setForwardOnly(true);
+        if (!prepareEachTime)
+            QVERIFY(q.prepare(stmt));
+
+        QElapsedTimer timer;
+        timer.start();
+        double sum = 0;
+        for (int i = 0; i < lookups; ++i) {
+            if (prepareEachTime)
+                QVERIFY(q.prepare(stmt));
+            q.bindValue(0, (i * 7919) % rows);
+            QVERIFY2(q.exec(), qPrintable(q.lastError().text()));
+            QVERIFY(q.next());
+            sum += q.value(0).toDouble();
+        }
+        const qint64 elapsed = timer.nsecsElapsed();
+        QVERIFY(sum > 0);
+
+        // lookups per second
+        QTest::setBenchmarkResult(lookups * 1e9 / elapsed, QTest::Events);
+        q.finish();
+        lookupDb.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+QTEST_MAIN(tst_QSQLite)
+
+#include "main.moc"
@@ -1,3 +1,5 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+       qsqlcachedresult \
+       qsqlconnectionpool \
        qsqlquery \
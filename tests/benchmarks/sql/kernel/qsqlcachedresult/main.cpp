@@ -0,0 +1,191 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtSql/QtSql>
+
+#if defined(__GLIBC__)
+#  include <malloc.h>
+#endif
+
+// Fills 10M cells from an SQLite database, which uses QSqlCachedResult,
+// through one connection with and one without QSQLITE_COLUMNAR_CACHE.
+
+class tst_QSqlCachedResult : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void fetch_data();
+    void fetch();
+    void memory_data() { fetch_data(); }
+    void memory();
+
+private:
+    bool fetchAll(QSqlQuery &query);
+    QSqlDatabase database(bool columnar) const { return columnar ? columnarDb : db; }
+
+    QTemporaryDir dir;
+    QSqlDatabase db;
+    QSqlDatabase columnarDb;
+};
+
+static const int columnCount = 4;
+static const int rowCount = 10000000 / columnCount;
+static const char selectAll[] = "SELECT id, value, name, opt FROM qtbench_cache";
+
+static qint64 allocatedBytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    const struct mallinfo2 info = mallinfo2();
+    return qint64(info.uordblks) + qint64(info.hblkhd);
+#elif defined(__GLIBC__)
+    const struct mallinfo info = mallinfo();
+    return qint64(uint(info.uordblks)) + qint64(uint(info.hblkhd));
+#else
+    return -1;
+#endif
+}
+
+void tst_QSqlCachedResult::initTestCase()
+{
+    if (!QSqlDatabase::isDriverAvailable(QStringLiteral("QSQLITE")))
+        QSKIP("The QSQLITE driver is not available");
+    QVERIFY(dir.isValid());
+    db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), QStringLiteral("tst_bench_qsqlcachedresult"));
+    db.setDatabaseName(dir.filePath(QStringLiteral("cache.db")));
+    QVERIFY2(db.open(), qPrintable(db.lastError().text()));
+
+    QSqlQuery q(db);
+    QVERIFY(q.exec(QLatin1String("CREATE TABLE qtbench_cache (id integer, value real, name text, opt integer)")));
+
+    QVariantList ids, values, names, opts;
+    ids.reserve(rowCount);
+    values.reserve(rowCount);
+    names.reserve(rowCount);
+    opts.reserve(rowCount);
+    for (int i = 0; i < rowCount; ++i) {
+        ids.append(i);
+        values.append(i * 0.5);
+        names.append(QStringLiteral("name %1").arg(i));
+        opts.append(i % 4 ? QVariant(i) : QVariant(QVariant::Int));
+    }
+    QVERIFY(q.prepare(QLatin1String("INSERT INTO qtbench_cache (id, value, name, opt) VALUES (?, ?, ?, ?)")));
+    q.addBindValue(ids);
+    q.addBindValue(values);
+    q.addBindValue(names);
+    q.addBindValue(opts);
+    QVERIFY2(q.execBatch(), qPrintable(q.lastError().text()));
+
+    columnarDb = QSqlDatabase::cloneDatabase(db, QStringLiteral("tst_bench_qsqlcachedresult_columnar"));
+    columnarDb.setConnectOptions(QStringLiteral("QSQLITE_COLUMNAR_CACHE"));
+    QVERIFY2(columnarDb.open(), qPrintable(columnarDb.lastError().text()));
+}
+
+void tst_QSqlCachedResult::cleanupTestCase()
+{
+    columnarDb.close();
+    db.close();
+}
+
+bool tst_QSqlCachedResult::fetchAll(QSqlQuery &query)
+{
+    if (!query.exec(QLatin1String(selectAll)))
+        return false;
+    int rows = 0;
+    while (query.next())
+        ++rows;
+    return rows == rowCount;
+}
+
+void tst_QSqlCachedResult::fetch_data()
+{
+    QTest::addColumn<bool>("columnar");
+
+    QTest::newRow("variants") << false;
+    QTest::newRow("columnar") << true;
+}
+
+void tst_QSqlCachedResult::fetch()
+{
+    QFETCH(bool, columnar);
+
+    QSqlQuery q(database(columnar));
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(fetchAll(q));
+
+    // read every cell once more from the cache, back to front
+    qint64 idSum = 0;
+    int nameChars = 0;
+    int nulls = 0;
+    QVERIFY(q.last());
+    do {
+        idSum += q.value(0).toLongLong();
+        q.value(1);
+        nameChars += q.value(2).toString().size();
+        nulls += q.isNull(3);
+    } while (q.previous());
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    QCOMPARE(idSum, qint64(rowCount) * (rowCount - 1) / 2);
+    QCOMPARE(nulls, rowCount / 4);
+    QVERIFY(nameChars > 0);
+
+    // cells per second, fetched and read back once
+    QTest::setBenchmarkResult(rowCount * columnCount * 1e9 / elapsed, QTest::Events);
+}
+
+void tst_QSqlCachedResult::memory()
+{
+    QFETCH(bool, columnar);
+
+    if (allocatedBytes() < 0)
+        QSKIP("Heap usage is only measured with glibc");
+
+    const qint64 before = allocatedBytes();
+    {
+        QSqlQuery q(database(columnar));
+
+        QVERIFY(fetchAll(q));
+        const qint64 used = allocatedBytes() - before;
+        QVERIFY(used > 0);
+
+        // bytes held by the cache for the whole result set
+        QTest::setBenchmarkResult(used, QTest::BytesAllocated);
+    }
+}
+
+QTEST_MAIN(tst_QSqlCachedResult)
+
+#include "main.moc"
@@ -0,0 +1,158 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtSql/QtSql>
+#include <QtConcurrent/QtConcurrent>
+
+// Runs many short point lookups against a SQLite file from QtConcurrent::map(),
+// either cloning a connection for every task or taking one from a
+// QSqlConnectionPool.
+
+class tst_QSqlConnectionPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void shortQueries_data();
+    void shortQueries();
+
+private:
+    QTemporaryDir dir;
+    QSqlDatabase prototype;
+};
+
+enum Mode { ClonePerTask, Pool };
+
+static const int rowCount = 10000;
+static const char lookup[] = "SELECT name FROM items WHERE id = ?";
+
+static bool runLookup(QSqlDatabase db, int id)
+{
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    if (!q.prepare(QLatin1String(lookup)))
+        return false;
+    q.addBindValue(id % rowCount);
+    return q.exec() && q.next();
+}
+
+void tst_QSqlConnectionPool::initTestCase()
+{
+    if (!QSqlDatabase::isDriverAvailable(QStringLiteral("QSQLITE")))
+        QSKIP("The QSQLITE driver is not available");
+    QVERIFY(dir.isValid());
+
+    prototype = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), QStringLiteral("prototype"));
+    prototype.setDatabaseName(dir.filePath(QStringLiteral("bench.db")));
+
+    QSqlDatabase db = QSqlDatabase::cloneDatabase(prototype, QStringLiteral("setup"));
+    QVERIFY(db.open());
+    {
+        QSqlQuery q(db);
+        QVERIFY(q.exec(QLatin1String("CREATE TABLE items (id integer PRIMARY KEY, name text)")));
+        QVariantList ids, names;
+        for (int i = 0; i < rowCount; ++i) {
+            ids.append(i);
+            names.append(QStringLiteral("item %1").arg(i));
+        }
+        QVERIFY(q.prepare(QLatin1String("INSERT INTO items (id, name) VALUES (?, ?)")));
+        q.addBindValue(ids);
+        q.addBindValue(names);
+        QVERIFY2(q.execBatch(), qPrintable(q.lastError().text()));
+    }
+    db.close();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(QStringLiteral("setup"));
+}
+
+void tst_QSqlConnectionPool::cleanupTestCase()
+{
+    prototype = QSqlDatabase();
+    QSqlDatabase::removeDatabase(QStringLiteral("prototype"));
+}
+
+void tst_QSqlConnectionPool::shortQueries_data()
+{
+    QTest::addColumn<int>("mode");
+    QTest::addColumn<int>("tasks");
+
+    QTest::newRow("clonePerTask-2k") << int(ClonePerTask) << 2000;
+    QTest::newRow("pool-2k") << int(Pool) << 2000;
+    QTest::newRow("pool-100k") << int(Pool) << 100000;
+}
+
+void tst_QSqlConnectionPool::shortQueries()
+{
+    QFETCH(int, mode);
+    QFETCH(int, tasks);
+
+    QVector<int> ids(tasks);
+    for (int i = 0; i < tasks; ++i)
+        ids[i] = i;
+
+    QSqlConnectionPool pool(prototype);
+    // blockingMap() also runs tasks in the calling thread
+    pool.setMaxConnections(QThreadPool::globalInstance()->maxThreadCount() + 1);
+    QAtomicInt failures;
+
+    QElapsedTimer timer;
+    timer.start();
+    if (mode == Pool) {
+        QtConcurrent::blockingMap(ids, [&](int id) {
+            QSqlDatabase db = pool.acquire();
+            if (!runLookup(db, id))
+                failures.ref();
+            pool.release(db);
+        });
+    } else {
+        QtConcurrent::blockingMap(ids, [&](int id) {
+            const QString name = QLatin1String("task_") + QString::number(id);
+            {
+                QSqlDatabase db = QSqlDatabase::cloneDatabase(prototype, name);
+                if (!db.open() || !runLookup(db, id))
+                    failures.ref();
+            }
+            QSqlDatabase::removeDatabase(name);
+        });
+    }
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    QCOMPARE(failures.load(), 0);
+
+    // queries per second
+    QTest::setBenchmarkResult(tasks * 1e9 / elapsed, QTest::Events);
+}
+
+QTEST_MAIN(tst_QSqlConnectionPool)
+
+#include "main.moc"
@@ -0,0 +1,8 @@
+TEMPLATE = app
+TARGET = tst_bench_qsqlconnectionpool
+
+QT = core sql testlib concurrent
+
+CONFIG += release
+
+SOURCES += main.cpp
@@ -0,0 +1,225 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtSql/QtSql>
+
+#if defined(__GLIBC__)
+#  include <malloc.h>
+#endif
+
+// Scrolls a view-sized page through a large SQLite table the way an item
+// view would, with the default QSqlQueryModel and with a row window.
+
+class tst_QSqlQueryModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void scroll_data();
+    void scroll();
+    void stall_data() { scroll_data(); }
+    void stall();
+    void memory_data() { scroll_data(); }
+    void memory();
+
+private:
+    bool scrollThrough(int windowSize, qint64 *elapsed, qint64 *longestStall);
+
+    QTemporaryDir dir;
+    QSqlDatabase db;
+};
+
+static const int rowCount = 2000000;
+static const int pageSize = 40;
+static const char selectAll[] = "SELECT id, value, name FROM qtbench_model ORDER BY id";
+
+static qint64 allocatedBytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    const struct mallinfo2 info = mallinfo2();
+    return qint64(info.uordblks) + qint64(info.hblkhd);
+#elif defined(__GLIBC__)
+    const struct mallinfo info = mallinfo();
+    return qint64(uint(info.uordblks)) + qint64(uint(info.hblkhd));
+#else
+    return -1;
+#endif
+}
+
+// Makes loop return once the model has news for the view. Waiting with
+// processEvents(WaitForMoreEvents) would keep blocking after the news arrived.
+static void quitOnUpdate(QSqlQueryModel *model, QEventLoop *loop)
+{
+    QObject::connect(model, &QAbstractItemModel::rowsInserted, loop, &QEventLoop::quit);
+    QObject::connect(model, &QAbstractItemModel::dataChanged, loop, &QEventLoop::quit);
+}
+
+void tst_QSqlQueryModel::initTestCase()
+{
+    if (!QSqlDatabase::isDriverAvailable(QStringLiteral("QSQLITE")))
+        QSKIP("The QSQLITE driver is not available");
+    QVERIFY(dir.isValid());
+    db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), QStringLiteral("tst_bench_qsqlquerymodel"));
+    db.setDatabaseName(dir.filePath(QStringLiteral("model.db")));
+    QVERIFY2(db.open(), qPrintable(db.lastError().text()));
+
+    QSqlQuery q(db);
+    QVERIFY(q.exec(QLatin1String("CREATE TABLE qtbench_model (id integer PRIMARY KEY, value real, name text)")));
+    QVERIFY(db.transaction());
+    QVERIFY(q.prepare(QLatin1String("INSERT INTO qtbench_model (id, value, name) VALUES (?, ?, ?)")));
+    for (int i = 0; i < rowCount; ++i) {
+        q.addBindValue(i);
+        q.addBindValue(i * 0.5);
+        q.addBindValue(QStringLiteral("name %1").arg(i));
+        QVERIFY(q.exec());
+    }
+    QVERIFY(db.commit());
+}
+
+void tst_QSqlQueryModel::cleanupTestCase()
+{
+    db.close();
+}
+
+// Shows every page of the table once, from top to bottom. A view only asks
+// for the rows it shows and calls fetchMore() when it reaches the end of the
+// rows it knows about; rows the model doesn't have yet are waited for
+// without blocking, as a view would repaint them on dataChanged().
+bool tst_QSqlQueryModel::scrollThrough(int windowSize, qint64 *elapsed, qint64 *longestStall)
+{
+    QSqlQueryModel model;
+    model.setWindowSize(windowSize);
+    QEventLoop loop;
+    quitOnUpdate(&model, &loop);
+
+    QElapsedTimer timer;
+    QElapsedTimer stall;
+    timer.start();
+    stall.start();
+    model.setQuery(QLatin1String(selectAll), db);
+    *longestStall = stall.nsecsElapsed();
+
+    for (int top = 0; top < rowCount; top += pageSize) {
+        const int bottom = qMin(top + pageSize, rowCount) - 1;
+        while (model.rowCount() <= bottom) {
+            stall.start();
+            if (model.canFetchMore())
+                model.fetchMore();
+            else
+                loop.exec();
+            *longestStall = qMax(*longestStall, stall.nsecsElapsed());
+        }
+
+        for (int row = top; row <= bottom; ++row) {
+            for (;;) {
+                stall.start();
+                const QVariant id = model.data(model.index(row, 0));
+                model.data(model.index(row, 1));
+                model.data(model.index(row, 2));
+                *longestStall = qMax(*longestStall, stall.nsecsElapsed());
+                if (id.isValid()) {
+                    if (id.toInt() != row)
+                        return false;
+                    break;
+                }
+                loop.exec();
+            }
+        }
+    }
+    *elapsed = timer.nsecsElapsed();
+    return true;
+}
+
+void tst_QSqlQueryModel::scroll_data()
+{
+    QTest::addColumn<int>("windowSize");
+
+    QTest::newRow("all-rows") << 0;
+    QTest::newRow("window-1000") << 1000;
+    QTest::newRow("window-10000") << 10000;
+}
+
+void tst_QSqlQueryModel::scroll()
+{
+    QFETCH(int, windowSize);
+
+    qint64 elapsed = 0;
+    qint64 longestStall = 0;
+    QVERIFY(scrollThrough(windowSize, &elapsed, &longestStall));
+
+    // rows shown per second
+    QTest::setBenchmarkResult(rowCount * 1e9 / elapsed, QTest::Events);
+}
+
+void tst_QSqlQueryModel::stall()
+{
+    QFETCH(int, windowSize);
+
+    qint64 elapsed = 0;
+    qint64 longestStall = 0;
+    QVERIFY(scrollThrough(windowSize, &elapsed, &longestStall));
+
+    // longest time the thread of the model was blocked at once
+    QTest::setBenchmarkResult(longestStall / 1000000.0, QTest::WalltimeMilliseconds);
+}
+
+void tst_QSqlQueryModel::memory()
+{
+    QFETCH(int, windowSize);
+
+    if (allocatedBytes() < 0)
+        QSKIP("Heap usage is only measured with glibc");
+
+    QSqlQueryModel model;
+    model.setWindowSize(windowSize);
+    QEventLoop loop;
+    quitOnUpdate(&model, &loop);
+    const qint64 before = allocatedBytes();
+    model.setQuery(QLatin1String(selectAll), db);
+
+    // scroll to the end in view-sized steps and measure what stays cached
+    for (int row = 0; row < rowCount; row += pageSize) {
+        while (model.rowCount() <= row) {
+            if (model.canFetchMore())
+                model.fetchMore();
+            else
+                loop.exec();
+        }
+        while (!model.data(model.index(row, 0)).isValid())
+            loop.exec();
+    }
+    QTest::setBenchmarkResult(allocatedBytes() - before, QTest::BytesAllocated);
+}
+
+QTEST_MAIN(tst_QSqlQueryModel)
+
+#include "main.moc"